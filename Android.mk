@@ -9,6 +9,7 @@ BUILD_FOR_HOST:=0
 #
 
 LOCAL_SRC_FILES_:=		\
+	ccutil/allocprofile.cpp	\
 	ccutil/ambigs.cpp	\
 	ccutil/basedir.cpp	\
 	ccutil/bits16.cpp	\
@@ -25,8 +26,10 @@ LOCAL_SRC_FILES_:=		\
 	ccutil/memry.cpp	\
 	ccutil/mfcpch.cpp	\
 	ccutil/ocrshell.cpp	\
+	ccutil/pagestats.cpp	\
 	ccutil/scanutils.cpp	\
 	ccutil/serialis.cpp	\
+	ccutil/simddetect.cpp	\
 	ccutil/strngs.cpp	\
 	ccutil/tessdatamanager.cpp	\
 	ccutil/tessopt.cpp	\
@@ -39,7 +42,8 @@ LOCAL_SRC_FILES_:=		\
 	ccutil/ccutil.cpp
 
 LOCAL_SRC_FILES_+=		\
-	api/baseapi.cpp
+	api/baseapi.cpp	\
+	api/batchapi.cpp
 
 LOCAL_SRC_FILES_+=		\
 	viewer/scrollview.cpp	\
@@ -60,6 +64,7 @@ LOCAL_SRC_FILES_+=		\
 	cutil/oldlist.cpp	\
 	cutil/structures.cpp	\
 	cutil/tessarray.cpp	\
+	cutil/wordarena.cpp	\
 	cutil/cutil_class.cpp 
 
 LOCAL_SRC_FILES_+=		\
@@ -247,14 +252,18 @@ LOCAL_SRC_FILES_+=		\
 	dict/context.cpp	\
 	dict/conversion.cpp	\
 	dict/dawg.cpp		\
+	dict/dawgbuilder.cpp	\
+	dict/dawgcache.cpp	\
 	dict/dict.cpp		\
 	dict/hyphen.cpp		\
+	dict/ngrammodel.cpp	\
 	dict/permdawg.cpp	\
 	dict/permngram.cpp	\
 	dict/permute.cpp	\
 	dict/states.cpp		\
 	dict/stopper.cpp	\
-	dict/trie.cpp
+	dict/trie.cpp		\
+	dict/userdict.cpp
 
 LOCAL_SRC_FILES_+=		\
 	classify/adaptive.cpp	\
@@ -262,12 +271,14 @@ LOCAL_SRC_FILES_+=		\
 	classify/baseline.cpp	\
 	classify/blobclass.cpp	\
 	classify/chartoname.cpp	\
+	classify/classifiercache.cpp	\
 	classify/classify.cpp	\
 	classify/cluster.cpp	\
 	classify/clusttool.cpp	\
 	classify/cutoffs.cpp	\
 	classify/extract.cpp	\
 	classify/featdefs.cpp	\
+	classify/featurestore.cpp	\
 	classify/flexfx.cpp	\
 	classify/float2int.cpp	\
 	classify/fpoint.cpp	\
@@ -276,6 +287,7 @@ LOCAL_SRC_FILES_+=		\
 	classify/intfx.cpp	\
 	classify/intmatcher.cpp	\
 	classify/intproto.cpp	\
+	classify/intsimd.cpp	\
 	classify/kdtree.cpp	\
 	classify/mf.cpp		\
 	classify/mfdefs.cpp	\
@@ -293,6 +305,7 @@ LOCAL_SRC_FILES_+=		\
 LOCAL_SRC_FILES_+=		\
 	wordrec/associate.cpp	\
 	wordrec/badwords.cpp	\
+	wordrec/beamsearch.cpp	\
 	wordrec/bestfirst.cpp	\
 	wordrec/chop.cpp	\
 	wordrec/chopper.cpp	\
@@ -313,6 +326,7 @@ LOCAL_SRC_FILES_+=		\
 	wordrec/plotseg.cpp	\
 	wordrec/render.cpp	\
 	wordrec/seam.cpp	\
+	wordrec/searchheap.cpp	\
 	wordrec/split.cpp	\
 	wordrec/tally.cpp	\
 	wordrec/tessinit.cpp	\
@@ -338,12 +352,14 @@ LOCAL_SRC_FILES_+=		\
 	ccmain/fixspace.cpp	\
 	ccmain/fixxht.cpp	\
 	ccmain/imgscale.cpp	\
+	ccmain/langmodel.cpp	\
 	ccmain/matmatch.cpp	\
 	ccmain/osdetect.cpp	\
 	ccmain/output.cpp	\
 	ccmain/pagewalk.cpp	\
 	ccmain/pgedit.cpp	\
 	ccmain/scaleimg.cpp	\
+	ccmain/stripthresholder.cpp	\
 	ccmain/tessbox.cpp	\
 	ccmain/tesseractclass.cpp	\
 	ccmain/tfacepp.cpp	\
@@ -408,6 +424,7 @@ LOCAL_C_INCLUDES_+=		\
 LOCAL_CFLAGS_:=			\
 	-DGRAPHICS_DISABLED	\
 	-DHAVE_LIBLEPT          \
+	-DHAVE_MMAP		\
         -O3
 #	-DFST_DISABLED		\
 #	-DDISABLE_INTEGER_MATCHING	\
@@ -30,8 +30,11 @@
 #include "baseapi.h"
 
 #include "thresholder.h"
+#include "stripthresholder.h"
 #include "tesseractmain.h"
 #include "tesseractclass.h"
+#include "langmodel.h"
+#include "userdict.h"
 #include "tessedit.h"
 #include "ocrclass.h"
 #include "pageres.h"
@@ -79,6 +82,8 @@ TessBaseAPI::TessBaseAPI()
     // created implicitly when used in InternalSetImage.
     thresholder_(NULL),
     threshold_done_(false),
+    strip_source_(NULL),
+    strip_height_(0),
     block_list_(NULL),
     page_res_(NULL),
     input_file_(NULL),
@@ -154,6 +159,8 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
             language, configs, configs_size, configs_global_only) != 0) {
       return -1;
     }
+    tesseract_->init_pass2_helpers();
+    tesseract_->init_seam_helpers();
   }
   // Update datapath and language requested for the last valid initialization.
   if (datapath_ == NULL)
@@ -171,6 +178,53 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
   return 0;
 }
 
+// Load the read-only data for a language once, to be shared by any number
+// of instances through InitWithLanguageModel.
+LanguageModel* TessBaseAPI::LoadLanguageModel(const char* datapath,
+                                              const char* language) {
+  return LanguageModel::Load(datapath, language);
+}
+
+void TessBaseAPI::ReleaseLanguageModel(LanguageModel* model) {
+  if (model != NULL)
+    model->Release();
+}
+
+// Start tesseract in the language of model, borrowing its read-only data.
+// Returns 0 on success and -1 on initialization failure.
+int TessBaseAPI::InitWithLanguageModel(const char* datapath,
+                                       LanguageModel* model,
+                                       char **configs, int configs_size,
+                                       bool configs_global_only) {
+  if (model == NULL)
+    return -1;
+  // The shared data can only be attached to a fresh instance.
+  if (tesseract_ != NULL) {
+    tesseract_->end_tesseract();
+    delete tesseract_;
+    tesseract_ = NULL;
+  }
+  tesseract_ = new Tesseract;
+  tesseract_->set_language_model(model);
+  if (tesseract_->init_tesseract(
+          datapath, output_file_ != NULL ? output_file_->string() : NULL,
+          model->lang().string(), configs, configs_size,
+          configs_global_only) != 0) {
+    return -1;
+  }
+  tesseract_->init_pass2_helpers();
+  tesseract_->init_seam_helpers();
+  if (datapath_ == NULL)
+    datapath_ = new STRING(datapath);
+  else
+    *datapath_ = datapath;
+  if (language_ == NULL)
+    language_ = new STRING(model->lang());
+  else
+    *language_ = model->lang();
+  return 0;
+}
+
 // Init only the lang model component of Tesseract. The only functions
 // that work after this init are SetVariable and IsValidWord.
 // WARNING: temporary! This function will be removed from here and placed
@@ -318,11 +372,27 @@ void TessBaseAPI::SetImage(const Pix* pix) {
 #endif
 }
 
+// Provide an image to be read and thresholded in strips, for pages that
+// are too large to hold in memory. The source is not copied or owned.
+void TessBaseAPI::SetImageStripSource(ImageStripSource* source,
+                                      int strip_height) {
+  if (!InternalSetImage())
+    return;
+  thresholder_->Clear();
+  tesseract_->page_image()->destroy();
+  strip_source_ = source;
+  strip_height_ = strip_height;
+  rect_left_ = 0;
+  rect_top_ = 0;
+  rect_width_ = image_width_ = source->width();
+  rect_height_ = image_height_ = source->height();
+}
+
 // Restrict recognition to a sub-rectangle of the image. Call after SetImage.
 // Each SetRectangle clears the recogntion results so multiple rectangles
 // can be recognized with the same image.
 void TessBaseAPI::SetRectangle(int left, int top, int width, int height) {
-  if (thresholder_ == NULL)
+  if (thresholder_ == NULL || strip_source_ != NULL)
     return;
   thresholder_->SetRectangle(left, top, width, height);
   ClearResults();
@@ -544,14 +614,15 @@ Boxa* TessBaseAPI::GetWords(Pixa** pixa) {
 void TessBaseAPI::DumpPGM(const char* filename) {
   if (tesseract_ == NULL)
     return;
+  IMAGE* page_image = tesseract_->page_image();
   IMAGELINE line;
-  line.init(page_image.get_xsize());
+  line.init(page_image->get_xsize());
   FILE *fp = fopen(filename, "w");
   fprintf(fp, "P5 " INT32FORMAT " " INT32FORMAT " 255\n",
-          page_image.get_xsize(), page_image.get_ysize());
-  for (int j = page_image.get_ysize()-1; j >= 0 ; --j) {
-    page_image.get_line(0, j, page_image.get_xsize(), &line, 0);
-    for (int i = 0; i < page_image.get_xsize(); ++i) {
+          page_image->get_xsize(), page_image->get_ysize());
+  for (int j = page_image->get_ysize()-1; j >= 0 ; --j) {
+    page_image->get_line(0, j, page_image->get_xsize(), &line, 0);
+    for (int i = 0; i < page_image->get_xsize(); ++i) {
       uinT8 b = line.pixels[i] ? 255 : 0;
       fwrite(&b, 1, 1, fp);
     }
@@ -559,12 +630,20 @@ void TessBaseAPI::DumpPGM(const char* filename) {
   fclose(fp);
 }
 
+// Write the internal binary image to filename, in the format given by
+// its extension.
+void TessBaseAPI::WriteThresholdedImage(const char* filename) {
+  if (tesseract_ != NULL)
+    tesseract_->page_image()->write(filename);
+}
+
 // Recognize the tesseract global image and return the result as Tesseract
 // internal structures.
 int TessBaseAPI::Recognize(struct ETEXT_STRUCT* monitor) {
   if (tesseract_ == NULL)
     return -1;
-  if (thresholder_ == NULL || thresholder_->IsEmpty()) {
+  if ((thresholder_ == NULL || thresholder_->IsEmpty()) &&
+      strip_source_ == NULL) {
     tprintf("Please call SetImage before attempting recognition.");
     return -1;
   }
@@ -602,6 +681,7 @@ int TessBaseAPI::Recognize(struct ETEXT_STRUCT* monitor) {
       tesseract_->recog_all_words(page_res_, monitor);
     }
   }
+  AllocProfiler::GetPage(&tesseract_->alloc_profile);
   return result;
 }
 
@@ -647,7 +727,7 @@ int TessBaseAPI::RecognizeForChopTest(struct ETEXT_STRUCT* monitor) {
     }
     TBLOB *pblob;
     TBLOB *blob;
-    init_match_table();
+    tesseract_->blob_match_table.init_match_table();
     BLOB_CHOICE_LIST *match_result;
     BLOB_CHOICE_LIST_VECTOR *char_choices = new BLOB_CHOICE_LIST_VECTOR();
     tesseract_->tess_denorm = &word_res->denorm;
@@ -717,6 +797,8 @@ static int ConvertWordToBoxText(WERD_RES *word,
                                 ROW_RES* row,
                                 int left,
                                 int bottom,
+                                int width,
+                                int height,
                                 char* word_str) {
   // Copy the output word and denormalize it back to image coords.
   WERD copy_outword;
@@ -735,9 +817,9 @@ static int ConvertWordToBoxText(WERD_RES *word,
       TBOX blob_box = blob->bounding_box();
       if (word->tess_failed ||
           blob_box.left() < 0 ||
-          blob_box.right() > page_image.get_xsize() ||
+          blob_box.right() > width ||
           blob_box.bottom() < 0 ||
-          blob_box.top() > page_image.get_ysize()) {
+          blob_box.top() > height) {
         // Bounding boxes can be illegal when tess fails on a word.
         blob_box = word->word->bounding_box();  // Use original word as backup.
         tprintf("Using substitute bounding box at (%d,%d)->(%d,%d)\n",
@@ -791,7 +873,7 @@ char* TessBaseAPI::GetBoxText() {
        page_res_it.forward()) {
     WERD_RES *word = page_res_it.word();
     ptr += ConvertWordToBoxText(word, page_res_it.row(), rect_left_, bottom,
-                                ptr);
+                                rect_width_, rect_height_, ptr);
     // Just in case...
     if (ptr - result + kMaxCharsPerChar > total_length)
       break;
@@ -956,6 +1038,55 @@ int* TessBaseAPI::AllWordConfidences() {
   return conf;
 }
 
+// Turns the timing of the recognition stages on or off.
+void TessBaseAPI::SetPageStatsEnabled(bool enabled) {
+  if (tesseract_ != NULL)
+    tesseract_->page_stats.set_enabled(enabled);
+}
+
+// Copies the stage times and counters gathered so far into stats.
+bool TessBaseAPI::GetPageStats(PageStats* stats) const {
+  if (tesseract_ == NULL)
+    return false;
+  *stats = tesseract_->page_stats;
+  return true;
+}
+
+// Returns the stats of GetPageStats as a JSON object.
+char* TessBaseAPI::GetPageStatsJSON() const {
+  if (tesseract_ == NULL)
+    return NULL;
+  STRING json;
+  tesseract_->page_stats.ToJSON(&json);
+  char* result = new char[json.length() + 1];
+  strcpy(result, json.string());
+  return result;
+}
+
+// Turns the allocation profiler on or off for all threads.
+void TessBaseAPI::SetAllocProfileEnabled(bool enabled, int sample_kbytes) {
+  AllocProfiler::set_enabled(enabled, sample_kbytes * 1024);
+}
+
+// Copies the allocation profile of the last page recognized into profile.
+bool TessBaseAPI::GetAllocProfile(AllocProfile* profile) const {
+  if (tesseract_ == NULL || !AllocProfiler::enabled())
+    return false;
+  *profile = tesseract_->alloc_profile;
+  return true;
+}
+
+// Returns the profile of GetAllocProfile as a JSON object.
+char* TessBaseAPI::GetAllocProfileJSON(bool symbols) const {
+  if (tesseract_ == NULL || !AllocProfiler::enabled())
+    return NULL;
+  STRING json;
+  tesseract_->alloc_profile.ToJSON(symbols, &json);
+  char* result = new char[json.length() + 1];
+  strcpy(result, json.string());
+  return result;
+}
+
 // Free up recognition results and any stored image data, without actually
 // freeing any recognition data that would be time-consuming to reload.
 // Afterwards, you must call SetImage or TesseractRect before doing
@@ -963,8 +1094,10 @@ int* TessBaseAPI::AllWordConfidences() {
 void TessBaseAPI::Clear() {
   if (thresholder_ != NULL)
     thresholder_->Clear();
+  strip_source_ = NULL;
   ClearResults();
-  page_image.destroy();
+  if (tesseract_ != NULL)
+    tesseract_->page_image()->destroy();
 }
 
 // Close down tesseract and free up all memory. End() is equivalent to
@@ -1013,6 +1146,64 @@ int TessBaseAPI::IsValidWord(const char *word) {
   return tesseract_->getDict().valid_word(word);
 }
 
+// Build a user dictionary for the language of this instance.
+UserDictionary* TessBaseAPI::LoadUserDictionary(const char* filename) {
+  if (tesseract_ == NULL)
+    return NULL;
+  return UserDictionary::ReadWordList(filename, tesseract_->unicharset,
+                                      tesseract_->lang);
+}
+
+UserDictionary* TessBaseAPI::CreateUserDictionary(const char* const* words,
+                                                  int num_words) {
+  if (tesseract_ == NULL)
+    return NULL;
+  return UserDictionary::FromWords(words, num_words, tesseract_->unicharset,
+                                   tesseract_->lang);
+}
+
+void TessBaseAPI::ReleaseUserDictionary(UserDictionary* dict) {
+  if (dict != NULL)
+    dict->Release();
+}
+
+// Add, remove or swap the user dictionaries searched by this instance.
+bool TessBaseAPI::AddUserDictionary(UserDictionary* dict) {
+  return tesseract_ != NULL && tesseract_->getDict().AddUserDictionary(dict);
+}
+
+bool TessBaseAPI::RemoveUserDictionary(UserDictionary* dict) {
+  return tesseract_ != NULL &&
+      tesseract_->getDict().RemoveUserDictionary(dict);
+}
+
+bool TessBaseAPI::ReplaceUserDictionary(UserDictionary* old_dict,
+                                        UserDictionary* new_dict) {
+  return tesseract_ != NULL &&
+      tesseract_->getDict().ReplaceUserDictionary(old_dict, new_dict);
+}
+
+char* TessBaseAPI::ExportAdaptiveClassifier(int* length) {
+  if (tesseract_ == NULL)
+    return NULL;
+  return tesseract_->ExportAdaptiveClassifier(length);
+}
+
+bool TessBaseAPI::ImportAdaptiveClassifier(const char* data, int length) {
+  return tesseract_ != NULL &&
+      tesseract_->ImportAdaptiveClassifier(data, length);
+}
+
+bool TessBaseAPI::CloneAdaptiveClassifierFrom(TessBaseAPI* source) {
+  int length;
+  char* data = source->ExportAdaptiveClassifier(&length);
+  if (data == NULL)
+    return false;
+  bool result = ImportAdaptiveClassifier(data, length);
+  delete [] data;
+  return result;
+}
+
 
 bool TessBaseAPI::GetTextDirection(int* out_offset, float* out_slope) {
   if (page_res_ == NULL)
@@ -1056,6 +1247,7 @@ bool TessBaseAPI::InternalSetImage() {
   }
   if (thresholder_ == NULL)
     thresholder_ = new ImageThresholder;
+  strip_source_ = NULL;
   ClearResults();
   return true;
 }
@@ -1063,13 +1255,16 @@ bool TessBaseAPI::InternalSetImage() {
 // Run the thresholder to make the thresholded image. If pix is not NULL,
 // the source is thresholded to pix instead of the internal IMAGE.
 void TessBaseAPI::Threshold(Pix** pix) {
+  PageStageTimer timer(tesseract_ != NULL ? &tesseract_->page_stats : NULL,
+                       PS_THRESHOLD);
+  AllocSubsystemScope alloc_scope(AS_CCMAIN);
 #ifdef HAVE_LIBLEPT
   if (pix != NULL)
     thresholder_->ThresholdToPix(pix);
   else
-    thresholder_->ThresholdToIMAGE(&page_image);
+    thresholder_->ThresholdToIMAGE(tesseract_->page_image());
 #else
-  thresholder_->ThresholdToIMAGE(&page_image);
+  thresholder_->ThresholdToIMAGE(tesseract_->page_image());
 #endif
   thresholder_->GetImageSizes(&rect_left_, &rect_top_,
                               &rect_width_, &rect_height_,
@@ -1086,6 +1281,12 @@ int TessBaseAPI::FindLines() {
     tesseract_ = new Tesseract;
     tesseract_->InitAdaptiveClassifier();
   }
+  if (strip_source_ != NULL) {
+    // The page is segmented as it is thresholded, without page_image.
+    StripThresholder strip_thresholder(strip_source_, strip_height_);
+    return tesseract_->SegmentPageStreamed(input_file_, &strip_thresholder,
+                                           block_list_);
+  }
 #ifdef HAVE_LIBLEPT
   if (tesseract_->pix_binary() == NULL)
     Threshold(tesseract_->mutable_pix_binary());
@@ -1093,12 +1294,13 @@ int TessBaseAPI::FindLines() {
   if (!threshold_done_)
     Threshold(NULL);
 
-  if (tesseract_->SegmentPage(input_file_, &page_image, block_list_) < 0)
+  IMAGE* page_image = tesseract_->page_image();
+  if (tesseract_->SegmentPage(input_file_, page_image, block_list_) < 0)
     return -1;
-  ASSERT_HOST(page_image.get_xsize() == rect_width_ ||
-              page_image.get_xsize() == rect_width_ - 1);
-  ASSERT_HOST(page_image.get_ysize() == rect_height_ ||
-              page_image.get_ysize() == rect_height_ - 1);
+  ASSERT_HOST(page_image->get_xsize() == rect_width_ ||
+              page_image->get_xsize() == rect_width_ - 1);
+  ASSERT_HOST(page_image->get_ysize() == rect_height_ ||
+              page_image->get_ysize() == rect_height_ - 1);
   return 0;
 }
 
@@ -1218,22 +1420,23 @@ static void fill_dummy_row(float baseline, float xheight,
 
 // Return a TBLOB * from the whole page_image.
 // To be freed later with free_blob().
-TBLOB *make_tesseract_blob(float baseline, float xheight,
+TBLOB *make_tesseract_blob(IMAGE* page_image,
+                           float baseline, float xheight,
                            float descender, float ascender) {
   BLOCK *block = new BLOCK("a character",
                            TRUE,
                            0, 0,
                            0, 0,
-                           page_image.get_xsize(),
-                           page_image.get_ysize());
+                           page_image->get_xsize(),
+                           page_image->get_ysize());
 
   // Create C_BLOBs from the page
   extract_edges(
 #ifndef GRAPHICS_DISABLED
 		NULL, 
 #endif
-		&page_image, &page_image,
-                ICOORD(page_image.get_xsize(), page_image.get_ysize()),
+		page_image, page_image,
+                ICOORD(page_image->get_xsize(), page_image->get_ysize()),
                 block);
 
   // Create one PBLOB from all C_BLOBs
@@ -1276,7 +1479,8 @@ void TessBaseAPI::AdaptToCharacter(const char *unichar_repr,
   fill_dummy_row(baseline, xheight, descender, ascender, &row);
   GetLineStatsFromRow(&row, &LineStats);
 
-  TBLOB *blob = make_tesseract_blob(baseline, xheight, descender, ascender);
+  TBLOB *blob = make_tesseract_blob(tesseract_->page_image(),
+                                    baseline, xheight, descender, ascender);
   float threshold;
   UNICHAR_ID best_class = 0;
   float best_rating = -100;
@@ -1493,6 +1697,7 @@ void TessBaseAPI::GetFeatures(INT_FEATURE_ARRAY int_features,
     ClearResults();
   if (!threshold_done_)
     Threshold(NULL);
+  IMAGE* page_image = tesseract_->page_image();
   // We have only one block, which is of the size of the page.
   BLOCK_LIST* blocks = new BLOCK_LIST;
   BLOCK *block = new BLOCK("",                       // filename.
@@ -1501,15 +1706,15 @@ void TessBaseAPI::GetFeatures(INT_FEATURE_ARRAY int_features,
                            0,                        // spacing.
                            0,                        // Left.
                            0,                        // Bottom.
-                           page_image.get_xsize(),   // Right.
-                           page_image.get_ysize());  // Top.
+                           page_image->get_xsize(),  // Right.
+                           page_image->get_ysize()); // Top.
   ICOORD bleft, tright;
   block->bounding_box (bleft, tright);
 
   BLOCK_IT block_it_add = blocks;
   block_it_add.add_to_end(block);
 
-  ICOORD page_tr(page_image.get_xsize(), page_image.get_ysize());
+  ICOORD page_tr(page_image->get_xsize(), page_image->get_ysize());
   TEXTROW tessrow;
   make_tess_row(NULL,       // Denormalizer.
                 &tessrow);  // Output row.
@@ -1523,13 +1728,13 @@ void TessBaseAPI::GetFeatures(INT_FEATURE_ARRAY int_features,
     BLOCK* block = block_it.data();
 #ifndef GRAPHICS_DISABLED
     extract_edges(NULL,         // Scrollview window.
-                  &page_image,  // Image.
-                  &page_image,  // Thresholded image.
+                  page_image,   // Image.
+                  page_image,   // Thresholded image.
                   page_tr,      // corner of page.
                   block);       // block.
 #else
-    extract_edges(&page_image,  // Image.
-                  &page_image,  // Thresholded image.
+    extract_edges(page_image,   // Image.
+                  page_image,   // Thresholded image.
                   page_tr,      // corner of page.
                   block);       // block.
 #endif
@@ -1540,7 +1745,7 @@ void TessBaseAPI::GetFeatures(INT_FEATURE_ARRAY int_features,
          blob_it.forward()) {
       C_BLOB* blob = blob_it.data();
       blob = blob;
-      PBLOB c_as_p(blob, page_image.get_ysize());
+      PBLOB c_as_p(blob, page_image->get_ysize());
       merge_blobs(pblob, &c_as_p);
     }
 
@@ -1551,7 +1756,7 @@ void TessBaseAPI::GetFeatures(INT_FEATURE_ARRAY int_features,
               0,           // Blanks in front.
               " ");        // Correct text.
     ROW *row = make_tess_ocrrow(0,                       // baseline.
-                                page_image.get_ysize(),  // xheight.
+                                page_image->get_ysize(), // xheight.
                                 0,                       // ascent.
                                 0);                      // descent.
     word.baseline_normalise(row);
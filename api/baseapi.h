@@ -52,6 +52,9 @@ typedef INT_FEATURE_STRUCT INT_FEATURE_ARRAY[MAX_NUM_INT_FEATURES];
 namespace tesseract {
 
 class Dict;
+class ImageStripSource;
+class AllocProfile;
+class PageStats;
 class Tesseract;
 class Trie;
 class CubeRecoContext;
@@ -59,6 +62,8 @@ class TesseractCubeCombiner;
 class CubeObject;
 class CubeLineObject;
 class Dawg;
+class LanguageModel;
+class UserDictionary;
 
 typedef int (Dict::*DictFunc)(void* void_dawg_args, int char_index,
                               const void *word, bool word_end);
@@ -110,13 +115,25 @@ class TESSDLL_API TessBaseAPI {
   // defaults on End().
   bool SetVariable(const char* variable, const char* value);
 
-  // Eventually instances will be thread-safe and totally independent,
-  // but for now, they all point to the same underlying engine,
-  // and are NOT RE-ENTRANT OR THREAD-SAFE. For now:
-  // it is safe to Init multiple TessBaseAPIs in the same language, use them
-  // sequentially, and End or delete them all, but once one is Ended, you can't
-  // do anything other than End the others. After End, it is safe to Init
-  // again on the same one.
+  // Instances may recognize at the same time on different threads, each
+  // instance being used by one thread at a time. The state of a page and
+  // of its recognition is owned by each instance, but the variables set
+  // through SetVariable and by the configs are global and shared by all
+  // instances, so Init, End and SetVariable must not be called while
+  // another instance is initializing or recognizing. The debug displays
+  // and the training outputs are shared by the process too, and should
+  // only be turned on with a single thread recognizing.
+  // Setting tessedit_pass2_threads to n before Init also makes an instance
+  // recognize the words of pass 2 of each page with n threads, with the
+  // same results. Pass 1 stays serial, as each word adapts the classifier
+  // for the next.
+  // Likewise chop_seam_threads set to n before Init makes an instance
+  // with chop_seam_candidates above 1 try the seam candidates of each chop
+  // with n threads, with the same results as with one.
+  // It is safe to Init multiple TessBaseAPIs in the same language, use them,
+  // and End or delete them all, but once one is Ended, you can't do anything
+  // other than End the others. After End, it is safe to Init again on the
+  // same one.
   //
   // Start tesseract. Returns zero on success and -1 on failure.
   // NOTE that the only members that may be called before Init are those
@@ -140,6 +157,29 @@ class TESSDLL_API TessBaseAPI {
     return Init(datapath, language, 0, 0, false);
   }
 
+  // Load the read-only data (pre-trained templates, normalization protos
+  // and dawgs) for the given language once, so that it can be shared by any
+  // number of instances through InitWithLanguageModel. The datapath and
+  // language are as for Init. Returns NULL on failure. The caller owns one
+  // reference to the returned model and must give it up with
+  // ReleaseLanguageModel, which may be done as soon as it has been passed
+  // to InitWithLanguageModel.
+  static LanguageModel* LoadLanguageModel(const char* datapath,
+                                          const char* language);
+  static void ReleaseLanguageModel(LanguageModel* model);
+
+  // Start tesseract like Init, in the language of model, but borrow the
+  // read-only data of the model instead of loading a private copy. The
+  // traineddata file is not read again: the unicharset is copied from the
+  // model. The adaptive classifier and the document dictionary stay private
+  // to this instance. The instance keeps the model alive until End.
+  int InitWithLanguageModel(const char* datapath, LanguageModel* model,
+                            char **configs, int configs_size,
+                            bool configs_global_only);
+  int InitWithLanguageModel(const char* datapath, LanguageModel* model) {
+    return InitWithLanguageModel(datapath, model, 0, 0, false);
+  }
+
   // Init only the lang model component of Tesseract. The only functions
   // that work after this init are SetVariable and IsValidWord.
   // WARNING: temporary! This function will be removed from here and placed
@@ -172,6 +212,9 @@ class TESSDLL_API TessBaseAPI {
   // have an effect, depending on the implementation.
   // The mode is stored as an INT_VARIABLE so it can also be modified by
   // ReadConfigFile or SetVariable("tessedit_accuracyvspeed", mode as string).
+  // With wordrec_beam_search on, the mode also sets the width of the
+  // segmentation beam, from the default at AVS_FASTEST to wide at
+  // AVS_MOST_ACCURATE, unless wordrec_beam_width is set.
   void SetAccuracyVSpeed(AccuracyVSpeed mode);
 
   // Recognize a rectangle from an image and return the result as a string.
@@ -222,6 +265,16 @@ class TESSDLL_API TessBaseAPI {
   // with less copies than an implementation that does not.
   void SetImage(const Pix* pix);
 
+  // Provide an image that is too large to hold in memory, to be read from
+  // source and thresholded a strip of strip_height lines at a time (0 for
+  // the default). Tesseract doesn't take ownership of the source, which
+  // must persist until after Recognize. As the whole image is never
+  // available, PSM_AUTO and PSM_SINGLE_COLUMN are done as PSM_SINGLE_BLOCK
+  // (or on the blocks of a UNLV zone file), and GetThresholdedImage and
+  // SetRectangle are not supported. The source is forgotten by the next
+  // SetImage or Clear.
+  void SetImageStripSource(ImageStripSource* source, int strip_height);
+
   // Restrict recognition to a sub-rectangle of the image. Call after SetImage.
   // Each SetRectangle clears the recogntion results so multiple rectangles
   // can be recognized with the same image.
@@ -265,6 +318,9 @@ class TESSDLL_API TessBaseAPI {
   // Deprecated. Use GetThresholdedImage and write the image using pixWrite
   // instead if possible.
   void DumpPGM(const char* filename);
+  // Write the internal binary image to filename, in the format given by
+  // its extension, as for the tessedit_write_images debug output.
+  void WriteThresholdedImage(const char* filename);
 
   // Recognize the image from SetAndThresholdImage, generating Tesseract
   // internal structures. Returns 0 on success.
@@ -298,6 +354,41 @@ class TESSDLL_API TessBaseAPI {
   // delimited words in GetUTF8Text.
   int* AllWordConfidences();
 
+  // Turns the timing of the recognition stages on or off. It is off by
+  // default, and then costs nothing measurable. Call after Init. The stats
+  // are reset by SetImage, SetRectangle and Clear, so they cover a single
+  // page (or rectangle), from thresholding to the last pass.
+  void SetPageStatsEnabled(bool enabled);
+  // Copies the stage times and counters gathered so far into stats.
+  // Returns false if there is no Tesseract to get them from.
+  bool GetPageStats(PageStats* stats) const;
+  // The stats of GetPageStats as a JSON object, such as
+  // {"threshold":{"usecs":1520,"calls":1},...,"seg_states":210}.
+  // Returned string must be freed with the delete [] operator.
+  char* GetPageStatsJSON() const;
+
+  // Turns the allocation profiler on or off. It is off by default. While it
+  // is on, each page recognized on a thread gets a profile of the memory
+  // allocated by each subsystem (textord, ccmain, wordrec, classify and
+  // dict), the subsystem running at the peak of the heap and the resident
+  // set size of the process before and after the page, with its peak. The
+  // allocations are only counted in builds with ENABLE_ALLOC_PROFILE
+  // defined; other builds report the resident set sizes only. If
+  // sample_kbytes is positive, the call stack of one allocation in about
+  // every sample_kbytes allocated kilobytes is recorded too, where the
+  // platform can capture it. Applies to all instances.
+  static void SetAllocProfileEnabled(bool enabled, int sample_kbytes);
+  // Copies the allocation profile of the last page recognized by Recognize
+  // into profile. Returns false if there is no Tesseract to get it from or
+  // the profiler is off.
+  bool GetAllocProfile(AllocProfile* profile) const;
+  // The profile of GetAllocProfile as a JSON object, such as
+  // {"start_live_bytes":0,...,"subsystems":{"other":{"allocs":12,...}},
+  // ...,"samples":[...]}. If symbols is true, the frames of the sampled
+  // stacks are given as symbols where they can be found.
+  // Returned string must be freed with the delete [] operator.
+  char* GetAllocProfileJSON(bool symbols) const;
+
   // Free up recognition results and any stored image data, without actually
   // freeing any recognition data that would be time-consuming to reload.
   // Afterwards, you must call SetImage or TesseractRect before doing
@@ -316,6 +407,46 @@ class TESSDLL_API TessBaseAPI {
   // in a separate API at some future time.
   int IsValidWord(const char *word);
 
+  // Builds a user dictionary of the words in the given file, one per line,
+  // or of the given num_words UTF-8 words, for the language and unicharset
+  // of this instance. Returns NULL on failure. The dictionary can be added
+  // to any instance of the same language, such as all the instances that
+  // share a LanguageModel. The caller owns one reference to it and must
+  // give it up with ReleaseUserDictionary, which may be done as soon as it
+  // has been added.
+  UserDictionary* LoadUserDictionary(const char* filename);
+  UserDictionary* CreateUserDictionary(const char* const* words,
+                                       int num_words);
+  static void ReleaseUserDictionary(UserDictionary* dict);
+
+  // Adds a user dictionary to the dictionaries searched by the recognizer,
+  // removes it, or swaps one for another, without having to End and Init
+  // again. Each instance holds a reference to the dictionaries it searches
+  // until they are removed or End is called. Return false if the
+  // dictionary was built for another language, or is already added (Add
+  // and the new one of Replace) or not added (Remove and the old one of
+  // Replace). Must not be called during recognition.
+  bool AddUserDictionary(UserDictionary* dict);
+  bool RemoveUserDictionary(UserDictionary* dict);
+  bool ReplaceUserDictionary(UserDictionary* old_dict,
+                             UserDictionary* new_dict);
+
+  // Returns a snapshot of what the adaptive classifier has learned so far,
+  // as a buffer of *length bytes that the caller must delete with
+  // delete [], or NULL if the adaptive classifier is not in use. The
+  // snapshot can be given to ImportAdaptiveClassifier of any instance of
+  // the same language on the same kind of machine, so that documents from
+  // the same source start from a warmed-up classifier.
+  char* ExportAdaptiveClassifier(int* length);
+  // Replaces the adaptive state with that of a snapshot from
+  // ExportAdaptiveClassifier. Returns false, leaving the state unchanged,
+  // if the snapshot is malformed or was made for another language.
+  // Must not be called during recognition.
+  bool ImportAdaptiveClassifier(const char* data, int length);
+  // Copies the adaptive state of source into this instance, as an export
+  // followed by an import. Returns false on failure.
+  bool CloneAdaptiveClassifierFrom(TessBaseAPI* source);
+
   bool GetTextDirection(int* out_offset, float* out_slope);
 
   // Set the letter_is_okay function to point somewhere else.
@@ -439,7 +570,9 @@ class TESSDLL_API TessBaseAPI {
  protected:
    Tesseract*        tesseract_;       // The underlying data object.
    ImageThresholder* thresholder_;     // Image thresholding module.
-   bool              threshold_done_;  // Image has been passed to page_image.
+   bool              threshold_done_;  // Image has been thresholded.
+   ImageStripSource* strip_source_;    // Streamed image, if not NULL.
+   int               strip_height_;    // Lines per strip of strip_source_.
    BLOCK_LIST*       block_list_;      // The page layout.
    PAGE_RES*         page_res_;        // The page-level data.
    STRING*           input_file_;      // Name used by training code.
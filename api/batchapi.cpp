@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////
+// File:        batchapi.cpp
+// Description: API for recognizing many pages with a pool of workers.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
+#ifdef HAVE_LIBLEPT
+// Include leptonica library only if autoconf (or makefile etc) tell us to.
+#include "allheaders.h"
+#endif
+
+#include <string.h>
+
+#include "batchapi.h"
+#include "ccutil.h"
+#include "genericvector.h"
+#include "langmodel.h"
+#include "ocrclass.h"
+#include "strngs.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+// A page of the batch: where its image comes from and its result.
+struct BatchPage {
+  BatchPage()
+    : imagedata(NULL), width(0), height(0), bytes_per_pixel(0),
+      bytes_per_line(0), pix(NULL), file_page(-1), text(NULL),
+      done(false), cancelled(false), batch(NULL) {
+  }
+  ~BatchPage() {
+    delete [] text;
+  }
+
+  // Raw image data, if not NULL.
+  const unsigned char* imagedata;
+  int width;
+  int height;
+  int bytes_per_pixel;
+  int bytes_per_line;
+  // Leptonica image, if not NULL.
+  const Pix* pix;
+  // Image file and page within it, if file_page >= 0.
+  STRING filename;
+  int file_page;
+
+  // UTF-8 text, or NULL if the page failed.
+  char* text;
+  bool done;
+  bool cancelled;
+  // Progress monitor handed to the recognizer of this page.
+  ETEXT_DESC monitor;
+  TessBatchAPI* batch;
+};
+
+struct BatchState {
+  BatchState()
+    : next_page(0), next_result(0), num_succeeded(0), num_started(0),
+      result_func(NULL), result_this(NULL),
+      monitor_func(NULL), monitor_this(NULL) {
+  }
+
+  GenericVector<TessBaseAPI*> workers;
+  GenericVector<BatchPage*> pages;
+  // Protects everything below while a Run is in progress.
+  CCUtilMutex mutex;
+  int next_page;        // Next page to hand out to a worker.
+  int next_result;      // Next page to deliver.
+  int num_succeeded;    // Pages recognized successfully.
+  int num_started;      // Workers that have picked up their recognizer.
+  PAGE_RESULT_FUNC result_func;
+  void* result_this;
+  PAGE_MONITOR_FUNC monitor_func;
+  void* monitor_this;
+};
+
+TessBatchAPI::TessBatchAPI()
+  : language_model_(NULL), state_(new BatchState) {
+}
+
+TessBatchAPI::~TessBatchAPI() {
+  End();
+  delete state_;
+}
+
+// Loads the language once and attaches it to num_workers recognizers.
+int TessBatchAPI::Init(const char* datapath, const char* language,
+                       int num_workers) {
+  End();
+  if (num_workers < 1)
+    num_workers = 1;
+  language_model_ = TessBaseAPI::LoadLanguageModel(datapath, language);
+  if (language_model_ == NULL)
+    return -1;
+  for (int i = 0; i < num_workers; ++i) {
+    TessBaseAPI* api = new TessBaseAPI;
+    if (api->InitWithLanguageModel(datapath, language_model_) != 0) {
+      delete api;
+      End();
+      return -1;
+    }
+    state_->workers.push_back(api);
+  }
+  return 0;
+}
+
+void TessBatchAPI::SetPageSegMode(PageSegMode mode) {
+  for (int i = 0; i < state_->workers.size(); ++i)
+    state_->workers[i]->SetPageSegMode(mode);
+}
+
+UserDictionary* TessBatchAPI::LoadUserDictionary(const char* filename) {
+  if (state_->workers.empty())
+    return NULL;
+  return state_->workers[0]->LoadUserDictionary(filename);
+}
+
+// The workers all have the same language, so a dictionary fits all of them
+// or none, and only the first can refuse it.
+bool TessBatchAPI::AddUserDictionary(UserDictionary* dict) {
+  if (state_->workers.empty() || !state_->workers[0]->AddUserDictionary(dict))
+    return false;
+  for (int i = 1; i < state_->workers.size(); ++i)
+    state_->workers[i]->AddUserDictionary(dict);
+  return true;
+}
+
+bool TessBatchAPI::RemoveUserDictionary(UserDictionary* dict) {
+  if (state_->workers.empty() ||
+      !state_->workers[0]->RemoveUserDictionary(dict))
+    return false;
+  for (int i = 1; i < state_->workers.size(); ++i)
+    state_->workers[i]->RemoveUserDictionary(dict);
+  return true;
+}
+
+bool TessBatchAPI::ReplaceUserDictionary(UserDictionary* old_dict,
+                                         UserDictionary* new_dict) {
+  if (state_->workers.empty() ||
+      !state_->workers[0]->ReplaceUserDictionary(old_dict, new_dict))
+    return false;
+  for (int i = 1; i < state_->workers.size(); ++i)
+    state_->workers[i]->ReplaceUserDictionary(old_dict, new_dict);
+  return true;
+}
+
+bool TessBatchAPI::ImportAdaptiveClassifier(const char* data, int length) {
+  if (state_->workers.empty() ||
+      !state_->workers[0]->ImportAdaptiveClassifier(data, length))
+    return false;
+  for (int i = 1; i < state_->workers.size(); ++i)
+    state_->workers[i]->ImportAdaptiveClassifier(data, length);
+  return true;
+}
+
+void TessBatchAPI::AddPage(const unsigned char* imagedata,
+                           int width, int height,
+                           int bytes_per_pixel, int bytes_per_line) {
+  BatchPage* page = new BatchPage;
+  page->imagedata = imagedata;
+  page->width = width;
+  page->height = height;
+  page->bytes_per_pixel = bytes_per_pixel;
+  page->bytes_per_line = bytes_per_line;
+  state_->pages.push_back(page);
+}
+
+void TessBatchAPI::AddPage(const Pix* pix) {
+  BatchPage* page = new BatchPage;
+  page->pix = pix;
+  state_->pages.push_back(page);
+}
+
+bool TessBatchAPI::AddImageFile(const char* filename) {
+#ifdef HAVE_LIBLEPT
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL)
+    return false;
+  int num_pages = 1;
+  int format = findFileFormat(fp);
+  if (format >= IFF_TIFF && format <= IFF_TIFF_ZIP) {
+    rewind(fp);
+    if (tiffGetCount(fp, &num_pages) != 0)
+      num_pages = 0;
+  }
+  fclose(fp);
+  if (format == IFF_UNKNOWN || num_pages <= 0)
+    return false;
+  for (int i = 0; i < num_pages; ++i) {
+    BatchPage* page = new BatchPage;
+    page->filename = filename;
+    page->file_page = i;
+    state_->pages.push_back(page);
+  }
+  return true;
+#else
+  tprintf("Reading image files for a batch requires leptonica\n");
+  return false;
+#endif
+}
+
+int TessBatchAPI::NumPages() const {
+  return state_->pages.size();
+}
+
+int TessBatchAPI::Run(PAGE_RESULT_FUNC result_func, void* result_this,
+                      PAGE_MONITOR_FUNC monitor_func, void* monitor_this) {
+  if (state_->workers.empty())
+    return -1;
+  state_->next_page = 0;
+  state_->next_result = 0;
+  state_->num_succeeded = 0;
+  state_->num_started = 0;
+  state_->result_func = result_func;
+  state_->result_this = result_this;
+  state_->monitor_func = monitor_func;
+  state_->monitor_this = monitor_this;
+
+  RunThreads();
+
+  int num_succeeded = state_->num_succeeded;
+  state_->pages.delete_data_pointers();
+  state_->pages.truncate(0);
+  return num_succeeded;
+}
+
+// Runs the workers over all the pages, each in its own thread.
+void TessBatchAPI::RunThreads() {
+  int num_threads = state_->workers.size();
+  if (num_threads > state_->pages.size())
+    num_threads = state_->pages.size();
+  CCUtilThread* threads = new CCUtilThread[num_threads];
+  int num_running = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    if (threads[i].Start(&WorkerMain, this))
+      ++num_running;
+  }
+  // If no thread could be started, do the work here.
+  if (num_running == 0 && num_threads > 0)
+    WorkerMain(this);
+  for (int i = 0; i < num_threads; ++i)
+    threads[i].Join();
+  delete [] threads;
+}
+
+void TessBatchAPI::End() {
+  for (int i = 0; i < state_->workers.size(); ++i)
+    delete state_->workers[i];
+  // clear() would leave the vectors unfit for the pages and workers of the
+  // next Run or Init, so they only lose their contents.
+  state_->workers.truncate(0);
+  state_->pages.delete_data_pointers();
+  state_->pages.truncate(0);
+  // The workers hold their own references, so this can only be the last
+  // one once they are gone.
+  TessBaseAPI::ReleaseLanguageModel(language_model_);
+  language_model_ = NULL;
+}
+
+// static
+void* TessBatchAPI::WorkerMain(void* arg) {
+  TessBatchAPI* batch = reinterpret_cast<TessBatchAPI*>(arg);
+  BatchState* state = batch->state_;
+  state->mutex.Lock();
+  TessBaseAPI* api = state->workers[state->num_started++];
+  state->mutex.Unlock();
+  batch->RunWorker(api);
+  return NULL;
+}
+
+void TessBatchAPI::RunWorker(TessBaseAPI* api) {
+  BatchState* state = state_;
+  for (;;) {
+    state->mutex.Lock();
+    if (state->next_page >= state->pages.size()) {
+      state->mutex.Unlock();
+      break;
+    }
+    int page_index = state->next_page++;
+    state->mutex.Unlock();
+
+    RecognizePage(api, page_index);
+
+    BatchPage* page = state->pages[page_index];
+    char* text = page->text;
+    page->text = NULL;
+    FinishPage(page_index, text);
+  }
+}
+
+void TessBatchAPI::FinishPage(int page_index, char* text) {
+  BatchState* state = state_;
+  state->mutex.Lock();
+  BatchPage* page = state->pages[page_index];
+  page->text = text;
+  page->done = true;
+  if (text != NULL)
+    ++state->num_succeeded;
+  DeliverResults();
+  state->mutex.Unlock();
+}
+
+void TessBatchAPI::RecognizePage(TessBaseAPI* api, int page_index) {
+  BatchPage* page = state_->pages[page_index];
+  page->batch = this;
+  ETEXT_DESC* monitor = &page->monitor;
+  memset(monitor, 0, sizeof(*monitor));
+  monitor->cancel = &CancelPage;
+  monitor->cancel_this = page;
+  monitor->page_number = page_index;
+
+  const Pix* pix = page->pix;
+#ifdef HAVE_LIBLEPT
+  Pix* file_pix = NULL;
+  if (page->file_page >= 0) {
+    file_pix = page->file_page > 0
+             ? pixReadTiff(page->filename.string(), page->file_page)
+             : pixRead(page->filename.string());
+    if (file_pix == NULL) {
+      tprintf("Failed to read page %d of %s\n", page->file_page,
+              page->filename.string());
+      return;
+    }
+    pix = file_pix;
+  }
+#endif
+
+  api->SetInputName(page->filename.length() > 0 ? page->filename.string()
+                                                : NULL);
+  if (pix != NULL) {
+    api->SetImage(pix);
+  } else if (page->imagedata != NULL) {
+    api->SetImage(page->imagedata, page->width, page->height,
+                  page->bytes_per_pixel, page->bytes_per_line);
+  }
+  if (api->Recognize(monitor) == 0 && !page->cancelled)
+    page->text = api->GetUTF8Text();
+  api->Clear();
+
+#ifdef HAVE_LIBLEPT
+  if (file_pix != NULL)
+    pixDestroy(&file_pix);
+#endif
+}
+
+// Must be called with the mutex of the state held.
+void TessBatchAPI::DeliverResults() {
+  BatchState* state = state_;
+  while (state->next_result < state->pages.size() &&
+         state->pages[state->next_result]->done) {
+    BatchPage* page = state->pages[state->next_result];
+    if (state->result_func != NULL)
+      (*state->result_func)(state->result_this, state->next_result,
+                            page->text);
+    delete [] page->text;
+    page->text = NULL;
+    ++state->next_result;
+  }
+}
+
+// static
+bool TessBatchAPI::CancelPage(void* cancel_this, int words) {
+  BatchPage* page = reinterpret_cast<BatchPage*>(cancel_this);
+  BatchState* state = page->batch->state_;
+  if (state->monitor_func == NULL)
+    return false;
+  // The monitor function is called by one worker at a time.
+  state->mutex.Lock();
+  if ((*state->monitor_func)(state->monitor_this, &page->monitor, words))
+    page->cancelled = true;
+  state->mutex.Unlock();
+  return page->cancelled;
+}
+
+}  // namespace tesseract.
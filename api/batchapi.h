@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////
+// File:        batchapi.h
+// Description: API for recognizing many pages with a pool of workers.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_BATCHAPI_H__
+#define TESSERACT_API_BATCHAPI_H__
+
+#include "baseapi.h"
+
+struct Pix;
+struct ETEXT_STRUCT;
+
+namespace tesseract {
+
+class LanguageModel;
+class UserDictionary;
+struct BatchPage;
+struct BatchState;
+
+// Called once per page, in page order, with the UTF-8 text of the page, or
+// NULL if the page could not be read or recognized or was cancelled.
+// The text belongs to the batch and is only valid during the call.
+typedef void (*PAGE_RESULT_FUNC)(void* result_this, int page,
+                                 const char* text);
+
+// Called whenever the recognizer of a page reports progress. The monitor
+// holds the page_number and the progress of the page. Returning true
+// cancels the recognition of that page only.
+typedef bool (*PAGE_MONITOR_FUNC)(void* monitor_this,
+                                  const ETEXT_STRUCT* monitor, int words);
+
+// TessBatchAPI recognizes a list of pages with a pool of worker threads.
+// Each worker has its own TessBaseAPI, and all of them share one
+// LanguageModel, so extra workers cost little memory or startup time.
+// Pages are handed out to the workers in order, recognized in parallel, and
+// their results are delivered in page order through a callback. As the
+// variables are global (see TessBaseAPI), no other instance may be
+// initialized or have its variables set while Run is in progress.
+class TESSDLL_API TessBatchAPI {
+ public:
+  TessBatchAPI();
+  ~TessBatchAPI();
+
+  // Loads the language (see TessBaseAPI::Init for datapath and language)
+  // and sets up num_workers recognizers. Returns 0 on success, -1 on failure.
+  int Init(const char* datapath, const char* language, int num_workers);
+
+  // Sets the page segmentation mode of all the workers.
+  void SetPageSegMode(PageSegMode mode);
+
+  // Builds a user dictionary for the language of the batch, as
+  // TessBaseAPI::LoadUserDictionary does. Returns NULL on failure.
+  UserDictionary* LoadUserDictionary(const char* filename);
+  // Adds, removes or swaps a user dictionary in all the workers, as the
+  // methods of TessBaseAPI of the same names do. Must not be called while
+  // Run is in progress.
+  bool AddUserDictionary(UserDictionary* dict);
+  bool RemoveUserDictionary(UserDictionary* dict);
+  bool ReplaceUserDictionary(UserDictionary* old_dict,
+                             UserDictionary* new_dict);
+
+  // Starts every worker from the adaptive classifier snapshot made by
+  // TessBaseAPI::ExportAdaptiveClassifier, such as one saved from an
+  // earlier batch of the same source. Returns false if the snapshot does
+  // not fit. Must not be called while Run is in progress.
+  bool ImportAdaptiveClassifier(const char* data, int length);
+
+  // Adds a page given as raw image data, in the format of
+  // TessBaseAPI::SetImage. The data must stay valid until Run returns.
+  void AddPage(const unsigned char* imagedata, int width, int height,
+               int bytes_per_pixel, int bytes_per_line);
+
+  // Adds a page given as a Pix (leptonica builds only). The Pix must stay
+  // valid until Run returns.
+  void AddPage(const Pix* pix);
+
+  // Adds every page of the given image file, which may be a multi-page tiff.
+  // The pages are read by the workers. Needs leptonica; returns false if it
+  // is not available or the file cannot be read.
+  bool AddImageFile(const char* filename);
+
+  // Returns the number of pages added since the last Run.
+  int NumPages() const;
+
+  // Recognizes all the added pages and calls result_func for each of them
+  // in page order. monitor_func may be NULL. Both are called from the
+  // worker threads, one call at a time. Returns the number of pages
+  // recognized successfully, or -1 if Init has not succeeded. The page list
+  // is then cleared.
+  int Run(PAGE_RESULT_FUNC result_func, void* result_this,
+          PAGE_MONITOR_FUNC monitor_func, void* monitor_this);
+
+  // Frees the workers and the language model.
+  void End();
+
+ private:
+  // Runs the workers in threads.
+  void RunThreads();
+  // Thread entry point; arg is the TessBatchAPI.
+  static void* WorkerMain(void* arg);
+  // Recognizes pages with the given worker until there are none left.
+  void RunWorker(TessBaseAPI* api);
+  // Recognizes one page and stores its text.
+  void RecognizePage(TessBaseAPI* api, int page_index);
+  // Marks the page done with the given text, which may be NULL and which
+  // the batch takes, and delivers the results that are ready.
+  void FinishPage(int page_index, char* text);
+  // Delivers the results of all finished pages that are next in order.
+  void DeliverResults();
+  // CANCEL_FUNC installed in the monitor of each page.
+  static bool CancelPage(void* cancel_this, int words);
+
+  LanguageModel* language_model_;
+  // Workers, pages and the state of the current Run.
+  BatchState* state_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_API_BATCHAPI_H__
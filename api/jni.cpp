@@ -192,7 +192,7 @@ void test_ocr(const char *infile, int x, int y, int bpp,
 	LOGI("recognize\n");
 	char * text = api.GetUTF8Text();
 	if (tessedit_write_images) {
-		page_image.write("tessinput.tif");
+		api.WriteThresholdedImage("tessinput.tif");
 	}
 	FAILIF(text == NULL, "didn't recognize\n");
 
@@ -257,11 +257,11 @@ ocr_open(JNIEnv *env, jobject thiz, jstring lang)
     return res;
 }
 
-static void dump_debug_data(char *text)
+static void dump_debug_data(tesseract::TessBaseAPI *api, char *text)
 {
 #if DEBUG
 	if (tessedit_write_images) {
-		page_image.write(TESSBASE "tessinput.tif");
+		api->WriteThresholdedImage(TESSBASE "tessinput.tif");
 	}
 
     if (text) {
@@ -401,7 +401,7 @@ ocr_recognize(JNIEnv *env, jobject thiz)
 	char * text = nat->api.GetUTF8Text();
     LOGI("AFTER RECOGNIZE");
 
-    dump_debug_data(text);
+    dump_debug_data(&nat->api, text);
 
     // Will that work on a NULL?
     return env->NewStringUTF(text);
@@ -153,7 +153,7 @@ void TesseractImage(const char* input_file, IMAGE* image, Pix* pix,
     }
   }
   if (tessedit_write_images) {
-    page_image.write("tessinput.tif");
+    api->WriteThresholdedImage("tessinput.tif");
   }
 }
 
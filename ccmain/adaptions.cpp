@@ -209,13 +209,16 @@ void Tesseract::collect_ems_for_adaption(WERD_RES *word,
   WERD copy_outword;             // copy to denorm
   PBLOB_IT copy_blob_it;
   OUTLINE_IT copy_outline_it;
-  inT32 resolution = page_image.get_res ();
+  inT32 resolution = page_resolution ();
 
   if (tessedit_reject_ems || tessedit_reject_suspect_ems)
     return;                      // Do nothing
 
   if (word->word->bounding_box ().height () > resolution / 3)
     return;
+  // A page segmented in strips has no image to clip the samples from.
+  if (page_image_.get_bpp() == 0)
+    return;
 
   if (tessedit_demo_adaption)
                                  // Make sure not set
@@ -252,7 +255,7 @@ void Tesseract::collect_ems_for_adaption(WERD_RES *word,
       copy_outword = *(word->outword);
 
     copy_outword.baseline_denormalise (&word->denorm);
-    char_clip_word(&copy_outword, page_image, pixrow_list, imlines, pix_box);
+    char_clip_word(&copy_outword, page_image_, pixrow_list, imlines, pix_box);
     pixrow_it.set_to_list (pixrow_list);
     pixrow_it.move_to_first ();
 
@@ -272,6 +275,7 @@ void Tesseract::collect_ems_for_adaption(WERD_RES *word,
         #endif
         if (tessedit_matrix_match) {
           sample = clip_sample (pixrow_it.data (),
+            page_image_,
             imlines,
             pix_box,
             copy_outword.flag (W_INVERSE),
@@ -319,10 +323,13 @@ void Tesseract::collect_characters_for_adaption(
   TBOX pix_box;                   // box of imlines
   // extent
   WERD copy_outword;             // copy to denorm
-  inT32 resolution = page_image.get_res ();
+  inT32 resolution = page_resolution ();
 
   if (word->word->bounding_box ().height () > resolution / 3)
     return;
+  // A page segmented in strips has no image to clip the samples from.
+  if (page_image_.get_bpp() == 0)
+    return;
 
   if (tessedit_demo_adaption)
                                  // Make sure not set
@@ -335,7 +342,7 @@ void Tesseract::collect_characters_for_adaption(
     /* Collect information about good matches */
     copy_outword = *(word->outword);
     copy_outword.baseline_denormalise (&word->denorm);
-    char_clip_word(&copy_outword, page_image, pixrow_list, imlines, pix_box);
+    char_clip_word(&copy_outword, page_image_, pixrow_list, imlines, pix_box);
     pixrow_it.set_to_list (pixrow_list);
     pixrow_it.move_to_first ();
 
@@ -355,6 +362,7 @@ void Tesseract::collect_characters_for_adaption(
             word->best_choice->unichar_string().string (), i);
         #endif
         sample = clip_sample (pixrow_it.data (),
+          page_image_,
           imlines,
           pix_box,
           copy_outword.flag (W_INVERSE),
@@ -555,7 +563,7 @@ void Tesseract::adapt_to_good_ems(WERD_RES *word,
   ScrollView* demo_win = NULL;
 #endif
 
-  inT32 resolution = page_image.get_res ();
+  inT32 resolution = page_resolution ();
 
   if (word->word->bounding_box ().height () > resolution / 3)
     return;
@@ -572,6 +580,9 @@ void Tesseract::adapt_to_good_ems(WERD_RES *word,
   else if (tessedit_reject_suspect_ems)
     reject_suspect_ems(word);
   else {
+    // A page segmented in strips has no image to clip the samples from.
+    if (page_image_.get_bpp() == 0)
+      return;
     if (char_clusters->length () == 0) {
       #ifndef SECURE_NAMES
       if (tessedit_cluster_debug)
@@ -618,7 +629,7 @@ void Tesseract::adapt_to_good_ems(WERD_RES *word,
 
       copy_outword.baseline_denormalise (&word->denorm);
       copy_blob_it.set_to_list (copy_outword.blob_list ());
-      char_clip_word(&copy_outword, page_image, pixrow_list, imlines, pix_box);
+      char_clip_word(&copy_outword, page_image_, pixrow_list, imlines, pix_box);
       pixrow_it.set_to_list (pixrow_list);
       pixrow_it.move_to_first ();
 
@@ -652,6 +663,7 @@ void Tesseract::adapt_to_good_ems(WERD_RES *word,
             TBOX copy_box = copy_blob_it.data ()->bounding_box ();
 
             sample = clip_sample (pixrow_it.data (),
+              page_image_,
               imlines,
               pix_box,
               copy_outword.flag (W_INVERSE),
@@ -743,7 +755,7 @@ void Tesseract::adapt_to_good_ems(WERD_RES *word,
 #ifndef GRAPHICS_DISABLED
               demo_win =
                 display_clip_image(&copy_outword,
-                                   page_image,
+                                   page_image_,
                                    pixrow_list,
                                    pix_box);
 #endif
@@ -793,7 +805,7 @@ void Tesseract::adapt_to_good_samples(WERD_RES *word,
   ScrollView* demo_win = NULL;
 #endif
 
-  inT32 resolution = page_image.get_res ();
+  inT32 resolution = page_resolution ();
 
   word_number++;
 
@@ -802,6 +814,9 @@ void Tesseract::adapt_to_good_samples(WERD_RES *word,
 
   if (word->word->bounding_box ().height () > resolution / 3)
     return;
+  // A page segmented in strips has no image to clip the samples from.
+  if (page_image_.get_bpp() == 0)
+    return;
 
   if (char_clusters->length () == 0) {
     #ifndef SECURE_NAMES
@@ -828,7 +843,7 @@ void Tesseract::adapt_to_good_samples(WERD_RES *word,
     copy_outword = *(word->outword);
     copy_outword.baseline_denormalise (&word->denorm);
     copy_blob_it.set_to_list (copy_outword.blob_list ());
-    char_clip_word(&copy_outword, page_image, pixrow_list, imlines, pix_box);
+    char_clip_word(&copy_outword, page_image_, pixrow_list, imlines, pix_box);
     pixrow_it.set_to_list (pixrow_list);
     pixrow_it.move_to_first ();
 
@@ -858,6 +873,7 @@ void Tesseract::adapt_to_good_samples(WERD_RES *word,
             word_number, i);
 
         sample = clip_sample (pixrow_it.data (),
+          page_image_,
           imlines,
           pix_box,
           copy_outword.flag (W_INVERSE),
@@ -934,7 +950,7 @@ void Tesseract::adapt_to_good_samples(WERD_RES *word,
 #ifndef GRAPHICS_DISABLED
             demo_win =
               display_clip_image(&copy_outword,
-                                 page_image,
+                                 page_image_,
                                  pixrow_list,
                                  pix_box);
 #endif
@@ -978,6 +994,7 @@ void print_em_stats(CHAR_SAMPLES_LIST *char_clusters,
 
 CHAR_SAMPLE *clip_sample(              //lines of the image
                          PIXROW *pixrow,
+                         IMAGE &page_image,  //image of page
                          IMAGELINE *imlines,
                          TBOX pix_box,  //box of imlines extent
                          BOOL8 white_on_black,
@@ -76,6 +76,7 @@ void print_em_stats(CHAR_SAMPLES_LIST *char_clusters,
                     CHAR_SAMPLE_LIST *chars_waiting);
                                  //lines of the image
 CHAR_SAMPLE *clip_sample(PIXROW *pixrow,
+                         IMAGE &page_image,  //image of page
                          IMAGELINE *imlines,
                          TBOX pix_box,  //box of imlines extent
                          BOOL8 white_on_black,
@@ -34,7 +34,7 @@ namespace tesseract {
 // Sets flags necessary for ambigs training mode.
 // Opens and returns the pointer to the output file.
 FILE *Tesseract::init_ambigs_training(const STRING &fname) {
-  permute_only_top = 1;                        // use only top choice permuter
+  getDict().set_permute_only_top(true);        // use only top choice permuter
   tessedit_tess_adaption_mode.set_value(0);    // turn off adaption
   tessedit_ok_mode.set_value(0);               // turn off context checking
   tessedit_enable_doc_dict.set_value(0);       // turn off document dictionary
@@ -72,8 +72,6 @@ EXTERN BOOL_VAR(learn_chars_and_char_frags_mode, FALSE,
                 " special low exposure mode) as well as unfragmented"
                 " characters.");
 
-extern IMAGE page_image;
-
 // The unicharset used during box training
 static UNICHARSET unicharset_boxes;
 
@@ -53,7 +53,6 @@ float Tesseract::compare_tess_blobs(TBLOB *blob1,
   set_all_bits (AllProtosOn, WordsInVectorOfSize (MAX_NUM_PROTOS));
   set_all_bits (AllConfigsOn, WordsInVectorOfSize (MAX_NUM_CONFIGS));
 
-  EnterClassifyMode;
   ad_templates = NewAdaptedTemplates (false);
   GetLineStatsFromRow(row1, &line_stats1);
                                  /*copy baseline stuff */
@@ -64,8 +63,8 @@ float Tesseract::compare_tess_blobs(TBLOB *blob1,
   fcount = GetAdaptiveFeatures (blob2, &line_stats2,
     int_features, &float_features);
   if (fcount > 0) {
-    SetBaseLineMatch();
-    IntegerMatcher (ClassForClassId (ad_templates->Templates, CMP_CLASS),
+    im_.SetBaseLineMatch();
+    im_.Match(ClassForClassId (ad_templates->Templates, CMP_CLASS),
       AllProtosOn, AllConfigsOn, fcount, fcount,
       int_features, 0, &int_result, testedit_match_debug);
     FreeFeatureSet(float_features);
@@ -32,8 +32,6 @@
 
 EXTERN INT_VAR (pix_word_margin, 3, "How far outside word BB to grow");
 
-extern IMAGE page_image;
-
 ELISTIZE (PIXROW)
 /*************************************************************************
  * PIXROW::PIXROW()
@@ -51,7 +51,10 @@
 #include "tordvars.h"
 #include "adaptmatch.h"
 #include "globals.h"
+#include "beamsearch.h"
 #include "tesseractclass.h"
+#include "langmodel.h"
+#include "chopper.h"
 
 #define MIN_FONT_ROW_COUNT  8
 #define MAX_XHEIGHT_DIFF  3
@@ -147,6 +150,9 @@ EXTERN INT_VAR (tessedit_test_adaption_mode, 3,
 EXTERN BOOL_VAR(save_best_choices, FALSE,
                 "Save the results of the recognition step"
 " (blob_choices) within the corresponding WERD_CHOICE");
+EXTERN INT_VAR(tessedit_pass2_threads, 1,
+               "Threads to recognize the words of pass 2 with,"
+               " read by Init");
 
 EXTERN BOOL_VAR (test_pt, FALSE, "Test for point");
 EXTERN double_VAR (test_pt_x, 99999.99, "xcoord");
@@ -229,30 +235,33 @@ void Tesseract::recog_all_words(                            //process words
                                 //0 - all, 1 just pass 1, 2 passes 2 and higher
                                 inT16 dopasses
                                ) {
+  AllocSubsystemScope alloc_scope(AS_CCMAIN);
                                  //reset page iterator
-  static PAGE_RES_IT page_res_it;
+  PAGE_RES_IT &page_res_it = recog_page_res_it_;
   inT16 chars_in_word;
   inT16 rejects_in_word;
-  static CHAR_SAMPLES_LIST em_clusters;
-  static CHAR_SAMPLE_LIST ems_waiting;
-  static CHAR_SAMPLES_LIST char_clusters;
-  static CHAR_SAMPLE_LIST chars_waiting;
+  CHAR_SAMPLES_LIST &em_clusters = em_clusters_;
+  CHAR_SAMPLE_LIST &ems_waiting = ems_waiting_;
+  CHAR_SAMPLES_LIST &char_clusters = char_clusters_;
+  CHAR_SAMPLE_LIST &chars_waiting = chars_waiting_;
   inT16 blob_quality = 0;
   inT16 outline_errs = 0;
-  static inT16 doc_blob_quality = 0;
-  static inT16 doc_outline_errs = 0;
-  static inT16 doc_char_quality = 0;
+  inT16 &doc_blob_quality = doc_blob_quality_;
+  inT16 &doc_outline_errs = doc_outline_errs_;
+  inT16 &doc_char_quality = doc_char_quality_;
   inT16 all_char_quality;
   inT16 accepted_all_char_quality;
-  static inT16 good_char_count = 0;
-  static inT16 doc_good_char_quality = 0;
+  inT16 &good_char_count = good_char_count_;
+  inT16 &doc_good_char_quality = doc_good_char_quality_;
   int i;
 
 
   inT32 tess_adapt_mode = 0;
-  static inT32 word_count;              //count of words in doc
+  inT32 &word_count = doc_word_count_;  //count of words in doc
   inT32 word_index;              //current word
-  static int dict_words;
+  int &dict_words = doc_dict_words_;
+
+  set_beam_width_hint(BeamWidthForAccuracyVSpeed(tessedit_accuracyvspeed));
 
   if (tessedit_minimal_rej_pass1) {
     tessedit_test_adaption.set_value (TRUE);
@@ -270,6 +279,7 @@ if (dopasses==0 || dopasses==1)
 {
 	page_res_it.page_res=page_res;
 	page_res_it.restart_page();
+  StartClassifierCachePage();
 
   /* Pass 1 */
   word_count = 0;
@@ -308,8 +318,11 @@ if (dopasses==0 || dopasses==1)
                                                          dict_words)))
         return;
     }
-    classify_word_pass1(page_res_it.word(), page_res_it.row()->row,
-                        page_res_it.block()->block, FALSE, NULL, NULL);
+    {
+      PageStageTimer timer(&page_stats, PS_PASS1);
+      classify_word_pass1(page_res_it.word(), page_res_it.row()->row,
+                          page_res_it.block()->block, FALSE, NULL, NULL);
+    }
     if (tessedit_dump_choices) {
 #ifndef GRAPHICS_DISABLED
       word_dumper(NULL, page_res_it.row()->row, page_res_it.word()->word);
@@ -378,12 +391,24 @@ if (dopasses==0 || dopasses==1)
 if (dopasses==1) return;
 
   /* Pass 2 */
+  // With helpers, the words are recognized first, and the loop below only
+  // does what follows the recognition of each word, in page order.
+  bool pass2_recognized = false;
+  if (!tessedit_test_adaption && target_word_box == NULL) {
+    PageStageTimer timer(&page_stats, PS_PASS2);
+    bool cancelled;
+    pass2_recognized = classify_words_pass2_parallel(page_res, monitor,
+                                                     word_count, dict_words,
+                                                     &cancelled);
+    if (cancelled)
+      return;
+  }
   page_res_it.restart_page ();
   word_index = 0;
   while (!tessedit_test_adaption && page_res_it.word () != NULL) {
     set_global_loc_code(LOC_PASS2);
     word_index++;
-    if (monitor != NULL) {
+    if (monitor != NULL && !pass2_recognized) {
       monitor->ocr_alive = TRUE;
       monitor->progress = 80 + 10 * word_index / word_count;
       if ((monitor->end_time != 0 && clock() > monitor->end_time) ||
@@ -408,8 +433,11 @@ if (dopasses==1) return;
 	}
 //end jetsoft
 
-    classify_word_pass2(page_res_it.word(), page_res_it.block()->block,
-                        page_res_it.row()->row);
+    if (!pass2_recognized) {
+      PageStageTimer timer(&page_stats, PS_PASS2);
+      classify_word_pass2(page_res_it.word(), page_res_it.block()->block,
+                          page_res_it.row()->row);
+    }
     if (tessedit_dump_choices) {
 #ifndef GRAPHICS_DISABLED
       word_dumper(NULL, page_res_it.row()->row, page_res_it.word()->word);
@@ -589,6 +617,251 @@ if (dopasses==1) return;
 }
 
 
+// A word of pass 2 and where it is on the page.
+struct Pass2Word {
+  WERD_RES *word;
+  BLOCK *block;
+  ROW *row;
+};
+
+// Progress of a parallel pass 2, shared by its threads.
+struct Pass2Progress {
+  CCUtilMutex mutex;
+  int words_done;
+  bool cancelled;
+};
+
+// A run of the words of pass 2 and the instance that recognizes it.
+struct Pass2Run {
+  Tesseract *tesseract;
+  const GenericVector<Pass2Word> *words;
+  int start;
+  int end;
+  Pass2Progress *progress;
+};
+
+// Recognizes the words of run, checking monitor, if not NULL, before each
+// one as the serial pass 2 does.
+static void RecognizePass2Run(Pass2Run *run, volatile ETEXT_DESC *monitor,
+                              inT32 word_count, int dict_words) {
+  Pass2Progress *progress = run->progress;
+  for (int i = run->start; i < run->end; ++i) {
+    progress->mutex.Lock();
+    bool cancelled = progress->cancelled;
+    int words_done = progress->words_done;
+    progress->mutex.Unlock();
+    if (cancelled)
+      return;
+    if (monitor != NULL) {
+      monitor->ocr_alive = TRUE;
+      monitor->progress = 80 + 10 * words_done / word_count;
+      if ((monitor->end_time != 0 && clock() > monitor->end_time) ||
+          (monitor->cancel != NULL && (*monitor->cancel)(monitor->cancel_this,
+                                                         dict_words))) {
+        progress->mutex.Lock();
+        progress->cancelled = true;
+        progress->mutex.Unlock();
+        return;
+      }
+    }
+    const Pass2Word &word = (*run->words)[i];
+    run->tesseract->classify_word_pass2(word.word, word.block, word.row);
+    progress->mutex.Lock();
+    ++progress->words_done;
+    progress->mutex.Unlock();
+  }
+}
+
+static void *Pass2RunThread(void *arg) {
+  RecognizePass2Run(static_cast<Pass2Run *>(arg), NULL, 1, 0);
+  return NULL;
+}
+
+void Tesseract::make_helpers(int count, GenericVector<Tesseract*> *helpers) {
+  // The helpers borrow the data that this instance borrows, or else that
+  // of this instance itself.
+  LanguageModel *model = language_model_;
+  if (model != NULL)
+    model->AddRef();
+  else
+    model = LanguageModel::Wrap(this);
+  // demodir points into a buffer that init_tesseract rewrites.
+  STRING datapath = demodir;
+  for (int i = 0; i < count; ++i) {
+    Tesseract *helper = new Tesseract;
+    helper->m_data_sub_dir.set_value(m_data_sub_dir.string());
+    helper->set_language_model(model);
+    if (helper->init_tesseract(datapath.string(), NULL, lang.string(),
+                               NULL, 0, false) != 0) {
+      delete helper;
+      break;
+    }
+    helpers->push_back(helper);
+  }
+  model->Release();
+}
+
+void Tesseract::init_pass2_helpers() {
+  end_pass2_helpers();
+  // The helpers would also write to the output and statistics files of
+  // this instance, and close them at the end.
+  if (tessedit_pass2_threads <= 1 || tord_write_output ||
+      tord_write_raw_output || record_matcher_output || tessedit_save_stats)
+    return;
+  make_helpers(tessedit_pass2_threads - 1, &pass2_helpers_);
+}
+
+void Tesseract::end_pass2_helpers() {
+  for (int i = 0; i < pass2_helpers_.size(); ++i) {
+    pass2_helpers_[i]->end_tesseract();
+    delete pass2_helpers_[i];
+  }
+  pass2_helpers_.truncate(0);
+}
+
+void Tesseract::init_seam_helpers() {
+  end_seam_helpers();
+  if (chop_seam_threads <= 1)
+    return;
+  // The seam helpers only classify, so they write to no files.
+  GenericVector<Tesseract*> helpers;
+  make_helpers(chop_seam_threads - 1, &helpers);
+  for (int i = 0; i < helpers.size(); ++i)
+    seam_helpers_.push_back(helpers[i]);
+  seam_helper_changes_ = -1;
+}
+
+void Tesseract::end_seam_helpers() {
+  for (int i = 0; i < seam_helpers_.size(); ++i) {
+    Tesseract *helper = static_cast<Tesseract*>(seam_helpers_[i]);
+    helper->end_tesseract();
+    delete helper;
+  }
+  seam_helpers_.truncate(0);
+}
+
+void Tesseract::copy_pass2_state(const char *templates, int templates_length,
+                                 Tesseract *helper) {
+  // Config files and the API set these variables of this instance only.
+  helper->tessedit_accuracyvspeed.set_value(tessedit_accuracyvspeed);
+  helper->tessedit_char_blacklist.set_value(tessedit_char_blacklist.string());
+  helper->tessedit_char_whitelist.set_value(tessedit_char_whitelist.string());
+  helper->tessedit_single_match.set_value(tessedit_single_match);
+  helper->tess_cn_matching.set_value(tess_cn_matching);
+  helper->tess_bn_matching.set_value(tess_bn_matching);
+  helper->classify_enable_learning.set_value(classify_enable_learning);
+  helper->classify_recog_devanagari.set_value(classify_recog_devanagari);
+  helper->set_beam_width_hint(
+      BeamWidthForAccuracyVSpeed(tessedit_accuracyvspeed));
+  helper->SetBlackAndWhitelist();
+  helper->StartClassifierCachePage();
+  if (templates != NULL)
+    helper->ImportAdaptiveClassifier(templates, templates_length);
+  helper->getDict().CopyWordListsFrom(getDict());
+  // The helper has no page image, only the size of the page.
+  helper->strip_page_width_ = page_width();
+  helper->strip_page_height_ = page_height();
+  helper->strip_page_resolution_ = page_resolution();
+}
+
+bool Tesseract::classify_words_pass2_parallel(PAGE_RES *page_res,
+                                              volatile ETEXT_DESC *monitor,
+                                              inT32 word_count,
+                                              int dict_words,
+                                              bool *cancelled) {
+  *cancelled = false;
+  // These modes keep state or files that the helpers do not have.
+  if (pass2_helpers_.empty() || tessedit_training_tess ||
+      tessedit_training_wiseowl || tessedit_draw_outwords ||
+      tessedit_use_nn || tessedit_save_stats || matcher_fp != NULL ||
+      getDict().permute_only_top())
+    return false;
+
+  // A word carries the hyphen state of the Dict to the first word of the
+  // next line, so a run may only start with a word that is sure to be
+  // recognized after a word of its own line that is sure to be recognized,
+  // which leaves the hyphen state of no use to it. The runs are balanced
+  // by the number of blobs to recognize.
+  GenericVector<Pass2Word> words;
+  GenericVector<int> blobs_before;
+  GenericVector<bool> may_start;
+  int total_blobs = 0;
+  bool line_started = false;
+  PAGE_RES_IT page_res_it(page_res);
+  for (page_res_it.restart_page(); page_res_it.word() != NULL;
+       page_res_it.forward()) {
+    Pass2Word word;
+    word.word = page_res_it.word();
+    word.block = page_res_it.block()->block;
+    word.row = page_res_it.row()->row;
+    bool recognized = !word.word->done &&
+                      !word.word->word->gblob_list()->empty();
+    words.push_back(word);
+    blobs_before.push_back(total_blobs);
+    may_start.push_back(recognized && line_started);
+    if (recognized)
+      total_blobs += word.word->word->gblob_list()->length();
+    if (word.word->word->flag(W_EOL))
+      line_started = false;
+    else if (recognized)
+      line_started = true;
+  }
+  int num_runs = pass2_helpers_.size() + 1;
+  GenericVector<int> starts;
+  starts.push_back(0);
+  for (int i = 1; i < words.size() && starts.size() < num_runs; ++i) {
+    if (may_start[i] &&
+        blobs_before[i] >= total_blobs * starts.size() / num_runs)
+      starts.push_back(i);
+  }
+  if (starts.size() < 2)
+    return false;
+  num_runs = starts.size();
+  starts.push_back(words.size());
+
+  int templates_length = 0;
+  char *templates = ExportAdaptiveClassifier(&templates_length);
+  for (int r = 1; r < num_runs; ++r) {
+    copy_pass2_state(templates, templates_length, pass2_helpers_[r - 1]);
+    pass2_helpers_[r - 1]->getDict().reset_hyphen_vars(true);
+  }
+  delete [] templates;
+
+  Pass2Progress progress;
+  progress.words_done = 0;
+  progress.cancelled = false;
+  Pass2Run *runs = new Pass2Run[num_runs];
+  for (int r = 0; r < num_runs; ++r) {
+    runs[r].tesseract = r == 0 ? this : pass2_helpers_[r - 1];
+    runs[r].words = &words;
+    runs[r].start = starts[r];
+    runs[r].end = starts[r + 1];
+    runs[r].progress = &progress;
+  }
+  CCUtilThread *threads = new CCUtilThread[num_runs];
+  GenericVector<bool> started;
+  started.push_back(true);
+  for (int r = 1; r < num_runs; ++r)
+    started.push_back(threads[r].Start(&Pass2RunThread, &runs[r]));
+  RecognizePass2Run(&runs[0], monitor, word_count, dict_words);
+  // A run whose thread could not be started is done here.
+  for (int r = 1; r < num_runs; ++r) {
+    if (!started[r])
+      RecognizePass2Run(&runs[r], monitor, word_count, dict_words);
+  }
+  for (int r = 1; r < num_runs; ++r)
+    threads[r].Join();
+  delete [] threads;
+  delete [] runs;
+
+  *cancelled = progress.cancelled;
+  // The next word this instance recognizes follows the last of the page.
+  if (!*cancelled)
+    getDict().CopyHyphenState(pass2_helpers_[num_runs - 2]->getDict());
+  return true;
+}
+
+
 /**********************************************************************
  * classify_word_pass1
  *
@@ -613,6 +886,7 @@ void Tesseract::classify_word_pass1(                 //recog one word
   char *match_string;
   char word_string[1024];
 
+  StartFeatureStoreWord();
   if (save_best_choices)
     blob_choices = new BLOB_CHOICE_LIST_CLIST();
   else
@@ -767,6 +1041,7 @@ void Tesseract::classify_word_pass2(WERD_RES *word, BLOCK* block, ROW *row) {
   inT16 new_word_quality;
   inT16 dummy;
 
+  StartFeatureStoreWord();
   set_global_subloc_code(SUBLOC_NORM);
   check_debug_pt (word, 30);
   if (!word->done ||
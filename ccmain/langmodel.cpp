@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////
+// File:        langmodel.cpp
+// Description: Read-only language data shared between Tesseract instances.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "langmodel.h"
+#include "tesseractclass.h"
+
+namespace tesseract {
+
+LanguageModel::LanguageModel()
+  : owner_(NULL), owns_owner_(true), ref_count_(1) {
+}
+
+LanguageModel::~LanguageModel() {
+  if (owner_ != NULL && owns_owner_) {
+    owner_->end_tesseract();
+    delete owner_;
+  }
+}
+
+// static
+LanguageModel* LanguageModel::Load(const char* datapath,
+                                   const char* language) {
+  LanguageModel* model = new LanguageModel;
+  model->owner_ = new Tesseract;
+  if (model->owner_->init_tesseract(datapath, NULL, language,
+                                    NULL, 0, false) != 0) {
+    delete model->owner_;
+    model->owner_ = NULL;
+    delete model;
+    return NULL;
+  }
+  return model;
+}
+
+// static
+LanguageModel* LanguageModel::Wrap(Tesseract* owner) {
+  LanguageModel* model = new LanguageModel;
+  model->owner_ = owner;
+  model->owns_owner_ = false;
+  return model;
+}
+
+void LanguageModel::AddRef() {
+  ref_mutex_.Lock();
+  ++ref_count_;
+  ref_mutex_.Unlock();
+}
+
+void LanguageModel::Release() {
+  ref_mutex_.Lock();
+  bool last = --ref_count_ == 0;
+  ref_mutex_.Unlock();
+  if (last)
+    delete this;
+}
+
+const STRING& LanguageModel::lang() const {
+  return owner_->lang;
+}
+
+}  // namespace tesseract.
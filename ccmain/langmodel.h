@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////
+// File:        langmodel.h
+// Description: Read-only language data shared between Tesseract instances.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCMAIN_LANGMODEL_H__
+#define TESSERACT_CCMAIN_LANGMODEL_H__
+
+#include "ccutil.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+class Tesseract;
+
+// LanguageModel holds the large read-only parts of a .traineddata file:
+// the pre-trained integer templates, the normalization protos and the
+// squished dawgs. It is loaded once and can then be attached to any number
+// of Tesseract instances (see Tesseract::set_language_model), which borrow
+// the data instead of loading private copies, so the traineddata is only
+// read here. The ambigs are shared too. The unicharset, which each instance
+// restricts with its own blacklist and whitelist, and the small cutoff
+// table are copied into each instance. The adaptive templates and the user
+// and document dawgs stay private to each instance.
+//
+// The model is reference counted. Load returns a model with one reference
+// held by the caller, and each attached instance holds one more. The model
+// is deleted when the last reference is released, so the caller may Release
+// its reference as soon as the model has been attached.
+class LanguageModel {
+ public:
+  // Loads the model for language from the tessdata directory found from
+  // datapath, in the same way as TessBaseAPI::Init. Returns NULL on failure.
+  static LanguageModel* Load(const char* datapath, const char* language);
+  // Returns a model of the data of owner, an initialized instance that is
+  // not deleted with the model and so must outlive it.
+  static LanguageModel* Wrap(Tesseract* owner);
+
+  void AddRef();
+  void Release();
+
+  // Language actually loaded, e.g. "eng" if the requested one was NULL.
+  const STRING& lang() const;
+
+  // The fully initialized instance that owns the shared data.
+  const Tesseract* owner() const {
+    return owner_;
+  }
+
+ private:
+  LanguageModel();
+  ~LanguageModel();
+
+  Tesseract* owner_;
+  // False if owner_ belongs to someone else.
+  bool owns_owner_;
+  int ref_count_;
+  CCUtilMutex ref_mutex_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCMAIN_LANGMODEL_H__
@@ -30,8 +30,6 @@
 #include "tesseractclass.h"
 #include "qrsequence.h"
 
-extern IMAGE page_image;
-
 const int kMinCharactersToTry = 50;
 const int kMaxCharactersToTry = 5 * kMinCharactersToTry;
 
@@ -77,10 +75,11 @@ bool orientation_and_script_detection(STRING& filename,
   lastdot = strrchr (name.string (), '.');
   if (lastdot != NULL)
     name[lastdot-name.string()] = '\0';
-  if (!read_unlv_file(name, page_image.get_xsize(), page_image.get_ysize(),
+  IMAGE* page_image = tess->page_image();
+  if (!read_unlv_file(name, page_image->get_xsize(), page_image->get_ysize(),
                      &blocks))
-    FullPageBlock(page_image.get_xsize(), page_image.get_ysize(), &blocks);
-  find_components(&blocks, &land_blocks, &port_blocks, &page_box);
+    FullPageBlock(page_image->get_xsize(), page_image->get_ysize(), &blocks);
+  find_components(page_image, &blocks, &land_blocks, &port_blocks, &page_box);
   return os_detect(&port_blocks, osr, tess);
 }
 
@@ -188,8 +187,8 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
       TBLOB *tessblob;               //converted blob
       TEXTROW tessrow;               //dummy row
 
-      tess_cn_matching.set_value(true); // turn it on
-      tess_bn_matching.set_value(false);
+      tess->tess_cn_matching.set_value(true); // turn it on
+      tess->tess_bn_matching.set_value(false);
       //convert blob
       tessblob = make_tess_blob (&pblob, TRUE);
       //make dummy row
@@ -213,10 +213,6 @@ void Tesseract::write_results(                        //output a word
   char txt_chs[32];              //Only for unlv_tilde_crunch
   char map_chs[32];              //Only for unlv_tilde_crunch
   int txt_index = 0;
-  static BOOL8 tilde_crunch_written = FALSE;
-  static BOOL8 last_char_was_newline = TRUE;
-  static BOOL8 last_char_was_tilde = FALSE;
-  static BOOL8 empty_block = TRUE;
   BOOL8 need_reject = FALSE;
   PBLOB_IT blob_it;              //blobs
   UNICHAR_ID space = unicharset.unichar_to_id(" ");
@@ -236,7 +232,7 @@ void Tesseract::write_results(                        //output a word
   if (word->unlv_crunch_mode != CR_NONE
   && !tessedit_zero_kelvin_rejection && !tessedit_word_for_word) {
     if ((word->unlv_crunch_mode != CR_DELETE) &&
-      (!tilde_crunch_written ||
+      (!tilde_crunch_written_ ||
       ((word->unlv_crunch_mode == CR_KEEP_SPACE) &&
       (word->word->space () > 0) &&
       !word->word->flag (W_FUZZY_NON) &&
@@ -249,13 +245,13 @@ void Tesseract::write_results(                        //output a word
         txt_chs[txt_index] = ' ';
         map_chs[txt_index++] = '1';
         ep_chars[ep_chars_index++] = ' ';
-        last_char_was_tilde = FALSE;
+        last_char_was_tilde_ = FALSE;
       }
       need_reject = TRUE;
     }
-    if ((need_reject && !last_char_was_tilde) || (force_eol && empty_block)) {
+    if ((need_reject && !last_char_was_tilde_) || (force_eol && empty_block_)) {
       /* Write a reject char - mark as rejected unless zero_rejection mode */
-      last_char_was_tilde = TRUE;
+      last_char_was_tilde_ = TRUE;
       txt_chs[txt_index] = unrecognised;
       if (tessedit_zero_rejection || (suspect_level == 0)) {
         map_chs[txt_index++] = '1';
@@ -280,12 +276,12 @@ void Tesseract::write_results(                        //output a word
                                  //dummy reject
         ep_chars[ep_chars_index++] = 1;
       }
-      tilde_crunch_written = TRUE;
-      last_char_was_newline = FALSE;
-      empty_block = FALSE;
+      tilde_crunch_written_ = TRUE;
+      last_char_was_newline_ = FALSE;
+      empty_block_ = FALSE;
     }
 
-    if ((word->word->flag (W_EOL) && !last_char_was_newline) || force_eol) {
+    if ((word->word->flag (W_EOL) && !last_char_was_newline_) || force_eol) {
       /* Add a new line output */
       txt_chs[txt_index] = '\n';
       map_chs[txt_index++] = '\n';
@@ -293,9 +289,9 @@ void Tesseract::write_results(                        //output a word
       ep_chars[ep_chars_index++] = newline_type;
 
                                  //Cos of the real newline
-      tilde_crunch_written = FALSE;
-      last_char_was_newline = TRUE;
-      last_char_was_tilde = FALSE;
+      tilde_crunch_written_ = FALSE;
+      last_char_was_newline_ = TRUE;
+      last_char_was_tilde_ = FALSE;
     }
     txt_chs[txt_index] = '\0';
     map_chs[txt_index] = '\0';
@@ -311,21 +307,21 @@ void Tesseract::write_results(                        //output a word
     word->ep_choice = new WERD_CHOICE(ep_chars, unicharset);
 
     if (force_eol)
-      empty_block = TRUE;
+      empty_block_ = TRUE;
     return;
   }
 
   /* NORMAL PROCESSING of non tilde crunched words */
 
-  tilde_crunch_written = FALSE;
+  tilde_crunch_written_ = FALSE;
   if (newline_type)
-    last_char_was_newline = TRUE;
+    last_char_was_newline_ = TRUE;
   else
-    last_char_was_newline = FALSE;
-  empty_block = force_eol;       //About to write a real word
+    last_char_was_newline_ = FALSE;
+  empty_block_ = force_eol;       //About to write a real word
 
   if (unlv_tilde_crunching &&
-      last_char_was_tilde &&
+      last_char_was_tilde_ &&
       (word->word->space() == 0) &&
       !(word->word->flag(W_REP_CHAR) && tessedit_write_rep_codes) &&
       (word->best_choice->unichar_id(0) == space)) {
@@ -339,16 +335,16 @@ void Tesseract::write_results(                        //output a word
   }
   if (newline_type ||
     (word->word->flag (W_REP_CHAR) && tessedit_write_rep_codes))
-    last_char_was_tilde = FALSE;
+    last_char_was_tilde_ = FALSE;
   else {
     if (word->reject_map.length () > 0) {
       if (word->best_choice->unichar_id(word->reject_map.length() - 1) == space)
-        last_char_was_tilde = TRUE;
+        last_char_was_tilde_ = TRUE;
       else
-        last_char_was_tilde = FALSE;
+        last_char_was_tilde_ = FALSE;
     }
     else if (word->word->space () > 0)
-      last_char_was_tilde = FALSE;
+      last_char_was_tilde_ = FALSE;
     /* else it is unchanged as there are no output chars */
   }
 
@@ -398,7 +394,7 @@ void Tesseract::write_results(                        //output a word
 
   if (write_to_shm)
     write_shm_text (word, page_res_it.block ()->block,
-      page_res_it.row (), *wordstr, wordstr_lengths);
+      page_res_it.row (), *wordstr, wordstr_lengths, page_height());
 
 #if 0
   if (tessedit_write_output)
@@ -648,7 +644,8 @@ void write_shm_text(                    //write output
                     BLOCK *block,       //block it is from
                     ROW_RES *row,       //row it is from
                     const STRING &text, //text to write
-                    const STRING &text_lengths
+                    const STRING &text_lengths,
+                    int page_height     //to flip the boxes
                    ) {
   inT32 index;                   //char counter
   inT32 index2;                  //char counter
@@ -723,8 +720,8 @@ void write_shm_text(                    //write output
         if (text[offset] == ' ') {
         ocr_append_char (unrecognised,
                          blob_box.left (), blob_box.right (),
-                         page_image.get_ysize () - 1 - blob_box.top (),
-                         page_image.get_ysize () - 1 - blob_box.bottom (),
+                         page_height - 1 - blob_box.top (),
+                         page_height - 1 - blob_box.bottom (),
                          font, (uinT8) rating,
                          ptsize,                //point size
                          blanks, enhancement,   //enhancement
@@ -735,8 +732,8 @@ void write_shm_text(                    //write output
           for (int suboffset = 0; suboffset < text_lengths[index]; ++suboffset)
             ocr_append_char (static_cast<unsigned char>(text[offset+suboffset]),
                              blob_box.left (), blob_box.right (),
-                             page_image.get_ysize () - 1 - blob_box.top (),
-                             page_image.get_ysize () - 1 - blob_box.bottom (),
+                             page_height - 1 - blob_box.top (),
+                             page_height - 1 - blob_box.bottom (),
                              font, (uinT8) rating,
                              ptsize,                //point size
                              blanks, enhancement,   //enhancement
@@ -774,8 +771,8 @@ void write_shm_text(                    //write output
                                  //font index
     ocr_append_char (unrecognised,
                      blob_box.left (), blob_box.right (),
-                     page_image.get_ysize () - 1 - blob_box.top (),
-                     page_image.get_ysize () - 1 - blob_box.bottom (),
+                     page_height - 1 - blob_box.top (),
+                     page_height - 1 - blob_box.bottom (),
                      font,
                      rating,                    //confidence
                      ptsize,                    //point size
@@ -91,7 +91,8 @@ void write_shm_text(                    //write output
                     BLOCK *block,       //block it is from
                     ROW_RES *row,       //row it is from
                     const STRING &text, //text to write
-                    const STRING &text_lengths
+                    const STRING &text_lengths,
+                    int page_height     //to flip the boxes
                    );
 void write_map(                //output a map file
                FILE *mapfile,  //mapfile to write to
@@ -49,7 +49,6 @@
 #define MAXSPACING      128      /*max expected spacing in pix */
 
 const ERRCODE EMPTYBLOCKLIST = "No blocks to edit";
-extern IMAGE page_image;
 
 enum CMD_EVENTS
 {
@@ -123,6 +122,7 @@ BOOL8 *other_image_changed = &target_changed;
 #define EXTERN
 
 EXTERN BLOCK_LIST *current_block_list = NULL;
+EXTERN IMAGE *current_page_image = NULL;  // Of the Tesseract being edited.
 EXTERN BOOL8 *current_image_changed = &source_changed;
 
 /* Variables */
@@ -509,9 +509,9 @@ BLOCK *, ROW *, WERD *)) {
   WERD *word;
 
   image_win->Clear();
-  if (display_image != 0) {
-    sv_show_sub_image(&page_image, 0, 0,
-      page_image.get_xsize(), page_image.get_ysize(),
+  if (display_image != 0 && current_page_image != NULL) {
+    sv_show_sub_image(current_page_image, 0, 0,
+      current_page_image->get_xsize(), current_page_image->get_ysize(),
       image_win, 0, 0);
   }
 
@@ -696,6 +696,7 @@ void Tesseract::pgeditor_main(BLOCK_LIST *blocks) {
 
   source_block_list = blocks;
   current_block_list = blocks;
+  current_page_image = &page_image_;
   if (current_block_list->empty())
     return;
 
@@ -754,10 +755,11 @@ void Tesseract::pgeditor_read_file(                   // of serialised file
   lastdot = strrchr (name.string (), '.');
   if (lastdot != NULL)
     name[lastdot-name.string()] = '\0';
-  if (!read_unlv_file(name, page_image.get_xsize(), page_image.get_ysize(),
+  if (!read_unlv_file(name, page_image_.get_xsize(), page_image_.get_ysize(),
                      blocks))
-    FullPageBlock(page_image.get_xsize(), page_image.get_ysize(), blocks);
-  find_components(blocks, &land_blocks, &port_blocks, &page_box);
+    FullPageBlock(page_image_.get_xsize(), page_image_.get_ysize(), blocks);
+  find_components(&page_image_, blocks, &land_blocks, &port_blocks,
+                  &page_box);
   textord_page(page_box.topright(), blocks, &land_blocks, &port_blocks, this);
 }
 }  // namespace tesseract
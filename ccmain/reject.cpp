@@ -416,7 +416,7 @@ void Tesseract::make_reject_map(      //make rej map for wd //detailed results
   }
 
   if (tessedit_image_border > -1)
-    reject_edge_blobs(word);
+    reject_edge_blobs(word, page_width(), page_height());
 
   check_debug_pt (word, 10);
   if (tessedit_rejection_debug) {
@@ -590,11 +590,12 @@ int sort_floats(                   //qsort function
 /*************************************************************************
  * reject_edge_blobs()
  *
- * If the word is perilously close to the edge of the image, reject those blobs
- * in the word which are too close to the edge as they could be clipped.
+ * If the word is perilously close to the edge of the image of the given
+ * size, reject those blobs in the word which are too close to the edge as
+ * they could be clipped.
  *************************************************************************/
 
-void reject_edge_blobs(WERD_RES *word) {
+void reject_edge_blobs(WERD_RES *word, int page_width, int page_height) {
   TBOX word_box = word->word->bounding_box ();
   TBOX blob_box;
   PBLOB_IT blob_it = word->outword->blob_list ();
@@ -605,8 +606,8 @@ void reject_edge_blobs(WERD_RES *word) {
   if ((word_box.left () < tessedit_image_border) ||
     (word_box.bottom () < tessedit_image_border) ||
     (word_box.right () + tessedit_image_border >
-    page_image.get_xsize () - 1) ||
-  (word_box.top () + tessedit_image_border > page_image.get_ysize () - 1)) {
+    page_width - 1) ||
+  (word_box.top () + tessedit_image_border > page_height - 1)) {
     ASSERT_HOST (word->reject_map.length () == blob_it.length ());
     for (blobindex = 0, blob_it.mark_cycle_pt ();
     !blob_it.cycled_list (); blobindex++, blob_it.forward ()) {
@@ -616,9 +617,9 @@ void reject_edge_blobs(WERD_RES *word) {
         (word->denorm.y (blob_box.bottom (), centre) <
         tessedit_image_border) ||
         (word->denorm.x (blob_box.right ()) + tessedit_image_border >
-        page_image.get_xsize () - 1) ||
+        page_width - 1) ||
         (word->denorm.y (blob_box.top (), centre)
-      + tessedit_image_border > page_image.get_ysize () - 1)) {
+      + tessedit_image_border > page_height - 1)) {
         word->reject_map[blobindex].setrej_edge_char ();
         //close to edge
       }
@@ -1067,14 +1068,17 @@ void Tesseract::nn_match_word(  //Match a word
   if ((clip_image_size <= 1) || (net_image_size <= 1)) {
     return;
   }
+  // A page segmented in strips has no image to clip the characters from.
+  if (page_image_.get_bpp() == 0)
+    return;
 
   /*
     Get the image of the word and the pix positions of each char
   */
-  char_clip_word(&copy_outword, page_image, pixrow_list, imlines, pix_box);
+  char_clip_word(&copy_outword, page_image_, pixrow_list, imlines, pix_box);
 #ifndef GRAPHICS_DISABLED
   if (show_char_clipping) {
-    win = display_clip_image (&copy_outword, page_image,
+    win = display_clip_image (&copy_outword, page_image_,
       pixrow_list, pix_box);
   }
 #endif
@@ -1083,7 +1087,7 @@ void Tesseract::nn_match_word(  //Match a word
   for (pixrow_it.mark_cycle_pt (), i = 0;
   !pixrow_it.cycled_list (); pixrow_it.forward (), i++) {
     if (pixrow_it.data ()->
-      bad_box (page_image.get_xsize (), page_image.get_ysize ()))
+      bad_box (page_image_.get_xsize (), page_image_.get_ysize ()))
       continue;
     clip_image.create (clip_image_size, clip_image_size, 1);
     //make bin imge
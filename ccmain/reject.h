@@ -106,7 +106,7 @@ float compute_reject_threshold(  //compute threshold //detailed results
 int sort_floats(                   //qsort function
                 const void *arg1,  //ptrs to floats
                 const void *arg2);
-void reject_edge_blobs(WERD_RES *word);
+void reject_edge_blobs(WERD_RES *word, int page_width, int page_height);
 BOOL8 word_contains_non_1_digit(const char *word,
                                 const char *word_lengths);
                                  //of character
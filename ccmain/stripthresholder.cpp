@@ -0,0 +1,246 @@
+///////////////////////////////////////////////////////////////////////
+// File:        stripthresholder.cpp
+// Description: Thresholding of images read a strip of lines at a time.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
+#include "stripthresholder.h"
+
+#include <ctype.h>
+#include <string.h>
+
+#include "ndminx.h"
+#include "otsuthr.h"
+
+namespace tesseract {
+
+MemoryStripSource::MemoryStripSource(const uinT8* imagedata,
+                                     int width, int height,
+                                     int bytes_per_pixel, int bytes_per_line,
+                                     int resolution)
+  : imagedata_(imagedata), width_(width), height_(height),
+    bytes_per_pixel_(bytes_per_pixel), src_bytes_per_line_(bytes_per_line),
+    resolution_(resolution) {
+}
+
+bool MemoryStripSource::ReadLines(int top, int num_lines, uinT8* buffer) {
+  if (top < 0 || top + num_lines > height_)
+    return false;
+  int line_bytes = bytes_per_line();
+  const uinT8* src = imagedata_ +
+      static_cast<size_t>(top) * src_bytes_per_line_;
+  for (int y = 0; y < num_lines; ++y) {
+    memcpy(buffer, src, line_bytes);
+    buffer += line_bytes;
+    src += src_bytes_per_line_;
+  }
+  return true;
+}
+
+PnmStripSource::PnmStripSource()
+  : fp_(NULL), data_start_(0), next_line_(0), width_(0), height_(0),
+    bytes_per_pixel_(0), maxval_(1) {
+}
+
+PnmStripSource::~PnmStripSource() {
+  if (fp_ != NULL)
+    fclose(fp_);
+}
+
+// ftell and fseek with 64 bit offsets, as a long is only 32 bits on
+// Windows. Elsewhere AC_SYS_LARGEFILE makes off_t 64 bits.
+static inT64 Tell64(FILE* fp) {
+#ifdef WIN32
+  return _ftelli64(fp);
+#else
+  return ftello(fp);
+#endif
+}
+
+static bool Seek64(FILE* fp, inT64 offset) {
+#ifdef WIN32
+  return _fseeki64(fp, offset, SEEK_SET) == 0;
+#else
+  off_t pos = static_cast<off_t>(offset);
+  return pos == offset && fseeko(fp, pos, SEEK_SET) == 0;
+#endif
+}
+
+// Reads the next decimal number of a netpbm header, skipping white space
+// and comments. Returns -1 if there is none.
+static int ReadPnmNumber(FILE* fp) {
+  int ch = fgetc(fp);
+  while (ch != EOF && (isspace(ch) || ch == '#')) {
+    if (ch == '#') {
+      while (ch != EOF && ch != '\n' && ch != '\r')
+        ch = fgetc(fp);
+    }
+    ch = fgetc(fp);
+  }
+  if (ch == EOF || !isdigit(ch))
+    return -1;
+  int value = 0;
+  while (ch != EOF && isdigit(ch)) {
+    value = value * 10 + ch - '0';
+    if (value > MAX_INT32 / 10)
+      return -1;
+    ch = fgetc(fp);
+  }
+  // The single white space character after the number is not put back, as
+  // after the last one of the header it is the start of the data.
+  return value;
+}
+
+bool PnmStripSource::Open(const char* filename) {
+  if (fp_ != NULL)
+    fclose(fp_);
+  fp_ = fopen(filename, "rb");
+  if (fp_ == NULL)
+    return false;
+  char magic[2];
+  if (fread(magic, 1, 2, fp_) != 2 || magic[0] != 'P' ||
+      (magic[1] != '4' && magic[1] != '5' && magic[1] != '6')) {
+    fclose(fp_);
+    fp_ = NULL;
+    return false;
+  }
+  width_ = ReadPnmNumber(fp_);
+  height_ = ReadPnmNumber(fp_);
+  if (magic[1] == '4') {
+    bytes_per_pixel_ = 0;
+    maxval_ = 1;
+  } else {
+    bytes_per_pixel_ = magic[1] == '5' ? 1 : 3;
+    maxval_ = ReadPnmNumber(fp_);
+  }
+  if (width_ <= 0 || height_ <= 0 || maxval_ <= 0 || maxval_ > 255) {
+    fclose(fp_);
+    fp_ = NULL;
+    return false;
+  }
+  data_start_ = Tell64(fp_);
+  next_line_ = 0;
+  return data_start_ >= 0;
+}
+
+bool PnmStripSource::ReadLines(int top, int num_lines, uinT8* buffer) {
+  if (fp_ == NULL || top < 0 || top + num_lines > height_)
+    return false;
+  size_t line_bytes = bytes_per_line();
+  // The thresholder reads the strips in order, so the file only has to be
+  // repositioned at the start of each pass.
+  if (top != next_line_) {
+    next_line_ = -1;
+    if (!Seek64(fp_, data_start_ + static_cast<inT64>(top) * line_bytes))
+      return false;
+  }
+  size_t num_bytes = line_bytes * num_lines;
+  if (fread(buffer, 1, num_bytes, fp_) != num_bytes) {
+    next_line_ = -1;
+    return false;
+  }
+  next_line_ = top + num_lines;
+  if (bytes_per_pixel_ == 0) {
+    // In netpbm a one bit is black.
+    for (size_t i = 0; i < num_bytes; ++i)
+      buffer[i] = ~buffer[i];
+  }
+  return true;
+}
+
+StripThresholder::StripThresholder(ImageStripSource* source, int strip_height)
+  : source_(source), strip_height_(strip_height),
+    thresholds_(NULL), hi_values_(NULL) {
+  if (strip_height_ <= 0)
+    strip_height_ = kDefaultStripHeight;
+}
+
+StripThresholder::~StripThresholder() {
+  delete [] thresholds_;
+  delete [] hi_values_;
+}
+
+bool StripThresholder::ComputeThresholds(uinT8* strip) {
+  int width = source_->width();
+  int height = source_->height();
+  int bytes_per_pixel = source_->bytes_per_pixel();
+  int bytes_per_line = source_->bytes_per_line();
+  int num_counts = bytes_per_pixel * kHistogramSize;
+  int* histograms = new int[num_counts];
+  memset(histograms, 0, sizeof(*histograms) * num_counts);
+  int strip_histogram[kHistogramSize];
+  bool ok = true;
+  for (int top = 0; top < height && ok; top += strip_height_) {
+    int num_lines = MIN(strip_height_, height - top);
+    ok = source_->ReadLines(top, num_lines, strip);
+    for (int ch = 0; ok && ch < bytes_per_pixel; ++ch) {
+      HistogramRect(strip + ch, bytes_per_pixel, bytes_per_line,
+                    0, 0, width, num_lines, strip_histogram);
+      int* histogram = histograms + ch * kHistogramSize;
+      for (int i = 0; i < kHistogramSize; ++i)
+        histogram[i] += strip_histogram[i];
+    }
+  }
+  if (ok) {
+    OtsuThresholdFromHistograms(bytes_per_pixel, histograms,
+                                &thresholds_, &hi_values_);
+  }
+  delete [] histograms;
+  return ok;
+}
+
+bool StripThresholder::ThresholdToLines(
+    Callback2<int, uinT8*>* line_callback) {
+  int width = source_->width();
+  int height = source_->height();
+  int bytes_per_pixel = source_->bytes_per_pixel();
+  int bytes_per_line = source_->bytes_per_line();
+  uinT8* strip = new uinT8[strip_height_ * bytes_per_line];
+  uinT8* line = new uinT8[width];
+  bool ok = bytes_per_pixel == 0 || thresholds_ != NULL ||
+            ComputeThresholds(strip);
+  for (int top = 0; top < height && ok; top += strip_height_) {
+    int num_lines = MIN(strip_height_, height - top);
+    ok = source_->ReadLines(top, num_lines, strip);
+    for (int y = 0; ok && y < num_lines; ++y) {
+      const uinT8* src = strip + y * bytes_per_line;
+      if (bytes_per_pixel == 0) {
+        for (int x = 0; x < width; ++x)
+          line[x] = (src[x >> 3] >> (7 - (x & 7))) & 1;
+      } else {
+        // As ImageThresholder::ThresholdRectToIMAGE.
+        for (int x = 0; x < width; ++x, src += bytes_per_pixel) {
+          line[x] = 1;
+          for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+            if (hi_values_[ch] >= 0 &&
+                (src[ch] > thresholds_[ch]) == (hi_values_[ch] == 0)) {
+              line[x] = 0;
+              break;
+            }
+          }
+        }
+      }
+      line_callback->Run(top + y, line);
+    }
+  }
+  delete [] line;
+  delete [] strip;
+  return ok;
+}
+
+}  // namespace tesseract.
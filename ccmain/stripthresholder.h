@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////
+// File:        stripthresholder.h
+// Description: Thresholding of images read a strip of lines at a time.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCMAIN_STRIPTHRESHOLDER_H__
+#define TESSERACT_CCMAIN_STRIPTHRESHOLDER_H__
+
+#include <stdio.h>
+
+#include "callback.h"
+#include "host.h"
+
+namespace tesseract {
+
+// Default number of lines read from an ImageStripSource at a time.
+const int kDefaultStripHeight = 64;
+
+// An image that can be read in horizontal strips, for pages too large to
+// be held in memory as a whole.
+// Pixels use the conventions of ImageThresholder::SetImage: grey is one
+// byte per pixel and color 3 or 4, while binary images have 0 bytes per
+// pixel and are packed 8 pixels to the byte, MSB first, with a one bit for
+// a WHITE pixel.
+class ImageStripSource {
+ public:
+  virtual ~ImageStripSource() {}
+
+  virtual int width() const = 0;
+  virtual int height() const = 0;
+  virtual int bytes_per_pixel() const = 0;
+  // Pixels per inch, or 0 if unknown.
+  virtual int resolution() const = 0;
+
+  // Bytes needed for one line of the image.
+  int bytes_per_line() const {
+    int bpp = bytes_per_pixel();
+    return bpp > 0 ? width() * bpp : (width() + 7) / 8;
+  }
+
+  // Reads num_lines lines, starting at line top counted from the top of the
+  // image, into buffer, bytes_per_line() bytes apart. Strips are read from
+  // the top down, but the image may be read more than once.
+  // Returns false on a read error.
+  virtual bool ReadLines(int top, int num_lines, uinT8* buffer) = 0;
+};
+
+// ImageStripSource for an image that is already in memory, as given to
+// ImageThresholder::SetImage. Streaming it still avoids the thresholded
+// copy of the whole page.
+class MemoryStripSource : public ImageStripSource {
+ public:
+  // The data must remain valid for the life of the source.
+  MemoryStripSource(const uinT8* imagedata, int width, int height,
+                    int bytes_per_pixel, int bytes_per_line, int resolution);
+
+  virtual int width() const {
+    return width_;
+  }
+  virtual int height() const {
+    return height_;
+  }
+  virtual int bytes_per_pixel() const {
+    return bytes_per_pixel_;
+  }
+  virtual int resolution() const {
+    return resolution_;
+  }
+  virtual bool ReadLines(int top, int num_lines, uinT8* buffer);
+
+ private:
+  const uinT8* imagedata_;
+  int width_;
+  int height_;
+  int bytes_per_pixel_;
+  int src_bytes_per_line_;
+  int resolution_;
+};
+
+// ImageStripSource for a binary (P4), grey (P5) or color (P6) netpbm file
+// with at most 8 bits per sample. Only the lines being read are ever in
+// memory.
+class PnmStripSource : public ImageStripSource {
+ public:
+  PnmStripSource();
+  virtual ~PnmStripSource();
+
+  // Opens the file and reads its header. Returns false if it is not a
+  // netpbm file of a supported kind.
+  bool Open(const char* filename);
+
+  virtual int width() const {
+    return width_;
+  }
+  virtual int height() const {
+    return height_;
+  }
+  virtual int bytes_per_pixel() const {
+    return bytes_per_pixel_;
+  }
+  virtual int resolution() const {
+    return 0;
+  }
+  virtual bool ReadLines(int top, int num_lines, uinT8* buffer);
+
+ private:
+  FILE* fp_;
+  inT64 data_start_;  // File offset of the first line.
+  int next_line_;     // Line at the file position, -1 if unknown.
+  int width_;
+  int height_;
+  int bytes_per_pixel_;
+  int maxval_;
+};
+
+// Thresholds an ImageStripSource with the same global Otsu thresholds as
+// ImageThresholder, but never holds more than one strip of the source in
+// memory: a first pass over the strips gathers the histograms, and a second
+// thresholds them and hands the result on one line at a time.
+class StripThresholder {
+ public:
+  // The source must remain valid for the life of the thresholder.
+  StripThresholder(ImageStripSource* source, int strip_height);
+  ~StripThresholder();
+
+  ImageStripSource* source() const {
+    return source_;
+  }
+
+  // Thresholds the whole image, calling line_callback, from the top line
+  // down, with the line number counted from the top and the thresholded
+  // line of width() bytes, 1 for white and 0 for black. The callback may
+  // modify the line. Returns false on a read error, in which case some of
+  // the lines may already have been delivered.
+  bool ThresholdToLines(Callback2<int, uinT8*>* line_callback);
+
+ private:
+  // Reads the whole image once to compute thresholds_ and hi_values_.
+  bool ComputeThresholds(uinT8* strip);
+
+  ImageStripSource* source_;
+  int strip_height_;
+  // Otsu thresholds per channel, as from OtsuThreshold.
+  int* thresholds_;
+  int* hi_values_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_CCMAIN_STRIPTHRESHOLDER_H__
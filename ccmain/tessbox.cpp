@@ -45,26 +45,21 @@ WERD_CHOICE *Tesseract::tess_segment_pass1(                 //recog one word
                                            WERD *&outword   //bln word output
                                           ) {
   WERD_CHOICE *result;           //return value
-  int saved_enable_assoc = 0;
-  int saved_chop_enable = 0;
-
-  if (word->flag (W_DONT_CHOP)) {
-    saved_enable_assoc = wordrec_enable_assoc;
-    saved_chop_enable = chop_enable;
-    wordrec_enable_assoc.set_value(0);
-    chop_enable.set_value(0);
-    if (word->flag (W_REP_CHAR))
-      permute_only_top = 1;
-  }
+
+  // Disable chopping and association for this word only, on this instance.
+  tess_dont_chop = word->flag (W_DONT_CHOP);
+  getDict().set_top_choice_only(word->flag (W_DONT_CHOP) &&
+                                word->flag (W_REP_CHAR));
   set_pass1();
   //      tprintf("pass1 chop on=%d, seg=%d, onlytop=%d",chop_enable,enable_assoc,permute_only_top);
   result = recog_word (word, denorm, matcher, NULL, NULL, FALSE,
     raw_choice, blob_choices, outword);
-  if (word->flag (W_DONT_CHOP)) {
-    wordrec_enable_assoc.set_value(saved_enable_assoc);
-    chop_enable.set_value(saved_chop_enable);
-    permute_only_top = 0;
-  }
+  tess_dont_chop = FALSE;
+  getDict().set_top_choice_only(false);
+  // A word that may not be chopped also ends any permute_only_top set
+  // elsewhere (as by ambigs training).
+  if (word->flag (W_DONT_CHOP))
+    getDict().set_permute_only_top(false);
   return result;
 }
 
@@ -87,25 +82,20 @@ WERD_CHOICE *Tesseract::tess_segment_pass2(                 //recog one word
                                            WERD *&outword   //bln word output
                                           ) {
   WERD_CHOICE *result;           //return value
-  int saved_enable_assoc = 0;
-  int saved_chop_enable = 0;
-
-  if (word->flag (W_DONT_CHOP)) {
-    saved_enable_assoc = wordrec_enable_assoc;
-    saved_chop_enable = chop_enable;
-    wordrec_enable_assoc.set_value(0);
-    chop_enable.set_value(0);
-    if (word->flag (W_REP_CHAR))
-      permute_only_top = 1;
-  }
+
+  // Disable chopping and association for this word only, on this instance.
+  tess_dont_chop = word->flag (W_DONT_CHOP);
+  getDict().set_top_choice_only(word->flag (W_DONT_CHOP) &&
+                                word->flag (W_REP_CHAR));
   set_pass2();
   result = recog_word (word, denorm, matcher, NULL, NULL, FALSE,
     raw_choice, blob_choices, outword);
-  if (word->flag (W_DONT_CHOP)) {
-    wordrec_enable_assoc.set_value(saved_enable_assoc);
-    chop_enable.set_value(saved_chop_enable);
-    permute_only_top = 0;
-  }
+  tess_dont_chop = FALSE;
+  getDict().set_top_choice_only(false);
+  // A word that may not be chopped also ends any permute_only_top set
+  // elsewhere (as by ambigs training).
+  if (word->flag (W_DONT_CHOP))
+    getDict().set_permute_only_top(false);
   return result;
 }
 
@@ -313,8 +303,6 @@ void tess_training_tester(                           //call tess
 
   if (correct) {
     classify_norm_method.set_value(character); // force char norm spc 30/11/93
-    tess_bn_matching.set_value(false);    //turn it off
-    tess_cn_matching.set_value(false);
                                  //convert blob
     tessblob = make_tess_blob (blob, TRUE);
                                  //make dummy row
@@ -341,7 +329,7 @@ void Tesseract::tess_adapter(                         //adapt to word
                              const char *rejmap       //reject map
                             ) {
   TWERD *tessword;               //converted word
-  static TEXTROW tessrow;        //dummy row
+  TEXTROW tessrow;               //dummy row
 
                                  //make dummy row
   make_tess_row(denorm, &tessrow);
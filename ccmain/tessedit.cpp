@@ -52,6 +52,7 @@
 #include "efio.h"
 #include "danerror.h"
 #include "globals.h"
+#include "langmodel.h"
 #include "tesseractclass.h"
 #include "varable.h"
 
@@ -139,6 +140,15 @@ bool Tesseract::init_tesseract_lang_data(
     read_config_file(configs[i], configs_global_only);
   }
 
+  // An instance with a language model copies the unicharset of the model
+  // and shares its ambigs (see Dict::getUnicharAmbigs), so the traineddata
+  // is only read when the model is loaded. The variables of the language
+  // config file are global, and were set then too.
+  if (language_model_ != NULL) {
+    unicharset.CopyFrom(language_model_->owner()->unicharset);
+    return true;
+  }
+
   // Initialize TessdataManager.
   STRING tessdata_path = language_data_path_prefix + kTrainedDataSuffix;
   tessdata_manager.Init(tessdata_path.string());
@@ -212,6 +222,8 @@ int Tesseract::init_tesseract_lm(const char *arg0,
 }
 
 void Tesseract::end_tesseract() {
+  end_pass2_helpers();
+  end_seam_helpers();
   end_recog();
 }
 
@@ -20,6 +20,7 @@
 
 #include "tesseractclass.h"
 #include "globals.h"
+#include "langmodel.h"
 
 // Include automatically generated configuration file if running autoconf.
 #ifdef HAVE_CONFIG_H
@@ -57,15 +58,54 @@ Tesseract::Tesseract()
     BOOL_MEMBER(global_tessedit_ambigs_training, false,
                 "Perform training for ambiguities"),
     pix_binary_(NULL),
+    strip_page_width_(0),
+    strip_page_height_(0),
+    strip_page_resolution_(0),
     deskew_(1.0f, 0.0f),
     reskew_(1.0f, 0.0f),
-    hindi_image_(false) {
+    hindi_image_(false),
+    doc_blob_quality_(0),
+    doc_outline_errs_(0),
+    doc_char_quality_(0),
+    good_char_count_(0),
+    doc_good_char_quality_(0),
+    doc_word_count_(0),
+    doc_dict_words_(0),
+    tilde_crunch_written_(FALSE),
+    last_char_was_newline_(TRUE),
+    last_char_was_tilde_(FALSE),
+    empty_block_(TRUE),
+    language_model_(NULL) {
 }
 
 Tesseract::~Tesseract() {
+  end_pass2_helpers();
+  end_seam_helpers();
+  set_language_model(NULL);
   Clear();
 }
 
+void Tesseract::set_language_model(LanguageModel* model) {
+  if (model == language_model_)
+    return;
+  if (model != NULL)
+    model->AddRef();
+  if (language_model_ != NULL) {
+    // Drop everything that points into the old model before releasing it.
+    EndAdaptiveClassifier();
+    getDict().end_permute();
+    language_model_->Release();
+  }
+  language_model_ = model;
+  if (model != NULL) {
+    ShareTemplatesFrom(model->owner());
+    getDict().ShareDawgsFrom(&model->owner()->getDict());
+  } else {
+    ShareTemplatesFrom(NULL);
+    getDict().ShareDawgsFrom(NULL);
+  }
+}
+
 void Tesseract::Clear() {
 #ifdef HAVE_LIBLEPT
   if (pix_binary_ != NULL)
@@ -73,6 +113,9 @@ void Tesseract::Clear() {
 #endif
  deskew_ = FCOORD(1.0f, 0.0f);
  reskew_ = FCOORD(1.0f, 0.0f);
+ page_stats.Reset();
+ alloc_profile.Reset();
+ AllocProfiler::StartPage();
 }
 
 void Tesseract::SetBlackAndWhitelist() {
@@ -22,10 +22,12 @@
 #define TESSERACT_CCMAIN_TESSERACTCLASS_H__
 
 #include "varable.h"
+#include "img.h"
 #include "wordrec.h"
 #include "ocrclass.h"
 #include "control.h"
 #include "docqual.h"
+#include "genericvector.h"
 
 class CHAR_SAMPLES_LIST;
 class CHAR_SAMPLE_LIST;
@@ -33,7 +35,6 @@ class PAGE_RES;
 class PAGE_RES_IT;
 class BLOCK_LIST;
 class TO_BLOCK_LIST;
-class IMAGE;
 class WERD_RES;
 class ROW;
 class TBOX;
@@ -46,8 +47,9 @@ class BLOB_CHOICE_LIST_CLIST;
 
 // Top-level class for all tesseract global instance data.
 // This class either holds or points to all data used by an instance
-// of Tesseract, including the memory allocator. When this is
-// complete, Tesseract will be thread-safe. UNTIL THEN, IT IS NOT!
+// of Tesseract, including the memory allocator. Instances recognize
+// independently on different threads, but the variables they read are
+// still global: see TessBaseAPI for what may run at the same time.
 //
 // NOTE to developers: Do not create cyclic dependencies through this class!
 // The directory dependency tree must remain a tree! The keep this clean,
@@ -71,6 +73,9 @@ class BLOB_CHOICE_LIST_CLIST;
 
 namespace tesseract {
 
+class LanguageModel;
+class StripThresholder;
+
 class Tesseract : public Wordrec {
  public:
   Tesseract();
@@ -90,13 +95,39 @@ class Tesseract : public Wordrec {
   Pix* pix_binary() const {
     return pix_binary_;
   }
+  // The thresholded page. It stays empty when the page is segmented in
+  // strips, so its size must be taken from the page_* accessors below.
+  IMAGE* page_image() {
+    return &page_image_;
+  }
+  // Size and resolution of the page, from page_image, or from the strip
+  // source if the page was segmented in strips.
+  int page_width() {
+    return page_image_.get_bpp() != 0 ? page_image_.get_xsize()
+                                      : strip_page_width_;
+  }
+  int page_height() {
+    return page_image_.get_bpp() != 0 ? page_image_.get_ysize()
+                                      : strip_page_height_;
+  }
+  int page_resolution() {
+    return page_image_.get_bpp() != 0 ? page_image_.get_res()
+                                      : strip_page_resolution_;
+  }
 
   void SetBlackAndWhitelist();
   int SegmentPage(const STRING* input_file,
                   IMAGE* image, BLOCK_LIST* blocks);
+  int SegmentPageStreamed(const STRING* input_file,
+                          StripThresholder* thresholder, BLOCK_LIST* blocks);
   int AutoPageSeg(int width, int height, int resolution,
                   bool single_column, IMAGE* image,
                   BLOCK_LIST* blocks, TO_BLOCK_LIST* to_blocks);
+  int MakePageBlocks(const STRING* input_file,
+                     int width, int height, BLOCK_LIST* blocks);
+  void TextordBlocks(int pageseg_mode, const TBOX& page_box,
+                     BLOCK_LIST* blocks, TO_BLOCK_LIST* land_blocks,
+                     TO_BLOCK_LIST* port_blocks);
 
   //// control.h /////////////////////////////////////////////////////////
   void recog_all_words(                                //process words
@@ -145,6 +176,36 @@ class Tesseract : public Wordrec {
                            WERD_RES *word,
                            BLOCK* block,
                            ROW *row);
+  // Creates the helper instances that recognize the words of pass 2 in
+  // parallel with this one when tessedit_pass2_threads is more than 1.
+  // They borrow the language data of this instance, so they are created
+  // after init_tesseract, and deleted by end_pass2_helpers or
+  // end_tesseract.
+  void init_pass2_helpers();
+  void end_pass2_helpers();
+  // Creates the helper instances that try the seam candidates of a chop
+  // with this one when chop_seam_threads is more than 1, like the helpers
+  // of pass 2, and deletes them.
+  void init_seam_helpers();
+  void end_seam_helpers();
+  // Appends to helpers up to count new instances that borrow the language
+  // data of this one, stopping at the first that fails to initialize.
+  void make_helpers(int count, GenericVector<Tesseract*> *helpers);
+  // Recognizes the words of pass 2 of page_res with this instance and its
+  // helpers, each taking a run of words, with the same results as the
+  // serial pass. Returns false without touching the words if they can not
+  // be shared out, or true when they have all been recognized or the
+  // monitor cancelled the page, as *cancelled tells.
+  bool classify_words_pass2_parallel(PAGE_RES *page_res,
+                                     volatile ETEXT_DESC *monitor,
+                                     inT32 word_count,
+                                     int dict_words,
+                                     bool *cancelled);
+  // Gives helper the state that the words of pass 2 depend on: the member
+  // variables, the adapted templates in the snapshot, the word lists and
+  // the page size.
+  void copy_pass2_state(const char *templates, int templates_length,
+                        Tesseract *helper);
   BOOL8 recog_interactive(            //recognize blobs
                           BLOCK *block,    //block
                           ROW *row,   //row of word
@@ -203,6 +264,11 @@ class Tesseract : public Wordrec {
 
   void recognize_page(STRING& image_name);
   void end_tesseract();
+  // Makes the next init_tesseract borrow the read-only templates and dawgs
+  // of model instead of loading private copies. The model must have been
+  // loaded for the same language. The instance holds a reference to model
+  // until it is destroyed or another model is set. NULL detaches.
+  void set_language_model(LanguageModel* model);
 
   bool init_tesseract_lang_data(const char *arg0,
                                 const char *textbase,
@@ -530,9 +596,38 @@ class Tesseract : public Wordrec {
                                   FILE *output_file);
  private:
   Pix* pix_binary_;
+  IMAGE page_image_;
+  // Size and resolution of the strip source of a page segmented in strips.
+  int strip_page_width_;
+  int strip_page_height_;
+  int strip_page_resolution_;
   FCOORD deskew_;
   FCOORD reskew_;
   bool hindi_image_;
+  // State carried by recog_all_words from one pass to the next. It must
+  // survive between separate calls for pass 1 and pass 2, so it lives here
+  // rather than in (process-wide) function statics.
+  PAGE_RES_IT recog_page_res_it_;
+  CHAR_SAMPLES_LIST em_clusters_;
+  CHAR_SAMPLE_LIST ems_waiting_;
+  CHAR_SAMPLES_LIST char_clusters_;
+  CHAR_SAMPLE_LIST chars_waiting_;
+  inT16 doc_blob_quality_;
+  inT16 doc_outline_errs_;
+  inT16 doc_char_quality_;
+  inT16 good_char_count_;
+  inT16 doc_good_char_quality_;
+  inT32 doc_word_count_;
+  int doc_dict_words_;
+  // Output state of write_results, carried from one word to the next.
+  BOOL8 tilde_crunch_written_;
+  BOOL8 last_char_was_newline_;
+  BOOL8 last_char_was_tilde_;
+  BOOL8 empty_block_;
+  // Shared read-only language data, or NULL if this instance loads its own.
+  LanguageModel* language_model_;
+  // Instances recognizing the words of pass 2 together with this one.
+  GenericVector<Tesseract*> pass2_helpers_;
 };
 
 }  // namespace tesseract
@@ -34,5 +34,4 @@ EXTERN INT_VAR (tessedit_dangambigs_chop, FALSE,
 EXTERN INT_VAR (tessedit_dangambigs_assoc, FALSE,
 "Use UnicharAmbigs to direct assoc");
 
-EXTERN IMAGE page_image;         //image of page
 EXTERN FILE *debug_fp = stderr;           //write debug stuff here
@@ -43,6 +43,5 @@ extern INT_VAR_H (tessedit_dangambigs_chop, FALSE,
 extern INT_VAR_H (tessedit_dangambigs_assoc, FALSE,
 "Use UnicharAmbigs to direct assoc");
 
-extern IMAGE page_image;         //image of page
 extern FILE *debug_fp;           //write debug stuff here
 #endif
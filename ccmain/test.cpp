@@ -50,7 +50,7 @@ static void ocr(tesseract::TessBaseAPI *api,
 	printf("recognize\n");
 	char * text = api->GetUTF8Text();
 	if (tessedit_write_images) {
-		page_image.write("tessinput.tif");
+		api->WriteThresholdedImage("tessinput.tif");
 	}
 	FAILIF(text == NULL, "didn't recognize\n");
 
@@ -32,6 +32,7 @@
 #include          "globals.h"
 #include          "reject.h"
 #include          "tesseractclass.h"
+#include          "wordarena.h"
 
 #define EXTERN
 
@@ -66,6 +67,10 @@ WERD_CHOICE *Tesseract::recog_word(                     //recog one owrd
   WERD_CHOICE *word_choice;
   uinT8 perm_type;
   uinT8 real_dict_perm_type;
+  // The tess form of the word lives only inside this scope.
+  WordArenaScope arena_scope;
+  inT64 arena_allocs = WordArena::arena_allocs();
+  inT64 heap_allocs = WordArena::heap_allocs();
 
   if (word->blob_list ()->empty ()) {
     word_choice = new WERD_CHOICE("", NULL, 10.0f, -1.0f,
@@ -112,6 +117,9 @@ WERD_CHOICE *Tesseract::recog_word(                     //recog one owrd
     }
   }
   assert ((word_choice == NULL) == (raw_choice == NULL));
+  page_stats.Count(PC_ARENA_ALLOCS,
+                   WordArena::arena_allocs() - arena_allocs);
+  page_stats.Count(PC_HEAP_ALLOCS, WordArena::heap_allocs() - heap_allocs);
   return word_choice;
 }
 
@@ -36,6 +36,12 @@ void OtsuThreshold(const unsigned char* imagedata,
                    int left, int top, int width, int height,
                    int** thresholds, int** hi_values);
 
+// Compute the Otsu threshold(s) from the histograms of num_channels
+// channels, laid out one after the other, kHistogramSize counts each.
+// The results are as for OtsuThreshold.
+void OtsuThresholdFromHistograms(int num_channels, const int* histograms,
+                                 int** thresholds, int** hi_values);
+
 // Compute the histogram for the given image rectangle, and the given
 // channel. (Channel pointed to by imagedata.) Each channel is always
 // one byte per pixel.
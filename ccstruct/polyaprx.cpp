@@ -33,8 +33,6 @@ EXTERN BOOL_VAR (poly_debug, FALSE, "Debug old poly");
 EXTERN BOOL_VAR (poly_wide_objects_better, TRUE,
 "More accurate approx on wide things");
 
-static int par1, par2;
-
 #define CONVEX        1          /*OUTLINE point is convex */
 #define CONCAVE       2          /*used and set only in edges */
 #define FIXED       4            /*OUTLINE point is fixed */
@@ -51,6 +49,11 @@ static int par1, par2;
 #define fixed_dist      20       //really an int_variable
 #define approx_dist     15       //really an int_variable
 
+                                 /*1200(4) */
+static const int par1 = 4500 / (approx_dist * approx_dist);
+                                 /*1200(6) */
+static const int par2 = 6750 / (approx_dist * approx_dist);
+
 #define point_diff(p,p1,p2) (p).x = (p1).x - (p2).x ; (p).y = (p1).y - (p2).y
 #define CROSS(a,b) ((a).x * (b).y - (a).y * (b).x)
 #define LENGTH(a) ((a).x * (a).x + (a).y * (a).y)
@@ -407,11 +410,6 @@ EDGEPT *poly2(                  //second poly
   if (area < 1200)
     area = 1200;                 /*minimum value */
 
-                                 /*1200(4) */
-  par1 = 4500 / (approx_dist * approx_dist);
-                                 /*1200(6) */
-  par2 = 6750 / (approx_dist * approx_dist);
-
   loopstart = NULL;              /*not found it yet */
   edgept = startpt;              /*start of loop */
 
@@ -0,0 +1,555 @@
+///////////////////////////////////////////////////////////////////////
+// File:        allocprofile.cpp
+// Description: Per-thread allocation profile of the recognition of a page.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "allocprofile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+namespace tesseract {
+
+static const char* const kSubsystemNames[AS_COUNT] = {
+  "other",
+  "textord",
+  "ccmain",
+  "wordrec",
+  "classify",
+  "dict",
+};
+
+// Frames of SampleStack, RecordAlloc and Malloc or Realloc at the top of a
+// sampled stack. The ones of their caller, such as operator new or
+// alloc_mem, are kept, as they may be inlined.
+const int kSkippedSampleFrames = 3;
+
+static bool profiler_enabled = false;
+static int profiler_sample_bytes = 0;
+
+// The profiler state of a thread. It is allocated with calloc, so that
+// making it does not recurse into operator new.
+struct ThreadAllocState {
+  AllocProfile profile;
+  AllocSubsystem subsystem;
+  inT64 bytes_until_sample;
+  bool in_hook;  // Set while the profiler itself is allocating.
+};
+
+#ifdef WIN32
+
+// The state of a thread is not freed when it exits.
+static DWORD state_key = TLS_OUT_OF_INDEXES;
+
+static ThreadAllocState* GetThreadState(bool create) {
+  if (state_key == TLS_OUT_OF_INDEXES) {
+    if (!create)
+      return NULL;
+    state_key = TlsAlloc();
+    if (state_key == TLS_OUT_OF_INDEXES)
+      return NULL;
+  }
+  void* state = TlsGetValue(state_key);
+  if (state == NULL && create) {
+    state = calloc(1, sizeof(ThreadAllocState));
+    if (state == NULL)
+      return NULL;
+    new(state) ThreadAllocState;
+    TlsSetValue(state_key, state);
+  }
+  return static_cast<ThreadAllocState*>(state);
+}
+
+#else
+
+static pthread_key_t state_key;
+static pthread_once_t state_key_once = PTHREAD_ONCE_INIT;
+static bool state_key_made = false;
+
+static void FreeThreadState(void* state) {
+  free(state);
+}
+
+static void MakeStateKey() {
+  state_key_made = pthread_key_create(&state_key, FreeThreadState) == 0;
+}
+
+static ThreadAllocState* GetThreadState(bool create) {
+  pthread_once(&state_key_once, MakeStateKey);
+  if (!state_key_made)
+    return NULL;
+  void* state = pthread_getspecific(state_key);
+  if (state == NULL && create) {
+    state = calloc(1, sizeof(ThreadAllocState));
+    if (state == NULL)
+      return NULL;
+    new(state) ThreadAllocState;
+    pthread_setspecific(state_key, state);
+  }
+  return static_cast<ThreadAllocState*>(state);
+}
+
+#endif  // WIN32
+
+AllocProfile::AllocProfile() {
+  Reset();
+}
+
+void AllocProfile::Reset() {
+  memset(counts_, 0, sizeof(counts_));
+  start_live_bytes_ = 0;
+  live_bytes_ = 0;
+  peak_live_bytes_ = 0;
+  peak_subsystem_ = AS_OTHER;
+  start_rss_kb_ = 0;
+  rss_kb_ = 0;
+  start_peak_rss_kb_ = 0;
+  peak_rss_kb_ = 0;
+  sample_bytes_ = 0;
+  num_samples_ = 0;
+  dropped_samples_ = 0;
+}
+
+// static
+const char* AllocProfile::SubsystemName(AllocSubsystem subsystem) {
+  return kSubsystemNames[subsystem];
+}
+
+// Appends str to json as a JSON string.
+static void AppendJSONString(const char* str, STRING* json) {
+  char buf[8];
+  *json += "\"";
+  for (; *str != '\0'; ++str) {
+    unsigned char ch = static_cast<unsigned char>(*str);
+    if (ch == '"' || ch == '\\') {
+      buf[0] = '\\';
+      buf[1] = ch;
+      buf[2] = '\0';
+    } else if (ch < ' ') {
+      sprintf(buf, "\\u%04x", ch);
+    } else {
+      buf[0] = ch;
+      buf[1] = '\0';
+    }
+    *json += buf;
+  }
+  *json += "\"";
+}
+
+void AllocProfile::ToJSON(bool symbols, STRING* json) const {
+  char buf[256];
+  sprintf(buf, "{\"start_live_bytes\":" INT64FORMAT ",\"live_bytes\":"
+          INT64FORMAT ",\"peak_live_bytes\":" INT64FORMAT
+          ",\"peak_subsystem\":\"%s\",", start_live_bytes_, live_bytes_,
+          peak_live_bytes_, kSubsystemNames[peak_subsystem_]);
+  *json += buf;
+  sprintf(buf, "\"start_rss_kb\":" INT64FORMAT ",\"rss_kb\":" INT64FORMAT
+          ",\"start_peak_rss_kb\":" INT64FORMAT ",\"peak_rss_kb\":"
+          INT64FORMAT ",\"subsystems\":{", start_rss_kb_, rss_kb_,
+          start_peak_rss_kb_, peak_rss_kb_);
+  *json += buf;
+  for (int s = 0; s < AS_COUNT; ++s) {
+    const AllocCounts& counts = counts_[s];
+    sprintf(buf, "\"%s\":{\"allocs\":" INT64FORMAT ",\"frees\":" INT64FORMAT
+            ",\"bytes\":" INT64FORMAT ",\"live_bytes\":" INT64FORMAT
+            ",\"peak_live_bytes\":" INT64FORMAT "}%s", kSubsystemNames[s],
+            counts.allocs, counts.frees, counts.bytes, counts.live_bytes,
+            counts.peak_live_bytes, s + 1 < AS_COUNT ? "," : "},");
+    *json += buf;
+  }
+  sprintf(buf, "\"sample_bytes\":%d,\"dropped_samples\":" INT64FORMAT
+          ",\"samples\":[", sample_bytes_, dropped_samples_);
+  *json += buf;
+  for (int i = 0; i < num_samples_; ++i) {
+    const AllocSample& sample = samples_[i];
+    sprintf(buf, "%s{\"subsystem\":\"%s\",\"samples\":" INT64FORMAT
+            ",\"frames\":[", i > 0 ? "," : "",
+            kSubsystemNames[sample.subsystem], sample.samples);
+    *json += buf;
+    char** names = NULL;
+#ifdef __GLIBC__
+    if (symbols && sample.num_frames > 0)
+      names = backtrace_symbols(sample.frames, sample.num_frames);
+#endif
+    for (int f = 0; f < sample.num_frames; ++f) {
+      if (f > 0)
+        *json += ",";
+      if (names != NULL) {
+        AppendJSONString(names[f], json);
+      } else {
+        sprintf(buf, "\"%p\"", sample.frames[f]);
+        *json += buf;
+      }
+    }
+    free(names);
+    *json += "]}";
+  }
+  *json += "]}";
+}
+
+// static
+bool AllocProfiler::counts_allocations() {
+#ifdef ENABLE_ALLOC_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+// static
+bool AllocProfiler::enabled() {
+  return profiler_enabled;
+}
+
+// static
+void AllocProfiler::set_enabled(bool enabled, int sample_bytes) {
+  profiler_sample_bytes = sample_bytes > 0 ? sample_bytes : 0;
+  profiler_enabled = enabled;
+}
+
+// static
+void AllocProfiler::StartPage() {
+  if (!profiler_enabled)
+    return;
+  ThreadAllocState* state = GetThreadState(true);
+  if (state == NULL)
+    return;
+  AllocProfile* profile = &state->profile;
+  // Keep the live bytes, which include memory allocated for earlier pages
+  // that this page may free.
+  inT64 live_bytes = profile->live_bytes_;
+  AllocCounts counts[AS_COUNT];
+  memcpy(counts, profile->counts_, sizeof(counts));
+  profile->Reset();
+  for (int s = 0; s < AS_COUNT; ++s) {
+    profile->counts_[s].live_bytes = counts[s].live_bytes;
+    profile->counts_[s].peak_live_bytes = counts[s].live_bytes;
+  }
+  profile->start_live_bytes_ = live_bytes;
+  profile->live_bytes_ = live_bytes;
+  profile->peak_live_bytes_ = live_bytes;
+  profile->peak_subsystem_ = state->subsystem;
+  profile->sample_bytes_ = profiler_sample_bytes;
+  profile->start_rss_kb_ = RSSKBytes();
+  profile->start_peak_rss_kb_ = PeakRSSKBytes();
+  state->bytes_until_sample = profiler_sample_bytes;
+}
+
+// static
+void AllocProfiler::GetPage(AllocProfile* profile) {
+  ThreadAllocState* state = GetThreadState(false);
+  if (state != NULL) {
+    state->in_hook = true;
+    *profile = state->profile;
+    state->in_hook = false;
+  } else {
+    profile->Reset();
+  }
+  profile->rss_kb_ = RSSKBytes();
+  profile->peak_rss_kb_ = PeakRSSKBytes();
+}
+
+// static
+AllocSubsystem AllocProfiler::subsystem() {
+  ThreadAllocState* state = GetThreadState(false);
+  return state != NULL ? state->subsystem : AS_OTHER;
+}
+
+// static
+void AllocProfiler::set_subsystem(AllocSubsystem subsystem) {
+  ThreadAllocState* state = GetThreadState(true);
+  if (state != NULL)
+    state->subsystem = subsystem;
+}
+
+// Records the stack of the current allocation in the samples of the
+// profile, merging it with an identical one.
+static void SampleStack(AllocSubsystem subsystem, AllocSample* samples,
+                        int* num_samples, inT64* dropped_samples) {
+#ifdef __GLIBC__
+  void* frames[kMaxAllocSampleFrames + kSkippedSampleFrames];
+  int num_frames = backtrace(frames, kMaxAllocSampleFrames +
+                                     kSkippedSampleFrames);
+  num_frames -= kSkippedSampleFrames;
+  if (num_frames <= 0)
+    return;
+  void** top = frames + kSkippedSampleFrames;
+  for (int i = 0; i < *num_samples; ++i) {
+    AllocSample* sample = &samples[i];
+    if (sample->subsystem == subsystem && sample->num_frames == num_frames &&
+        memcmp(sample->frames, top, num_frames * sizeof(top[0])) == 0) {
+      ++sample->samples;
+      return;
+    }
+  }
+  if (*num_samples == kMaxAllocSamples) {
+    ++*dropped_samples;
+    return;
+  }
+  AllocSample* sample = &samples[(*num_samples)++];
+  sample->subsystem = subsystem;
+  sample->num_frames = num_frames;
+  memcpy(sample->frames, top, num_frames * sizeof(top[0]));
+  sample->samples = 1;
+#endif
+}
+
+// static
+int AllocProfiler::RecordAlloc(size_t size) {
+  if (!profiler_enabled)
+    return AS_COUNT;
+  ThreadAllocState* state = GetThreadState(true);
+  if (state == NULL || state->in_hook)
+    return AS_COUNT;
+  state->in_hook = true;
+  AllocSubsystem subsystem = state->subsystem;
+  AllocProfile* profile = &state->profile;
+  AllocCounts* counts = &profile->counts_[subsystem];
+  ++counts->allocs;
+  counts->bytes += size;
+  counts->live_bytes += size;
+  if (counts->live_bytes > counts->peak_live_bytes)
+    counts->peak_live_bytes = counts->live_bytes;
+  profile->live_bytes_ += size;
+  if (profile->live_bytes_ > profile->peak_live_bytes_) {
+    profile->peak_live_bytes_ = profile->live_bytes_;
+    profile->peak_subsystem_ = subsystem;
+  }
+  if (profile->sample_bytes_ > 0) {
+    state->bytes_until_sample -= size;
+    if (state->bytes_until_sample <= 0) {
+      SampleStack(subsystem, profile->samples_, &profile->num_samples_,
+                  &profile->dropped_samples_);
+      state->bytes_until_sample = profile->sample_bytes_;
+    }
+  }
+  state->in_hook = false;
+  return subsystem;
+}
+
+// static
+void AllocProfiler::RecordFree(size_t size, int subsystem) {
+  // Frees of counted allocations are counted even after the profiler is
+  // turned off, to keep the live bytes right.
+  if (subsystem < 0 || subsystem >= AS_COUNT)
+    return;
+  ThreadAllocState* state = GetThreadState(false);
+  if (state == NULL)
+    return;
+  AllocCounts* counts = &state->profile.counts_[subsystem];
+  ++counts->frees;
+  counts->live_bytes -= size;
+  state->profile.live_bytes_ -= size;
+}
+
+// static
+inT64 AllocProfiler::RSSKBytes() {
+#ifdef WIN32
+  return 0;
+#else
+  FILE* fp = fopen("/proc/self/statm", "r");
+  if (fp == NULL)
+    return 0;
+  long size_pages = 0;
+  long resident_pages = 0;
+  int found = fscanf(fp, "%ld %ld", &size_pages, &resident_pages);
+  fclose(fp);
+  if (found != 2)
+    return 0;
+  return static_cast<inT64>(resident_pages) * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+// static
+inT64 AllocProfiler::PeakRSSKBytes() {
+#ifdef WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;  // Bytes rather than kilobytes.
+#else
+  return usage.ru_maxrss;
+#endif
+#endif
+}
+
+#ifdef ENABLE_ALLOC_PROFILE
+
+// Each counted block is preceded by a header holding its size and the
+// subsystem it was charged to, so that Free can take them back off.
+union AllocHeader {
+  struct {
+    size_t size;
+    int subsystem;
+  } info;
+  double align[2];  // Keeps the blocks aligned like those of malloc.
+};
+
+// static
+void* AllocProfiler::Malloc(size_t size) {
+  AllocHeader* header =
+    static_cast<AllocHeader*>(malloc(sizeof(AllocHeader) + size));
+  if (header == NULL)
+    return NULL;
+  header->info.size = size;
+  header->info.subsystem = RecordAlloc(size);
+  return header + 1;
+}
+
+// static
+void* AllocProfiler::Calloc(size_t count, size_t size) {
+  if (size != 0 && count > (static_cast<size_t>(-1) - sizeof(AllocHeader)) /
+                           size)
+    return NULL;
+  void* ptr = Malloc(count * size);
+  if (ptr != NULL)
+    memset(ptr, 0, count * size);
+  return ptr;
+}
+
+// static
+void* AllocProfiler::Realloc(void* ptr, size_t size) {
+  if (ptr == NULL)
+    return Malloc(size);
+  if (size == 0) {
+    Free(ptr);
+    return NULL;
+  }
+  AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+  size_t old_size = header->info.size;
+  int old_subsystem = header->info.subsystem;
+  header = static_cast<AllocHeader*>(realloc(header,
+                                             sizeof(AllocHeader) + size));
+  if (header == NULL)
+    return NULL;  // The old block is left as it was.
+  RecordFree(old_size, old_subsystem);
+  header->info.size = size;
+  header->info.subsystem = RecordAlloc(size);
+  return header + 1;
+}
+
+// static
+void AllocProfiler::Free(void* ptr) {
+  if (ptr == NULL)
+    return;
+  AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+  RecordFree(header->info.size, header->info.subsystem);
+  free(header);
+}
+
+#else  // ENABLE_ALLOC_PROFILE
+
+// static
+void* AllocProfiler::Malloc(size_t size) {
+  return malloc(size);
+}
+
+// static
+void* AllocProfiler::Calloc(size_t count, size_t size) {
+  return calloc(count, size);
+}
+
+// static
+void* AllocProfiler::Realloc(void* ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+// static
+void AllocProfiler::Free(void* ptr) {
+  free(ptr);
+}
+
+#endif  // ENABLE_ALLOC_PROFILE
+
+}  // namespace tesseract
+
+#ifdef ENABLE_ALLOC_PROFILE
+
+// The global operator new and delete, replaced to feed the profiler
+// through AllocProfiler::Malloc and Free.
+
+#if __cplusplus >= 201103L
+#define ALLOC_PROFILE_THROW
+#define ALLOC_PROFILE_NOTHROW noexcept
+#else
+#define ALLOC_PROFILE_THROW throw(std::bad_alloc)
+#define ALLOC_PROFILE_NOTHROW throw()
+#endif
+
+// Like the operator new of the library, calls the new handler until the
+// allocation succeeds, and throws std::bad_alloc if there is none.
+static void* ProfiledNew(size_t size) {
+  for (;;) {
+    void* ptr = tesseract::AllocProfiler::Malloc(size);
+    if (ptr != NULL)
+      return ptr;
+    std::new_handler handler = std::set_new_handler(NULL);
+    std::set_new_handler(handler);
+    if (handler == NULL)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void* operator new(size_t size) ALLOC_PROFILE_THROW {
+  return ProfiledNew(size);
+}
+
+void* operator new[](size_t size) ALLOC_PROFILE_THROW {
+  return ProfiledNew(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) ALLOC_PROFILE_NOTHROW {
+  return tesseract::AllocProfiler::Malloc(size);
+}
+
+void* operator new[](size_t size,
+                     const std::nothrow_t&) ALLOC_PROFILE_NOTHROW {
+  return tesseract::AllocProfiler::Malloc(size);
+}
+
+void operator delete(void* ptr) ALLOC_PROFILE_NOTHROW {
+  tesseract::AllocProfiler::Free(ptr);
+}
+
+void operator delete[](void* ptr) ALLOC_PROFILE_NOTHROW {
+  tesseract::AllocProfiler::Free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) ALLOC_PROFILE_NOTHROW {
+  tesseract::AllocProfiler::Free(ptr);
+}
+
+void operator delete[](void* ptr,
+                       const std::nothrow_t&) ALLOC_PROFILE_NOTHROW {
+  tesseract::AllocProfiler::Free(ptr);
+}
+
+#endif  // ENABLE_ALLOC_PROFILE
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////
+// File:        allocprofile.h
+// Description: Per-thread allocation profile of the recognition of a page.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_ALLOCPROFILE_H__
+#define TESSERACT_CCUTIL_ALLOCPROFILE_H__
+
+#include <stddef.h>
+
+#include "host.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+// The parts of the recognition that allocations are charged to. An
+// AllocSubsystemScope makes its subsystem the current one of its thread,
+// until the scope of another subsystem is entered.
+enum AllocSubsystem {
+  AS_OTHER,     // Outside of any scope, such as in the API.
+  AS_TEXTORD,   // Page layout analysis and finding of rows and words.
+  AS_CCMAIN,    // Thresholding and the passes over the words.
+  AS_WORDREC,   // Chopping and segmentation search of a word.
+  AS_CLASSIFY,  // Classification of and adaptation to blobs.
+  AS_DICT,      // Permuters and dictionary lookups.
+  AS_COUNT
+};
+
+const int kMaxAllocSampleFrames = 16;
+const int kMaxAllocSamples = 32;
+
+// The allocations charged to one subsystem.
+struct AllocCounts {
+  inT64 allocs;
+  inT64 frees;
+  inT64 bytes;            // Total size of allocs.
+  inT64 live_bytes;       // Allocated and not freed yet.
+  inT64 peak_live_bytes;  // Highest live_bytes.
+};
+
+// A call stack of an allocation caught by the sampling of the profiler.
+struct AllocSample {
+  AllocSubsystem subsystem;
+  int num_frames;
+  void* frames[kMaxAllocSampleFrames];
+  inT64 samples;  // Number of times the stack was sampled.
+};
+
+// AllocProfile is the allocation profile of the recognition of a page on
+// one thread: the allocations of each subsystem, the subsystem that was
+// running when the heap of the thread was the largest, the resident set
+// size of the process and the call stacks of a sample of the allocations.
+// The live bytes carry over from one page to the next, so the peaks of a
+// page are relative to start_live_bytes.
+class AllocProfile {
+ public:
+  AllocProfile();
+
+  // Zeroes all counts and forgets the samples.
+  void Reset();
+
+  const AllocCounts& counts(AllocSubsystem subsystem) const {
+    return counts_[subsystem];
+  }
+  inT64 start_live_bytes() const {
+    return start_live_bytes_;
+  }
+  inT64 live_bytes() const {
+    return live_bytes_;
+  }
+  inT64 peak_live_bytes() const {
+    return peak_live_bytes_;
+  }
+  AllocSubsystem peak_subsystem() const {
+    return peak_subsystem_;
+  }
+  // Resident set size of the process at the start and at the end of the
+  // page, and its highest value so far at the start and at the end. When
+  // the last two differ, the page raised the peak of the process. All are
+  // 0 where they are not available.
+  inT64 start_rss_kb() const {
+    return start_rss_kb_;
+  }
+  inT64 rss_kb() const {
+    return rss_kb_;
+  }
+  inT64 start_peak_rss_kb() const {
+    return start_peak_rss_kb_;
+  }
+  inT64 peak_rss_kb() const {
+    return peak_rss_kb_;
+  }
+  // Each sample stands for sample_bytes allocated bytes.
+  int sample_bytes() const {
+    return sample_bytes_;
+  }
+  int num_samples() const {
+    return num_samples_;
+  }
+  const AllocSample& sample(int index) const {
+    return samples_[index];
+  }
+  // Samples whose stack did not fit in the table.
+  inT64 dropped_samples() const {
+    return dropped_samples_;
+  }
+
+  // Name used for the subsystem in ToJSON, such as "classify".
+  static const char* SubsystemName(AllocSubsystem subsystem);
+
+  // Appends the profile to json as a single JSON object. If symbols is
+  // true, the frames of the samples are given as symbols where they can
+  // be found, and as addresses otherwise.
+  void ToJSON(bool symbols, STRING* json) const;
+
+ private:
+  friend class AllocProfiler;
+
+  AllocCounts counts_[AS_COUNT];
+  inT64 start_live_bytes_;
+  inT64 live_bytes_;
+  inT64 peak_live_bytes_;
+  AllocSubsystem peak_subsystem_;
+  inT64 start_rss_kb_;
+  inT64 rss_kb_;
+  inT64 start_peak_rss_kb_;
+  inT64 peak_rss_kb_;
+  int sample_bytes_;
+  int num_samples_;
+  AllocSample samples_[kMaxAllocSamples];
+  inT64 dropped_samples_;
+};
+
+// AllocProfiler keeps an AllocProfile for each thread. Allocations are
+// only counted in builds with ENABLE_ALLOC_PROFILE defined, which replace
+// the global operator new and delete and make alloc_mem, alloc_struct,
+// alloc_string and Emalloc allocate through Malloc; other builds report
+// the resident set sizes only. The profiler is off by default, and then
+// costs a test of enabled() per allocation and per AllocSubsystemScope.
+//
+// Memory freed by another thread than the one that allocated it is
+// counted as freed by the freeing thread, whose live bytes may then go
+// below their start.
+class AllocProfiler {
+ public:
+  // True if the build counts allocations.
+  static bool counts_allocations();
+
+  static bool enabled();
+  // Turns the profiler on or off for all threads. While it is on, the
+  // call stack of one allocation in about every sample_bytes allocated
+  // bytes is recorded, if the platform can capture it. 0 records none.
+  static void set_enabled(bool enabled, int sample_bytes);
+
+  // Starts the profile of a new page on the calling thread.
+  static void StartPage();
+  // Copies the profile of the current page of the calling thread into
+  // profile.
+  static void GetPage(AllocProfile* profile);
+
+  // The subsystem that the allocations of the calling thread are charged
+  // to.
+  static AllocSubsystem subsystem();
+  static void set_subsystem(AllocSubsystem subsystem);
+
+  // Called by the allocator. RecordAlloc charges an allocation of size
+  // bytes to the current subsystem of the calling thread and returns it,
+  // or returns AS_COUNT if the allocation is not counted. RecordFree
+  // takes the size and the subsystem returned for the allocation.
+  static int RecordAlloc(size_t size);
+  static void RecordFree(size_t size, int subsystem);
+
+  // The allocator of the memory functions of ccutil and cutil. In builds
+  // with ENABLE_ALLOC_PROFILE, the blocks carry the same header as those of
+  // operator new and are charged to the current subsystem, so they must
+  // only be given back to Realloc or Free, never to free. In other builds
+  // these are malloc, calloc, realloc and free.
+  static void* Malloc(size_t size);
+  static void* Calloc(size_t count, size_t size);
+  static void* Realloc(void* ptr, size_t size);
+  static void Free(void* ptr);
+
+  // The current and the highest resident set size of the process, or 0
+  // where they are not available.
+  static inT64 RSSKBytes();
+  static inT64 PeakRSSKBytes();
+};
+
+// Charges the allocations of the calling thread to a subsystem for the
+// lifetime of the scope.
+class AllocSubsystemScope {
+ public:
+  explicit AllocSubsystemScope(AllocSubsystem subsystem)
+    : previous_(AS_COUNT) {
+    if (AllocProfiler::enabled()) {
+      previous_ = AllocProfiler::subsystem();
+      AllocProfiler::set_subsystem(subsystem);
+    }
+  }
+  ~AllocSubsystemScope() {
+    if (previous_ != AS_COUNT)
+      AllocProfiler::set_subsystem(previous_);
+  }
+
+ private:
+  // Not copyable.
+  AllocSubsystemScope(const AllocSubsystemScope&);
+  AllocSubsystemScope& operator=(const AllocSubsystemScope&);
+
+  AllocSubsystem previous_;  // AS_COUNT if the profiler was off.
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_ALLOCPROFILE_H__
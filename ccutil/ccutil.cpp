@@ -43,6 +43,46 @@ void CCUtilMutex::Unlock() {
 #endif
 }
 
+CCUtilThread::CCUtilThread() : started_(false) {
+}
+
+bool CCUtilThread::Start(void *(*func)(void *), void *arg) {
+  if (started_)
+    return false;
+#ifdef WIN32
+  thread_ = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) func, arg, 0, NULL);
+  started_ = thread_ != NULL;
+#else
+  started_ = pthread_create(&thread_, NULL, func, arg) == 0;
+#endif
+  return started_;
+}
+
+void CCUtilThread::Join() {
+  if (!started_)
+    return;
+#ifdef WIN32
+  WaitForSingleObject(thread_, INFINITE);
+  CloseHandle(thread_);
+#else
+  pthread_join(thread_, NULL);
+#endif
+  started_ = false;
+}
+
+// static
+int CCUtilThread::NumProcessors() {
+  int num_processors = 1;
+#ifdef WIN32
+  SYSTEM_INFO system_info;
+  GetSystemInfo(&system_info);
+  num_processors = system_info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  num_processors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return num_processors > 0 ? num_processors : 1;
+}
+
 
 CCUtilMutex tprintfMutex;
 } // namespace tesseract
@@ -19,8 +19,10 @@
 #ifndef TESSERACT_CCUTIL_CCUTIL_H__
 #define TESSERACT_CCUTIL_CCUTIL_H__
 
+#include "allocprofile.h"
 #include "ambigs.h"
 #include "errcode.h"
+#include "pagestats.h"
 #include "strngs.h"
 #include "tessdatamanager.h"
 #include "varable.h"
@@ -31,6 +33,7 @@
 #else
 #include <pthread.h>
 #include <semaphore.h>
+#include <unistd.h>
 #endif
 
 namespace tesseract {
@@ -50,6 +53,28 @@ class CCUtilMutex {
 #endif
 };
 
+// A thread that runs a single function and must be waited for with Join.
+class CCUtilThread {
+ public:
+  CCUtilThread();
+
+  // Runs func(arg) in a new thread. Returns false if it could not be started.
+  bool Start(void *(*func)(void *), void *arg);
+
+  // Waits for the function given to Start to return.
+  void Join();
+
+  // Returns the number of processors online, at least 1.
+  static int NumProcessors();
+ private:
+#ifdef WIN32
+  HANDLE thread_;
+#else
+  pthread_t thread_;
+#endif
+  bool started_;
+};
+
 
 class CCUtil {
  public:
@@ -75,6 +100,8 @@ class CCUtil {
   UnicharAmbigs unichar_ambigs;
   STRING imagefile;  // image file name
   STRING directory;  // main directory
+  PageStats page_stats;  // Stage timing of the current page.
+  AllocProfile alloc_profile;  // Allocations of the last page recognized.
 };
 
 extern CCUtilMutex tprintfMutex;
@@ -21,9 +21,11 @@
 #define TESSERACT_CCUTIL_GENERICVECTOR_H_
 
 #include <stdio.h>
+#include <string.h>
 
 #include "callback.h"
 #include "errcode.h"
+#include "serialis.h"
 
 template <typename T>
 class GenericVector {
@@ -106,6 +108,13 @@ class GenericVector {
   // the callback to NULL.
   virtual void clear();
 
+  // Removes the elements from index size on, keeping the memory for reuse.
+  // Neither the clear callback nor any destructor is called for them.
+  void truncate(int size) {
+    if (size < size_used_)
+      size_used_ = size;
+  }
+
   // Delete objects pointed to by data_[i]
   void delete_data_pointers();
 
@@ -26,6 +26,7 @@
 #include          "tprintf.h"
 #include          "memblk.h"
 #include          "memry.h"
+#include          "allocprofile.h"
 
 //#define COUNTING_CLASS_STRUCTURES
 
@@ -59,16 +60,23 @@ void*						addr						//mem to free
 /**********************************************************************
  * check_mem
  *
- * Check consistency of all memory controlled by alloc_mem.
+ * Check consistency of the structures of alloc_struct, and report the
+ * allocation profile of the calling thread (see allocprofile.h).
  **********************************************************************/
 
 DLLSYM void check_mem(                     //check consistency
                       const char *string,  //context message
                       inT8 level           //level of check
                      ) {
-  big_mem.check (string, level);
-  main_mem.check (string, level);
   check_structs(level);
+  if (level >= MEMCHECKS && tesseract::AllocProfiler::enabled()) {
+    tesseract::AllocProfile profile;
+    STRING json;
+
+    tesseract::AllocProfiler::GetPage(&profile);
+    profile.ToJSON(level >= FULLMEMCHECKS, &json);
+    tprintf ("%s: %s\n", string, json.string ());
+  }
 }
 
 
@@ -115,7 +123,8 @@ DLLSYM char *alloc_string(             //allocate string
   return &string[1];             //string for user
 #else
   // Round up the amount allocated to a multiple of 4
-  return static_cast<char*>(malloc((count + 3) & ~3));
+  return static_cast<char*>(
+      tesseract::AllocProfiler::Malloc((count + 3) & ~3));
 #endif
 }
 
@@ -144,7 +153,7 @@ DLLSYM void free_string(              //free a string
   }
   tprintf ("Non-string given to free_string");
 #else
-  free(string);
+  tesseract::AllocProfiler::Free(string);
 #endif
 }
 
@@ -234,7 +243,7 @@ const char *                     //name of type
   }
   return returnelement;          //free cell
 #else
-  return malloc(count);
+  return tesseract::AllocProfiler::Malloc(count);
 #endif
 }
 
@@ -369,7 +378,7 @@ const char *                     //name of type
       free_mem(deadstruct);  //free directly
   }
 #else
-  free(deadstruct);
+  tesseract::AllocProfiler::Free(deadstruct);
 #endif
 }
 
@@ -378,34 +387,12 @@ const char *                     //name of type
  * alloc_mem_p
  *
  * Allocate permanent space which will never be returned.
- * This space is allocated from the top end of a memory block to
- * avoid the fragmentation which would result from alternate use
- * of alloc_mem for permanent and temporary blocks.
  **********************************************************************/
 
-//#ifdef __UNIX__
-//#pragma OPT_LEVEL 0
-//#endif
 DLLSYM void *alloc_mem_p(             //allocate permanent space
                          inT32 count  //block size to allocate
                         ) {
-  #ifdef RAYS_MALLOC
-  #ifdef TESTING_BIGSTUFF
-  if (main_mem.biggestblock == 0)
-    main_mem.init (alloc_big_mem, free_big_mem,
-      FIRSTSIZE, LASTSIZE, MAX_CHUNK);
-  #else
-  if (main_mem.biggestblock == 0)
-    main_mem.init ((void *(*)(inT32)) malloc, free,
-      FIRSTSIZE, LASTSIZE, MAX_CHUNK);
-  #endif
-  if (mem_mallocdepth > 0)
-    return main_mem.alloc_p (count, trace_caller (mem_mallocdepth));
-  else
-    return main_mem.alloc_p (count, NULL);
-  #else
-  return malloc ((size_t) count);
-  #endif
+  return tesseract::AllocProfiler::Malloc((size_t) count);
 }
 
 
@@ -418,23 +405,7 @@ DLLSYM void *alloc_mem_p(             //allocate permanent space
 DLLSYM void *alloc_mem(             //get some memory
                        inT32 count  //no of bytes to get
                       ) {
-  #ifdef RAYS_MALLOC
-  #ifdef TESTING_BIGSTUFF
-  if (main_mem.biggestblock == 0)
-    main_mem.init (alloc_big_mem, free_big_mem,
-      FIRSTSIZE, LASTSIZE, MAX_CHUNK);
-  #else
-  if (main_mem.biggestblock == 0)
-    main_mem.init ((void *(*)(inT32)) malloc, free,
-      FIRSTSIZE, LASTSIZE, MAX_CHUNK);
-  #endif
-  if (mem_mallocdepth > 0)
-    return main_mem.alloc (count, trace_caller (mem_mallocdepth));
-  else
-    return main_mem.alloc (count, NULL);
-  #else
-  return malloc ((size_t) count);
-  #endif
+  return tesseract::AllocProfiler::Malloc((size_t) count);
 }
 
 
@@ -447,17 +418,7 @@ DLLSYM void *alloc_mem(             //get some memory
 DLLSYM void *alloc_big_mem(             //get some memory
                            inT32 count  //no of bytes to get
                           ) {
-  #ifdef TESTING_BIGSTUFF
-  if (big_mem.biggestblock == 0)
-    big_mem.init ((void *(*)(inT32)) malloc, free,
-      BIGSIZE, BIGSIZE, MAX_BIGCHUNK);
-  if (mem_mallocdepth > 0)
-    return big_mem.alloc (count, trace_caller (mem_mallocdepth));
-  else
-    return big_mem.alloc (count, NULL);
-  #else
-  return malloc ((size_t) count);
-  #endif
+  return tesseract::AllocProfiler::Malloc((size_t) count);
 }
 
 
@@ -470,21 +431,7 @@ DLLSYM void *alloc_big_mem(             //get some memory
 DLLSYM void *alloc_big_zeros(             //get some memory
                              inT32 count  //no of bytes to get
                             ) {
-  #ifdef TESTING_BIGSTUFF
-  if (big_mem.biggestblock == 0)
-    big_mem.init ((void *(*)(inT32)) malloc, free,
-      BIGSIZE, BIGSIZE, MAX_BIGCHUNK);
-  void *buf;                     //return value
-
-  if (mem_mallocdepth > 0)
-    buf = big_mem.alloc (count, trace_caller (mem_mallocdepth));
-  else
-    buf = big_mem.alloc (count, NULL);
-  memset (buf, 0, count);
-  return buf;
-  #else
-  return calloc ((size_t) count, 1);
-  #endif
+  return tesseract::AllocProfiler::Calloc((size_t) count, 1);
 }
 
 
@@ -492,21 +439,12 @@ DLLSYM void *alloc_big_zeros(             //get some memory
  * free_mem
  *
  * Free a block allocated by alloc_mem (or alloc_mem_p).
- * It checks that the pointer is legal and maintains counts of the
- * amount of free memory above and below the current free pointer.
  **********************************************************************/
 
 DLLSYM void free_mem(                //free mem from alloc_mem
                      void *oldchunk  //chunk to free
                     ) {
-  #ifdef RAYS_MALLOC
-  if (mem_freedepth > 0 && main_mem.callers != NULL)
-    main_mem.dealloc (oldchunk, trace_caller (mem_freedepth));
-  else
-    main_mem.dealloc (oldchunk, NULL);
-  #else
-  free(oldchunk);
-  #endif
+  tesseract::AllocProfiler::Free(oldchunk);
 }
 
 
@@ -514,19 +452,10 @@ DLLSYM void free_mem(                //free mem from alloc_mem
  * free_big_mem
  *
  * Free a block allocated by alloc_big_mem.
- * It checks that the pointer is legal and maintains counts of the
- * amount of free memory above and below the current free pointer.
  **********************************************************************/
 
 DLLSYM void free_big_mem(                //free mem from alloc_mem
                          void *oldchunk  //chunk to free
                         ) {
-  #ifdef TESTING_BIGSTUFF
-  if (mem_freedepth > 0 && main_mem.callers != NULL)
-    big_mem.dealloc (oldchunk, trace_caller (mem_freedepth));
-  else
-    big_mem.dealloc (oldchunk, NULL);
-  #else
-  free(oldchunk);
-  #endif
+  tesseract::AllocProfiler::Free(oldchunk);
 }
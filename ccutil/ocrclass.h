@@ -302,6 +302,7 @@ typedef struct ETEXT_STRUCT      /*output header */
   CANCEL_FUNC cancel;            /*returns true to cancel */
   void* cancel_this;             /*this or other data for cancel*/
   clock_t end_time;              /*time to stop if not 0*/
+  inT32 page_number;             /*page in a batch (TessBatchAPI), else -1*/
   EANYCODE_CHAR text[1];         /*character data */
 } ETEXT_DESC;                    /*output header */
 
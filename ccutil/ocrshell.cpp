@@ -443,6 +443,7 @@ ETEXT_DESC *ocr_setup_monitor() {  /*setup monitor */
   monitor->ocr_alive = TRUE;     /*ocr sets to 1, hp 0 */
   monitor->err_code = 0;         /*used by ocr_error */
   monitor->cancel = FALSE;       /*0=continue, 1=cancel */
+  monitor->page_number = -1;     /*not part of a batch */
 
 
 //by jetsoft
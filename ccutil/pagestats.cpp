@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.cpp
+// Description: Per-page timing and counters of the recognition stages.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagestats.h"
+
+#include <stdio.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace tesseract {
+
+static const char* const kStageNames[PS_COUNT] = {
+  "threshold",
+  "segment_page",
+  "textord",
+  "pass1",
+  "pass2",
+  "chop_word",
+  "best_first_search",
+  "beam_search",
+  "class_pruner",
+  "integer_matcher",
+  "dawg_permute",
+};
+
+static const char* const kCounterNames[PC_COUNT] = {
+  "classifier_calls",
+  "chop_attempts",
+  "seg_states",
+  "arena_allocs",
+  "heap_allocs",
+};
+
+PageStats::PageStats() : enabled_(false) {
+  Reset();
+}
+
+void PageStats::Reset() {
+  for (int s = 0; s < PS_COUNT; ++s) {
+    stage_usecs_[s] = 0;
+    stage_calls_[s] = 0;
+  }
+  for (int c = 0; c < PC_COUNT; ++c)
+    counters_[c] = 0;
+}
+
+// static
+const char* PageStats::StageName(PageStage stage) {
+  return kStageNames[stage];
+}
+
+// static
+const char* PageStats::CounterName(PageCounter counter) {
+  return kCounterNames[counter];
+}
+
+void PageStats::ToJSON(STRING* json) const {
+  char buf[128];
+  *json += "{";
+  for (int s = 0; s < PS_COUNT; ++s) {
+    sprintf(buf, "\"%s\":{\"usecs\":" INT64FORMAT ",\"calls\":" INT32FORMAT
+            "},", kStageNames[s], stage_usecs_[s], stage_calls_[s]);
+    *json += buf;
+  }
+  for (int c = 0; c < PC_COUNT; ++c) {
+    sprintf(buf, "\"%s\":" INT32FORMAT "%s", kCounterNames[c], counters_[c],
+            c + 1 < PC_COUNT ? "," : "}");
+    *json += buf;
+  }
+}
+
+// static
+inT64 PageStats::NowMicros() {
+#ifdef WIN32
+  LARGE_INTEGER frequency, count;
+  if (!QueryPerformanceFrequency(&frequency) ||
+      !QueryPerformanceCounter(&count))
+    return 0;
+  return count.QuadPart / frequency.QuadPart * 1000000 +
+         count.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart;
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return static_cast<inT64>(tv.tv_sec) * 1000000 + tv.tv_usec;
+#endif
+}
+
+}  // namespace tesseract
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.h
+// Description: Per-page timing and counters of the recognition stages.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PAGESTATS_H__
+#define TESSERACT_CCUTIL_PAGESTATS_H__
+
+#include "host.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+// The timed stages of the recognition of a page. Stages nest, so the time
+// of a stage includes the time of the stages it calls: pass 1 includes the
+// ClassPruner calls of its words, for example.
+enum PageStage {
+  PS_THRESHOLD,       // Thresholding of the whole image.
+  PS_SEGMENT_PAGE,    // Tesseract::SegmentPage, including textord, or
+                      // SegmentPageStreamed, including thresholding.
+  PS_TEXTORD,         // Finding rows and words of the blocks.
+  PS_PASS1,           // classify_word_pass1, per word.
+  PS_PASS2,           // classify_word_pass2, per word.
+  PS_CHOP_WORD,       // Wordrec::chop_word_main.
+  PS_BEST_FIRST,      // Wordrec::best_first_search.
+  PS_BEAM_SEARCH,     // Wordrec::beam_search.
+  PS_CLASS_PRUNER,    // Classify::ClassPruner.
+  PS_INT_MATCHER,     // IntegerMatcher::Match.
+  PS_DAWG_PERMUTE,    // Dict::dawg_permute_and_select.
+  PS_COUNT
+};
+
+// Events counted on a page, with no time attached.
+enum PageCounter {
+  PC_CLASSIFIER_CALLS,  // Calls of the adaptive classifier on a blob.
+  PC_CHOP_ATTEMPTS,     // Calls of attempt_blob_chop.
+  PC_SEG_STATES,        // Segmentation states evaluated by the search.
+  PC_ARENA_ALLOCS,      // Word structures allocated from the WordArena.
+  PC_HEAP_ALLOCS,       // Word structures allocated from the heap while
+                        // recognizing a word.
+  PC_COUNT
+};
+
+// PageStats accumulates the wall time and number of calls of each
+// PageStage, and the PageCounters, of one Tesseract instance. It is
+// disabled by default, in which case the only cost of a PageStageTimer
+// or Count is a test of enabled().
+class PageStats {
+ public:
+  PageStats();
+
+  bool enabled() const {
+    return enabled_;
+  }
+  void set_enabled(bool enabled) {
+    enabled_ = enabled;
+  }
+  // Zeroes all times and counts.
+  void Reset();
+
+  // Adds a call of stage that took usecs microseconds.
+  void AddStage(PageStage stage, inT64 usecs) {
+    stage_usecs_[stage] += usecs;
+    ++stage_calls_[stage];
+  }
+  void Count(PageCounter counter) {
+    if (enabled_)
+      ++counters_[counter];
+  }
+  void Count(PageCounter counter, inT32 n) {
+    if (enabled_)
+      counters_[counter] += n;
+  }
+
+  inT64 stage_usecs(PageStage stage) const {
+    return stage_usecs_[stage];
+  }
+  inT32 stage_calls(PageStage stage) const {
+    return stage_calls_[stage];
+  }
+  inT32 counter(PageCounter counter) const {
+    return counters_[counter];
+  }
+
+  // Names used for the stages and counters in ToJSON, such as "pass1".
+  static const char* StageName(PageStage stage);
+  static const char* CounterName(PageCounter counter);
+
+  // Appends the stats to json as a single JSON object, with an object of
+  // "usecs" and "calls" for each stage, and a number for each counter.
+  void ToJSON(STRING* json) const;
+
+  // Returns the current wall time in microseconds, from an arbitrary
+  // origin.
+  static inT64 NowMicros();
+
+ private:
+  bool enabled_;
+  inT64 stage_usecs_[PS_COUNT];
+  inT32 stage_calls_[PS_COUNT];
+  inT32 counters_[PC_COUNT];
+};
+
+// Adds the wall time of its own scope to a stage of a PageStats, if the
+// stats are not NULL and enabled when it is constructed.
+class PageStageTimer {
+ public:
+  PageStageTimer(PageStats* stats, PageStage stage)
+    : stats_(stats != NULL && stats->enabled() ? stats : NULL),
+      stage_(stage), start_(0) {
+    if (stats_ != NULL)
+      start_ = PageStats::NowMicros();
+  }
+  ~PageStageTimer() {
+    if (stats_ != NULL)
+      stats_->AddStage(stage_, PageStats::NowMicros() - start_);
+  }
+
+ private:
+  PageStats* stats_;
+  PageStage stage_;
+  inT64 start_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_PAGESTATS_H__
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.cpp
+// Description: Runtime detection of the SIMD extensions of the CPU.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "simddetect.h"
+
+#include <stddef.h>
+
+#if defined(TESS_SIMD_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// Bits of the cpuid results.
+const unsigned int kCpuid1EdxSSE2 = 1 << 26;
+const unsigned int kCpuid1EcxOSXSAVE = 1 << 27;
+const unsigned int kCpuid1EcxAVX = 1 << 28;
+const unsigned int kCpuid7EbxAVX2 = 1 << 5;
+// Bits of XCR0 that say the OS saves the XMM and YMM registers.
+const unsigned int kXcr0XmmYmm = 0x6;
+
+SIMDDetect SIMDDetect::detector_;
+bool SIMDDetect::sse2_available_ = false;
+bool SIMDDetect::avx2_available_ = false;
+
+#if defined(TESS_SIMD_X86)
+// Runs cpuid for the given leaf and subleaf. Returns false if the leaf is
+// not supported.
+static bool RunCpuid(unsigned int leaf, unsigned int subleaf,
+                     unsigned int regs[4]) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (static_cast<unsigned int>(info[0]) < leaf)
+    return false;
+  __cpuidex(info, leaf, subleaf);
+  for (int i = 0; i < 4; ++i)
+    regs[i] = info[i];
+  return true;
+#else
+  if (__get_cpuid_max(0, NULL) < leaf)
+    return false;
+  __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+  return true;
+#endif
+}
+
+// Returns the low word of XCR0, which may only be read if OSXSAVE is set.
+static unsigned int ReadXcr0() {
+#if defined(_MSC_VER)
+#if _MSC_VER >= 1600
+  return static_cast<unsigned int>(_xgetbv(0));
+#else
+  return 0;
+#endif
+#else
+  unsigned int eax, edx;
+  __asm__ __volatile__(".byte 0x0f, 0x01, 0xd0"  // xgetbv
+                       : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#endif
+}
+#endif  // TESS_SIMD_X86
+
+SIMDDetect::SIMDDetect() {
+#if defined(TESS_SIMD_X86)
+  unsigned int regs[4];  // eax, ebx, ecx, edx
+  if (!RunCpuid(1, 0, regs))
+    return;
+  sse2_available_ = (regs[3] & kCpuid1EdxSSE2) != 0;
+  bool os_avx = (regs[2] & kCpuid1EcxOSXSAVE) != 0 &&
+                (regs[2] & kCpuid1EcxAVX) != 0 &&
+                (ReadXcr0() & kXcr0XmmYmm) == kXcr0XmmYmm;
+  if (os_avx && RunCpuid(7, 0, regs))
+    avx2_available_ = (regs[1] & kCpuid7EbxAVX2) != 0;
+#endif
+}
@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.h
+// Description: Runtime detection of the SIMD extensions of the CPU.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_SIMDDETECT_H__
+#define TESSERACT_CCUTIL_SIMDDETECT_H__
+
+// Compilers that can build x86 SIMD code into a single function, without
+// compiling the whole file for the extension, define TESS_SIMD_X86. SSE2
+// and AVX2 kernels are only compiled if TESS_SIMD_SSE2 or TESS_SIMD_AVX2
+// is defined, and only run if SIMDDetect reports the CPU supports them.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || \
+     (defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define TESS_SIMD_X86
+#define TESS_SIMD_SSE2
+#define TESS_SIMD_AVX2
+#define TESS_TARGET_SSE2 __attribute__((target("sse2")))
+#define TESS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define TESS_SIMD_X86
+#define TESS_SIMD_SSE2
+#if _MSC_VER >= 1800
+#define TESS_SIMD_AVX2
+#endif
+#define TESS_TARGET_SSE2
+#define TESS_TARGET_AVX2
+#endif
+
+// SIMDDetect finds out once, at startup, which SIMD extensions the CPU and
+// the operating system support.
+class SIMDDetect {
+ public:
+  static bool IsSSE2Available() {
+    return sse2_available_;
+  }
+  static bool IsAVX2Available() {
+    return avx2_available_;
+  }
+
+ private:
+  SIMDDetect();
+
+  static SIMDDetect detector_;
+  static bool sse2_available_;
+  static bool avx2_available_;
+};
+
+#endif  // TESSERACT_CCUTIL_SIMDDETECT_H__
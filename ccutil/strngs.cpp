@@ -21,23 +21,6 @@
 #include          "tprintf.h"
 #include          "strngs.h"
 
-/**********************************************************************
- * DataCache for reducing initial allocations, such as the default
- * constructor. The memory in this cache is not special, it is just
- * held locally rather than freeing. Only blocks with the default
- * capacity are considered for the cache.
- *
- * In practice it does not appear that this cache grows very big,
- * so even 2-4 elements are probably sufficient to realize most
- * gains.
- *
- * The cache is maintained globally with a global destructor to
- * avoid memory leaks being reported on exit.
- **********************************************************************/
-// kDataCacheSize is cache of last n min sized buffers freed for
-// cheap recyling
-const int kDataCacheSize = 8;  // max number of buffers cached
-
 #if 1
 #define CHECK_INVARIANT(s)  // EMPTY
 #else
@@ -56,47 +39,6 @@ static void check_used_(int len, const char *s) {
 #define CHECK_INVARIANT(s)  check_used_(s->GetHeader()->used_, s->string())
 #endif
 
-// put recycled buffers into a class so we can destroy it on exit
-class DataCache {
- public:
-  DataCache() {
-    top_ = 0;
-  }
-  ~DataCache() {
-    while (--top_ >= 0)
-        free_string((char *)stack_[top_]);
-  }
-
-  // Allocate a buffer out of this cache.
-  // Returs NULL if there are no cached buffers.
-  // The buffers in the cache can be freed using string_free.
-  void* alloc() {
-    if (top_ == 0)
-      return NULL;
-
-    return stack_[--top_];
-  }
-
-  // Free pointer either by caching it on the stack of pointers
-  // or freeing it with string_free if there isnt space left to cache it.
-  // s should have capacity kMinCapacity.
-  void free(void* p) {
-    if (top_ == kDataCacheSize)
-      free_string((char *)p);
-    else
-      stack_[top_++] = p;
-  }
-
-  // Stack of discarded but not-yet freed pointers.
-  void* stack_[kDataCacheSize];
-
-  // Top of stack, points to element after last cached pointer
-  int   top_;
-};
-
-static DataCache MinCapacityDataCache;
-
-
 /**********************************************************************
  * STRING_HEADER provides metadata about the allocated buffer,
  * including total capacity and how much used (strlen with '\0').
@@ -114,9 +56,7 @@ static DataCache MinCapacityDataCache;
 const int kMinCapacity = 16;
 
 char* STRING::AllocData(int used, int capacity) {
-  if ((capacity != kMinCapacity)
-      || ((data_ = (STRING_HEADER *)MinCapacityDataCache.alloc()) == NULL))
-    data_ = (STRING_HEADER *)alloc_string(capacity + sizeof(STRING_HEADER));
+  data_ = (STRING_HEADER *)alloc_string(capacity + sizeof(STRING_HEADER));
 
   // header is the metadata for this memory block
   STRING_HEADER* header = GetHeader();
@@ -126,11 +66,7 @@ char* STRING::AllocData(int used, int capacity) {
 }
 
 void STRING::DiscardData() {
-  STRING_HEADER* header = GetHeader();
-  if (header->capacity_ == kMinCapacity)
-    MinCapacityDataCache.free(data_);
-  else
-    free_string((char *)data_);
+  free_string((char *)data_);
 }
 
 // This is a private method; ensure FixHeader is called (or used_ is well defined)
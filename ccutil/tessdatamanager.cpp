@@ -17,9 +17,17 @@
 //
 ///////////////////////////////////////////////////////////////////////
 
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
 #include "tessdatamanager.h"
 
 #include <stdio.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #include "serialis.h"
 #include "strngs.h"
@@ -31,11 +39,23 @@ BOOL_VAR(global_load_freq_dawg, true, "Load frequent word dawg.");
 BOOL_VAR(global_load_punc_dawg, true, "Load dawg with punctuation patterns.");
 BOOL_VAR(global_load_number_dawg, true, "Load dawg with number patterns.");
 
+BOOL_VAR(global_load_mmap_tessdata, false,
+         "Memory-map the traineddata file and use the dawgs and"
+         " class pruners in place.");
+
 INT_VAR(global_tessdata_manager_debug_level, 0,
         "Debug level for TessdataManager functions.");
 
 namespace tesseract {
 
+TessdataManager::~TessdataManager() {
+  End();
+#ifdef HAVE_MMAP
+  for (int i = 0; i < mappings_.size(); ++i)
+    munmap(mappings_[i], mapping_sizes_[i]);
+#endif
+}
+
 void TessdataManager::Init(const char *data_file_name) {
   int i;
   data_file_ = fopen(data_file_name, "rb");
@@ -43,6 +63,24 @@ void TessdataManager::Init(const char *data_file_name) {
     tprintf("Error openning data file %s\n", data_file_name);
     exit(1);
   }
+  mapped_data_ = NULL;
+  mapped_size_ = 0;
+#ifdef HAVE_MMAP
+  if (global_load_mmap_tessdata && fseek(data_file_, 0, SEEK_END) == 0) {
+    inT64 size = ftell(data_file_);
+    void *data = size > 0 ? mmap(NULL, size, PROT_READ, MAP_SHARED,
+                                 fileno(data_file_), 0) : MAP_FAILED;
+    if (data != MAP_FAILED) {
+      mapped_data_ = static_cast<char *>(data);
+      mapped_size_ = size;
+      mappings_.push_back(mapped_data_);
+      mapping_sizes_.push_back(mapped_size_);
+    } else if (global_tessdata_manager_debug_level) {
+      tprintf("TessdataManager: could not map %s\n", data_file_name);
+    }
+    rewind(data_file_);
+  }
+#endif
   fread(&actual_tessdata_num_entries_, sizeof(inT32), 1, data_file_);
   bool swap = (actual_tessdata_num_entries_ > kMaxNumTessdataEntries);
   if (swap) {
@@ -65,6 +103,15 @@ void TessdataManager::Init(const char *data_file_name) {
   }
 }
 
+const char *TessdataManager::GetMappedData(int alignment, inT64 size) const {
+  if (mapped_data_ == NULL || data_file_ == NULL)
+    return NULL;
+  inT64 offset = ftell(data_file_);
+  if (offset < 0 || offset % alignment != 0 || offset + size > mapped_size_)
+    return NULL;
+  return mapped_data_ + offset;
+}
+
 FILE *TessdataManager::GetFilePtr(const char *language_data_path_prefix,
                                   const char *file_suffix, bool required_file,
                                   bool text_file) {
@@ -93,6 +140,12 @@ void TessdataManager::CopyFile(FILE *input_file, FILE *output_file,
   delete[] chunk;
 }
 
+void TessdataManager::PadToAlignment(FILE *output_file, int alignment,
+                                     int header_size) {
+  while ((ftell(output_file) + header_size) % alignment != 0)
+    fputc('\n', output_file);
+}
+
 void TessdataManager::CombineDataFiles(
     const char *language_data_path_prefix,
     const char *output_filename) {
@@ -136,6 +189,7 @@ void TessdataManager::CombineDataFiles(
     GetFilePtr(language_data_path_prefix,
                kBuiltInTemplatesFileSuffix, false, false);
   if (file_ptr != NULL) {
+    PadToAlignment(output_file, kInttempAlignment, 0);
     offset_table[TESSDATA_INTTEMP] = ftell(output_file);
     CopyFile(file_ptr, output_file, false);
     fclose(file_ptr);
@@ -159,6 +213,7 @@ void TessdataManager::CombineDataFiles(
   file_ptr = GetFilePtr(language_data_path_prefix,
                         kPuncDawgFileSuffix, false, false);
   if (file_ptr != NULL) {
+    PadToAlignment(output_file, kDawgEdgeAlignment, kDawgHeaderSize);
     offset_table[TESSDATA_PUNC_DAWG] = ftell(output_file);
     CopyFile(file_ptr, output_file, false);
     fclose(file_ptr);
@@ -167,6 +222,7 @@ void TessdataManager::CombineDataFiles(
   file_ptr = GetFilePtr(language_data_path_prefix,
                         kSystemDawgFileSuffix, false, false);
   if (file_ptr != NULL) {
+    PadToAlignment(output_file, kDawgEdgeAlignment, kDawgHeaderSize);
     offset_table[TESSDATA_SYSTEM_DAWG] = ftell(output_file);
     CopyFile(file_ptr, output_file, false);
     fclose(file_ptr);
@@ -175,6 +231,7 @@ void TessdataManager::CombineDataFiles(
   file_ptr = GetFilePtr(language_data_path_prefix,
                         kNumberDawgFileSuffix, false, false);
   if (file_ptr != NULL) {
+    PadToAlignment(output_file, kDawgEdgeAlignment, kDawgHeaderSize);
     offset_table[TESSDATA_NUMBER_DAWG] = ftell(output_file);
     CopyFile(file_ptr, output_file, false);
     fclose(file_ptr);
@@ -183,11 +240,22 @@ void TessdataManager::CombineDataFiles(
   file_ptr = GetFilePtr(language_data_path_prefix,
                         kFreqDawgFileSuffix, false, false);
   if (file_ptr != NULL) {
+    PadToAlignment(output_file, kDawgEdgeAlignment, kDawgHeaderSize);
     offset_table[TESSDATA_FREQ_DAWG] = ftell(output_file);
     CopyFile(file_ptr, output_file, false);
     fclose(file_ptr);
   }
 
+  // Record the n-gram model.
+  file_ptr = GetFilePtr(language_data_path_prefix,
+                        kNgramModelFileSuffix, false, false);
+  if (file_ptr != NULL) {
+    PadToAlignment(output_file, kNgramModelAlignment, 0);
+    offset_table[TESSDATA_NGRAM_MODEL] = ftell(output_file);
+    CopyFile(file_ptr, output_file, false);
+    fclose(file_ptr);
+  }
+
   fseek(output_file, 0, SEEK_SET);
   inT32 num_entries = TESSDATA_NUM_ENTRIES;
   fwrite(&num_entries, sizeof(inT32), 1, output_file);
@@ -21,6 +21,7 @@
 #define TESSERACT_CCUTIL_TESSDATAMANAGER_H_
 
 #include <stdio.h>
+#include "genericvector.h"
 #include "host.h"
 #include "tprintf.h"
 #include "varable.h"
@@ -32,6 +33,10 @@ extern BOOL_VAR_H(global_load_number_dawg, true,
                   "Load dawg with number patterns.");
 extern BOOL_VAR_H(global_load_freq_dawg, true, "Load frequent word dawg.");
 
+extern BOOL_VAR_H(global_load_mmap_tessdata, false,
+                  "Memory-map the traineddata file and use the dawgs and"
+                  " class pruners in place.");
+
 extern INT_VAR_H(global_tessdata_manager_debug_level, 0,
                  "Debug level for TessdataManager functions.");
 
@@ -47,6 +52,7 @@ static const char kPuncDawgFileSuffix[] = "punc-dawg";
 static const char kSystemDawgFileSuffix[] = "word-dawg";
 static const char kNumberDawgFileSuffix[] = "number-dawg";
 static const char kFreqDawgFileSuffix[] = "freq-dawg";
+static const char kNgramModelFileSuffix[] = "ngram";
 
 namespace tesseract {
 
@@ -61,6 +67,7 @@ enum TessdataType {
   TESSDATA_SYSTEM_DAWG,  // 7
   TESSDATA_NUMBER_DAWG,  // 8
   TESSDATA_FREQ_DAWG,    // 9
+  TESSDATA_NGRAM_MODEL,  // 10
 
   TESSDATA_NUM_ENTRIES
 };
@@ -72,24 +79,51 @@ enum TessdataType {
 // kMaxNumTessdataEntries.
 static const int kMaxNumTessdataEntries = 1000;
 
+// CombineDataFiles pads the combined file so that the data that can be used
+// in place from a memory mapping is suitably aligned: the class pruners
+// (kInttempAlignment), the dawg edge arrays (kDawgEdgeAlignment) and the
+// tables of the n-gram model (kNgramModelAlignment), whose header is a
+// multiple of kNgramModelAlignment.
+// The inttemp header is a multiple of kInttempAlignment and the edges of a
+// squished dawg start kDawgHeaderSize bytes after the start of the dawg, or
+// a multiple of kDawgEdgeAlignment bytes more (the node-indexed format pads
+// its node offset table to keep this), so the dawg sections start
+// kDawgHeaderSize bytes before an aligned offset.
+static const int kInttempAlignment = 16;
+static const int kDawgEdgeAlignment = 8;
+static const int kDawgHeaderSize = 10;
+static const int kNgramModelAlignment = 4;
+
 
 class TessdataManager {
  public:
   TessdataManager() {
     data_file_ = NULL;
+    mapped_data_ = NULL;
+    mapped_size_ = 0;
     actual_tessdata_num_entries_ = 0;
     for (int i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
       offset_table_[i] = -1;
     }
   }
-  ~TessdataManager() {}
+  ~TessdataManager();
 
   // Opens the given data file and reads the offset table.
+  // If global_load_mmap_tessdata is true and mmap is available, the file is
+  // also mapped into memory (see GetMappedData).
   void Init(const char *data_file_name);
 
   // Returns data file pointer.
   inline FILE *GetDataFilePtr() const { return data_file_; }
 
+  // Returns a pointer to the bytes at the current position of the data file
+  // in the memory mapping, or NULL if the file is not mapped, or if the
+  // position is not a multiple of alignment, or if there are fewer than
+  // size bytes left. Readers that use the pointer instead of reading must
+  // still skip the data in the file. The mapping is read-only and stays
+  // valid until the TessdataManager is destroyed, even after End().
+  const char *GetMappedData(int alignment, inT64 size) const;
+
   // Returns false if there is no data of the given type.
   // Otherwise does a seek on the data_file_ to position the pointer
   // at the start of the data of the given type.
@@ -121,11 +155,14 @@ class TessdataManager {
     return (index == actual_tessdata_num_entries_) ? -1 : offset_table_[index] - 1;
   }
   // Closes data_file_ (if it was opened by Init()).
+  // Any mapping of the file is kept for the data that points into it.
   inline void End() {
     if (data_file_ != NULL) {
       fclose(data_file_);
       data_file_ = NULL;
     }
+    mapped_data_ = NULL;
+    mapped_size_ = 0;
   }
 
   // Reads all the standard tesseract config and data files for a language
@@ -146,6 +183,12 @@ class TessdataManager {
   // Copies all the bytes in the given input file to the output_file provided.
   static void CopyFile(FILE *input_file, FILE *output_file, bool newline_end);
 
+  // Writes newlines to output_file until its position plus header_size is a
+  // multiple of alignment. The padding ends up at the end of the previous
+  // section, where both the text and the binary readers ignore it.
+  static void PadToAlignment(FILE *output_file, int alignment,
+                             int header_size);
+
   // Each offset_table_[i] contains a file offset in the combined data file
   // where the data of TessdataFileType i is stored.
   inT64 offset_table_[TESSDATA_NUM_ENTRIES];
@@ -157,6 +200,13 @@ class TessdataManager {
   // when new tessdata types are introduced.
   inT32 actual_tessdata_num_entries_;
   FILE *data_file_;  // pointer to the data file.
+  // Mapping of the current data file, or NULL.
+  char *mapped_data_;
+  inT64 mapped_size_;
+  // Every mapping made by Init, kept until destruction because the data
+  // loaded from each of them may still be in use.
+  GenericVector<char *> mappings_;
+  GenericVector<inT64> mapping_sizes_;
 };
 
 
@@ -309,6 +309,32 @@ bool UNICHARSET::load_from_file(FILE *file) {
   return true;
 }
 
+void UNICHARSET::CopyFrom(const UNICHARSET &src) {
+  this->clear();
+  this->reserve(src.size_used);
+  for (UNICHAR_ID id = 0; id < src.size_used; ++id) {
+    const UNICHAR_PROPERTIES &properties = src.unichars[id].properties;
+    this->unichar_insert(src.unichars[id].representation);
+    this->set_isalpha(id, properties.isalpha);
+    this->set_islower(id, properties.islower);
+    this->set_isupper(id, properties.isupper);
+    this->set_isdigit(id, properties.isdigit);
+    this->set_ispunctuation(id, properties.ispunctuation);
+    this->set_isngram(id, properties.isngram);
+    this->set_script(id, src.get_script_from_script_id(properties.script_id));
+    this->unichars[id].properties.other_case = properties.other_case;
+    this->unichars[id].properties.enabled = true;
+  }
+
+  null_sid_ = get_script_id_from_name(null_script);
+  ASSERT_HOST(null_sid_ == 0);
+  common_sid_ = get_script_id_from_name("Common");
+  latin_sid_ = get_script_id_from_name("Latin");
+  cyrillic_sid_ = get_script_id_from_name("Cyrillic");
+  greek_sid_ = get_script_id_from_name("Greek");
+  han_sid_ = get_script_id_from_name("Han");
+}
+
 // Set a whitelist and/or blacklist of characters to recognize.
 // An empty or NULL whitelist enables everything (minus any blacklist).
 // An empty or NULL blacklist disables nothing.
@@ -238,6 +238,10 @@ class UNICHARSET {
   // Returns true if the operation is successful.
   bool load_from_file(FILE *file);
 
+  // Makes this a copy of src, with the same ids and properties, as if it
+  // had been loaded from the same file. The previous data is lost.
+  void CopyFrom(const UNICHARSET &src);
+
   // Set a whitelist and/or blacklist of characters to recognize.
   // An empty or NULL whitelist enables everything (minus any blacklist).
   // An empty or NULL blacklist disables nothing.
@@ -277,6 +281,11 @@ class UNICHARSET {
     unichars[unichar_id].properties.isngram = value;
   }
 
+  // Set the enabled property of the given unichar to the given value.
+  void set_enabled(UNICHAR_ID unichar_id, bool value) {
+    unichars[unichar_id].properties.enabled = value;
+  }
+
   // Set the script name of the given unichar to the given value.
   // Value is copied and thus can be a temporary;
   void set_script(UNICHAR_ID unichar_id, const char* value) {
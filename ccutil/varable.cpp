@@ -341,6 +341,7 @@ value(v) {
 
   name = vname;                  // strings must be static
   info = comment;
+  set_c_string();
   it.add_before_stay_put(this);  // add it to stack
 }
 
@@ -588,30 +589,30 @@ bool set_variable(const char *variable, const char* value) {
   double_VARIABLE_C_IT double_it = &double_VARIABLE::head;
 
   bool foundit = false;
-  // find name
-  for (STRING_it.mark_cycle_pt();
-       !STRING_it.cycled_list() && strcmp(variable, STRING_it.data()->name);
-       STRING_it.forward());
-  if (!STRING_it.cycled_list()) {
-    foundit = true;          // found the varaible
+  // Member variables of several instances share a name, so every variable
+  // of that name is set.
+  for (STRING_it.mark_cycle_pt(); !STRING_it.cycled_list();
+       STRING_it.forward()) {
+    if (!strcmp(variable, STRING_it.data()->name)) {
+      foundit = true;          // found the varaible
       STRING_it.data()->set_value(value);  // set its value
+    }
   }
 
   if (*value) {
-    // find name
-    for (int_it.mark_cycle_pt();
-         !int_it.cycled_list() && strcmp(variable, int_it.data()->name);
-         int_it.forward());
     int intval;
-    if (!int_it.cycled_list()
-    && sscanf(value, INT32FORMAT, &intval) == 1) {
-      foundit = true;        // found the varaible
-      int_it.data()->set_value(intval);  // set its value.
+    if (sscanf(value, INT32FORMAT, &intval) == 1) {
+      for (int_it.mark_cycle_pt(); !int_it.cycled_list(); int_it.forward()) {
+        if (!strcmp(variable, int_it.data()->name)) {
+          foundit = true;      // found the varaible
+          int_it.data()->set_value(intval);  // set its value.
+        }
+      }
     }
-    for (BOOL_it.mark_cycle_pt();
-         !BOOL_it.cycled_list () && strcmp(variable, BOOL_it.data()->name);
-         BOOL_it.forward());
-    if (!BOOL_it.cycled_list()) {
+    for (BOOL_it.mark_cycle_pt(); !BOOL_it.cycled_list();
+         BOOL_it.forward()) {
+      if (strcmp(variable, BOOL_it.data()->name))
+        continue;
       if (*value == 'T' || *value == 't' ||
           *value == 'Y' || *value == 'y' || *value == '1') {
         foundit = true;
@@ -623,19 +624,20 @@ bool set_variable(const char *variable, const char* value) {
         BOOL_it.data()->set_value(FALSE);
       }
     }
-    for (double_it.mark_cycle_pt();
-         !double_it.cycled_list() && strcmp(variable, double_it.data ()->name);
-         double_it.forward());
     double doubleval;
 #ifdef EMBEDDED
-    if (!double_it.cycled_list ()) {
-      doubleval = strtofloat(value);
+    doubleval = strtofloat(value);
+    {
 #else
-    if (!double_it.cycled_list()
-        && sscanf(value, "%lf", &doubleval) == 1) {
+    if (sscanf(value, "%lf", &doubleval) == 1) {
 #endif
-      foundit = true;        // found the varaible
-      double_it.data()->set_value(doubleval);
+      for (double_it.mark_cycle_pt(); !double_it.cycled_list();
+           double_it.forward()) {
+        if (!strcmp(variable, double_it.data()->name)) {
+          foundit = true;      // found the varaible
+          double_it.data()->set_value(doubleval);
+        }
+      }
     }
   }
   return foundit;
@@ -35,7 +35,7 @@ extern DLLSYM BOOL8 read_variables_file(
 // Read variables from the given file pointer (stop at end_offset).
 bool read_variables_from_fp(FILE *fp, inT64 end_offset, bool global_only);
 
-// Set a variable to have the given value.
+// Set every variable of the given name to have the given value.
 bool set_variable(const char *variable, const char* value);
 
 // Print variables to a file.
@@ -217,6 +217,7 @@ class DLLSYM STRING_VARIABLE
     STRING_VARIABLE() {  //for elist only
       name = "NONAME";
       info = "Uninitialized";
+      c_string = NULL;
     }
     ~STRING_VARIABLE ();         //for elist only
 
@@ -228,10 +229,11 @@ class DLLSYM STRING_VARIABLE
     void set_value(             //assign to value
                    STRING v) {  //value to set
       value = v;
+      set_c_string();
     }
 
     const char *string() const {  //get string
-      return value.string ();
+      return c_string;
     }
 
     const char *name_str() {  //access name
@@ -249,7 +251,16 @@ class DLLSYM STRING_VARIABLE
                       FILE *fp);  //file to print on
 
   private:
+    // Keeps the chars of value in c_string, with the length of value
+    // known, so that recognition threads reading the variable at the
+    // same time, through string() or copies of value, never write it.
+    void set_c_string() {
+      c_string = value.string();
+      value.length();
+    }
+
     STRING value;                //the variable
+    const char *c_string;        //chars of value
     const char *name;            //name of variable
     const char *info;            //for menus
     static STRING_VAR_FROM copy; //pre constructor
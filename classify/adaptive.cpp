@@ -29,6 +29,7 @@
 #include <assert.h>
 #endif
 #include <stdio.h>
+#include <string.h>
 
 /**----------------------------------------------------------------------------
               Public Code
@@ -547,3 +548,401 @@ void WriteTempConfig(FILE *File, TEMP_CONFIG Config) {
     Config->ProtoVectorSize, File);
 
 }                                /* WriteTempConfig */
+
+
+/*---------------------------------------------------------------------------*/
+/* The adaptive classifier snapshot is a compact in-memory copy of a set of
+   adapted templates, in the byte order of the machine that wrote it.  Only
+   the classes that have been adapted to are stored, and the class pruners,
+   which are mostly empty, are stored as a list of their nonzero words. */
+typedef struct
+{
+  char *Data;                    /* NULL to only count the bytes */
+  int Length;
+}
+
+
+SNAPSHOT_WRITER;
+
+typedef struct
+{
+  const char *Data;
+  int Length;
+  int Position;
+}
+
+
+SNAPSHOT_READER;
+
+/* words in a class pruner, as an int like the indices compared with it */
+static const int kWordsPerCP = WERDS_PER_CP;
+
+/*---------------------------------------------------------------------------*/
+static void PutBytes(SNAPSHOT_WRITER *Writer, const void *Bytes, int Size) {
+  if (Writer->Data != NULL)
+    memcpy (Writer->Data + Writer->Length, Bytes, Size);
+  Writer->Length += Size;
+}
+
+/*---------------------------------------------------------------------------*/
+static void PutInt(SNAPSHOT_WRITER *Writer, inT32 Value) {
+  PutBytes(Writer, &Value, sizeof (Value));
+}
+
+/*---------------------------------------------------------------------------*/
+static BOOL8 GetBytes(SNAPSHOT_READER *Reader, void *Bytes, int Size) {
+  if (Size < 0 || Size > Reader->Length - Reader->Position)
+    return FALSE;
+  memcpy (Bytes, Reader->Data + Reader->Position, Size);
+  Reader->Position += Size;
+  return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+static BOOL8 GetInt(SNAPSHOT_READER *Reader, inT32 *Value) {
+  return GetBytes(Reader, Value, sizeof (*Value));
+}
+
+/*---------------------------------------------------------------------------*/
+static BOOL8 IsSnapshotClass(ADAPT_TEMPLATES Templates, int ClassId) {
+  return !IsEmptyAdaptedClass (Templates->Class[ClassId]) ||
+    Templates->Templates->Class[ClassId]->NumConfigs > 0;
+}
+
+/*---------------------------------------------------------------------------*/
+static inT32 UnicharsetHash(const UNICHARSET &Unicharset) {
+/*
+ **	Parameters:
+ **		Unicharset	unicharset the templates are indexed by
+ **	Globals: none
+ **	Operation: Hashes the unichars of Unicharset in the order of their
+ **		ids (FNV-1a), so that a snapshot is only read back by a
+ **		classifier with the same class ids.
+ **	Return: The hash.
+ **	Exceptions: none
+ */
+  uinT32 Hash = 2166136261U;
+  const char *Unichar;
+  int i;
+
+  for (i = 0; i < Unicharset.size(); i++) {
+    for (Unichar = Unicharset.id_to_unichar(i); ; Unichar++) {
+      Hash = (Hash ^ static_cast<uinT8>(*Unichar)) * 16777619U;
+      if (*Unichar == '\0')
+        break;
+    }
+  }
+  return static_cast<inT32>(Hash);
+}
+
+/*---------------------------------------------------------------------------*/
+static void PutSnapshot(SNAPSHOT_WRITER *Writer, ADAPT_TEMPLATES Templates,
+                        inT32 UnicharsetId) {
+/*
+ **	Parameters:
+ **		Writer		where to write the snapshot
+ **		Templates	adapted templates to write
+ **		UnicharsetId	hash of the unicharset of the templates
+ **	Globals: none
+ **	Operation: Writes the snapshot of Templates with Writer.
+ **	Return: none
+ **	Exceptions: none
+ */
+  INT_TEMPLATES IntTemplates = Templates->Templates;
+  INT_CLASS IntClass;
+  ADAPT_CLASS Class;
+  LIST TempProtos;
+  uinT32 *Words;
+  uinT8 NumAmbigs;
+  int NumClasses;
+  int NumWords;
+  int i, j;
+
+  PutInt(Writer, ADAPT_SNAPSHOT_MAGIC);
+  PutInt(Writer, ADAPT_SNAPSHOT_VERSION);
+  PutInt(Writer, IntTemplates->NumClasses);
+  PutInt(Writer, IntTemplates->NumClassPruners);
+  PutInt(Writer, Templates->NumNonEmptyClasses);
+  PutInt(Writer, Templates->NumPermClasses);
+  PutInt(Writer, UnicharsetId);
+
+  /* the nonzero words of the class pruners, with their index */
+  NumWords = 0;
+  for (i = 0; i < IntTemplates->NumClassPruners; i++) {
+    Words = reinterpret_cast<uinT32 *>(IntTemplates->ClassPruner[i]);
+    for (j = 0; j < kWordsPerCP; j++)
+      if (Words[j] != 0)
+        NumWords++;
+  }
+  PutInt(Writer, NumWords);
+  for (i = 0; i < IntTemplates->NumClassPruners; i++) {
+    Words = reinterpret_cast<uinT32 *>(IntTemplates->ClassPruner[i]);
+    for (j = 0; j < kWordsPerCP; j++) {
+      if (Words[j] != 0) {
+        PutInt(Writer, i * kWordsPerCP + j);
+        PutBytes(Writer, &Words[j], sizeof (uinT32));
+      }
+    }
+  }
+
+  NumClasses = 0;
+  for (i = 0; i < IntTemplates->NumClasses; i++)
+    if (IsSnapshotClass (Templates, i))
+      NumClasses++;
+  PutInt(Writer, NumClasses);
+  for (i = 0; i < IntTemplates->NumClasses; i++) {
+    if (!IsSnapshotClass (Templates, i))
+      continue;
+    IntClass = IntTemplates->Class[i];
+    Class = Templates->Class[i];
+    PutInt(Writer, i);
+
+    /* the integer class */
+    PutBytes(Writer, &IntClass->NumProtos, sizeof (IntClass->NumProtos));
+    PutBytes(Writer, &IntClass->NumProtoSets, sizeof (IntClass->NumProtoSets));
+    PutBytes(Writer, &IntClass->NumConfigs, sizeof (IntClass->NumConfigs));
+    PutBytes(Writer, IntClass->ConfigLengths,
+      IntClass->NumConfigs * sizeof (IntClass->ConfigLengths[0]));
+    PutBytes(Writer, IntClass->ProtoLengths,
+      MaxNumIntProtosIn (IntClass) * sizeof (uinT8));
+    for (j = 0; j < IntClass->NumProtoSets; j++)
+      PutBytes(Writer, IntClass->ProtoSets[j], sizeof (PROTO_SET_STRUCT));
+    PutInt(Writer, IntClass->font_set_id);
+
+    /* the adapted class */
+    PutBytes(Writer, &Class->NumPermConfigs, sizeof (Class->NumPermConfigs));
+    PutBytes(Writer, Class->PermProtos,
+      WordsInVectorOfSize (MAX_NUM_PROTOS) * sizeof (uinT32));
+    PutBytes(Writer, Class->PermConfigs,
+      WordsInVectorOfSize (MAX_NUM_CONFIGS) * sizeof (uinT32));
+    PutInt(Writer, count (Class->TempProtos));
+    TempProtos = Class->TempProtos;
+    iterate (TempProtos) {
+      PutBytes(Writer, first_node (TempProtos), sizeof (TEMP_PROTO_STRUCT));
+    }
+    for (j = 0; j < IntClass->NumConfigs; j++) {
+      if (ConfigIsPermanent (Class, j)) {
+        NumAmbigs = 0;
+        while (PermConfigFor (Class, j)[NumAmbigs] >= 0)
+          ++NumAmbigs;
+        PutBytes(Writer, &NumAmbigs, sizeof (NumAmbigs));
+        PutBytes(Writer, PermConfigFor (Class, j),
+          NumAmbigs * sizeof (UNICHAR_ID));
+      }
+      else {
+        assert (TempConfigFor (Class, j)->ContextsSeen == NULL);
+        PutBytes(Writer, &TempConfigFor (Class, j)->NumTimesSeen,
+          sizeof (uinT8));
+        PutBytes(Writer, &TempConfigFor (Class, j)->ProtoVectorSize,
+          sizeof (uinT8));
+        PutBytes(Writer, &TempConfigFor (Class, j)->MaxProtoId,
+          sizeof (PROTO_ID));
+        PutBytes(Writer, TempConfigFor (Class, j)->Protos,
+          TempConfigFor (Class, j)->ProtoVectorSize * sizeof (uinT32));
+      }
+    }
+  }
+}                                /* PutSnapshot */
+
+/*---------------------------------------------------------------------------*/
+static BOOL8 GetSnapshotClass(SNAPSHOT_READER *Reader,
+                              ADAPT_TEMPLATES Templates, int ClassId) {
+/*
+ **	Parameters:
+ **		Reader		snapshot to read the class from
+ **		Templates	empty adapted templates to put the class in
+ **		ClassId		id of the class
+ **	Globals: none
+ **	Operation: Reads the integer and adapted class ClassId from the
+ **		snapshot, and replaces the empty ones of Templates with them.
+ **		The new classes are installed before they are filled in, so
+ **		that freeing Templates after a failure frees them too.
+ **	Return: FALSE if the snapshot is malformed, else TRUE.
+ **	Exceptions: none
+ */
+  INT_CLASS IntClass;
+  ADAPT_CLASS Class;
+  TEMP_PROTO TempProto;
+  TEMP_CONFIG Config;
+  PERM_CONFIG Perm;
+  uinT16 NumProtos;
+  uinT8 NumProtoSets;
+  uinT8 NumConfigs;
+  uinT8 NumAmbigs;
+  uinT8 NumTimesSeen;
+  uinT8 ProtoVectorSize;
+  PROTO_ID MaxProtoId;
+  inT32 NumTempProtos;
+  int i;
+
+  if (!GetBytes(Reader, &NumProtos, sizeof (NumProtos)) ||
+      !GetBytes(Reader, &NumProtoSets, sizeof (NumProtoSets)) ||
+      !GetBytes(Reader, &NumConfigs, sizeof (NumConfigs)) ||
+      NumProtoSets > MAX_NUM_PROTO_SETS || NumConfigs > MAX_NUM_CONFIGS ||
+      NumProtos > NumProtoSets * PROTOS_PER_PROTO_SET)
+    return FALSE;
+
+  /* the integer class */
+  free_int_class (Templates->Templates->Class[ClassId]);
+  IntClass = NewIntClass (NumProtoSets * PROTOS_PER_PROTO_SET, NumConfigs);
+  Templates->Templates->Class[ClassId] = IntClass;
+  if (MaxNumIntProtosIn (IntClass) == 0)
+    IntClass->ProtoLengths = NULL;
+  IntClass->NumProtos = NumProtos;
+  IntClass->NumConfigs = NumConfigs;
+  if (!GetBytes(Reader, IntClass->ConfigLengths,
+                NumConfigs * sizeof (IntClass->ConfigLengths[0])) ||
+      !GetBytes(Reader, IntClass->ProtoLengths,
+                MaxNumIntProtosIn (IntClass) * sizeof (uinT8)))
+    return FALSE;
+  for (i = 0; i < NumProtoSets; i++)
+    if (!GetBytes(Reader, IntClass->ProtoSets[i], sizeof (PROTO_SET_STRUCT)))
+      return FALSE;
+  if (!GetInt(Reader, &IntClass->font_set_id))
+    return FALSE;
+
+  /* the adapted class */
+  free_adapted_class (Templates->Class[ClassId]);
+  Class = NewAdaptedClass ();
+  Templates->Class[ClassId] = Class;
+  if (!GetBytes(Reader, &Class->NumPermConfigs,
+                sizeof (Class->NumPermConfigs)) ||
+      !GetBytes(Reader, Class->PermProtos,
+                WordsInVectorOfSize (MAX_NUM_PROTOS) * sizeof (uinT32)) ||
+      !GetBytes(Reader, Class->PermConfigs,
+                WordsInVectorOfSize (MAX_NUM_CONFIGS) * sizeof (uinT32)) ||
+      !GetInt(Reader, &NumTempProtos) || NumTempProtos < 0)
+    return FALSE;
+  for (i = 0; i < NumTempProtos; i++) {
+    TempProto = NewTempProto ();
+    Class->TempProtos = push_last (Class->TempProtos, TempProto);
+    if (!GetBytes(Reader, TempProto, sizeof (TEMP_PROTO_STRUCT)))
+      return FALSE;
+  }
+  for (i = 0; i < NumConfigs; i++) {
+    if (ConfigIsPermanent (Class, i)) {
+      if (!GetBytes(Reader, &NumAmbigs, sizeof (NumAmbigs)))
+        return FALSE;
+      Perm = (PERM_CONFIG) Emalloc (sizeof (UNICHAR_ID) * (NumAmbigs + 1));
+      Perm[0] = -1;
+      PermConfigFor (Class, i) = Perm;
+      if (!GetBytes(Reader, Perm, NumAmbigs * sizeof (UNICHAR_ID)))
+        return FALSE;
+      Perm[NumAmbigs] = -1;
+    }
+    else {
+      if (!GetBytes(Reader, &NumTimesSeen, sizeof (NumTimesSeen)) ||
+          !GetBytes(Reader, &ProtoVectorSize, sizeof (ProtoVectorSize)) ||
+          !GetBytes(Reader, &MaxProtoId, sizeof (MaxProtoId)) ||
+          MaxProtoId < 0 || MaxProtoId >= MAX_NUM_PROTOS ||
+          ProtoVectorSize != WordsInVectorOfSize (MaxProtoId + 1))
+        return FALSE;
+      Config = NewTempConfig (MaxProtoId);
+      TempConfigFor (Class, i) = Config;
+      Config->NumTimesSeen = NumTimesSeen;
+      if (!GetBytes(Reader, Config->Protos,
+                    ProtoVectorSize * sizeof (uinT32)))
+        return FALSE;
+    }
+  }
+  return TRUE;
+}                                /* GetSnapshotClass */
+
+
+/*---------------------------------------------------------------------------*/
+namespace tesseract {
+char *Classify::WriteAdaptedSnapshot(ADAPT_TEMPLATES Templates, int *Length) {
+/*
+ **	Parameters:
+ **		Templates	adapted templates to write
+ **		Length		returns the number of bytes of the snapshot
+ **	Globals: none
+ **	Operation: Writes Templates into a single buffer in the compact
+ **		snapshot format, which is sized by a first pass that only
+ **		counts the bytes.
+ **	Return: The snapshot, to be freed with delete [].
+ **	Exceptions: none
+ */
+  SNAPSHOT_WRITER Writer;
+
+  Writer.Data = NULL;
+  Writer.Length = 0;
+  PutSnapshot(&Writer, Templates, UnicharsetHash(unicharset));
+  Writer.Data = new char[Writer.Length];
+  *Length = Writer.Length;
+  Writer.Length = 0;
+  PutSnapshot(&Writer, Templates, UnicharsetHash(unicharset));
+  return Writer.Data;
+}                                /* WriteAdaptedSnapshot */
+
+
+/*---------------------------------------------------------------------------*/
+ADAPT_TEMPLATES Classify::ReadAdaptedSnapshot(const char *Data, int Length) {
+/*
+ **	Parameters:
+ **		Data		snapshot made by WriteAdaptedSnapshot
+ **		Length		number of bytes of Data
+ **	Globals: none
+ **	Operation: Rebuilds a set of adapted templates from a snapshot.
+ **		The snapshot must have been written by a classifier with the
+ **		same unicharset, on a machine of the same byte order.
+ **	Return: The new templates, or NULL if the snapshot is malformed or
+ **		does not fit this classifier.
+ **	Exceptions: none
+ */
+  SNAPSHOT_READER Reader;
+  ADAPT_TEMPLATES Templates;
+  INT_TEMPLATES IntTemplates;
+  inT32 Header[7];
+  inT32 NumWords;
+  inT32 NumClasses;
+  inT32 Index;
+  inT32 ClassId;
+  uinT32 Word;
+  int i;
+
+  Reader.Data = Data;
+  Reader.Length = Length;
+  Reader.Position = 0;
+  if (!GetBytes(&Reader, Header, sizeof (Header)) ||
+      Header[0] != ADAPT_SNAPSHOT_MAGIC ||
+      Header[1] != ADAPT_SNAPSHOT_VERSION ||
+      Header[2] != unicharset.size() ||
+      Header[6] != UnicharsetHash(unicharset))
+    return NULL;
+
+  Templates = NewAdaptedTemplates (true);
+  IntTemplates = Templates->Templates;
+  if (Header[3] != IntTemplates->NumClassPruners ||
+      !GetInt(&Reader, &NumWords) || NumWords < 0) {
+    free_adapted_templates(Templates);
+    return NULL;
+  }
+  for (i = 0; i < NumWords; i++) {
+    if (!GetInt(&Reader, &Index) ||
+        !GetBytes(&Reader, &Word, sizeof (Word)) ||
+        Index < 0 || Index >= IntTemplates->NumClassPruners * kWordsPerCP) {
+      free_adapted_templates(Templates);
+      return NULL;
+    }
+    reinterpret_cast<uinT32 *>(IntTemplates->ClassPruner[Index / kWordsPerCP])
+      [Index % kWordsPerCP] = Word;
+  }
+
+  if (!GetInt(&Reader, &NumClasses)) {
+    free_adapted_templates(Templates);
+    return NULL;
+  }
+  for (i = 0; i < NumClasses; i++) {
+    if (!GetInt(&Reader, &ClassId) ||
+        ClassId < 0 || ClassId >= IntTemplates->NumClasses ||
+        !GetSnapshotClass(&Reader, Templates, ClassId)) {
+      free_adapted_templates(Templates);
+      return NULL;
+    }
+  }
+  Templates->NumNonEmptyClasses = Header[4];
+  Templates->NumPermClasses = Header[5];
+  return Templates;
+}                                /* ReadAdaptedSnapshot */
+}  // namespace tesseract
@@ -25,6 +25,10 @@
 #include "intproto.h"
 #include <stdio.h>
 
+/* first words of an adaptive classifier snapshot (see WriteAdaptedSnapshot) */
+#define ADAPT_SNAPSHOT_MAGIC    0x53444154
+#define ADAPT_SNAPSHOT_VERSION  2
+
 typedef struct
 {
   uinT16 ProtoId;
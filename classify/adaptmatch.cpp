@@ -92,6 +92,17 @@ struct ADAPT_RESULTS
        Ratings[i] = WORST_POSSIBLE_RATING;
      }
   }
+
+  // Sorts the classes of the matches by increasing rating.
+  void SortClassesByRating();
+};
+
+// A matched class with its rating, so that the qsort comparison function
+// needs no other data.
+struct RATED_CLASS
+{
+  FLOAT32 Rating;
+  CLASS_ID Class;
 };
 
 
@@ -150,8 +161,8 @@ void CharNormClassifier(TBLOB *Blob,
 
 void ClassifyAsNoise(ADAPT_RESULTS *Results);
 
-int CompareCurrentRatings(const void *arg1,
-                          const void *arg2);
+int CompareRatedClasses(const void *arg1,
+                        const void *arg2);
 
 void ConvertMatchesToChoices(ADAPT_RESULTS *Results,
                              BLOB_CHOICE_LIST *Choices);
@@ -173,24 +184,6 @@ UNICHAR_ID *GetAmbiguities(TBLOB *Blob,
                            LINE_STATS *LineStats,
                            CLASS_ID CorrectClass);
 
-namespace tesseract {
-int GetBaselineFeatures(TBLOB *Blob,
-                        LINE_STATS *LineStats,
-                        INT_TEMPLATES Templates,
-                        INT_FEATURE_ARRAY IntFeatures,
-                        CLASS_NORMALIZATION_ARRAY CharNormArray,
-                        inT32 *BlobLength);
-
-
-int GetIntBaselineFeatures(TBLOB *Blob,
-                           LINE_STATS *LineStats,
-                           INT_TEMPLATES Templates,
-                           INT_FEATURE_ARRAY IntFeatures,
-                           CLASS_NORMALIZATION_ARRAY CharNormArray,
-                           inT32 *BlobLength);
-
-}  // namespace tesseract.
-
 void InitMatcherRatings(register FLOAT32 *Rating);
 
 PROTO_ID MakeNewTempProtos(FEATURE_SET Features,
@@ -217,7 +210,6 @@ void RemoveBadMatches(ADAPT_RESULTS *Results);
 
 void RemoveExtraPuncs(ADAPT_RESULTS *Results);
 
-void SetAdaptiveThreshold(FLOAT32 Threshold);
 void ShowBestMatchFor(TBLOB *Blob,
                       LINE_STATS *LineStats,
                       CLASS_ID ClassId,
@@ -228,37 +220,6 @@ void ShowBestMatchFor(TBLOB *Blob,
 /**----------------------------------------------------------------------------
         Global Data Definitions and Declarations
 ----------------------------------------------------------------------------**/
-/* variables used to hold performance statistics */
-static int AdaptiveMatcherCalls = 0;
-static int BaselineClassifierCalls = 0;
-static int CharNormClassifierCalls = 0;
-static int AmbigClassifierCalls = 0;
-static int NumWordsAdaptedTo = 0;
-static int NumCharsAdaptedTo = 0;
-static int NumBaselineClassesTried = 0;
-static int NumCharNormClassesTried = 0;
-static int NumAmbigClassesTried = 0;
-static int NumClassesOutput = 0;
-static int NumAdaptationsFailed = 0;
-
-/* define globals used to hold onto extracted features.  This is used
-to map from the old scheme in which baseline features and char norm
-features are extracted separately, to the new scheme in which they
-are extracted at the same time. */
-static BOOL8 FeaturesHaveBeenExtracted = FALSE;
-static BOOL8 FeaturesOK = TRUE;
-static INT_FEATURE_ARRAY BaselineFeatures;
-static INT_FEATURE_ARRAY CharNormFeatures;
-static INT_FX_RESULT_STRUCT FXInfo;
-
-/* use a global variable to hold onto the current ratings so that the
-comparison function passes to qsort can get at them */
-static FLOAT32 *CurrentRatings;
-
-/* define globals to hold filenames of training data */
-static CLASS_CUTOFF_ARRAY CharNormCutoffs;
-static CLASS_CUTOFF_ARRAY BaselineCutoffs;
-
 /* define control knobs for adaptive matcher */
 BOOL_VAR(classify_enable_adaptive_matcher, 1, "Enable adaptive classifier");
 
@@ -303,8 +264,15 @@ INT_VAR(matcher_failed_adaptations_before_reset, 150,
 double_VAR(tessedit_class_miss_scale, 0.00390625,
            "Scale factor for features not used");
 
-BOOL_VAR(tess_cn_matching, 0, "Character Normalized Matching");
-BOOL_VAR(tess_bn_matching, 0, "Baseline Normalized Matching");
+INT_VAR(classify_cache_max_kbytes, 0,
+        "Memory bound of the classifier result cache in KB, 0 to disable");
+BOOL_VAR(classify_cache_across_pages, FALSE,
+         "Keep the classifier result cache from page to page");
+INT_VAR(classify_feature_store_max_kbytes, 1024,
+        "Memory bound of the store of extracted blob features in KB,"
+        " 0 to disable");
+BOOL_VAR(classify_feature_store_per_page, FALSE,
+         "Keep extracted blob features for the whole page, not one word");
 
 /**----------------------------------------------------------------------------
               Public Code
@@ -320,7 +288,7 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
  **  Parameters: Blob    blob to be classified
  **              DotBlob         (obsolete)
  **              Row             row of text that word appears in
- **  Globals: CurrentRatings  used by compare function for qsort
+ **  Globals: none
  **                         Operation: This routine calls the adaptive matcher
  **                         which returns (in an array) the class id of each
  **                         class matched.
@@ -341,18 +309,34 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
  **                         History: Mon Mar 11 10:00:58 1991, DSJ, Created.
  */
   assert(Choices != NULL);
+  AllocSubsystemScope alloc_scope(AS_CLASSIFY);
   ADAPT_RESULTS *Results = new ADAPT_RESULTS();
   LINE_STATS LineStats;
+  page_stats.Count(PC_CLASSIFIER_CALLS);
 
-  if (matcher_failed_adaptations_before_reset >= 0 &&
-      NumAdaptationsFailed >= matcher_failed_adaptations_before_reset) {
-    NumAdaptationsFailed = 0;
-    ResetAdaptiveClassifier();
-  }
-  if (AdaptedTemplates == NULL)
+  ResetIfAdaptationsFailed();
+  if (AdaptedTemplates == NULL) {
     AdaptedTemplates = NewAdaptedTemplates (true);
+    classifier_cache_.Clear();
+  }
 
-  EnterClassifyMode;
+  /* Identical blobs on the same normalized row get the same choices, so
+  the result of an earlier one is reused if the templates and the matcher
+  mode did not change since. */
+  bool UseCache = false;
+  classifier_cache_.set_max_bytes(classify_cache_max_kbytes * 1024);
+  if (classifier_cache_.enabled() && CPResults == NULL &&
+      !classify_enable_adaptive_debugger && matcher_debug_level < 1) {
+    inT16 CacheMode = (bln_numericmode ? 1 : 0) | (tess_cn_matching ? 2 : 0) |
+                      (tess_bn_matching ? 4 : 0);
+    UseCache = ClassifierCache::MakeKey(Blob, Row, CacheMode, &cache_key_);
+  }
+  if (UseCache && classifier_cache_.Lookup(cache_key_, Choices)) {
+    InitIntFX();
+    NumClassesOutput += Choices->length();
+    delete Results;
+    return;
+  }
 
   Results->Initialize();
   GetLineStatsFromRow(Row, &LineStats);
@@ -363,10 +347,7 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
            sizeof(CPResults[0]) * Results->NumMatches);
   RemoveBadMatches(Results);
 
-  /* save ratings in a global so that CompareCurrentRatings() can see them */
-  CurrentRatings = Results->Ratings;
-  qsort ((void *) (Results->Classes), Results->NumMatches,
-    sizeof (CLASS_ID), CompareCurrentRatings);
+  Results->SortClassesByRating();
 
   RemoveExtraPuncs(Results);
   ConvertMatchesToChoices(Results, Choices);
@@ -384,6 +365,9 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
     DebugAdaptiveClassifier(Blob, &LineStats, Results);
 #endif
 
+  if (UseCache)
+    classifier_cache_.Insert(cache_key_, Choices);
+
   NumClassesOutput += Choices->length();
   if (Choices->length() == 0) {
     if (!bln_numericmode)
@@ -429,6 +413,7 @@ void Classify::AdaptToWord(TWERD *Word,
  **                         Exceptions: none
  **                         History: Thu Mar 14 07:40:36 1991, DSJ, Created.
 */
+  AllocSubsystemScope alloc_scope(AS_CLASSIFY);
   TBLOB *Blob;
   LINE_STATS LineStats;
   FLOAT32 Thresholds[MAX_ADAPTABLE_WERD_SIZE];
@@ -548,6 +533,8 @@ void Classify::EndAdaptiveClassifier() {
 */
   STRING Filename;
   FILE *File;
+  char *Snapshot;
+  int SnapshotLength;
 
   #ifndef SECURE_NAMES
   if (AdaptedTemplates != NULL &&
@@ -559,7 +546,9 @@ void Classify::EndAdaptiveClassifier() {
     else {
       cprintf ("\nSaving adapted templates to %s ...", Filename.string());
       fflush(stdout);
-      WriteAdaptedTemplates(File, AdaptedTemplates);
+      Snapshot = WriteAdaptedSnapshot(AdaptedTemplates, &SnapshotLength);
+      fwrite(Snapshot, 1, SnapshotLength, File);
+      delete [] Snapshot;
       cprintf ("\n");
       fclose(File);
     }
@@ -570,7 +559,13 @@ void Classify::EndAdaptiveClassifier() {
     free_adapted_templates(AdaptedTemplates);
     AdaptedTemplates = NULL;
   }
+  classifier_cache_.Clear();
 
+  if (template_source_ != NULL) {
+    // The templates and protos belong to the source classifier.
+    PreTrainedTemplates = NULL;
+    NormProtos = NULL;
+  }
   if (PreTrainedTemplates != NULL) {
     free_int_templates(PreTrainedTemplates);
     PreTrainedTemplates = NULL;
@@ -626,11 +621,14 @@ void Classify::InitAdaptiveClassifier() {
     return;
   if (AllProtosOn != NULL)
     EndAdaptiveClassifier();  // Don't leak with multiple inits.
+  classifier_cache_.Clear();
 
   // If there is no language_data_path_prefix, the classifier will be
   // adaptive only.
   if (language_data_path_prefix.length() > 0) {
-    if (!tessdata_manager.SeekToStart(TESSDATA_INTTEMP)) {
+    if (template_source_ != NULL) {
+      inttemp_loaded_ = template_source_->inttemp_loaded_;
+    } else if (!tessdata_manager.SeekToStart(TESSDATA_INTTEMP)) {
       inttemp_loaded_ = false;
     } else {
       PreTrainedTemplates =
@@ -651,9 +649,20 @@ void Classify::InitAdaptiveClassifier() {
 
       inttemp_loaded_ = true;
     }
+    if (template_source_ != NULL && inttemp_loaded_) {
+      // Borrow the read-only data of the source instead of loading a copy.
+      // The traineddata is not opened again, so the cutoffs, which are
+      // small, are copied from the source.
+      PreTrainedTemplates = template_source_->PreTrainedTemplates;
+      NormProtos = template_source_->NormProtos;
+      if (fontinfo_table_.size() == 0 && fontset_table_.size() == 0)
+        CopyFontTables(*template_source_);
+      memcpy(CharNormCutoffs, template_source_->CharNormCutoffs,
+             sizeof(CharNormCutoffs));
+    }
   }
 
-  InitIntegerMatcher();
+  im_.Init();
   InitIntegerFX();
 
   AllProtosOn = NewBitVector(MAX_NUM_PROTOS);
@@ -683,9 +692,15 @@ void Classify::InitAdaptiveClassifier() {
               Filename.string());
       fflush(stdout);
       #endif
-      AdaptedTemplates = ReadAdaptedTemplates(File);
+      AdaptedTemplates = ReadAdaptedTemplatesFile(File);
       cprintf("\n");
       fclose(File);
+      if (AdaptedTemplates == NULL) {
+        cprintf("Pre-adapted templates do not fit %s, ignoring them\n",
+                Filename.string());
+        AdaptedTemplates = NewAdaptedTemplates(true);
+        return;
+      }
       PrintAdaptedTemplates(stdout, AdaptedTemplates);
 
       for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
@@ -702,6 +717,120 @@ void Classify::InitAdaptiveClassifier() {
 void Classify::ResetAdaptiveClassifier() {
   free_adapted_templates(AdaptedTemplates);
   AdaptedTemplates = NULL;
+  classifier_cache_.Clear();
+}
+
+/*---------------------------------------------------------------------------*/
+void Classify::ResetIfAdaptationsFailed() {
+  if (matcher_failed_adaptations_before_reset >= 0 &&
+      NumAdaptationsFailed >= matcher_failed_adaptations_before_reset) {
+    NumAdaptationsFailed = 0;
+    ResetAdaptiveClassifier();
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+ADAPT_TEMPLATES Classify::ReadAdaptedTemplatesFile(FILE *File) {
+/*
+ **                         Parameters:
+ **                         File
+ **                         open file to read adapted templates from
+ **                         Operation: Reads a set of adapted templates saved by
+ **                         EndAdaptiveClassifier, which are in the snapshot format
+ **                         unless they were saved by an older version, in which
+ **                         case they are read with ReadAdaptedTemplates.
+ **                         Return: The templates, or NULL if the snapshot does not fit
+ **                         this classifier or its length cannot be found.
+ **                         Exceptions: none
+*/
+  inT32 Magic;
+  long Length;
+  char *Snapshot;
+  ADAPT_TEMPLATES Templates;
+
+  if (fread(&Magic, sizeof(Magic), 1, File) != 1 ||
+      Magic != ADAPT_SNAPSHOT_MAGIC) {
+    rewind(File);
+    return ReadAdaptedTemplates(File);
+  }
+  if (fseek(File, 0, SEEK_END) != 0 || (Length = ftell(File)) < 0 ||
+      Length > MAX_INT32) {
+    cprintf("Can't find the length of the adapted templates file\n");
+    return NULL;
+  }
+  rewind(File);
+  Snapshot = new char[Length];
+  Templates = NULL;
+  if (fread(Snapshot, 1, Length, File) == static_cast<size_t>(Length))
+    Templates = ReadAdaptedSnapshot(Snapshot, Length);
+  delete [] Snapshot;
+  return Templates;
+}                                /* ReadAdaptedTemplatesFile */
+
+/*---------------------------------------------------------------------------*/
+char *Classify::ExportAdaptiveClassifier(int *length) {
+  if (!classify_enable_adaptive_matcher || AllProtosOn == NULL)
+    return NULL;
+  if (AdaptedTemplates == NULL) {
+    AdaptedTemplates = NewAdaptedTemplates(true);
+    classifier_cache_.Clear();
+  }
+  return WriteAdaptedSnapshot(AdaptedTemplates, length);
+}
+
+/*---------------------------------------------------------------------------*/
+bool Classify::ImportAdaptiveClassifier(const char *data, int length) {
+  if (!classify_enable_adaptive_matcher || AllProtosOn == NULL)
+    return false;
+  ADAPT_TEMPLATES Templates = ReadAdaptedSnapshot(data, length);
+  if (Templates == NULL)
+    return false;
+  free_adapted_templates(AdaptedTemplates);
+  AdaptedTemplates = Templates;
+  // The cached results came from the templates that were replaced.
+  classifier_cache_.Clear();
+  for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++)
+    BaselineCutoffs[i] = CharNormCutoffs[i];
+  return true;
+}
+
+/*---------------------------------------------------------------------------*/
+void Classify::CopyClassifierState(const char *templates,
+                                   int templates_length, Classify *other) {
+  other->tessedit_single_match.set_value(tessedit_single_match);
+  other->classify_recog_devanagari.set_value(classify_recog_devanagari);
+  for (int i = 0; i < unicharset.size() && i < other->unicharset.size(); ++i)
+    other->unicharset.set_enabled(i, unicharset.get_enabled(i));
+  other->StartClassifierCachePage();
+  if (templates != NULL)
+    other->ImportAdaptiveClassifier(templates, templates_length);
+}
+
+/*---------------------------------------------------------------------------*/
+void Classify::StartClassifierCachePage() {
+  // The white and black lists are applied by the matcher, so the cached
+  // results are only good for the same lists.
+  bool EnabledChanged = cache_enabled_.size() != unicharset.size();
+  if (EnabledChanged) {
+    cache_enabled_.truncate(0);
+    for (int i = 0; i < unicharset.size(); ++i)
+      cache_enabled_.push_back(unicharset.get_enabled(i));
+  }
+  for (int i = 0; i < unicharset.size(); ++i) {
+    if (cache_enabled_[i] != unicharset.get_enabled(i)) {
+      cache_enabled_[i] = unicharset.get_enabled(i);
+      EnabledChanged = true;
+    }
+  }
+  if (!classify_cache_across_pages || EnabledChanged)
+    classifier_cache_.Clear();
+  feature_store_.Clear();
+}
+
+/*---------------------------------------------------------------------------*/
+void Classify::StartFeatureStoreWord() {
+  if (!classify_feature_store_per_page)
+    feature_store_.Clear();
 }
 }  // namespace tesseract
 
@@ -741,6 +870,15 @@ void Classify::PrintAdaptiveStatistics(FILE *File) {
     ((AmbigClassifierCalls == 0) ? (0.0) :
   ((float) NumAmbigClassesTried / AmbigClassifierCalls)));
 
+  fprintf (File, "\tResult cache: %d hits, %d misses, %d evictions,"
+    " %d invalidations, %d entries (%d bytes)\n",
+    classifier_cache_.hits(), classifier_cache_.misses(),
+    classifier_cache_.evictions(), classifier_cache_.invalidations(),
+    classifier_cache_.num_entries(), classifier_cache_.bytes());
+  fprintf (File, "\tFeature store: %d hits, %d misses, %d entries (%d bytes)\n",
+    feature_store_.hits(), feature_store_.misses(),
+    feature_store_.num_entries(), feature_store_.bytes());
+
   fprintf (File, "\nADAPTIVE LEARNER STATISTICS:\n");
   fprintf (File, "\tNumber of words adapted to: %d\n", NumWordsAdaptedTo);
   fprintf (File, "\tNumber of chars adapted to: %d\n", NumCharsAdaptedTo);
@@ -838,8 +976,10 @@ void Classify::InitAdaptedClass(TBLOB *Blob,
   INT_CLASS IClass;
   TEMP_CONFIG Config;
 
-  classify_norm_method.set_value(baseline);
-  Features = ExtractOutlineFeatures (Blob, LineStats);
+  /* cached classifications may not hold for the new class */
+  classifier_cache_.Clear();
+
+  Features = ExtractOutlineFeatures (Blob, LineStats, baseline);
   NumFeatures = Features->NumFeatures;
   if (NumFeatures > UNLIKELY_NUM_FEAT || NumFeatures <= 0) {
     FreeFeatureSet(Features);
@@ -927,8 +1067,7 @@ int GetAdaptiveFeatures(TBLOB *Blob,
   FEATURE_SET Features;
   int NumFeatures;
 
-  classify_norm_method.set_value(baseline);
-  Features = ExtractPicoFeatures (Blob, LineStats);
+  Features = ExtractPicoFeatures (Blob, LineStats, baseline);
 
   NumFeatures = Features->NumFeatures;
   if (NumFeatures > UNLIKELY_NUM_FEAT) {
@@ -936,7 +1075,7 @@ int GetAdaptiveFeatures(TBLOB *Blob,
     return (0);
   }
 
-  ComputeIntFeatures(Features, IntFeatures);
+  ComputeIntFeatures(Features, baseline, IntFeatures);
   *FloatFeatures = Features;
 
   return (NumFeatures);
@@ -1035,8 +1174,8 @@ int Classify::AdaptableWord(TWERD *Word,
     if (NumFeatures <= 0)
       return;
 
-    SetBaseLineMatch();
-    IntegerMatcher (IClass, AllProtosOn, AllConfigsOn,
+    im_.SetBaseLineMatch();
+    im_.Match(IClass, AllProtosOn, AllConfigsOn,
       NumFeatures, NumFeatures, IntFeatures, 0,
       &IntResult, NO_DEBUG);
 
@@ -1078,7 +1217,7 @@ int Classify::AdaptableWord(TWERD *Word,
 
 #ifndef GRAPHICS_DISABLED
       if (classify_learning_debug_level >= 1) {
-        IntegerMatcher (IClass, AllProtosOn, AllConfigsOn,
+        im_.Match(IClass, AllProtosOn, AllConfigsOn,
           NumFeatures, NumFeatures, IntFeatures, 0,
           &IntResult, NO_DEBUG);
         cprintf ("Best match to temp config %d = %4.1f%%.\n",
@@ -1087,7 +1226,7 @@ int Classify::AdaptableWord(TWERD *Word,
           uinT32 ConfigMask;
           ConfigMask = 1 << IntResult.Config;
           ShowMatchDisplay();
-          IntegerMatcher (IClass, AllProtosOn, (BIT_VECTOR)&ConfigMask,
+          im_.Match(IClass, AllProtosOn, (BIT_VECTOR)&ConfigMask,
             NumFeatures, NumFeatures, IntFeatures, 0,
             &IntResult, 6 | 0x19);
           UpdateMatchDisplay();
@@ -1271,8 +1410,8 @@ void Classify::AmbigClassifier(TBLOB *Blob,
   while (*Ambiguities >= 0) {
     ClassId = *Ambiguities;
 
-    SetCharNormMatch();
-    IntegerMatcher (ClassForClassId (Templates, ClassId),
+    im_.SetCharNormMatch();
+    im_.Match(ClassForClassId (Templates, ClassId),
       AllProtosOn, AllConfigsOn,
       Results->BlobLength, NumFeatures, IntFeatures,
       CharNormArray[ClassId], &IntResult, NO_DEBUG);
@@ -1313,7 +1452,7 @@ void Classify::MasterMatcher(INT_TEMPLATES templates,
     BIT_VECTOR configs = classes != NULL ? classes[class_id]->PermConfigs
                                          : AllConfigsOn;
 
-    IntegerMatcher(ClassForClassId(templates, class_id),
+    im_.Match(ClassForClassId(templates, class_id),
                    protos, configs, final_results->BlobLength,
                    num_features, features, norm_factors[class_id],
                    &int_result, debug);
@@ -1415,7 +1554,7 @@ UNICHAR_ID *Classify::BaselineClassifier(TBLOB *Blob,
   if (matcher_debug_level >= 2 || tord_display_ratings > 1)
     cprintf ("BL Matches =  ");
 
-  SetBaseLineMatch();
+  im_.SetBaseLineMatch();
   MasterMatcher(Templates->Templates, NumFeatures, IntFeatures, CharNormArray,
                 Templates->Class, matcher_debug_flags, NumClasses,
                 Results->CPResults, Results);
@@ -1482,7 +1621,7 @@ int Classify::CharNormClassifier(TBLOB *Blob,
     NumClasses = 1;
   NumCharNormClassesTried += NumClasses;
 
-  SetCharNormMatch();
+  im_.SetCharNormMatch();
   MasterMatcher(Templates, NumFeatures, IntFeatures, CharNormArray,
                 NULL, matcher_debug_flags, NumClasses,
                 Results->CPResults, Results);
@@ -1519,18 +1658,15 @@ void Classify::ClassifyAsNoise(ADAPT_RESULTS *Results) {
 
 
 /*---------------------------------------------------------------------------*/
-int CompareCurrentRatings(                     //CLASS_ID              *Class1,
-                          const void *arg1,
-                          const void *arg2) {  //CLASS_ID              *Class2)
+int CompareRatedClasses(const void *arg1,
+                        const void *arg2) {
 /*
  **                         Parameters:
- **                         Class1, Class2
-              classes whose ratings are to be compared
-**                          Globals:
-**                          CurrentRatings
-              contains actual ratings for each class
-**                          Operation: This routine gets the ratings for the 2 specified classes
-**                          from a global variable (CurrentRatings) and returns:
+ **                         arg1, arg2
+              RATED_CLASS entries to be compared
+**                          Globals: none
+**                          Operation: This routine compares the ratings of the
+**                          2 specified classes and returns:
 **          -1 if Rating1 < Rating2
 **                          0 if Rating1 = Rating2
 **                          1 if Rating1 > Rating2
@@ -1538,12 +1674,8 @@ int CompareCurrentRatings(                     //CLASS_ID              *Class1,
 **                          Exceptions: none
 **                          History: Tue Mar 12 14:18:31 1991, DSJ, Created.
 */
-  FLOAT32 Rating1, Rating2;
-  CLASS_ID *Class1 = (CLASS_ID *) arg1;
-  CLASS_ID *Class2 = (CLASS_ID *) arg2;
-
-  Rating1 = CurrentRatings[*Class1];
-  Rating2 = CurrentRatings[*Class2];
+  FLOAT32 Rating1 = ((const RATED_CLASS *) arg1)->Rating;
+  FLOAT32 Rating2 = ((const RATED_CLASS *) arg2)->Rating;
 
   if (Rating1 < Rating2)
     return (-1);
@@ -1552,7 +1684,24 @@ int CompareCurrentRatings(                     //CLASS_ID              *Class1,
   else
     return (0);
 
-}                                /* CompareCurrentRatings */
+}                                /* CompareRatedClasses */
+
+
+/*---------------------------------------------------------------------------*/
+void ADAPT_RESULTS::SortClassesByRating() {
+  RATED_CLASS *RatedClasses = new RATED_CLASS[NumMatches];
+  int i;
+
+  for (i = 0; i < NumMatches; i++) {
+    RatedClasses[i].Rating = Ratings[Classes[i]];
+    RatedClasses[i].Class = Classes[i];
+  }
+  qsort ((void *) RatedClasses, NumMatches, sizeof (RATED_CLASS),
+         CompareRatedClasses);
+  for (i = 0; i < NumMatches; i++)
+    Classes[i] = RatedClasses[i].Class;
+  delete [] RatedClasses;
+}
 
 
 /*---------------------------------------------------------------------------*/
@@ -1831,8 +1980,6 @@ UNICHAR_ID *Classify::GetAmbiguities(TBLOB *Blob,
    **                            CorrectClass
    correct class for Blob
    **                            Globals:
-   **                            CurrentRatings
-   used by qsort compare routine
    **                            PreTrainedTemplates
    built-in templates
    **                            Operation: This routine matches blob to the built-in templates
@@ -1846,17 +1993,12 @@ UNICHAR_ID *Classify::GetAmbiguities(TBLOB *Blob,
   UNICHAR_ID *Ambiguities;
   int i;
 
-  EnterClassifyMode;
-
   Results->Initialize();
 
   CharNormClassifier(Blob, LineStats, PreTrainedTemplates, Results);
   RemoveBadMatches(Results);
 
-  /* save ratings in a global so that CompareCurrentRatings() can see them */
-  CurrentRatings = Results->Ratings;
-  qsort ((void *) (Results->Classes), Results->NumMatches,
-         sizeof (CLASS_ID), CompareCurrentRatings);
+  Results->SortClassesByRating();
 
   /* copy the class id's into an string of ambiguities - don't copy if
      the correct class is the only class id matched */
@@ -1876,12 +2018,12 @@ UNICHAR_ID *Classify::GetAmbiguities(TBLOB *Blob,
 }                              /* GetAmbiguities */
 
 /*---------------------------------------------------------------------------*/
-int GetBaselineFeatures(TBLOB *Blob,
-                        LINE_STATS *LineStats,
-                        INT_TEMPLATES Templates,
-                        INT_FEATURE_ARRAY IntFeatures,
-                        CLASS_NORMALIZATION_ARRAY CharNormArray,
-                        inT32 *BlobLength) {
+int Classify::GetBaselineFeatures(TBLOB *Blob,
+                                  LINE_STATS *LineStats,
+                                  INT_TEMPLATES Templates,
+                                  INT_FEATURE_ARRAY IntFeatures,
+                                  CLASS_NORMALIZATION_ARRAY CharNormArray,
+                                  inT32 *BlobLength) {
   /*
    **                           Parameters:
    **                           Blob
@@ -1916,8 +2058,7 @@ int GetBaselineFeatures(TBLOB *Blob,
     return (GetIntBaselineFeatures (Blob, LineStats, Templates,
                                     IntFeatures, CharNormArray, BlobLength));
 
-  classify_norm_method.set_value(baseline);
-  Features = ExtractPicoFeatures (Blob, LineStats);
+  Features = ExtractPicoFeatures (Blob, LineStats, baseline);
 
   NumFeatures = Features->NumFeatures;
   *BlobLength = NumFeatures;
@@ -1926,7 +2067,7 @@ int GetBaselineFeatures(TBLOB *Blob,
     return (0);
   }
 
-  ComputeIntFeatures(Features, IntFeatures);
+  ComputeIntFeatures(Features, baseline, IntFeatures);
   ClearCharNormArray(Templates, CharNormArray);
 
   FreeFeatureSet(Features);
@@ -1978,8 +2119,8 @@ FLOAT32 Classify::GetBestRatingFor(TBLOB *Blob,
                                          PreTrainedTemplates,
                                          CNFeatures, CNAdjust, &BlobLength);
     if (NumCNFeatures > 0) {
-      SetCharNormMatch();
-      IntegerMatcher (ClassForClassId (PreTrainedTemplates, ClassId),
+      im_.SetCharNormMatch();
+      im_.Match(ClassForClassId (PreTrainedTemplates, ClassId),
                       AllProtosOn, AllConfigsOn,
                       BlobLength, NumCNFeatures, CNFeatures,
                       CNAdjust[ClassId], &CNResult, NO_DEBUG);
@@ -1991,8 +2132,8 @@ FLOAT32 Classify::GetBestRatingFor(TBLOB *Blob,
                                          AdaptedTemplates->Templates,
                                          BLFeatures, BLAdjust, &BlobLength);
     if (NumBLFeatures > 0) {
-      SetBaseLineMatch();
-      IntegerMatcher(ClassForClassId(AdaptedTemplates->Templates, ClassId),
+      im_.SetBaseLineMatch();
+      im_.Match(ClassForClassId(AdaptedTemplates->Templates, ClassId),
                       AdaptedTemplates->Class[ClassId]->PermProtos,
                       AdaptedTemplates->Class[ClassId]->PermConfigs,
                       BlobLength, NumBLFeatures, BLFeatures,
@@ -2046,12 +2187,12 @@ int Classify::GetCharNormFeatures(TBLOB *Blob,
 }                              /* GetCharNormFeatures */
 
 /*---------------------------------------------------------------------------*/
-int GetIntBaselineFeatures(TBLOB *Blob,
-                           LINE_STATS *LineStats,
-                           INT_TEMPLATES Templates,
-                           INT_FEATURE_ARRAY IntFeatures,
-                           CLASS_NORMALIZATION_ARRAY CharNormArray,
-                           inT32 *BlobLength) {
+int Classify::GetIntBaselineFeatures(TBLOB *Blob,
+                                     LINE_STATS *LineStats,
+                                     INT_TEMPLATES Templates,
+                                     INT_FEATURE_ARRAY IntFeatures,
+                                     CLASS_NORMALIZATION_ARRAY CharNormArray,
+                                     inT32 *BlobLength) {
   /*
    **                           Parameters:
    **                           Blob
@@ -2066,7 +2207,7 @@ int GetIntBaselineFeatures(TBLOB *Blob,
    array to fill with dummy char norm adjustments
    **                            BlobLength
    length of blob in baseline-normalized units
-   **                            Globals:
+   **                            Members:
    **                            FeaturesHaveBeenExtracted
    TRUE if fx has been done
    **                            BaselineFeatures
@@ -2078,7 +2219,7 @@ int GetIntBaselineFeatures(TBLOB *Blob,
    **                            Operation: This routine calls the integer (Hardware) feature
    **                            extractor if it has not been called before for this blob.
    **                            The results from the feature extractor are placed into
-   **                            globals so that they can be used in other routines without
+   **                            members so that they can be used in other routines without
    **                            re-extracting the features.
    **                            It then copies the baseline features into the IntFeatures
    **                            array provided by the caller.
@@ -2089,8 +2230,7 @@ int GetIntBaselineFeatures(TBLOB *Blob,
   register INT_FEATURE Src, Dest, End;
 
   if (!FeaturesHaveBeenExtracted) {
-    FeaturesOK = ExtractIntFeat (Blob, BaselineFeatures,
-                                 CharNormFeatures, &FXInfo);
+    ExtractStoredIntFeatures(Blob);
     FeaturesHaveBeenExtracted = TRUE;
   }
 
@@ -2129,7 +2269,7 @@ int Classify::GetIntCharNormFeatures(TBLOB *Blob,
    array to fill with dummy char norm adjustments
    **                            BlobLength
    length of blob in baseline-normalized units
-   **                            Globals:
+   **                            Members:
    **                            FeaturesHaveBeenExtracted
    TRUE if fx has been done
    **                            BaselineFeatures
@@ -2141,7 +2281,7 @@ int Classify::GetIntCharNormFeatures(TBLOB *Blob,
    **                            Operation: This routine calls the integer (Hardware) feature
    **                            extractor if it has not been called before for this blob.
    **                            The results from the feature extractor are placed into
-   **                            globals so that they can be used in other routines without
+   **                            members so that they can be used in other routines without
    **                            re-extracting the features.
    **                            It then copies the char norm features into the IntFeatures
    **                            array provided by the caller.
@@ -2154,8 +2294,7 @@ int Classify::GetIntCharNormFeatures(TBLOB *Blob,
   FLOAT32 Baseline, Scale;
 
   if (!FeaturesHaveBeenExtracted) {
-    FeaturesOK = ExtractIntFeat (Blob, BaselineFeatures,
-                                 CharNormFeatures, &FXInfo);
+    ExtractStoredIntFeatures(Blob);
     FeaturesHaveBeenExtracted = TRUE;
   }
 
@@ -2183,6 +2322,47 @@ int Classify::GetIntCharNormFeatures(TBLOB *Blob,
   return (FXInfo.NumCN);
 }                              /* GetIntCharNormFeatures */
 
+/*---------------------------------------------------------------------------*/
+void Classify::ExtractStoredIntFeatures(TBLOB *Blob) {
+  /*
+   **                           Parameters:
+   **                           Blob
+   blob to extract features from
+   **                            Members:
+   **                            BaselineFeatures
+   holds extracted baseline feat
+   **                            CharNormFeatures
+   holds extracted char norm feat
+   **                            FXInfo
+   holds misc. FX info
+   **                            FeaturesOK
+   result of the feature extractor
+   **                            Operation: This routine calls the integer feature extractor
+   **                            for Blob, unless a blob with exactly the same outlines was
+   **                            extracted earlier in the word (or page), in which case its
+   **                            stored features are copied instead. The features only
+   **                            depend on the normalized outlines, so the store stays
+   **                            valid while the adapted templates change.
+   **                            Return: none
+   **                            Exceptions: none
+   */
+  bool UseStore;
+
+  feature_store_.set_max_bytes(classify_feature_store_max_kbytes * 1024);
+  UseStore = feature_store_.enabled() &&
+             ClassifierCache::MakeBlobKey(Blob, &feature_key_);
+  if (UseStore &&
+      feature_store_.Lookup(feature_key_, BaselineFeatures, CharNormFeatures,
+                            &FXInfo, &FeaturesOK))
+    return;
+
+  FeaturesOK = ExtractIntFeat (Blob, BaselineFeatures,
+                               CharNormFeatures, &FXInfo);
+  if (UseStore)
+    feature_store_.Insert(feature_key_, BaselineFeatures, CharNormFeatures,
+                          FXInfo, FeaturesOK);
+}                              /* ExtractStoredIntFeatures */
+
 /*---------------------------------------------------------------------------*/
 int Classify::MakeNewTemporaryConfig(ADAPT_TEMPLATES Templates,
                            CLASS_ID ClassId,
@@ -2241,10 +2421,11 @@ int Classify::MakeNewTemporaryConfig(ADAPT_TEMPLATES Templates,
       cprintf ("Cannot make new temporary config: maximum number exceeded.\n");
     return -1;
   }
+  classifier_cache_.Clear();
 
   OldMaxProtoId = IClass->NumProtos - 1;
 
-  NumOldProtos = FindGoodProtos (IClass, AllProtosOn, AllConfigsOff,
+  NumOldProtos = im_.FindGoodProtos (IClass, AllProtosOn, AllConfigsOff,
                                  BlobLength, NumFeatures, Features,
                                  OldProtos, debug_level);
 
@@ -2253,7 +2434,7 @@ int Classify::MakeNewTemporaryConfig(ADAPT_TEMPLATES Templates,
   for (i = 0; i < NumOldProtos; i++)
     SET_BIT (TempProtoMask, OldProtos[i]);
 
-  NumBadFeatures = FindBadFeatures (IClass, TempProtoMask, AllConfigsOn,
+  NumBadFeatures = im_.FindBadFeatures (IClass, TempProtoMask, AllConfigsOn,
                                     BlobLength, NumFeatures, Features,
                                     BadFeatures, debug_level);
 
@@ -2410,6 +2591,7 @@ void Classify::MakePermanent(ADAPT_TEMPLATES Templates,
   ADAPT_CLASS Class;
   PROTO_KEY ProtoKey;
 
+  classifier_cache_.Clear();
   Class = Templates->Class[ClassId];
   Config = TempConfigFor(Class, ConfigId);
 
@@ -2661,7 +2843,8 @@ void Classify::RemoveExtraPuncs(ADAPT_RESULTS *Results) {
 }  // namespace tesseract
 
 /*---------------------------------------------------------------------------*/
-void SetAdaptiveThreshold(FLOAT32 Threshold) {
+namespace tesseract {
+void Classify::SetAdaptiveThreshold(FLOAT32 Threshold) {
   /*
    **                           Parameters:
    **                           Threshold
@@ -2679,18 +2862,17 @@ void SetAdaptiveThreshold(FLOAT32 Threshold) {
   if (Threshold == matcher_good_threshold) {
     /* the blob was probably classified correctly - use the default rating
        threshold */
-    SetProtoThresh (0.9);
-    SetFeatureThresh (0.9);
+    im_.SetProtoThresh (0.9);
+    im_.SetFeatureThresh (0.9);
   }
   else {
     /* the blob was probably incorrectly classified */
-    SetProtoThresh (1.0 - Threshold);
-    SetFeatureThresh (1.0 - Threshold);
+    im_.SetProtoThresh (1.0 - Threshold);
+    im_.SetFeatureThresh (1.0 - Threshold);
   }
 }                              /* SetAdaptiveThreshold */
 
 /*---------------------------------------------------------------------------*/
-namespace tesseract {
 void Classify::ShowBestMatchFor(TBLOB *Blob,
                                 LINE_STATS *LineStats,
                                 CLASS_ID ClassId,
@@ -2755,8 +2937,8 @@ void Classify::ShowBestMatchFor(TBLOB *Blob,
       if (NumCNFeatures <= 0)
         cprintf ("Illegal blob (char norm features)!\n");
       else {
-        SetCharNormMatch();
-        IntegerMatcher (ClassForClassId (PreTrainedTemplates, ClassId),
+        im_.SetCharNormMatch();
+        im_.Match(ClassForClassId (PreTrainedTemplates, ClassId),
                         AllProtosOn, AllConfigsOn,
                         BlobLength, NumCNFeatures, CNFeatures,
                         CNAdjust[ClassId], &CNResult, NO_DEBUG);
@@ -2779,8 +2961,8 @@ void Classify::ShowBestMatchFor(TBLOB *Blob,
       if (NumBLFeatures <= 0)
         cprintf ("Illegal blob (baseline features)!\n");
       else {
-        SetBaseLineMatch();
-        IntegerMatcher (ClassForClassId
+        im_.SetBaseLineMatch();
+        im_.Match(ClassForClassId
                         (AdaptedTemplates->Templates, ClassId),
                         AllProtosOn, AllConfigsOn,
                         // AdaptedTemplates->Class[ClassId]->PermProtos,
@@ -2809,8 +2991,8 @@ void Classify::ShowBestMatchFor(TBLOB *Blob,
     }
     classify_norm_method.set_value(baseline);
 
-    SetBaseLineMatch();
-    IntegerMatcher (ClassForClassId (AdaptedTemplates->Templates, ClassId),
+    im_.SetBaseLineMatch();
+    im_.Match(ClassForClassId (AdaptedTemplates->Templates, ClassId),
                     AllProtosOn,
                     //        AdaptedTemplates->Class[ClassId]->PermProtos,
                     (BIT_VECTOR) & ConfigMask,
@@ -2823,9 +3005,9 @@ void Classify::ShowBestMatchFor(TBLOB *Blob,
     ConfigMask = 1 << CNResult.Config;
     classify_norm_method.set_value(character);
 
-    SetCharNormMatch();
+    im_.SetCharNormMatch();
     //xiaofan
-    IntegerMatcher (ClassForClassId (PreTrainedTemplates, ClassId), AllProtosOn, (BIT_VECTOR) & ConfigMask,
+    im_.Match(ClassForClassId (PreTrainedTemplates, ClassId), AllProtosOn, (BIT_VECTOR) & ConfigMask,
                     BlobLength, NumCNFeatures, CNFeatures,
                     CNAdjust[ClassId], &CNResult, matcher_debug_flags);
   }
@@ -74,8 +74,6 @@ LearnBlob (const STRING& filename,
   CHAR_DESC CharDesc;
   LINE_STATS LineStats;
 
-  EnterLearnMode;
-
   GetLineStatsFromRow(Row, &LineStats);
 
   CharDesc = ExtractBlobFeatures (Blob, &LineStats);
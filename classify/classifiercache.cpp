@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////
+// File:        classifiercache.cpp
+// Description: Cache of adaptive classifier results keyed by blob shape.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "classifiercache.h"
+
+#include <string.h>
+
+namespace tesseract {
+
+// Blobs with more points than this are not worth caching, and their keys
+// would not fit the inT16 point counts.
+const int kMaxCachedPoints = 4096;
+// Number of buckets of the hash table at the first Insert.
+const int kInitialBuckets = 256;
+
+struct ClassifierCacheEntry {
+  uinT32 hash;
+  inT16 *key;
+  int key_length;
+  int bytes;
+  BLOB_CHOICE_LIST choices;
+  ClassifierCacheEntry *bucket_next;
+  ClassifierCacheEntry *lru_prev;
+  ClassifierCacheEntry *lru_next;
+};
+
+// FNV-1a hash of the values of key.
+static uinT32 HashKey(const inT16 *key, int length) {
+  uinT32 hash = 2166136261u;
+  for (int i = 0; i < length; ++i) {
+    uinT16 value = static_cast<uinT16>(key[i]);
+    hash = (hash ^ (value & 0xff)) * 16777619u;
+    hash = (hash ^ (value >> 8)) * 16777619u;
+  }
+  return hash;
+}
+
+// Appends the bits of value to key as 16 bit pieces, so that keys compare
+// floating point values exactly.
+static void PushBits(const void *value, int size, GenericVector<inT16> *key) {
+  const char *bytes = reinterpret_cast<const char *>(value);
+  for (int i = 0; i < size; i += sizeof(inT16)) {
+    inT16 piece;
+    memcpy(&piece, bytes + i, sizeof(piece));
+    key->push_back(piece);
+  }
+}
+
+// Returns true if spline is a single horizontal line, as on the rows the
+// words are normalized to.
+static bool IsFlatSpline(const SPLINE_SPEC &spline) {
+  return spline.segments == 1 && spline.quads[0].a == 0.0 &&
+         spline.quads[0].b == 0.0;
+}
+
+// Returns the number of points of outline and all the outlines inside and
+// after it, stopping early once there are more than kMaxCachedPoints.
+static int CountPoints(TESSLINE *outline) {
+  int num_points = 0;
+  for (; outline != NULL; outline = outline->next) {
+    EDGEPT *point = outline->loop;
+    if (point != NULL) {
+      do {
+        ++num_points;
+        point = point->next;
+      } while (point != outline->loop && num_points <= kMaxCachedPoints);
+    }
+    if (num_points > kMaxCachedPoints)
+      return num_points;
+    num_points += CountPoints(outline->child);
+  }
+  return num_points;
+}
+
+// Appends outline and all the outlines inside and after it to key.
+static void PushOutlines(TESSLINE *outline, GenericVector<inT16> *key) {
+  for (; outline != NULL; outline = outline->next) {
+    key->push_back(outline->topleft.x);
+    key->push_back(outline->topleft.y);
+    key->push_back(outline->botright.x);
+    key->push_back(outline->botright.y);
+    int length_index = key->size();
+    key->push_back(0);
+    int num_points = 0;
+    EDGEPT *point = outline->loop;
+    if (point != NULL) {
+      do {
+        key->push_back(point->pos.x);
+        key->push_back(point->pos.y);
+        PushBits(point->flags, EDGEPTFLAGS, key);
+        ++num_points;
+        point = point->next;
+      } while (point != outline->loop);
+    }
+    (*key)[length_index] = num_points;
+    // The child list is closed with a marker so that nesting is part of
+    // the key.
+    PushOutlines(outline->child, key);
+    key->push_back(-1);
+  }
+}
+
+// static
+bool ClassifierCache::MakeKey(TBLOB *blob, TEXTROW *row, inT16 mode,
+                              GenericVector<inT16> *key) {
+  if (!IsFlatSpline(row->baseline) || !IsFlatSpline(row->xheight))
+    return false;
+  int num_points = CountPoints(blob->outlines);
+  if (num_points == 0 || num_points > kMaxCachedPoints)
+    return false;
+
+  key->truncate(0);
+  key->push_back(mode);
+  PushBits(&row->baseline.quads[0].c, sizeof(row->baseline.quads[0].c), key);
+  PushBits(&row->xheight.quads[0].c, sizeof(row->xheight.quads[0].c), key);
+  PushBits(&row->lineheight, sizeof(row->lineheight), key);
+  PushBits(&row->ascrise, sizeof(row->ascrise), key);
+  PushBits(&row->descdrop, sizeof(row->descdrop), key);
+  PushBits(blob->flags, TBLOBFLAGS, key);
+  PushOutlines(blob->outlines, key);
+  return true;
+}
+
+// static
+bool ClassifierCache::MakeBlobKey(TBLOB *blob, GenericVector<inT16> *key) {
+  int num_points = CountPoints(blob->outlines);
+  if (num_points == 0 || num_points > kMaxCachedPoints)
+    return false;
+  key->truncate(0);
+  PushBits(blob->flags, TBLOBFLAGS, key);
+  PushOutlines(blob->outlines, key);
+  return true;
+}
+
+// static
+uinT32 ClassifierCache::Hash(const GenericVector<inT16> &key) {
+  return HashKey(&key[0], key.size());
+}
+
+ClassifierCache::ClassifierCache()
+  : max_bytes_(0), bytes_(0), num_entries_(0), num_buckets_(0),
+    buckets_(NULL), lru_head_(NULL), lru_tail_(NULL), generation_(0) {
+  ResetStats();
+}
+
+ClassifierCache::~ClassifierCache() {
+  Clear();
+  delete [] buckets_;
+}
+
+void ClassifierCache::set_max_bytes(int max_bytes) {
+  if (max_bytes < 0)
+    max_bytes = 0;
+  if (max_bytes == max_bytes_)
+    return;
+  max_bytes_ = max_bytes;
+  EvictToFit();
+}
+
+void ClassifierCache::ResetStats() {
+  hits_ = 0;
+  misses_ = 0;
+  evictions_ = 0;
+  invalidations_ = 0;
+}
+
+bool ClassifierCache::Lookup(const GenericVector<inT16> &key,
+                             BLOB_CHOICE_LIST *choices) {
+  if (num_buckets_ == 0 || key.empty()) {
+    ++misses_;
+    return false;
+  }
+  ClassifierCacheEntry *entry =
+    *Find(key, HashKey(&key[0], key.size()));
+  if (entry == NULL) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  // Move the entry to the front of the LRU list.
+  if (entry != lru_head_) {
+    entry->lru_prev->lru_next = entry->lru_next;
+    if (entry->lru_next != NULL)
+      entry->lru_next->lru_prev = entry->lru_prev;
+    else
+      lru_tail_ = entry->lru_prev;
+    entry->lru_prev = NULL;
+    entry->lru_next = lru_head_;
+    lru_head_->lru_prev = entry;
+    lru_head_ = entry;
+  }
+  choices->deep_copy(&entry->choices, &BLOB_CHOICE::deep_copy);
+  return true;
+}
+
+void ClassifierCache::Insert(const GenericVector<inT16> &key,
+                             const BLOB_CHOICE_LIST *choices) {
+  if (!enabled() || key.empty())
+    return;
+  if (num_buckets_ == 0) {
+    num_buckets_ = kInitialBuckets;
+    buckets_ = new ClassifierCacheEntry*[num_buckets_];
+    memset(buckets_, 0, num_buckets_ * sizeof(buckets_[0]));
+  }
+  uinT32 hash = HashKey(&key[0], key.size());
+  ClassifierCacheEntry *old_entry = *Find(key, hash);
+  if (old_entry != NULL)
+    Remove(old_entry);
+
+  ClassifierCacheEntry *entry = new ClassifierCacheEntry;
+  entry->hash = hash;
+  entry->key_length = key.size();
+  entry->key = new inT16[entry->key_length];
+  memcpy(entry->key, &key[0], entry->key_length * sizeof(entry->key[0]));
+  entry->choices.deep_copy(choices, &BLOB_CHOICE::deep_copy);
+  entry->bytes = sizeof(*entry) + entry->key_length * sizeof(entry->key[0]) +
+                 entry->choices.length() * sizeof(BLOB_CHOICE);
+  if (entry->bytes > max_bytes_) {
+    delete [] entry->key;
+    delete entry;
+    return;
+  }
+
+  ClassifierCacheEntry **bucket = &buckets_[hash & (num_buckets_ - 1)];
+  entry->bucket_next = *bucket;
+  *bucket = entry;
+  entry->lru_prev = NULL;
+  entry->lru_next = lru_head_;
+  if (lru_head_ != NULL)
+    lru_head_->lru_prev = entry;
+  else
+    lru_tail_ = entry;
+  lru_head_ = entry;
+  bytes_ += entry->bytes;
+  ++num_entries_;
+
+  EvictToFit();
+  if (num_entries_ > num_buckets_)
+    Grow();
+}
+
+void ClassifierCache::Clear() {
+  ++generation_;
+  if (num_entries_ == 0)
+    return;
+  while (lru_head_ != NULL)
+    Remove(lru_head_);
+  ++invalidations_;
+}
+
+ClassifierCacheEntry **ClassifierCache::Find(const GenericVector<inT16> &key,
+                                             uinT32 hash) {
+  ClassifierCacheEntry **link = &buckets_[hash & (num_buckets_ - 1)];
+  for (; *link != NULL; link = &(*link)->bucket_next) {
+    ClassifierCacheEntry *entry = *link;
+    if (entry->hash == hash && entry->key_length == key.size() &&
+        memcmp(entry->key, &key[0],
+               entry->key_length * sizeof(entry->key[0])) == 0)
+      break;
+  }
+  return link;
+}
+
+void ClassifierCache::Remove(ClassifierCacheEntry *entry) {
+  ClassifierCacheEntry **link = &buckets_[entry->hash & (num_buckets_ - 1)];
+  while (*link != entry)
+    link = &(*link)->bucket_next;
+  *link = entry->bucket_next;
+
+  if (entry->lru_prev != NULL)
+    entry->lru_prev->lru_next = entry->lru_next;
+  else
+    lru_head_ = entry->lru_next;
+  if (entry->lru_next != NULL)
+    entry->lru_next->lru_prev = entry->lru_prev;
+  else
+    lru_tail_ = entry->lru_prev;
+
+  bytes_ -= entry->bytes;
+  --num_entries_;
+  delete [] entry->key;
+  delete entry;
+}
+
+void ClassifierCache::Grow() {
+  int new_num_buckets = num_buckets_ * 2;
+  ClassifierCacheEntry **new_buckets =
+    new ClassifierCacheEntry*[new_num_buckets];
+  memset(new_buckets, 0, new_num_buckets * sizeof(new_buckets[0]));
+  for (int b = 0; b < num_buckets_; ++b) {
+    ClassifierCacheEntry *entry = buckets_[b];
+    while (entry != NULL) {
+      ClassifierCacheEntry *next = entry->bucket_next;
+      ClassifierCacheEntry **bucket =
+        &new_buckets[entry->hash & (new_num_buckets - 1)];
+      entry->bucket_next = *bucket;
+      *bucket = entry;
+      entry = next;
+    }
+  }
+  delete [] buckets_;
+  buckets_ = new_buckets;
+  num_buckets_ = new_num_buckets;
+}
+
+void ClassifierCache::EvictToFit() {
+  while (bytes_ > max_bytes_ && lru_tail_ != NULL) {
+    Remove(lru_tail_);
+    ++evictions_;
+  }
+}
+
+}  // namespace tesseract
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////
+// File:        classifiercache.h
+// Description: Cache of adaptive classifier results keyed by blob shape.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_CLASSIFIERCACHE_H__
+#define TESSERACT_CLASSIFY_CLASSIFIERCACHE_H__
+
+#include "genericvector.h"
+#include "host.h"
+#include "ratngs.h"
+#include "tessclas.h"
+
+namespace tesseract {
+
+struct ClassifierCacheEntry;
+
+// ClassifierCache remembers the choices the adaptive classifier returned for
+// the blobs it has seen, so that a blob with exactly the same outlines, the
+// same row normalization and the same matcher mode is not classified again.
+// The key is the exact normalized input of the classifier, position
+// included, so a hit gives what classifying the blob again would. The hits
+// come from the segmentation search, which classifies the same pieces of a
+// word many times.
+// The cache holds at most max_bytes of entries and evicts the least recently
+// used ones beyond that. It knows nothing about the templates the results
+// came from: the owner must Clear it whenever they change.
+class ClassifierCache {
+ public:
+  ClassifierCache();
+  ~ClassifierCache();
+
+  // Sets the memory bound, evicting entries if it shrank. 0 disables the
+  // cache and empties it.
+  void set_max_bytes(int max_bytes);
+  bool enabled() const {
+    return max_bytes_ > 0;
+  }
+
+  // Builds the key of blob in row into key, with mode holding the bits of
+  // the matcher settings that change the result. Returns false if the blob
+  // cannot be cached, i.e. its row is not a flat normalized row or the blob
+  // is too large for the key.
+  static bool MakeKey(TBLOB *blob, TEXTROW *row, inT16 mode,
+                      GenericVector<inT16> *key);
+  // Builds into key the exact shape of blob alone, without the row.
+  // Returns false if the blob is empty or too large.
+  static bool MakeBlobKey(TBLOB *blob, GenericVector<inT16> *key);
+  // Returns the hash of a non-empty key.
+  static uinT32 Hash(const GenericVector<inT16> &key);
+
+  // Appends copies of the cached choices for key to choices and returns
+  // true, or returns false if key is not in the cache.
+  bool Lookup(const GenericVector<inT16> &key, BLOB_CHOICE_LIST *choices);
+  // Stores copies of choices as the result for key, replacing any earlier
+  // result.
+  void Insert(const GenericVector<inT16> &key,
+              const BLOB_CHOICE_LIST *choices);
+  // Removes all the entries. Counts as an invalidation if there were any.
+  void Clear();
+  // The number of calls of Clear since construction, including those that
+  // found the cache empty. As the owner clears the cache whenever its
+  // results may change, a change of it tells that they may have.
+  int generation() const {
+    return generation_;
+  }
+
+  // Statistics since construction or the last ResetStats.
+  int hits() const {
+    return hits_;
+  }
+  int misses() const {
+    return misses_;
+  }
+  int evictions() const {
+    return evictions_;
+  }
+  int invalidations() const {
+    return invalidations_;
+  }
+  int num_entries() const {
+    return num_entries_;
+  }
+  int bytes() const {
+    return bytes_;
+  }
+  void ResetStats();
+
+ private:
+  // Not copyable.
+  ClassifierCache(const ClassifierCache &);
+  ClassifierCache &operator=(const ClassifierCache &);
+
+  // Returns the bucket chain link that points to the entry for key, or to
+  // the NULL at the end of the chain if there is none.
+  ClassifierCacheEntry **Find(const GenericVector<inT16> &key, uinT32 hash);
+  // Unlinks entry from its bucket and the LRU list and deletes it.
+  void Remove(ClassifierCacheEntry *entry);
+  // Doubles the number of buckets.
+  void Grow();
+  // Removes least recently used entries until the cache fits max_bytes_.
+  void EvictToFit();
+
+  int max_bytes_;
+  int bytes_;
+  int num_entries_;
+  int num_buckets_;  // Always a power of 2, or 0 before the first Insert.
+  ClassifierCacheEntry **buckets_;
+  // Most and least recently used entries.
+  ClassifierCacheEntry *lru_head_;
+  ClassifierCacheEntry *lru_tail_;
+  int generation_;
+
+  int hits_;
+  int misses_;
+  int evictions_;
+  int invalidations_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_CLASSIFIERCACHE_H__
@@ -54,11 +54,14 @@ void delete_callback_fs(FontSet fs) {
 namespace tesseract {
 Classify::Classify()
   : INT_MEMBER(tessedit_single_match, FALSE, "Top choice only from CP"),
+    BOOL_MEMBER(tess_cn_matching, 0, "Character Normalized Matching"),
+    BOOL_MEMBER(tess_bn_matching, 0, "Baseline Normalized Matching"),
     BOOL_MEMBER(classify_enable_learning, true, "Enable adaptive classifier"),
     BOOL_MEMBER(classify_recog_devanagari, false,
                 "Whether recognizing a language with devanagari script."),
     EnableLearning(true),
     dict_(&image_) {
+  im_.set_page_stats(&page_stats);
   fontinfo_table_.set_compare_callback(
       NewPermanentCallback(compare_fontinfo));
   fontinfo_table_.set_clear_callback(
@@ -77,10 +80,47 @@ Classify::Classify()
   AllConfigsOff = NULL;
   TempProtoMask = NULL;
   NormProtos = NULL;
+  template_source_ = NULL;
+  FeaturesHaveBeenExtracted = FALSE;
+  FeaturesOK = TRUE;
+  memset(CharNormCutoffs, 0, sizeof(CharNormCutoffs));
+  memset(BaselineCutoffs, 0, sizeof(BaselineCutoffs));
+  AdaptiveMatcherCalls = 0;
+  BaselineClassifierCalls = 0;
+  CharNormClassifierCalls = 0;
+  AmbigClassifierCalls = 0;
+  NumWordsAdaptedTo = 0;
+  NumCharsAdaptedTo = 0;
+  NumBaselineClassesTried = 0;
+  NumCharNormClassesTried = 0;
+  NumAmbigClassesTried = 0;
+  NumClassesOutput = 0;
+  NumAdaptationsFailed = 0;
 }
 
 Classify::~Classify() {
   EndAdaptiveClassifier();
 }
 
+void Classify::ShareTemplatesFrom(const Classify *source) {
+  template_source_ = source;
+}
+
+void Classify::CopyFontTables(const Classify &source) {
+  for (int i = 0; i < source.fontinfo_table_.size(); ++i) {
+    FontInfo fi = source.fontinfo_table_.get(i);
+    char *name = new char[strlen(fi.name) + 1];
+    strcpy(name, fi.name);
+    fi.name = name;
+    fontinfo_table_.push_back(fi);
+  }
+  for (int i = 0; i < source.fontset_table_.size(); ++i) {
+    FontSet fs = source.fontset_table_.get(i);
+    int *configs = new int[fs.size];
+    memcpy(configs, fs.configs, fs.size * sizeof(*configs));
+    fs.configs = configs;
+    fontset_table_.push_back(fs);
+  }
+}
+
 }  // namespace tesseract
@@ -21,9 +21,12 @@
 
 #include "adaptive.h"
 #include "ccstruct.h"
+#include "classifiercache.h"
 #include "classify.h"
 #include "dict.h"
+#include "featurestore.h"
 #include "fxdefs.h"
+#include "intfx.h"
 #include "intmatcher.h"
 #include "ratngs.h"
 #include "ocrfeatures.h"
@@ -41,6 +44,9 @@ class Classify : public CCStruct {
   Dict& getDict() {
     return dict_;
   }
+  const Dict& getDict() const {
+    return dict_;
+  }
   /* adaptive.cpp ************************************************************/
   ADAPT_TEMPLATES NewAdaptedTemplates(bool InitFromUnicharset);
   int ClassPruner(INT_TEMPLATES IntTemplates,
@@ -55,6 +61,8 @@ class Classify : public CCStruct {
   void PrintAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   void WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   ADAPT_TEMPLATES ReadAdaptedTemplates(FILE *File);
+  char *WriteAdaptedSnapshot(ADAPT_TEMPLATES Templates, int *Length);
+  ADAPT_TEMPLATES ReadAdaptedSnapshot(const char *Data, int Length);
   /* normmatch.cpp ************************************************************/
   FLOAT32 ComputeNormMatch(CLASS_ID ClassId, FEATURE Feature, BOOL8 DebugMatch);
   void FreeNormProtos();
@@ -71,6 +79,12 @@ class Classify : public CCStruct {
                    const WERD_CHOICE& BestRawChoice,
                    const char *rejmap);
   void InitAdaptiveClassifier();
+  // Makes InitAdaptiveClassifier borrow the pre-trained templates, the
+  // normalization protos and the font tables of source, and copy its
+  // cutoffs, instead of reading them from the traineddata file. The source
+  // classifier must stay initialized for as long as this one uses its
+  // templates. Pass NULL to go back to loading private copies.
+  void ShareTemplatesFrom(const Classify *source);
   void InitAdaptedClass(TBLOB *Blob,
                         LINE_STATS *LineStats,
                         CLASS_ID ClassId,
@@ -147,6 +161,7 @@ class Classify : public CCStruct {
                    LINE_STATS *LineStats,
                    CLASS_ID ClassId,
                    FLOAT32 Threshold);
+  void SetAdaptiveThreshold(FLOAT32 Threshold);
   int AdaptableWord(TWERD *Word,
                   const WERD_CHOICE &BestChoiceWord,
                   const WERD_CHOICE &RawChoiceWord);
@@ -161,10 +176,60 @@ class Classify : public CCStruct {
                           CLASS_PRUNER_RESULTS cp_results);
   void ClassifyAsNoise(ADAPT_RESULTS *Results);
   void ResetAdaptiveClassifier();
+  // Resets the adapted templates if too many adaptations have failed, as
+  // AdaptiveClassifier does before it classifies a blob.
+  void ResetIfAdaptationsFailed();
+  // Reads adapted templates saved by EndAdaptiveClassifier, in either the
+  // snapshot or the older format. Returns NULL if they do not fit.
+  ADAPT_TEMPLATES ReadAdaptedTemplatesFile(FILE *File);
+  // Returns a snapshot of the adapted templates, of *length bytes, to be
+  // freed with delete [], or NULL if the adaptive classifier is not in use.
+  char *ExportAdaptiveClassifier(int *length);
+  // Replaces the adapted templates with those of a snapshot made by
+  // ExportAdaptiveClassifier of a classifier of the same language, and
+  // forgets the cached classifier results. Returns false, leaving the
+  // templates unchanged, if the snapshot does not fit this classifier.
+  bool ImportAdaptiveClassifier(const char *data, int length);
+  // Gives other, a classifier of the same language, the enabled unichars
+  // and the matcher settings of this one, and the adapted templates of the
+  // snapshot templates, if it is not NULL, so that it classifies blobs as
+  // this one does.
+  void CopyClassifierState(const char *templates, int templates_length,
+                           Classify *other);
+  // Changes whenever the results of the classifier may have changed, with
+  // its adapted templates or its enabled unichars.
+  int classifier_changes() const {
+    return classifier_cache_.generation();
+  }
+  // Starts a new page for the classifier result cache, which forgets the
+  // results of the previous page unless classify_cache_across_pages is set.
+  void StartClassifierCachePage();
+  const ClassifierCache &classifier_cache() const {
+    return classifier_cache_;
+  }
+  // Starts a new word for the store of extracted blob features, which
+  // forgets the features of the previous word unless
+  // classify_feature_store_per_page is set.
+  void StartFeatureStoreWord();
+  const FeatureStore &feature_store() const {
+    return feature_store_;
+  }
 
   FLOAT32 GetBestRatingFor(TBLOB *Blob,
                            LINE_STATS *LineStats,
                            CLASS_ID ClassId);
+  int GetBaselineFeatures(TBLOB *Blob,
+                          LINE_STATS *LineStats,
+                          INT_TEMPLATES Templates,
+                          INT_FEATURE_ARRAY IntFeatures,
+                          CLASS_NORMALIZATION_ARRAY CharNormArray,
+                          inT32 *BlobLength);
+  int GetIntBaselineFeatures(TBLOB *Blob,
+                             LINE_STATS *LineStats,
+                             INT_TEMPLATES Templates,
+                             INT_FEATURE_ARRAY IntFeatures,
+                             CLASS_NORMALIZATION_ARRAY CharNormArray,
+                             inT32 *BlobLength);
   int GetCharNormFeatures(TBLOB *Blob,
                           LINE_STATS *LineStats,
                           INT_TEMPLATES Templates,
@@ -177,6 +242,9 @@ class Classify : public CCStruct {
                              INT_FEATURE_ARRAY IntFeatures,
                              CLASS_NORMALIZATION_ARRAY CharNormArray,
                              inT32 *BlobLength);
+  // Fills BaselineFeatures, CharNormFeatures, FXInfo and FeaturesOK for
+  // Blob, from the feature store if the blob was extracted before.
+  void ExtractStoredIntFeatures(TBLOB *Blob);
 
   /* float2int.cpp ************************************************************/
   void ComputeIntCharNormArray(FEATURE NormFeature,
@@ -197,6 +265,9 @@ class Classify : public CCStruct {
   /* adaptmatch.cpp ***********************************************************/
   /* name of current image file being processed */
   INT_VAR_H(tessedit_single_match, FALSE, "Top choice only from CP");
+  // Matcher modes set by the callers of AdaptiveClassifier for each blob.
+  BOOL_VAR_H(tess_cn_matching, 0, "Character Normalized Matching");
+  BOOL_VAR_H(tess_bn_matching, 0, "Baseline Normalized Matching");
   /* use class variables to hold onto built-in templates and adapted
      templates */
   INT_TEMPLATES PreTrainedTemplates;
@@ -219,11 +290,60 @@ class Classify : public CCStruct {
   bool EnableLearning;
   /* normmatch.cpp */
   NORM_PROTOS *NormProtos;
+  /* intmatcher.cpp ***********************************************************/
+  IntegerMatcher im_;
   /* font detection ***********************************************************/
   UnicityTable<FontInfo> fontinfo_table_;
   UnicityTable<FontSet> fontset_table_;
  private:
+  // Copies the font tables of source into the (empty) tables of this.
+  void CopyFontTables(const Classify &source);
+
+  // Average number of features of each class, read from the pffmtable.
+  CLASS_CUTOFF_ARRAY CharNormCutoffs;
+  CLASS_CUTOFF_ARRAY BaselineCutoffs;
+  // Statistics of the adaptive matcher, printed by PrintAdaptiveStatistics.
+  int AdaptiveMatcherCalls;
+  int BaselineClassifierCalls;
+  int CharNormClassifierCalls;
+  int AmbigClassifierCalls;
+  int NumWordsAdaptedTo;
+  int NumCharsAdaptedTo;
+  int NumBaselineClassesTried;
+  int NumCharNormClassesTried;
+  int NumAmbigClassesTried;
+  int NumClassesOutput;
+  int NumAdaptationsFailed;
+
   Dict dict_;
+  // Classifier whose PreTrainedTemplates and NormProtos are borrowed, or NULL
+  // if this classifier owns its own.
+  const Classify *template_source_;
+  // Work arrays for ClassPruner, owned by the instance so that ClassPruner
+  // is re-entrant across separate Classify objects.
+  int cp_class_count_[MAX_NUM_CLASSES];
+  int cp_norm_count_[MAX_NUM_CLASSES];
+  int cp_sort_key_[MAX_NUM_CLASSES + 1];
+  int cp_sort_index_[MAX_NUM_CLASSES + 1];
+  int cp_key_count_[MAX_CP_SORT_RANGE];
+  // Integer features of the blob being classified. The baseline and char
+  // norm features are extracted together on first use and kept here until
+  // the next blob, so each instance can classify independently.
+  BOOL8 FeaturesHaveBeenExtracted;
+  BOOL8 FeaturesOK;
+  INT_FEATURE_ARRAY BaselineFeatures;
+  INT_FEATURE_ARRAY CharNormFeatures;
+  INT_FX_RESULT_STRUCT FXInfo;
+  // Results of AdaptiveClassifier for the blobs seen since the adapted
+  // templates last changed, the key of the blob being classified and the
+  // enabled unichars the results were found with.
+  ClassifierCache classifier_cache_;
+  GenericVector<inT16> cache_key_;
+  GenericVector<bool> cache_enabled_;
+  // Integer features of the blobs of the current word or page, and the key
+  // of the blob being extracted.
+  FeatureStore feature_store_;
+  GenericVector<inT16> feature_key_;
 };
 }  // namespace tesseract
 
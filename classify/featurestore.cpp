@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////
+// File:        featurestore.cpp
+// Description: Store of the integer features extracted from blobs.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "featurestore.h"
+
+#include <string.h>
+
+#include "classifiercache.h"
+
+namespace tesseract {
+
+// Number of buckets of the hash table at the first Insert.
+const int kInitialFeatureBuckets = 64;
+
+struct FeatureStoreEntry {
+  uinT32 hash;
+  inT16 *key;
+  int key_length;
+  int bytes;
+  BOOL8 fx_ok;
+  INT_FX_RESULT_STRUCT fx_info;
+  // The NumBL baseline features followed by the NumCN char norm features,
+  // or NULL if fx_ok is FALSE.
+  INT_FEATURE_STRUCT *features;
+  FeatureStoreEntry *bucket_next;
+};
+
+FeatureStore::FeatureStore()
+  : max_bytes_(0), bytes_(0), num_entries_(0), num_buckets_(0),
+    buckets_(NULL) {
+  ResetStats();
+}
+
+FeatureStore::~FeatureStore() {
+  Clear();
+  delete [] buckets_;
+}
+
+void FeatureStore::set_max_bytes(int max_bytes) {
+  if (max_bytes < 0)
+    max_bytes = 0;
+  max_bytes_ = max_bytes;
+  if (bytes_ > max_bytes_)
+    Clear();
+}
+
+void FeatureStore::ResetStats() {
+  hits_ = 0;
+  misses_ = 0;
+}
+
+bool FeatureStore::Lookup(const GenericVector<inT16> &key,
+                          INT_FEATURE_ARRAY bl_features,
+                          INT_FEATURE_ARRAY cn_features,
+                          INT_FX_RESULT_STRUCT *fx_info, BOOL8 *fx_ok) {
+  FeatureStoreEntry *entry = NULL;
+  if (num_entries_ > 0 && !key.empty())
+    entry = Find(key, ClassifierCache::Hash(key));
+  if (entry == NULL) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  *fx_info = entry->fx_info;
+  *fx_ok = entry->fx_ok;
+  if (entry->fx_ok) {
+    memcpy(bl_features, entry->features,
+           entry->fx_info.NumBL * sizeof(INT_FEATURE_STRUCT));
+    memcpy(cn_features, entry->features + entry->fx_info.NumBL,
+           entry->fx_info.NumCN * sizeof(INT_FEATURE_STRUCT));
+  }
+  return true;
+}
+
+void FeatureStore::Insert(const GenericVector<inT16> &key,
+                          const INT_FEATURE_STRUCT *bl_features,
+                          const INT_FEATURE_STRUCT *cn_features,
+                          const INT_FX_RESULT_STRUCT &fx_info, BOOL8 fx_ok) {
+  if (!enabled() || key.empty())
+    return;
+  uinT32 hash = ClassifierCache::Hash(key);
+  if (num_buckets_ > 0 && Find(key, hash) != NULL)
+    return;  // The features of a blob never change.
+  int num_features = fx_ok ? fx_info.NumBL + fx_info.NumCN : 0;
+  int bytes = sizeof(FeatureStoreEntry) + key.size() * sizeof(inT16) +
+              num_features * sizeof(INT_FEATURE_STRUCT);
+  if (bytes > max_bytes_)
+    return;
+  if (bytes_ + bytes > max_bytes_)
+    Clear();
+  if (num_buckets_ == 0) {
+    num_buckets_ = kInitialFeatureBuckets;
+    buckets_ = new FeatureStoreEntry*[num_buckets_];
+    memset(buckets_, 0, num_buckets_ * sizeof(buckets_[0]));
+  }
+
+  FeatureStoreEntry *entry = new FeatureStoreEntry;
+  entry->hash = hash;
+  entry->key_length = key.size();
+  entry->key = new inT16[entry->key_length];
+  memcpy(entry->key, &key[0], entry->key_length * sizeof(entry->key[0]));
+  entry->bytes = bytes;
+  entry->fx_ok = fx_ok;
+  entry->fx_info = fx_info;
+  entry->features = NULL;
+  if (fx_ok) {
+    entry->features = new INT_FEATURE_STRUCT[num_features];
+    memcpy(entry->features, bl_features,
+           fx_info.NumBL * sizeof(INT_FEATURE_STRUCT));
+    memcpy(entry->features + fx_info.NumBL, cn_features,
+           fx_info.NumCN * sizeof(INT_FEATURE_STRUCT));
+  }
+  FeatureStoreEntry **bucket = &buckets_[hash & (num_buckets_ - 1)];
+  entry->bucket_next = *bucket;
+  *bucket = entry;
+  bytes_ += bytes;
+  ++num_entries_;
+  if (num_entries_ > num_buckets_)
+    Grow();
+}
+
+void FeatureStore::Clear() {
+  for (int b = 0; b < num_buckets_ && num_entries_ > 0; ++b) {
+    while (buckets_[b] != NULL) {
+      FeatureStoreEntry *entry = buckets_[b];
+      buckets_[b] = entry->bucket_next;
+      delete [] entry->key;
+      delete [] entry->features;
+      delete entry;
+      --num_entries_;
+    }
+  }
+  bytes_ = 0;
+}
+
+FeatureStoreEntry *FeatureStore::Find(const GenericVector<inT16> &key,
+                                      uinT32 hash) const {
+  FeatureStoreEntry *entry = buckets_[hash & (num_buckets_ - 1)];
+  for (; entry != NULL; entry = entry->bucket_next) {
+    if (entry->hash == hash && entry->key_length == key.size() &&
+        memcmp(entry->key, &key[0],
+               entry->key_length * sizeof(entry->key[0])) == 0)
+      break;
+  }
+  return entry;
+}
+
+void FeatureStore::Grow() {
+  int new_num_buckets = num_buckets_ * 2;
+  FeatureStoreEntry **new_buckets = new FeatureStoreEntry*[new_num_buckets];
+  memset(new_buckets, 0, new_num_buckets * sizeof(new_buckets[0]));
+  for (int b = 0; b < num_buckets_; ++b) {
+    FeatureStoreEntry *entry = buckets_[b];
+    while (entry != NULL) {
+      FeatureStoreEntry *next = entry->bucket_next;
+      FeatureStoreEntry **bucket =
+        &new_buckets[entry->hash & (new_num_buckets - 1)];
+      entry->bucket_next = *bucket;
+      *bucket = entry;
+      entry = next;
+    }
+  }
+  delete [] buckets_;
+  buckets_ = new_buckets;
+  num_buckets_ = new_num_buckets;
+}
+
+}  // namespace tesseract
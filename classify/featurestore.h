@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////
+// File:        featurestore.h
+// Description: Store of the integer features extracted from blobs.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_FEATURESTORE_H__
+#define TESSERACT_CLASSIFY_FEATURESTORE_H__
+
+#include "genericvector.h"
+#include "host.h"
+#include "intfx.h"
+#include "intproto.h"
+
+namespace tesseract {
+
+struct FeatureStoreEntry;
+
+// FeatureStore keeps the baseline and character normalized features that
+// ExtractIntFeat returned for the blobs of the current word (or page), so
+// that a blob classified again, by a later classifier of the same call or
+// after the adapted templates changed, is not feature-extracted again.
+// Blobs are keyed by their exact normalized outlines (see
+// ClassifierCache::MakeBlobKey), which is all the features depend on, so
+// the store never has to be invalidated; the owner clears it only to bound
+// its lifetime. When an Insert would take it over max_bytes, the store is
+// emptied first.
+class FeatureStore {
+ public:
+  FeatureStore();
+  ~FeatureStore();
+
+  // Sets the memory bound, emptying the store if it no longer fits. 0
+  // disables the store.
+  void set_max_bytes(int max_bytes);
+  bool enabled() const {
+    return max_bytes_ > 0;
+  }
+
+  // If key is in the store, copies its features into bl_features and
+  // cn_features, its results into *fx_info and the return value of
+  // ExtractIntFeat into *fx_ok, and returns true. Returns false otherwise.
+  bool Lookup(const GenericVector<inT16> &key,
+              INT_FEATURE_ARRAY bl_features,
+              INT_FEATURE_ARRAY cn_features,
+              INT_FX_RESULT_STRUCT *fx_info, BOOL8 *fx_ok);
+  // Stores the result of ExtractIntFeat for key. The features are only
+  // kept if fx_ok is TRUE.
+  void Insert(const GenericVector<inT16> &key,
+              const INT_FEATURE_STRUCT *bl_features,
+              const INT_FEATURE_STRUCT *cn_features,
+              const INT_FX_RESULT_STRUCT &fx_info, BOOL8 fx_ok);
+  // Removes all the entries.
+  void Clear();
+
+  // Statistics since construction or the last ResetStats.
+  int hits() const {
+    return hits_;
+  }
+  int misses() const {
+    return misses_;
+  }
+  int num_entries() const {
+    return num_entries_;
+  }
+  int bytes() const {
+    return bytes_;
+  }
+  void ResetStats();
+
+ private:
+  // Not copyable.
+  FeatureStore(const FeatureStore &);
+  FeatureStore &operator=(const FeatureStore &);
+
+  // Returns the entry for key, or NULL if there is none.
+  FeatureStoreEntry *Find(const GenericVector<inT16> &key, uinT32 hash) const;
+  // Doubles the number of buckets.
+  void Grow();
+
+  int max_bytes_;
+  int bytes_;
+  int num_entries_;
+  int num_buckets_;  // Always a power of 2, or 0 before the first Insert.
+  FeatureStoreEntry **buckets_;
+
+  int hits_;
+  int misses_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_FEATURESTORE_H__
@@ -92,10 +92,12 @@ void Classify::ComputeIntCharNormArray(
 }  // namespace tesseract
 
 /*---------------------------------------------------------------------------*/
-void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY IntFeatures) {
+void ComputeIntFeatures(FEATURE_SET Features, NORM_METHOD NormMethod,
+                        INT_FEATURE_ARRAY IntFeatures) {
 /*
  **	Parameters:
  **		Features	floating point pico-features to be converted
+ **		NormMethod	normalization method the features were made with
  **		IntFeatures	array to put converted features into
  **	Globals: none
  **	Operation: This routine converts each floating point pico-feature
@@ -109,7 +111,7 @@ void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY IntFeatures) {
   FEATURE Feature;
   FLOAT32 YShift;
 
-  if (classify_norm_method == baseline)
+  if (NormMethod == baseline)
     YShift = BASELINE_Y_SHIFT;
   else
     YShift = Y_SHIFT;
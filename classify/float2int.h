@@ -23,6 +23,7 @@
 ----------------------------------------------------------------------------**/
 #include "intmatcher.h"
 #include "ocrfeatures.h"
+#include "mfoutline.h"
 
 #define INT_FEAT_RANGE    256
 #define BASELINE_Y_SHIFT  (0.25)
@@ -35,6 +36,7 @@ void ClearCharNormArray(INT_TEMPLATES Templates,
                         CLASS_NORMALIZATION_ARRAY CharNormArray);
 }  // namespace tesseract.
 
-void ComputeIntFeatures(FEATURE_SET Features, INT_FEATURE_ARRAY IntFeatures);
+void ComputeIntFeatures(FEATURE_SET Features, NORM_METHOD NormMethod,
+                        INT_FEATURE_ARRAY IntFeatures);
 
 #endif
@@ -22,12 +22,6 @@
 #include "picofeat.h"
 #include "normfeat.h"
 
-/**----------------------------------------------------------------------------
-        Global Data Definitions and Declarations
-----------------------------------------------------------------------------**/
-/* flag to control learn mode vs. classify mode */
-int ExtractMode;
-
 // Definitions of extractors separated from feature definitions.
 DefineFeatureExt (MicroFeatureExt, ExtractMicros)
 DefineFeatureExt (PicoFeatExt, NULL)
@@ -24,10 +24,6 @@
 #include "tessclas.h"
 #include "general.h"
 
-/* define different modes for feature extractor - learning vs. classifying */
-#define LEARN_MODE      0
-#define CLASSIFY_MODE   1
-
 /* define a data structure to hold line statistics.  These line statistics
   are used to normalize character outlines to a standard size and position
   relative to the baseline of the text. */
@@ -53,16 +49,6 @@ LINE_STATS;
   of this data structure. */
 typedef char *CHAR_FEATURES;
 
-/**----------------------------------------------------------------------------
-            Macros
-----------------------------------------------------------------------------**/
-/* macro to change and monitor the mode of the feature extractor.
-  In general, learn mode smears features which would otherwise be discrete
-  in nature; classify mode does not.*/
-#define SetExtractMode(M) (ExtractMode = (M))
-#define EnterLearnMode    (SetExtractMode (LEARN_MODE))
-#define EnterClassifyMode (SetExtractMode (CLASSIFY_MODE))
-
 /*----------------------------------------------------------------------------
           Public Function Prototypes
 -----------------------------------------------------------------------------*/
@@ -84,10 +70,4 @@ void GetLineStatsFromRow
 
 #undef _ARGS
 */
-
-/**----------------------------------------------------------------------------
-        Global Data Definitions and Declarations
-----------------------------------------------------------------------------**/
-/* flag to control learn mode vs. classify mode */
-extern int ExtractMode;
 #endif
@@ -21,6 +21,8 @@
 #include "intfx.h"
 #include "intmatcher.h"
 #include "const.h"
+#include "emalloc.h"
+#include <string.h>
 #ifdef __UNIX__
 #endif
 
@@ -70,15 +72,76 @@ int ExtractIntFeat(TBLOB *Blob,
                    INT_FEATURE_ARRAY BLFeat,
                    INT_FEATURE_ARRAY CNFeat,
                    INT_FX_RESULT Results) {
+/*
+ **      Parameters:
+ **              Blob            blob to extract features from
+ **              BLFeat          baseline normalized features
+ **              CNFeat          character normalized features
+ **              Results         length, center of mass and radius of
+ **                              gyration of the outlines
+ **      Operation:
+ **              The outlines are copied once into a flat array of points.
+ **              One pass over it finds the center of mass and samples the
+ **              baseline features, which are then moved to the center of
+ **              mass while the second moments are summed; a second pass
+ **              samples the character normalized features.
+ **      Return: FALSE if the blob has a bad loop, no length or too many
+ **              features, else TRUE.
+ */
+  INT_FX_POINT LocalPoints[MAX_LOCAL_FX_POINTS];
+  INT_FX_POINT *Points;
+  int NumPoints;
+  int Result;
 
-  TESSLINE *OutLine;
-  EDGEPT *Loop, *LoopStart, *Segment;
+  Results->Length = 0;
+  Results->Xmean = 0;
+  Results->Ymean = 0;
+  Results->Rx = 0;
+  Results->Ry = 0;
+  Results->NumBL = 0;
+  Results->NumCN = 0;
+
+  Points = LocalPoints;
+  NumPoints = FlattenOutlines (Blob, &Points);
+  if (NumPoints < 0)
+    return FALSE;
+  Result = ExtractFlatIntFeat (Points, NumPoints, BLFeat, CNFeat, Results);
+  if (Points != LocalPoints)
+    Efree(Points);
+  return Result;
+}
+
+
+/*--------------------------------------------------------------------------*/
+int ExtractFlatIntFeat(const INT_FX_POINT *Points,
+                       int NumPoints,
+                       INT_FEATURE_ARRAY BLFeat,
+                       INT_FEATURE_ARRAY CNFeat,
+                       INT_FX_RESULT Results) {
+/*
+ **      Parameters:
+ **              Points          outline points made by FlattenOutlines
+ **              NumPoints       number of points
+ **              BLFeat          baseline normalized features
+ **              CNFeat          character normalized features
+ **              Results         length, center of mass and radius of
+ **                              gyration of the outlines, which must
+ **                              have been cleared
+ **      Operation: See ExtractIntFeat.
+ **      Return: FALSE if the outlines have no length or too many
+ **              features, else TRUE.
+ */
+  const INT_FX_POINT *Point;
+  inT32 SampleX[MAX_NUM_INT_FEATURES];
+  inT32 SampleY[MAX_NUM_INT_FEATURES];
+  uinT8 SampleTheta[MAX_NUM_INT_FEATURES];
   inT16 LastX, LastY, Xmean, Ymean;
   inT32 NormX, NormY, DeltaX, DeltaY;
   inT32 Xsum, Ysum;
   uinT32 Ix, Iy, LengthSum;
   uinT16 n;
   uinT8 Theta;
+  int NumSamples;
   uinT16 NumBLFeatures, NumCNFeatures;
   uinT8 RxInv, RyInv;            /* x.xxxxxxx  *  2^Exp  */
   uinT8 RxExp, RyExp;
@@ -87,37 +150,22 @@ int ExtractIntFeat(TBLOB *Blob,
   uinT16 Length;
   register int i;
 
-  Results->Length = 0;
-  Results->Xmean = 0;
-  Results->Ymean = 0;
-  Results->Rx = 0;
-  Results->Ry = 0;
-  Results->NumBL = 0;
-  Results->NumCN = 0;
-
-  /* find Xmean, Ymean */
-  NumBLFeatures = 0;
-  NumCNFeatures = 0;
-  OutLine = Blob->outlines;
+  /* find Xmean, Ymean and sample the baseline features */
   Xsum = 0;
   Ysum = 0;
   LengthSum = 0;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = Loop->pos.x;
-    LastY = Loop->pos.y;
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
+  NumSamples = 0;
+  Point = Points;
+  while (Point < Points + NumPoints) {
+    LastX = Point->X;
+    LastY = Point->Y;
     do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = Loop->pos.x;
-      NormY = Loop->pos.y;
+      Point++;
+      NormX = Point->X;
+      NormY = Point->Y;
 
       n = 1;
-      if (!is_hidden_edge (Segment)) {
+      if (!Point[-1].Hidden) {
         DeltaX = NormX - LastX;
         DeltaY = NormY - LastY;
         Length = MySqrt (DeltaX, DeltaY);
@@ -126,6 +174,21 @@ int ExtractIntFeat(TBLOB *Blob,
           Xsum += ((LastX << 1) + DeltaX) * (int) Length;
           Ysum += ((LastY << 1) + DeltaY) * (int) Length;
           LengthSum += Length;
+          Theta = TableLookup (DeltaY, DeltaX);
+          dX = (DeltaX << 8) / n;
+          dY = (DeltaY << 8) / n;
+          pfX = (LastX << 8) + (dX >> 1);
+          pfY = (LastY << 8) + (dY >> 1);
+          for (i = 0; i < n; i++) {
+            if (NumSamples < MAX_NUM_INT_FEATURES) {
+              SampleX[NumSamples] = pfX >> 8;
+              SampleY[NumSamples] = pfY >> 8;
+              SampleTheta[NumSamples] = Theta;
+            }
+            NumSamples++;
+            pfX += dX;
+            pfY += dY;
+          }
         }
       }
       if (n != 0) {              /* Throw away a point that is too close */
@@ -133,8 +196,8 @@ int ExtractIntFeat(TBLOB *Blob,
         LastY = NormY;
       }
     }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
+    while (!Point->LoopEnd);
+    Point++;
   }
   if (LengthSum == 0)
     return FALSE;
@@ -144,67 +207,21 @@ int ExtractIntFeat(TBLOB *Blob,
   Results->Length = LengthSum;
   Results->Xmean = Xmean;
   Results->Ymean = Ymean;
+  if (NumSamples > MAX_NUM_INT_FEATURES)
+    return FALSE;
 
-  /* extract Baseline normalized features,     */
-  /* and find 2nd moments & radius of gyration */
+  /* save the baseline normalized features relative to Xmean, */
+  /* and find 2nd moments & radius of gyration                */
   Ix = 0;
   Iy = 0;
-  NumBLFeatures = 0;
-  OutLine = Blob->outlines;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = Loop->pos.x - Xmean;
-    LastY = Loop->pos.y;
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
-    do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = Loop->pos.x - Xmean;
-      NormY = Loop->pos.y;
-
-      n = 1;
-      if (!is_hidden_edge (Segment)) {
-        DeltaX = NormX - LastX;
-        DeltaY = NormY - LastY;
-        Length = MySqrt (DeltaX, DeltaY);
-        n = ((Length << 2) + Length + 32) >> 6;
-        if (n != 0) {
-          Theta = TableLookup (DeltaY, DeltaX);
-          dX = (DeltaX << 8) / n;
-          dY = (DeltaY << 8) / n;
-          pfX = (LastX << 8) + (dX >> 1);
-          pfY = (LastY << 8) + (dY >> 1);
-          Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
-          Iy += (pfX >> 8) * (pfX >> 8);
-          if (SaveFeature (BLFeat, NumBLFeatures, (inT16) (pfX >> 8),
-            (inT16) ((pfY >> 8) - 128),
-            Theta) == FALSE)
-            return FALSE;
-          NumBLFeatures++;
-          for (i = 1; i < n; i++) {
-            pfX += dX;
-            pfY += dY;
-            Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
-            Iy += (pfX >> 8) * (pfX >> 8);
-            if (SaveFeature
-              (BLFeat, NumBLFeatures, (inT16) (pfX >> 8),
-              (inT16) ((pfY >> 8) - 128), Theta) == FALSE)
-              return FALSE;
-            NumBLFeatures++;
-          }
-        }
-      }
-      if (n != 0) {              /* Throw away a point that is too close */
-        LastX = NormX;
-        LastY = NormY;
-      }
-    }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
+  for (i = 0; i < NumSamples; i++) {
+    SampleX[i] -= Xmean;
+    Ix += (SampleY[i] - Ymean) * (SampleY[i] - Ymean);
+    Iy += SampleX[i] * SampleX[i];
+    SaveFeature (BLFeat, i, (inT16) SampleX[i], (inT16) (SampleY[i] - 128),
+                 SampleTheta[i]);
   }
+  NumBLFeatures = NumSamples;
   if (Ix == 0)
     Ix = 1;
   if (Iy == 0)
@@ -226,27 +243,21 @@ int ExtractIntFeat(TBLOB *Blob,
 
   /* extract character normalized features */
   NumCNFeatures = 0;
-  OutLine = Blob->outlines;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = (Loop->pos.x - Xmean) * RyInv;
-    LastY = (Loop->pos.y - Ymean) * RxInv;
+  Point = Points;
+  while (Point < Points + NumPoints) {
+    LastX = (Point->X - Xmean) * RyInv;
+    LastY = (Point->Y - Ymean) * RxInv;
     LastX >>= (inT8) RyExp;
     LastY >>= (inT8) RxExp;
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
     do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = (Loop->pos.x - Xmean) * RyInv;
-      NormY = (Loop->pos.y - Ymean) * RxInv;
+      Point++;
+      NormX = (Point->X - Xmean) * RyInv;
+      NormY = (Point->Y - Ymean) * RxInv;
       NormX >>= (inT8) RyExp;
       NormY >>= (inT8) RxExp;
 
       n = 1;
-      if (!is_hidden_edge (Segment)) {
+      if (!Point[-1].Hidden) {
         DeltaX = NormX - LastX;
         DeltaY = NormY - LastY;
         Length = MySqrt (DeltaX, DeltaY);
@@ -257,18 +268,13 @@ int ExtractIntFeat(TBLOB *Blob,
           dY = (DeltaY << 8) / n;
           pfX = (LastX << 8) + (dX >> 1);
           pfY = (LastY << 8) + (dY >> 1);
-          if (SaveFeature (CNFeat, NumCNFeatures, (inT16) (pfX >> 8),
-            (inT16) ((pfY >> 8)), Theta) == FALSE)
-            return FALSE;
-          NumCNFeatures++;
-          for (i = 1; i < n; i++) {
-            pfX += dX;
-            pfY += dY;
-            if (SaveFeature
-              (CNFeat, NumCNFeatures, (inT16) (pfX >> 8),
+          for (i = 0; i < n; i++) {
+            if (SaveFeature (CNFeat, NumCNFeatures, (inT16) (pfX >> 8),
               (inT16) ((pfY >> 8)), Theta) == FALSE)
               return FALSE;
             NumCNFeatures++;
+            pfX += dX;
+            pfY += dY;
           }
         }
       }
@@ -277,8 +283,8 @@ int ExtractIntFeat(TBLOB *Blob,
         LastY = NormY;
       }
     }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
+    while (!Point->LoopEnd);
+    Point++;
   }
 
   Results->NumCN = NumCNFeatures;
@@ -286,6 +292,71 @@ int ExtractIntFeat(TBLOB *Blob,
 }
 
 
+/*--------------------------------------------------------------------------*/
+int FlattenOutlines(TBLOB *Blob, INT_FX_POINT **Points) {
+/*
+ **      Parameters:
+ **              Blob            blob whose outlines are to be copied
+ **              Points          array of MAX_LOCAL_FX_POINTS points to
+ **                              fill, replaced by a larger array from
+ **                              Emalloc if it is too small
+ **      Operation:
+ **              Copies the points of each top level outline of the blob
+ **              into *Points, followed by a copy of its first point with
+ **              LoopEnd set, which closes the loop. Hidden is set on each
+ **              point that starts a hidden edge.
+ **      Return: The number of points copied, or -1 if an outline has a
+ **              bad loop, in which case *Points is left as it was.
+ */
+  TESSLINE *OutLine;
+  EDGEPT *Loop, *LoopStart;
+  INT_FX_POINT *Array;
+  INT_FX_POINT *NewArray;
+  int NumPoints;
+  int MaxPoints;
+  int Start;
+
+  Array = *Points;
+  NumPoints = 0;
+  MaxPoints = MAX_LOCAL_FX_POINTS;
+  for (OutLine = Blob->outlines; OutLine != NULL; OutLine = OutLine->next) {
+    LoopStart = OutLine->loop;
+    /* Check for bad loops */
+    if ((LoopStart == NULL) || (LoopStart->next == NULL) ||
+        (LoopStart->next == LoopStart)) {
+      if (Array != *Points)
+        Efree(Array);
+      return -1;
+    }
+    Start = NumPoints;
+    Loop = LoopStart;
+    do {
+      /* keep room for the point that closes the loop */
+      if (NumPoints + 1 >= MaxPoints) {
+        MaxPoints *= 2;
+        NewArray = (INT_FX_POINT *) Emalloc (MaxPoints * sizeof (INT_FX_POINT));
+        memcpy(NewArray, Array, NumPoints * sizeof (INT_FX_POINT));
+        if (Array != *Points)
+          Efree(Array);
+        Array = NewArray;
+      }
+      Array[NumPoints].X = Loop->pos.x;
+      Array[NumPoints].Y = Loop->pos.y;
+      Array[NumPoints].Hidden = is_hidden_edge (Loop) != 0;
+      Array[NumPoints].LoopEnd = FALSE;
+      NumPoints++;
+      Loop = Loop->next;
+    }
+    while (Loop != LoopStart);
+    Array[NumPoints] = Array[Start];
+    Array[NumPoints].LoopEnd = TRUE;
+    NumPoints++;
+  }
+  *Points = Array;
+  return NumPoints;
+}
+
+
 /*--------------------------------------------------------------------------*/
 uinT8 TableLookup(inT32 Y, inT32 X) {
   inT16 Angle;
@@ -37,6 +37,22 @@ typedef struct
 
 INT_FX_RESULT_STRUCT, *INT_FX_RESULT;
 
+/* A point of a blob outline in the flat copy made by FlattenOutlines.
+   Hidden is set if the edge from this point to the next one is hidden.
+   Each loop ends with a copy of its first point that has LoopEnd set. */
+typedef struct
+{
+  inT16 X, Y;
+  uinT8 Hidden;
+  uinT8 LoopEnd;
+}
+
+
+INT_FX_POINT;
+
+/* number of points that ExtractIntFeat copies without allocating */
+#define MAX_LOCAL_FX_POINTS  1024
+
 /**----------------------------------------------------------------------------
           Public Function Prototypes
 ----------------------------------------------------------------------------**/
@@ -47,6 +63,14 @@ int ExtractIntFeat(TBLOB *Blob,
                    INT_FEATURE_ARRAY CNFeat,
                    INT_FX_RESULT Results);
 
+int ExtractFlatIntFeat(const INT_FX_POINT *Points,
+                       int NumPoints,
+                       INT_FEATURE_ARRAY BLFeat,
+                       INT_FEATURE_ARRAY CNFeat,
+                       INT_FX_RESULT Results);
+
+int FlattenOutlines(TBLOB *Blob, INT_FX_POINT **Points);
+
 uinT8 TableLookup(inT32 Y, inT32 X);
 
 int SaveFeature(INT_FEATURE_ARRAY FeatureArray,
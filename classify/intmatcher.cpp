@@ -21,6 +21,7 @@
 ----------------------------------------------------------------------------**/
 #include "intmatcher.h"
 #include "intproto.h"
+#include "intsimd.h"
 #include "tordvars.h"
 #include "callcpp.h"
 #include "scrollview.h"
@@ -34,10 +35,10 @@
 /**----------------------------------------------------------------------------
                     Global Data Definitions and Declarations
 ----------------------------------------------------------------------------**/
-#define  SE_TABLE_BITS    9
-#define  SE_TABLE_SIZE  512
 #define TEMPLATE_CACHE 2
-static uinT8 SimilarityEvidenceTable[SE_TABLE_SIZE];
+
+/* Alignment of the evidence tables of IntegerMatcher for the SIMD kernels */
+#define IM_TABLE_ALIGNMENT 32
 static uinT8 offset_table[256] = {
   255, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
   4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
@@ -90,16 +91,8 @@ static uinT8 next_table[256] = {
   0xf8, 0xfc, 0xfc, 0xfe
 };
 
-static uinT32 EvidenceTableMask;
-
-static uinT32 MultTruncShiftBits;
-
-static uinT32 TableTruncShiftBits;
-
 uinT32 EvidenceMultMask;
 
-static inT16 LocalMatcherMultiplier;
-
 INT_VAR(classify_class_pruner_threshold, 229,
 "Class Pruner Threshold 0-255:        ");
 
@@ -137,6 +130,12 @@ BOOL_VAR(disable_character_fragments, FALSE,
          "Do not include character fragments in the"
          " results of the classifier");
 
+BOOL_VAR(classify_cp_use_simd, TRUE,
+         "Use the SSE2/AVX2 class pruner when the CPU supports it");
+
+BOOL_VAR(classify_im_use_simd, TRUE,
+         "Use the SSE2/AVX2 integer matcher when the CPU supports it");
+
 BOOL_VAR(matcher_debug_separate_windows, FALSE,
          "Use two different windows for debugging the matching: "
          "One for the protos and one for the features.");
@@ -196,17 +195,19 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
   int NumPruners;
   inT32 feature_index;           //current feature
 
-  static int ClassCount[MAX_NUM_CLASSES];
-  static int NormCount[MAX_NUM_CLASSES];
-  static int SortKey[MAX_NUM_CLASSES + 1];
-  static int SortIndex[MAX_NUM_CLASSES + 1];
+  int *ClassCount = cp_class_count_;
+  int *NormCount = cp_norm_count_;
+  int *SortKey = cp_sort_key_;
+  int *SortIndex = cp_sort_index_;
   int out_class;
   int MaxNumClasses;
   int MaxCount;
+  int MaxKey;
   int NumClasses;
   FLOAT32 max_rating;            //max allowed rating
   int *ClassCountPtr;
   CLASS_ID class_id;
+  PageStageTimer timer(&page_stats, PS_CLASS_PRUNER);
 
   MaxNumClasses = IntTemplates->NumClasses;
 
@@ -218,60 +219,62 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
 
   /* Update Class Counts */
   NumPruners = IntTemplates->NumClassPruners;
-  for (feature_index = 0; feature_index < NumFeatures; feature_index++) {
-    feature = &Features[feature_index];
-    feature_address = (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
-                        (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
-                       (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
-    ClassPruner = IntTemplates->ClassPruner;
-    class_index = 0;
-
-    for (PrunerSet = 0; PrunerSet < NumPruners; PrunerSet++, ClassPruner++) {
-      BasePrunerAddress = (uinT32 *) (*ClassPruner) + feature_address;
-
-      for (Word = 0; Word < WERDS_PER_CP_VECTOR; Word++) {
-        PrunerWord = *BasePrunerAddress++;
-        // This inner loop is unrolled to speed up the ClassPruner.
-        // Currently gcc would not unroll it unless it is set to O3
-        // level of optimization or -funroll-loops is specified.
-        /*
-        uinT32 class_mask = (1 << NUM_BITS_PER_CLASS) - 1;
-        for (int bit = 0; bit < BITS_PER_WERD/NUM_BITS_PER_CLASS; bit++) {
-          ClassCount[class_index++] += PrunerWord & class_mask;
-          PrunerWord >>= NUM_BITS_PER_CLASS;
+  if (!ClassPrunerSIMD(IntTemplates, NumFeatures, Features, ClassCount)) {
+    for (feature_index = 0; feature_index < NumFeatures; feature_index++) {
+      feature = &Features[feature_index];
+      feature_address = (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
+                          (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
+                         (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
+      ClassPruner = IntTemplates->ClassPruner;
+      class_index = 0;
+
+      for (PrunerSet = 0; PrunerSet < NumPruners; PrunerSet++, ClassPruner++) {
+        BasePrunerAddress = (uinT32 *) (*ClassPruner) + feature_address;
+
+        for (Word = 0; Word < WERDS_PER_CP_VECTOR; Word++) {
+          PrunerWord = *BasePrunerAddress++;
+          // This inner loop is unrolled to speed up the ClassPruner.
+          // Currently gcc would not unroll it unless it is set to O3
+          // level of optimization or -funroll-loops is specified.
+          /*
+          uinT32 class_mask = (1 << NUM_BITS_PER_CLASS) - 1;
+          for (int bit = 0; bit < BITS_PER_WERD/NUM_BITS_PER_CLASS; bit++) {
+            ClassCount[class_index++] += PrunerWord & class_mask;
+            PrunerWord >>= NUM_BITS_PER_CLASS;
+          }
+          */
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
+          PrunerWord >>= 2;
+          ClassCount[class_index++] += cp_maps[PrunerWord & 3];
         }
-        */
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
-        PrunerWord >>= 2;
-        ClassCount[class_index++] += cp_maps[PrunerWord & 3];
       }
     }
   }
@@ -295,10 +298,13 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
 
   /* Adjust Class Counts for Normalization Factors */
   MaxCount = 0;
+  MaxKey = 0;
   for (class_id = 0; class_id < MaxNumClasses; class_id++) {
     NormCount[class_id] = ClassCount[class_id]
       - ((classify_class_pruner_multiplier * NormalizationFactors[class_id]) >> 8)
       * cp_maps[3] / 3;
+    if (NormCount[class_id] > MaxKey)
+      MaxKey = NormCount[class_id];
     if (NormCount[class_id] > MaxCount &&
         // This additional check is added in order to ensure that
         // the classifier will return at least one non-fragmented
@@ -316,18 +322,8 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
   /* Select Classes */
   if (MaxCount < 1)
     MaxCount = 1;
-  NumClasses = 0;
-  for (class_id = 0; class_id < MaxNumClasses; class_id++) {
-    if (NormCount[class_id] >= MaxCount) {
-      NumClasses++;
-      SortIndex[NumClasses] = class_id;
-      SortKey[NumClasses] = NormCount[class_id];
-    }
-  }
-
-  /* Sort Classes using Heapsort Algorithm */
-  if (NumClasses > 1)
-    HeapSort(NumClasses, SortKey, SortIndex);
+  NumClasses = SelectPrunedClasses(MaxNumClasses, NormCount, MaxCount, MaxKey,
+                                   cp_key_count_, SortKey, SortIndex);
 
   if (tord_display_ratings > 1) {
     cprintf ("CP:%d classes, %d features:\n", NumClasses, NumFeatures);
@@ -398,15 +394,48 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
 }  // namespace tesseract
 
 /*---------------------------------------------------------------------------*/
-void IntegerMatcher(INT_CLASS ClassTemplate,
-                    BIT_VECTOR ProtoMask,
-                    BIT_VECTOR ConfigMask,
-                    uinT16 BlobLength,
-                    inT16 NumFeatures,
-                    INT_FEATURE_ARRAY Features,
-                    uinT8 NormalizationFactor,
-                    INT_RESULT Result,
-                    int Debug) {
+IntegerMatcher::IntegerMatcher()
+  : Kernels(NULL),
+    EvidenceTableMask(0),
+    MultTruncShiftBits(0),
+    TableTruncShiftBits(0),
+    LocalMatcherMultiplier(0),
+    AdaptProtoThresh(classify_adapt_proto_thresh),
+    AdaptFeatureThresh(classify_adapt_feature_thresh),
+    page_stats_(NULL) {
+  int FeatureEvidenceSize = MAX_NUM_CONFIGS * sizeof(*FeatureEvidence);
+  int SumOfFeatureEvidenceSize =
+    MAX_NUM_CONFIGS * sizeof(*SumOfFeatureEvidence);
+  int TableSize = FeatureEvidenceSize + SumOfFeatureEvidenceSize +
+    MAX_NUM_PROTOS * sizeof(*ProtoEvidence);
+
+  /* All the table sizes are multiples of IM_TABLE_ALIGNMENT */
+  TableMemory = new uinT8[TableSize + IM_TABLE_ALIGNMENT - 1];
+  memset(TableMemory, 0, TableSize + IM_TABLE_ALIGNMENT - 1);
+  uinT8 *Table = TableMemory +
+    (-reinterpret_cast<size_t>(TableMemory) & (IM_TABLE_ALIGNMENT - 1));
+  FeatureEvidence = Table;
+  Table += FeatureEvidenceSize;
+  SumOfFeatureEvidence = reinterpret_cast<int *>(Table);
+  Table += SumOfFeatureEvidenceSize;
+  ProtoEvidence = reinterpret_cast<uinT8 (*)[PROTO_EVIDENCE_STRIDE]>(Table);
+}
+
+/*---------------------------------------------------------------------------*/
+IntegerMatcher::~IntegerMatcher() {
+  delete [] TableMemory;
+}
+
+/*---------------------------------------------------------------------------*/
+void IntegerMatcher::Match(INT_CLASS ClassTemplate,
+                           BIT_VECTOR ProtoMask,
+                           BIT_VECTOR ConfigMask,
+                           uinT16 BlobLength,
+                           inT16 NumFeatures,
+                           INT_FEATURE_ARRAY Features,
+                           uinT8 NormalizationFactor,
+                           INT_RESULT Result,
+                           int Debug) {
 /*
  **      Parameters:
  **              ClassTemplate             Prototypes & tables for a class
@@ -431,23 +460,22 @@ void IntegerMatcher(INT_CLASS ClassTemplate,
  **      Exceptions: none
  **      History: Tue Feb 19 16:36:23 MST 1991, RWM, Created.
  */
-  static uinT8 FeatureEvidence[MAX_NUM_CONFIGS];
-  static int SumOfFeatureEvidence[MAX_NUM_CONFIGS];
-  static uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX];
   int Feature;
   int BestMatch;
+  tesseract::PageStageTimer timer(page_stats_, tesseract::PS_INT_MATCHER);
 
   if (MatchDebuggingOn (Debug))
     cprintf ("Integer Matcher -------------------------------------------\n");
 
+  Kernels = classify_im_use_simd ? GetIntMatcherKernels() : NULL;
   IMClearTables(ClassTemplate, SumOfFeatureEvidence, ProtoEvidence);
   Result->FeatureMisses = 0;
 
   for (Feature = 0; Feature < NumFeatures; Feature++) {
-    int csum = IMUpdateTablesForFeature(ClassTemplate, ProtoMask, ConfigMask,
-                                        Feature, &(Features[Feature]),
-                                        FeatureEvidence, SumOfFeatureEvidence,
-                                        ProtoEvidence, Debug);
+    int csum = UpdateTablesForFeature(ClassTemplate, ProtoMask, ConfigMask,
+                                      Feature, &(Features[Feature]),
+                                      FeatureEvidence, SumOfFeatureEvidence,
+                                      ProtoEvidence, Debug);
     // Count features that were missed over all configs.
     if (csum == 0)
       Result->FeatureMisses++;
@@ -471,35 +499,42 @@ void IntegerMatcher(INT_CLASS ClassTemplate,
                             Debug);
 
   if (DisplayFeatureMatchesOn (Debug))
-    IMDisplayFeatureDebugInfo(ClassTemplate,
-                              ProtoMask,
-                              ConfigMask,
-                              NumFeatures,
-                              Features,
-                              Debug);
+    DisplayFeatureDebugInfo(ClassTemplate,
+                            ProtoMask,
+                            ConfigMask,
+                            NumFeatures,
+                            Features,
+                            Debug);
 #endif
 
-  IMUpdateSumOfProtoEvidences(ClassTemplate,
-                              ConfigMask,
+  if (Kernels != NULL) {
+    Kernels->UpdateSumOfProtoEvidences(ClassTemplate, *ConfigMask,
+                                       ProtoEvidence[0], SumOfFeatureEvidence);
+    Kernels->NormalizeSumOfEvidences(ClassTemplate, NumFeatures,
+                                     SumOfFeatureEvidence);
+  } else {
+    IMUpdateSumOfProtoEvidences(ClassTemplate,
+                                ConfigMask,
+                                SumOfFeatureEvidence,
+                                ProtoEvidence,
+                                NumFeatures);
+
+    IMNormalizeSumOfEvidences(ClassTemplate,
                               SumOfFeatureEvidence,
-                              ProtoEvidence,
+                              NumFeatures,
                               NumFeatures);
-
-  IMNormalizeSumOfEvidences(ClassTemplate,
-                            SumOfFeatureEvidence,
-                            NumFeatures,
-                            NumFeatures);
+  }
 
   BestMatch =
-    IMFindBestMatch(ClassTemplate,
-                    SumOfFeatureEvidence,
-                    BlobLength,
-                    NormalizationFactor,
-                    Result);
+    FindBestMatch(ClassTemplate,
+                  SumOfFeatureEvidence,
+                  BlobLength,
+                  NormalizationFactor,
+                  Result);
 
 #ifndef GRAPHICS_DISABLED
   if (PrintMatchSummaryOn (Debug))
-    IMDebugBestMatch(BestMatch, Result, BlobLength, NormalizationFactor);
+    DebugBestMatch(BestMatch, Result, BlobLength, NormalizationFactor);
 
   if (MatchDebuggingOn (Debug))
     cprintf ("Match Complete --------------------------------------------\n");
@@ -509,14 +544,14 @@ void IntegerMatcher(INT_CLASS ClassTemplate,
 
 
 /*---------------------------------------------------------------------------*/
-int FindGoodProtos(INT_CLASS ClassTemplate,
-                   BIT_VECTOR ProtoMask,
-                   BIT_VECTOR ConfigMask,
-                   uinT16 BlobLength,
-                   inT16 NumFeatures,
-                   INT_FEATURE_ARRAY Features,
-                   PROTO_ID *ProtoArray,
-                   int Debug) {
+int IntegerMatcher::FindGoodProtos(INT_CLASS ClassTemplate,
+                                   BIT_VECTOR ProtoMask,
+                                   BIT_VECTOR ConfigMask,
+                                   uinT16 BlobLength,
+                                   inT16 NumFeatures,
+                                   INT_FEATURE_ARRAY Features,
+                                   PROTO_ID *ProtoArray,
+                                   int Debug) {
 /*
  **      Parameters:
  **              ClassTemplate             Prototypes & tables for a class
@@ -531,19 +566,16 @@ int FindGoodProtos(INT_CLASS ClassTemplate,
  **              LocalMatcherMultiplier    Normalization factor multiplier
  **              classify_int_theta_fudge             Theta fudge factor used for
  **                                        evidence calculation
- **              classify_adapt_proto_thresh          Threshold for good protos
+ **              AdaptProtoThresh          Threshold for good protos
  **      Operation:
  **              FindGoodProtos finds all protos whose normalized proto-evidence
- **              exceed classify_adapt_proto_thresh.  The list is ordered by increasing
+ **              exceed AdaptProtoThresh.  The list is ordered by increasing
  **              proto id number.
  **      Return:
  **              Number of good protos in ProtoArray.
  **      Exceptions: none
  **      History: Tue Mar 12 17:09:26 MST 1991, RWM, Created
  */
-  static uinT8 FeatureEvidence[MAX_NUM_CONFIGS];
-  static int SumOfFeatureEvidence[MAX_NUM_CONFIGS];
-  static uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX];
   int Feature;
   register uinT8 *UINT8Pointer;
   register int ProtoIndex;
@@ -557,10 +589,11 @@ int FindGoodProtos(INT_CLASS ClassTemplate,
     cprintf
       ("Find Good Protos -------------------------------------------\n");
 
+  Kernels = classify_im_use_simd ? GetIntMatcherKernels() : NULL;
   IMClearTables(ClassTemplate, SumOfFeatureEvidence, ProtoEvidence);
 
   for (Feature = 0; Feature < NumFeatures; Feature++)
-    IMUpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
+    UpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
       &(Features[Feature]), FeatureEvidence,
       SumOfFeatureEvidence, ProtoEvidence, Debug);
 
@@ -589,7 +622,7 @@ int FindGoodProtos(INT_CLASS ClassTemplate,
     Temp /= ClassTemplate->ProtoLengths[ActualProtoNum];
 
     /* Find Good Protos */
-    if (Temp >= classify_adapt_proto_thresh) {
+    if (Temp >= AdaptProtoThresh) {
       *ProtoArray = ActualProtoNum;
       ProtoArray++;
       NumGoodProtos++;
@@ -604,14 +637,14 @@ int FindGoodProtos(INT_CLASS ClassTemplate,
 
 
 /*---------------------------------------------------------------------------*/
-int FindBadFeatures(INT_CLASS ClassTemplate,
-                    BIT_VECTOR ProtoMask,
-                    BIT_VECTOR ConfigMask,
-                    uinT16 BlobLength,
-                    inT16 NumFeatures,
-                    INT_FEATURE_ARRAY Features,
-                    FEATURE_ID *FeatureArray,
-                    int Debug) {
+int IntegerMatcher::FindBadFeatures(INT_CLASS ClassTemplate,
+                                    BIT_VECTOR ProtoMask,
+                                    BIT_VECTOR ConfigMask,
+                                    uinT16 BlobLength,
+                                    inT16 NumFeatures,
+                                    INT_FEATURE_ARRAY Features,
+                                    FEATURE_ID *FeatureArray,
+                                    int Debug) {
 /*
  **      Parameters:
  **              ClassTemplate             Prototypes & tables for a class
@@ -626,19 +659,16 @@ int FindBadFeatures(INT_CLASS ClassTemplate,
  **              LocalMatcherMultiplier    Normalization factor multiplier
  **              classify_int_theta_fudge             Theta fudge factor used for
  **                                        evidence calculation
- **              classify_adapt_feature_thresh        Threshold for bad features
+ **              AdaptFeatureThresh        Threshold for bad features
  **      Operation:
  **              FindBadFeatures finds all features whose maximum feature-evidence
- **              was less than classify_adapt_feature_thresh.  The list is ordered by increasing
+ **              was less than AdaptFeatureThresh.  The list is ordered by increasing
  **              feature number.
  **      Return:
  **              Number of bad features in FeatureArray.
  **      Exceptions: none
  **      History: Tue Mar 12 17:09:26 MST 1991, RWM, Created
  */
-  static uinT8 FeatureEvidence[MAX_NUM_CONFIGS];
-  static int SumOfFeatureEvidence[MAX_NUM_CONFIGS];
-  static uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX];
   int Feature;
   register uinT8 *UINT8Pointer;
   register int ConfigNum;
@@ -651,12 +681,13 @@ int FindBadFeatures(INT_CLASS ClassTemplate,
     cprintf
       ("Find Bad Features -------------------------------------------\n");
 
+  Kernels = classify_im_use_simd ? GetIntMatcherKernels() : NULL;
   IMClearTables(ClassTemplate, SumOfFeatureEvidence, ProtoEvidence);
 
   NumBadFeatures = 0;
   NumConfigs = ClassTemplate->NumConfigs;
   for (Feature = 0; Feature < NumFeatures; Feature++) {
-    IMUpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
+    UpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
       &(Features[Feature]), FeatureEvidence,
       SumOfFeatureEvidence, ProtoEvidence, Debug);
 
@@ -668,7 +699,7 @@ int FindBadFeatures(INT_CLASS ClassTemplate,
         Temp = *UINT8Pointer;
 
     /* Find Bad Features */
-    if (Temp < classify_adapt_feature_thresh) {
+    if (Temp < AdaptFeatureThresh) {
       *FeatureArray = Feature;
       FeatureArray++;
       NumBadFeatures++;
@@ -695,7 +726,7 @@ int FindBadFeatures(INT_CLASS ClassTemplate,
 
 
 /*---------------------------------------------------------------------------*/
-void InitIntegerMatcher() {
+void IntegerMatcher::Init() {
   int i;
   uinT32 IntSimilarity;
   double Similarity;
@@ -704,6 +735,8 @@ void InitIntegerMatcher() {
 
   /* Set default mode of operation of IntegerMatcher */
   SetCharNormMatch();
+  AdaptProtoThresh = classify_adapt_proto_thresh;
+  AdaptFeatureThresh = classify_adapt_feature_thresh;
 
   /* Initialize table for evidence to similarity lookup */
   for (i = 0; i < SE_TABLE_SIZE; i++) {
@@ -747,33 +780,33 @@ void PrintIntMatcherStats(FILE *f) {
 
 
 /*-------------------------------------------------------------------------*/
-void SetProtoThresh(FLOAT32 Threshold) {
-  classify_adapt_proto_thresh.set_value(255 * Threshold);
-  if (classify_adapt_proto_thresh < 0)
-    classify_adapt_proto_thresh.set_value(0);
-  if (classify_adapt_proto_thresh > 255)
-    classify_adapt_proto_thresh.set_value(255);
+void IntegerMatcher::SetProtoThresh(FLOAT32 Threshold) {
+  AdaptProtoThresh = (inT32) (255 * Threshold);
+  if (AdaptProtoThresh < 0)
+    AdaptProtoThresh = 0;
+  if (AdaptProtoThresh > 255)
+    AdaptProtoThresh = 255;
 }
 
 
 /*---------------------------------------------------------------------------*/
-void SetFeatureThresh(FLOAT32 Threshold) {
-  classify_adapt_feature_thresh.set_value(255 * Threshold);
-  if (classify_adapt_feature_thresh < 0)
-    classify_adapt_feature_thresh.set_value(0);
-  if (classify_adapt_feature_thresh > 255)
-    classify_adapt_feature_thresh.set_value(255);
+void IntegerMatcher::SetFeatureThresh(FLOAT32 Threshold) {
+  AdaptFeatureThresh = (inT32) (255 * Threshold);
+  if (AdaptFeatureThresh < 0)
+    AdaptFeatureThresh = 0;
+  if (AdaptFeatureThresh > 255)
+    AdaptFeatureThresh = 255;
 }
 
 
 /*--------------------------------------------------------------------------*/
-void SetBaseLineMatch() {
+void IntegerMatcher::SetBaseLineMatch() {
   LocalMatcherMultiplier = 0;
 }
 
 
 /*--------------------------------------------------------------------------*/
-void SetCharNormMatch() {
+void IntegerMatcher::SetCharNormMatch() {
   LocalMatcherMultiplier = classify_integer_matcher_multiplier;
 }
 
@@ -785,7 +818,7 @@ void SetCharNormMatch() {
 void
 IMClearTables (INT_CLASS ClassTemplate,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX]) {
+uinT8 ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE]) {
 /*
  **      Parameters:
  **              SumOfFeatureEvidence  Sum of Feature Evidence Table
@@ -883,17 +916,16 @@ void IMDebugConfigurationSum(int FeatureNum,
 
 
 /*---------------------------------------------------------------------------*/
-int
-IMUpdateTablesForFeature (INT_CLASS ClassTemplate,
-BIT_VECTOR ProtoMask,
-BIT_VECTOR ConfigMask,
-int FeatureNum,
-INT_FEATURE Feature,
-uinT8 FeatureEvidence[MAX_NUM_CONFIGS],
-int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
-int Debug) {
+int IntegerMatcher::UpdateTablesForFeature(
+    INT_CLASS ClassTemplate,
+    BIT_VECTOR ProtoMask,
+    BIT_VECTOR ConfigMask,
+    int FeatureNum,
+    INT_FEATURE Feature,
+    uinT8 FeatureEvidence[MAX_NUM_CONFIGS],
+    int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
+    uinT8 ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
+    int Debug) {
 /*
  **      Parameters:
  **              ClassTemplate         Prototypes & tables for a class
@@ -936,6 +968,7 @@ int Debug) {
   register inT32 M3;
   register inT32 A3;
   register uinT32 A4;
+  int NumFeatureProtos = 0;
 
   IMClearFeatureEvidenceTable(FeatureEvidence, ClassTemplate->NumConfigs);
 
@@ -1002,6 +1035,15 @@ int Debug) {
 
           ConfigWord &= *ConfigMask;
 
+          if (Kernels != NULL) {
+            /* Leave the table updates to the kernels */
+            FeatureProtoIds[NumFeatureProtos] = ActualProtoNum + proto_offset;
+            FeatureProtoEvidence[NumFeatureProtos] = Evidence;
+            FeatureProtoConfigs[NumFeatureProtos] = ConfigWord;
+            NumFeatureProtos++;
+            continue;
+          }
+
           UINT8Pointer = FeatureEvidence - 8;
           config_byte = 0;
           while (ConfigWord != 0 || config_byte != 0) {
@@ -1035,9 +1077,19 @@ int Debug) {
     }
   }
 
+  if (Kernels != NULL)
+    Kernels->ApplyProtoEvidences(NumFeatureProtos, FeatureProtoIds,
+                                 FeatureProtoEvidence, FeatureProtoConfigs,
+                                 ClassTemplate->ProtoLengths,
+                                 FeatureEvidence, ProtoEvidence[0]);
+
   if (PrintFeatureMatchesOn (Debug))
     IMDebugConfigurationSum (FeatureNum, FeatureEvidence,
       ClassTemplate->NumConfigs);
+  if (Kernels != NULL)
+    return Kernels->AddFeatureEvidence(FeatureEvidence,
+                                       ClassTemplate->NumConfigs,
+                                       SumOfFeatureEvidence);
   IntPointer = SumOfFeatureEvidence;
   UINT8Pointer = FeatureEvidence;
   int SumOverConfigs = 0;
@@ -1058,7 +1110,7 @@ BIT_VECTOR ProtoMask,
 BIT_VECTOR ConfigMask,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
 uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
+ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
 inT16 NumFeatures, int Debug) {
 /*
  **      Parameters:
@@ -1194,7 +1246,7 @@ void
 IMDisplayProtoDebugInfo (INT_CLASS ClassTemplate,
 BIT_VECTOR ProtoMask,
 BIT_VECTOR ConfigMask,
-uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
+uinT8 ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
 int Debug) {
   register uinT8 *UINT8Pointer;
   register uinT32 ConfigWord;
@@ -1253,21 +1305,26 @@ int Debug) {
 
 
 /*---------------------------------------------------------------------------*/
-void IMDisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
-                               BIT_VECTOR ProtoMask,
-                               BIT_VECTOR ConfigMask,
-                               inT16 NumFeatures,
-                               INT_FEATURE_ARRAY Features,
-                               int Debug) {
-  static uinT8 FeatureEvidence[MAX_NUM_CONFIGS];
-  static int SumOfFeatureEvidence[MAX_NUM_CONFIGS];
-  static uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX];
+void IntegerMatcher::DisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
+                                             BIT_VECTOR ProtoMask,
+                                             BIT_VECTOR ConfigMask,
+                                             inT16 NumFeatures,
+                                             INT_FEATURE_ARRAY Features,
+                                             int Debug) {
+  // Called part way through Match, so it must not disturb the member tables.
+  uinT8 FeatureEvidence[MAX_NUM_CONFIGS];
+  int SumOfFeatureEvidence[MAX_NUM_CONFIGS];
+  uinT8 (*ProtoEvidence)[PROTO_EVIDENCE_STRIDE] =
+    new uinT8[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE];
+  // The local tables are not aligned for the SIMD kernels.
+  const IntMatcherKernels *MatchKernels = Kernels;
   int Feature;
   register uinT8 *UINT8Pointer;
   register int ConfigNum;
   int NumConfigs;
   register int Temp;
 
+  Kernels = NULL;
   IMClearTables(ClassTemplate, SumOfFeatureEvidence, ProtoEvidence);
 
   InitIntMatchWindowIfReqd();
@@ -1278,7 +1335,7 @@ void IMDisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
 
   NumConfigs = ClassTemplate->NumConfigs;
   for (Feature = 0; Feature < NumFeatures; Feature++) {
-    IMUpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
+    UpdateTablesForFeature (ClassTemplate, ProtoMask, ConfigMask, Feature,
       &(Features[Feature]), FeatureEvidence,
       SumOfFeatureEvidence, ProtoEvidence, 0);
 
@@ -1291,7 +1348,7 @@ void IMDisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
 
     /* Update display for current feature */
     if (ClipMatchEvidenceOn (Debug)) {
-      if (Temp < classify_adapt_feature_thresh)
+      if (Temp < AdaptFeatureThresh)
         DisplayIntFeature (&(Features[Feature]), 0.0);
       else
         DisplayIntFeature (&(Features[Feature]), 1.0);
@@ -1300,6 +1357,8 @@ void IMDisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
       DisplayIntFeature (&(Features[Feature]), (Temp / 255.0));
     }
   }
+  delete [] ProtoEvidence;
+  Kernels = MatchKernels;
 }
 #endif
 
@@ -1309,7 +1368,7 @@ IMUpdateSumOfProtoEvidences (INT_CLASS ClassTemplate,
 BIT_VECTOR ConfigMask,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
 uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
+ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
 inT16 NumFeatures) {
 /*
  **      Parameters:
@@ -1391,11 +1450,11 @@ inT16 NumFeatures, inT32 used_features) {
 
 
 /*---------------------------------------------------------------------------*/
-int
-IMFindBestMatch (INT_CLASS ClassTemplate,
-int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT16 BlobLength,
-uinT8 NormalizationFactor, INT_RESULT Result) {
+int IntegerMatcher::FindBestMatch(INT_CLASS ClassTemplate,
+                                  int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
+                                  uinT16 BlobLength,
+                                  uinT8 NormalizationFactor,
+                                  INT_RESULT Result) {
 /*
  **      Parameters:
  **      Globals:
@@ -1449,10 +1508,10 @@ uinT8 NormalizationFactor, INT_RESULT Result) {
 
 /*---------------------------------------------------------------------------*/
 #ifndef GRAPHICS_DISABLED
-void IMDebugBestMatch(int BestMatch,
-                      INT_RESULT Result,
-                      uinT16 BlobLength,
-                      uinT8 NormalizationFactor) {
+void IntegerMatcher::DebugBestMatch(int BestMatch,
+                                    INT_RESULT Result,
+                                    uinT16 BlobLength,
+                                    uinT8 NormalizationFactor) {
 /*
  **      Parameters:
  **      Globals:
@@ -1476,57 +1535,145 @@ void IMDebugBestMatch(int BestMatch,
 #endif
 
 /*---------------------------------------------------------------------------*/
-void
-HeapSort (int n, register int ra[], register int rb[]) {
+bool ClassPrunerSIMD(INT_TEMPLATES IntTemplates,
+                     inT16 NumFeatures,
+                     INT_FEATURE_ARRAY Features,
+                     int *ClassCount) {
 /*
  **      Parameters:
- **              n      Number of elements to sort
- **              ra     Key array [1..n]
- **              rb     Index array [1..n]
+ **              IntTemplates           Class pruner tables
+ **              NumFeatures            Number of features in blob
+ **              Features               Array of features
+ **              ClassCount             Array to fill with the class counts
+ **                                     (by CLASS_INDEX)
  **      Globals:
+ **              classify_cp_use_simd   Use the SIMD kernels at all
+ **              cp_maps                Count of each 2-bit pruner entry
  **      Operation:
- **              Sort Key array in ascending order using heap sort
- **              algorithm.  Also sort Index array that is tied to
- **              the key array.
- **      Return:
+ **              Computes the class counts of the class pruner with the
+ **              widest SIMD kernel that the CPU supports. The counts are
+ **              the same as those of the scalar loop in ClassPruner.
+ **      Return: FALSE if there is no usable kernel, or if the counts
+ **              could overflow the 16 bits of the kernels, in which case
+ **              ClassCount is untouched.
+ **      Exceptions: none
+ */
+#ifdef TESS_SIMD_X86
+  INT_FEATURE feature;
+  int offsets[MAX_NUM_INT_FEATURES];
+  inT32 max_map = 0;
+
+  if (!classify_cp_use_simd || NumFeatures <= 0 ||
+      NumFeatures > MAX_NUM_INT_FEATURES)
+    return false;
+  for (int i = 0; i < 4; i++) {
+    if (cp_maps[i] < 0)
+      return false;
+    if (cp_maps[i] > max_map)
+      max_map = cp_maps[i];
+  }
+  if (max_map * NumFeatures > 0xffff)
+    return false;
+  if (!SIMDDetect::IsAVX2Available() && !SIMDDetect::IsSSE2Available())
+    return false;
+
+  for (int f = 0; f < NumFeatures; f++) {
+    feature = &Features[f];
+    offsets[f] = (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
+                   (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
+                  (feature->Theta * NUM_CP_BUCKETS >> 8)) * WERDS_PER_CP_VECTOR;
+  }
+#ifdef TESS_SIMD_AVX2
+  if (SIMDDetect::IsAVX2Available()) {
+    ClassPrunerCountsAVX2(IntTemplates->ClassPruner,
+                          IntTemplates->NumClassPruners,
+                          offsets, NumFeatures, cp_maps, ClassCount);
+    return true;
+  }
+#endif
+  if (SIMDDetect::IsSSE2Available()) {
+    ClassPrunerCountsSSE2(IntTemplates->ClassPruner,
+                          IntTemplates->NumClassPruners,
+                          offsets, NumFeatures, cp_maps, ClassCount);
+    return true;
+  }
+#endif  // TESS_SIMD_X86
+  return false;
+}
+
+/*---------------------------------------------------------------------------*/
+int SelectPrunedClasses(int NumClasses,
+                        const int *NormCount,
+                        int MinCount,
+                        int MaxKey,
+                        int *KeyCount,
+                        int *SortKey,
+                        int *SortIndex) {
+/*
+ **      Parameters:
+ **              NumClasses     Number of classes in NormCount
+ **              NormCount      Normalized class counts (by CLASS_INDEX)
+ **              MinCount       Smallest count of a class that is kept
+ **              MaxKey         Largest count in NormCount
+ **              KeyCount       Work array of MAX_CP_SORT_RANGE entries
+ **              SortKey        Array [1..n] to fill with the counts of the
+ **                             kept classes
+ **              SortIndex      Array [1..n] to fill with the kept classes
+ **      Operation:
+ **              Keeps the classes whose count is at least MinCount and
+ **              sorts them in ascending order of count. Classes with
+ **              equal counts are in decreasing class order, so that
+ **              ClassPruner, which reads the best classes from the end,
+ **              gives them in class order. The counts of the kept
+ **              classes span only the small range from MinCount to
+ **              MaxKey, so a counting sort does this in two linear passes.
+ **              An unusually wide range falls back to an insertion sort,
+ **              which gives the same order.
+ **      Return: Number of classes kept.
  **      Exceptions: none
- **      History: Tue Feb 19 10:24:24 MST 1991, RWM, Created.
  */
-  register int i, rra, rrb;
-  int l, j, ir;
-
-  l = (n >> 1) + 1;
-  ir = n;
-  for (;;) {
-    if (l > 1) {
-      rra = ra[--l];
-      rrb = rb[l];
+  int class_id;
+  int key;
+  int position;
+  int num_kept = 0;
+  int range = MaxKey - MinCount + 1;
+
+  if (range <= 0)
+    return 0;
+  if (range <= MAX_CP_SORT_RANGE) {
+    memset(KeyCount, 0, range * sizeof(*KeyCount));
+    for (class_id = 0; class_id < NumClasses; class_id++) {
+      if (NormCount[class_id] >= MinCount)
+        KeyCount[NormCount[class_id] - MinCount]++;
     }
-    else {
-      rra = ra[ir];
-      rrb = rb[ir];
-      ra[ir] = ra[1];
-      rb[ir] = rb[1];
-      if (--ir == 1) {
-        ra[1] = rra;
-        rb[1] = rrb;
-        return;
+    /* Turn the counts of each key into the first position of the key. */
+    position = 1;
+    for (key = 0; key < range; key++) {
+      num_kept = KeyCount[key];
+      KeyCount[key] = position;
+      position += num_kept;
+    }
+    num_kept = position - 1;
+    for (class_id = NumClasses - 1; class_id >= 0; class_id--) {
+      if (NormCount[class_id] >= MinCount) {
+        position = KeyCount[NormCount[class_id] - MinCount]++;
+        SortKey[position] = NormCount[class_id];
+        SortIndex[position] = class_id;
       }
     }
-    i = l;
-    j = l << 1;
-    while (j <= ir) {
-      if (j < ir && ra[j] < ra[j + 1])
-        ++j;
-      if (rra < ra[j]) {
-        ra[i] = ra[j];
-        rb[i] = rb[j];
-        j += (i = j);
+  } else {
+    for (class_id = NumClasses - 1; class_id >= 0; class_id--) {
+      if (NormCount[class_id] >= MinCount) {
+        position = ++num_kept;
+        while (position > 1 && SortKey[position - 1] > NormCount[class_id]) {
+          SortKey[position] = SortKey[position - 1];
+          SortIndex[position] = SortIndex[position - 1];
+          position--;
+        }
+        SortKey[position] = NormCount[class_id];
+        SortIndex[position] = class_id;
       }
-      else
-        j = ir + 1;
     }
-    ra[i] = rra;
-    rb[i] = rrb;
   }
+  return num_kept;
 }
@@ -37,6 +37,7 @@ extern INT_VAR_H(classify_integer_matcher_multiplier, 14,
 ----------------------------------------------------------------------------**/
 #include "intproto.h"
 #include "cutoffs.h"
+#include "pagestats.h"
 
 typedef struct
 {
@@ -64,6 +65,17 @@ typedef CP_RESULT_STRUCT CLASS_PRUNER_RESULTS[MAX_NUM_CLASSES];
 
 typedef uinT8 CLASS_NORMALIZATION_ARRAY[MAX_NUM_CLASSES];
 
+#define  SE_TABLE_BITS    9
+#define  SE_TABLE_SIZE  512
+
+/* Widest range of class pruner counts that is sorted by counting */
+#define  MAX_CP_SORT_RANGE  2048
+
+/* Rows of the proto evidence table are padded to a whole SIMD vector */
+#define  PROTO_EVIDENCE_STRIDE  32
+
+struct IntMatcherKernels;
+
 /*----------------------------------------------------------------------------
             Variables
 -----------------------------------------------------------------------------*/
@@ -74,56 +86,142 @@ extern INT_VAR_H(classify_adapt_proto_thresh, 230,
 extern INT_VAR_H(classify_adapt_feature_thresh, 230,
                  "Threshold for good features during adaptive 0-255:   ");
 
+extern BOOL_VAR_H(classify_cp_use_simd, TRUE,
+                  "Use the SSE2/AVX2 class pruner when the CPU supports it");
+
+extern BOOL_VAR_H(classify_im_use_simd, TRUE,
+                  "Use the SSE2/AVX2 integer matcher when the CPU supports it");
+
 /**----------------------------------------------------------------------------
           Public Function Prototypes
 ----------------------------------------------------------------------------**/
 
-void IntegerMatcher(INT_CLASS ClassTemplate,
-                    BIT_VECTOR ProtoMask,
-                    BIT_VECTOR ConfigMask,
+// The integer matcher. All the evidence tables and the matching mode
+// belong to the instance, so each Classify owns an independent matcher
+// that may run concurrently with matchers owned by other instances.
+class IntegerMatcher {
+ public:
+  IntegerMatcher();
+  ~IntegerMatcher();
+
+  void Init();
+
+  void SetBaseLineMatch();
+  void SetCharNormMatch();
+
+  // Set the thresholds of FindGoodProtos and FindBadFeatures, as fractions
+  // of a perfect match. Init sets them from classify_adapt_proto_thresh
+  // and classify_adapt_feature_thresh.
+  void SetProtoThresh(FLOAT32 Threshold);
+  void SetFeatureThresh(FLOAT32 Threshold);
+
+  // Sets the PageStats that Match is timed in, or NULL for none.
+  void set_page_stats(tesseract::PageStats *stats) {
+    page_stats_ = stats;
+  }
+
+  void Match(INT_CLASS ClassTemplate,
+             BIT_VECTOR ProtoMask,
+             BIT_VECTOR ConfigMask,
+             uinT16 BlobLength,
+             inT16 NumFeatures,
+             INT_FEATURE_ARRAY Features,
+             uinT8 NormalizationFactor,
+             INT_RESULT Result,
+             int Debug);
+
+  int FindGoodProtos(INT_CLASS ClassTemplate,
+                     BIT_VECTOR ProtoMask,
+                     BIT_VECTOR ConfigMask,
+                     uinT16 BlobLength,
+                     inT16 NumFeatures,
+                     INT_FEATURE_ARRAY Features,
+                     PROTO_ID *ProtoArray,
+                     int Debug);
+
+  int FindBadFeatures(INT_CLASS ClassTemplate,
+                      BIT_VECTOR ProtoMask,
+                      BIT_VECTOR ConfigMask,
+                      uinT16 BlobLength,
+                      inT16 NumFeatures,
+                      INT_FEATURE_ARRAY Features,
+                      FEATURE_ID *FeatureArray,
+                      int Debug);
+
+ private:
+  int UpdateTablesForFeature(INT_CLASS ClassTemplate,
+                             BIT_VECTOR ProtoMask,
+                             BIT_VECTOR ConfigMask,
+                             int FeatureNum,
+                             INT_FEATURE Feature,
+                             uinT8 FeatureEvidence[MAX_NUM_CONFIGS],
+                             int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
+                             uinT8 ProtoEvidence[MAX_NUM_PROTOS]
+                                                [PROTO_EVIDENCE_STRIDE],
+                             int Debug);
+
+  int FindBestMatch(INT_CLASS ClassTemplate,
+                    int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
                     uinT16 BlobLength,
-                    inT16 NumFeatures,
-                    INT_FEATURE_ARRAY Features,
                     uinT8 NormalizationFactor,
-                    INT_RESULT Result,
-                    int Debug);
-
-int FindGoodProtos(INT_CLASS ClassTemplate,
-                   BIT_VECTOR ProtoMask,
-                   BIT_VECTOR ConfigMask,
-                   uinT16 BlobLength,
-                   inT16 NumFeatures,
-                   INT_FEATURE_ARRAY Features,
-                   PROTO_ID *ProtoArray,
-                   int Debug);
-
-int FindBadFeatures(INT_CLASS ClassTemplate,
-                    BIT_VECTOR ProtoMask,
-                    BIT_VECTOR ConfigMask,
-                    uinT16 BlobLength,
-                    inT16 NumFeatures,
-                    INT_FEATURE_ARRAY Features,
-                    FEATURE_ID *FeatureArray,
-                    int Debug);
-
-void InitIntegerMatcher();
-
-void PrintIntMatcherStats(FILE *f);
+                    INT_RESULT Result);
 
-void SetProtoThresh(FLOAT32 Threshold);
+#ifndef GRAPHICS_DISABLED
+  void DisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
+                               BIT_VECTOR ProtoMask,
+                               BIT_VECTOR ConfigMask,
+                               inT16 NumFeatures,
+                               INT_FEATURE_ARRAY Features,
+                               int Debug);
 
-void SetFeatureThresh(FLOAT32 Threshold);
+  void DebugBestMatch(int BestMatch,
+                      INT_RESULT Result,
+                      uinT16 BlobLength,
+                      uinT8 NormalizationFactor);
+#endif
 
-void SetBaseLineMatch();
+  // Not copyable: the tables below point into TableMemory.
+  IntegerMatcher(const IntegerMatcher &);
+  void operator=(const IntegerMatcher &);
+
+  // Scratch tables filled in by a single Match/FindGoodProtos/FindBadFeatures.
+  // They are carved out of TableMemory, each aligned to 32 bytes for the
+  // SIMD kernels.
+  uinT8 *TableMemory;
+  uinT8 *FeatureEvidence;               // [MAX_NUM_CONFIGS]
+  int *SumOfFeatureEvidence;            // [MAX_NUM_CONFIGS]
+  uinT8 (*ProtoEvidence)[PROTO_EVIDENCE_STRIDE];  // [MAX_NUM_PROTOS]
+
+  // The SIMD kernels of the current match, or NULL for the scalar code.
+  const IntMatcherKernels *Kernels;
+  // Protos that matched the current feature, with their evidence and
+  // masked config words, when the kernels apply them all at once.
+  uinT16 FeatureProtoIds[MAX_NUM_PROTOS];
+  uinT8 FeatureProtoEvidence[MAX_NUM_PROTOS];
+  uinT32 FeatureProtoConfigs[MAX_NUM_PROTOS];
+
+  // Lookup tables and constants computed by Init.
+  uinT8 SimilarityEvidenceTable[SE_TABLE_SIZE];
+  uinT32 EvidenceTableMask;
+  uinT32 MultTruncShiftBits;
+  uinT32 TableTruncShiftBits;
+  inT16 LocalMatcherMultiplier;
+
+  // Evidence limits of good protos and bad features, from 0 to 255.
+  int AdaptProtoThresh;
+  int AdaptFeatureThresh;
+
+  tesseract::PageStats *page_stats_;
+};
 
-void SetCharNormMatch();
+void PrintIntMatcherStats(FILE *f);
 
 /**----------------------------------------------------------------------------
           Private Function Prototypes
 ----------------------------------------------------------------------------**/
 void IMClearTables (INT_CLASS ClassTemplate,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT8 ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX]);
+uinT8 ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE]);
 
 void IMClearFeatureEvidenceTable (uinT8 FeatureEvidence[MAX_NUM_CONFIGS],
 int NumConfigs);
@@ -138,39 +236,21 @@ void IMDebugConfigurationSum(INT_FEATURE FeatureNum,
                              uinT8 *FeatureEvidence,
                              inT32 ConfigCount);
 
-int IMUpdateTablesForFeature (INT_CLASS ClassTemplate,
-BIT_VECTOR ProtoMask,
-BIT_VECTOR ConfigMask,
-int FeatureNum,
-INT_FEATURE Feature,
-uinT8 FeatureEvidence[MAX_NUM_CONFIGS],
-int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
-int Debug);
-
 #ifndef GRAPHICS_DISABLED
 void IMDebugFeatureProtoError (INT_CLASS ClassTemplate,
 BIT_VECTOR ProtoMask,
 BIT_VECTOR ConfigMask,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
 uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
+ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
 inT16 NumFeatures, int Debug);
 
 void IMDisplayProtoDebugInfo (INT_CLASS ClassTemplate,
 BIT_VECTOR ProtoMask,
 BIT_VECTOR ConfigMask,
 uinT8
-ProtoEvidence[MAX_NUM_PROTOS][MAX_PROTO_INDEX],
+ProtoEvidence[MAX_NUM_PROTOS][PROTO_EVIDENCE_STRIDE],
 int Debug);
-
-void IMDisplayFeatureDebugInfo(INT_CLASS ClassTemplate,
-                               BIT_VECTOR ProtoMask,
-                               BIT_VECTOR ConfigMask,
-                               inT16 NumFeatures,
-                               INT_FEATURE_ARRAY Features,
-                               int Debug);
 #endif
 
 void IMUpdateSumOfProtoEvidences (INT_CLASS ClassTemplate,
@@ -178,25 +258,24 @@ BIT_VECTOR ConfigMask,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
 uinT8
 ProtoEvidence[MAX_NUM_PROTOS]
-[MAX_PROTO_INDEX], inT16 NumFeatures);
+[PROTO_EVIDENCE_STRIDE], inT16 NumFeatures);
 
 void IMNormalizeSumOfEvidences (INT_CLASS ClassTemplate,
 int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
 inT16 NumFeatures, inT32 used_features);
 
-int IMFindBestMatch (INT_CLASS ClassTemplate,
-int SumOfFeatureEvidence[MAX_NUM_CONFIGS],
-uinT16 BlobLength,
-uinT8 NormalizationFactor, INT_RESULT Result);
-
-#ifndef GRAPHICS_DISABLED
-void IMDebugBestMatch(int BestMatch,
-                      INT_RESULT Result,
-                      uinT16 BlobLength,
-                      uinT8 NormalizationFactor);
-#endif
-
-void HeapSort (int n, register int ra[], register int rb[]);
+bool ClassPrunerSIMD(INT_TEMPLATES IntTemplates,
+                     inT16 NumFeatures,
+                     INT_FEATURE_ARRAY Features,
+                     int *ClassCount);
+
+int SelectPrunedClasses(int NumClasses,
+                        const int *NormCount,
+                        int MinCount,
+                        int MaxKey,
+                        int *KeyCount,
+                        int *SortKey,
+                        int *SortIndex);
 
 /**----------------------------------------------------------------------------
         Global Data Definitions and Declarations
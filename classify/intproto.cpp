@@ -763,6 +763,7 @@ INT_TEMPLATES NewIntTemplates() {
   T = (INT_TEMPLATES) Emalloc (sizeof (INT_TEMPLATES_STRUCT));
   T->NumClasses = 0;
   T->NumClassPruners = 0;
+  T->ClassPrunersMapped = FALSE;
 
   for (i = 0; i < MAX_NUM_CLASSES; i++)
     ClassForClassId (T, i) = NULL;
@@ -777,8 +778,10 @@ void free_int_templates(INT_TEMPLATES templates) {
 
   for (i = 0; i < templates->NumClasses; i++)
     free_int_class(templates->Class[i]);
-  for (i = 0; i < templates->NumClassPruners; i++)
-    Efree (templates->ClassPruner[i]);
+  if (!templates->ClassPrunersMapped) {
+    for (i = 0; i < templates->NumClassPruners; i++)
+      Efree (templates->ClassPruner[i]);
+  }
   Efree(templates);
 }
 
@@ -913,28 +916,45 @@ INT_TEMPLATES Classify::ReadIntTemplates(FILE *File) {
     }
   }
 
-  /* then read in the class pruners */
-  for (i = 0; i < Templates->NumClassPruners; i++) {
-    Pruner = (CLASS_PRUNER) Emalloc (sizeof (CLASS_PRUNER_STRUCT));
-    if ((nread =
-         fread ((char *) Pruner, 1, sizeof (CLASS_PRUNER_STRUCT),
-                File)) != sizeof (CLASS_PRUNER_STRUCT))
-      cprintf ("Bad read of inttemp!\n");
-    if (swap) {
-      for (x = 0; x < NUM_CP_BUCKETS; x++) {
-        for (y = 0; y < NUM_CP_BUCKETS; y++) {
-          for (z = 0; z < NUM_CP_BUCKETS; z++) {
-            for (w = 0; w < WERDS_PER_CP_VECTOR; w++) {
-              reverse32 (&Pruner[x][y][z][w]);
+  /* then read in the class pruners, using them in place if the traineddata
+     file is memory-mapped and they are in the current format */
+  const char *MappedPruners = NULL;
+  if (version_id >= 2 && !swap && File == tessdata_manager.GetDataFilePtr()) {
+    MappedPruners = tessdata_manager.GetMappedData(
+        kInttempAlignment,
+        Templates->NumClassPruners * sizeof(CLASS_PRUNER_STRUCT));
+  }
+  if (MappedPruners != NULL) {
+    for (i = 0; i < Templates->NumClassPruners; i++) {
+      Templates->ClassPruner[i] = (CLASS_PRUNER)
+        (MappedPruners + i * sizeof(CLASS_PRUNER_STRUCT));
+    }
+    Templates->ClassPrunersMapped = TRUE;
+    fseek(File, Templates->NumClassPruners * sizeof(CLASS_PRUNER_STRUCT),
+          SEEK_CUR);
+  } else {
+    for (i = 0; i < Templates->NumClassPruners; i++) {
+      Pruner = (CLASS_PRUNER) Emalloc (sizeof (CLASS_PRUNER_STRUCT));
+      if ((nread =
+           fread ((char *) Pruner, 1, sizeof (CLASS_PRUNER_STRUCT),
+                  File)) != sizeof (CLASS_PRUNER_STRUCT))
+        cprintf ("Bad read of inttemp!\n");
+      if (swap) {
+        for (x = 0; x < NUM_CP_BUCKETS; x++) {
+          for (y = 0; y < NUM_CP_BUCKETS; y++) {
+            for (z = 0; z < NUM_CP_BUCKETS; z++) {
+              for (w = 0; w < WERDS_PER_CP_VECTOR; w++) {
+                reverse32 (&Pruner[x][y][z][w]);
+              }
             }
           }
         }
       }
-    }
-    if (version_id < 2) {
-      TempClassPruner[i] = Pruner;
-    } else {
-      Templates->ClassPruner[i] = Pruner;
+      if (version_id < 2) {
+        TempClassPruner[i] = Pruner;
+      } else {
+        Templates->ClassPruner[i] = Pruner;
+      }
     }
   }
 
@@ -148,6 +148,9 @@ typedef struct
   int NumClassPruners;
   INT_CLASS Class[MAX_NUM_CLASSES];
   CLASS_PRUNER ClassPruner[MAX_NUM_CLASS_PRUNERS];
+  /* true if the class pruners point into a memory-mapped traineddata file
+     and must not be freed */
+  BOOL8 ClassPrunersMapped;
 }
 
 
@@ -247,6 +250,8 @@ void DisplayIntProto(INT_CLASS Class, PROTO_ID ProtoId, FLOAT32 Evidence);
 
 INT_CLASS NewIntClass(int MaxNumProtos, int MaxNumConfigs);
 
+void free_int_class(INT_CLASS int_class);
+
 INT_TEMPLATES NewIntTemplates();
 
 void free_int_templates(INT_TEMPLATES templates);
@@ -0,0 +1,520 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimd.cpp
+// Description: SIMD kernels of the integer classifier.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "intsimd.h"
+#include "intmatcher.h"
+
+#ifdef TESS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef TESS_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+// The kernels below read the two words of a pruner cell as one 32-bit
+// value broadcast to all lanes. Each 16-bit lane then holds either the low
+// or the high half word, alternately, so lanes 2k and 2k + 1 see the 2-bit
+// entries of classes k and k + 8 at bits 2k and 2k + 1. Multiplying lane
+// pair k by 1 << (14 - 2k) moves the entry to the top two bits of the lane,
+// from where a shift by 14 extracts it.
+
+// Copies the 16-bit lane counts of one pruner word, in the interleaved
+// order described above, to the class counts of its CLASSES_PER_CP_WERD
+// classes.
+static void ScatterWordCounts(const uinT16 *lanes, int *counts) {
+  for (int k = 0; k < CLASSES_PER_CP_WERD / 2; ++k) {
+    counts[k] = lanes[2 * k];
+    counts[k + CLASSES_PER_CP_WERD / 2] = lanes[2 * k + 1];
+  }
+}
+
+// Returns true if maps is the identity mapping, which needs no lookup.
+static bool IsIdentityMap(const inT32 maps[4]) {
+  return maps[0] == 0 && maps[1] == 1 && maps[2] == 2 && maps[3] == 3;
+}
+
+#ifdef TESS_SIMD_SSE2
+// Replaces each 2-bit entry in the lanes of entries with its mapped value.
+TESS_TARGET_SSE2
+static inline __m128i MapEntriesSSE2(__m128i entries,
+                                     const __m128i map_values[4]) {
+  __m128i result = _mm_setzero_si128();
+  for (int i = 0; i < 4; ++i) {
+    __m128i is_i = _mm_cmpeq_epi16(entries, _mm_set1_epi16(i));
+    result = _mm_or_si128(result, _mm_and_si128(is_i, map_values[i]));
+  }
+  return result;
+}
+
+TESS_TARGET_SSE2
+void ClassPrunerCountsSSE2(const CLASS_PRUNER *pruners, int num_pruners,
+                           const int *offsets, int num_features,
+                           const inT32 maps[4], int *class_counts) {
+  // Multipliers for classes 0-3 (and 8-11), then 4-7 (and 12-15).
+  const __m128i mult_low = _mm_set_epi16(1 << 8, 1 << 8, 1 << 10, 1 << 10,
+                                         1 << 12, 1 << 12, 1 << 14, 1 << 14);
+  const __m128i mult_high = _mm_set_epi16(1 << 0, 1 << 0, 1 << 2, 1 << 2,
+                                          1 << 4, 1 << 4, 1 << 6, 1 << 6);
+  const bool identity = IsIdentityMap(maps);
+  __m128i map_values[4];
+  for (int i = 0; i < 4; ++i)
+    map_values[i] = _mm_set1_epi16(static_cast<short>(maps[i]));
+  uinT16 lanes[CLASSES_PER_CP];
+
+  for (int p = 0; p < num_pruners; ++p) {
+    const uinT32 *pruner = reinterpret_cast<const uinT32 *>(pruners[p]);
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128();
+    __m128i acc3 = _mm_setzero_si128();
+    for (int f = 0; f < num_features; ++f) {
+      const uinT32 *cell = pruner + offsets[f];
+      __m128i word0 = _mm_set1_epi32(static_cast<int>(cell[0]));
+      __m128i word1 = _mm_set1_epi32(static_cast<int>(cell[1]));
+      __m128i e0 = _mm_srli_epi16(_mm_mullo_epi16(word0, mult_low), 14);
+      __m128i e1 = _mm_srli_epi16(_mm_mullo_epi16(word0, mult_high), 14);
+      __m128i e2 = _mm_srli_epi16(_mm_mullo_epi16(word1, mult_low), 14);
+      __m128i e3 = _mm_srli_epi16(_mm_mullo_epi16(word1, mult_high), 14);
+      if (!identity) {
+        e0 = MapEntriesSSE2(e0, map_values);
+        e1 = MapEntriesSSE2(e1, map_values);
+        e2 = MapEntriesSSE2(e2, map_values);
+        e3 = MapEntriesSSE2(e3, map_values);
+      }
+      acc0 = _mm_add_epi16(acc0, e0);
+      acc1 = _mm_add_epi16(acc1, e1);
+      acc2 = _mm_add_epi16(acc2, e2);
+      acc3 = _mm_add_epi16(acc3, e3);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc0);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 8), acc1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 16), acc2);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes + 24), acc3);
+    int *counts = class_counts + p * CLASSES_PER_CP;
+    ScatterWordCounts(lanes, counts);
+    ScatterWordCounts(lanes + CLASSES_PER_CP_WERD,
+                      counts + CLASSES_PER_CP_WERD);
+  }
+}
+#endif  // TESS_SIMD_SSE2
+
+#ifdef TESS_SIMD_AVX2
+// Replaces each 2-bit entry in the lanes of entries with its mapped value.
+TESS_TARGET_AVX2
+static inline __m256i MapEntriesAVX2(__m256i entries,
+                                     const __m256i map_values[4]) {
+  __m256i result = _mm256_setzero_si256();
+  for (int i = 0; i < 4; ++i) {
+    __m256i is_i = _mm256_cmpeq_epi16(entries, _mm256_set1_epi16(i));
+    result = _mm256_or_si256(result, _mm256_and_si256(is_i, map_values[i]));
+  }
+  return result;
+}
+
+TESS_TARGET_AVX2
+void ClassPrunerCountsAVX2(const CLASS_PRUNER *pruners, int num_pruners,
+                           const int *offsets, int num_features,
+                           const inT32 maps[4], int *class_counts) {
+  // Multipliers for all 16 classes of a pruner word.
+  const __m256i mult = _mm256_set_epi16(1 << 0, 1 << 0, 1 << 2, 1 << 2,
+                                        1 << 4, 1 << 4, 1 << 6, 1 << 6,
+                                        1 << 8, 1 << 8, 1 << 10, 1 << 10,
+                                        1 << 12, 1 << 12, 1 << 14, 1 << 14);
+  const bool identity = IsIdentityMap(maps);
+  __m256i map_values[4];
+  for (int i = 0; i < 4; ++i)
+    map_values[i] = _mm256_set1_epi16(static_cast<short>(maps[i]));
+  uinT16 lanes[CLASSES_PER_CP];
+
+  for (int p = 0; p < num_pruners; ++p) {
+    const uinT32 *pruner = reinterpret_cast<const uinT32 *>(pruners[p]);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    for (int f = 0; f < num_features; ++f) {
+      const uinT32 *cell = pruner + offsets[f];
+      __m256i word0 = _mm256_set1_epi32(static_cast<int>(cell[0]));
+      __m256i word1 = _mm256_set1_epi32(static_cast<int>(cell[1]));
+      __m256i e0 = _mm256_srli_epi16(_mm256_mullo_epi16(word0, mult), 14);
+      __m256i e1 = _mm256_srli_epi16(_mm256_mullo_epi16(word1, mult), 14);
+      if (!identity) {
+        e0 = MapEntriesAVX2(e0, map_values);
+        e1 = MapEntriesAVX2(e1, map_values);
+      }
+      acc0 = _mm256_add_epi16(acc0, e0);
+      acc1 = _mm256_add_epi16(acc1, e1);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), acc0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes + 16), acc1);
+    int *counts = class_counts + p * CLASSES_PER_CP;
+    ScatterWordCounts(lanes, counts);
+    ScatterWordCounts(lanes + CLASSES_PER_CP_WERD,
+                      counts + CLASSES_PER_CP_WERD);
+  }
+}
+#endif  // TESS_SIMD_AVX2
+
+// The integer matcher kernels below assume that a proto evidence row is
+// exactly 32 bytes: one AVX2 vector or two SSE2 vectors. A row is kept
+// sorted in descending order, so inserting the evidence e and dropping the
+// smallest value gives, at each position i, max(r[i], min(r[i - 1], e)),
+// with r[-1] taken as 255. Bytes beyond the proto length stay zero.
+
+#ifdef TESS_SIMD_SSE2
+// Returns the sum of the two 64-bit lanes of sums, as left by psadbw.
+TESS_TARGET_SSE2
+static inline int HorizontalSumSSE2(__m128i sums) {
+  return _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+}
+
+TESS_TARGET_SSE2
+static void IMApplyProtoEvidencesSSE2(int num_protos,
+                                      const uinT16 *proto_ids,
+                                      const uinT8 *evidence,
+                                      const uinT32 *config_words,
+                                      const uinT8 *proto_lengths,
+                                      uinT8 *feature_evidence,
+                                      uinT8 *proto_evidence) {
+  const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                     1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i index_low = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                          8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i index_high = _mm_add_epi8(index_low, _mm_set1_epi8(16));
+  const __m128i first_byte = _mm_setr_epi8(-1, 0, 0, 0, 0, 0, 0, 0,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+  __m128i *configs = reinterpret_cast<__m128i *>(feature_evidence);
+  __m128i configs_low = _mm_load_si128(configs);
+  __m128i configs_high = _mm_load_si128(configs + 1);
+
+  for (int i = 0; i < num_protos; ++i) {
+    __m128i e = _mm_set1_epi8(static_cast<char>(evidence[i]));
+    // Spread the config bits to one byte per config: bytes 8k to 8k + 7
+    // all get byte k of the word, and each tests its own bit.
+    __m128i word = _mm_set1_epi32(static_cast<int>(config_words[i]));
+    word = _mm_unpacklo_epi8(word, word);
+    word = _mm_unpacklo_epi16(word, word);
+    __m128i mask_low = _mm_unpacklo_epi32(word, word);
+    __m128i mask_high = _mm_unpackhi_epi32(word, word);
+    mask_low = _mm_cmpeq_epi8(_mm_and_si128(mask_low, bits), bits);
+    mask_high = _mm_cmpeq_epi8(_mm_and_si128(mask_high, bits), bits);
+    configs_low = _mm_max_epu8(configs_low, _mm_and_si128(mask_low, e));
+    configs_high = _mm_max_epu8(configs_high, _mm_and_si128(mask_high, e));
+
+    __m128i *row = reinterpret_cast<__m128i *>(
+        proto_evidence + proto_ids[i] * PROTO_EVIDENCE_STRIDE);
+    __m128i row_low = _mm_load_si128(row);
+    __m128i row_high = _mm_load_si128(row + 1);
+    __m128i prev_low = _mm_or_si128(_mm_slli_si128(row_low, 1), first_byte);
+    __m128i prev_high = _mm_or_si128(_mm_slli_si128(row_high, 1),
+                                     _mm_srli_si128(row_low, 15));
+    __m128i length = _mm_set1_epi8(static_cast<char>(
+        proto_lengths[proto_ids[i]]));
+    row_low = _mm_max_epu8(row_low, _mm_min_epu8(prev_low, e));
+    row_high = _mm_max_epu8(row_high, _mm_min_epu8(prev_high, e));
+    row_low = _mm_and_si128(row_low, _mm_cmpgt_epi8(length, index_low));
+    row_high = _mm_and_si128(row_high, _mm_cmpgt_epi8(length, index_high));
+    _mm_store_si128(row, row_low);
+    _mm_store_si128(row + 1, row_high);
+  }
+  _mm_store_si128(configs, configs_low);
+  _mm_store_si128(configs + 1, configs_high);
+}
+
+TESS_TARGET_SSE2
+static int IMAddFeatureEvidenceSSE2(const uinT8 *feature_evidence,
+                                    int num_configs,
+                                    int *sum_of_feature_evidence) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+  __m128i total = zero;
+  for (int c = 0; c < num_configs; c += 16) {
+    // Configs from num_configs on are masked out of this block.
+    __m128i in_range = _mm_cmpgt_epi8(
+        _mm_set1_epi8(static_cast<char>(num_configs - c)), index);
+    __m128i e = _mm_and_si128(in_range, _mm_load_si128(
+        reinterpret_cast<const __m128i *>(feature_evidence + c)));
+    total = _mm_add_epi64(total, _mm_sad_epu8(e, zero));
+    __m128i e_low = _mm_unpacklo_epi8(e, zero);
+    __m128i e_high = _mm_unpackhi_epi8(e, zero);
+    __m128i e32[4] = {
+      _mm_unpacklo_epi16(e_low, zero), _mm_unpackhi_epi16(e_low, zero),
+      _mm_unpacklo_epi16(e_high, zero), _mm_unpackhi_epi16(e_high, zero)
+    };
+    __m128i *sums = reinterpret_cast<__m128i *>(sum_of_feature_evidence + c);
+    for (int k = 0; k < 4; ++k)
+      _mm_store_si128(sums + k, _mm_add_epi32(_mm_load_si128(sums + k),
+                                              e32[k]));
+  }
+  return HorizontalSumSSE2(total);
+}
+
+TESS_TARGET_SSE2
+static void IMUpdateSumOfProtoEvidencesSSE2(INT_CLASS class_template,
+                                            uinT32 config_mask,
+                                            const uinT8 *proto_evidence,
+                                            int *sum_of_feature_evidence) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i bits[8];
+  __m128i sums[8];
+  __m128i *sum_ptr = reinterpret_cast<__m128i *>(sum_of_feature_evidence);
+  for (int j = 0; j < 8; ++j) {
+    bits[j] = _mm_setr_epi32(1 << (4 * j), 2 << (4 * j),
+                             4 << (4 * j), 8 << (4 * j));
+    sums[j] = _mm_load_si128(sum_ptr + j);
+  }
+  int num_protos = class_template->NumProtos;
+  for (int p = 0; p < num_protos; ++p) {
+    PROTO_SET proto_set = class_template->ProtoSets[p / PROTOS_PER_PROTO_SET];
+    uinT32 config_word =
+      proto_set->Protos[p % PROTOS_PER_PROTO_SET].Configs[0] & config_mask;
+    if (config_word == 0)
+      continue;
+    const __m128i *row = reinterpret_cast<const __m128i *>(
+        proto_evidence + p * PROTO_EVIDENCE_STRIDE);
+    __m128i row_sum = _mm_add_epi64(_mm_sad_epu8(_mm_load_si128(row), zero),
+                                    _mm_sad_epu8(_mm_load_si128(row + 1),
+                                                 zero));
+    __m128i temp = _mm_set1_epi32(HorizontalSumSSE2(row_sum));
+    __m128i word = _mm_set1_epi32(static_cast<int>(config_word));
+    for (int j = 0; j < 8; ++j) {
+      __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(word, bits[j]), bits[j]);
+      sums[j] = _mm_add_epi32(sums[j], _mm_and_si128(mask, temp));
+    }
+  }
+  for (int j = 0; j < 8; ++j)
+    _mm_store_si128(sum_ptr + j, sums[j]);
+}
+
+// The quotients below are computed in double precision, which truncates
+// to exactly the integer quotient: numerator and denominator are below
+// 2^31, so a quotient that is not an integer is at least 2^-31 of its
+// value away from the next integer, far more than the rounding error.
+TESS_TARGET_SSE2
+static void IMNormalizeSumOfEvidencesSSE2(INT_CLASS class_template,
+                                          int num_features,
+                                          int *sum_of_feature_evidence) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i features = _mm_set1_epi32(num_features);
+  int num_configs = class_template->NumConfigs;
+  int c = 0;
+  for (; c + 4 <= num_configs; c += 4) {
+    __m128i *sums = reinterpret_cast<__m128i *>(sum_of_feature_evidence + c);
+    __m128i sum = _mm_slli_epi32(_mm_load_si128(sums), 8);
+    __m128i lengths = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(
+        class_template->ConfigLengths + c));
+    lengths = _mm_add_epi32(_mm_unpacklo_epi16(lengths, zero), features);
+    __m128d q_low = _mm_div_pd(_mm_cvtepi32_pd(sum),
+                               _mm_cvtepi32_pd(lengths));
+    __m128d q_high = _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(sum, 8)),
+                                _mm_cvtepi32_pd(_mm_srli_si128(lengths, 8)));
+    _mm_store_si128(sums, _mm_unpacklo_epi64(_mm_cvttpd_epi32(q_low),
+                                             _mm_cvttpd_epi32(q_high)));
+  }
+  for (; c < num_configs; ++c)
+    sum_of_feature_evidence[c] = (sum_of_feature_evidence[c] << 8) /
+      (num_features + class_template->ConfigLengths[c]);
+}
+
+static const IntMatcherKernels kIntMatcherKernelsSSE2 = {
+  IMApplyProtoEvidencesSSE2,
+  IMAddFeatureEvidenceSSE2,
+  IMUpdateSumOfProtoEvidencesSSE2,
+  IMNormalizeSumOfEvidencesSSE2
+};
+#endif  // TESS_SIMD_SSE2
+
+#ifdef TESS_SIMD_AVX2
+// Returns the sum of the four 64-bit lanes of sums, as left by vpsadbw.
+TESS_TARGET_AVX2
+static inline int HorizontalSumAVX2(__m256i sums) {
+  __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                              _mm256_extracti128_si256(sums, 1));
+  return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+}
+
+TESS_TARGET_AVX2
+static void IMApplyProtoEvidencesAVX2(int num_protos,
+                                      const uinT16 *proto_ids,
+                                      const uinT8 *evidence,
+                                      const uinT32 *config_words,
+                                      const uinT8 *proto_lengths,
+                                      uinT8 *feature_evidence,
+                                      uinT8 *proto_evidence) {
+  const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128);
+  // Byte k of the config word for bytes 8k to 8k + 7. pshufb works within
+  // each 128-bit lane, but the word is broadcast to both.
+  const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0,
+                                          1, 1, 1, 1, 1, 1, 1, 1,
+                                          2, 2, 2, 2, 2, 2, 2, 2,
+                                          3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i index = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                         8, 9, 10, 11, 12, 13, 14, 15,
+                                         16, 17, 18, 19, 20, 21, 22, 23,
+                                         24, 25, 26, 27, 28, 29, 30, 31);
+  const __m256i first_byte = _mm256_setr_epi8(-1, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+  __m256i *config_ptr = reinterpret_cast<__m256i *>(feature_evidence);
+  __m256i configs = _mm256_load_si256(config_ptr);
+
+  for (int i = 0; i < num_protos; ++i) {
+    __m256i e = _mm256_set1_epi8(static_cast<char>(evidence[i]));
+    __m256i word = _mm256_set1_epi32(static_cast<int>(config_words[i]));
+    __m256i mask = _mm256_shuffle_epi8(word, spread);
+    mask = _mm256_cmpeq_epi8(_mm256_and_si256(mask, bits), bits);
+    configs = _mm256_max_epu8(configs, _mm256_and_si256(mask, e));
+
+    __m256i *row = reinterpret_cast<__m256i *>(
+        proto_evidence + proto_ids[i] * PROTO_EVIDENCE_STRIDE);
+    __m256i values = _mm256_load_si256(row);
+    // Shift the row up one byte across the two lanes.
+    __m256i prev = _mm256_alignr_epi8(
+        values, _mm256_permute2x128_si256(values, values, 0x08), 15);
+    prev = _mm256_or_si256(prev, first_byte);
+    __m256i length = _mm256_set1_epi8(static_cast<char>(
+        proto_lengths[proto_ids[i]]));
+    values = _mm256_max_epu8(values, _mm256_min_epu8(prev, e));
+    values = _mm256_and_si256(values, _mm256_cmpgt_epi8(length, index));
+    _mm256_store_si256(row, values);
+  }
+  _mm256_store_si256(config_ptr, configs);
+}
+
+TESS_TARGET_AVX2
+static int IMAddFeatureEvidenceAVX2(const uinT8 *feature_evidence,
+                                    int num_configs,
+                                    int *sum_of_feature_evidence) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i index = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                         8, 9, 10, 11, 12, 13, 14, 15,
+                                         16, 17, 18, 19, 20, 21, 22, 23,
+                                         24, 25, 26, 27, 28, 29, 30, 31);
+  __m256i total = zero;
+  for (int c = 0; c < num_configs; c += 32) {
+    // Configs from num_configs on are masked out of this block.
+    __m256i in_range = _mm256_cmpgt_epi8(
+        _mm256_set1_epi8(static_cast<char>(num_configs - c)), index);
+    __m256i e = _mm256_and_si256(in_range, _mm256_load_si256(
+        reinterpret_cast<const __m256i *>(feature_evidence + c)));
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(e, zero));
+    __m128i e_low = _mm256_castsi256_si128(e);
+    __m128i e_high = _mm256_extracti128_si256(e, 1);
+    __m256i e32[4] = {
+      _mm256_cvtepu8_epi32(e_low),
+      _mm256_cvtepu8_epi32(_mm_srli_si128(e_low, 8)),
+      _mm256_cvtepu8_epi32(e_high),
+      _mm256_cvtepu8_epi32(_mm_srli_si128(e_high, 8))
+    };
+    __m256i *sums = reinterpret_cast<__m256i *>(sum_of_feature_evidence + c);
+    for (int k = 0; k < 4; ++k)
+      _mm256_store_si256(sums + k, _mm256_add_epi32(
+          _mm256_load_si256(sums + k), e32[k]));
+  }
+  return HorizontalSumAVX2(total);
+}
+
+TESS_TARGET_AVX2
+static void IMUpdateSumOfProtoEvidencesAVX2(INT_CLASS class_template,
+                                            uinT32 config_mask,
+                                            const uinT8 *proto_evidence,
+                                            int *sum_of_feature_evidence) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i bits[4];
+  __m256i sums[4];
+  __m256i *sum_ptr = reinterpret_cast<__m256i *>(sum_of_feature_evidence);
+  for (int j = 0; j < 4; ++j) {
+    bits[j] = _mm256_setr_epi32(1 << (8 * j), 2 << (8 * j),
+                                4 << (8 * j), 8 << (8 * j),
+                                16 << (8 * j), 32 << (8 * j),
+                                64 << (8 * j),
+                                static_cast<int>(128u << (8 * j)));
+    sums[j] = _mm256_load_si256(sum_ptr + j);
+  }
+  int num_protos = class_template->NumProtos;
+  for (int p = 0; p < num_protos; ++p) {
+    PROTO_SET proto_set = class_template->ProtoSets[p / PROTOS_PER_PROTO_SET];
+    uinT32 config_word =
+      proto_set->Protos[p % PROTOS_PER_PROTO_SET].Configs[0] & config_mask;
+    if (config_word == 0)
+      continue;
+    __m256i row = _mm256_load_si256(reinterpret_cast<const __m256i *>(
+        proto_evidence + p * PROTO_EVIDENCE_STRIDE));
+    __m256i temp = _mm256_set1_epi32(
+        HorizontalSumAVX2(_mm256_sad_epu8(row, zero)));
+    __m256i word = _mm256_set1_epi32(static_cast<int>(config_word));
+    for (int j = 0; j < 4; ++j) {
+      __m256i mask = _mm256_cmpeq_epi32(_mm256_and_si256(word, bits[j]),
+                                        bits[j]);
+      sums[j] = _mm256_add_epi32(sums[j], _mm256_and_si256(mask, temp));
+    }
+  }
+  for (int j = 0; j < 4; ++j)
+    _mm256_store_si256(sum_ptr + j, sums[j]);
+}
+
+// See IMNormalizeSumOfEvidencesSSE2 for why the double quotients are exact.
+TESS_TARGET_AVX2
+static void IMNormalizeSumOfEvidencesAVX2(INT_CLASS class_template,
+                                          int num_features,
+                                          int *sum_of_feature_evidence) {
+  const __m256i features = _mm256_set1_epi32(num_features);
+  int num_configs = class_template->NumConfigs;
+  int c = 0;
+  for (; c + 8 <= num_configs; c += 8) {
+    __m256i *sums = reinterpret_cast<__m256i *>(sum_of_feature_evidence + c);
+    __m256i sum = _mm256_slli_epi32(_mm256_load_si256(sums), 8);
+    __m256i lengths = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(class_template->ConfigLengths + c)));
+    lengths = _mm256_add_epi32(lengths, features);
+    __m256d q_low = _mm256_div_pd(
+        _mm256_cvtepi32_pd(_mm256_castsi256_si128(sum)),
+        _mm256_cvtepi32_pd(_mm256_castsi256_si128(lengths)));
+    __m256d q_high = _mm256_div_pd(
+        _mm256_cvtepi32_pd(_mm256_extracti128_si256(sum, 1)),
+        _mm256_cvtepi32_pd(_mm256_extracti128_si256(lengths, 1)));
+    __m256i q = _mm256_castsi128_si256(_mm256_cvttpd_epi32(q_low));
+    q = _mm256_inserti128_si256(q, _mm256_cvttpd_epi32(q_high), 1);
+    _mm256_store_si256(sums, q);
+  }
+  for (; c < num_configs; ++c)
+    sum_of_feature_evidence[c] = (sum_of_feature_evidence[c] << 8) /
+      (num_features + class_template->ConfigLengths[c]);
+}
+
+static const IntMatcherKernels kIntMatcherKernelsAVX2 = {
+  IMApplyProtoEvidencesAVX2,
+  IMAddFeatureEvidenceAVX2,
+  IMUpdateSumOfProtoEvidencesAVX2,
+  IMNormalizeSumOfEvidencesAVX2
+};
+#endif  // TESS_SIMD_AVX2
+
+const IntMatcherKernels *GetIntMatcherKernels() {
+#ifdef TESS_SIMD_AVX2
+  if (SIMDDetect::IsAVX2Available())
+    return &kIntMatcherKernelsAVX2;
+#endif
+#ifdef TESS_SIMD_SSE2
+  if (SIMDDetect::IsSSE2Available())
+    return &kIntMatcherKernelsSSE2;
+#endif
+  return NULL;
+}
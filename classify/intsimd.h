@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimd.h
+// Description: SIMD kernels of the integer classifier.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_INTSIMD_H__
+#define TESSERACT_CLASSIFY_INTSIMD_H__
+
+#include "host.h"
+#include "intproto.h"
+#include "simddetect.h"
+
+// The class pruner kernels count, for each class of the num_pruners pruners,
+// the entries of num_features pruner cells, mapped through maps. The cells
+// are given by offsets: offsets[f] is the index, in uinT32 words from the
+// start of each pruner, of the WERDS_PER_CP_VECTOR words of feature f.
+// class_counts gets num_pruners * CLASSES_PER_CP counts and is overwritten.
+// The counts are kept in 16 bits, so maps must be non-negative and
+// num_features times the largest map must be below 65536. The results are
+// the same as those of the scalar loop in Classify::ClassPruner.
+#ifdef TESS_SIMD_SSE2
+void ClassPrunerCountsSSE2(const CLASS_PRUNER *pruners, int num_pruners,
+                           const int *offsets, int num_features,
+                           const inT32 maps[4], int *class_counts);
+#endif
+#ifdef TESS_SIMD_AVX2
+void ClassPrunerCountsAVX2(const CLASS_PRUNER *pruners, int num_pruners,
+                           const int *offsets, int num_features,
+                           const inT32 maps[4], int *class_counts);
+#endif
+
+// The kernels of the integer matcher work on the evidence tables of
+// IntegerMatcher, which are aligned to 32 bytes and have proto evidence
+// rows of PROTO_EVIDENCE_STRIDE bytes. They leave the tables exactly as the
+// scalar code in intmatcher.cpp would.
+struct IntMatcherKernels {
+  // Applies, in order, the evidence of the num_protos protos that matched
+  // one feature: proto proto_ids[i] had evidence[i] and the masked config
+  // word config_words[i]. Each config of the word keeps the larger of its
+  // feature evidence and the proto evidence, and the proto evidence row
+  // keeps its proto_lengths[proto_id] largest values in descending order.
+  void (*ApplyProtoEvidences)(int num_protos, const uinT16 *proto_ids,
+                              const uinT8 *evidence,
+                              const uinT32 *config_words,
+                              const uinT8 *proto_lengths,
+                              uinT8 *feature_evidence,
+                              uinT8 *proto_evidence);
+  // Adds the feature evidence of the first num_configs configs to
+  // sum_of_feature_evidence and returns their sum.
+  int (*AddFeatureEvidence)(const uinT8 *feature_evidence, int num_configs,
+                            int *sum_of_feature_evidence);
+  // IMUpdateSumOfProtoEvidences for the configs in config_mask.
+  void (*UpdateSumOfProtoEvidences)(INT_CLASS class_template,
+                                    uinT32 config_mask,
+                                    const uinT8 *proto_evidence,
+                                    int *sum_of_feature_evidence);
+  // IMNormalizeSumOfEvidences.
+  void (*NormalizeSumOfEvidences)(INT_CLASS class_template,
+                                  int num_features,
+                                  int *sum_of_feature_evidence);
+};
+
+// Returns the integer matcher kernels of the widest instruction set the CPU
+// supports, or NULL if there are none.
+const IntMatcherKernels *GetIntMatcherKernels();
+
+#endif  // TESSERACT_CLASSIFY_INTSIMD_H__
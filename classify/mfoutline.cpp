@@ -26,19 +26,13 @@
 #include "const.h"
 #include "mfx.h"
 #include "varable.h"
+#include "wordarena.h"
 
 #include <math.h>
 #include <stdio.h>
 
 #define MIN_INERTIA (0.00001)
 
-/**----------------------------------------------------------------------------
-        Global Data Definitions and Declarations
-----------------------------------------------------------------------------**/
-/* center of current blob being processed - used when "unexpanding"
-  expanded blobs */
-static TPOINT BlobCenter;
-
 /**----------------------------------------------------------------------------
              Variables
 ----------------------------------------------------------------------------**/
@@ -98,11 +92,12 @@ LIST ConvertBlob(TBLOB *Blob) {
  **	History: Thu Dec 13 15:40:17 1990, DSJ, Created.
  */
   LIST ConvertedOutlines = NIL;
+  TPOINT BlobCenter;
 
   if (Blob != NULL) {
-    SettupBlobConversion(Blob);  //ComputeBlobCenter (Blob, &BlobCenter);
+    ComputeBlobCenter(Blob, &BlobCenter);
     ConvertedOutlines = ConvertOutlines (Blob->outlines,
-      ConvertedOutlines, outer);
+      ConvertedOutlines, outer, &BlobCenter);
   }
 
   return (ConvertedOutlines);
@@ -110,12 +105,12 @@ LIST ConvertBlob(TBLOB *Blob) {
 
 
 /*---------------------------------------------------------------------------*/
-MFOUTLINE ConvertOutline(TESSLINE *Outline) {
+MFOUTLINE ConvertOutline(TESSLINE *Outline, const TPOINT *BlobCenter) {
 /*
  **	Parameters:
  **		Outline		outline to be converted
- **	Globals:
- **		BlobCenter	pre-computed center of current blob
+ **		BlobCenter	pre-computed center of the blob of Outline
+ **	Globals: none
  **	Operation:
  **		This routine converts the specified outline into a special
  **		data structure which is used for extracting micro-features.
@@ -124,7 +119,7 @@ MFOUTLINE ConvertOutline(TESSLINE *Outline) {
  **		do is copy the points.  Otherwise,
  **		if the outline is expanded, then the expanded form is used
  **		and the coordinates of the points are returned to page
- **		coordinates using the global variable BlobCenter and the
+ **		coordinates using BlobCenter and the
  **		scaling factor REALSCALE.  If the outline is not expanded,
  **		then the compressed form is used.
  **	Return: Outline converted into special micro-features format.
@@ -206,9 +201,9 @@ MFOUTLINE ConvertOutline(TESSLINE *Outline) {
         ClearMark(NewPoint);
         NewPoint->Hidden = is_hidden_edge (EdgePoint) ? TRUE : FALSE;
         NewPoint->Point.x =
-          (EdgePoint->pos.x + BlobCenter.x) / REALSCALE;
+          (EdgePoint->pos.x + BlobCenter->x) / REALSCALE;
         NewPoint->Point.y =
-          (EdgePoint->pos.y + BlobCenter.y) / REALSCALE;
+          (EdgePoint->pos.y + BlobCenter->y) / REALSCALE;
         MFOutline = push (MFOutline, NewPoint);
       }
       EdgePoint = NextPoint;
@@ -225,12 +220,14 @@ MFOUTLINE ConvertOutline(TESSLINE *Outline) {
 /*---------------------------------------------------------------------------*/
 LIST ConvertOutlines(TESSLINE *Outline,
                      LIST ConvertedOutlines,
-                     OUTLINETYPE OutlineType) {
+                     OUTLINETYPE OutlineType,
+                     const TPOINT *BlobCenter) {
 /*
  **	Parameters:
  **		Outline			first outline to be converted
  **		ConvertedOutlines	list to add converted outlines to
  **		OutlineType		are the outlines outer or holes?
+ **		BlobCenter		pre-computed center of their blob
  **	Globals: none
  **	Operation:
  **              This routine converts all given outlines into a new format.
@@ -249,13 +246,13 @@ LIST ConvertOutlines(TESSLINE *Outline,
     if (Outline->child != NULL) {
       if (OutlineType == outer)
         ConvertedOutlines = ConvertOutlines (Outline->child,
-          ConvertedOutlines, hole);
+          ConvertedOutlines, hole, BlobCenter);
       else
         ConvertedOutlines = ConvertOutlines (Outline->child,
-          ConvertedOutlines, outer);
+          ConvertedOutlines, outer, BlobCenter);
     }
 
-    MFOutline = ConvertOutline (Outline);
+    MFOutline = ConvertOutline (Outline, BlobCenter);
     ConvertedOutlines = push (ConvertedOutlines, MFOutline);
     Outline = Outline->next;
   }
@@ -440,7 +437,7 @@ void FreeMFOutline(void *arg) {  //MFOUTLINE                             Outline
   Start = rest (Outline);
   set_rest(Outline, NIL);
   while (Start != NULL) {
-    free_struct (first_node (Start), sizeof (MFEDGEPT), "MFEDGEPT");
+    tesseract::WordArena::Delete(first_node (Start), sizeof (MFEDGEPT));
     Start = pop (Start);
   }
 
@@ -507,12 +504,13 @@ MFEDGEPT *NewEdgePoint() {
  **	Globals: none
  **	Operation:
  **		This routine allocates and returns a new edge point for
- **		a micro-feature outline.
+ **		a micro-feature outline, from the word arena while a word
+ **		is being recognized.
  **	Return: New edge point.
  **	Exceptions: none
  **	History: 7/21/89, DSJ, Created.
  */
-  return ((MFEDGEPT *) alloc_struct (sizeof (MFEDGEPT), "MFEDGEPT"));
+  return ((MFEDGEPT *) tesseract::WordArena::New (sizeof (MFEDGEPT)));
 
 }                                /* NewEdgePoint */
 
@@ -606,19 +604,20 @@ void NormalizeOutline(MFOUTLINE Outline,
 /*---------------------------------------------------------------------------*/
 void NormalizeOutlines(LIST Outlines,
                        LINE_STATS *LineStats,
+                       NORM_METHOD NormMethod,
                        FLOAT32 *XScale,
                        FLOAT32 *YScale) {
 /*
  **	Parameters:
  **		Outlines	list of outlines to be normalized
  **		LineStats	statistics for text line normalization
+ **		NormMethod	normalization method to use
  **		XScale		x-direction scale factor used by routine
  **		YScale		y-direction scale factor used by routine
  **	Globals:
- **   classify_norm_method  method being used for normalization
  **   classify_char_norm_range map radius of gyration to this value
  **	Operation: This routine normalizes every outline in Outlines
- **		according to the currently selected normalization method.
+ **		according to NormMethod.
  **		It also returns the scale factors that it used to do this
  **		scaling.  The scale factors returned represent the x and
  **		y sizes in the normalized coordinate system that correspond
@@ -631,7 +630,7 @@ void NormalizeOutlines(LIST Outlines,
   OUTLINE_STATS OutlineStats;
   FLOAT32 BaselineScale;
 
-  switch (classify_norm_method) {
+  switch (NormMethod) {
     case character:
       ComputeOutlineStats(Outlines, &OutlineStats);
 
@@ -669,25 +668,6 @@ void NormalizeOutlines(LIST Outlines,
 }                                /* NormalizeOutlines */
 
 
-/*---------------------------------------------------------------------------*/
-void SettupBlobConversion(TBLOB *Blob) {
-/*
- **	Parameters:
- **		Blob		blob that is to be converted
- **	Globals:
- **		BlobCenter	center of blob to be converted
- **	Operation: Compute the center of the blob's bounding box and save
- **		it in a global variable.  This routine must be called before
- **		any calls to ConvertOutline.  It must be called once per
- **		blob.
- **	Return: none
- **	Exceptions: none
- **	History: Thu May 17 11:06:17 1990, DSJ, Created.
- */
-  ComputeBlobCenter(Blob, &BlobCenter);
-}                                /* SettupBlobConversion */
-
-
 /*---------------------------------------------------------------------------*/
 void SmearExtremities(MFOUTLINE Outline, FLOAT32 XScale, FLOAT32 YScale) {
 /*
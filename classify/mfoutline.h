@@ -133,11 +133,12 @@ void ComputeBlobCenter(TBLOB *Blob, TPOINT *BlobCenter);
 
 LIST ConvertBlob(TBLOB *Blob);
 
-MFOUTLINE ConvertOutline(TESSLINE *Outline);
+MFOUTLINE ConvertOutline(TESSLINE *Outline, const TPOINT *BlobCenter);
 
 LIST ConvertOutlines(TESSLINE *Outline,
                      LIST ConvertedOutlines,
-                     OUTLINETYPE OutlineType);
+                     OUTLINETYPE OutlineType,
+                     const TPOINT *BlobCenter);
 
 void ComputeOutlineStats(LIST Outlines, OUTLINE_STATS *OutlineStats);
 
@@ -163,11 +164,10 @@ void NormalizeOutline(MFOUTLINE Outline,
 
 void NormalizeOutlines(LIST Outlines,
                        LINE_STATS *LineStats,
+                       NORM_METHOD NormMethod,
                        FLOAT32 *XScale,
                        FLOAT32 *YScale);
 
-void SettupBlobConversion(TBLOB *Blob);
-
 void SmearExtremities(MFOUTLINE Outline, FLOAT32 XScale, FLOAT32 YScale);
 
 /*----------------------------------------------------------------------------
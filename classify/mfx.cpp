@@ -88,10 +88,10 @@ CHAR_FEATURES BlobMicroFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
   INT_FX_RESULT_STRUCT results;
 
   if (Blob != NULL) {
-    Outlines = ConvertBlob (Blob);
-//    NormalizeOutlines(Outlines, LineStats, &XScale, &YScale);
     if (!ExtractIntFeat(Blob, blfeatures, cnfeatures, &results))
       return NULL;
+    Outlines = ConvertBlob (Blob);
+//    NormalizeOutlines(Outlines, LineStats, &XScale, &YScale);
     XScale = 0.2f / results.Ry;
     YScale = 0.2f / results.Rx;
 
@@ -74,7 +74,6 @@ FEATURE_SET ExtractCharNormFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
   FEATURE Feature;
   FLOAT32 Scale;
   FLOAT32 Baseline;
-  LIST Outlines;
   INT_FEATURE_ARRAY blfeatures;
   INT_FEATURE_ARRAY cnfeatures;
   INT_FX_RESULT_STRUCT FXInfo;
@@ -86,23 +85,6 @@ FEATURE_SET ExtractCharNormFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
   AddFeature(FeatureSet, Feature); 
 
   /* compute the normalization statistics for this blob */
-  Outlines = ConvertBlob (Blob);
-  /*---------Debug--------------------------------------------------*
-  OFile = fopen ("f:/ims/debug/nfOutline.logCPP", "r");
-  if (OFile == NULL)
-  {
-    OFile = Efopen ("f:/ims/debug/nfOutline.logCPP", "w");
-    WriteOutlines(OFile, Outlines);
-  }
-  else
-  {
-    fclose (OFile);
-    OFile = Efopen ("f:/ims/debug/nfOutline.logCPP", "a");
-  }
-  WriteOutlines(OFile, Outlines);
-  fclose (OFile);
-  *--------------------------------------------------------------------*/
-
   ExtractIntFeat(Blob, blfeatures, cnfeatures, &FXInfo);
   Baseline = BaselineAt (LineStats, FXInfo.Xmean);
   Scale = ComputeScaleFactor (LineStats);
@@ -127,6 +109,5 @@ FEATURE_SET ExtractCharNormFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
   WriteFeatureSet(File, FeatureSet);
   fclose (File);
   *--------------------------------------------------------------------*/
-  FreeOutlines(Outlines); 
   return (FeatureSet);
 }                                /* ExtractCharNormFeatures */
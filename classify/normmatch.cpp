@@ -239,8 +239,11 @@ NORM_PROTOS *Classify::ReadNormProtos(FILE *File, inT64 end_offset) {
   NormProtos->NumParams = ReadSampleSize (File);
   NormProtos->ParamDesc = ReadParamDesc (File, NormProtos->NumParams);
 
-  /* read protos for each class into a separate list */
-  while ((end_offset < 0 || ftell(File) < end_offset) &&
+  /* read protos for each class into a separate list, skipping white space
+     first so that the newlines padding a combined file up to the end offset
+     are not taken for another class */
+  while (fscanf(File, " ") != EOF &&
+         (end_offset < 0 || ftell(File) < end_offset) &&
          fscanf(File, "%s %d", unichar, &NumProtos) == 2) {
     if (unicharset.contains_unichar(unichar)) {
       unichar_id = unicharset.unichar_to_id(unichar);
@@ -29,11 +29,13 @@
               Public Code
 ----------------------------------------------------------------------------**/
 /*---------------------------------------------------------------------------*/
-FEATURE_SET ExtractOutlineFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
+FEATURE_SET ExtractOutlineFeatures(TBLOB *Blob, LINE_STATS *LineStats,
+                                   NORM_METHOD NormMethod) {
 /*
  **	Parameters:
  **		Blob		blob to extract pico-features from
  **		LineStats	statistics on text row blob is in
+ **		NormMethod	normalization method to use
  **	Globals: none
  **	Operation: Convert each segment in the outline to a feature
  **		and return the features.
@@ -54,13 +56,13 @@ FEATURE_SET ExtractOutlineFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
 
   Outlines = ConvertBlob (Blob);
 
-  NormalizeOutlines(Outlines, LineStats, &XScale, &YScale);
+  NormalizeOutlines(Outlines, LineStats, NormMethod, &XScale, &YScale);
   RemainingOutlines = Outlines;
   iterate(RemainingOutlines) {
     Outline = (MFOUTLINE) first_node (RemainingOutlines);
     ConvertToOutlineFeatures(Outline, FeatureSet);
   }
-  if (classify_norm_method == baseline)
+  if (NormMethod == baseline)
     NormalizeOutlineX(FeatureSet);
   FreeOutlines(Outlines);
   return (FeatureSet);
@@ -36,7 +36,8 @@ typedef enum {
 /**----------------------------------------------------------------------------
           Public Function Prototypes
 ----------------------------------------------------------------------------**/
-FEATURE_SET ExtractOutlineFeatures(TBLOB *Blob, LINE_STATS *LineStats); 
+FEATURE_SET ExtractOutlineFeatures(TBLOB *Blob, LINE_STATS *LineStats,
+                                   NORM_METHOD NormMethod);
 
 /*---------------------------------------------------------------------------
           Privat Function Prototypes
@@ -51,13 +51,14 @@ void NormalizePicoX(FEATURE_SET FeatureSet);
               Public Code
 ----------------------------------------------------------------------------**/
 /*---------------------------------------------------------------------------*/
-FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
+FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats,
+                                NORM_METHOD NormMethod) {
 /*
  **	Parameters:
  **		Blob		blob to extract pico-features from
  **		LineStats	statistics on text row blob is in
- **	Globals:
- **		classify_norm_method	normalization method currently specified
+ **		NormMethod	normalization method to use
+ **	Globals: none
  **	Operation: Dummy for now.
  **	Return: Pico-features for Blob.
  **	Exceptions: none
@@ -73,7 +74,7 @@ FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
 
   Outlines = ConvertBlob (Blob);
 
-  NormalizeOutlines(Outlines, LineStats, &XScale, &YScale);
+  NormalizeOutlines(Outlines, LineStats, NormMethod, &XScale, &YScale);
   RemainingOutlines = Outlines;
   iterate(RemainingOutlines) {
     Outline = (MFOUTLINE) first_node (RemainingOutlines);
@@ -94,7 +95,7 @@ FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats) {
     *--------------------------------------------------------------------*/
     ConvertToPicoFeatures2(Outline, FeatureSet);
   }
-  if (classify_norm_method == baseline)
+  if (NormMethod == baseline)
     NormalizePicoX(FeatureSet);
   /*---------Debug--------------------------------------------------*
   File = fopen ("f:/ims/debug/pfFeatSet.logCPP", "r");
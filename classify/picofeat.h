@@ -25,6 +25,7 @@
 #include "tessclas.h"
 #include "fxdefs.h"
 #include "varable.h"
+#include "mfoutline.h"
 
 typedef enum
 { PicoFeatY, PicoFeatDir, PicoFeatX }
@@ -44,7 +45,8 @@ extern double_VAR_H(classify_pico_feature_length, 0.05, "Pico Feature Length");
 ----------------------------------------------------------------------------**/
 #define GetPicoFeatureLength()  (PicoFeatureLength)
 
-FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats); 
+FEATURE_SET ExtractPicoFeatures(TBLOB *Blob, LINE_STATS *LineStats,
+                                NORM_METHOD NormMethod);
 
 /**----------------------------------------------------------------------------
         Global Data Definitions and Declarations
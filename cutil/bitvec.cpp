@@ -25,12 +25,6 @@
 
 #include "emalloc.h"
 #include "freelist.h"
-#include "tprintf.h"
-
-/**----------------------------------------------------------------------------
-        Global Data Definitions and Declarations
-----------------------------------------------------------------------------**/
-static int BitVectorCount = 0;
 
 /**----------------------------------------------------------------------------
               Public Code
@@ -58,21 +52,15 @@ void FreeBitVector(BIT_VECTOR BitVector) {
 /*
  **	Parameters:
  **		BitVector	bit vector to be freed
- **	Globals:
- **		BitVectorCount	count of number of bit vectors allocated
- **	Operation: This routine frees a bit vector.  It also decrements
- **		the global counter that keeps track of the number of
- **		bit vectors allocated.  If BitVector is NULL, then
- **		the count is printed to stderr.
+ **	Globals: none
+ **	Operation: This routine frees a bit vector.  Nothing is done
+ **		if BitVector is NULL.
  **	Return: none
  **	Exceptions: none
  **	History: Tue Oct 23 16:46:09 1990, DSJ, Created.
  */
   if (BitVector) {
     Efree(BitVector);
-    BitVectorCount--;
-  } else {
-    tprintf("%6d BITVECTOR elements in use\n", BitVectorCount);
   }
 }                                /* FreeBitVector */
 
@@ -101,15 +89,13 @@ BIT_VECTOR NewBitVector(int NumBits) {
 /*
  **	Parameters:
  **		NumBits		number of bits in new bit vector
- **	Globals:
- **		BitVectorCount	number of bit vectors allocated
+ **	Globals: none
  **	Operation: Allocate and return a new bit vector large enough to
  **		hold the specified number of bits.
  **	Return: New bit vector.
  **	Exceptions: none
  **	History: Tue Oct 23 16:51:27 1990, DSJ, Created.
  */
-  BitVectorCount++;
   return ((BIT_VECTOR) Emalloc(sizeof(uinT32) *
     WordsInVectorOfSize(NumBits)));
 }                                /* NewBitVector */
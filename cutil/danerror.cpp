@@ -18,6 +18,11 @@
 /**----------------------------------------------------------------------------
           Include Files and Type Defines
 ----------------------------------------------------------------------------**/
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
 #include "general.h"
 #include "danerror.h"
 #include "callcpp.h"
@@ -27,7 +32,13 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <setjmp.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 #define MAXTRAPDEPTH    100
 
@@ -36,9 +47,69 @@
 /**----------------------------------------------------------------------------
         Global Data Definitions and Declarations
 ----------------------------------------------------------------------------**/
-static jmp_buf ErrorTrapStack[MAXTRAPDEPTH];
-static VOID_PROC ProcTrapStack[MAXTRAPDEPTH];
-static inT32 CurrentTrapDepth = 0;
+/* Each thread has its own stack of error traps, as the traps are jumped
+   to from the thread that called DoError. The stacks are allocated with
+   calloc, so that they start out empty. */
+typedef struct
+{
+  jmp_buf ErrorTrapStack[MAXTRAPDEPTH];
+  VOID_PROC ProcTrapStack[MAXTRAPDEPTH];
+  inT32 CurrentTrapDepth;
+} ERROR_TRAPS;
+
+/* Used when a thread cannot get a stack of its own. */
+static ERROR_TRAPS SharedErrorTraps;
+
+/* GetErrorTraps returns the error traps of the calling thread, making
+   them if create is true, or NULL if there are none. */
+#ifdef WIN32
+
+/* The traps of a thread are not freed when it exits. */
+static DWORD TrapKey = TLS_OUT_OF_INDEXES;
+
+static ERROR_TRAPS *GetErrorTraps(bool create) {
+  if (TrapKey == TLS_OUT_OF_INDEXES) {
+    if (!create)
+      return NULL;
+    TrapKey = TlsAlloc();
+    if (TrapKey == TLS_OUT_OF_INDEXES)
+      return &SharedErrorTraps;
+  }
+  void *Traps = TlsGetValue(TrapKey);
+  if (Traps == NULL && create) {
+    Traps = calloc(1, sizeof(ERROR_TRAPS));
+    if (Traps == NULL)
+      return &SharedErrorTraps;
+    TlsSetValue(TrapKey, Traps);
+  }
+  return (ERROR_TRAPS *) Traps;
+}
+
+#else
+
+static pthread_key_t TrapKey;
+static pthread_once_t TrapKeyOnce = PTHREAD_ONCE_INIT;
+static bool TrapKeyMade = false;
+
+static void MakeTrapKey() {
+  TrapKeyMade = pthread_key_create(&TrapKey, free) == 0;
+}
+
+static ERROR_TRAPS *GetErrorTraps(bool create) {
+  pthread_once(&TrapKeyOnce, MakeTrapKey);
+  if (!TrapKeyMade)
+    return &SharedErrorTraps;
+  void *Traps = pthread_getspecific(TrapKey);
+  if (Traps == NULL && create) {
+    Traps = calloc(1, sizeof(ERROR_TRAPS));
+    if (Traps == NULL)
+      return &SharedErrorTraps;
+    pthread_setspecific(TrapKey, Traps);
+  }
+  return (ERROR_TRAPS *) Traps;
+}
+
+#endif  // WIN32
 
 /**----------------------------------------------------------------------------
               Public Code
@@ -49,7 +120,7 @@ void ReleaseErrorTrap() {
  **	Parameters:
  **		None
  **	Globals:
- **		CurrentTrapDepth	number of traps on the stack
+ **		CurrentTrapDepth	number of traps on the stack of the thread
  **	Operation:
  **		This routine removes the current error trap from the
  **		error trap stack, thus returning control to the previous
@@ -62,8 +133,10 @@ void ReleaseErrorTrap() {
  **	History:
  **		4/3/89, DSJ, Created.
  */
-  if (CurrentTrapDepth > 0) {
-    CurrentTrapDepth--;
+  ERROR_TRAPS *Traps = GetErrorTraps(false);
+
+  if (Traps != NULL && Traps->CurrentTrapDepth > 0) {
+    Traps->CurrentTrapDepth--;
   }
 }                                /* ReleaseErrorTrap */
 
@@ -75,7 +148,7 @@ void DoError(int Error, const char *Message) {
  **		Error	error number which is to be trapped
  **		Message	pointer to a string to be printed as an error message
  **	Globals:
- **		ErrorTrapStack		stack of error traps
+ **		ErrorTrapStack		stack of error traps of the thread
  **		CurrentTrapDepth	number of traps on the stack
  **	Operation:
  **		This routine prints the specified error message to stderr.
@@ -89,11 +162,13 @@ void DoError(int Error, const char *Message) {
  **	History:
  **		4/3/89, DSJ, Created.
  */
+  ERROR_TRAPS *Traps = GetErrorTraps(false);
+
   if (Message != NULL) {
     cprintf ("\nError: %s!\n", Message);
   }
 
-  if (CurrentTrapDepth <= 0) {
+  if (Traps == NULL || Traps->CurrentTrapDepth <= 0) {
     cprintf ("\nFatal error: No error trap defined!\n");
 
     /* SPC 20/4/94
@@ -103,10 +178,10 @@ void DoError(int Error, const char *Message) {
     signal_termination_handler(Error);
   }
 
-  if (ProcTrapStack[CurrentTrapDepth - 1] != DO_NOTHING)
-    (*ProcTrapStack[CurrentTrapDepth - 1]) ();
+  if (Traps->ProcTrapStack[Traps->CurrentTrapDepth - 1] != DO_NOTHING)
+    (*Traps->ProcTrapStack[Traps->CurrentTrapDepth - 1]) ();
 
-  longjmp (ErrorTrapStack[CurrentTrapDepth - 1], 1);
+  longjmp (Traps->ErrorTrapStack[Traps->CurrentTrapDepth - 1], 1);
 }                                /* DoError */
 
 
@@ -119,7 +194,7 @@ jmp_buf &PushErrorTrap(VOID_PROC Procedure) {
  **	Parameters:
  **		Procedure		trap procedure to execute
  **	Globals:
- **		ErrorTrapStack		stack of error traps
+ **		ErrorTrapStack		stack of error traps of the thread
  **		CurrentTrapDepth	number of traps on the stack
  **	Operation:
  **		This routine pushes a new error trap onto the top of
@@ -136,9 +211,11 @@ jmp_buf &PushErrorTrap(VOID_PROC Procedure) {
  **		3/17/89, DSJ, Created.
  **		9/12/90, DSJ, Added trap procedure parameter.
  */
-  if (CurrentTrapDepth >= MAXTRAPDEPTH)
+  ERROR_TRAPS *Traps = GetErrorTraps(true);
+
+  if (Traps->CurrentTrapDepth >= MAXTRAPDEPTH)
     DoError (ERRORTRAPDEPTH, "Error trap depth exceeded");
-  ProcTrapStack[CurrentTrapDepth] = Procedure;
-  return ErrorTrapStack[CurrentTrapDepth++];
+  Traps->ProcTrapStack[Traps->CurrentTrapDepth] = Procedure;
+  return Traps->ErrorTrapStack[Traps->CurrentTrapDepth++];
 
 }                                /* PushErrorTrap */
@@ -25,6 +25,7 @@
           Include Files and Type Defines
 ----------------------------------------------------------------------------**/
 #include "emalloc.h"
+#include "allocprofile.h"
 #include "danerror.h"
 #include <stdlib.h>
 
@@ -55,7 +56,7 @@ void *Emalloc(size_t Size) {
 
   if (Size <= 0)
     DoError (ILLEGALMALLOCREQUEST, "Illegal malloc request size");
-  Buffer = (void *) malloc (Size);
+  Buffer = tesseract::AllocProfiler::Malloc (Size);
   if (Buffer == NULL) {
     DoError (NOTENOUGHMEMORY, "Not enough memory");
     return (NULL);
@@ -73,7 +74,7 @@ void *Erealloc(void *ptr, size_t size) {
   if (size < 0 || (size == 0 && ptr == NULL))
     DoError (ILLEGALMALLOCREQUEST, "Illegal realloc request size");
 
-  Buffer = (void *) realloc (ptr, size);
+  Buffer = tesseract::AllocProfiler::Realloc (ptr, size);
   if (Buffer == NULL && size != 0)
     DoError (NOTENOUGHMEMORY, "Not enough memory");
   return (Buffer);
@@ -86,6 +87,6 @@ void Efree(void *ptr) {
   if (ptr == NULL)
     DoError (ILLEGALMALLOCREQUEST, "Attempted to free NULL ptr");
 
-  free(ptr); 
+  tesseract::AllocProfiler::Free (ptr);
 
 }                                /* Efree */
@@ -50,9 +50,9 @@ int max_data_types = 0;
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
-makestructure (newword, oldword, printword, TWERD,
+makewordstructure (newword, oldword, printword, TWERD,
 freeword, WERDBLOCK, "TWERD", wordcount)
-makestructure (newoutline, oldoutline, printol, TESSLINE,
+makewordstructure (newoutline, oldoutline, printol, TESSLINE,
 freeoutline, OUTLINEBLOCK, "TESSLINE", outlinecount);
 
 makestructure (new_cell, free_cell, printcell, list_rec,
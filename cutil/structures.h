@@ -32,6 +32,7 @@
 #include "oldlist.h"
 #include "freelist.h"
 #include "danerror.h"
+#include "wordarena.h"
 
 #define NUM_DATA_TYPES 20
 
@@ -63,16 +64,39 @@ void old(type* deadelement)
 }                                                                            \
 
 
+/**********************************************************************
+ * makewordstructure
+ *
+ * Like makestructure, for the plain data types that never outlive the
+ * recognition of a word.  They are drawn from the word arena while a
+ * word is recognized (see wordarena.h).
+ **********************************************************************/
+
+#define makewordstructure(newfunc,old,print,type,nextfree,blocksize,typestring,usecount)            \
+type *newfunc()                                                                  \
+{                                                                            \
+	return (type *) tesseract::WordArena::New(sizeof(type)); \
+}                                                                            \
+																									\
+																									\
+																									\
+void old(type* deadelement)                                                       \
+{                                                                            \
+	tesseract::WordArena::Delete(deadelement, sizeof(type)); \
+}                                                                            \
+
+
 /**********************************************************************
  * newstructure
  *
- * Allocate a chunk of memory for a particular data type.
+ * Allocate a chunk of memory for a particular data type, from the word
+ * arena while a word is recognized.
  **********************************************************************/
 
 #define newstructure(name,type,nextfree,blocksize,errorstring,usecount)\
 type *name()											/*returns a new type*/\
 {\
-	return new type;\
+	return (type *) tesseract::WordArena::New(sizeof(type));\
 }
 
 /**********************************************************************
@@ -88,7 +112,7 @@ type *name(type* deadelement)\
 	type                    *returnelement;				/*return next ptr*/\
 \
 	returnelement=deadelement->next;					/*return link*/\
-	delete deadelement;  \
+	tesseract::WordArena::Delete(deadelement, sizeof(type));  \
 	return returnelement;\
 }
 
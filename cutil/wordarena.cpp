@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////
+// File:        wordarena.cpp
+// Description: Arena for the small structures of the recognition of a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
+#include "wordarena.h"
+
+#include <stdlib.h>
+#include <new>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace tesseract {
+
+#ifndef DISABLE_WORD_ARENA
+
+// Sizes are rounded up to a multiple of the grain, which is also the
+// alignment of the structures.
+const int kArenaGrain = 8;
+// Larger structures always come from the heap.
+const int kMaxArenaSize = 256;
+const int kNumSizeClasses = kMaxArenaSize / kArenaGrain;
+const int kArenaBlockSize = 64 * 1024;
+// At most this many blocks are used by a word, which bounds the arena to
+// 16MB. Once they are full, New falls back on the heap.
+const int kMaxArenaBlocks = 256;
+// Blocks kept for the next word when the outermost scope closes.
+const int kRetainedArenaBlocks = 16;
+
+struct ArenaFreeCell {
+  ArenaFreeCell *next;
+};
+
+#endif  // DISABLE_WORD_ARENA
+
+// The arena of a thread. It is allocated with calloc, so that it starts
+// out empty.
+struct ThreadArena {
+  inT64 arena_alloc_count;
+  inT64 heap_alloc_count;
+#ifndef DISABLE_WORD_ARENA
+  int scope_depth;
+  // The blocks, in the order they are used.
+  char *blocks[kMaxArenaBlocks];
+  // The same blocks sorted by address, to tell whether they own a pointer.
+  char *sorted_blocks[kMaxArenaBlocks];
+  int num_blocks;
+  // Number of blocks in use by the current word.
+  int used_blocks;
+  // Free space of the last block in use.
+  char *bump_ptr;
+  char *bump_end;
+  // The freed structures of each size class.
+  ArenaFreeCell *free_cells[kNumSizeClasses];
+#endif
+};
+
+// GetThreadArena returns the arena of the calling thread, making it if
+// create is true, or NULL if there is none.
+#ifdef WIN32
+
+// The arena of a thread is not freed when it exits.
+static DWORD arena_key = TLS_OUT_OF_INDEXES;
+
+static ThreadArena *GetThreadArena(bool create) {
+  if (arena_key == TLS_OUT_OF_INDEXES) {
+    if (!create)
+      return NULL;
+    arena_key = TlsAlloc();
+    if (arena_key == TLS_OUT_OF_INDEXES)
+      return NULL;
+  }
+  void *arena = TlsGetValue(arena_key);
+  if (arena == NULL && create) {
+    arena = calloc(1, sizeof(ThreadArena));
+    if (arena == NULL)
+      return NULL;
+    TlsSetValue(arena_key, arena);
+  }
+  return static_cast<ThreadArena *>(arena);
+}
+
+#else
+
+static pthread_key_t arena_key;
+static pthread_once_t arena_key_once = PTHREAD_ONCE_INIT;
+static bool arena_key_made = false;
+
+static void FreeThreadArena(void *ptr) {
+  ThreadArena *arena = static_cast<ThreadArena *>(ptr);
+#ifndef DISABLE_WORD_ARENA
+  for (int b = 0; b < arena->num_blocks; ++b)
+    delete [] arena->blocks[b];
+#endif
+  free(arena);
+}
+
+static void MakeArenaKey() {
+  arena_key_made = pthread_key_create(&arena_key, FreeThreadArena) == 0;
+}
+
+static ThreadArena *GetThreadArena(bool create) {
+  pthread_once(&arena_key_once, MakeArenaKey);
+  if (!arena_key_made)
+    return NULL;
+  void *arena = pthread_getspecific(arena_key);
+  if (arena == NULL && create) {
+    arena = calloc(1, sizeof(ThreadArena));
+    if (arena == NULL)
+      return NULL;
+    pthread_setspecific(arena_key, arena);
+  }
+  return static_cast<ThreadArena *>(arena);
+}
+
+#endif  // WIN32
+
+#ifndef DISABLE_WORD_ARENA
+
+// Makes the next block of arena the one to allocate from, allocating it if
+// all the retained ones are in use. Returns false if the arena is full.
+static bool NextArenaBlock(ThreadArena *arena) {
+  if (arena->used_blocks == arena->num_blocks) {
+    if (arena->num_blocks == kMaxArenaBlocks)
+      return false;
+    char *block = new char[kArenaBlockSize];
+    arena->blocks[arena->num_blocks] = block;
+    int i = arena->num_blocks++;
+    for (; i > 0 && arena->sorted_blocks[i - 1] > block; --i)
+      arena->sorted_blocks[i] = arena->sorted_blocks[i - 1];
+    arena->sorted_blocks[i] = block;
+  }
+  arena->bump_ptr = arena->blocks[arena->used_blocks++];
+  arena->bump_end = arena->bump_ptr + kArenaBlockSize;
+  return true;
+}
+
+// Returns true if ptr is in one of the blocks of arena.
+static bool ArenaOwns(const ThreadArena *arena, const void *ptr) {
+  const char *p = static_cast<const char *>(ptr);
+  int lo = 0;
+  int hi = arena->num_blocks;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (p < arena->sorted_blocks[mid])
+      hi = mid;
+    else if (p >= arena->sorted_blocks[mid] + kArenaBlockSize)
+      lo = mid + 1;
+    else
+      return true;
+  }
+  return false;
+}
+
+void *WordArena::New(int size) {
+  ThreadArena *arena = GetThreadArena(true);
+  if (arena == NULL)
+    return ::operator new(size);
+  if (arena->scope_depth > 0 && size <= kMaxArenaSize) {
+    int size_class = (size - 1) / kArenaGrain;
+    ArenaFreeCell *cell = arena->free_cells[size_class];
+    if (cell != NULL) {
+      arena->free_cells[size_class] = cell->next;
+      ++arena->arena_alloc_count;
+      return cell;
+    }
+    int rounded_size = (size_class + 1) * kArenaGrain;
+    if (arena->bump_end - arena->bump_ptr >= rounded_size ||
+        NextArenaBlock(arena)) {
+      void *result = arena->bump_ptr;
+      arena->bump_ptr += rounded_size;
+      ++arena->arena_alloc_count;
+      return result;
+    }
+  }
+  ++arena->heap_alloc_count;
+  return ::operator new(size);
+}
+
+void WordArena::Delete(void *ptr, int size) {
+  if (ptr == NULL)
+    return;
+  ThreadArena *arena = GetThreadArena(false);
+  if (arena != NULL && size <= kMaxArenaSize && arena->num_blocks > 0 &&
+      ArenaOwns(arena, ptr)) {
+    // Outside of a scope, the memory has already been released.
+    if (arena->scope_depth > 0) {
+      ArenaFreeCell *cell = static_cast<ArenaFreeCell *>(ptr);
+      int size_class = (size - 1) / kArenaGrain;
+      cell->next = arena->free_cells[size_class];
+      arena->free_cells[size_class] = cell;
+    }
+    return;
+  }
+  ::operator delete(ptr);
+}
+
+void WordArena::BeginWord() {
+  ThreadArena *arena = GetThreadArena(true);
+  if (arena != NULL)
+    ++arena->scope_depth;
+}
+
+void WordArena::EndWord() {
+  ThreadArena *arena = GetThreadArena(false);
+  if (arena == NULL || --arena->scope_depth > 0)
+    return;
+  for (int c = 0; c < kNumSizeClasses; ++c)
+    arena->free_cells[c] = NULL;
+  arena->bump_ptr = NULL;
+  arena->bump_end = NULL;
+  arena->used_blocks = 0;
+  if (arena->num_blocks > kRetainedArenaBlocks) {
+    for (int b = kRetainedArenaBlocks; b < arena->num_blocks; ++b)
+      delete [] arena->blocks[b];
+    arena->num_blocks = kRetainedArenaBlocks;
+    for (int b = 0; b < arena->num_blocks; ++b) {
+      int i = b;
+      for (; i > 0 && arena->sorted_blocks[i - 1] > arena->blocks[b]; --i)
+        arena->sorted_blocks[i] = arena->sorted_blocks[i - 1];
+      arena->sorted_blocks[i] = arena->blocks[b];
+    }
+  }
+}
+
+#else  // DISABLE_WORD_ARENA
+
+void *WordArena::New(int size) {
+  ThreadArena *arena = GetThreadArena(true);
+  if (arena != NULL)
+    ++arena->heap_alloc_count;
+  return ::operator new(size);
+}
+
+void WordArena::Delete(void *ptr, int size) {
+  ::operator delete(ptr);
+}
+
+void WordArena::BeginWord() {
+}
+
+void WordArena::EndWord() {
+}
+
+#endif  // DISABLE_WORD_ARENA
+
+inT64 WordArena::arena_allocs() {
+  ThreadArena *arena = GetThreadArena(false);
+  return arena != NULL ? arena->arena_alloc_count : 0;
+}
+
+inT64 WordArena::heap_allocs() {
+  ThreadArena *arena = GetThreadArena(false);
+  return arena != NULL ? arena->heap_alloc_count : 0;
+}
+
+}  // namespace tesseract
@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////////////////
+// File:        wordarena.h
+// Description: Arena for the small structures of the recognition of a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CUTIL_WORDARENA_H__
+#define TESSERACT_CUTIL_WORDARENA_H__
+
+#include "host.h"
+
+namespace tesseract {
+
+// WordArena hands out the small structures that the recognition of a word
+// allocates and frees by the thousand: the TWERD, TBLOBs, TESSLINEs and
+// EDGEPTs of the tess word, the SEAMs and SPLITs of the chopper and the
+// MFEDGEPTs of the micro-feature outlines. While a WordArenaScope is open,
+// they are carved out of large blocks, a freed one is reused by the next
+// allocation of the same size, and all of them are released in one step
+// when the outermost scope closes. Outside of any scope, or when the arena
+// is compiled out by defining DISABLE_WORD_ARENA (configure
+// --disable-word-arena), they come from the heap.
+//
+// Everything allocated inside a scope must be freed, or at least no longer
+// used, when the scope closes. Structures that outlive a word, such as the
+// list cells of the adapted templates and the stopper, or the BLOB_CHOICEs
+// of the results, must not be allocated from the arena.
+//
+// Each thread has its own arena, so instances recognizing words in
+// different threads share none of it. What a thread allocates inside a
+// scope must be freed by the same thread.
+class WordArena {
+ public:
+  // Returns size bytes from the arena if a scope is open and size is small
+  // enough, or from the heap otherwise.
+  static void *New(int size);
+  // Frees the memory of the given size returned by New.
+  static void Delete(void *ptr, int size);
+
+  // Open and close a scope. Scopes nest, and only the outermost one
+  // releases the memory when it closes.
+  static void BeginWord();
+  static void EndWord();
+
+  // The number of calls of New by this thread served by the arena and by
+  // the heap. With the arena compiled out, all of them are counted as heap
+  // allocations.
+  static inT64 arena_allocs();
+  static inT64 heap_allocs();
+};
+
+// Keeps a scope of the WordArena open for its own lifetime.
+class WordArenaScope {
+ public:
+  WordArenaScope() {
+    WordArena::BeginWord();
+  }
+  ~WordArenaScope() {
+    WordArena::EndWord();
+  }
+
+ private:
+  // Not copyable.
+  WordArenaScope(const WordArenaScope &);
+  WordArenaScope &operator=(const WordArenaScope &);
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CUTIL_WORDARENA_H__
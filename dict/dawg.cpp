@@ -27,6 +27,8 @@
 ----------------------------------------------------------------------*/
 #include "dawg.h"
 
+#include <stdlib.h>
+
 #include "context.h"
 #include "cutil.h"
 #include "dict.h"
@@ -43,6 +45,10 @@
 INT_VAR(dawg_debug_level, 0, "Set to 1 for general debug info"
         ", to 2 for more details, to 3 to see all the debug messages");
 
+INT_VAR(dawg_min_indexed_edges, 16,
+        "Nodes of a squished dawg with at least this many edges are"
+        " searched through a sorted index, 0 for no index");
+
 /*----------------------------------------------------------------------
               F u n c t i o n s   f o r   D a w g
 ----------------------------------------------------------------------*/
@@ -157,13 +163,39 @@ void Dawg::init(DawgType type, const STRING &lang,
          F u n c t i o n s   f o r   S q u i s h e d    D a w g
 ----------------------------------------------------------------------*/
 
-SquishedDawg::~SquishedDawg() { memfree(edges_); }
+SquishedDawg::~SquishedDawg() {
+  if (!edges_mapped_) memfree(edges_);
+  if (node_starts_ != NULL && !node_starts_mapped_) memfree(node_starts_);
+}
 
 EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
                                     UNICHAR_ID unichar_id,
                                     bool word_end) const {
   EDGE_REF edge = node;
-  if (node == 0) {  // binary search
+  int index;
+  if (node_starts_ != NULL) {  // node-indexed layout
+    if (node < 0 || node >= num_nodes_) return NO_EDGE;
+    EDGE_REF start = node_starts_[node];
+    EDGE_REF end = node_starts_[node + 1];
+    if (end - start > kMaxLinearSearchEdges) {
+      while (start < end) {  // find the first edge with unichar_id
+        EDGE_REF middle = (start + end) >> 1;
+        if (unichar_id_from_edge_rec(edges_[middle]) < unichar_id)
+          start = middle + 1;
+        else
+          end = middle;
+      }
+      end = node_starts_[node + 1];
+    }
+    // The edges are sorted, so the search can stop at a greater unichar id.
+    for (edge = start; edge < end; ++edge) {
+      UNICHAR_ID edge_unichar_id = unichar_id_from_edge_rec(edges_[edge]);
+      if (edge_unichar_id > unichar_id) break;
+      if (edge_unichar_id == unichar_id &&
+          (!word_end || end_of_word_from_edge_rec(edges_[edge])))
+        return edge;
+    }
+  } else if (node == 0) {  // binary search
     EDGE_REF start = 0;
     EDGE_REF end = num_forward_edges_in_node0 - 1;
     int compare;
@@ -179,6 +211,24 @@ EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
         end = edge - 1;
   }
 }
+  } else if (!indexed_nodes_.empty() &&
+             (index = find_indexed_node(node)) >= 0) {  // binary search
+    int start = index_starts_[index];
+    int end = index_starts_[index + 1];
+    while (start < end) {  // find the first child with unichar_id
+      int middle = (start + end) >> 1;
+      if (index_children_[middle].unichar_id < unichar_id)
+        start = middle + 1;
+      else
+        end = middle;
+    }
+    end = index_starts_[index + 1];
+    for (; start < end && index_children_[start].unichar_id == unichar_id;
+         ++start) {
+      edge = index_children_[start].edge_ref;
+      if (!word_end || end_of_word_from_edge_rec(edges_[edge]))
+        return edge;
+    }
   } else {  // linear search
     if (edge != NO_EDGE && edge_occupied(edge)) {
       do {
@@ -191,10 +241,76 @@ EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
   return (NO_EDGE);  // not found
 }
 
+// Orders NodeChilds by unichar id, and then by edge, which keeps the
+// children of a node with the same unichar id in their order in the node.
+static int compare_node_children(const void *child1, const void *child2) {
+  const NodeChild *first = reinterpret_cast<const NodeChild *>(child1);
+  const NodeChild *second = reinterpret_cast<const NodeChild *>(child2);
+  if (first->unichar_id != second->unichar_id)
+    return first->unichar_id < second->unichar_id ? -1 : 1;
+  if (first->edge_ref != second->edge_ref)
+    return first->edge_ref < second->edge_ref ? -1 : 1;
+  return 0;
+}
+
+void SquishedDawg::build_edge_index() {
+  indexed_nodes_.truncate(0);
+  index_starts_.truncate(0);
+  index_children_.truncate(0);
+  // The edges of the node-indexed layout are already sorted.
+  if (dawg_min_indexed_edges <= 0 || node_starts_ != NULL) return;
+  NodeChildVector children;
+  for (EDGE_REF edge = 0; edge < num_edges_; ++edge) {
+    if (!forward_edge(edge)) continue;
+    // edge is the first forward edge of a node.
+    NODE_REF node = edge;
+    inT32 num_edges = num_forward_edges(node);
+    if (node != 0 && num_edges >= dawg_min_indexed_edges) {
+      children.truncate(0);
+      unichar_ids_of(node, &children);
+      qsort(&children[0], children.size(), sizeof(children[0]),
+            compare_node_children);
+      indexed_nodes_.push_back(node);
+      index_starts_.push_back(index_children_.size());
+      for (int i = 0; i < children.size(); ++i)
+        index_children_.push_back(children[i]);
+    }
+    edge += num_edges;
+    if (edge < num_edges_ && backward_edge(edge))
+      while (!last_edge(edge++));
+    edge--;
+  }
+  if (!indexed_nodes_.empty())
+    index_starts_.push_back(index_children_.size());
+  if (dawg_debug_level) {
+    tprintf("Indexed %d nodes with %d edges\n",
+            indexed_nodes_.size(), index_children_.size());
+  }
+}
+
+int SquishedDawg::find_indexed_node(NODE_REF node) const {
+  int start = 0;
+  int end = indexed_nodes_.size() - 1;
+  while (start <= end) {
+    int middle = (start + end) >> 1;
+    if (indexed_nodes_[middle] == node)
+      return middle;
+    if (indexed_nodes_[middle] < node)
+      start = middle + 1;
+    else
+      end = middle - 1;
+  }
+  return -1;
+}
+
 inT32 SquishedDawg::num_forward_edges(NODE_REF node) const {
   EDGE_REF   edge = node;
   inT32        num  = 0;
 
+  if (node_starts_ != NULL) {
+    if (node < 0 || node >= num_nodes_) return 0;
+    return node_starts_[node + 1] - node_starts_[node];
+  }
   if (forward_edge (edge)) {
     do {
       num++;
@@ -223,7 +339,18 @@ void SquishedDawg::print_node(NODE_REF node, int max_num_edges) const {
 
   UNICHAR_ID unichar_id;
 
-  if (edge_occupied(edge)) {
+  if (node_starts_ != NULL) {
+    if (num_forward_edges(node) == 0) {
+      tprintf(REFFORMAT " : no edges in this node\n\n", node);
+      return;
+    }
+    for (edge = node_starts_[node]; edge < node_starts_[node + 1]; ++edge) {
+      eow = end_of_word(edge) ? eow_string : not_eow_string;
+      tprintf(REFFORMAT " : next = " REFFORMAT ", unichar_id = %d, %s %s\n",
+              edge, next_node(edge), edge_letter(edge), forward_string, eow);
+      if (edge - node_starts_[node] > max_num_edges) return;
+    }
+  } else if (edge_occupied(edge)) {
     do {
       direction =
         forward_edge(edge) ? forward_string : backward_string;
@@ -275,28 +402,53 @@ void SquishedDawg::print_edge(EDGE_REF edge) const {
   }
 }
 
-void SquishedDawg::read_squished_dawg(FILE *file, DawgType type,
-                                      const STRING &lang, PermuterType perm) {
+void SquishedDawg::read_squished_dawg(FILE *file,
+                                      const TessdataManager *tessdata_manager,
+                                      DawgType type, const STRING &lang,
+                                      PermuterType perm) {
   if (dawg_debug_level) tprintf("Reading squished dawg\n");
 
-  // Read the magic number and if it does not match kDawgMagicNumber
-  // set swap to true to indicate that we need to switch endianness.
+  // Read the magic number and if it does not match kDawgMagicNumber or
+  // kNodeDawgMagicNumber set swap to true to indicate that we need to
+  // switch endianness.
   inT16 magic;
   fread(&magic, sizeof(inT16), 1, file);
-  bool swap = (magic != kDawgMagicNumber);
+  bool swap = (magic != kDawgMagicNumber && magic != kNodeDawgMagicNumber);
+  if (swap) magic = reverse16(magic);
+  bool node_indexed = (magic == kNodeDawgMagicNumber);
 
   int unicharset_size;
+  inT32 num_nodes = 0;
   fread(&unicharset_size, sizeof(inT32), 1, file);
   fread(&num_edges_, sizeof(inT32), 1, file);
+  if (node_indexed) fread(&num_nodes, sizeof(inT32), 1, file);
 
   if (swap) {
     unicharset_size = reverse32(unicharset_size);
     num_edges_ = reverse32(num_edges_);
+    num_nodes = reverse32(num_nodes);
   }
   Dawg::init(type, lang, perm, unicharset_size);
-
-  edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
-  fread(&edges_[0], sizeof(EDGE_RECORD), num_edges_, file);
+  node_starts_ = NULL;
+  num_nodes_ = num_nodes;
+  node_starts_mapped_ = false;
+  if (node_indexed) read_node_starts(file, tessdata_manager, swap);
+
+  // Use the edges in place if they are mapped (and aligned, which
+  // combine_tessdata ensures) and need no byte swapping.
+  const char *mapped_edges = NULL;
+  if (tessdata_manager != NULL && !swap) {
+    mapped_edges = tessdata_manager->GetMappedData(
+        kDawgEdgeAlignment, sizeof(EDGE_RECORD) * num_edges_);
+  }
+  edges_mapped_ = mapped_edges != NULL;
+  if (edges_mapped_) {
+    edges_ = (EDGE_ARRAY) mapped_edges;
+    fseek(file, sizeof(EDGE_RECORD) * num_edges_, SEEK_CUR);
+  } else {
+    edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
+    fread(&edges_[0], sizeof(EDGE_RECORD), num_edges_, file);
+  }
   EDGE_REF edge;
   if (swap) {
     for (edge = 0; edge < num_edges_; ++edge) {
@@ -304,36 +456,72 @@ void SquishedDawg::read_squished_dawg(FILE *file, DawgType type,
     }
   }
   if (dawg_debug_level > 2) {
-    tprintf("type: %d lang: %s perm: %d unicharset_size: %d num_edges: %d\n",
-            type_, lang_.string(), perm_, unicharset_size_, num_edges_);
+    tprintf("type: %d lang: %s perm: %d unicharset_size: %d num_edges: %d"
+            " num_nodes: %d\n", type_, lang_.string(), perm_,
+            unicharset_size_, num_edges_, num_nodes_);
     for (edge = 0; edge < num_edges_; ++edge)
       print_edge(edge);
   }
 }
 
-NODE_MAP SquishedDawg::build_node_map(inT32 *num_nodes) const {
+void SquishedDawg::read_node_starts(FILE *file,
+                                    const TessdataManager *tessdata_manager,
+                                    bool swap) {
+  int num_node_starts = num_node_starts_on_disk(num_nodes_);
+  const char *mapped_starts = NULL;
+  if (tessdata_manager != NULL && !swap) {
+    mapped_starts = tessdata_manager->GetMappedData(
+        sizeof(inT32), sizeof(inT32) * num_node_starts);
+  }
+  node_starts_mapped_ = mapped_starts != NULL;
+  if (node_starts_mapped_) {
+    node_starts_ = (inT32 *) mapped_starts;
+    fseek(file, sizeof(inT32) * num_node_starts, SEEK_CUR);
+  } else {
+    node_starts_ = (inT32 *) memalloc(sizeof(inT32) * num_node_starts);
+    fread(node_starts_, sizeof(inT32), num_node_starts, file);
+    if (swap) {
+      for (int i = 0; i < num_node_starts; ++i)
+        node_starts_[i] = reverse32(node_starts_[i]);
+    }
+  }
+}
+
+int SquishedDawg::num_node_starts_on_disk(int num_nodes) {
+  int num_node_starts = num_nodes + 1;
+  // combine_tessdata aligns the edges of a dawg that start kDawgHeaderSize
+  // bytes after the start of the dawg, so pad the table to match.
+  if ((kNodeDawgHeaderSize + sizeof(inT32) * num_node_starts -
+       kDawgHeaderSize) % kDawgEdgeAlignment != 0)
+    ++num_node_starts;
+  return num_node_starts;
+}
+
+NODE_MAP SquishedDawg::build_node_map(GenericVector<NODE_REF> *nodes) const {
   EDGE_REF   edge;
   NODE_MAP   node_map;
-  inT32       node_counter;
-  inT32       num_edges;
 
-  node_map = (NODE_MAP) malloc(sizeof(EDGE_REF) * num_edges_);
+  if (node_starts_ != NULL) {  // the nodes are numbered already
+    node_map = (NODE_MAP) malloc(sizeof(EDGE_REF) * (num_nodes_ + 1));
+    for (NODE_REF node = 0; node < num_nodes_; ++node) {
+      node_map[node] = node;
+      nodes->push_back(node);
+    }
+    return (node_map);
+  }
+
+  node_map = (NODE_MAP) malloc(sizeof(EDGE_REF) * (num_edges_ + 1));
 
   for (edge=0; edge < num_edges_; edge++)       // init all slots
     node_map [edge] = -1;
 
-  node_counter = num_forward_edges(0);
-
-  *num_nodes   = 0;
   for (edge=0; edge < num_edges_; edge++) {     // search all slots
-
     if (forward_edge(edge)) {
-      (*num_nodes)++;                          // count nodes links
-      node_map[edge] = (edge ? node_counter : 0);
-      num_edges = num_forward_edges(edge);
-      if (edge != 0) node_counter += num_edges;
-      edge += num_edges;
-      if (backward_edge(edge)) while (!last_edge(edge++));
+      node_map[edge] = nodes->size();
+      nodes->push_back(edge);
+      edge += num_forward_edges(edge);
+      if (edge < num_edges_ && backward_edge(edge))
+        while (!last_edge(edge++));
       edge--;
     }
   }
@@ -342,16 +530,28 @@ NODE_MAP SquishedDawg::build_node_map(inT32 *num_nodes) const {
 
 void SquishedDawg::write_squished_dawg(const char *filename) {
   FILE       *file;
-  EDGE_REF    edge;
-  inT32       num_edges;
-  inT32       node_count = 0;
   NODE_MAP    node_map;
-  EDGE_REF    old_index;
-  EDGE_RECORD temp_record;
+  GenericVector<NODE_REF> nodes;
+  NodeChildVector children;
+  EDGE_RECORD edge_rec;
+  int         i;
 
   if (dawg_debug_level) tprintf("write_squished_dawg\n");
-
-  node_map = build_node_map(&node_count);
+  ASSERT_HOST(!edges_mapped_);
+
+  node_map = build_node_map(&nodes);
+
+  // Build the node offset table, padded with copies of its last entry.
+  inT32 num_nodes = nodes.size();
+  inT32 num_node_starts = num_node_starts_on_disk(num_nodes);
+  inT32 *node_starts = new inT32[num_node_starts];
+  inT32 num_edges = 0;
+  for (i = 0; i < num_nodes; ++i) {
+    node_starts[i] = num_edges;
+    num_edges += num_forward_edges(nodes[i]);
+  }
+  for (i = num_nodes; i < num_node_starts; ++i)
+    node_starts[i] = num_edges;
 
 #ifdef WIN32
   file = open_file(filename, "wb");
@@ -360,41 +560,39 @@ void SquishedDawg::write_squished_dawg(const char *filename) {
 #endif
 
   // Write the magic number to help detecting a change in endianness.
-  inT16 magic = kDawgMagicNumber;
+  inT16 magic = kNodeDawgMagicNumber;
   fwrite(&magic, sizeof(inT16), 1, file);
   fwrite(&unicharset_size_, sizeof(inT32), 1, file);
-
-  // Count the number of edges in this Dawg.
-  num_edges = 0;
-  for (edge=0; edge < num_edges_; edge++)
-    if (forward_edge(edge))
-      num_edges++;
-
   fwrite(&num_edges, sizeof(inT32), 1, file);  // write edge count to file
+  fwrite(&num_nodes, sizeof(inT32), 1, file);  // write node count to file
+  fwrite(node_starts, sizeof(inT32), num_node_starts, file);
 
   if (dawg_debug_level) {
-    tprintf("%d nodes in DAWG\n", node_count);
+    tprintf("%d nodes in DAWG\n", num_nodes);
     tprintf("%d edges in DAWG\n", num_edges);
-}
-
-  for (edge=0; edge<num_edges_; edge++) {
-    if (forward_edge(edge)) {  // write forward edges
-      do {
-        old_index = next_node_from_edge_rec(edges_[edge]);
-        set_next_node(edge, node_map[old_index]);
-        temp_record = edges_[edge];
-        fwrite(&(temp_record), sizeof(EDGE_RECORD), 1, file);
-        set_next_node(edge, old_index);
-      } while (!last_edge(edge++));
-
-      if (backward_edge(edge))  // skip back links
-        while (!last_edge(edge++));
+  }
 
-      edge--;
-    }
+  // Write the forward edges of each node sorted by unichar id, with the
+  // next nodes translated to node numbers.
+  for (i = 0; i < num_nodes; ++i) {
+    children.truncate(0);
+    unichar_ids_of(nodes[i], &children);
+    if (children.empty()) continue;
+    qsort(&children[0], children.size(), sizeof(children[0]),
+          compare_node_children);
+    for (int j = 0; j < children.size(); ++j) {
+      edge_rec = edges_[children[j].edge_ref];
+      NODE_REF next = node_map[next_node_from_edge_rec(edge_rec)];
+      ASSERT_HOST(next >= 0);
+      set_next_node_in_edge_rec(&edge_rec, next);
+      edge_rec &= ~(LAST_FLAG << flag_start_bit_);
+      if (j == children.size() - 1) set_last_flag_in_edge_rec(&edge_rec);
+      fwrite(&edge_rec, sizeof(EDGE_RECORD), 1, file);
     }
+  }
+  delete [] node_starts;
   free(node_map);
   fclose(file);
-  }
+}
 
 }  // namespace tesseract
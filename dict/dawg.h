@@ -34,6 +34,7 @@
 #include "elst.h"
 #include "general.h"
 #include "ratngs.h"
+#include "tessdatamanager.h"
 #include "varable.h"
 
 /*----------------------------------------------------------------------
@@ -43,6 +44,10 @@
 extern INT_VAR_H(dawg_debug_level, 0, "Set to 1 for general debug info, to"
                  " 2 for more details, to 3 to see all the debug messages");
 
+extern INT_VAR_H(dawg_min_indexed_edges, 16,
+                 "Nodes of a squished dawg with at least this many edges are"
+                 " searched through a sorted index, 0 for no index");
+
 #ifdef __MSW32__
 #define NO_EDGE                (inT64) 0xffffffffffffffffi64
 #else
@@ -131,6 +136,9 @@ class Dawg {
  public:
   // Magic number to determine endianness when reading the Dawg from file.
   static const inT16 kDawgMagicNumber = 42;
+  // Magic number of the node-indexed SquishedDawg format, in which the
+  // nodes are numbered and found through a node offset table.
+  static const inT16 kNodeDawgMagicNumber = 43;
   // A special unichar id that indicates that any appropriate pattern
   // (e.g.dicitonary word, 0-9 digit, etc) can be inserted instead
   // Used for expressing patterns in punctuation and number Dawgs.
@@ -342,12 +350,33 @@ class DawgInfoVector : public GenericVector<DawgInfo> {
 // is stored as a contiguous EDGE_ARRAY (read from file or given as an
 // argument to the constructor).
 //
+// A SquishedDawg has one of two layouts. In the edge array layout (built
+// by Trie::trie_to_dawg and read from files in the old format) a NODE_REF
+// is the index of the first edge of the node, and the edges of a node run
+// up to the one with the last flag. In the node-indexed layout (read from
+// files written by write_squished_dawg) a NODE_REF is the number of the
+// node, the forward edges of node i are edges_[node_starts_[i]] up to
+// edges_[node_starts_[i + 1]], sorted by unichar id, and there are no
+// backward edges. In both layouts node 0 is the root, and an edge whose
+// next node is 0 ends a word.
+//
 class SquishedDawg : public Dawg {
  public:
   SquishedDawg(FILE *file, DawgType type,
                const STRING &lang, PermuterType perm) {
-    read_squished_dawg(file, type, lang, perm);
+    read_squished_dawg(file, NULL, type, lang, perm);
+    num_forward_edges_in_node0 = num_forward_edges(0);
+    build_edge_index();
+  }
+  // Reads the dawg at the current position of the data file of
+  // tessdata_manager. If the file is memory-mapped the edges are used in
+  // place, and the dawg must not outlive tessdata_manager.
+  SquishedDawg(const TessdataManager &tessdata_manager, DawgType type,
+               const STRING &lang, PermuterType perm) {
+    read_squished_dawg(tessdata_manager.GetDataFilePtr(), &tessdata_manager,
+                       type, lang, perm);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_edge_index();
   }
   SquishedDawg(const char* filename, DawgType type,
                const STRING &lang, PermuterType perm) {
@@ -356,15 +385,18 @@ class SquishedDawg : public Dawg {
       tprintf("Failed to open dawg file %s\n", filename);
       exit(1);
     }
-    read_squished_dawg(file, type, lang, perm);
+    read_squished_dawg(file, NULL, type, lang, perm);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_edge_index();
     fclose(file);
   }
   SquishedDawg(EDGE_ARRAY edges, int num_edges, DawgType type,
                const STRING &lang, PermuterType perm, int unicharset_size) :
-    edges_(edges), num_edges_(num_edges) {
+    edges_(edges), num_edges_(num_edges), edges_mapped_(false),
+    node_starts_(NULL), num_nodes_(0), node_starts_mapped_(false) {
     init(type, lang, perm, unicharset_size);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_edge_index();
     if (dawg_debug_level > 3) print_all("SquishedDawg:");
   }
   ~SquishedDawg();
@@ -376,6 +408,15 @@ class SquishedDawg : public Dawg {
   // Fills the given NodeChildVector with all the unichar ids (and the
   // corresponding EDGE_REFs) for which there is an edge out of this node.
   void unichar_ids_of(NODE_REF node, NodeChildVector *vec) const {
+    if (node_starts_ != NULL) {
+      if (node < 0 || node >= num_nodes_) return;
+      for (EDGE_REF edge = node_starts_[node];
+           edge < node_starts_[node + 1]; ++edge) {
+        vec->push_back(NodeChild(unichar_id_from_edge_rec(edges_[edge]),
+                                 edge));
+      }
+      return;
+    }
     EDGE_REF edge = node;
     if (!edge_occupied(edge) || edge == NO_EDGE) return;
     assert(forward_edge(edge));  // we don't expect any backward edges to
@@ -405,10 +446,21 @@ class SquishedDawg : public Dawg {
   // At most max_num_edges will be printed.
   void print_node(NODE_REF node, int max_num_edges) const;
 
-  // Writes the squished/reduced Dawg to a file.
+  // Writes the squished/reduced Dawg to a file in the node-indexed format.
+  // Not allowed for a dawg whose edges are memory-mapped. Backward edges of
+  // a dawg in the edge array layout are dropped: nothing walks a
+  // SquishedDawg backwards, so the format has no place for them.
   void write_squished_dawg(const char *filename);
 
  private:
+  // Nodes of the node-indexed layout with at most this many edges are
+  // searched linearly, those with more by binary search.
+  static const int kMaxLinearSearchEdges = 8;
+  // Size in bytes of the header of the node-indexed format: the magic
+  // number, the unicharset size, the number of edges and of nodes.
+  static const int kNodeDawgHeaderSize = 14;
+
+
   // Sets the next node link for this edge.
   inline void set_next_node(EDGE_REF edge_ref, EDGE_REF value) {
     set_next_node_in_edge_rec(&(edges_[edge_ref]), value);
@@ -447,9 +499,11 @@ class SquishedDawg : public Dawg {
   // Counts and returns the number of forward edges in this node.
   inT32 num_forward_edges(NODE_REF node) const;
 
-  // Reads SquishedDawg from a file.
-  void read_squished_dawg(FILE *file, DawgType type,
-                          const STRING &lang, PermuterType perm);
+  // Reads SquishedDawg from a file. If tessdata_manager is not NULL, file is
+  // its data file, and the edges are used in place if it is memory-mapped.
+  void read_squished_dawg(FILE *file, const TessdataManager *tessdata_manager,
+                          DawgType type, const STRING &lang,
+                          PermuterType perm);
 
   // Prints the contents of an edge indicated by the given EDGE_REF.
   void print_edge(EDGE_REF edge) const;
@@ -460,14 +514,49 @@ class SquishedDawg : public Dawg {
     for (int i = 0; i < num_edges_; ++i) print_edge(i);
     tprintf("__________________________\n");
   }
-  // Constructs a mapping from the memory node indices to disk node indices.
-  NODE_MAP build_node_map(inT32 *num_nodes) const;
+  // Reads the node offset table of the node-indexed format, which follows
+  // its header, in place if tessdata_manager is not NULL and its data file
+  // is memory-mapped.
+  void read_node_starts(FILE *file, const TessdataManager *tessdata_manager,
+                        bool swap);
+  // Returns the number of entries of the node offset table written for
+  // num_nodes nodes, padded so that the edges that follow it are aligned
+  // like those of the old format.
+  static int num_node_starts_on_disk(int num_nodes);
+  // Constructs a mapping from the memory node indices to the node numbers
+  // of the node-indexed format, and fills nodes with the memory node
+  // indices in order of their node numbers.
+  NODE_MAP build_node_map(GenericVector<NODE_REF> *nodes) const;
+
+  // Builds the sorted edge index of the nodes other than node 0 that have
+  // at least dawg_min_indexed_edges forward edges.
+  void build_edge_index();
+  // Returns the index of node in indexed_nodes_, or -1 if it has no index.
+  int find_indexed_node(NODE_REF node) const;
 
 
   // Member variables.
   EDGE_ARRAY edges_;
   int num_edges_;
   int num_forward_edges_in_node0;
+  // True if edges_ points into a read-only memory mapping.
+  bool edges_mapped_;
+  // Node offset table of the node-indexed layout, with num_nodes_ + 1
+  // entries, or NULL for the edge array layout.
+  inT32 *node_starts_;
+  int num_nodes_;
+  // True if node_starts_ points into a read-only memory mapping.
+  bool node_starts_mapped_;
+  // Sorted edge index of the nodes with many edges, whose forward edges
+  // are not in order, unlike those of node 0. Only built for the edge
+  // array layout. indexed_nodes_ holds the
+  // indexed nodes in increasing order, and the forward edges of
+  // indexed_nodes_[i] are index_children_[index_starts_[i]] up to
+  // index_children_[index_starts_[i + 1]], ordered by unichar id and then
+  // by position in the node.
+  GenericVector<NODE_REF> indexed_nodes_;
+  GenericVector<int> index_starts_;
+  NodeChildVector index_children_;
 };
 }  // namespace tesseract
 
@@ -0,0 +1,580 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgbuilder.cpp
+// Description: Incremental construction of a minimal dawg from a sorted
+//              word list.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "dawgbuilder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ccutil.h"
+#include "cutil.h"
+#include "freelist.h"
+#include "helpers.h"
+#include "ndminx.h"
+#include "ratngs.h"
+#include "tprintf.h"
+#include "unicharset.h"
+
+namespace tesseract {
+
+// Initial size of the register of closed states, a power of 2.
+static const int kInitialRegisterSize = 1024;
+// Most unichar ids of the words that read_word_list sorts in memory at a
+// time when its input is not sorted.
+static const int kMaxRunUnicharIds = 1 << 22;
+
+DawgBuilder::DawgBuilder(DawgType type, const STRING &lang,
+                         PermuterType perm, int unicharset_size)
+  : register_size_(kInitialRegisterSize), num_registered_(0),
+    finished_(false) {
+  init(type, lang, perm, unicharset_size);
+  register_ = new inT32[register_size_];
+  memset(register_, 0, sizeof(*register_) * register_size_);
+  // State 0 is the root, whose edges are added by finish().
+  state_starts_.push_back(0);
+  num_state_edges_.push_back(0);
+  path_.push_back(new GenericVector<EDGE_RECORD>);
+}
+
+DawgBuilder::~DawgBuilder() {
+  delete [] register_;
+  path_.delete_data_pointers();
+}
+
+void DawgBuilder::clear() {
+  edges_.truncate(0);
+  state_starts_.truncate(0);
+  num_state_edges_.truncate(0);
+  state_starts_.push_back(0);
+  num_state_edges_.push_back(0);
+  memset(register_, 0, sizeof(*register_) * register_size_);
+  num_registered_ = 0;
+  for (int i = 0; i < path_.size(); ++i)
+    path_[i]->truncate(0);
+  last_word_.truncate(0);
+  finished_ = false;
+}
+
+bool DawgBuilder::add_word(const UNICHAR_ID *word, int length) {
+  if (finished_) return false;
+  if (length <= 0) return true;
+  int prefix = 0;
+  while (prefix < length && prefix < last_word_.size() &&
+         word[prefix] == last_word_[prefix])
+    ++prefix;
+  if (prefix == length && prefix == last_word_.size())
+    return true;  // the same word again
+  if (prefix < last_word_.size() &&
+      (prefix == length || word[prefix] < last_word_[prefix])) {
+    if (dawg_debug_level) tprintf("Word out of order in DawgBuilder\n");
+    return false;
+  }
+  close_path(prefix);
+  while (path_.size() <= length)
+    path_.push_back(new GenericVector<EDGE_RECORD>);
+  for (int i = prefix; i < length; ++i) {
+    path_[i]->push_back(make_edge_rec(word[i], i == length - 1, 0));
+    last_word_.push_back(word[i]);
+  }
+  return true;
+}
+
+void DawgBuilder::finish() {
+  if (finished_) return;
+  close_path(0);
+  GenericVector<EDGE_RECORD> *root = path_[0];
+  state_starts_[0] = edges_.size();
+  num_state_edges_[0] = root->size();
+  for (int i = 0; i < root->size(); ++i)
+    edges_.push_back((*root)[i]);
+  root->truncate(0);
+  finished_ = true;
+  if (dawg_debug_level) {
+    tprintf("DawgBuilder: %d states, %d edges\n", num_states(), num_edges());
+  }
+}
+
+// Appends the unichar ids of string to unichar_ids, followed by
+// INVALID_UNICHAR_ID, and its start to word_starts, unless it is empty or
+// has unichars that are not in unicharset.
+static void pack_word(const char *string, const UNICHARSET &unicharset,
+                      GenericVector<UNICHAR_ID> *unichar_ids,
+                      GenericVector<int> *word_starts) {
+  WERD_CHOICE word(string, unicharset);
+  if (word.length() != 0 && !word.contains_unichar_id(INVALID_UNICHAR_ID)) {
+    word_starts->push_back(unichar_ids->size());
+    for (int i = 0; i < word.length(); ++i)
+      unichar_ids->push_back(word.unichar_id(i));
+    unichar_ids->push_back(INVALID_UNICHAR_ID);
+  } else if (dawg_debug_level) {
+    tprintf("Skipping invalid word %s\n", string);
+    if (dawg_debug_level >= 3) word.print();
+  }
+}
+
+// Reads the next line of word_file and packs it like pack_word, counting
+// it in word_count. Returns false at the end of the file.
+static bool read_word(FILE *word_file, const UNICHARSET &unicharset,
+                      GenericVector<UNICHAR_ID> *unichar_ids,
+                      GenericVector<int> *word_starts, int *word_count) {
+  char string[CHARS_PER_LINE];
+  if (fgets(string, CHARS_PER_LINE, word_file) == NULL) return false;
+  chomp_string(string);  // remove newline
+  pack_word(string, unicharset, unichar_ids, word_starts);
+  ++*word_count;
+  if (dawg_debug_level && *word_count % 10000 == 0)
+    tprintf("Read %d words so far\n", *word_count);
+  return true;
+}
+
+bool DawgBuilder::read_word_list(const char *filename,
+                                 const UNICHARSET &unicharset,
+                                 int num_threads) {
+  FILE *word_file = fopen(filename, "r");
+  if (word_file == NULL) return false;
+
+  // Word lists are usually sorted already, and are then added one word at
+  // a time as they are read.
+  GenericVector<UNICHAR_ID> unichar_ids;
+  GenericVector<int> word_starts;
+  int word_count = 0;
+  bool sorted = true;
+  while (sorted && read_word(word_file, unicharset, &unichar_ids,
+                             &word_starts, &word_count)) {
+    if (!word_starts.empty())
+      sorted = add_word(&unichar_ids[0], unichar_ids.size() - 1);
+    unichar_ids.truncate(0);
+    word_starts.truncate(0);
+  }
+  bool result = true;
+  if (!sorted) {
+    if (dawg_debug_level)
+      tprintf("Word %d is out of order, sorting the list\n", word_count);
+    clear();
+    rewind(word_file);
+    word_count = 0;
+    result = add_unsorted_words(word_file, unicharset, num_threads,
+                                &word_count);
+  }
+  fclose(word_file);
+  if (dawg_debug_level)
+    tprintf("Read %d words total.\n", word_count);
+  return result;
+}
+
+bool DawgBuilder::add_unsorted_words(FILE *word_file,
+                                     const UNICHARSET &unicharset,
+                                     int num_threads, int *word_count) {
+  // Sort the words in runs of up to kMaxRunUnicharIds unichar ids, each
+  // kept in a temporary file, then merge the runs.
+  GenericVector<FILE *> runs;
+  GenericVector<UNICHAR_ID> unichar_ids;
+  GenericVector<int> word_starts;
+  bool result = true;
+  bool more = true;
+  while (result && more) {
+    unichar_ids.truncate(0);
+    word_starts.truncate(0);
+    while (unichar_ids.size() < kMaxRunUnicharIds &&
+           (more = read_word(word_file, unicharset, &unichar_ids,
+                             &word_starts, word_count))) {
+    }
+    if (word_starts.empty()) continue;
+    FILE *run = write_run(unichar_ids, word_starts, num_threads);
+    if (run != NULL)
+      runs.push_back(run);
+    else
+      result = false;
+  }
+  if (result) {
+    if (dawg_debug_level)
+      tprintf("Merging %d sorted runs\n", runs.size());
+    merge_runs(runs);
+  }
+  for (int i = 0; i < runs.size(); ++i)
+    fclose(runs[i]);
+  return result;
+}
+
+void DawgBuilder::add_words(const char * const *words, int num_words,
+                            const UNICHARSET &unicharset, int num_threads) {
+  GenericVector<UNICHAR_ID> unichar_ids;
+  GenericVector<int> word_starts;
+  for (int i = 0; i < num_words; ++i)
+    pack_word(words[i], unicharset, &unichar_ids, &word_starts);
+  add_packed_words(unichar_ids, word_starts, num_threads);
+}
+
+void DawgBuilder::add_packed_words(
+    const GenericVector<UNICHAR_ID> &unichar_ids,
+    const GenericVector<int> &word_starts, int num_threads) {
+  GenericVector<const UNICHAR_ID *> words;
+  words.reserve(word_starts.size());
+  for (int i = 0; i < word_starts.size(); ++i)
+    words.push_back(&unichar_ids[word_starts[i]]);
+  sort_words(&words, num_threads);
+  for (int i = 0; i < words.size(); ++i) {
+    int length = 0;
+    while (words[i][length] != INVALID_UNICHAR_ID) ++length;
+    ASSERT_HOST(add_word(words[i], length));
+  }
+}
+
+FILE *DawgBuilder::write_run(const GenericVector<UNICHAR_ID> &unichar_ids,
+                             const GenericVector<int> &word_starts,
+                             int num_threads) {
+  FILE *run = tmpfile();
+  if (run == NULL) {
+    tprintf("Can't make a temporary file to sort the word list\n");
+    return NULL;
+  }
+  GenericVector<const UNICHAR_ID *> words;
+  words.reserve(word_starts.size());
+  for (int i = 0; i < word_starts.size(); ++i)
+    words.push_back(&unichar_ids[word_starts[i]]);
+  sort_words(&words, num_threads);
+  bool written = true;
+  for (int i = 0; written && i < words.size(); ++i) {
+    int length = 0;
+    while (words[i][length] != INVALID_UNICHAR_ID) ++length;
+    // Keep the INVALID_UNICHAR_ID that ends the word.
+    written = fwrite(words[i], sizeof(*words[i]), length + 1, run) ==
+              static_cast<size_t>(length + 1);
+  }
+  if (!written || fflush(run) != 0) {
+    tprintf("Can't write the sorted word list to a temporary file\n");
+    fclose(run);
+    return NULL;
+  }
+  rewind(run);
+  return run;
+}
+
+// A sorted run of words being merged, with the next word to add.
+struct WordRun {
+  FILE *file;
+  GenericVector<UNICHAR_ID> word;  // Ends with INVALID_UNICHAR_ID.
+};
+
+// Reads the next word of run into run->word. Returns false if there are
+// no words left.
+static bool read_run_word(WordRun *run) {
+  run->word.truncate(0);
+  UNICHAR_ID unichar_id;
+  while (fread(&unichar_id, sizeof(unichar_id), 1, run->file) == 1) {
+    run->word.push_back(unichar_id);
+    if (unichar_id == INVALID_UNICHAR_ID) return true;
+  }
+  return false;
+}
+
+// Moves the run at index down the binary heap of runs, ordered by their
+// next words, until the heap is in order.
+static void sift_down(GenericVector<WordRun *> *heap, int index) {
+  int size = heap->size();
+  for (;;) {
+    int least = index;
+    for (int child = 2 * index + 1; child <= 2 * index + 2; ++child) {
+      if (child < size &&
+          DawgBuilder::compare_words(&(*heap)[child]->word[0],
+                                     &(*heap)[least]->word[0]) < 0)
+        least = child;
+    }
+    if (least == index) return;
+    WordRun *swap = (*heap)[index];
+    (*heap)[index] = (*heap)[least];
+    (*heap)[least] = swap;
+    index = least;
+  }
+}
+
+void DawgBuilder::merge_runs(const GenericVector<FILE *> &runs) {
+  GenericVector<WordRun *> heap;
+  for (int i = 0; i < runs.size(); ++i) {
+    WordRun *run = new WordRun;
+    run->file = runs[i];
+    if (read_run_word(run))
+      heap.push_back(run);
+    else
+      delete run;
+  }
+  for (int i = heap.size() / 2 - 1; i >= 0; --i)
+    sift_down(&heap, i);
+  while (!heap.empty()) {
+    WordRun *run = heap[0];
+    ASSERT_HOST(add_word(&run->word[0], run->word.size() - 1));
+    if (!read_run_word(run)) {
+      delete run;
+      heap[0] = heap[heap.size() - 1];
+      heap.truncate(heap.size() - 1);
+    }
+    if (!heap.empty()) sift_down(&heap, 0);
+  }
+}
+
+SquishedDawg *DawgBuilder::to_squished_dawg() {
+  ASSERT_HOST(finished_);
+  // Lay the states out in order of their numbers, so the root comes first,
+  // and link the edges to the first edge of their next nodes.
+  int num_states = state_starts_.size();
+  EDGE_REF *node_refs = new EDGE_REF[num_states];
+  EDGE_REF num_edges = 0;
+  for (int state = 0; state < num_states; ++state) {
+    node_refs[state] = num_edges;
+    num_edges += num_state_edges_[state];
+  }
+  // Allocate one edge more, left empty, so that an empty dawg reads as
+  // a root with no edges.
+  EDGE_ARRAY edge_array =
+    (EDGE_ARRAY) memalloc((num_edges + 1) * sizeof(EDGE_RECORD));
+  EDGE_ARRAY edge_array_ptr = edge_array;
+  for (int state = 0; state < num_states; ++state) {
+    int end = state_starts_[state] + num_state_edges_[state];
+    for (int edge = state_starts_[state]; edge < end; ++edge) {
+      EDGE_RECORD edge_rec = edges_[edge];
+      set_next_node_in_edge_rec(
+          &edge_rec, node_refs[next_node_from_edge_rec(edge_rec)]);
+      if (edge == end - 1) set_last_flag_in_edge_rec(&edge_rec);
+      *edge_array_ptr++ = edge_rec;
+    }
+  }
+  *edge_array_ptr = next_node_mask_;
+  delete [] node_refs;
+  return new SquishedDawg(edge_array, num_edges, type_, lang_, perm_,
+                          unicharset_size_);
+}
+
+int DawgBuilder::compare_words(const UNICHAR_ID *word1,
+                               const UNICHAR_ID *word2) {
+  while (*word1 == *word2 && *word1 != INVALID_UNICHAR_ID) {
+    ++word1;
+    ++word2;
+  }
+  if (*word1 == *word2) return 0;
+  return *word1 < *word2 ? -1 : 1;
+}
+
+// qsort comparator for pointers to words.
+static int compare_word_ptrs(const void *word1, const void *word2) {
+  return DawgBuilder::compare_words(
+      *reinterpret_cast<const UNICHAR_ID * const *>(word1),
+      *reinterpret_cast<const UNICHAR_ID * const *>(word2));
+}
+
+// A piece of the words to sort, or two adjacent sorted pieces,
+// [start, middle) and [middle, end), to merge into merged.
+struct WordSortJob {
+  const UNICHAR_ID **words;
+  const UNICHAR_ID **merged;
+  int start;
+  int middle;
+  int end;
+};
+
+static void *sort_piece(void *arg) {
+  WordSortJob *job = reinterpret_cast<WordSortJob *>(arg);
+  qsort(job->words + job->start, job->end - job->start,
+        sizeof(*job->words), compare_word_ptrs);
+  return NULL;
+}
+
+static void *merge_pieces(void *arg) {
+  WordSortJob *job = reinterpret_cast<WordSortJob *>(arg);
+  int i = job->start;
+  int j = job->middle;
+  int k = job->start;
+  while (i < job->middle && j < job->end) {
+    if (DawgBuilder::compare_words(job->words[j], job->words[i]) < 0)
+      job->merged[k++] = job->words[j++];
+    else
+      job->merged[k++] = job->words[i++];
+  }
+  while (i < job->middle) job->merged[k++] = job->words[i++];
+  while (j < job->end) job->merged[k++] = job->words[j++];
+  return NULL;
+}
+
+// Runs func on each of the jobs, in parallel threads if possible.
+static void run_jobs(void *(*func)(void *), WordSortJob *jobs, int num_jobs) {
+  CCUtilThread *threads = new CCUtilThread[num_jobs];
+  for (int i = 1; i < num_jobs; ++i) {
+    if (!threads[i].Start(func, &jobs[i]))
+      func(&jobs[i]);
+  }
+  func(&jobs[0]);
+  for (int i = 1; i < num_jobs; ++i)
+    threads[i].Join();
+  delete [] threads;
+}
+
+void DawgBuilder::sort_words(GenericVector<const UNICHAR_ID *> *words,
+                             int num_threads) {
+  int num_words = words->size();
+  int i;
+  for (i = 1; i < num_words; ++i) {
+    if (compare_words((*words)[i - 1], (*words)[i]) > 0) break;
+  }
+  if (i >= num_words) return;  // already sorted, as word lists often are
+
+  // Sort num_pieces pieces of the words separately, then merge pairs of
+  // adjacent pieces until there is one left.
+  int num_pieces = MAX(MIN(num_threads, num_words), 1);
+  const UNICHAR_ID **sorted = &(*words)[0];
+  const UNICHAR_ID **merged = new const UNICHAR_ID *[num_words];
+  int *bounds = new int[num_pieces + 1];
+  for (i = 0; i <= num_pieces; ++i)
+    bounds[i] = static_cast<inT64>(num_words) * i / num_pieces;
+  WordSortJob *jobs = new WordSortJob[num_pieces];
+  for (i = 0; i < num_pieces; ++i) {
+    jobs[i].words = sorted;
+    jobs[i].start = bounds[i];
+    jobs[i].end = bounds[i + 1];
+  }
+  run_jobs(sort_piece, jobs, num_pieces);
+  while (num_pieces > 1) {
+    int num_jobs = (num_pieces + 1) / 2;
+    for (i = 0; i < num_jobs; ++i) {
+      jobs[i].words = sorted;
+      jobs[i].merged = merged;
+      jobs[i].start = bounds[2 * i];
+      // An odd piece out is merged with nothing, which copies it.
+      jobs[i].middle = bounds[MIN(2 * i + 1, num_pieces)];
+      jobs[i].end = bounds[MIN(2 * i + 2, num_pieces)];
+    }
+    run_jobs(merge_pieces, jobs, num_jobs);
+    for (i = 0; i < num_jobs; ++i)
+      bounds[i + 1] = jobs[i].end;
+    num_pieces = num_jobs;
+    const UNICHAR_ID **swap = sorted;
+    sorted = merged;
+    merged = swap;
+  }
+  if (sorted != &(*words)[0]) {
+    memcpy(&(*words)[0], sorted, sizeof(*sorted) * num_words);
+    merged = sorted;
+  }
+  delete [] merged;
+  delete [] bounds;
+  delete [] jobs;
+}
+
+EDGE_REF DawgBuilder::edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
+                                   bool word_end) const {
+  if (node < 0 || node >= num_states()) return NO_EDGE;
+  int end = state_starts_[node] + num_state_edges_[node];
+  for (int edge = state_starts_[node]; edge < end; ++edge) {
+    UNICHAR_ID edge_unichar_id = unichar_id_from_edge_rec(edges_[edge]);
+    if (edge_unichar_id > unichar_id) break;
+    if (edge_unichar_id == unichar_id &&
+        (!word_end || end_of_word_from_edge_rec(edges_[edge])))
+      return edge;
+  }
+  return NO_EDGE;
+}
+
+void DawgBuilder::unichar_ids_of(NODE_REF node, NodeChildVector *vec) const {
+  if (node < 0 || node >= num_states()) return;
+  int end = state_starts_[node] + num_state_edges_[node];
+  for (int edge = state_starts_[node]; edge < end; ++edge)
+    vec->push_back(NodeChild(unichar_id_from_edge_rec(edges_[edge]), edge));
+}
+
+void DawgBuilder::print_node(NODE_REF node, int max_num_edges) const {
+  if (node < 0 || node >= num_states()) return;
+  int end = state_starts_[node] + num_state_edges_[node];
+  for (int edge = state_starts_[node];
+       edge < end && edge - state_starts_[node] < max_num_edges; ++edge) {
+    tprintf("%d : next = " REFFORMAT ", unichar_id = %d, %s\n", edge,
+            next_node(edge), edge_letter(edge),
+            end_of_word(edge) ? "EOW" : "");
+  }
+  tprintf("\n");
+}
+
+EDGE_RECORD DawgBuilder::make_edge_rec(UNICHAR_ID unichar_id, bool word_end,
+                                       NODE_REF next_node) const {
+  EDGE_RECORD flags = word_end ? WERD_END_FLAG : 0;
+  return ((static_cast<EDGE_RECORD>(next_node) << next_node_start_bit_) |
+          (flags << flag_start_bit_) |
+          (static_cast<EDGE_RECORD>(unichar_id) << LETTER_START_BIT));
+}
+
+void DawgBuilder::close_path(int depth) {
+  for (int i = last_word_.size(); i > depth; --i) {
+    NODE_REF state = register_state(*path_[i]);
+    path_[i]->truncate(0);
+    GenericVector<EDGE_RECORD> *parent = path_[i - 1];
+    set_next_node_in_edge_rec(&(*parent)[parent->size() - 1], state);
+  }
+  last_word_.truncate(depth);
+}
+
+NODE_REF DawgBuilder::register_state(
+    const GenericVector<EDGE_RECORD> &edges) {
+  if (edges.empty()) return 0;  // the end of a word
+  const EDGE_RECORD *edge_ptr = &edges[0];
+  int slot = hash_edges(edge_ptr, edges.size()) & (register_size_ - 1);
+  while (register_[slot] != 0) {
+    if (state_equals(register_[slot], edge_ptr, edges.size()))
+      return register_[slot];
+    slot = (slot + 1) & (register_size_ - 1);
+  }
+  NODE_REF state = state_starts_.size();
+  state_starts_.push_back(edges_.size());
+  num_state_edges_.push_back(edges.size());
+  for (int i = 0; i < edges.size(); ++i)
+    edges_.push_back(edges[i]);
+  insert_in_register(state);
+  return state;
+}
+
+uinT32 DawgBuilder::hash_edges(const EDGE_RECORD *edges, int num_edges) {
+  uinT64 hash = num_edges;
+  for (int i = 0; i < num_edges; ++i)
+    hash = (hash ^ edges[i]) * 1099511628211ULL;
+  return static_cast<uinT32>(hash ^ (hash >> 32));
+}
+
+bool DawgBuilder::state_equals(NODE_REF state, const EDGE_RECORD *edges,
+                               int num_edges) const {
+  if (num_state_edges_[state] != num_edges) return false;
+  return memcmp(&edges_[state_starts_[state]], edges,
+                sizeof(*edges) * num_edges) == 0;
+}
+
+void DawgBuilder::insert_in_register(NODE_REF state) {
+  if (2 * (num_registered_ + 1) > register_size_) {
+    // Keep the register at most half full.
+    delete [] register_;
+    register_size_ *= 2;
+    register_ = new inT32[register_size_];
+    memset(register_, 0, sizeof(*register_) * register_size_);
+    num_registered_ = 0;
+    for (int old_state = 1; old_state < state; ++old_state)
+      insert_in_register(old_state);
+  }
+  int slot = hash_edges(&edges_[state_starts_[state]],
+                        num_state_edges_[state]) & (register_size_ - 1);
+  while (register_[slot] != 0)
+    slot = (slot + 1) & (register_size_ - 1);
+  register_[slot] = state;
+  ++num_registered_;
+}
+
+}  // namespace tesseract
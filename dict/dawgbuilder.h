@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgbuilder.h
+// Description: Incremental construction of a minimal dawg from a sorted
+//              word list.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_DICT_DAWGBUILDER_H__
+#define TESSERACT_DICT_DAWGBUILDER_H__
+
+#include <stdio.h>
+
+#include "dawg.h"
+#include "genericvector.h"
+#include "host.h"
+#include "unichar.h"
+
+class UNICHARSET;
+
+namespace tesseract {
+
+// DawgBuilder builds the minimal dawg of a word list in a single pass over
+// the words in sorted order (Daciuk et al., "Incremental Construction of
+// Minimal Acyclic Finite-State Automata"). Only the states along the last
+// word added are still open. When the next word leaves that path, the
+// states it leaves are closed deepest first, each replaced by an equal
+// state from a register of the closed states if there is one, so the
+// closed states always form a minimal dawg, and memory grows with the
+// size of the result, not with the number of words.
+//
+// The closed states are numbered from 1, and state 0 is the root, which
+// is closed by finish(). As in SquishedDawg, an edge that ends a word and
+// leads to no more letters points to node 0. Once finished, a DawgBuilder
+// can be searched like any other Dawg, and converted to a SquishedDawg.
+class DawgBuilder : public Dawg {
+ public:
+  DawgBuilder(DawgType type, const STRING &lang, PermuterType perm,
+              int unicharset_size);
+  ~DawgBuilder();
+
+  // Adds the given word, of length unichar ids, which must not come before
+  // the last word added in the order of compare_words. A word equal to the
+  // last one is ignored. Returns false if the word is out of order, or if
+  // the dawg is finished.
+  bool add_word(const UNICHAR_ID *word, int length);
+
+  // Closes the open states, including the root. No words can be added
+  // after this.
+  void finish();
+
+  // Reads the words in the given file, one per line, and adds them all, to
+  // a builder that has no words yet. Words with unichars that are not in
+  // unicharset are skipped. A list sorted by unichar id (see compare_words)
+  // is added as it is read. Any other list, including one sorted by
+  // collation or by bytes, is read again in runs of bounded size, each
+  // sorted using up to num_threads threads and kept in a temporary file,
+  // and the runs are merged, so that the memory used does not grow with
+  // the length of the list. Returns false if the file could not be read,
+  // or a temporary file could not be written.
+  bool read_word_list(const char *filename, const UNICHARSET &unicharset,
+                      int num_threads);
+  // Adds the given UTF-8 words, in any order, like read_word_list.
+  void add_words(const char * const *words, int num_words,
+                 const UNICHARSET &unicharset, int num_threads);
+
+  // Returns a new SquishedDawg with the same words as this finished dawg.
+  // The caller takes ownership of the result.
+  SquishedDawg *to_squished_dawg();
+
+  // Returns the number of states, and of edges, closed so far.
+  int num_states() const { return state_starts_.size(); }
+  int num_edges() const { return edges_.size(); }
+
+  // Orders words, given as strings of unichar ids terminated by
+  // INVALID_UNICHAR_ID, lexicographically by unichar id.
+  static int compare_words(const UNICHAR_ID *word1, const UNICHAR_ID *word2);
+  // Sorts words by compare_words, sorting pieces of the vector in up to
+  // num_threads threads and merging them.
+  static void sort_words(GenericVector<const UNICHAR_ID *> *words,
+                         int num_threads);
+
+  // Methods of Dawg, valid once the dawg is finished.
+  EDGE_REF edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
+                        bool word_end) const;
+  void unichar_ids_of(NODE_REF node, NodeChildVector *vec) const;
+  NODE_REF next_node(EDGE_REF edge_ref) const {
+    return next_node_from_edge_rec(edges_[edge_ref]);
+  }
+  bool end_of_word(EDGE_REF edge_ref) const {
+    return end_of_word_from_edge_rec(edges_[edge_ref]);
+  }
+  UNICHAR_ID edge_letter(EDGE_REF edge_ref) const {
+    return unichar_id_from_edge_rec(edges_[edge_ref]);
+  }
+  void print_node(NODE_REF node, int max_num_edges) const;
+
+ private:
+  // Returns an edge for unichar_id leading to next_node.
+  EDGE_RECORD make_edge_rec(UNICHAR_ID unichar_id, bool word_end,
+                            NODE_REF next_node) const;
+  // Sorts the words packed in unichar_ids, the ids of each word followed
+  // by INVALID_UNICHAR_ID and starting at an entry of word_starts, and adds
+  // them all.
+  void add_packed_words(const GenericVector<UNICHAR_ID> &unichar_ids,
+                        const GenericVector<int> &word_starts,
+                        int num_threads);
+  // Removes all the words, leaving the builder as it was constructed.
+  void clear();
+  // Reads the rest of word_file, counting its words in word_count, and
+  // adds them all in sorted runs, as read_word_list describes.
+  bool add_unsorted_words(FILE *word_file, const UNICHARSET &unicharset,
+                          int num_threads, int *word_count);
+  // Sorts the words given as for add_packed_words and writes them to a new
+  // temporary file, which the caller closes. Returns NULL on failure.
+  static FILE *write_run(const GenericVector<UNICHAR_ID> &unichar_ids,
+                         const GenericVector<int> &word_starts,
+                         int num_threads);
+  // Adds the words of the given sorted runs, merged in order.
+  void merge_runs(const GenericVector<FILE *> &runs);
+  // Closes the open states deeper than depth.
+  void close_path(int depth);
+  // Returns the number of a closed state with the given edges, which is
+  // new unless the register already has an equal state. The root is never
+  // registered.
+  NODE_REF register_state(const GenericVector<EDGE_RECORD> &edges);
+  // Returns the hash of the given edges.
+  static uinT32 hash_edges(const EDGE_RECORD *edges, int num_edges);
+  // Returns true if closed state matches the given edges.
+  bool state_equals(NODE_REF state, const EDGE_RECORD *edges,
+                    int num_edges) const;
+  // Inserts state into register_, growing it if it is getting full.
+  void insert_in_register(NODE_REF state);
+
+  // Edges of the closed states. The edges of state i are
+  // edges_[state_starts_[i]] up to edges_[state_starts_[i] +
+  // num_state_edges_[i]], in increasing order of unichar id.
+  GenericVector<EDGE_RECORD> edges_;
+  GenericVector<inT32> state_starts_;
+  GenericVector<inT32> num_state_edges_;
+  // Open hash table of the closed states other than the root, with 0 for
+  // empty slots. Its size is a power of 2.
+  inT32 *register_;
+  int register_size_;
+  int num_registered_;
+  // path_[i] holds the edges of the open state reached by the first i
+  // letters of last_word_. The last edge of each open state but the
+  // deepest leads to the next one, and is linked when that one is closed.
+  GenericVector<GenericVector<EDGE_RECORD> *> path_;
+  GenericVector<UNICHAR_ID> last_word_;
+  bool finished_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_DICT_DAWGBUILDER_H__
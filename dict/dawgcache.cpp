@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgcache.cpp
+// Description: Cache of the dawg edges followed while permuting a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "dawgcache.h"
+
+namespace tesseract {
+
+DawgEdgeCache::DawgEdgeCache()
+  : entries_(new Entry[kNumEntries]), generation_(1) {
+  for (int i = 0; i < kNumEntries; ++i)
+    entries_[i].generation = 0;
+}
+
+DawgEdgeCache::~DawgEdgeCache() {
+  delete [] entries_;
+}
+
+void DawgEdgeCache::Clear() {
+  if (++generation_ == 0) {
+    // The generation wrapped around, so old entries could look valid.
+    for (int i = 0; i < kNumEntries; ++i)
+      entries_[i].generation = 0;
+    generation_ = 1;
+  }
+}
+
+}  // namespace tesseract
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgcache.h
+// Description: Cache of the dawg edges followed while permuting a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_DICT_DAWGCACHE_H__
+#define TESSERACT_DICT_DAWGCACHE_H__
+
+#include "dawg.h"
+#include "host.h"
+#include "unichar.h"
+
+namespace tesseract {
+
+// DawgEdgeCache remembers the result of Dawg::edge_char_of for each
+// (dawg index, node, unichar id, word end) looked up since it was last
+// cleared. A node stands for the prefix of the word that led to it, so
+// the candidate words of a segmentation, and the segmentations of a word,
+// that share a prefix find its edges here instead of searching the dawg
+// nodes again. The cache is direct-mapped with a fixed number of entries,
+// and is cleared in constant time.
+// The edges of a Trie change as words are added to it, so the cache must
+// be cleared whenever a dawg changes.
+class DawgEdgeCache {
+ public:
+  DawgEdgeCache();
+  ~DawgEdgeCache();
+
+  // Forgets all the edges.
+  void Clear();
+
+  // Returns true and sets *edge if the edge of dawg_index out of node for
+  // unichar_id and word_end is in the cache.
+  bool Lookup(int dawg_index, NODE_REF node, UNICHAR_ID unichar_id,
+              bool word_end, EDGE_REF *edge) const {
+    const Entry &entry = entries_[Slot(dawg_index, node, unichar_id,
+                                       word_end)];
+    if (entry.generation != generation_ || entry.node != node ||
+        entry.dawg_index != dawg_index || entry.unichar_id != unichar_id ||
+        entry.word_end != word_end)
+      return false;
+    *edge = entry.edge;
+    return true;
+  }
+  // Records edge as the edge of dawg_index out of node for unichar_id and
+  // word_end, in place of any entry that had the same slot.
+  void Insert(int dawg_index, NODE_REF node, UNICHAR_ID unichar_id,
+              bool word_end, EDGE_REF edge) {
+    Entry &entry = entries_[Slot(dawg_index, node, unichar_id, word_end)];
+    entry.node = node;
+    entry.edge = edge;
+    entry.dawg_index = dawg_index;
+    entry.unichar_id = unichar_id;
+    entry.word_end = word_end;
+    entry.generation = generation_;
+  }
+
+ private:
+  // Number of entries, a power of 2.
+  static const int kNumEntries = 4096;
+
+  struct Entry {
+    NODE_REF node;
+    EDGE_REF edge;
+    int dawg_index;
+    UNICHAR_ID unichar_id;
+    bool word_end;
+    uinT32 generation;  // Entry is valid if equal to generation_.
+  };
+
+  static int Slot(int dawg_index, NODE_REF node, UNICHAR_ID unichar_id,
+                  bool word_end) {
+    uinT32 hash = static_cast<uinT32>(node) * 2654435761u;
+    hash ^= (static_cast<uinT32>(unichar_id) << 1 | word_end) * 40503u;
+    hash ^= dawg_index * 97u;
+    return (hash ^ (hash >> 16)) & (kNumEntries - 1);
+  }
+
+  Entry *entries_;
+  uinT32 generation_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_DICT_DAWGCACHE_H__
@@ -35,10 +35,17 @@ Dict::Dict(Image* image_ptr)
   go_deeper_fxn_ = NULL;
   hyphen_word_ = NULL;
   last_word_on_line_ = false;
+  top_choice_only_ = false;
+  permute_only_top_ = false;
+  permutation_count_ = 0;
+  wordseg_rating_adjust_factor_ = -1.0f;
   hyphen_unichar_id_ = INVALID_UNICHAR_ID;
   document_words_ = NULL;
   pending_words_ = NULL;
   freq_dawg_ = NULL;
+  num_file_dawgs_ = 0;
+  dawg_source_ = NULL;
+  ngram_model_ = NULL;
 }
 
 Dict::~Dict() {
@@ -106,7 +113,7 @@ int Dict::def_letter_is_okay(void* void_dawg_args, int word_index,
     }
     // Find the edge out of the node for the curent unichar_id.
     EDGE_REF edge = (node != NO_EDGE) ?
-      dawg->edge_char_of(node, unichar_id, word_end) : NO_EDGE;
+      CachedEdgeCharOf(info.dawg_index, node, unichar_id, word_end) : NO_EDGE;
 
     if (dawg_debug_level >= 3) {
       tprintf("Active dawg: [%d, " REFFORMAT "] edge=" REFFORMAT "\n",
@@ -128,7 +135,8 @@ int Dict::def_letter_is_okay(void* void_dawg_args, int word_index,
       // This constraint will be applied later when this dawg is found among
       // successor dawgs as well potentially at the end of the word.
       if (dawg->type() == DAWG_TYPE_PUNCTUATION) {
-        edge = dawg->edge_char_of(node, Dawg::kPatternUnicharID, word_end);
+        edge = CachedEdgeCharOf(info.dawg_index, node,
+                                Dawg::kPatternUnicharID, word_end);
         if (edge != NO_EDGE) {
           dawg_args->updated_constraints->add_unique(
               DawgInfo(info.dawg_index, edge), "Recording constraint: ");
@@ -182,8 +190,8 @@ int Dict::def_letter_is_okay(void* void_dawg_args, int word_index,
           }
         }
         // Look for the letter in this successor dawg.
-        EDGE_REF sedge = sdawg->edge_char_of(
-            snode, word->unichar_id(word_index), word_end);
+        EDGE_REF sedge = CachedEdgeCharOf(
+            sdawg_index, snode, word->unichar_id(word_index), word_end);
         // If we found the letter append sdawg to the active_dawgs list.
         if (sedge != NO_EDGE &&
             ConstraintsOk(*(dawg_args->updated_constraints), word_end,
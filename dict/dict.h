@@ -23,11 +23,14 @@
 #include "choices.h"
 #include "choicearr.h"
 #include "dawg.h"
+#include "dawgcache.h"
 #include "image.h"
+#include "ngrammodel.h"
 #include "ratngs.h"
 #include "stopper.h"
 #include "trie.h"
 #include "unicharset.h"
+#include "userdict.h"
 
 extern STRING_VAR_H(global_user_words_suffix, "user-words",
                     "A list of user-provided words.");
@@ -81,8 +84,11 @@ class Dict {
   UNICHARSET& getUnicharset() {
     return getImage()->getCCUtil()->unicharset;
   }
+  // The ambigs are read-only, so a Dict that shares the dawgs of another
+  // shares its ambigs too.
   const UnicharAmbigs &getUnicharAmbigs() {
-    return getImage()->getCCUtil()->unichar_ambigs;
+    const Dict *owner = dawg_source_ != NULL ? dawg_source_ : this;
+    return owner->image_ptr_->getCCUtil()->unichar_ambigs;
   }
 
   /* hyphen.cpp ************************************************************/
@@ -126,6 +132,9 @@ class Dict {
   void set_hyphen_word(const WERD_CHOICE &word,
                        const DawgInfoVector &active_dawgs,
                        const DawgInfoVector &constraints);
+  // Takes over the hyphen state of source, as if this Dict had recognized
+  // the last word that source did. The dawgs must be the same.
+  void CopyHyphenState(const Dict &source);
 
   /* permdawg.cpp ************************************************************/
   // If new_rating < best_choice->rating(), copy word int best_choice
@@ -167,7 +176,39 @@ class Dict {
 
   /* permute.cpp *************************************************************/
   void add_document_word(const WERD_CHOICE &best_choice);
+  // Number of calls of permute_characters since init_permute.
+  int permutation_count() const { return permutation_count_; }
+  // Sets the multiplier that incorporate_segcost applies to the ratings of
+  // the words of the segmentation being evaluated. None if not positive.
+  void set_wordseg_rating_adjust_factor(float factor) {
+    wordseg_rating_adjust_factor_ = factor;
+  }
   void init_permute();
+  // Makes init_permute borrow the dawgs that source loaded from the
+  // traineddata file (punctuation, system, number and frequent words),
+  // and its n-gram model and ambigs, instead of reading private copies. The
+  // user and document dawgs stay private. The source must stay initialized
+  // for as long as this Dict uses its dawgs. Pass NULL to go back to loading
+  // private copies.
+  void ShareDawgsFrom(const Dict *source);
+  // Adds the dawg of user_dict to the dawgs searched for words, after all
+  // the others, and holds a reference to user_dict until it is removed or
+  // end_permute is called. Returns false if the dawgs are not loaded, or
+  // if user_dict was built for another unicharset or language, or was
+  // already added. Must not be called while a word is being recognized.
+  bool AddUserDictionary(UserDictionary *user_dict);
+  // Stops searching the dawg of user_dict and releases it. Returns false
+  // if it was not added.
+  bool RemoveUserDictionary(UserDictionary *user_dict);
+  // Searches new_dict in place of old_dict, like RemoveUserDictionary
+  // followed by AddUserDictionary, but in one step.
+  bool ReplaceUserDictionary(UserDictionary *old_dict,
+                             UserDictionary *new_dict);
+  // Gives this Dict the document words and the user dictionaries of
+  // source, which shares or loaded the same dawgs from the traineddata, so
+  // that both find the same words. Must not be called while a word is being
+  // recognized.
+  void CopyWordListsFrom(const Dict &source);
   WERD_CHOICE *permute_top_choice(
     const BLOB_CHOICE_LIST_VECTOR &char_choices,
     float* rating_limit,
@@ -191,12 +232,33 @@ class Dict {
                            float rating_limit,
                            WERD_CHOICE *raw_choice);
   void end_permute();
+  // Builds successors_ from the dawgs in dawgs_.
+  void init_successors();
+  // Prepares the search for a change to the dawgs in dawgs_: rebuilds
+  // successors_ and forgets the cached edges and the dawg state of a word
+  // hyphenated across lines, which refer to dawgs by index.
+  void dawgs_changed();
+  // Returns true if user_dict may be added to the dawgs of this Dict.
+  bool user_dictionary_fits(const UserDictionary *user_dict);
   void adjust_non_word(WERD_CHOICE *word, float *adjust_factor);
   void permute_subword(const BLOB_CHOICE_LIST_VECTOR &char_choices,
                        float rating_limit,
                        int start,
                        int end,
                        WERD_CHOICE *current_word);
+  // Restricts the permuter to the top choice of each blob (as does
+  // set_permute_only_top) for the current word only.
+  void set_top_choice_only(bool value) {
+    top_choice_only_ = value;
+  }
+  // Restricts the permuter to the top choice of each blob for every word,
+  // until it is cleared, as ambigs training does.
+  void set_permute_only_top(bool value) {
+    permute_only_top_ = value;
+  }
+  bool permute_only_top() const {
+    return permute_only_top_;
+  }
   void permute_characters(const BLOB_CHOICE_LIST_VECTOR &char_choices,
                           float limit,
                           WERD_CHOICE *best_choice,
@@ -324,9 +386,16 @@ class Dict {
   void print_choices(const char *label,
                      CHOICES rating);   // List of (A_CHOICE*).
   /* permngram.cpp ***********************************************************/
-  A_CHOICE *ngram_permute_and_select(CHOICES_LIST char_choices,
-                                     float rating_limit,
-                                     const Dawg *dawg);
+  // Permutes the given char_choices by the sum of the classifier ratings
+  // and the costs under the n-gram model, mixed by
+  // classifier_score_ngram_score_ratio, and returns the best word, or NULL
+  // if there is no n-gram model or if the best rating is worse than
+  // rating_limit. Words that are not prefixes in dawg (if not NULL) are
+  // penalized by non_dawg_prefix_rating_adjustment.
+  WERD_CHOICE *ngram_permute_and_select(
+      const BLOB_CHOICE_LIST_VECTOR &char_choices,
+      float rating_limit,
+      const Dawg *dawg);
   /* dawg.cpp ****************************************************************/
 
   // Returns the maximal permuter code (from ccstruct/ratngs.h) if in light
@@ -401,6 +470,18 @@ class Dict {
   inline const int NumDawgs() const { return dawgs_.size(); }
   // Return i-th dawg pointer recorded in the dawgs_ vector.
   inline const Dawg *GetDawg(int index) const { return dawgs_[index]; }
+  // Return the edge of the dawg at dawg_index out of node for unichar_id,
+  // as dawgs_[dawg_index]->edge_char_of() does, looking it up in
+  // edge_cache_ first.
+  inline EDGE_REF CachedEdgeCharOf(int dawg_index, NODE_REF node,
+                                   UNICHAR_ID unichar_id, bool word_end) {
+    EDGE_REF edge;
+    if (!edge_cache_.Lookup(dawg_index, node, unichar_id, word_end, &edge)) {
+      edge = dawgs_[dawg_index]->edge_char_of(node, unichar_id, word_end);
+      edge_cache_.Insert(dawg_index, node, unichar_id, word_end, edge);
+    }
+    return edge;
+  }
   // At word ending make sure all the recorded constraints are satisfied.
   // Each constraint signifies that we found a beginning pattern in a
   // pattern dawg. Check that this pattern can end here (e.g. if some
@@ -466,10 +547,31 @@ class Dict {
   DawgInfoVector hyphen_active_dawgs_;
   DawgInfoVector hyphen_constraints_;
   bool last_word_on_line_;
+  // Only permute the top choices of the current word.
+  bool top_choice_only_;
+  // Only permute the top choices of every word.
+  bool permute_only_top_;
+  int permutation_count_;
+  // Segmentation cost multiplier of the word ratings, see
+  // incorporate_segcost.
+  float wordseg_rating_adjust_factor_;
   // Dawgs.
   DawgVector dawgs_;
   SuccessorListsVector successors_;
+  // Edges of dawgs_ looked up during the current word. Cleared for each
+  // word, and whenever a word is added to one of dawgs_.
+  DawgEdgeCache edge_cache_;
   Dawg *freq_dawg_;
+  // The first num_file_dawgs_ entries of dawgs_ were read from the
+  // traineddata file. They are owned by dawg_source_ if it is not NULL.
+  int num_file_dawgs_;
+  const Dict *dawg_source_;
+  // User dictionaries added at runtime, whose dawgs are the last
+  // user_dictionaries_.size() entries of dawgs_, in the same order.
+  GenericVector<UserDictionary *> user_dictionaries_;
+  // Character n-gram model read from the traineddata file if
+  // ngram_permuter_activated is set, or borrowed from dawg_source_.
+  NgramModel *ngram_model_;
   Trie *pending_words_;
   // The following pointers are only cached for convenience.
   // The dawgs will be deleted when dawgs_ vector is destroyed.
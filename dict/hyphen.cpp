@@ -66,4 +66,18 @@ void Dict::set_hyphen_word(const WERD_CHOICE &word,
     hyphen_word_->print("set_hyphen_word: ");
   }
 }
+
+void Dict::CopyHyphenState(const Dict &source) {
+  if (source.hyphen_word_ == NULL) {
+    delete hyphen_word_;
+    hyphen_word_ = NULL;
+  } else {
+    if (hyphen_word_ == NULL)
+      hyphen_word_ = new WERD_CHOICE();
+    *hyphen_word_ = *source.hyphen_word_;
+  }
+  hyphen_active_dawgs_ = source.hyphen_active_dawgs_;
+  hyphen_constraints_ = source.hyphen_constraints_;
+  last_word_on_line_ = source.last_word_on_line_;
+}
 }  // namespace tesseract
@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////
+// File:        ngrammodel.cpp
+// Description: Compact character n-gram model used by the ngram permuter.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "ngrammodel.h"
+
+#include <string.h>
+
+#include "errcode.h"
+#include "serialis.h"
+#include "tessdatamanager.h"
+#include "unichar.h"
+
+namespace tesseract {
+
+// Magic number at the start of a model, also used to detect the byte order.
+static const inT32 kNgramModelMagicNumber = 0x4d474e54;
+
+// Unicode values must leave the low 8 bits of a slot for the cost.
+static const inT32 kMaxUnicode = 0xffffff;
+
+// Reads num_words 32-bit words from file into data, swapping their bytes
+// if swap is true. Returns false if they could not all be read.
+static bool ReadWords(FILE *file, bool swap, int num_words, void *data) {
+  if (fread(data, sizeof(inT32), num_words, file) !=
+      static_cast<size_t>(num_words))
+    return false;
+  if (swap) {
+    uinT32 *words = static_cast<uinT32 *>(data);
+    for (int i = 0; i < num_words; ++i)
+      words[i] = reverse32(words[i]);
+  }
+  return true;
+}
+
+// Returns the index of the level of cost_table nearest to cost.
+static int QuantizeCost(float cost, float min_cost, float step) {
+  if (step <= 0.0f)
+    return 0;
+  int level = static_cast<int>((cost - min_cost) / step + 0.5f);
+  return level < 0 ? 0 : (level > 255 ? 255 : level);
+}
+
+NgramModel::NgramModel()
+  : order_(0), num_states_(0), num_slots_(0), unknown_cost_(0.0f),
+    states_(NULL), slots_(NULL), mapped_(false), word_start_state_(0) {
+}
+
+NgramModel::~NgramModel() {
+  Clear();
+}
+
+void NgramModel::Clear() {
+  if (!mapped_) {
+    delete [] states_;
+    delete [] slots_;
+  }
+  states_ = NULL;
+  slots_ = NULL;
+  mapped_ = false;
+  num_states_ = 0;
+  num_slots_ = 0;
+}
+
+bool NgramModel::Read(FILE *file, const TessdataManager *tessdata_manager) {
+  Clear();
+  inT32 header[4];
+  if (fread(header, sizeof(inT32), 4, file) != 4)
+    return false;
+  bool swap = header[0] != kNgramModelMagicNumber;
+  if (swap) {
+    for (int i = 0; i < 4; ++i)
+      header[i] = reverse32(header[i]);
+    if (header[0] != kNgramModelMagicNumber)
+      return false;
+  }
+  order_ = header[1];
+  inT32 num_states = header[2];
+  inT32 num_slots = header[3];
+  if (order_ < 1 || num_states < 1 || num_slots < 2 ||
+      (num_slots & (num_slots - 1)) != 0)
+    return false;
+  if (!ReadWords(file, swap, 1, &unknown_cost_) ||
+      !ReadWords(file, swap, kNumCostLevels, cost_table_))
+    return false;
+
+  // Use the tables in place if they are mapped and need no byte swapping.
+  inT64 states_size = sizeof(State) * static_cast<inT64>(num_states);
+  inT64 slots_size = sizeof(Slot) * static_cast<inT64>(num_slots);
+  const char *mapped = NULL;
+  if (tessdata_manager != NULL && !swap) {
+    mapped = tessdata_manager->GetMappedData(sizeof(inT32),
+                                             states_size + slots_size);
+  }
+  if (mapped != NULL) {
+    mapped_ = true;
+    states_ = (State *) mapped;
+    slots_ = (Slot *) (mapped + states_size);
+    fseek(file, states_size + slots_size, SEEK_CUR);
+  } else {
+    states_ = new State[num_states];
+    slots_ = new Slot[num_slots];
+    if (!ReadWords(file, swap, num_states * 2, states_) ||
+        !ReadWords(file, swap, num_slots * 3, slots_)) {
+      Clear();
+      return false;
+    }
+  }
+  num_states_ = num_states;
+  num_slots_ = num_slots;
+  if (!TablesValid()) {
+    Clear();
+    return false;
+  }
+  Cost(0, ' ', &word_start_state_);
+  return true;
+}
+
+bool NgramModel::TablesValid() const {
+  // Each state backs off to a shorter context, which has a lower index, so
+  // Cost always ends at state 0 and then -1.
+  for (inT32 i = 0; i < num_states_; ++i) {
+    const State &state = states_[i];
+    if (state.backoff_state >= i || state.backoff_state < (i == 0 ? -1 : 0) ||
+        state.backoff_cost < 0 || state.backoff_cost >= kNumCostLevels)
+      return false;
+  }
+  // FindSlot needs an empty slot to end its search.
+  bool any_empty = false;
+  for (inT32 i = 0; i < num_slots_; ++i) {
+    const Slot &slot = slots_[i];
+    if (slot.state == -1) {
+      any_empty = true;
+    } else if (slot.state < 0 || slot.state >= num_states_ ||
+               slot.next_state < 0 || slot.next_state >= num_states_) {
+      return false;
+    }
+  }
+  return any_empty;
+}
+
+bool NgramModel::Write(FILE *file, int order, float unknown_cost,
+                       const GenericVector<inT32> &backoff_states,
+                       const GenericVector<float> &backoff_costs,
+                       const GenericVector<NgramTransition> &transitions) {
+  // Spread the cost levels evenly over the range of the costs.
+  float min_cost = backoff_costs.empty() ? 0.0f : backoff_costs[0];
+  float max_cost = min_cost;
+  int i;
+  for (i = 0; i < backoff_costs.size(); ++i) {
+    if (backoff_costs[i] < min_cost) min_cost = backoff_costs[i];
+    if (backoff_costs[i] > max_cost) max_cost = backoff_costs[i];
+  }
+  for (i = 0; i < transitions.size(); ++i) {
+    if (transitions[i].cost < min_cost) min_cost = transitions[i].cost;
+    if (transitions[i].cost > max_cost) max_cost = transitions[i].cost;
+  }
+  float step = (max_cost - min_cost) / (kNumCostLevels - 1);
+  float cost_table[kNumCostLevels];
+  for (i = 0; i < kNumCostLevels; ++i)
+    cost_table[i] = min_cost + step * i;
+
+  // Keep the hash table at most 3/4 full, so that lookups stay short and
+  // always find an empty slot.
+  inT32 num_slots = 2;
+  while (num_slots < transitions.size() + transitions.size() / 3 + 1)
+    num_slots *= 2;
+  Slot *slots = new Slot[num_slots];
+  for (i = 0; i < num_slots; ++i) {
+    slots[i].state = -1;
+    slots[i].unicode_and_cost = 0;
+    slots[i].next_state = 0;
+  }
+  for (i = 0; i < transitions.size(); ++i) {
+    const NgramTransition &transition = transitions[i];
+    ASSERT_HOST(transition.unicode >= 0 && transition.unicode <= kMaxUnicode);
+    Slot &slot = slots[FindSlot(slots, num_slots, transition.state,
+                                transition.unicode)];
+    slot.state = transition.state;
+    slot.unicode_and_cost = (transition.unicode << 8) |
+        QuantizeCost(transition.cost, min_cost, step);
+    slot.next_state = transition.next_state;
+  }
+
+  inT32 num_states = backoff_states.size();
+  inT32 header[4] = { kNgramModelMagicNumber, order, num_states, num_slots };
+  bool ok = fwrite(header, sizeof(inT32), 4, file) == 4 &&
+      fwrite(&unknown_cost, sizeof(float), 1, file) == 1 &&
+      fwrite(cost_table, sizeof(float), kNumCostLevels, file) ==
+          static_cast<size_t>(kNumCostLevels);
+  for (i = 0; ok && i < num_states; ++i) {
+    State state;
+    state.backoff_state = backoff_states[i];
+    state.backoff_cost = QuantizeCost(backoff_costs[i], min_cost, step);
+    ok = fwrite(&state, sizeof(state), 1, file) == 1;
+  }
+  if (ok)
+    ok = fwrite(slots, sizeof(Slot), num_slots, file) ==
+        static_cast<size_t>(num_slots);
+  delete [] slots;
+  return ok;
+}
+
+inT32 NgramModel::FindSlot(const Slot *slots, inT32 num_slots, inT32 state,
+                           inT32 unicode) {
+  uinT32 hash = static_cast<uinT32>(state) * 0x9e3779b1U ^
+      static_cast<uinT32>(unicode) * 0x85ebca6bU;
+  hash ^= hash >> 16;
+  uinT32 mask = num_slots - 1;
+  for (uinT32 index = hash & mask; ; index = (index + 1) & mask) {
+    const Slot &slot = slots[index];
+    if (slot.state == -1 ||
+        (slot.state == state &&
+         static_cast<inT32>(slot.unicode_and_cost >> 8) == unicode))
+      return index;
+  }
+}
+
+float NgramModel::Cost(int state, int unicode, int *next_state) const {
+  bool valid = unicode >= 0 && unicode <= kMaxUnicode;
+  float cost = 0.0f;
+  while (state >= 0) {
+    if (valid) {
+      const Slot &slot = slots_[FindSlot(slots_, num_slots_, state, unicode)];
+      if (slot.state != -1) {
+        *next_state = slot.next_state;
+        return cost + cost_table_[slot.unicode_and_cost & 0xff];
+      }
+    }
+    cost += cost_table_[states_[state].backoff_cost];
+    state = states_[state].backoff_state;
+  }
+  *next_state = 0;
+  return cost + unknown_cost_;
+}
+
+float NgramModel::StringCost(int state, const char *utf8,
+                             int *next_state) const {
+  float cost = 0.0f;
+  *next_state = state;
+  while (*utf8 != '\0') {
+    int step = UNICHAR::utf8_step(utf8);
+    if (step == 0)
+      break;  // Not UTF-8.
+    UNICHAR unichar(utf8, step);
+    cost += Cost(*next_state, unichar.first_uni(), next_state);
+    utf8 += step;
+  }
+  return cost;
+}
+
+}  // namespace tesseract
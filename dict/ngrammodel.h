@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////
+// File:        ngrammodel.h
+// Description: Compact character n-gram model used by the ngram permuter.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_DICT_NGRAMMODEL_H__
+#define TESSERACT_DICT_NGRAMMODEL_H__
+
+#include <stdio.h>
+
+#include "genericvector.h"
+#include "host.h"
+
+namespace tesseract {
+
+class TessdataManager;
+
+// A transition of an NgramModel, as given to NgramModel::Write: following
+// the context of state, the character unicode costs cost bits and leads to
+// the context of next_state.
+struct NgramTransition {
+  inT32 state;
+  inT32 unicode;
+  float cost;
+  inT32 next_state;
+};
+
+// NgramModel is a backoff character n-gram model stored as a finite-state
+// machine. Each state is a context of up to order - 1 characters seen in
+// the training text, and state 0 is the empty context. Each n-gram of the
+// model is a transition of its context state, which gives the cost of the
+// character and the state of the longest context that the character ends.
+// A character without a transition from a state costs the backoff cost of
+// the state plus its cost from the backoff state, which is the state of the
+// context without its first character.
+//
+// The transitions are kept in one open hash table, and all the costs are
+// quantized to one byte with a table of 256 levels, so that a transition
+// takes 12 bytes. The model is read from the traineddata file (see
+// TESSDATA_NGRAM_MODEL) and used in place if the file is memory mapped.
+//
+// The callers keep the state reached by each hypothesis, so the cost of
+// extending a hypothesis by one character takes one hash lookup, or at
+// most order lookups when it backs off.
+class NgramModel {
+ public:
+  NgramModel();
+  ~NgramModel();
+
+  // Reads the model at the current position of file. If tessdata_manager is
+  // not NULL and has the file mapped, the tables are used in place.
+  // Returns false if the data is not a valid model.
+  bool Read(FILE *file, const TessdataManager *tessdata_manager);
+  // Writes the model with the given transitions to file. The backoff
+  // state and cost of each state are given by backoff_states and
+  // backoff_costs, which must be -1 and the backoff cost of the empty
+  // context for state 0. unknown_cost is the cost, after backing off from
+  // state 0, of a character that has no transition from it.
+  // Returns false if the file could not be written.
+  static bool Write(FILE *file, int order, float unknown_cost,
+                    const GenericVector<inT32> &backoff_states,
+                    const GenericVector<float> &backoff_costs,
+                    const GenericVector<NgramTransition> &transitions);
+
+  // The length of the longest n-grams of the model.
+  int order() const { return order_; }
+  int num_states() const { return num_states_; }
+  // The state after the space that separates words, which is the context
+  // of the first character of a word.
+  int word_start_state() const { return word_start_state_; }
+
+  // Returns the cost in bits of unicode following the context of state,
+  // and sets *next_state to the context that it ends.
+  float Cost(int state, int unicode, int *next_state) const;
+  // Returns the sum of the costs of the characters of the given UTF-8
+  // string following the context of state, and sets *next_state to the
+  // context that the last one ends.
+  float StringCost(int state, const char *utf8, int *next_state) const;
+
+ private:
+  // Layout of a state on disk and in memory.
+  struct State {
+    inT32 backoff_state;
+    inT32 backoff_cost;  // index into cost_table_
+  };
+  // Layout of a transition on disk and in memory. An empty slot has a
+  // state of -1.
+  struct Slot {
+    inT32 state;
+    uinT32 unicode_and_cost;  // unicode << 8 | index into cost_table_
+    inT32 next_state;
+  };
+
+  static const int kNumCostLevels = 256;
+
+  // Returns the slot in slots of the transition of state for unicode, or
+  // of the empty slot where it would be inserted.
+  static inT32 FindSlot(const Slot *slots, inT32 num_slots, inT32 state,
+                        inT32 unicode);
+  // Returns false if a state or transition of the tables refers to a
+  // state that does not exist, or a backoff could loop.
+  bool TablesValid() const;
+  // Frees the tables that are not used in place.
+  void Clear();
+
+  inT32 order_;
+  inT32 num_states_;
+  inT32 num_slots_;  // a power of 2
+  float unknown_cost_;
+  float cost_table_[kNumCostLevels];
+  State *states_;
+  Slot *slots_;
+  bool mapped_;
+  int word_start_state_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_DICT_NGRAMMODEL_H__
@@ -24,10 +24,9 @@
 #include "tordvars.h"
 #include "stopper.h"
 #include "globals.h"
-#include "context.h"
 #include "ndminx.h"
 #include "dict.h"
-#include "conversion.h"
+#include "ngrammodel.h"
 
 #include <math.h>
 #include <ctype.h>
@@ -45,38 +44,47 @@ double_VAR(non_dawg_prefix_rating_adjustment,
            1.5,
            "");
 
+// Number of prefixes kept at each character position.
+static const int kMaxNumPrefixes = 20;
+
 // HypothesisPrefix represents a word prefix during the search of the
 // character-level n-gram model based permuter.
-// It holds the data needed to create the corresponding A_CHOICE.
-// Note that the string stored in the _word data member always begin with a
-// space character. This is used by the n-gram model to score the word.
+// It holds the data needed to create the corresponding WERD_CHOICE.
+// It also holds the state of the n-gram model reached by the prefix, so
+// that scoring the prefix extended by one more character only needs a
+// lookup from that state. The state of the model for the empty prefix is
+// the one after a space, so the first character is scored as the start
+// of a word.
 // HypothesisPrefix also contains the node in the DAWG that is reached when
 // searching for the corresponding prefix.
 class HypothesisPrefix {
  public:
-  HypothesisPrefix();
+  HypothesisPrefix(const tesseract::NgramModel& model);
   HypothesisPrefix(const HypothesisPrefix& prefix,
-                   A_CHOICE* choice,
+                   const BLOB_CHOICE& choice,
                    bool end_of_word,
                    const tesseract::Dawg *dawg,
-                   tesseract::Dict* dict);
+                   const tesseract::NgramModel& model,
+                   const UNICHARSET& unicharset);
 
   double rating() const {return rating_;}
   double certainty() const {return certainty_;}
-  const char* word() const {return word_;}
-  const char* unichar_lengths() const {return unichar_lengths_;}
+  int length() const {return length_;}
+  UNICHAR_ID unichar_id(int index) const {return unichar_ids_[index];}
   const float* certainty_array() const {return certainty_array_;}
   bool is_dawg_prefix() const {return is_dawg_prefix_;}
   NODE_REF dawg_node() const {return dawg_node_;}
+  int ngram_state() const {return ngram_state_;}
 
  private:
   double rating_;
   double certainty_;
-  char word_[UNICHAR_LEN * MAX_WERD_LENGTH + 2];
-  char unichar_lengths_[MAX_WERD_LENGTH + 1];
+  int length_;
+  UNICHAR_ID unichar_ids_[MAX_WERD_LENGTH];
   float certainty_array_[MAX_WERD_LENGTH + 1];
   NODE_REF dawg_node_;
   bool is_dawg_prefix_;
+  int ngram_state_;
 };
 
 // HypothesisPrefix is the class used as nodes in HypothesisPrefixLists
@@ -117,58 +125,64 @@ static double get_classifier_score_ngram_score_ratio(const char* choice);
 // the best current prefixes to create the list of best prefixes at the next
 // character position.
 namespace tesseract {
-A_CHOICE *Dict::ngram_permute_and_select(CHOICES_LIST char_choices,
-                                         float rating_limit,
-                                         const Dawg *dawg) {
-  if (array_count (char_choices) <= MAX_WERD_LENGTH) {
-    CHOICES choices;
-    int char_index_max = array_count(char_choices);
-    HypothesisPrefixList list_1(20);
-    HypothesisPrefixList list_2(20);
-    HypothesisPrefixList* current_list = &list_1;
-    HypothesisPrefixList* next_list = &list_2;
-    HypothesisPrefix* initial_node = new HypothesisPrefix();
-    current_list->add_node(initial_node);
-    for (int char_index = 0; char_index < char_index_max; ++char_index) {
-      iterate_list(choices, (CHOICES) array_index(char_choices, char_index)) {
-        A_CHOICE* choice = (A_CHOICE *) first_node(choices);
-        for (int node_index = 0;
-             node_index < current_list->size();
-             ++node_index) {
-          // Append this choice to the current node
-          HypothesisPrefix* new_node = new HypothesisPrefix(
-              current_list->node(node_index),
-              choice,
-              char_index == char_index_max - 1,
-              dawg, this);
-          next_list->add_node(new_node);
-        }
+WERD_CHOICE *Dict::ngram_permute_and_select(
+    const BLOB_CHOICE_LIST_VECTOR &char_choices,
+    float rating_limit,
+    const Dawg *dawg) {
+  int char_index_max = char_choices.length();
+  if (ngram_model_ == NULL || char_index_max == 0 ||
+      char_index_max > MAX_WERD_LENGTH)
+    return NULL;
+  const UNICHARSET &unicharset = getUnicharset();
+  HypothesisPrefixList list_1(kMaxNumPrefixes);
+  HypothesisPrefixList list_2(kMaxNumPrefixes);
+  HypothesisPrefixList* current_list = &list_1;
+  HypothesisPrefixList* next_list = &list_2;
+  current_list->add_node(new HypothesisPrefix(*ngram_model_));
+  for (int char_index = 0; char_index < char_index_max; ++char_index) {
+    BLOB_CHOICE_IT blob_choice_it(char_choices.get(char_index));
+    for (blob_choice_it.mark_cycle_pt(); !blob_choice_it.cycled_list();
+         blob_choice_it.forward()) {
+      const BLOB_CHOICE *choice = blob_choice_it.data();
+      // Fragments are put together by the other permuters.
+      if (unicharset.get_fragment(choice->unichar_id()) != NULL)
+        continue;
+      for (int node_index = 0;
+           node_index < current_list->size();
+           ++node_index) {
+        // Append this choice to the current node
+        HypothesisPrefix* new_node = new HypothesisPrefix(
+            current_list->node(node_index),
+            *choice,
+            char_index == char_index_max - 1,
+            dawg, *ngram_model_, unicharset);
+        next_list->add_node(new_node);
       }
-      // Clear current list and switch lists
-      current_list->clear();
-      HypothesisPrefixList* temp_list = current_list;
-      current_list = next_list;
-      next_list = temp_list;
-
-      // Give up if the current best rating is worse than rating_limit
-      if (current_list->node(0).rating() > rating_limit)
-        return new_choice (NULL, NULL, MAXFLOAT, -MAXFLOAT, -1, NO_PERM);
     }
-    const HypothesisPrefix& best_word = current_list->node(0);
-    A_CHOICE* best_choice = new_choice (best_word.word() + 1,
-                                        best_word.unichar_lengths(),
-                                        best_word.rating(),
-                                        best_word.certainty(), -1,
-                                        valid_word(best_word.word() + 1) ?
-                                        SYSTEM_DAWG_PERM : TOP_CHOICE_PERM);
-    LogNewWordChoice(best_choice, best_word.is_dawg_prefix() ?
-                     1.0 : non_dawg_prefix_rating_adjustment,
-                     const_cast<float*>(best_word.certainty_array()),
-                     getUnicharset());
-    return best_choice;
-  } else {
-    return new_choice (NULL, NULL, MAXFLOAT, -MAXFLOAT, -1, NO_PERM);
+    // Clear current list and switch lists
+    current_list->clear();
+    HypothesisPrefixList* temp_list = current_list;
+    current_list = next_list;
+    next_list = temp_list;
+
+    // Give up if the current best rating is worse than rating_limit
+    if (current_list->size() == 0 ||
+        current_list->node(0).rating() > rating_limit)
+      return NULL;
   }
+  const HypothesisPrefix& best_word = current_list->node(0);
+  WERD_CHOICE *best_choice = new WERD_CHOICE(best_word.length());
+  for (int i = 0; i < best_word.length(); ++i)
+    best_choice->append_unichar_id_space_allocated(best_word.unichar_id(i),
+                                                   1, 0.0, 0.0);
+  best_choice->set_rating(best_word.rating());
+  best_choice->set_certainty(best_word.certainty());
+  int permuter = valid_word(*best_choice);
+  best_choice->set_permuter(permuter != NO_PERM ? permuter : TOP_CHOICE_PERM);
+  LogNewChoice(*best_choice, best_word.is_dawg_prefix() ?
+               1.0 : non_dawg_prefix_rating_adjustment,
+               best_word.certainty_array(), false);
+  return best_choice;
 }
 }  // namespace tesseract
 
@@ -182,109 +196,79 @@ double get_classifier_score_ngram_score_ratio(const char* choice) {
 
 // Initial HypothesisPrefix constructor used to create the first state of the
 // search.
-HypothesisPrefix::HypothesisPrefix() {
+HypothesisPrefix::HypothesisPrefix(const tesseract::NgramModel& model) {
   rating_ = 0;
   certainty_ = MAXFLOAT;
-  strcpy(word_, " ");
-  unichar_lengths_[0] = '\0';
+  length_ = 0;
   dawg_node_ = 0;
   is_dawg_prefix_ = true;
+  ngram_state_ = model.word_start_state();
 }
 
 // Main constructor to create a new HypothesisPrefix by appending a character
-// choice (A_CHOICE) to an existing HypothesisPrefix. This constructor takes
+// choice (BLOB_CHOICE) to an existing HypothesisPrefix. This constructor takes
 // care of copying the original prefix's data members, appends the character
 // choice to the word and updates its rating using a character-level n-gram
 // model. The state in the DAWG is also updated.
 HypothesisPrefix::HypothesisPrefix(const HypothesisPrefix& prefix,
-                                   A_CHOICE* choice,
+                                   const BLOB_CHOICE& choice,
                                    bool end_of_word,
                                    const tesseract::Dawg *dawg,
-                                   tesseract::Dict* dict) {
-  char* word_ptr = word_;
-  const char* prefix_word_ptr = prefix.word_;
-
-  // Copy first space character
-  *(word_ptr++) = *(prefix_word_ptr++);
-
-  // Copy existing word, unichar_lengths, certainty_array
-  int char_index;
-  for (char_index = 0;
-       prefix.unichar_lengths_[char_index] != '\0';
-       ++char_index) {
-    for (int char_subindex = 0;
-         char_subindex < prefix.unichar_lengths_[char_index];
-         ++char_subindex) {
-      *(word_ptr++) = *(prefix_word_ptr++);
-    }
-    unichar_lengths_[char_index] = prefix.unichar_lengths_[char_index];
-    certainty_array_[char_index] = prefix.certainty_array_[char_index];
-  }
+                                   const tesseract::NgramModel& model,
+                                   const UNICHARSET& unicharset) {
+  // Copy existing unichar ids and certainty_array
+  length_ = prefix.length_;
+  memcpy(unichar_ids_, prefix.unichar_ids_, length_ * sizeof(UNICHAR_ID));
+  memcpy(certainty_array_, prefix.certainty_array_, length_ * sizeof(float));
 
   // If choice is empty, use a space character instead
-  const char* class_string_choice = *class_string(choice) == '\0' ?
-      " " : class_string(choice);
+  UNICHAR_ID unichar_id = choice.unichar_id();
+  const char* class_string_choice = unicharset.id_to_unichar(unichar_id);
+  if (*class_string_choice == '\0')
+    class_string_choice = " ";
 
   // Update certainty
-  certainty_ = MIN(prefix.certainty_, class_certainty(choice));
+  certainty_ = MIN(prefix.certainty_, choice.certainty());
 
-  // Apprend choice to the word
-  strcpy(word_ptr, class_string_choice);
-  unichar_lengths_[char_index] = strlen(class_string_choice);
-  unichar_lengths_[char_index + 1] = '\0';
-
-  // Append choice certainty to the certainty array
-  certainty_array_[char_index] = class_certainty(choice);
+  // Append choice and its certainty to the word
+  unichar_ids_[length_] = unichar_id;
+  certainty_array_[length_] = choice.certainty();
+  ++length_;
 
   // Copy DAWG node state
   dawg_node_ = prefix.dawg_node_;
   is_dawg_prefix_ = prefix.is_dawg_prefix_;
 
-  // Verify DAWG and update dawg_node_ if the current prefix is already valid
-  if (is_dawg_prefix_) {
-    for (int char_subindex = 0;
-         class_string_choice[char_subindex] != '\0';
-         ++char_subindex) {
-
-      // TODO(daria): update this code (and the rest of ngram permuter code
-      // to deal with unichar ids, make use of the new parallel dawg search
-      // and use WERD_CHOICE, BLOB_CHOICE_LIST_VECTOR instead of the deprecated
-      // A_CHOICE.
-      tprintf("Error: ngram permuter functionality is not available\n");
-      exit(1);
-
-      // Verify each byte of the appended character. Note that word_ptr points
-      // to the first byte so (word_ptr - (word_ + 1)) is the index of the first
-      // new byte in the string that starts at (word_ + 1).
-      /*
-      int current_byte_index = word_ptr - (word_ + 1) + char_subindex;
-      if (!(dict->*dict->letter_is_okay_)(
-         dawg, &dawg_node_, current_byte_index, word_ + 1,
-         end_of_word && class_string_choice[char_subindex + 1] == '\0')) {
-        dawg_node_ = NO_EDGE;
-        is_dawg_prefix_ = false;
-        break;
-      }
-      */
+  // Verify that the word is still a valid prefix in the DAWG and update
+  // dawg_node_. A prefix that reaches node 0 before the end of the word
+  // cannot be continued.
+  if (is_dawg_prefix_ && dawg != NULL) {
+    EDGE_REF edge = dawg->edge_char_of(dawg_node_, unichar_id, end_of_word);
+    if (edge != NO_EDGE)
+      dawg_node_ = dawg->next_node(edge);
+    if (edge == NO_EDGE || (!end_of_word && dawg_node_ == 0)) {
+      dawg_node_ = NO_EDGE;
+      is_dawg_prefix_ = false;
     }
   }
 
   // Copy the prefix rating
   rating_ = prefix.rating_;
 
-  // Compute rating of current character
-  double probability = probability_in_context(prefix.word_, -1,
-                                              class_string_choice, -1);
-
-  // If last character of the word, take the following space into account
-  if (end_of_word)
-    probability *= probability_in_context(word_, -1, " ", -1);
+  // Compute the cost of the current character from the n-gram state of the
+  // prefix. If last character of the word, take the following space into
+  // account.
+  double ngram_rating = model.StringCost(prefix.ngram_state_,
+                                         class_string_choice, &ngram_state_);
+  if (end_of_word) {
+    int end_state;
+    ngram_rating += model.Cost(ngram_state_, ' ', &end_state);
+  }
 
   double local_classifier_score_ngram_score_ratio =
       get_classifier_score_ngram_score_ratio(class_string_choice);
 
-  double classifier_rating = class_rating(choice);
-  double ngram_rating = -log(probability) / log(2.0);
+  double classifier_rating = choice.rating();
   double mixed_rating =
       local_classifier_score_ngram_score_ratio * classifier_rating +
       (1 - local_classifier_score_ngram_score_ratio) * ngram_rating;
@@ -55,7 +55,6 @@
 #include "image.h"
 #include "ccutil.h"
 
-int permutation_count;           // Used in metrics.cpp.
 /*----------------------------------------------------------------------
               V a r i a b l e s
 ----------------------------------------------------------------------*/
@@ -107,13 +106,11 @@ BOOL_VAR(doc_dict_enable, 1, "Enable Document Dictionary ");
 BOOL_VAR(ngram_permuter_activated, FALSE,
          "Activate character-level n-gram-based permuter");
 
-STRING_VAR(global_user_words_suffix, "", "A list of user-provided words.");
-
-// This is an ugly way to incorporate segmentation cost in word rating.
-// See comments in incorporate_segcost.
-float wordseg_rating_adjust_factor;
+BOOL_VAR(ngram_permuter_replaces_dawgs, FALSE,
+         "Take the word of the n-gram permuter instead of running the "
+         "dictionary permuters, rather than as one more candidate");
 
-int permute_only_top = 0;
+STRING_VAR(global_user_words_suffix, "", "A list of user-provided words.");
 
 #define SIM_CERTAINTY_SCALE  -10.0   /* Similarity matcher values */
 #define SIM_CERTAINTY_OFFSET -10.0   /* Similarity matcher values */
@@ -217,6 +214,7 @@ void Dict::add_document_word(const WERD_CHOICE &best_choice) {
     fclose(doc_word_file);
   }
   document_words_->add_word_to_dawg(best_choice);
+  edge_cache_.Clear();
 }
 
 
@@ -265,27 +263,34 @@ void Dict::init_permute() {
 
   if (dawgs_.length() != 0) end_permute();
 
+  permutation_count_ = 0;
   hyphen_unichar_id_ = getUnicharset().unichar_to_id(kHyphenSymbol);
   TessdataManager &tessdata_manager =
     getImage()->getCCUtil()->tessdata_manager;
 
   // Load dawgs_.
-  if (global_load_punc_dawg &&
-      tessdata_manager.SeekToStart(TESSDATA_PUNC_DAWG)) {
-    dawgs_ += new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                               DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM);
-  }
-  if (global_load_system_dawg &&
-      tessdata_manager.SeekToStart(TESSDATA_SYSTEM_DAWG)) {
-    dawgs_ += new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                               DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM);
-  }
-  if (global_load_number_dawg &&
-      tessdata_manager.SeekToStart(TESSDATA_NUMBER_DAWG)) {
-    dawgs_ +=
-      new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                       DAWG_TYPE_NUMBER, lang, NUMBER_PERM);
+  if (dawg_source_ != NULL) {
+    for (int i = 0; i < dawg_source_->num_file_dawgs_; ++i)
+      dawgs_ += dawg_source_->dawgs_[i];
+  } else {
+    if (global_load_punc_dawg &&
+        tessdata_manager.SeekToStart(TESSDATA_PUNC_DAWG)) {
+      dawgs_ += new SquishedDawg(tessdata_manager,
+                                 DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM);
+    }
+    if (global_load_system_dawg &&
+        tessdata_manager.SeekToStart(TESSDATA_SYSTEM_DAWG)) {
+      dawgs_ += new SquishedDawg(tessdata_manager,
+                                 DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM);
+    }
+    if (global_load_number_dawg &&
+        tessdata_manager.SeekToStart(TESSDATA_NUMBER_DAWG)) {
+      dawgs_ +=
+        new SquishedDawg(tessdata_manager,
+                         DAWG_TYPE_NUMBER, lang, NUMBER_PERM);
+    }
   }
+  num_file_dawgs_ = dawgs_.length();
   if (((STRING &)global_user_words_suffix).length() > 0) {
     Trie *trie_ptr = new Trie(DAWG_TYPE_WORD, lang, USER_DAWG_PERM,
                               MAX_USER_EDGES, getUnicharset().size());
@@ -307,14 +312,39 @@ void Dict::init_permute() {
 
   // The frequent words dawg is only searched when a word
   // is found in any of the other dawgs.
-  if (tessdata_manager.SeekToStart(TESSDATA_FREQ_DAWG)) {
-    freq_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
+  if (dawg_source_ != NULL) {
+    freq_dawg_ = dawg_source_->freq_dawg_;
+  } else if (tessdata_manager.SeekToStart(TESSDATA_FREQ_DAWG)) {
+    freq_dawg_ = new SquishedDawg(tessdata_manager,
                                   DAWG_TYPE_WORD, lang, FREQ_DAWG_PERM);
   }
 
+  // The n-gram model is only needed by the ngram permuter.
+  if (dawg_source_ != NULL) {
+    ngram_model_ = dawg_source_->ngram_model_;
+  } else if (ngram_permuter_activated &&
+             tessdata_manager.SeekToStart(TESSDATA_NGRAM_MODEL)) {
+    ngram_model_ = new NgramModel;
+    if (!ngram_model_->Read(tessdata_manager.GetDataFilePtr(),
+                            &tessdata_manager)) {
+      tprintf("Error: failed to read the ngram model\n");
+      delete ngram_model_;
+      ngram_model_ = NULL;
+    }
+  }
+  if (ngram_permuter_activated && ngram_model_ == NULL)
+    tprintf("Warning: no ngram model for %s, ngram permuter disabled\n",
+            lang.string());
+
+  init_successors();
+}
+
+void Dict::init_successors() {
   // Construct a list of corresponding successors for each dawg. Each entry i
   // in the successors_ vector is a vector of integers that represent the
   // indices into the dawgs_ vector of the successors for dawg i.
+  successors_.delete_data_pointers();
+  successors_.truncate(0);
   successors_.reserve(dawgs_.length());
   for (int i = 0; i < dawgs_.length(); ++i) {
     const Dawg *dawg = dawgs_[i];
@@ -331,15 +361,120 @@ void Dict::init_permute() {
 void Dict::end_permute() {
   if (dawgs_.length() == 0)
     return;  // Not safe to call twice.
-  dawgs_.delete_data_pointers();
+  // The dawgs of the user dictionaries belong to the dictionaries.
+  dawgs_.truncate(dawgs_.length() - user_dictionaries_.size());
+  for (int i = 0; i < user_dictionaries_.size(); ++i)
+    user_dictionaries_[i]->Release();
+  user_dictionaries_.truncate(0);
+  if (dawg_source_ != NULL) {
+    // Only the dawgs after the borrowed ones belong to this Dict.
+    for (int i = num_file_dawgs_; i < dawgs_.length(); ++i)
+      delete dawgs_[i];
+    freq_dawg_ = NULL;
+  } else {
+    dawgs_.delete_data_pointers();
+  }
   successors_.delete_data_pointers();
   dawgs_.clear();
   successors_.clear();
+  edge_cache_.Clear();
+  num_file_dawgs_ = 0;
   document_words_ = NULL;
   if (pending_words_ != NULL) delete pending_words_;
   pending_words_ = NULL;
   if (freq_dawg_ != NULL) delete freq_dawg_;
   freq_dawg_ = NULL;
+  if (dawg_source_ == NULL) delete ngram_model_;
+  ngram_model_ = NULL;
+}
+
+void Dict::ShareDawgsFrom(const Dict *source) {
+  dawg_source_ = source;
+}
+
+bool Dict::user_dictionary_fits(const UserDictionary *user_dict) {
+  if (user_dict == NULL || dawgs_.length() == 0)
+    return false;
+  const STRING &lang = getImage()->getCCUtil()->lang;
+  return user_dict->FitsUnicharset(getUnicharset()) &&
+      user_dict->dawg()->lang() == lang;
+}
+
+bool Dict::AddUserDictionary(UserDictionary *user_dict) {
+  if (!user_dictionary_fits(user_dict))
+    return false;
+  for (int i = 0; i < user_dictionaries_.size(); ++i) {
+    if (user_dictionaries_[i] == user_dict)
+      return false;
+  }
+  user_dict->AddRef();
+  user_dictionaries_.push_back(user_dict);
+  dawgs_ += user_dict->dawg();
+  dawgs_changed();
+  return true;
+}
+
+bool Dict::RemoveUserDictionary(UserDictionary *user_dict) {
+  int first = dawgs_.length() - user_dictionaries_.size();
+  for (int i = 0; i < user_dictionaries_.size(); ++i) {
+    if (user_dictionaries_[i] == user_dict) {
+      user_dictionaries_.remove(i);
+      dawgs_.remove(first + i);
+      dawgs_changed();
+      user_dict->Release();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Dict::ReplaceUserDictionary(UserDictionary *old_dict,
+                                 UserDictionary *new_dict) {
+  if (old_dict == new_dict || !user_dictionary_fits(new_dict))
+    return false;
+  int first = dawgs_.length() - user_dictionaries_.size();
+  int index = -1;
+  for (int i = 0; i < user_dictionaries_.size(); ++i) {
+    if (user_dictionaries_[i] == new_dict)
+      return false;
+    if (user_dictionaries_[i] == old_dict)
+      index = i;
+  }
+  if (index < 0)
+    return false;
+  new_dict->AddRef();
+  user_dictionaries_[index] = new_dict;
+  dawgs_[first + index] = new_dict->dawg();
+  dawgs_changed();
+  old_dict->Release();
+  return true;
+}
+
+void Dict::CopyWordListsFrom(const Dict &source) {
+  if (document_words_ != NULL && source.document_words_ != NULL)
+    document_words_->copy_from(*source.document_words_);
+  // The user dictionaries go after the other dawgs in the order of source.
+  bool same = user_dictionaries_.size() == source.user_dictionaries_.size();
+  for (int i = 0; same && i < user_dictionaries_.size(); ++i)
+    same = user_dictionaries_[i] == source.user_dictionaries_[i];
+  if (!same) {
+    while (!user_dictionaries_.empty())
+      RemoveUserDictionary(user_dictionaries_[0]);
+    for (int i = 0; i < source.user_dictionaries_.size(); ++i)
+      AddUserDictionary(source.user_dictionaries_[i]);
+  }
+  edge_cache_.Clear();
+}
+
+void Dict::dawgs_changed() {
+  init_successors();
+  edge_cache_.Clear();
+  if (hyphen_word_ != NULL) {
+    delete hyphen_word_;
+    hyphen_word_ = NULL;
+    hyphen_active_dawgs_.clear();
+    hyphen_constraints_.clear();
+  }
 }
 
 
@@ -385,20 +520,33 @@ WERD_CHOICE *Dict::permute_all(const BLOB_CHOICE_LIST_VECTOR &char_choices,
     result1 = get_best_delete_other(result1, result2);
   }
 
-  // TODO(daria): update ngram permuter code.
-  if (ngram_permuter_activated) {
-    tprintf("Error: ngram permuter functionality is not available\n");
-    exit(1);
-    // A_CHOICE *ngram_choice =
-    //  ngram_permute_and_select(old_char_choices, rating_limit, word_dawg_);
-    // return ngram_choice;
-  }
-
   if (result1 == NULL)
     return (NULL);
-  if (permute_only_top)
+  if (permute_only_top_ || top_choice_only_)
     return result1;
 
+  // The ngram permuter rates its word by mixing the classifier ratings with
+  // the costs of the n-gram model (see permngram.cpp). Its word is one more
+  // candidate for the dictionary permuters to beat, unless
+  // ngram_permuter_replaces_dawgs is set, in which case it is taken instead
+  // of theirs. Where it finds no word (too long, all fragments or over the
+  // rating limit) the choices so far are kept.
+  if (ngram_permuter_activated && ngram_model_ != NULL) {
+    const Dawg *word_dawg = NULL;
+    for (int i = 0; i < dawgs_.length() && word_dawg == NULL; ++i) {
+      if (dawgs_[i]->permuter() == SYSTEM_DAWG_PERM)
+        word_dawg = dawgs_[i];
+    }
+    result2 = ngram_permute_and_select(char_choices, rating_limit, word_dawg);
+    if (ngram_permuter_replaces_dawgs) {
+      if (result2 == NULL)
+        return result1;
+      delete result1;
+      return result2;
+    }
+    result1 = get_best_delete_other(result1, result2);
+  }
+
   result2 = dawg_permute_and_select(char_choices, rating_limit);
   result1 = get_best_delete_other(result1, result2);
 
@@ -532,14 +680,14 @@ BLOB_CHOICE* find_choice_by_script(
  * outside the permuter in evalaute_state.
  **********************************************************************/
 void Dict::incorporate_segcost(WERD_CHOICE *word) {
-  if (!word || wordseg_rating_adjust_factor <= 0) return;
+  if (!word || wordseg_rating_adjust_factor_ <= 0) return;
 
   float old_rating = word->rating();
-  float new_rating = old_rating * wordseg_rating_adjust_factor;
+  float new_rating = old_rating * wordseg_rating_adjust_factor_;
   word->set_rating(new_rating);
   if (permute_debug)
     tprintf("Permute segadjust %f * %f --> %f\n",
-            old_rating, wordseg_rating_adjust_factor, new_rating);
+            old_rating, wordseg_rating_adjust_factor_, new_rating);
 }
 
 /**********************************************************************
@@ -636,8 +784,9 @@ void Dict::permute_characters(const BLOB_CHOICE_LIST_VECTOR &char_choices,
                               float limit,
                               WERD_CHOICE *best_choice,
                               WERD_CHOICE *raw_choice) {
+  AllocSubsystemScope alloc_scope(AS_DICT);
   float old_raw_choice_rating = raw_choice->rating();
-  permutation_count++;           /* Global counter */
+  permutation_count_++;
   if (tord_display_ratings > 1) {
     cprintf("\nchar_choices in permute_characters:\n");
     print_char_choices_list("\n==> Input CharChoices", char_choices,
@@ -986,9 +1135,6 @@ WERD_CHOICE *Dict::permute_top_choice(
     LogNewChoice(*raw_choice, 1.0, certainties, true);
   }
 
-  if (ngram_permuter_activated)
-    return NULL;
-
   float rating = word.rating();
   adjust_non_word(&word, &adjust_factor);
   LogNewChoice(word, adjust_factor, certainties, false);
@@ -66,9 +66,6 @@ extern double_VAR_H(segment_penalty_dict_nonword, 1.25,
                     "Score multiplier for glyph fragment segmentations which "
                     "do not match a dictionary word (lower is better).");
 
-extern int permute_only_top;
-extern float wordseg_rating_adjust_factor;
-
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
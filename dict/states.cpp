@@ -26,6 +26,9 @@
               I n c l u d e s
 ----------------------------------------------------------------------*/
 #include "states.h"
+
+#include <string.h>
+
 #include "structures.h"
 #include "tordvars.h"
 #include "callcpp.h"
@@ -37,6 +40,115 @@
 makestructure (newstate, free_state, printstate, STATE,
 freestate, STATEBLOCK, "STATE", statecount);
 
+
+/*----------------------------------------------------------------------
+              M e t h o d s
+----------------------------------------------------------------------*/
+/**********************************************************************
+ * STATE::operator=
+ *
+ * Copy another state. The extra words are only kept if the other state
+ * has them, so that short states stay on the fast path.
+ **********************************************************************/
+STATE &STATE::operator=(const STATE &other) {
+  if (this == &other)
+    return *this;
+  part1 = other.part1;
+  part2 = other.part2;
+  if (num_more != other.num_more) {
+    delete [] more;
+    num_more = other.num_more;
+    more = num_more > 0 ? new uinT32[num_more] : NULL;
+  }
+  if (num_more > 0)
+    memcpy(more, other.more, num_more * sizeof(*more));
+  return *this;
+}
+
+
+/**********************************************************************
+ * STATE::set_bit
+ *
+ * Set or clear bit x, making room for it if needed.
+ **********************************************************************/
+void STATE::set_bit(int x, bool value) {
+  uinT32 *word;
+  if (x < 32) {
+    word = &part2;
+  }
+  else if (x < 64) {
+    word = &part1;
+    x -= 32;
+  }
+  else {
+    x -= 64;
+    int index = x / 32;
+    if (index >= num_more) {
+      if (!value)
+        return;
+      uinT32 *new_more = new uinT32[index + 1];
+      memset(new_more, 0, (index + 1) * sizeof(*new_more));
+      if (num_more > 0)
+        memcpy(new_more, more, num_more * sizeof(*more));
+      delete [] more;
+      more = new_more;
+      num_more = index + 1;
+    }
+    word = &more[index];
+    x %= 32;
+  }
+  if (value)
+    *word |= 1u << x;
+  else
+    *word &= ~(1u << x);
+}
+
+
+/**********************************************************************
+ * STATE::clear
+ *
+ * Clear all the bits.
+ **********************************************************************/
+void STATE::clear() {
+  part1 = 0;
+  part2 = 0;
+  delete [] more;
+  more = NULL;
+  num_more = 0;
+}
+
+
+/**********************************************************************
+ * STATE::more_equal
+ *
+ * Compare the extra words of two states, a missing word being zero.
+ **********************************************************************/
+bool STATE::more_equal(const STATE &other) const {
+  int length = num_more > other.num_more ? num_more : other.num_more;
+  for (int i = 0; i < length; ++i) {
+    uinT32 word = i < num_more ? more[i] : 0;
+    uinT32 other_word = i < other.num_more ? other.more[i] : 0;
+    if (word != other_word)
+      return false;
+  }
+  return true;
+}
+
+
+/**********************************************************************
+ * STATE::more_hash
+ *
+ * Hash the extra words so that zero words, as left by clearing high
+ * bits, do not change the hash.
+ **********************************************************************/
+uinT32 STATE::more_hash() const {
+  uinT32 result = 0;
+  for (int i = 0; i < num_more; ++i)
+    result ^= more[i] * (0x85ebca6bu + 2 * i);
+  return result;
+}
+
+
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
@@ -49,7 +161,6 @@ freestate, STATEBLOCK, "STATE", statecount);
  **********************************************************************/
 SEARCH_STATE bin_to_chunks(STATE *state, int num_joints) {
   int x;
-  unsigned int mask;
   int depth;
   int pieces = 0;
   SEARCH_STATE s;
@@ -57,32 +168,14 @@ SEARCH_STATE bin_to_chunks(STATE *state, int num_joints) {
   s = memalloc (sizeof (int) * (ones_in_state (state, num_joints) + 1));
 
   depth = 1;
-  mask = 1 << (num_joints - 1 - 32);
-  for (x = num_joints; x > 32; x--) {
-    if (state->part1 & mask) {
-      s[depth++] = pieces;
-      pieces = 0;
-    }
-    else {
-      pieces++;
-    }
-    mask >>= 1;
-  }
-
-  if (num_joints > 32)
-    mask = 1 << 31;
-  else
-    mask = 1 << (num_joints - 1);
-
-  while (x--) {
-    if (state->part2 & mask) {
+  for (x = num_joints - 1; x >= 0; x--) {
+    if (state->bit(x)) {
       s[depth++] = pieces;
       pieces = 0;
     }
     else {
       pieces++;
     }
-    mask >>= 1;
   }
   s[0] = depth - 1;
 
@@ -99,34 +192,25 @@ SEARCH_STATE bin_to_chunks(STATE *state, int num_joints) {
  **********************************************************************/
 void bin_to_pieces(STATE *state, int num_joints, PIECES_STATE pieces) {
   int x;
-  unsigned int mask;             /* Bit mask */
   inT16 num_pieces = 0;
-  /* Preset mask */
   if (tord_debug_8)
     print_state ("bin_to_pieces = ", state, num_joints);
 
-  mask = ((num_joints > 32) ?
-    (1 << (num_joints - 1 - 32)) : (1 << (num_joints - 1)));
-
+  ASSERT_HOST (num_joints < MAX_NUM_CHUNKS);
   pieces[num_pieces] = 0;
 
   for (x = num_joints - 1; x >= 0; x--) {
                                  /* Iterate all bits */
     pieces[num_pieces]++;
 
-    if ((x < 32) ?               /* Test for 1 bit */
-      ((state->part2 & mask) ? TRUE : FALSE) :
-    ((state->part1 & mask) ? TRUE : FALSE)) {
+    if (state->bit(x)) {
       pieces[++num_pieces] = 0;
       if (tord_debug_8)
         cprintf ("[%d]=%d ", num_pieces - 1, pieces[num_pieces - 1]);
     }
-    /* Next mask value */
-    mask = ((mask == 1) ? (1 << 31) : (mask >> 1));
   }
   pieces[num_pieces]++;
   pieces[++num_pieces] = 0;
-  ASSERT_HOST (num_pieces < MAX_NUM_CHUNKS + 2);
   if (tord_debug_8)
     new_line();
 }
@@ -145,7 +229,13 @@ void insert_new_chunk(register STATE *state,
   register unsigned int result;
 
   index = (num_joints - index);
-  if (index < 32) {
+  if (num_joints >= 64 || state->more != NULL) {
+    /* The state grows beyond the two words: move the bits one by one */
+    for (int x = num_joints; x > index; x--)
+      state->set_bit(x, state->bit(x - 1));
+    state->set_bit(index, false);
+  }
+  else if (index < 32) {
     mask = ~0;
     mask <<= index;
     result = (mask & state->part2) << 1;
@@ -175,8 +265,7 @@ STATE *new_state(STATE *oldstate) {
   STATE *this_state;
 
   this_state = newstate ();
-  this_state->part1 = oldstate->part1;
-  this_state->part2 = oldstate->part2;
+  *this_state = *oldstate;
   return (this_state);
 }
 
@@ -187,27 +276,13 @@ STATE *new_state(STATE *oldstate) {
  * Return the number of ones that are in this state.
  **********************************************************************/
 int ones_in_state(STATE *state, int num_joints) {
-  inT8 num_ones = 0;
-  inT8 x;
-  unsigned int mask;
-
-  if (num_joints > 32)           /* Preset mask */
-    mask = 1 << (num_joints - 1 - 32);
-  else
-    mask = 1 << (num_joints - 1);
+  int num_ones = 0;
+  int x;
 
   for (x = num_joints - 1; x >= 0; x--) {
                                  /* Iterate all bits */
-
-    if (x < 32)
-      num_ones += ((state->part2 & mask) ? 1 : 0);
-    else
-      num_ones += ((state->part1 & mask) ? 1 : 0);
-
-    if (mask == 1)               /* Next mask value */
-      mask = 1 << 31;
-    else
-      mask >>= 1;
+    if (state->bit(x))
+      num_ones++;
   }
 
   return (num_ones);
@@ -221,29 +296,14 @@ int ones_in_state(STATE *state, int num_joints) {
  **********************************************************************/
 void print_state(const char *label, STATE *state, int num_joints) {
   int x;
-  unsigned int mask;             /* Bit mask */
-
-  if (num_joints > 32)           /* Preset mask */
-    mask = 1 << (num_joints - 1 - 32);
-  else
-    mask = 1 << (num_joints - 1);
 
   cprintf ("%s ", label);
 
   for (x = num_joints - 1; x >= 0; x--) {
                                  /* Iterate all bits */
-
-    if (x < 32)
-      cprintf ("%d", ((state->part2 & mask) ? 1 : 0));
-    else
-      cprintf ("%d", ((state->part1 & mask) ? 1 : 0));
+    cprintf ("%d", state->bit(x) ? 1 : 0);
     if (x % 4 == 0)
       cprintf (" ");
-
-    if (mask == 1)               /* Next mask value */
-      mask = 1 << 31;
-    else
-      mask >>= 1;
   }
 
   new_line();
@@ -256,15 +316,24 @@ void print_state(const char *label, STATE *state, int num_joints) {
  * Set the first n bits in a state.
  **********************************************************************/
 void set_n_ones(STATE *state, int n) {
+  state->clear();
+  if (n <= 0)
+    return;
   if (n < 32) {
     state->part2 = ~0;
     state->part2 >>= 32 - n;
-    state->part1 = 0;
+  }
+  else if (n <= 64) {
+    state->part2 = ~0;
+    state->part1 = n == 32 ? 0 : ~0;
+    if (n > 32)
+      state->part1 >>= 64 - n;
   }
   else {
     state->part2 = ~0;
     state->part1 = ~0;
-    state->part1 >>= 64 - n;
+    for (int x = 64; x < n; x++)
+      state->set_bit(x, true);
   }
 }
 
@@ -281,37 +350,20 @@ void set_n_ones(STATE *state, int n) {
 int compare_states(STATE *true_state, STATE *this_state, int *blob_index) {
   int blob_count;                //number found
   int true_index;                //index of true blob
-  int index;                     //current
+  int x;                         //current bit
   int result = 0;                //return value
-  uinT32 mask;
 
-  if (true_state->part1 == this_state->part1
-    && true_state->part2 == this_state->part2)
+  if (*true_state == *this_state)
     return 2;
   if (*blob_index == 0) {
-    if (bits_in_states > 32) {
-      for (mask = 1 << (bits_in_states - 33); mask != 0; mask >>= 1) {
-        if (this_state->part1 & mask) {
-          if (true_state->part1 & mask)
-            return 2;
-          else
-            return 1;
-        }
-        else if (true_state->part1 & mask)
-          return 4;
-      }
-      index = 31;
-    }
-    else
-      index = bits_in_states - 1;
-    for (mask = 1 << index; mask != 0; mask >>= 1) {
-      if (this_state->part2 & mask) {
-        if (true_state->part2 & mask)
+    for (x = bits_in_states - 1; x >= 0; x--) {
+      if (this_state->bit(x)) {
+        if (true_state->bit(x))
           return 2;
         else
           return 1;
       }
-      else if (true_state->part2 & mask)
+      else if (true_state->bit(x))
         return 4;
     }
     return 2;
@@ -319,62 +371,29 @@ int compare_states(STATE *true_state, STATE *this_state, int *blob_index) {
   else {
     blob_count = 0;
     true_index = 0;
-    if (bits_in_states > 32) {
-      for (mask = 1 << (bits_in_states - 33); mask != 0; mask >>= 1) {
-        if (true_state->part1 & mask)
-          true_index++;
-        if (this_state->part1 & mask) {
-          blob_count++;
-          if (blob_count == *blob_index) {
-            if ((true_state->part1 & mask) == 0)
-              result = 1;
-            break;
-          }
-        }
-      }
-      if (blob_count == *blob_index) {
-        for (mask >>= 1; mask != 0; mask >>= 1) {
-          if (this_state->part1 & mask) {
-            if ((true_state->part1 & mask) && result == 0)
-              return 2;
-            else
-              return result | 1;
-          }
-          else if (true_state->part1 & mask)
-            result |= 4;
-        }
-      }
-      index = 31;
-    }
-    else
-      index = bits_in_states - 1;
-    mask = 1 << index;
-    if (blob_count < *blob_index) {
-      for (; mask != 0; mask >>= 1) {
-        if (true_state->part2 & mask)
-          true_index++;
-        if (this_state->part2 & mask) {
-          blob_count++;
-          if (blob_count == *blob_index) {
-            if ((true_state->part2 & mask) == 0)
-              result = 1;
-            break;
-          }
+    for (x = bits_in_states - 1; x >= 0; x--) {
+      if (true_state->bit(x))
+        true_index++;
+      if (this_state->bit(x)) {
+        blob_count++;
+        if (blob_count == *blob_index) {
+          if (!true_state->bit(x))
+            result = 1;
+          break;
         }
       }
-      if (blob_count != *blob_index)
-        return 2;
-      mask >>= 1;
     }
+    if (blob_count != *blob_index)
+      return 2;
     *blob_index = true_index;
-    for (; mask != 0; mask >>= 1) {
-      if (this_state->part2 & mask) {
-        if ((true_state->part2 & mask) && result == 0)
+    for (x--; x >= 0; x--) {
+      if (this_state->bit(x)) {
+        if (true_state->bit(x) && result == 0)
           return 2;
         else
           return result | 1;
       }
-      else if (true_state->part2 & mask)
+      else if (true_state->bit(x))
         result |= 4;
     }
     return result == 0 ? 2 : result;
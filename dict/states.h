@@ -33,18 +33,74 @@
 /*----------------------------------------------------------------------
               T y p e s
 ----------------------------------------------------------------------*/
-#define MAX_NUM_CHUNKS  64       /* Limit on pieces */
+#define MAX_NUM_CHUNKS  512      /* Limit on pieces */
+
+/**********************************************************************
+ * STATE
+ *
+ * A segmentation state has one bit for each joint between the chunks
+ * of a word, set where the word is split into characters. Bit x is the
+ * joint num_joints - 1 - x, so the first joint is the highest bit.
+ * Bits 0-31 are kept in part2 and bits 32-63 in part1. Longer words
+ * keep the rest in more, 32 bits to a word, which stays NULL for the
+ * states of up to 64 joints so that they copy, compare and hash as
+ * cheaply as the two words alone.
+ **********************************************************************/
+struct STATE {
+  STATE() : part1(0), part2(0), more(NULL), num_more(0) {}
+  STATE(const STATE &other) : more(NULL), num_more(0) {
+    *this = other;
+  }
+  ~STATE() {
+    delete [] more;
+  }
+  STATE &operator=(const STATE &other);
+
+  bool operator==(const STATE &other) const {
+    return part1 == other.part1 && part2 == other.part2 &&
+      ((more == NULL && other.more == NULL) || more_equal(other));
+  }
+  bool operator!=(const STATE &other) const {
+    return !(*this == other);
+  }
+  uinT32 hash() const {
+    uinT32 result = part2 ^ (part1 * 2654435761u);
+    return more == NULL ? result : result ^ more_hash();
+  }
+
+  bool bit(int x) const {
+    if (x < 32)
+      return (part2 >> x) & 1;
+    if (x < 64)
+      return (part1 >> (x - 32)) & 1;
+    x -= 64;
+    return x / 32 < num_more && (more[x / 32] >> (x % 32)) & 1;
+  }
+  void set_bit(int x, bool value);
+  void toggle_bit(int x) {
+    if (x < 32)
+      part2 ^= 1u << x;
+    else if (x < 64)
+      part1 ^= 1u << (x - 32);
+    else
+      set_bit(x, !bit(x));
+  }
+  void clear();
 
-typedef struct
-{
   uinT32 part1;
   uinT32 part2;
-} STATE;
+  uinT32 *more;                  /* Bits 64 and up, or NULL */
+  int num_more;                  /* Words in more */
+
+ private:
+  bool more_equal(const STATE &other) const;
+  uinT32 more_hash() const;
+};
 
 typedef int *SEARCH_STATE;       /* State variable for search */
 
                                  /* State variable for search */
-typedef uinT8 PIECES_STATE[MAX_NUM_CHUNKS + 2];
+typedef uinT16 PIECES_STATE[MAX_NUM_CHUNKS + 2];
 
 /*----------------------------------------------------------------------
               F u n c t i o n s
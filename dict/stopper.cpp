@@ -525,6 +525,8 @@ void Dict::InitChoiceAccum() {
   raw_choices_ = NIL;
 
   EnableChoiceAccum();
+  // The dawg edges looked up for the last word are unlikely to be useful.
+  edge_cache_.Clear();
 
   for (BlobWidth = current_segmentation_,
     End = current_segmentation_ + MAX_NUM_CHUNKS;
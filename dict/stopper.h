@@ -26,7 +26,7 @@
 #include "unichar.h"
 #include "varable.h"
 
-typedef uinT8 BLOB_WIDTH;
+typedef uinT16 BLOB_WIDTH;
 
 typedef struct
 {
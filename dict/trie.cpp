@@ -199,11 +199,24 @@ void Trie::add_word_to_dawg(const WERD_CHOICE &word) {
   if (add_failed) {
     tprintf("Re-initializing document dictionary...\n");
     nodes_.delete_data_pointers();
+    nodes_.truncate(0);
     num_edges_ = 0;
     new_dawg_node();  // need to allocate node 0
   }
   }
 
+void Trie::copy_from(const Trie &other) {
+  nodes_.delete_data_pointers();
+  nodes_.truncate(0);
+  for (int i = 0; i < other.nodes_.size(); ++i) {
+    TRIE_NODE_RECORD *node = new TRIE_NODE_RECORD();
+    node->forward_edges += other.nodes_[i]->forward_edges;
+    node->backward_edges += other.nodes_[i]->backward_edges;
+    nodes_.push_back(node);
+  }
+  num_edges_ = other.num_edges_;
+}
+
 NODE_REF Trie::new_dawg_node() {
   TRIE_NODE_RECORD *node = new TRIE_NODE_RECORD();
   if (node == NULL) return 0;  // failed to create new node
@@ -34,7 +34,8 @@ class UNICHARSET;
 // max int32, we will need to change GenericVector to use int64 for size
 // and address indices. This does not seem to be needed immediately,
 // since currently the largest number of edges limit used by tesseract
-// (kMaxNumEdges in wordlist2dawg.cpp) is far less than max int32.
+// (MAX_USER_EDGES and MAX_DOC_EDGES in permute.cpp) is far less than max
+// int32.
 typedef inT64 EDGE_INDEX;  // index of an edge in a given node
 typedef bool *NODE_MARKER;
 typedef GenericVector<EDGE_RECORD> EDGE_VECTOR;
@@ -126,6 +127,10 @@ class Trie : public Dawg {
   // Adds a word to the Trie (creates the necessary nodes and edges).
   void add_word_to_dawg(const WERD_CHOICE &word);
 
+  // Replaces the contents of this Trie with a copy of those of other,
+  // which must have been created with the same arguments.
+  void copy_from(const Trie &other);
+
  protected:
   // The structure of an EDGE_REF for Trie edges is as follows:
   // [LETTER_START_BIT, flag_start_bit_):
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////
+// File:        userdict.cpp
+// Description: User dictionary built at runtime and shared by instances.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "userdict.h"
+
+#include "dawgbuilder.h"
+#include "ratngs.h"
+#include "unicharset.h"
+
+namespace tesseract {
+
+// Appends the unichars of unicharset to unichars in the order of their ids,
+// each followed by a newline.
+static void AppendUnichars(const UNICHARSET& unicharset, STRING* unichars) {
+  for (int i = 0; i < unicharset.size(); ++i) {
+    *unichars += unicharset.id_to_unichar(i);
+    *unichars += '\n';
+  }
+}
+
+UserDictionary* UserDictionary::ReadWordList(const char* filename,
+                                             const UNICHARSET& unicharset,
+                                             const STRING& lang) {
+  DawgBuilder* dawg = new DawgBuilder(DAWG_TYPE_WORD, lang, USER_DAWG_PERM,
+                                      unicharset.size());
+  if (!dawg->read_word_list(filename, unicharset, 1)) {
+    delete dawg;
+    return NULL;
+  }
+  dawg->finish();
+  return new UserDictionary(dawg, unicharset);
+}
+
+UserDictionary* UserDictionary::FromWords(const char* const* words,
+                                          int num_words,
+                                          const UNICHARSET& unicharset,
+                                          const STRING& lang) {
+  DawgBuilder* dawg = new DawgBuilder(DAWG_TYPE_WORD, lang, USER_DAWG_PERM,
+                                      unicharset.size());
+  dawg->add_words(words, num_words, unicharset, 1);
+  dawg->finish();
+  return new UserDictionary(dawg, unicharset);
+}
+
+UserDictionary::UserDictionary(DawgBuilder* dawg,
+                               const UNICHARSET& unicharset)
+  : dawg_(dawg), ref_count_(1) {
+  AppendUnichars(unicharset, &unichars_);
+}
+
+UserDictionary::~UserDictionary() {
+  delete dawg_;
+}
+
+void UserDictionary::AddRef() {
+  ref_mutex_.Lock();
+  ++ref_count_;
+  ref_mutex_.Unlock();
+}
+
+void UserDictionary::Release() {
+  ref_mutex_.Lock();
+  bool last = --ref_count_ == 0;
+  ref_mutex_.Unlock();
+  if (last)
+    delete this;
+}
+
+Dawg* UserDictionary::dawg() const {
+  return dawg_;
+}
+
+bool UserDictionary::FitsUnicharset(const UNICHARSET& unicharset) const {
+  STRING unichars;
+  AppendUnichars(unicharset, &unichars);
+  return unichars == unichars_;
+}
+
+}  // namespace tesseract
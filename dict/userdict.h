@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////
+// File:        userdict.h
+// Description: User dictionary built at runtime and shared by instances.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_DICT_USERDICT_H__
+#define TESSERACT_DICT_USERDICT_H__
+
+#include "ccutil.h"
+#include "strngs.h"
+
+class UNICHARSET;
+
+namespace tesseract {
+
+class Dawg;
+class DawgBuilder;
+
+// UserDictionary is a list of words compiled at runtime into a minimal
+// dawg, which any number of Dicts that use the same unicharset and
+// language can search alongside their other dawgs (see
+// Dict::AddUserDictionary). The dawg is never changed once built, so the
+// Dicts share it without locking; to change the words, build a new
+// dictionary and swap it in with Dict::ReplaceUserDictionary.
+//
+// The dictionary is reference counted like LanguageModel. The build
+// functions return a dictionary with one reference held by the caller,
+// and each Dict that uses it holds one more.
+class UserDictionary {
+ public:
+  // Builds the dictionary of the words in the given file, one per line,
+  // of which those with unichars that are not in unicharset are skipped.
+  // Returns NULL if the file cannot be read.
+  static UserDictionary* ReadWordList(const char* filename,
+                                      const UNICHARSET& unicharset,
+                                      const STRING& lang);
+  // Builds the dictionary of the given num_words UTF-8 words.
+  static UserDictionary* FromWords(const char* const* words, int num_words,
+                                   const UNICHARSET& unicharset,
+                                   const STRING& lang);
+
+  void AddRef();
+  void Release();
+
+  // The dawg of the words, owned by the dictionary.
+  Dawg* dawg() const;
+  // Returns true if unicharset has the same unichars, with the same ids, as
+  // the unicharset that the dictionary was built with, so that the unichar
+  // ids of the dawg mean the same in both.
+  bool FitsUnicharset(const UNICHARSET& unicharset) const;
+
+ private:
+  UserDictionary(DawgBuilder* dawg, const UNICHARSET& unicharset);
+  ~UserDictionary();
+
+  DawgBuilder* dawg_;
+  // The unichars of the unicharset of the dictionary in the order of their
+  // ids, each followed by a newline, which no unichar contains.
+  STRING unichars_;
+  int ref_count_;
+  CCUtilMutex ref_mutex_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_DICT_USERDICT_H__
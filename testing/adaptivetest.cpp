@@ -0,0 +1,266 @@
+///////////////////////////////////////////////////////////////////////
+// File:        adaptivetest.cpp
+// Description: Round trip of adapted templates through an adaptive
+//              classifier snapshot.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Adapts a few classes of a classifier by hand, the way InitAdaptedClass
+// and MakePermanent do: one with a temporary config, one with a permanent
+// and a temporary config, and one with two permanent configs. Writes them
+// with WriteAdaptedSnapshot and reads them back with ReadAdaptedSnapshot.
+// Checks that the templates read back are the same as the originals and
+// give the same snapshot, and that truncated snapshots and snapshots of a
+// classifier with another unicharset are rejected.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "adaptive.h"
+#include "bitvec.h"
+#include "classify.h"
+#include "emalloc.h"
+#include "intproto.h"
+#include "oldlist.h"
+#include "protos.h"
+
+namespace tesseract {
+
+static const char *kUnichars[] = { "a", "b", "c", "d", "e" };
+static const int kNumUnichars = sizeof(kUnichars) / sizeof(kUnichars[0]);
+
+// Returns the next number of a fixed pseudo-random sequence.
+static unsigned int Random(unsigned int *seed) {
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 16) & 0x7fff;
+}
+
+// Returns a pseudo-random number between min and max.
+static float RandomRange(unsigned int *seed, float min, float max) {
+  return min + (max - min) * Random(seed) / 0x7fff;
+}
+
+// Adds a new config of num_protos new protos to class_id of templates. If
+// permanent is true, the config and its protos are made permanent, with
+// class_id and ambig as its ambiguities, else they are temporary.
+static void AddConfig(ADAPT_TEMPLATES templates, CLASS_ID class_id,
+                      int num_protos, bool permanent, UNICHAR_ID ambig,
+                      unsigned int *seed) {
+  ADAPT_CLASS adapt_class = templates->Class[class_id];
+  INT_CLASS int_class = ClassForClassId(templates->Templates, class_id);
+  if (IsEmptyAdaptedClass(adapt_class))
+    ++templates->NumNonEmptyClasses;
+
+  BIT_VECTOR protos = NewBitVector(MAX_NUM_PROTOS);
+  zero_all_bits(protos, WordsInVectorOfSize(MAX_NUM_PROTOS));
+  int max_proto_id = 0;
+  for (int i = 0; i < num_protos; ++i) {
+    int proto_id = AddIntProto(int_class);
+    TEMP_PROTO temp_proto = NewTempProto();
+    memset(temp_proto, 0, sizeof(*temp_proto));
+    PROTO proto = &temp_proto->Proto;
+    proto->Angle = RandomRange(seed, 0.0f, 1.0f);
+    proto->X = RandomRange(seed, -0.4f, 0.4f);
+    proto->Y = RandomRange(seed, -0.4f, 0.4f);
+    proto->Length = RandomRange(seed, 0.02f, 0.2f);
+    FillABC(proto);
+    temp_proto->ProtoId = proto_id;
+    ConvertProto(proto, proto_id, int_class);
+    AddProtoToProtoPruner(proto, proto_id, int_class);
+    AddProtoToClassPruner(proto, class_id, templates->Templates);
+    SET_BIT(protos, proto_id);
+    max_proto_id = proto_id;
+    if (permanent) {
+      MakeProtoPermanent(adapt_class, proto_id);
+      FreeTempProto(temp_proto);
+    } else {
+      adapt_class->TempProtos = push(adapt_class->TempProtos, temp_proto);
+    }
+  }
+
+  int config_id = AddIntConfig(int_class);
+  ConvertConfig(protos, config_id, int_class);
+  if (permanent) {
+    MakeConfigPermanent(adapt_class, config_id);
+    if (adapt_class->NumPermConfigs == 0)
+      ++templates->NumPermClasses;
+    ++adapt_class->NumPermConfigs;
+    PERM_CONFIG ambigs = (PERM_CONFIG) Emalloc(3 * sizeof(UNICHAR_ID));
+    ambigs[0] = class_id;
+    ambigs[1] = ambig;
+    ambigs[2] = -1;
+    PermConfigFor(adapt_class, config_id) = ambigs;
+  } else {
+    TEMP_CONFIG config = NewTempConfig(max_proto_id);
+    for (int i = 0; i <= max_proto_id; ++i) {
+      if (test_bit(protos, i))
+        SET_BIT(config->Protos, i);
+    }
+    config->NumTimesSeen = 1 + Random(seed) % 3;
+    TempConfigFor(adapt_class, config_id) = config;
+  }
+  FreeBitVector(protos);
+}
+
+// Returns true if the class_id classes of both templates are the same,
+// printing the first difference otherwise.
+static bool SameClass(ADAPT_TEMPLATES expected, ADAPT_TEMPLATES actual,
+                      CLASS_ID class_id) {
+  INT_CLASS e_int = expected->Templates->Class[class_id];
+  INT_CLASS a_int = actual->Templates->Class[class_id];
+  bool same = e_int->NumProtos == a_int->NumProtos &&
+      e_int->NumProtoSets == a_int->NumProtoSets &&
+      e_int->NumConfigs == a_int->NumConfigs &&
+      e_int->font_set_id == a_int->font_set_id &&
+      memcmp(e_int->ConfigLengths, a_int->ConfigLengths,
+             e_int->NumConfigs * sizeof(e_int->ConfigLengths[0])) == 0 &&
+      (MaxNumIntProtosIn(e_int) == 0 ||
+       memcmp(e_int->ProtoLengths, a_int->ProtoLengths,
+              MaxNumIntProtosIn(e_int)) == 0);
+  for (int i = 0; same && i < e_int->NumProtoSets; ++i) {
+    same = memcmp(e_int->ProtoSets[i], a_int->ProtoSets[i],
+                  sizeof(PROTO_SET_STRUCT)) == 0;
+  }
+  if (!same) {
+    printf("Integer class %d differs\n", class_id);
+    return false;
+  }
+
+  ADAPT_CLASS e_class = expected->Class[class_id];
+  ADAPT_CLASS a_class = actual->Class[class_id];
+  same = e_class->NumPermConfigs == a_class->NumPermConfigs &&
+      memcmp(e_class->PermProtos, a_class->PermProtos,
+             WordsInVectorOfSize(MAX_NUM_PROTOS) * sizeof(uinT32)) == 0 &&
+      memcmp(e_class->PermConfigs, a_class->PermConfigs,
+             WordsInVectorOfSize(MAX_NUM_CONFIGS) * sizeof(uinT32)) == 0 &&
+      count(e_class->TempProtos) == count(a_class->TempProtos);
+  LIST e_protos = e_class->TempProtos;
+  LIST a_protos = a_class->TempProtos;
+  for (; same && e_protos != NIL; e_protos = rest(e_protos),
+       a_protos = rest(a_protos)) {
+    same = memcmp(first_node(e_protos), first_node(a_protos),
+                  sizeof(TEMP_PROTO_STRUCT)) == 0;
+  }
+  for (int i = 0; same && i < e_int->NumConfigs; ++i) {
+    if (ConfigIsPermanent(e_class, i)) {
+      PERM_CONFIG e_perm = PermConfigFor(e_class, i);
+      PERM_CONFIG a_perm = PermConfigFor(a_class, i);
+      int j = 0;
+      while (e_perm[j] >= 0 && e_perm[j] == a_perm[j])
+        ++j;
+      same = e_perm[j] == a_perm[j];
+    } else {
+      TEMP_CONFIG e_temp = TempConfigFor(e_class, i);
+      TEMP_CONFIG a_temp = TempConfigFor(a_class, i);
+      same = e_temp->NumTimesSeen == a_temp->NumTimesSeen &&
+          e_temp->ProtoVectorSize == a_temp->ProtoVectorSize &&
+          e_temp->MaxProtoId == a_temp->MaxProtoId &&
+          memcmp(e_temp->Protos, a_temp->Protos,
+                 e_temp->ProtoVectorSize * sizeof(uinT32)) == 0;
+    }
+  }
+  if (!same) {
+    printf("Adapted class %d differs\n", class_id);
+    return false;
+  }
+  return true;
+}
+
+// Returns true if both templates are the same, printing the first
+// difference otherwise.
+static bool SameTemplates(ADAPT_TEMPLATES expected, ADAPT_TEMPLATES actual) {
+  INT_TEMPLATES e_int = expected->Templates;
+  INT_TEMPLATES a_int = actual->Templates;
+  if (expected->NumNonEmptyClasses != actual->NumNonEmptyClasses ||
+      expected->NumPermClasses != actual->NumPermClasses ||
+      e_int->NumClasses != a_int->NumClasses ||
+      e_int->NumClassPruners != a_int->NumClassPruners) {
+    printf("Templates differ in their numbers of classes\n");
+    return false;
+  }
+  for (int i = 0; i < e_int->NumClassPruners; ++i) {
+    if (memcmp(e_int->ClassPruner[i], a_int->ClassPruner[i],
+               sizeof(*e_int->ClassPruner[i])) != 0) {
+      printf("Class pruner %d differs\n", i);
+      return false;
+    }
+  }
+  for (int i = 0; i < e_int->NumClasses; ++i) {
+    if (!SameClass(expected, actual, i))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace tesseract
+
+int main(int argc, char **argv) {
+  tesseract::Classify classify;
+  for (int i = 0; i < tesseract::kNumUnichars; ++i)
+    classify.unicharset.unichar_insert(tesseract::kUnichars[i]);
+
+  ADAPT_TEMPLATES templates = classify.NewAdaptedTemplates(true);
+  unsigned int seed = 1;
+  tesseract::AddConfig(templates, 1, 12, false, -1, &seed);
+  tesseract::AddConfig(templates, 2, 9, true, 3, &seed);
+  tesseract::AddConfig(templates, 2, 7, false, -1, &seed);
+  tesseract::AddConfig(templates, 4, 20, true, -1, &seed);
+  tesseract::AddConfig(templates, 4, 5, true, 0, &seed);
+
+  int length;
+  char *snapshot = classify.WriteAdaptedSnapshot(templates, &length);
+  ADAPT_TEMPLATES read_back = classify.ReadAdaptedSnapshot(snapshot, length);
+  bool ok = read_back != NULL;
+  if (!ok)
+    printf("Snapshot of %d bytes rejected\n", length);
+  ok = ok && tesseract::SameTemplates(templates, read_back);
+  if (ok) {
+    int new_length;
+    char *new_snapshot = classify.WriteAdaptedSnapshot(read_back,
+                                                       &new_length);
+    if (new_length != length || memcmp(snapshot, new_snapshot, length) != 0) {
+      printf("Snapshot of the templates read back differs\n");
+      ok = false;
+    }
+    delete [] new_snapshot;
+  }
+  free_adapted_templates(read_back);
+
+  for (int i = 0; ok && i < length; ++i) {
+    ADAPT_TEMPLATES truncated = classify.ReadAdaptedSnapshot(snapshot, i);
+    if (truncated != NULL) {
+      printf("Snapshot truncated to %d of %d bytes accepted\n", i, length);
+      free_adapted_templates(truncated);
+      ok = false;
+    }
+  }
+
+  // A classifier of another language, with as many unichars.
+  tesseract::Classify other;
+  for (int i = tesseract::kNumUnichars - 1; i >= 0; --i)
+    other.unicharset.unichar_insert(tesseract::kUnichars[i]);
+  ADAPT_TEMPLATES foreign = other.ReadAdaptedSnapshot(snapshot, length);
+  if (ok && foreign != NULL) {
+    printf("Snapshot accepted by a classifier of another unicharset\n");
+    ok = false;
+  }
+  free_adapted_templates(foreign);
+
+  free_adapted_templates(templates);
+  if (ok) {
+    printf("Round trip of a snapshot of %d bytes passed\n", length);
+  }
+  delete [] snapshot;
+  return ok ? 0 : 1;
+}
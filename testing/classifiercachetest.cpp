@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////
+// File:        classifiercachetest.cpp
+// Description: Checks the keys, lookups and eviction of the classifier
+//              result cache.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// ClassifierCache must only give back the choices of a blob whose
+// classifier input is exactly the same. This test builds box blobs by hand
+// and checks that moving a blob, changing its row or its matcher mode
+// changes the key, that an identical blob hits and gets back copies of the
+// stored choices, that the least recently used entries are evicted to keep
+// within the memory bound, and that Clear empties the cache and counts a
+// generation.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "classifiercache.h"
+#include "ratngs.h"
+#include "tessclas.h"
+
+using tesseract::ClassifierCache;
+
+static int num_failures = 0;
+
+static void Check(bool condition, const char *what) {
+  if (!condition) {
+    printf("Failed: %s\n", what);
+    ++num_failures;
+  }
+}
+
+// A blob of one rectangular outline, with its points stored in place.
+struct BoxBlob {
+  TBLOB blob;
+  TESSLINE outline;
+  EDGEPT points[4];
+};
+
+// Fills in box as the rectangle from (left, bottom) to (right, top).
+static void MakeBox(int left, int bottom, int right, int top, BoxBlob *box) {
+  memset(box, 0, sizeof(*box));
+  const int xs[4] = { left, left, right, right };
+  const int ys[4] = { top, bottom, bottom, top };
+  for (int i = 0; i < 4; ++i) {
+    EDGEPT *point = &box->points[i];
+    point->pos.x = xs[i];
+    point->pos.y = ys[i];
+    point->next = &box->points[(i + 1) % 4];
+    point->prev = &box->points[(i + 3) % 4];
+  }
+  for (int i = 0; i < 4; ++i) {
+    box->points[i].vec.x = box->points[i].next->pos.x - box->points[i].pos.x;
+    box->points[i].vec.y = box->points[i].next->pos.y - box->points[i].pos.y;
+  }
+  box->outline.topleft.x = left;
+  box->outline.topleft.y = top;
+  box->outline.botright.x = right;
+  box->outline.botright.y = bottom;
+  box->outline.start = box->points[0].pos;
+  box->outline.loop = &box->points[0];
+  box->blob.outlines = &box->outline;
+}
+
+// Fills in row as a flat normalized row with the given baseline.
+static void MakeRow(double baseline, TEXTROW *row) {
+  memset(row, 0, sizeof(*row));
+  row->baseline.segments = 1;
+  row->baseline.quads[0].c = baseline;
+  row->xheight.segments = 1;
+  row->xheight.quads[0].c = baseline + 64;
+  row->lineheight = 64;
+  row->ascrise = 32;
+  row->descdrop = -32;
+}
+
+// Returns a list of one choice of unichar_id.
+static BLOB_CHOICE_LIST *MakeChoices(int unichar_id) {
+  BLOB_CHOICE_LIST *choices = new BLOB_CHOICE_LIST;
+  BLOB_CHOICE_IT it(choices);
+  it.add_to_end(new BLOB_CHOICE(unichar_id, 1.0f, -1.0f, 0, 0));
+  return choices;
+}
+
+// Returns the unichar id of the single choice of choices, or -1.
+static int ChoiceOf(BLOB_CHOICE_LIST *choices) {
+  if (choices->length() != 1)
+    return -1;
+  BLOB_CHOICE_IT it(choices);
+  return it.data()->unichar_id();
+}
+
+static void CheckKeys() {
+  BoxBlob box, moved, other;
+  TEXTROW row, other_row;
+  MakeBox(10, 0, 30, 40, &box);
+  MakeBox(50, 0, 70, 40, &moved);
+  MakeBox(10, 0, 30, 41, &other);
+  MakeRow(0.0, &row);
+  MakeRow(1.0, &other_row);
+
+  GenericVector<inT16> key, same_key, moved_key, other_key;
+  Check(ClassifierCache::MakeKey(&box.blob, &row, 0, &key), "MakeKey");
+  ClassifierCache::MakeKey(&box.blob, &row, 0, &same_key);
+  Check(key.size() == same_key.size() &&
+        memcmp(&key[0], &same_key[0], key.size() * sizeof(key[0])) == 0,
+        "the same blob gives the same key");
+  ClassifierCache::MakeKey(&moved.blob, &row, 0, &moved_key);
+  Check(!(moved_key.size() == key.size() &&
+          memcmp(&key[0], &moved_key[0], key.size() * sizeof(key[0])) == 0),
+        "a blob at another x gives another key");
+  ClassifierCache::MakeKey(&other.blob, &row, 0, &other_key);
+  Check(!(other_key.size() == key.size() &&
+          memcmp(&key[0], &other_key[0], key.size() * sizeof(key[0])) == 0),
+        "another shape gives another key");
+
+  ClassifierCache cache;
+  cache.set_max_bytes(1 << 20);
+  BLOB_CHOICE_LIST *choices = MakeChoices(7);
+  cache.Insert(key, choices);
+  delete choices;
+
+  BLOB_CHOICE_LIST result;
+  Check(cache.Lookup(same_key, &result) && ChoiceOf(&result) == 7,
+        "the same blob hits with its choices");
+  result.clear();
+  Check(!cache.Lookup(moved_key, &result) && result.empty(),
+        "the moved blob misses");
+  ClassifierCache::MakeKey(&box.blob, &other_row, 0, &other_key);
+  Check(!cache.Lookup(other_key, &result), "another row misses");
+  ClassifierCache::MakeKey(&box.blob, &row, 1, &other_key);
+  Check(!cache.Lookup(other_key, &result), "another mode misses");
+  Check(cache.hits() == 1 && cache.misses() == 3, "hit and miss counts");
+
+  // A curved baseline is not cached.
+  other_row.baseline.quads[0].b = 0.5;
+  Check(!ClassifierCache::MakeKey(&box.blob, &other_row, 0, &other_key),
+        "no key on a curved row");
+
+  Check(cache.generation() == 0, "no generation before Clear");
+  cache.Clear();
+  Check(cache.num_entries() == 0 && cache.bytes() == 0 &&
+        cache.invalidations() == 1, "Clear empties the cache");
+  Check(!cache.Lookup(key, &result), "no hit after Clear");
+  cache.Clear();
+  Check(cache.invalidations() == 1 && cache.generation() == 2,
+        "Clear of an empty cache is a generation, not an invalidation");
+}
+
+static void CheckEviction() {
+  const int kNumBlobs = 20;
+  ClassifierCache cache;
+  cache.set_max_bytes(1 << 20);
+  GenericVector<inT16> keys[kNumBlobs];
+  TEXTROW row;
+  MakeRow(0.0, &row);
+  for (int i = 0; i < kNumBlobs; ++i) {
+    BoxBlob box;
+    MakeBox(i * 10, 0, i * 10 + 8, 40, &box);
+    ClassifierCache::MakeKey(&box.blob, &row, 0, &keys[i]);
+    BLOB_CHOICE_LIST *choices = MakeChoices(i);
+    cache.Insert(keys[i], choices);
+    delete choices;
+  }
+  Check(cache.num_entries() == kNumBlobs, "all the blobs are stored");
+  int entry_bytes = cache.bytes() / kNumBlobs;
+
+  // Touch the first blob so that the second is the least recently used.
+  BLOB_CHOICE_LIST result;
+  cache.Lookup(keys[0], &result);
+  cache.set_max_bytes(cache.bytes() - entry_bytes / 2);
+  Check(cache.num_entries() == kNumBlobs - 1 && cache.evictions() == 1,
+        "shrinking evicts one entry");
+  Check(cache.bytes() <= (kNumBlobs - 1) * entry_bytes, "bytes fit the bound");
+  result.clear();
+  Check(cache.Lookup(keys[0], &result) && ChoiceOf(&result) == 0,
+        "the recently used entry stays");
+  result.clear();
+  Check(!cache.Lookup(keys[1], &result), "the least recently used goes");
+
+  cache.set_max_bytes(0);
+  Check(!cache.enabled() && cache.num_entries() == 0,
+        "a zero bound disables and empties the cache");
+  BLOB_CHOICE_LIST *choices = MakeChoices(1);
+  cache.Insert(keys[1], choices);
+  delete choices;
+  Check(cache.num_entries() == 0, "no Insert while disabled");
+}
+
+int main(int argc, char **argv) {
+  CheckKeys();
+  CheckEviction();
+  printf("%d failures\n", num_failures);
+  return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////
+// File:        classprunertest.cpp
+// Description: Checks the SIMD class pruner against the scalar one, and
+//              the order in which the pruned classes are selected.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Classify::ClassPruner counts the pruner entries of the features with
+// ClassPrunerSIMD when classify_cp_use_simd is set and the CPU has SSE2 or
+// AVX2, and with its scalar loop otherwise, then selects the best classes
+// with SelectPrunedClasses. This test runs random pruners and features
+// through ClassPrunerSIMD and each kernel the CPU supports, with the switch
+// on and off, and checks that the counts are those of the scalar loop,
+// which is copied below. It then checks that SelectPrunedClasses keeps the
+// classes of random counts over the cutoff, and that ClassPruner reads them
+// back by decreasing count with equal counts in class order, on both the
+// counting sort and the insertion sort it falls back to.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "callcpp.h"
+#include "intmatcher.h"
+#include "intproto.h"
+#include "intsimd.h"
+
+static const int kNumTrials = 200;
+static const int kMaxPruners = 8;
+// cp_maps to test, the last with counts too large for 16 bits.
+static const inT32 kMaps[][4] = {
+  { 0, 1, 2, 3 }, { 0, 2, 5, 9 }, { 1, 0, 3, 2 }, { 0, 0, 0, 200 }
+};
+static const int kNumMaps = sizeof(kMaps) / sizeof(kMaps[0]);
+
+// Returns a random number in [0, n).
+static int Random(int n) {
+  return rand() % n;
+}
+
+// Returns 32 random bits.
+static uinT32 RandomWord() {
+  return (static_cast<uinT32>(rand()) << 16) ^ static_cast<uinT32>(rand());
+}
+
+// The scalar loop of Classify::ClassPruner.
+static void ReferenceCounts(INT_TEMPLATES templates, int num_features,
+                            INT_FEATURE_ARRAY features, int *class_count) {
+  memset(class_count, 0, sizeof(*class_count) * MAX_NUM_CLASSES);
+  for (int f = 0; f < num_features; ++f) {
+    INT_FEATURE feature = &features[f];
+    uinT32 feature_address =
+        (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
+          (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
+         (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
+    int class_index = 0;
+    for (int p = 0; p < templates->NumClassPruners; ++p) {
+      uinT32 *address =
+          (uinT32 *) templates->ClassPruner[p] + feature_address;
+      for (int w = 0; w < WERDS_PER_CP_VECTOR; ++w) {
+        uinT32 pruner_word = *address++;
+        for (int c = 0; c < CLASSES_PER_CP_WERD; ++c) {
+          class_count[class_index++] += cp_maps[pruner_word & 3];
+          pruner_word >>= 2;
+        }
+      }
+    }
+  }
+}
+
+// Returns true if the first num_classes counts are equal, printing the
+// first difference otherwise.
+static bool SameCounts(const char *name, const int *expected,
+                       const int *actual, int num_classes) {
+  for (int c = 0; c < num_classes; ++c) {
+    if (expected[c] != actual[c]) {
+      printf("%s: count of class %d is %d, expected %d\n",
+             name, c, actual[c], expected[c]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Checks the counts of random pruners and features. Returns the number of
+// failures.
+static int CheckCounts() {
+  static int expected[MAX_NUM_CLASSES];
+  static int actual[MAX_NUM_CLASSES];
+  INT_FEATURE_ARRAY features;
+  int offsets[MAX_NUM_INT_FEATURES];
+  INT_TEMPLATES_STRUCT templates;
+  memset(&templates, 0, sizeof(templates));
+  for (int p = 0; p < kMaxPruners; ++p)
+    templates.ClassPruner[p] = (CLASS_PRUNER) new CLASS_PRUNER_STRUCT;
+
+  int num_failures = 0;
+  int num_simd = 0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    templates.NumClassPruners = 1 + Random(kMaxPruners);
+    templates.NumClasses = templates.NumClassPruners * CLASSES_PER_CP;
+    for (int p = 0; p < templates.NumClassPruners; ++p) {
+      uinT32 *words = (uinT32 *) templates.ClassPruner[p];
+      for (int w = 0; w < WERDS_PER_CP; ++w)
+        words[w] = RandomWord();
+    }
+    // Crowd some of the features into a few cells, as real ones are.
+    int num_features = 1 + Random(MAX_NUM_INT_FEATURES);
+    int spread = trial % 2 == 0 ? 256 : 32;
+    for (int f = 0; f < num_features; ++f) {
+      features[f].X = Random(spread);
+      features[f].Y = Random(spread);
+      features[f].Theta = Random(256);
+      offsets[f] = (((features[f].X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
+                     (features[f].Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
+                    (features[f].Theta * NUM_CP_BUCKETS >> 8)) *
+                   WERDS_PER_CP_VECTOR;
+    }
+    memcpy(cp_maps, kMaps[trial % kNumMaps], sizeof(cp_maps));
+    ReferenceCounts(&templates, num_features, features, expected);
+    inT32 max_map = 0;
+    for (int i = 0; i < 4; ++i) {
+      if (cp_maps[i] > max_map)
+        max_map = cp_maps[i];
+    }
+    bool fits = max_map * num_features <= 0xffff;
+
+    // ClassPrunerSIMD must give the scalar counts when it runs, and must
+    // only run when it is switched on and the counts fit.
+    classify_cp_use_simd.set_value(TRUE);
+    memset(actual, 0, sizeof(actual));
+    if (ClassPrunerSIMD(&templates, num_features, features, actual)) {
+      ++num_simd;
+      if (!fits) {
+        printf("Trial %d: ClassPrunerSIMD ran on counts that do not fit\n",
+               trial);
+        ++num_failures;
+      } else if (!SameCounts("ClassPrunerSIMD", expected, actual,
+                             templates.NumClasses)) {
+        ++num_failures;
+      }
+    } else if (fits && (SIMDDetect::IsSSE2Available() ||
+                        SIMDDetect::IsAVX2Available())) {
+      printf("Trial %d: ClassPrunerSIMD did not run\n", trial);
+      ++num_failures;
+    }
+    classify_cp_use_simd.set_value(FALSE);
+    if (ClassPrunerSIMD(&templates, num_features, features, actual)) {
+      printf("Trial %d: ClassPrunerSIMD ran while switched off\n", trial);
+      ++num_failures;
+    }
+    if (!fits)
+      continue;
+
+    // Each kernel the CPU supports, whichever ClassPrunerSIMD chose.
+#ifdef TESS_SIMD_SSE2
+    if (SIMDDetect::IsSSE2Available()) {
+      ClassPrunerCountsSSE2(templates.ClassPruner, templates.NumClassPruners,
+                            offsets, num_features, cp_maps, actual);
+      if (!SameCounts("SSE2", expected, actual, templates.NumClasses))
+        ++num_failures;
+    }
+#endif
+#ifdef TESS_SIMD_AVX2
+    if (SIMDDetect::IsAVX2Available()) {
+      ClassPrunerCountsAVX2(templates.ClassPruner, templates.NumClassPruners,
+                            offsets, num_features, cp_maps, actual);
+      if (!SameCounts("AVX2", expected, actual, templates.NumClasses))
+        ++num_failures;
+    }
+#endif
+  }
+  classify_cp_use_simd.set_value(TRUE);
+  for (int p = 0; p < kMaxPruners; ++p)
+    delete [] (uinT32 *) templates.ClassPruner[p];
+  printf("%d count trials, %d with SIMD (SSE2 %d, AVX2 %d), %d failures\n",
+         kNumTrials, num_simd, SIMDDetect::IsSSE2Available(),
+         SIMDDetect::IsAVX2Available(), num_failures);
+  return num_failures;
+}
+
+// Checks SelectPrunedClasses on random counts whose kept range is narrow
+// enough for its counting sort on even trials, and too wide on odd ones.
+// Returns the number of failures.
+static int CheckSelection() {
+  static int norm_count[MAX_NUM_CLASSES];
+  static int key_count[MAX_CP_SORT_RANGE];
+  static int sort_key[MAX_NUM_CLASSES + 1];
+  static int sort_index[MAX_NUM_CLASSES + 1];
+  static int expected_key[MAX_NUM_CLASSES];
+  static int expected_index[MAX_NUM_CLASSES];
+
+  int num_failures = 0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    int num_classes = 1 + Random(MAX_NUM_CLASSES);
+    // Few distinct counts, so that there are many ties.
+    int range = trial % 2 == 0 ? 1 + Random(64) : 3 * MAX_CP_SORT_RANGE;
+    int max_key = 0;
+    for (int c = 0; c < num_classes; ++c) {
+      norm_count[c] = Random(range) - range / 4;
+      if (norm_count[c] > max_key)
+        max_key = norm_count[c];
+    }
+    int min_count = 1 + Random(max_key > 0 ? max_key : 1);
+
+    // The kept classes in the order in which they are read back: by
+    // decreasing count, and in class order for equal counts.
+    int num_expected = 0;
+    for (int c = 0; c < num_classes; ++c) {
+      if (norm_count[c] < min_count)
+        continue;
+      int position = num_expected++;
+      while (position > 0 && expected_key[position - 1] < norm_count[c]) {
+        expected_key[position] = expected_key[position - 1];
+        expected_index[position] = expected_index[position - 1];
+        --position;
+      }
+      expected_key[position] = norm_count[c];
+      expected_index[position] = c;
+    }
+
+    int num_kept = SelectPrunedClasses(num_classes, norm_count, min_count,
+                                       max_key, key_count, sort_key,
+                                       sort_index);
+    if (num_kept != num_expected) {
+      printf("Trial %d: kept %d classes, expected %d\n",
+             trial, num_kept, num_expected);
+      ++num_failures;
+      continue;
+    }
+    // ClassPruner reads the classes from the end of the arrays.
+    for (int i = 0; i < num_kept; ++i) {
+      int read = num_kept - i;
+      if (sort_key[read] != expected_key[i] ||
+          sort_index[read] != expected_index[i]) {
+        printf("Trial %d: class %d read is %d with count %d, "
+               "expected %d with count %d\n", trial, i, sort_index[read],
+               sort_key[read], expected_index[i], expected_key[i]);
+        ++num_failures;
+        break;
+      }
+    }
+  }
+  printf("%d selection trials, %d failures\n", kNumTrials, num_failures);
+  return num_failures;
+}
+
+int main(int argc, char **argv) {
+  srand(1);
+  int num_failures = CheckCounts();
+  num_failures += CheckSelection();
+  return num_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgcachetest.cpp
+// Description: Checks the edge index of large squished dawg nodes and the
+//              cache of dawg edge lookups.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// SquishedDawg::edge_char_of binary-searches a sorted index of the nodes
+// with at least dawg_min_indexed_edges edges. This test makes the same
+// dawg of random words with the index switched off and with almost every
+// node indexed, and checks that edge_char_of returns exactly the same edge
+// in both for every unichar id and word end at every node on the paths of
+// the words. It then checks that DawgEdgeCache gives back the edges
+// inserted for the same key only, and nothing after Clear.
+
+#include <stdio.h>
+
+#include "dawg.h"
+#include "dawgcache.h"
+#include "ratngs.h"
+#include "trie.h"
+
+namespace tesseract {
+
+static const int kUnicharsetSize = 41;
+static const int kNumWords = 3000;
+static const int kMaxWordLength = 10;
+
+// Returns the next number of a fixed pseudo-random sequence.
+static unsigned int Random(unsigned int *seed) {
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 16) & 0x7fff;
+}
+
+// Makes the random word of index i into word and returns its length. The
+// first letters are drawn from all the unichar ids, so that the nodes near
+// the root have many edges.
+static int MakeWord(int i, UNICHAR_ID *word) {
+  unsigned int seed = i + 1;
+  int length = 1 + Random(&seed) % kMaxWordLength;
+  for (int j = 0; j < length; ++j) {
+    int num_letters = j < 2 ? kUnicharsetSize - 1 : 6;
+    word[j] = 1 + Random(&seed) % num_letters;
+  }
+  return length;
+}
+
+// Returns the squished dawg of the kNumWords words, with the nodes of at
+// least min_indexed_edges edges indexed.
+static SquishedDawg *MakeDawg(int min_indexed_edges) {
+  Trie trie(DAWG_TYPE_WORD, "", SYSTEM_DAWG_PERM, 1 << 20, kUnicharsetSize);
+  UNICHAR_ID word[kMaxWordLength];
+  for (int i = 0; i < kNumWords; ++i) {
+    int length = MakeWord(i, word);
+    WERD_CHOICE choice;
+    for (int j = 0; j < length; ++j)
+      choice.append_unichar_id(word[j], 1, 0.0, 0.0);
+    trie.add_word_to_dawg(choice);
+  }
+  dawg_min_indexed_edges.set_value(min_indexed_edges);
+  SquishedDawg *dawg = trie.trie_to_dawg();
+  dawg_min_indexed_edges.set_value(16);
+  return dawg;
+}
+
+// Compares the edges of the two dawgs out of every node on the paths of
+// the words. Returns the number of differences.
+static int CompareEdges(const Dawg &linear, const Dawg &indexed) {
+  int num_differences = 0;
+  UNICHAR_ID word[kMaxWordLength];
+  for (int i = 0; i < kNumWords; ++i) {
+    int length = MakeWord(i, word);
+    NODE_REF node = 0;
+    for (int j = 0; j < length; ++j) {
+      for (UNICHAR_ID id = 0; id < kUnicharsetSize; ++id) {
+        for (int word_end = 0; word_end < 2; ++word_end) {
+          EDGE_REF expected = linear.edge_char_of(node, id, word_end);
+          EDGE_REF actual = indexed.edge_char_of(node, id, word_end);
+          if (actual != expected) {
+            if (num_differences == 0) {
+              printf("Node " REFFORMAT " letter %d end %d: edge " REFFORMAT
+                     ", expected " REFFORMAT "\n", node, id, word_end,
+                     actual, expected);
+            }
+            ++num_differences;
+          }
+        }
+      }
+      EDGE_REF edge = linear.edge_char_of(node, word[j], false);
+      node = linear.next_node(edge);
+      if (node == 0)
+        break;
+    }
+  }
+  return num_differences;
+}
+
+// Returns the number of failures of DawgEdgeCache.
+static int CheckCache() {
+  int num_failures = 0;
+  DawgEdgeCache cache;
+  EDGE_REF edge = NO_EDGE;
+  for (int node = 0; node < 1000; ++node)
+    cache.Insert(node % 2, node, node % 7, node % 3 == 0, node * 10);
+  // About one in nine of the entries were replaced by later ones of the
+  // same slot, but any entry found must be the one inserted for its key.
+  int num_found = 0;
+  for (int node = 0; node < 1000; ++node) {
+    if (cache.Lookup(node % 2, node, node % 7, node % 3 == 0, &edge)) {
+      ++num_found;
+      if (edge != node * 10) {
+        printf("Cached edge of node %d is " REFFORMAT "\n", node, edge);
+        ++num_failures;
+      }
+    }
+    if (cache.Lookup(node % 2 + 1, node, node % 7, node % 3 == 0, &edge) ||
+        cache.Lookup(node % 2, node, node % 7 + 1, node % 3 == 0, &edge) ||
+        cache.Lookup(node % 2, node, node % 7, node % 3 != 0, &edge)) {
+      printf("Node %d found under another key\n", node);
+      ++num_failures;
+    }
+  }
+  if (num_found < 800) {
+    printf("Only %d of 1000 edges stayed in the cache\n", num_found);
+    ++num_failures;
+  }
+  cache.Clear();
+  for (int node = 0; node < 1000; ++node) {
+    if (cache.Lookup(node % 2, node, node % 7, node % 3 == 0, &edge)) {
+      printf("Node %d found after Clear\n", node);
+      ++num_failures;
+      break;
+    }
+  }
+  cache.Insert(0, 5, 3, true, NO_EDGE);
+  if (!cache.Lookup(0, 5, 3, true, &edge) || edge != NO_EDGE) {
+    printf("A missing edge is not cached\n");
+    ++num_failures;
+  }
+  return num_failures;
+}
+
+}  // namespace tesseract
+
+int main(int argc, char **argv) {
+  tesseract::SquishedDawg *linear = tesseract::MakeDawg(0);
+  tesseract::SquishedDawg *indexed = tesseract::MakeDawg(2);
+  int num_differences = tesseract::CompareEdges(*linear, *indexed);
+  printf("%d differences between the indexed and linear searches\n",
+         num_differences);
+  delete linear;
+  delete indexed;
+  int num_failures = tesseract::CheckCache();
+  printf("%d cache failures\n", num_failures);
+  return num_differences == 0 && num_failures == 0 ? 0 : 1;
+}
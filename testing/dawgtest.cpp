@@ -0,0 +1,267 @@
+///////////////////////////////////////////////////////////////////////
+// File:        dawgtest.cpp
+// Description: Round trip of a dawg through the node-indexed squished
+//              dawg format.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Builds the dawg of a word list with DawgBuilder, writes it with
+// write_squished_dawg in the node-indexed format and reads it back. Checks
+// that every stage holds exactly the words of the list, and that
+// edge_char_of of the dawg read back finds the same words and rejects the
+// same non-words as a dawg in the edge array layout, made from the same
+// words by Trie::trie_to_dawg.
+
+#include <stdio.h>
+
+#include "dawg.h"
+#include "dawgbuilder.h"
+#include "genericvector.h"
+#include "ratngs.h"
+#include "trie.h"
+#include "unichar.h"
+
+namespace tesseract {
+
+// Number of unichar ids of the words, which are all above 0, as 0 is the
+// space of a unicharset. The root gets an edge for most of them, so it is
+// binary searched, while most deeper nodes are searched linearly.
+static const int kUnicharsetSize = 41;
+static const int kNumWords = 4000;
+static const int kMaxWordLength = 12;
+
+// Sorted list of words without duplicates, each given by its unichar ids
+// followed by INVALID_UNICHAR_ID.
+class WordList {
+ public:
+  // Adds the first length unichar ids of word.
+  void AddWord(const UNICHAR_ID *word, int length) {
+    for (int i = 0; i < length; ++i)
+      unichar_ids_.push_back(word[i]);
+    unichar_ids_.push_back(INVALID_UNICHAR_ID);
+  }
+  // Adds the words of dawg that start at node. The letters before node
+  // are in prefix.
+  void AddWords(const Dawg &dawg, NODE_REF node,
+                GenericVector<UNICHAR_ID> *prefix) {
+    NodeChildVector children;
+    dawg.unichar_ids_of(node, &children);
+    for (int i = 0; i < children.size(); ++i) {
+      prefix->push_back(children[i].unichar_id);
+      if (dawg.end_of_word(children[i].edge_ref))
+        AddWord(&(*prefix)[0], prefix->size());
+      NODE_REF next = dawg.next_node(children[i].edge_ref);
+      if (next != 0)
+        AddWords(dawg, next, prefix);
+      prefix->truncate(prefix->size() - 1);
+    }
+  }
+  // Sorts the words added and removes the duplicates. No words can be
+  // added after this.
+  void Sort() {
+    GenericVector<const UNICHAR_ID *> words;
+    for (int start = 0; start < unichar_ids_.size(); ++start) {
+      words.push_back(&unichar_ids_[start]);
+      while (unichar_ids_[start] != INVALID_UNICHAR_ID)
+        ++start;
+    }
+    DawgBuilder::sort_words(&words, 1);
+    for (int i = 0; i < words.size(); ++i) {
+      if (words_.empty() ||
+          DawgBuilder::compare_words(words_[words_.size() - 1],
+                                     words[i]) != 0)
+        words_.push_back(words[i]);
+    }
+  }
+
+  int size() const { return words_.size(); }
+  const UNICHAR_ID *word(int index) const { return words_[index]; }
+  int length(int index) const {
+    int length = 0;
+    while (words_[index][length] != INVALID_UNICHAR_ID)
+      ++length;
+    return length;
+  }
+
+  // Returns true if dawg holds exactly the words of this list, printing
+  // the first difference otherwise.
+  bool SameWords(const Dawg &dawg, const char *name) const {
+    WordList dawg_words;
+    GenericVector<UNICHAR_ID> prefix;
+    dawg_words.AddWords(dawg, 0, &prefix);
+    dawg_words.Sort();
+    for (int i = 0; i < size() && i < dawg_words.size(); ++i) {
+      if (DawgBuilder::compare_words(word(i), dawg_words.word(i)) != 0) {
+        printf("%s: word %d differs\n", name, i);
+        return false;
+      }
+    }
+    if (size() != dawg_words.size()) {
+      printf("%s has %d words, expected %d\n", name, dawg_words.size(),
+             size());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  GenericVector<UNICHAR_ID> unichar_ids_;
+  GenericVector<const UNICHAR_ID *> words_;
+};
+
+// Returns the next number of a fixed pseudo-random sequence.
+static unsigned int Random(unsigned int *seed) {
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 16) & 0x7fff;
+}
+
+// Adds kNumWords words to words. Their letters are drawn from fewer unichar
+// ids the further they are into the word, and many words end with one of a
+// few suffixes, so the words share prefixes and suffixes, as in a
+// dictionary.
+static void MakeWords(WordList *words) {
+  static const UNICHAR_ID kSuffixes[][3] = {
+    { 5, 14, 7 }, { 5, 4, INVALID_UNICHAR_ID }, { 19, INVALID_UNICHAR_ID }
+  };
+  unsigned int seed = 1;
+  UNICHAR_ID word[kMaxWordLength + 3];
+  for (int i = 0; i < kNumWords; ++i) {
+    int length = 1 + Random(&seed) % kMaxWordLength;
+    for (int j = 0; j < length; ++j) {
+      int num_letters = kUnicharsetSize - 1 - 3 * j;
+      if (num_letters < 4) num_letters = 4;
+      word[j] = 1 + Random(&seed) % num_letters;
+    }
+    int suffix = Random(&seed) % 6;
+    for (int j = 0; suffix < 3 && j < 3 &&
+         kSuffixes[suffix][j] != INVALID_UNICHAR_ID; ++j)
+      word[length++] = kSuffixes[suffix][j];
+    words->AddWord(word, length);
+  }
+  words->Sort();
+}
+
+// Returns true if the first length unichar ids of word are a word of dawg,
+// as Dawg::word_in_dawg finds it.
+static bool WordInDawg(const Dawg &dawg, const UNICHAR_ID *word, int length) {
+  NODE_REF node = 0;
+  for (int i = 0; i < length; ++i) {
+    if (node == NO_EDGE)
+      return false;
+    EDGE_REF edge = dawg.edge_char_of(node, word[i], i == length - 1);
+    if (edge == NO_EDGE)
+      return false;
+    node = dawg.next_node(edge);
+    if (node == 0)
+      node = NO_EDGE;
+  }
+  return length > 0;
+}
+
+// Looks up each word of words, its prefixes and the words that differ from
+// it in the last letter in both dawgs. Returns true if the dawgs agree on
+// all of them and find all the words.
+static bool SameLookups(const WordList &words, const Dawg &expected,
+                        const Dawg &actual) {
+  UNICHAR_ID probe[kMaxWordLength + 3];
+  for (int i = 0; i < words.size(); ++i) {
+    int length = words.length(i);
+    if (!WordInDawg(actual, words.word(i), length)) {
+      printf("Word %d of length %d not found\n", i, length);
+      return false;
+    }
+    for (int j = 0; j < length; ++j)
+      probe[j] = words.word(i)[j];
+    for (int j = 1; j < length; ++j) {
+      if (WordInDawg(expected, probe, j) != WordInDawg(actual, probe, j)) {
+        printf("Prefix of length %d of word %d looked up differently\n",
+               j, i);
+        return false;
+      }
+    }
+    for (UNICHAR_ID id = 0; id < kUnicharsetSize; ++id) {
+      probe[length - 1] = id;
+      if (WordInDawg(expected, probe, length) !=
+          WordInDawg(actual, probe, length)) {
+        printf("Word %d with a last letter of %d looked up differently\n",
+               i, id);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace tesseract
+
+int main(int argc, char **argv) {
+  using tesseract::DawgBuilder;
+  using tesseract::SquishedDawg;
+  const char *kDawgFile = "dawgtest.dawg";
+
+  tesseract::WordList words;
+  tesseract::MakeWords(&words);
+
+  // The reference dawg, in the edge array layout.
+  tesseract::Trie trie(tesseract::DAWG_TYPE_WORD, "", SYSTEM_DAWG_PERM,
+                       1 << 20, tesseract::kUnicharsetSize);
+  for (int i = 0; i < words.size(); ++i) {
+    WERD_CHOICE word;
+    for (int j = 0; j < words.length(i); ++j)
+      word.append_unichar_id(words.word(i)[j], 1, 0.0, 0.0);
+    trie.add_word_to_dawg(word);
+  }
+  SquishedDawg *reference = trie.trie_to_dawg();
+  bool ok = words.SameWords(*reference, "Trie");
+
+  DawgBuilder builder(tesseract::DAWG_TYPE_WORD, "", SYSTEM_DAWG_PERM,
+                      tesseract::kUnicharsetSize);
+  for (int i = 0; ok && i < words.size(); ++i) {
+    if (!builder.add_word(words.word(i), words.length(i))) {
+      printf("DawgBuilder rejected word %d\n", i);
+      ok = false;
+    }
+  }
+  builder.finish();
+  ok = ok && words.SameWords(builder, "DawgBuilder");
+
+  SquishedDawg *squished = builder.to_squished_dawg();
+  ok = ok && words.SameWords(*squished, "to_squished_dawg");
+  if (ok)
+    squished->write_squished_dawg(kDawgFile);
+  delete squished;
+
+  FILE *file = ok ? fopen(kDawgFile, "rb") : NULL;
+  inT16 magic = 0;
+  if (ok && (file == NULL || fread(&magic, sizeof(magic), 1, file) != 1 ||
+             magic != tesseract::Dawg::kNodeDawgMagicNumber)) {
+    printf("%s is not in the node-indexed format\n", kDawgFile);
+    ok = false;
+  }
+  if (file != NULL)
+    fclose(file);
+  if (ok) {
+    SquishedDawg read_back(kDawgFile, tesseract::DAWG_TYPE_WORD, "",
+                           SYSTEM_DAWG_PERM);
+    ok = words.SameWords(read_back, "read_squished_dawg") &&
+        tesseract::SameLookups(words, *reference, read_back);
+    remove(kDawgFile);
+  }
+  delete reference;
+  if (ok) {
+    printf("Round trip of %d words through %d nodes and %d edges passed\n",
+           words.size(), builder.num_states(), builder.num_edges());
+  }
+  return ok ? 0 : 1;
+}
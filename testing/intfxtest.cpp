@@ -0,0 +1,424 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intfxtest.cpp
+// Description: Checks the integer feature extractor against the original
+//              three-pass extractor on the blobs of a real image.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// ExtractIntFeat copies the outlines of a blob into a flat array of points
+// with FlattenOutlines and extracts the features from it in one pass with
+// ExtractFlatIntFeat. ReferenceExtractIntFeat below is the extractor it
+// replaced, which walked the outlines three times. This test finds the
+// blobs of intfxtest.tif, places them on the baseline at a few scales,
+// alone, in pairs and all together, and checks that both extractors give
+// exactly the same results and features.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "edgblob.h"
+#include "emalloc.h"
+#include "expandblob.h"
+#include "img.h"
+#include "intfx.h"
+#include "intmatcher.h"
+#include "ocrblock.h"
+#include "polyblob.h"
+#include "tstruct.h"
+#include "werd.h"
+
+// Height in pixels of the lower case letters of intfxtest.tif.
+static const float kXHeight = 15.0f;
+// Scales at which each blob is extracted, relative to the one that gives
+// the letters an x-height of bln_x_height.
+static const float kScales[] = { 0.5f, 1.0f, 1.5f, 2.0f };
+static const int kNumScales = sizeof(kScales) / sizeof(kScales[0]);
+
+// The three-pass extractor as it was before the flat outline buffer, kept
+// verbatim apart from its name.
+static int ReferenceExtractIntFeat(TBLOB *Blob,
+                                   INT_FEATURE_ARRAY BLFeat,
+                                   INT_FEATURE_ARRAY CNFeat,
+                                   INT_FX_RESULT Results) {
+  TESSLINE *OutLine;
+  EDGEPT *Loop, *LoopStart, *Segment;
+  inT16 LastX, LastY, Xmean, Ymean;
+  inT32 NormX, NormY, DeltaX, DeltaY;
+  inT32 Xsum, Ysum;
+  uinT32 Ix, Iy, LengthSum;
+  uinT16 n;
+  uinT8 Theta;
+  uinT16 NumBLFeatures, NumCNFeatures;
+  uinT8 RxInv, RyInv;            /* x.xxxxxxx  *  2^Exp  */
+  uinT8 RxExp, RyExp;
+                                 /* sxxxxxxxxxxxxxxxxxxxxxxx.xxxxxxxx */
+  register inT32 pfX, pfY, dX, dY;
+  uinT16 Length;
+  register int i;
+
+  Results->Length = 0;
+  Results->Xmean = 0;
+  Results->Ymean = 0;
+  Results->Rx = 0;
+  Results->Ry = 0;
+  Results->NumBL = 0;
+  Results->NumCN = 0;
+
+  /* find Xmean, Ymean */
+  NumBLFeatures = 0;
+  NumCNFeatures = 0;
+  OutLine = Blob->outlines;
+  Xsum = 0;
+  Ysum = 0;
+  LengthSum = 0;
+  while (OutLine != NULL) {
+    LoopStart = OutLine->loop;
+    Loop = LoopStart;
+    LastX = Loop->pos.x;
+    LastY = Loop->pos.y;
+    /* Check for bad loops */
+    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
+      return FALSE;
+    do {
+      Segment = Loop;
+      Loop = Loop->next;
+      NormX = Loop->pos.x;
+      NormY = Loop->pos.y;
+
+      n = 1;
+      if (!is_hidden_edge (Segment)) {
+        DeltaX = NormX - LastX;
+        DeltaY = NormY - LastY;
+        Length = MySqrt (DeltaX, DeltaY);
+        n = ((Length << 2) + Length + 32) >> 6;
+        if (n != 0) {
+          Xsum += ((LastX << 1) + DeltaX) * (int) Length;
+          Ysum += ((LastY << 1) + DeltaY) * (int) Length;
+          LengthSum += Length;
+        }
+      }
+      if (n != 0) {              /* Throw away a point that is too close */
+        LastX = NormX;
+        LastY = NormY;
+      }
+    }
+    while (Loop != LoopStart);
+    OutLine = OutLine->next;
+  }
+  if (LengthSum == 0)
+    return FALSE;
+  Xmean = (Xsum / (inT32) LengthSum) >> 1;
+  Ymean = (Ysum / (inT32) LengthSum) >> 1;
+
+  Results->Length = LengthSum;
+  Results->Xmean = Xmean;
+  Results->Ymean = Ymean;
+
+  /* extract Baseline normalized features,     */
+  /* and find 2nd moments & radius of gyration */
+  Ix = 0;
+  Iy = 0;
+  NumBLFeatures = 0;
+  OutLine = Blob->outlines;
+  while (OutLine != NULL) {
+    LoopStart = OutLine->loop;
+    Loop = LoopStart;
+    LastX = Loop->pos.x - Xmean;
+    LastY = Loop->pos.y;
+    /* Check for bad loops */
+    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
+      return FALSE;
+    do {
+      Segment = Loop;
+      Loop = Loop->next;
+      NormX = Loop->pos.x - Xmean;
+      NormY = Loop->pos.y;
+
+      n = 1;
+      if (!is_hidden_edge (Segment)) {
+        DeltaX = NormX - LastX;
+        DeltaY = NormY - LastY;
+        Length = MySqrt (DeltaX, DeltaY);
+        n = ((Length << 2) + Length + 32) >> 6;
+        if (n != 0) {
+          Theta = TableLookup (DeltaY, DeltaX);
+          dX = (DeltaX << 8) / n;
+          dY = (DeltaY << 8) / n;
+          pfX = (LastX << 8) + (dX >> 1);
+          pfY = (LastY << 8) + (dY >> 1);
+          Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
+          Iy += (pfX >> 8) * (pfX >> 8);
+          if (SaveFeature (BLFeat, NumBLFeatures, (inT16) (pfX >> 8),
+            (inT16) ((pfY >> 8) - 128),
+            Theta) == FALSE)
+            return FALSE;
+          NumBLFeatures++;
+          for (i = 1; i < n; i++) {
+            pfX += dX;
+            pfY += dY;
+            Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
+            Iy += (pfX >> 8) * (pfX >> 8);
+            if (SaveFeature
+              (BLFeat, NumBLFeatures, (inT16) (pfX >> 8),
+              (inT16) ((pfY >> 8) - 128), Theta) == FALSE)
+              return FALSE;
+            NumBLFeatures++;
+          }
+        }
+      }
+      if (n != 0) {              /* Throw away a point that is too close */
+        LastX = NormX;
+        LastY = NormY;
+      }
+    }
+    while (Loop != LoopStart);
+    OutLine = OutLine->next;
+  }
+  if (Ix == 0)
+    Ix = 1;
+  if (Iy == 0)
+    Iy = 1;
+  RxInv = MySqrt2 (NumBLFeatures, Ix, &RxExp);
+  RyInv = MySqrt2 (NumBLFeatures, Iy, &RyExp);
+  ClipRadius(&RxInv, &RxExp, &RyInv, &RyExp);
+
+  Results->Rx = (inT16) (51.2 / (double) RxInv * pow (2.0, (double) RxExp));
+  Results->Ry = (inT16) (51.2 / (double) RyInv * pow (2.0, (double) RyExp));
+  if (Results->Ry == 0) {
+    /*
+        This would result in features having 'nan' values.
+        Since the expression is always > 0, assign a value of 1.
+    */
+    Results->Ry = 1;
+  }
+  Results->NumBL = NumBLFeatures;
+
+  /* extract character normalized features */
+  NumCNFeatures = 0;
+  OutLine = Blob->outlines;
+  while (OutLine != NULL) {
+    LoopStart = OutLine->loop;
+    Loop = LoopStart;
+    LastX = (Loop->pos.x - Xmean) * RyInv;
+    LastY = (Loop->pos.y - Ymean) * RxInv;
+    LastX >>= (inT8) RyExp;
+    LastY >>= (inT8) RxExp;
+    /* Check for bad loops */
+    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
+      return FALSE;
+    do {
+      Segment = Loop;
+      Loop = Loop->next;
+      NormX = (Loop->pos.x - Xmean) * RyInv;
+      NormY = (Loop->pos.y - Ymean) * RxInv;
+      NormX >>= (inT8) RyExp;
+      NormY >>= (inT8) RxExp;
+
+      n = 1;
+      if (!is_hidden_edge (Segment)) {
+        DeltaX = NormX - LastX;
+        DeltaY = NormY - LastY;
+        Length = MySqrt (DeltaX, DeltaY);
+        n = ((Length << 2) + Length + 32) >> 6;
+        if (n != 0) {
+          Theta = TableLookup (DeltaY, DeltaX);
+          dX = (DeltaX << 8) / n;
+          dY = (DeltaY << 8) / n;
+          pfX = (LastX << 8) + (dX >> 1);
+          pfY = (LastY << 8) + (dY >> 1);
+          if (SaveFeature (CNFeat, NumCNFeatures, (inT16) (pfX >> 8),
+            (inT16) ((pfY >> 8)), Theta) == FALSE)
+            return FALSE;
+          NumCNFeatures++;
+          for (i = 1; i < n; i++) {
+            pfX += dX;
+            pfY += dY;
+            if (SaveFeature
+              (CNFeat, NumCNFeatures, (inT16) (pfX >> 8),
+              (inT16) ((pfY >> 8)), Theta) == FALSE)
+              return FALSE;
+            NumCNFeatures++;
+          }
+        }
+      }
+      if (n != 0) {              /* Throw away a point that is too close */
+        LastX = NormX;
+        LastY = NormY;
+      }
+    }
+    while (Loop != LoopStart);
+    OutLine = OutLine->next;
+  }
+
+  Results->NumCN = NumCNFeatures;
+  return TRUE;
+}
+
+// Returns true if the first num_features features of the arrays are equal,
+// printing the first difference otherwise.
+static bool SameFeatures(const char *name, const INT_FEATURE_ARRAY expected,
+                         const INT_FEATURE_ARRAY actual, int num_features) {
+  for (int i = 0; i < num_features; ++i) {
+    if (expected[i].X != actual[i].X || expected[i].Y != actual[i].Y ||
+        expected[i].Theta != actual[i].Theta) {
+      printf("%s feature %d is (%d,%d,%d), expected (%d,%d,%d)\n", name, i,
+             actual[i].X, actual[i].Y, actual[i].Theta,
+             expected[i].X, expected[i].Y, expected[i].Theta);
+      return false;
+    }
+  }
+  return true;
+}
+
+// Extracts the features of blob with both extractors. Returns true if they
+// agree. Counts the blobs that the extractors rejected in *num_rejected.
+static bool CheckBlob(TBLOB *blob, int *num_rejected) {
+  static INT_FEATURE_ARRAY expected_bl, expected_cn, bl, cn;
+  INT_FX_RESULT_STRUCT expected, flat, result;
+
+  int expected_ok = ReferenceExtractIntFeat(blob, expected_bl, expected_cn,
+                                            &expected);
+
+  // The two steps of ExtractIntFeat, then ExtractIntFeat itself.
+  INT_FX_POINT local_points[MAX_LOCAL_FX_POINTS];
+  INT_FX_POINT *points = local_points;
+  int num_points = FlattenOutlines(blob, &points);
+  int flat_ok = num_points >= 0 &&
+      ExtractFlatIntFeat(points, num_points, bl, cn, &flat);
+  if (points != local_points)
+    Efree(points);
+  if (flat_ok != expected_ok) {
+    printf("ExtractFlatIntFeat returned %d, expected %d\n",
+           flat_ok, expected_ok);
+    return false;
+  }
+  int ok = ExtractIntFeat(blob, bl, cn, &result);
+  if (ok != expected_ok) {
+    printf("ExtractIntFeat returned %d, expected %d\n", ok, expected_ok);
+    return false;
+  }
+  if (!expected_ok) {
+    ++*num_rejected;
+    return true;
+  }
+  const INT_FX_RESULT_STRUCT *results[] = { &flat, &result };
+  for (int i = 0; i < 2; ++i) {
+    const INT_FX_RESULT_STRUCT &r = *results[i];
+    if (r.Length != expected.Length || r.Xmean != expected.Xmean ||
+        r.Ymean != expected.Ymean || r.Rx != expected.Rx ||
+        r.Ry != expected.Ry || r.NumBL != expected.NumBL ||
+        r.NumCN != expected.NumCN) {
+      printf("Results (%d %d,%d %d,%d %d,%d) differ from the expected "
+             "(%d %d,%d %d,%d %d,%d)\n",
+             r.Length, r.Xmean, r.Ymean, r.Rx, r.Ry, r.NumBL, r.NumCN,
+             expected.Length, expected.Xmean, expected.Ymean,
+             expected.Rx, expected.Ry, expected.NumBL, expected.NumCN);
+      return false;
+    }
+  }
+  return SameFeatures("BL", expected_bl, bl, expected.NumBL) &&
+      SameFeatures("CN", expected_cn, cn, expected.NumCN);
+}
+
+// Checks the features of pblob, placed on the baseline at each of
+// kScales, and counts the extractions in the given counts. Returns false
+// if the extractors disagree at any scale.
+static bool CheckScaledBlob(const PBLOB &pblob, int *num_checked,
+                            int *num_rejected) {
+  bool ok = true;
+  for (int s = 0; s < kNumScales; ++s) {
+    // Center the blob on x = 0 and stand it on the baseline, as baseline
+    // normalization does.
+    PBLOB scaled;
+    scaled = pblob;
+    TBOX box = scaled.bounding_box();
+    scaled.move(FCOORD(-(box.left() + box.right()) / 2.0f, -box.bottom()));
+    scaled.scale(kScales[s] * bln_x_height / kXHeight);
+    scaled.move(FCOORD(0.0f, bln_baseline_offset));
+    TBLOB *blob = make_tess_blob(&scaled, TRUE);
+    if (!CheckBlob(blob, num_rejected)) {
+      printf("Blob at (%d,%d)->(%d,%d), scale %g: features differ\n",
+             box.left(), box.bottom(), box.right(), box.top(), kScales[s]);
+      ok = false;
+    }
+    ++*num_checked;
+    free_blob(blob);
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  const char *srcdir = getenv("srcdir");
+  STRING filename = srcdir != NULL ? srcdir : ".";
+  filename += "/intfxtest.tif";
+  IMAGE image;
+  if (image.read_header(filename.string()) != 0 || image.read(0) != 0) {
+    printf("Failed to read %s\n", filename.string());
+    return 1;
+  }
+  InitIntegerFX();
+  // Init sets the range of the deltas that MySqrt measures.
+  IntegerMatcher matcher;
+  matcher.Init();
+
+  BLOCK block("intfxtest", TRUE, 0, 0, 0, 0,
+              image.get_xsize(), image.get_ysize());
+  extract_edges(
+#ifndef GRAPHICS_DISABLED
+                NULL,
+#endif
+                &image, &image,
+                ICOORD(image.get_xsize(), image.get_ysize()), &block);
+
+  // Check each blob, each pair of neighbouring blobs as one blob of
+  // several outlines, and all of them as one blob, which has too many
+  // features.
+  int num_blobs = 0;
+  int num_checked = 0;
+  int num_rejected = 0;
+  int num_failed = 0;
+  PBLOB all_blobs;
+  OUTLINE_IT all_it(all_blobs.out_list());
+  C_BLOB *prev_c_blob = NULL;
+  C_BLOB_IT c_blob_it(block.blob_list());
+  for (c_blob_it.mark_cycle_pt(); !c_blob_it.cycled_list();
+       c_blob_it.forward()) {
+    C_BLOB *c_blob = c_blob_it.data();
+    float xheight = c_blob->bounding_box().height();
+    PBLOB pblob(c_blob, xheight);
+    if (!CheckScaledBlob(pblob, &num_checked, &num_rejected))
+      ++num_failed;
+    if (prev_c_blob != NULL) {
+      PBLOB pair(prev_c_blob, prev_c_blob->bounding_box().height());
+      PBLOB copy;
+      copy = pblob;
+      OUTLINE_IT(pair.out_list()).add_list_after(copy.out_list());
+      if (!CheckScaledBlob(pair, &num_checked, &num_rejected))
+        ++num_failed;
+    }
+    PBLOB copy;
+    copy = pblob;
+    all_it.add_list_after(copy.out_list());
+    prev_c_blob = c_blob;
+    ++num_blobs;
+  }
+  if (!CheckScaledBlob(all_blobs, &num_checked, &num_rejected))
+    ++num_failed;
+  printf("%d blobs, %d extractions, %d rejected by both, %d failures\n",
+         num_blobs, num_checked, num_rejected, num_failed);
+  // Both the accepted and the rejected blobs must have been tested.
+  if (num_rejected == 0 || num_rejected == num_checked)
+    return 1;
+  return num_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intmatchertest.cpp
+// Description: Checks the SIMD integer matcher against the scalar one on
+//              random classes and features.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// IntegerMatcher updates its evidence tables with the kernels of
+// GetIntMatcherKernels when classify_im_use_simd is set and the CPU has
+// SSE2 or AVX2, and with its scalar code otherwise. This test builds random
+// classes, masks and features, runs Match, FindGoodProtos and
+// FindBadFeatures with the switch off and on, and checks that the results
+// are exactly the same. The classes have random proto pruners, so that the
+// number of protos matching each feature varies, and up to all 64 configs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "intmatcher.h"
+#include "intproto.h"
+#include "intsimd.h"
+
+static const int kNumTrials = 300;
+static const uinT16 kBlobLength = 100;
+static const uinT8 kNormalizationFactor = 50;
+
+// Returns a random number in [0, n).
+static int Random(int n) {
+  return rand() % n;
+}
+
+// Returns 32 random bits.
+static uinT32 RandomWord() {
+  return (static_cast<uinT32>(rand()) << 16) ^ static_cast<uinT32>(rand());
+}
+
+// Returns a new class of random protos and configs. On odd trials the
+// proto pruners are sparse, so that few protos match each feature.
+static INT_CLASS RandomClass(int trial) {
+  int num_protos = 1 + Random(MAX_NUM_PROTOS);
+  INT_CLASS int_class = NewIntClass(num_protos, 0);
+  int_class->NumProtos = num_protos;
+  int_class->NumConfigs = 1 + Random(trial % 3 == 0 ? MAX_NUM_CONFIGS : 32);
+  for (int p = 0; p < MaxNumIntProtosIn(int_class); ++p)
+    int_class->ProtoLengths[p] = 1 + Random(MAX_PROTO_INDEX);
+  for (int c = 0; c < MAX_NUM_CONFIGS; ++c)
+    int_class->ConfigLengths[c] = 1 + Random(200);
+  for (int s = 0; s < int_class->NumProtoSets; ++s) {
+    PROTO_SET proto_set = int_class->ProtoSets[s];
+    uinT32 *words = reinterpret_cast<uinT32 *>(proto_set->ProtoPruner);
+    for (int w = 0; w < WERDS_PER_PP; ++w) {
+      words[w] = RandomWord();
+      if (trial % 2 == 1)
+        words[w] &= RandomWord() & RandomWord();
+    }
+    for (int p = 0; p < PROTOS_PER_PROTO_SET; ++p) {
+      INT_PROTO_STRUCT &proto = proto_set->Protos[p];
+      proto.A = Random(256) - 128;
+      proto.B = Random(256);
+      proto.C = Random(256) - 128;
+      proto.Angle = Random(256);
+      for (int w = 0; w < WERDS_PER_CONFIG_VEC; ++w)
+        proto.Configs[w] = RandomWord();
+    }
+  }
+  return int_class;
+}
+
+int main(int argc, char **argv) {
+  srand(7);
+  const IntMatcherKernels *kernels = GetIntMatcherKernels();
+  printf("Kernels: %s\n", kernels == NULL ? "none" :
+         SIMDDetect::IsAVX2Available() ? "AVX2" : "SSE2");
+  IntegerMatcher scalar_matcher;
+  IntegerMatcher simd_matcher;
+  scalar_matcher.Init();
+  simd_matcher.Init();
+  INT_FEATURE_ARRAY features;
+  uinT32 proto_mask[MAX_NUM_PROTOS / 32];
+  uinT32 config_mask[WERDS_PER_CONFIG_VEC];
+  PROTO_ID scalar_protos[MAX_NUM_PROTOS];
+  PROTO_ID simd_protos[MAX_NUM_PROTOS];
+  FEATURE_ID scalar_features[MAX_NUM_INT_FEATURES];
+  FEATURE_ID simd_features[MAX_NUM_INT_FEATURES];
+
+  int num_failures = 0;
+  for (int trial = 0; trial < kNumTrials; ++trial) {
+    INT_CLASS int_class = RandomClass(trial);
+    int num_features = 1 + Random(MAX_NUM_INT_FEATURES);
+    for (int f = 0; f < num_features; ++f) {
+      features[f].X = Random(256);
+      features[f].Y = Random(256);
+      features[f].Theta = Random(256);
+    }
+    for (int i = 0; i < MAX_NUM_PROTOS / 32; ++i)
+      proto_mask[i] = trial & 1 ? ~0U : RandomWord();
+    for (int i = 0; i < WERDS_PER_CONFIG_VEC; ++i)
+      config_mask[i] = trial & 2 ? ~0U : RandomWord();
+    if (trial % 4 == 0) {
+      scalar_matcher.SetBaseLineMatch();
+      simd_matcher.SetBaseLineMatch();
+    } else {
+      scalar_matcher.SetCharNormMatch();
+      simd_matcher.SetCharNormMatch();
+    }
+
+    INT_RESULT_STRUCT scalar_result, simd_result;
+    classify_im_use_simd.set_value(FALSE);
+    scalar_matcher.Match(int_class, proto_mask, config_mask, kBlobLength,
+                         num_features, features, kNormalizationFactor,
+                         &scalar_result, 0);
+    int num_scalar_protos = scalar_matcher.FindGoodProtos(
+        int_class, proto_mask, config_mask, kBlobLength, num_features,
+        features, scalar_protos, 0);
+    int num_scalar_features = scalar_matcher.FindBadFeatures(
+        int_class, proto_mask, config_mask, kBlobLength, num_features,
+        features, scalar_features, 0);
+    classify_im_use_simd.set_value(TRUE);
+    simd_matcher.Match(int_class, proto_mask, config_mask, kBlobLength,
+                       num_features, features, kNormalizationFactor,
+                       &simd_result, 0);
+    int num_simd_protos = simd_matcher.FindGoodProtos(
+        int_class, proto_mask, config_mask, kBlobLength, num_features,
+        features, simd_protos, 0);
+    int num_simd_features = simd_matcher.FindBadFeatures(
+        int_class, proto_mask, config_mask, kBlobLength, num_features,
+        features, simd_features, 0);
+
+    if (simd_result.Rating != scalar_result.Rating ||
+        simd_result.Config != scalar_result.Config ||
+        simd_result.Config2 != scalar_result.Config2 ||
+        simd_result.FeatureMisses != scalar_result.FeatureMisses) {
+      printf("Trial %d: Match gave %g/%d/%d/%d, expected %g/%d/%d/%d\n",
+             trial, simd_result.Rating, simd_result.Config,
+             simd_result.Config2, simd_result.FeatureMisses,
+             scalar_result.Rating, scalar_result.Config,
+             scalar_result.Config2, scalar_result.FeatureMisses);
+      ++num_failures;
+    }
+    if (num_simd_protos != num_scalar_protos ||
+        memcmp(simd_protos, scalar_protos,
+               sizeof(*simd_protos) * num_simd_protos) != 0) {
+      printf("Trial %d: FindGoodProtos differs (%d protos, expected %d)\n",
+             trial, num_simd_protos, num_scalar_protos);
+      ++num_failures;
+    }
+    if (num_simd_features != num_scalar_features ||
+        memcmp(simd_features, scalar_features,
+               sizeof(*simd_features) * num_simd_features) != 0) {
+      printf("Trial %d: FindBadFeatures differs (%d features, expected %d)\n",
+             trial, num_simd_features, num_scalar_features);
+      ++num_failures;
+    }
+    free_int_class(int_class);
+  }
+  printf("%d trials, %d failures\n", kNumTrials, num_failures);
+  return num_failures == 0 ? 0 : 1;
+}
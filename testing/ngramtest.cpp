@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////
+// File:        ngramtest.cpp
+// Description: Round trip of a character n-gram model through its file
+//              format.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Writes a trigram model with NgramModel::Write and reads it back, in the
+// byte order of the machine and in the other one. Checks that Cost gives
+// every transition and backoff of the model as they were written, up to
+// the quantization of the costs, and that truncated or foreign data is
+// rejected.
+
+#include <math.h>
+#include <stdio.h>
+
+#include "genericvector.h"
+#include "host.h"
+#include "ndminx.h"
+#include "ngrammodel.h"
+
+namespace tesseract {
+
+static const int kOrder = 3;
+// The characters of the model, with two outside ASCII. kUnknown is not in
+// the model.
+static const int kChars[] = { ' ', 'a', 'b', 'c', 'd', 0xe9, 0x4e2d };
+static const int kNumChars = sizeof(kChars) / sizeof(kChars[0]);
+static const int kUnknown = 'z';
+static const float kUnknownCost = 20.0f;
+static const float kMaxCost = 12.0f;
+
+// The model as it is written: the context of each state, as up to two
+// indices into kChars, and its backoff, and the transitions.
+struct TestModel {
+  GenericVector<int> first_chars;   // -1 for contexts shorter than 2
+  GenericVector<int> last_chars;    // -1 for the empty context
+  GenericVector<inT32> backoff_states;
+  GenericVector<float> backoff_costs;
+  GenericVector<NgramTransition> transitions;
+  float min_cost;
+  float max_cost;
+};
+
+// Returns the next number of a fixed pseudo-random sequence.
+static unsigned int Random(unsigned int *seed) {
+  *seed = *seed * 1103515245 + 12345;
+  return (*seed >> 16) & 0x7fff;
+}
+
+// Returns a pseudo-random cost between 0 and kMaxCost.
+static float RandomCost(unsigned int *seed) {
+  return kMaxCost * Random(seed) / 0x7fff;
+}
+
+// Returns the state of the given context, or -1 if it is not a state.
+static int FindState(const TestModel &model, int first_char, int last_char) {
+  for (int i = 0; i < model.first_chars.size(); ++i) {
+    if (model.first_chars[i] == first_char &&
+        model.last_chars[i] == last_char)
+      return i;
+  }
+  return -1;
+}
+
+// Fills model with the empty context, all contexts of one character and
+// two thirds of those of two, and a pseudo-random set of transitions.
+// State 0 has no transition for the last character, so it costs the
+// unknown cost.
+static void MakeModel(TestModel *model) {
+  unsigned int seed = 1;
+  model->first_chars.push_back(-1);
+  model->last_chars.push_back(-1);
+  model->backoff_states.push_back(-1);
+  model->backoff_costs.push_back(RandomCost(&seed));
+  for (int c = 0; c < kNumChars; ++c) {
+    model->first_chars.push_back(-1);
+    model->last_chars.push_back(c);
+    model->backoff_states.push_back(0);
+    model->backoff_costs.push_back(RandomCost(&seed));
+  }
+  for (int c1 = 0; c1 < kNumChars; ++c1) {
+    for (int c2 = 0; c2 < kNumChars; ++c2) {
+      if ((c1 * kNumChars + c2) % 3 == 0) continue;
+      model->first_chars.push_back(c1);
+      model->last_chars.push_back(c2);
+      model->backoff_states.push_back(FindState(*model, -1, c2));
+      model->backoff_costs.push_back(RandomCost(&seed));
+    }
+  }
+  for (int state = 0; state < model->first_chars.size(); ++state) {
+    for (int c = 0; c < kNumChars; ++c) {
+      if (state == 0 ? c == kNumChars - 1 : Random(&seed) % 3 == 0)
+        continue;
+      NgramTransition transition;
+      transition.state = state;
+      transition.unicode = kChars[c];
+      transition.cost = RandomCost(&seed);
+      // The longest context that the character ends.
+      int next_state = FindState(*model, model->last_chars[state], c);
+      transition.next_state =
+          next_state >= 0 ? next_state : FindState(*model, -1, c);
+      model->transitions.push_back(transition);
+    }
+  }
+  model->min_cost = model->max_cost = model->backoff_costs[0];
+  for (int i = 0; i < model->backoff_costs.size(); ++i) {
+    model->min_cost = MIN(model->min_cost, model->backoff_costs[i]);
+    model->max_cost = MAX(model->max_cost, model->backoff_costs[i]);
+  }
+  for (int i = 0; i < model->transitions.size(); ++i) {
+    model->min_cost = MIN(model->min_cost, model->transitions[i].cost);
+    model->max_cost = MAX(model->max_cost, model->transitions[i].cost);
+  }
+}
+
+// Returns the cost of unicode after state in model, as NgramModel::Cost
+// gives it, but without the quantization of the costs. Sets *num_costs to
+// the number of quantized costs that it adds up.
+static float ExpectedCost(const TestModel &model, int state, int unicode,
+                          int *next_state, int *num_costs) {
+  float cost = 0.0f;
+  *num_costs = 0;
+  while (state >= 0) {
+    ++*num_costs;
+    for (int i = 0; i < model.transitions.size(); ++i) {
+      const NgramTransition &transition = model.transitions[i];
+      if (transition.state == state && transition.unicode == unicode) {
+        *next_state = transition.next_state;
+        return cost + transition.cost;
+      }
+    }
+    cost += model.backoff_costs[state];
+    state = model.backoff_states[state];
+  }
+  *next_state = 0;
+  return cost + kUnknownCost;
+}
+
+// Returns true if ngram_model gives the costs and next states of model for
+// each character, and one unknown one, after each state, printing the
+// first difference otherwise.
+static bool SameCosts(const TestModel &model, const NgramModel &ngram_model) {
+  if (ngram_model.order() != kOrder ||
+      ngram_model.num_states() != model.first_chars.size()) {
+    printf("Read a model of order %d with %d states\n", ngram_model.order(),
+           ngram_model.num_states());
+    return false;
+  }
+  // Each quantized cost is off by at most half a level.
+  float half_level = (model.max_cost - model.min_cost) / 255 / 2;
+  for (int state = 0; state < model.first_chars.size(); ++state) {
+    for (int c = 0; c <= kNumChars; ++c) {
+      int unicode = c < kNumChars ? kChars[c] : kUnknown;
+      int expected_next, next, num_costs;
+      float expected = ExpectedCost(model, state, unicode, &expected_next,
+                                    &num_costs);
+      float cost = ngram_model.Cost(state, unicode, &next);
+      if (next != expected_next ||
+          fabs(cost - expected) > num_costs * half_level + 1e-4f) {
+        printf("Cost of U+%04x after state %d is %g to state %d,"
+               " expected %g to state %d\n", unicode, state, cost, next,
+               expected, expected_next);
+        return false;
+      }
+    }
+  }
+  int expected_start, num_costs;
+  ExpectedCost(model, 0, ' ', &expected_start, &num_costs);
+  if (ngram_model.word_start_state() != expected_start) {
+    printf("Word start state is %d, expected %d\n",
+           ngram_model.word_start_state(), expected_start);
+    return false;
+  }
+  // "ab", U+00E9, U+4E2D and "z" in UTF-8.
+  const char kString[] = "ab\xc3\xa9\xe4\xb8\xadz";
+  const int kStringChars[] = { 'a', 'b', 0xe9, 0x4e2d, 'z' };
+  int expected_next = expected_start;
+  float expected = 0.0f;
+  for (int i = 0; i < 5; ++i) {
+    expected += ngram_model.Cost(expected_next, kStringChars[i],
+                                 &expected_next);
+  }
+  int next;
+  float cost = ngram_model.StringCost(expected_start, kString, &next);
+  if (next != expected_next || fabs(cost - expected) > 1e-4f) {
+    printf("StringCost is %g to state %d, expected %g to state %d\n",
+           cost, next, expected, expected_next);
+    return false;
+  }
+  return true;
+}
+
+// Writes data to a new temporary file, rewound for reading.
+static FILE *TempFile(const GenericVector<char> &data) {
+  FILE *file = tmpfile();
+  if (file != NULL) {
+    fwrite(&data[0], 1, data.size(), file);
+    rewind(file);
+  }
+  return file;
+}
+
+// Returns true if NgramModel::Read accepts the first length bytes of data,
+// reading them into ngram_model.
+static bool ReadModel(const GenericVector<char> &data, int length,
+                      NgramModel *ngram_model) {
+  GenericVector<char> prefix;
+  for (int i = 0; i < length; ++i)
+    prefix.push_back(data[i]);
+  FILE *file = TempFile(prefix);
+  if (file == NULL)
+    return false;
+  bool ok = ngram_model->Read(file, NULL);
+  fclose(file);
+  return ok;
+}
+
+}  // namespace tesseract
+
+int main(int argc, char **argv) {
+  using tesseract::NgramModel;
+  tesseract::TestModel model;
+  tesseract::MakeModel(&model);
+
+  FILE *file = tmpfile();
+  if (file == NULL ||
+      !NgramModel::Write(file, tesseract::kOrder, tesseract::kUnknownCost,
+                         model.backoff_states, model.backoff_costs,
+                         model.transitions)) {
+    printf("Failed to write the model\n");
+    return 1;
+  }
+  GenericVector<char> data;
+  rewind(file);
+  int ch;
+  while ((ch = fgetc(file)) != EOF)
+    data.push_back(static_cast<char>(ch));
+  fclose(file);
+
+  NgramModel ngram_model;
+  if (!tesseract::ReadModel(data, data.size(), &ngram_model) ||
+      !tesseract::SameCosts(model, ngram_model)) {
+    printf("Round trip failed\n");
+    return 1;
+  }
+
+  // The model is made of 32-bit words, so reversing the bytes of each one
+  // gives the file written on a machine of the other byte order.
+  GenericVector<char> swapped;
+  for (int i = 0; i < data.size(); ++i)
+    swapped.push_back(data[i - i % 4 + 3 - i % 4]);
+  NgramModel swapped_model;
+  if (!tesseract::ReadModel(swapped, swapped.size(), &swapped_model) ||
+      !tesseract::SameCosts(model, swapped_model)) {
+    printf("Round trip in the other byte order failed\n");
+    return 1;
+  }
+
+  for (int length = 0; length < data.size(); length += 4) {
+    NgramModel truncated;
+    if (tesseract::ReadModel(data, length, &truncated)) {
+      printf("Accepted a model truncated to %d of %d bytes\n", length,
+             data.size());
+      return 1;
+    }
+  }
+  GenericVector<char> bad_magic(data);
+  bad_magic[0] ^= 1;
+  NgramModel foreign;
+  if (tesseract::ReadModel(bad_magic, bad_magic.size(), &foreign)) {
+    printf("Accepted a model with a bad magic number\n");
+    return 1;
+  }
+  printf("Round trip of %d states and %d transitions in %d bytes passed\n",
+         model.backoff_states.size(), model.transitions.size(), data.size());
+  return 0;
+}
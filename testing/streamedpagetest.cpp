@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////
+// File:        streamedpagetest.cpp
+// Description: Checks that a page read in strips is recognized as the
+//              same page given as a whole.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// TessBaseAPI::SetImageStripSource segments a page as it is thresholded in
+// strips, so the thresholded page is never held as a whole. This test
+// recognizes intfxtest.tif once with SetImage and once from a
+// MemoryStripSource of the same pixels, at a few strip heights, and checks
+// that the text, the boxes and the UNLV text are the same. The words near
+// the edges of the page are rejected by their distance from the edges, and
+// the rejects show in the UNLV text, so a streamed page that lost its size
+// fails the test. The language is the first argument, or eng. The test is
+// skipped unless TESSDATA_PREFIX is set to the directory above the tessdata
+// that holds its traineddata, as Init exits if it cannot read the data.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "baseapi.h"
+#include "img.h"
+#include "imgs.h"
+#include "strngs.h"
+#include "stripthresholder.h"
+
+// Exit status that makes automake count the test as skipped.
+static const int kSkipped = 77;
+static const int kStripHeights[] = { 1, 7, tesseract::kDefaultStripHeight };
+static const int kNumStripHeights =
+    sizeof(kStripHeights) / sizeof(kStripHeights[0]);
+
+// The outputs of one recognition of the page.
+struct PageText {
+  STRING text;
+  STRING boxes;
+  STRING unlv;
+};
+
+// Gets the outputs of the image set in api into page. The adaptive
+// classifier is cleared first, so that every recognition starts the same.
+static void GetPageText(tesseract::TessBaseAPI* api, PageText* page) {
+  api->ClearAdaptiveClassifier();
+  char* text = api->GetUTF8Text();
+  page->text = text != NULL ? text : "";
+  delete [] text;
+  text = api->GetBoxText();
+  page->boxes = text != NULL ? text : "";
+  delete [] text;
+  text = api->GetUNLVText();
+  page->unlv = text != NULL ? text : "";
+  delete [] text;
+}
+
+// Returns the number of the outputs of actual that differ from expected.
+static int ComparePages(const char* name, const PageText& expected,
+                        const PageText& actual) {
+  int num_differences = 0;
+  if (strcmp(actual.text.string(), expected.text.string()) != 0) {
+    printf("%s: text \"%s\", expected \"%s\"\n", name,
+           actual.text.string(), expected.text.string());
+    ++num_differences;
+  }
+  if (strcmp(actual.boxes.string(), expected.boxes.string()) != 0) {
+    printf("%s: the boxes differ\n", name);
+    ++num_differences;
+  }
+  if (strcmp(actual.unlv.string(), expected.unlv.string()) != 0) {
+    printf("%s: UNLV text \"%s\", expected \"%s\"\n", name,
+           actual.unlv.string(), expected.unlv.string());
+    ++num_differences;
+  }
+  return num_differences;
+}
+
+int main(int argc, char **argv) {
+  const char *srcdir = getenv("srcdir");
+  STRING filename = srcdir != NULL ? srcdir : ".";
+  filename += "/intfxtest.tif";
+  IMAGE image;
+  if (image.read_header(filename.string()) != 0 || image.read(0) != 0) {
+    printf("Failed to read %s\n", filename.string());
+    return 1;
+  }
+  int bytes_per_line = check_legal_image_size(image.get_xsize(),
+                                              image.get_ysize(),
+                                              image.get_bpp());
+
+  const char* language = argc > 1 ? argv[1] : "eng";
+  const char* prefix = getenv("TESSDATA_PREFIX");
+  STRING traineddata = prefix != NULL ? prefix : "";
+  traineddata += "tessdata/";
+  traineddata += language;
+  traineddata += ".traineddata";
+  FILE* fp = prefix != NULL ? fopen(traineddata.string(), "rb") : NULL;
+  if (fp == NULL) {
+    printf("No TESSDATA_PREFIX with the traineddata of %s, skipped\n",
+           language);
+    return kSkipped;
+  }
+  fclose(fp);
+  tesseract::TessBaseAPI api;
+  if (api.Init(argv[0], language) != 0) {
+    printf("Failed to initialize %s\n", language);
+    return 1;
+  }
+  api.SetPageSegMode(tesseract::PSM_SINGLE_BLOCK);
+  api.SetImage(image.get_buffer(), image.get_xsize(), image.get_ysize(),
+               image.get_bpp() / 8, bytes_per_line);
+  PageText whole;
+  GetPageText(&api, &whole);
+  if (whole.text.length() == 0) {
+    printf("Nothing was recognized on the whole page\n");
+    return 1;
+  }
+
+  int num_differences = 0;
+  for (int i = 0; i < kNumStripHeights; ++i) {
+    tesseract::MemoryStripSource source(image.get_buffer(),
+                                        image.get_xsize(), image.get_ysize(),
+                                        image.get_bpp() / 8, bytes_per_line,
+                                        image.get_res());
+    api.SetImageStripSource(&source, kStripHeights[i]);
+    PageText streamed;
+    GetPageText(&api, &streamed);
+    char name[32];
+    snprintf(name, sizeof(name), "Strips of %d lines", kStripHeights[i]);
+    num_differences += ComparePages(name, whole, streamed);
+    api.Clear();
+  }
+  api.End();
+  printf("%d differences\n", num_differences);
+  return num_differences == 0 ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////
+// File:        wordarenatest.cpp
+// Description: Checks the scopes, reuse and per-thread state of the word
+//              arena.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// WordArena serves the allocations made inside a WordArenaScope from
+// blocks of its own, reuses freed structures of the same size and releases
+// everything when the outermost scope closes. This test checks that
+// allocations outside a scope and large ones come from the heap, that a
+// freed structure is handed out again, that only the outermost scope
+// releases the memory, and that structures of every size class keep their
+// contents while the scope is open. It then runs the same allocations in
+// several threads at once, each filling its structures with its own
+// pattern, and checks that the threads neither share memory nor counts.
+// With the arena compiled out, it only checks that everything comes from
+// the heap.
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "wordarena.h"
+
+using tesseract::WordArena;
+using tesseract::WordArenaScope;
+
+static const int kNumThreads = 4;
+static const int kNumStructs = 20000;
+static const int kMaxSize = 256;
+
+// Returns the number of failures of the allocations of one thread, whose
+// structures are filled with pattern.
+static int CheckAllocations(unsigned char pattern) {
+  int num_failures = 0;
+  inT64 arena_allocs = WordArena::arena_allocs();
+  inT64 heap_allocs = WordArena::heap_allocs();
+  void *ptr = WordArena::New(24);
+  WordArena::Delete(ptr, 24);
+  if (WordArena::heap_allocs() != heap_allocs + 1) {
+    printf("An allocation outside a scope did not come from the heap\n");
+    ++num_failures;
+  }
+
+  unsigned char **structs = new unsigned char *[kNumStructs];
+  for (int round = 0; round < 2; ++round) {
+    WordArenaScope scope;
+    {
+      // Only the outermost scope releases the memory.
+      WordArenaScope inner_scope;
+      ptr = WordArena::New(40);
+    }
+    WordArena::Delete(ptr, 40);
+    void *reused = WordArena::New(40);
+#ifndef DISABLE_WORD_ARENA
+    if (reused != ptr) {
+      printf("A freed structure was not reused\n");
+      ++num_failures;
+    }
+#endif
+    WordArena::Delete(reused, 40);
+    void *large = WordArena::New(kMaxSize + 1);
+    WordArena::Delete(large, kMaxSize + 1);
+
+    for (int i = 0; i < kNumStructs; ++i) {
+      int size = 1 + (i * 7) % kMaxSize;
+      structs[i] = static_cast<unsigned char *>(WordArena::New(size));
+      memset(structs[i], pattern ^ (i & 0xff), size);
+    }
+    // Free every third one and take the space again.
+    for (int i = 0; i < kNumStructs; i += 3)
+      WordArena::Delete(structs[i], 1 + (i * 7) % kMaxSize);
+    for (int i = 0; i < kNumStructs; i += 3) {
+      int size = 1 + (i * 7) % kMaxSize;
+      structs[i] = static_cast<unsigned char *>(WordArena::New(size));
+      memset(structs[i], pattern ^ (i & 0xff), size);
+    }
+    bool overwritten = false;
+    for (int i = 0; i < kNumStructs && !overwritten; ++i) {
+      int size = 1 + (i * 7) % kMaxSize;
+      for (int j = 0; j < size && !overwritten; ++j)
+        overwritten = structs[i][j] != (pattern ^ (i & 0xff));
+      if (overwritten) {
+        printf("Structure %d of size %d was overwritten\n", i, size);
+        ++num_failures;
+      }
+    }
+    for (int i = 0; i < kNumStructs; ++i)
+      WordArena::Delete(structs[i], 1 + (i * 7) % kMaxSize);
+  }
+  delete [] structs;
+
+  // Per round: 1 + 1 + kNumStructs + kNumStructs / 3 rounded up from the
+  // arena, and the large one from the heap.
+  inT64 expected = 2 * (2 + kNumStructs + (kNumStructs + 2) / 3);
+#ifdef DISABLE_WORD_ARENA
+  inT64 expected_arena = 0;
+  inT64 expected_heap = expected + 2 + 1;
+#else
+  inT64 expected_arena = expected;
+  inT64 expected_heap = 2 + 1;
+#endif
+  if (WordArena::arena_allocs() - arena_allocs != expected_arena ||
+      WordArena::heap_allocs() - heap_allocs != expected_heap) {
+    printf("Counted %lld arena and %lld heap allocations,"
+           " expected %lld and %lld\n",
+           static_cast<long long>(WordArena::arena_allocs() - arena_allocs),
+           static_cast<long long>(WordArena::heap_allocs() - heap_allocs),
+           static_cast<long long>(expected_arena),
+           static_cast<long long>(expected_heap));
+    ++num_failures;
+  }
+  return num_failures;
+}
+
+struct ThreadResult {
+  unsigned char pattern;
+  int num_failures;
+};
+
+static void *RunThread(void *arg) {
+  ThreadResult *result = static_cast<ThreadResult *>(arg);
+  result->num_failures = CheckAllocations(result->pattern);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  int num_failures = CheckAllocations(0x5a);
+
+  pthread_t threads[kNumThreads];
+  ThreadResult results[kNumThreads];
+  for (int t = 0; t < kNumThreads; ++t) {
+    results[t].pattern = 0x11 * (t + 1);
+    results[t].num_failures = 0;
+    if (pthread_create(&threads[t], NULL, RunThread, &results[t]) != 0) {
+      printf("Cannot start thread %d\n", t);
+      return 1;
+    }
+  }
+  for (int t = 0; t < kNumThreads; ++t) {
+    pthread_join(threads[t], NULL);
+    num_failures += results[t].num_failures;
+  }
+  printf("%d failures\n", num_failures);
+  return num_failures == 0 ? 0 : 1;
+}
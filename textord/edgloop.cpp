@@ -32,13 +32,6 @@ EXTERN BOOL_VAR (edges_show_paths, FALSE, "Draw raw outlines");
 EXTERN BOOL_VAR (edges_show_needles, FALSE, "Draw edge needles");
 EXTERN INT_VAR (edges_maxedgelength, 16000, "Max steps in any outline");
 
-#ifndef GRAPHICS_DISABLED
-static ScrollView* edge_win;          //window
-#endif
-static C_OUTLINE_IT *outline_it; //iterator
-static int short_edges;          //no of short ones
-static int long_edges;           //no of long ones
-
 /**********************************************************************
  * get_outlines
  *
@@ -56,10 +49,10 @@ DLLSYM void get_outlines(                      //edge detect
                          C_OUTLINE_IT *out_it  //output iterator
                         ) {
 #ifndef GRAPHICS_DISABLED
-  edge_win = window;             //set statics
+  block_edges(t_image, block, page_tr, out_it, window);
+#else
+  block_edges(t_image, block, page_tr, out_it, NULL);
 #endif
-  outline_it = out_it;
-  block_edges(t_image, block, page_tr);
   out_it->move_to_first ();
 #ifndef GRAPHICS_DISABLED
   if (window != NULL)
@@ -75,8 +68,10 @@ DLLSYM void get_outlines(                      //edge detect
  * Complete the edge by cleaning it up andapproximating it.
  **********************************************************************/
 
-void complete_edge(                  //clean and approximate
-                   CRACKEDGE *start  //start of loop
+void complete_edge(                      //clean and approximate
+                   ScrollView* window,   //for raw edges, or NULL
+                   CRACKEDGE *start,     //start of loop
+                   C_OUTLINE_IT *out_it  //output iterator
                   ) {
   ScrollView::Color colour;                 //colour to draw in
   inT16 looplength;              //steps in loop
@@ -87,9 +82,9 @@ void complete_edge(                  //clean and approximate
                                  //check length etc.
   colour = check_path_legal (start);
 #ifndef GRAPHICS_DISABLED
-  if (edges_show_paths) {
+  if (edges_show_paths && window != NULL) {
                                  //in red
-    draw_raw_edge(edge_win, start, colour);
+    draw_raw_edge(window, start, colour);
   }
 #endif
 
@@ -97,7 +92,7 @@ void complete_edge(                  //clean and approximate
     looplength = loop_bounding_box (start, botleft, topright);
     outline = new C_OUTLINE (start, botleft, topright, looplength);
                                  //add to list
-    outline_it->add_after_then_move (outline);
+    out_it->add_after_then_move (outline);
   }
 }
 
@@ -144,14 +139,10 @@ ScrollView::Color check_path_legal(                  //certify outline
 
   if ((chainsum != 4 && chainsum != -4)
   || edgept != start || length < MINEDGELENGTH) {
-    if (edgept != start) {
-      long_edges++;
+    if (edgept != start)
       return ScrollView::YELLOW;
-    }
-    else if (length < MINEDGELENGTH) {
-      short_edges++;
+    else if (length < MINEDGELENGTH)
       return ScrollView::MAGENTA;
-    }
     else {
       ED_ILLEGAL_SUM.error ("check_path_legal", TESSLOG, "chainsum=%d",
         chainsum);
@@ -734,6 +734,8 @@ float ydiffs[]                   /*diff from spline */
   float diff;                    /*difference from line */
   int startx;                    /*index of start blob */
   float partdiffs[MAXPARTS];     /*step between parts */
+  float drift;                   /*drift from spline */
+  float lastdelta;               /*previous delta */
 
   for (bestpart = 0; bestpart < MAXPARTS; bestpart++)
     partsizes[bestpart] = 0;     /*zero them all */
@@ -749,8 +751,8 @@ float ydiffs[]                   /*diff from spline */
         blobcoords[blobindex].left (),
         blobcoords[blobindex].bottom ());
     }
-    bestpart =
-      choose_partition(diff, partdiffs, bestpart, jumplimit, numparts);
+    bestpart = choose_partition(diff, partdiffs, bestpart, jumplimit,
+                                &drift, &lastdelta, numparts);
                                  /*record partition */
     partids[blobindex] = bestpart;
     partsizes[bestpart]++;       /*another in it */
@@ -766,8 +768,8 @@ float ydiffs[]                   /*diff from spline */
         blobcoords[blobindex].left (),
         blobcoords[blobindex].bottom ());
     }
-    bestpart =
-      choose_partition(diff, partdiffs, bestpart, jumplimit, numparts);
+    bestpart = choose_partition(diff, partdiffs, bestpart, jumplimit,
+                                &drift, &lastdelta, numparts);
                                  /*record partition */
     partids[blobindex] = bestpart;
     partsizes[bestpart]++;       /*another in it */
@@ -956,6 +958,8 @@ float ydiffs[]                   /*output */
  * choose_partition
  *
  * Choose a partition for the point and return the index.
+ * drift and lastdelta are kept by the caller from one point to the next,
+ * and are reset with the first point.
  **********************************************************************/
 
 int
@@ -964,32 +968,32 @@ register float diff,             /*diff from spline */
 float partdiffs[],               /*diff on all parts */
 int lastpart,                    /*last assigned partition */
 float jumplimit,                 /*new part threshold */
+float *drift,                    /*drift from spline */
+float *lastdelta,                /*previous delta */
 int *partcount                   /*no of partitions */
 ) {
   register int partition;        /*partition no */
   int bestpart;                  /*best new partition */
   float bestdelta;               /*best gap from a part */
-  static float drift;            /*drift from spline */
   float delta;                   /*diff from part */
-  static float lastdelta;        /*previous delta */
 
   if (lastpart < 0) {
     partdiffs[0] = diff;
     lastpart = 0;                /*first point */
-    drift = 0.0f;
-    lastdelta = 0.0f;
+    *drift = 0.0f;
+    *lastdelta = 0.0f;
   }
                                  /*adjusted diff from part */
-  delta = diff - partdiffs[lastpart] - drift;
+  delta = diff - partdiffs[lastpart] - *drift;
   if (textord_oldbl_debug) {
-    tprintf ("Diff=%.2f, Delta=%.3f, Drift=%.3f, ", diff, delta, drift);
+    tprintf ("Diff=%.2f, Delta=%.3f, Drift=%.3f, ", diff, delta, *drift);
   }
   if (ABS (delta) > jumplimit / 2) {
                                  /*delta on part 0 */
-    bestdelta = diff - partdiffs[0] - drift;
+    bestdelta = diff - partdiffs[0] - *drift;
     bestpart = 0;                /*0 best so far */
     for (partition = 1; partition < *partcount; partition++) {
-      delta = diff - partdiffs[partition] - drift;
+      delta = diff - partdiffs[partition] - *drift;
       if (ABS (delta) < ABS (bestdelta)) {
         bestdelta = delta;
         bestpart = partition;    /*part with nearest jump */
@@ -1001,7 +1005,7 @@ int *partcount                   /*no of partitions */
     && *partcount < MAXPARTS) {  /*and spare part left */
       bestpart = (*partcount)++; /*best was new one */
                                  /*start new one */
-      partdiffs[bestpart] = diff - drift;
+      partdiffs[bestpart] = diff - *drift;
       delta = 0.0f;
     }
   }
@@ -1010,11 +1014,11 @@ int *partcount                   /*no of partitions */
   }
 
   if (bestpart == lastpart
-    && (ABS (delta - lastdelta) < jumplimit / 2
+    && (ABS (delta - *lastdelta) < jumplimit / 2
     || ABS (delta) < jumplimit / 2))
                                  /*smooth the drift */
-    drift = (3 * drift + delta) / 3;
-  lastdelta = delta;
+    *drift = (3 * *drift + delta) / 3;
+  *lastdelta = delta;
 
   if (textord_oldbl_debug) {
     tprintf ("P=%d\n", bestpart);
@@ -124,6 +124,8 @@ register float diff,             /*diff from spline */
 float partdiffs[],               /*diff on all parts */
 int lastpart,                    /*last assigned partition */
 float jumplimit,                 /*new part threshold */
+float *drift,                    /*drift from spline */
+float *lastdelta,                /*previous delta */
 int *partcount                   /*no of partitions */
 );
 int partition_coords (           //find relevant coords
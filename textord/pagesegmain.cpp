@@ -46,6 +46,7 @@
 #include "baseapi.h"
 #include "tordmain.h"
 #include "tessvars.h"
+#include "stripthresholder.h"
 
 namespace tesseract {
 
@@ -60,6 +61,8 @@ const int kDefaultResolution = 300;
 // On return the blocks list owns all the constructed page layout.
 int Tesseract::SegmentPage(const STRING* input_file,
                            IMAGE* image, BLOCK_LIST* blocks) {
+  PageStageTimer timer(&page_stats, PS_SEGMENT_PAGE);
+  AllocSubsystemScope alloc_scope(AS_TEXTORD);
   int width = image->get_xsize();
   int height = image->get_ysize();
   int resolution = image->get_res();
@@ -73,29 +76,9 @@ int Tesseract::SegmentPage(const STRING* input_file,
   // Zero resolution messes up the algorithms, so make sure it is credible.
   if (resolution < kMinCredibleResolution)
     resolution = kDefaultResolution;
-  // Get page segmentation mode.
+  bool single_column = static_cast<int>(tessedit_pageseg_mode) > PSM_AUTO;
   PageSegMode pageseg_mode = static_cast<PageSegMode>(
-      static_cast<int>(tessedit_pageseg_mode));
-  // If a UNLV zone file can be found, use that instead of segmentation.
-  if (pageseg_mode != tesseract::PSM_AUTO &&
-      input_file != NULL && input_file->length() > 0) {
-    STRING name = *input_file;
-    const char* lastdot = strrchr(name.string(), '.');
-    if (lastdot != NULL)
-      name[lastdot - name.string()] = '\0';
-    read_unlv_file(name, width, height, blocks);
-  }
-  bool single_column = pageseg_mode > PSM_AUTO;
-  if (blocks->empty()) {
-    // No UNLV file present. Work according to the PageSegMode.
-    // First make a single block covering the whole image.
-    BLOCK_IT block_it(blocks);
-    BLOCK* block = new BLOCK("", TRUE, 0, 0, 0, 0, width, height);
-    block_it.add_to_end(block);
-  } else {
-    // UNLV file present. Use PSM_SINGLE_COLUMN.
-    pageseg_mode = PSM_SINGLE_COLUMN;
-  }
+      MakePageBlocks(input_file, width, height, blocks));
 
   TO_BLOCK_LIST land_blocks, port_blocks;
   TBOX page_box;
@@ -120,7 +103,7 @@ int Tesseract::SegmentPage(const STRING* input_file,
 
   if (port_blocks.empty()) {
     // AutoPageSeg was not used, so we need to find_components first.
-  find_components(blocks, &land_blocks, &port_blocks, &page_box);
+  find_components(image, blocks, &land_blocks, &port_blocks, &page_box);
   } else {
     // AutoPageSeg does not need to find_components as it did that already.
     page_box.set_left(0);
@@ -130,24 +113,98 @@ int Tesseract::SegmentPage(const STRING* input_file,
     // Filter_blobs sets up the TO_BLOCKs the same as find_components does.
     filter_blobs(page_box.topright(), &port_blocks, true);
   }
+  TextordBlocks(pageseg_mode, page_box, blocks, &land_blocks, &port_blocks);
+  return 0;
+}
 
-  TO_BLOCK_IT to_block_it(&port_blocks);
-  ASSERT_HOST(!port_blocks.empty());
+// Segment a page that is too large to hold in memory, which the thresholder
+// reads and thresholds in strips. The edges of the page are scanned strip
+// by strip and only the outlines found are kept, so the thresholded page
+// never exists as a whole. Auto page segmentation needs the whole image,
+// so PSM_AUTO and PSM_SINGLE_COLUMN are done as PSM_SINGLE_BLOCK, on the
+// blocks of a UNLV zone file if there is one.
+// On return the blocks list owns all the constructed page layout.
+int Tesseract::SegmentPageStreamed(const STRING* input_file,
+                                   StripThresholder* thresholder,
+                                   BLOCK_LIST* blocks) {
+  PageStageTimer timer(&page_stats, PS_SEGMENT_PAGE);
+  AllocSubsystemScope alloc_scope(AS_TEXTORD);
+  int width = thresholder->source()->width();
+  int height = thresholder->source()->height();
+  // page_image stays empty, so the readers of the page size get it here.
+  strip_page_width_ = width;
+  strip_page_height_ = height;
+  strip_page_resolution_ = thresholder->source()->resolution();
+  PageSegMode pageseg_mode = static_cast<PageSegMode>(
+      MakePageBlocks(input_file, width, height, blocks));
+  if (pageseg_mode <= PSM_SINGLE_COLUMN)
+    pageseg_mode = PSM_SINGLE_BLOCK;
+  deskew_ = FCOORD(1.0f, 0.0f);
+  reskew_ = FCOORD(1.0f, 0.0f);
+
+  TO_BLOCK_LIST land_blocks, port_blocks;
+  TBOX page_box;
+  if (!find_components_streamed(thresholder, blocks,
+                                &land_blocks, &port_blocks, &page_box))
+    return -1;
+  TextordBlocks(pageseg_mode, page_box, blocks, &land_blocks, &port_blocks);
+  return 0;
+}
+
+// Fill the empty blocks list with the blocks of the UNLV zone file of
+// input_file if there is one, or with a single block covering the page.
+// Returns the PageSegMode to use, which is PSM_SINGLE_COLUMN for a zone
+// file and tessedit_pageseg_mode otherwise.
+int Tesseract::MakePageBlocks(const STRING* input_file,
+                              int width, int height, BLOCK_LIST* blocks) {
+  // Get page segmentation mode.
+  PageSegMode pageseg_mode = static_cast<PageSegMode>(
+      static_cast<int>(tessedit_pageseg_mode));
+  // If a UNLV zone file can be found, use that instead of segmentation.
+  if (pageseg_mode != tesseract::PSM_AUTO &&
+      input_file != NULL && input_file->length() > 0) {
+    STRING name = *input_file;
+    const char* lastdot = strrchr(name.string(), '.');
+    if (lastdot != NULL)
+      name[lastdot - name.string()] = '\0';
+    read_unlv_file(name, width, height, blocks);
+  }
+  if (blocks->empty()) {
+    // No UNLV file present. Work according to the PageSegMode.
+    // First make a single block covering the whole image.
+    BLOCK_IT block_it(blocks);
+    BLOCK* block = new BLOCK("", TRUE, 0, 0, 0, 0, width, height);
+    block_it.add_to_end(block);
+  } else {
+    // UNLV file present. Use PSM_SINGLE_COLUMN.
+    pageseg_mode = PSM_SINGLE_COLUMN;
+  }
+  return pageseg_mode;
+}
+
+// Make the rows and words of the blocks from the blobs that have been
+// sorted into port_blocks, by the method that suits the PageSegMode.
+void Tesseract::TextordBlocks(int pageseg_mode, const TBOX& page_box,
+                              BLOCK_LIST* blocks, TO_BLOCK_LIST* land_blocks,
+                              TO_BLOCK_LIST* port_blocks) {
+  PageStageTimer timer(&page_stats, PS_TEXTORD);
+  TO_BLOCK_IT to_block_it(port_blocks);
+  ASSERT_HOST(!port_blocks->empty());
   TO_BLOCK* to_block = to_block_it.data();
   if (pageseg_mode <= PSM_SINGLE_BLOCK ||
       to_block->line_size < 2) {
     // For now, AUTO, SINGLE_COLUMN and SINGLE_BLOCK all map to the old
     // textord. The difference is the number of blocks and how the are made.
-    textord_page(page_box.topright(), blocks, &land_blocks, &port_blocks,
+    textord_page(page_box.topright(), blocks, land_blocks, port_blocks,
                  this);
   } else {
     // SINGLE_LINE, SINGLE_WORD and SINGLE_CHAR all need a single row.
     float gradient = make_single_row(page_box.topright(),
-                                     to_block, &port_blocks, this);
+                                     to_block, port_blocks, this);
     if (pageseg_mode == PSM_SINGLE_LINE) {
       // SINGLE_LINE uses the old word maker on the single line.
       make_words(page_box.topright(), gradient, blocks,
-                 &land_blocks, &port_blocks, this);
+                 land_blocks, port_blocks, this);
     } else {
       // SINGLE_WORD and SINGLE_CHAR cram all the blobs into a
       // single word, and in SINGLE_CHAR mode, all the outlines
@@ -156,7 +213,6 @@ int Tesseract::SegmentPage(const STRING* input_file,
                        to_block->get_rows(), to_block->block->row_list());
     }
   }
-  return 0;
 }
 
 // Auto page segmentation. Divide the page image into blocks of uniform
@@ -219,7 +275,7 @@ int Tesseract::AutoPageSeg(int width, int height, int resolution,
   TO_BLOCK_LIST land_blocks, port_blocks;
   TBOX page_box;
   // The rest of the algorithm uses the usual connected components.
-  find_components(blocks, &land_blocks, &port_blocks, &page_box);
+  find_components(image, blocks, &land_blocks, &port_blocks, &page_box);
 
   TO_BLOCK_IT to_block_it(&port_blocks);
   ASSERT_HOST(!to_block_it.empty());
@@ -32,8 +32,76 @@
 #define XMARGIN       2          //margin needed
 #define YMARGIN       3          //by edge detector
 
-                                 /*local freelist */
-static CRACKEDGE *free_cracks = NULL;
+/**********************************************************************
+ * BLOCK_EDGE_SCANNER::BLOCK_EDGE_SCANNER
+ *
+ * Start scanning a block, with nothing in progress.
+ **********************************************************************/
+
+BLOCK_EDGE_SCANNER::BLOCK_EDGE_SCANNER(                      //scan a block
+                                       PDBLK *blk,           //block in image
+                                       C_OUTLINE_IT *out,    //output
+                                       ScrollView* win       //for raw edges
+                                      )
+: line_it(blk) {
+  inT16 x;                       //line coords
+
+  block = blk;
+  out_it = out;
+  window = win;
+  free_cracks = NULL;
+  block->bounding_box (bleft, tright);
+  ptrline = new CRACKEDGE*[tright.x () - bleft.x () + 1];
+  for (x = tright.x () - bleft.x (); x >= 0; x--)
+    ptrline[x] = NULL;           //no lines in progress
+}
+
+
+BLOCK_EDGE_SCANNER::~BLOCK_EDGE_SCANNER() {
+  delete [] ptrline;
+  free_crackedges(free_cracks);  //really free them
+}
+
+
+/**********************************************************************
+ * BLOCK_EDGE_SCANNER::scan_line
+ *
+ * Scan line y of the block, whose thresholded pixels start at the left
+ * edge of the block. The pixels outside the block are set to margin.
+ * Lines must be given in order from the top of the block down.
+ **********************************************************************/
+
+void BLOCK_EDGE_SCANNER::scan_line(               //add a line
+                                   inT16 y,       //line coord
+                                   uinT8 *pixels  //from block left
+                                  ) {
+  make_margins (block, &line_it, pixels, WHITE_PIX, bleft.x (),
+    tright.x (), y);
+  line_edges (bleft.x (), y, tright.x () - bleft.x (),
+    WHITE_PIX, pixels, ptrline);
+}
+
+
+/**********************************************************************
+ * BLOCK_EDGE_SCANNER::finish
+ *
+ * Close all the edges still open with a margin line below the block.
+ **********************************************************************/
+
+void BLOCK_EDGE_SCANNER::finish() {
+  inT16 x;                       //line coords
+  int xindex;                    //index to pixel
+  uinT8 *margin_line;            //all margin
+
+  x = tright.x () - bleft.x ();
+  margin_line = new uinT8[x + 1];
+  for (xindex = 0; xindex < x; xindex++)
+    margin_line[xindex] = WHITE_PIX;
+  line_edges (bleft.x (), bleft.y () - 1, x,
+    WHITE_PIX, margin_line, ptrline);
+  delete [] margin_line;
+}
+
 
 /**********************************************************************
  * block_edges
@@ -44,50 +112,26 @@ static CRACKEDGE *free_cracks = NULL;
 DLLSYM void block_edges(                      //get edges in a block
                         IMAGE *t_image,       //threshold image
                         PDBLK *block,         //block in image
-                        ICOORD page_tr        //corner of page
+                        ICOORD page_tr,       //corner of page
+                        C_OUTLINE_IT *out_it, //output iterator
+                        ScrollView* window    //for raw edges, or NULL
                        ) {
-  uinT8 margin;                  //margin colour
-  inT16 x;                       //line coords
   inT16 y;                       //current line
   ICOORD bleft;                  //bounding box
   ICOORD tright;
-  ICOORD block_bleft;            //bounding box
-  ICOORD block_tright;
-  int xindex;                    //index to pixel
-  BLOCK_LINE_IT line_it = block; //line iterator
   IMAGELINE bwline;              //thresholded line
-                                 //lines in progress
-  CRACKEDGE **ptrline = new CRACKEDGE*[t_image->get_xsize()+1];
-  block->bounding_box (bleft, tright); // block box
-  block_bleft = bleft;
-  block_tright = tright;
-  for (x = tright.x () - bleft.x (); x >= 0; x--)
-    ptrline[x] = NULL;           //no lines in progress
+  BLOCK_EDGE_SCANNER scanner(block, out_it, window);
 
+  block->bounding_box (bleft, tright); // block box
   bwline.init (t_image->get_xsize());
 
-  margin = WHITE_PIX;
-
-  for (y = tright.y () - 1; y >= bleft.y () - 1; y--) {
-    if (y >= block_bleft.y () && y < block_tright.y ()) {
-      t_image->get_line (bleft.x (), y, tright.x () - bleft.x (), &bwline,
-        0);
-      make_margins (block, &line_it, bwline.pixels, margin, bleft.x (),
-        tright.x (), y);
-    }
-    else {
-      x = tright.x () - bleft.x ();
-      for (xindex = 0; xindex < x; xindex++)
-        bwline.pixels[xindex] = margin;
-    }
-    line_edges (bleft.x (), y, tright.x () - bleft.x (),
-      margin, bwline.pixels, ptrline);
-  }
-
-  free_crackedges(free_cracks);  //really free them
-  free_cracks = NULL;
-    delete [] ptrline;
+  for (y = tright.y () - 1; y >= bleft.y (); y--) {
+    t_image->get_line (bleft.x (), y, tright.x () - bleft.x (), &bwline,
+      0);
+    scanner.scan_line (y, bwline.pixels);
   }
+  scanner.finish ();
+}
 
 
 /**********************************************************************
@@ -181,14 +225,14 @@ void whiteout_block(                 //clean it
 
 
 /**********************************************************************
- * line_edges
+ * BLOCK_EDGE_SCANNER::line_edges
  *
  * Scan a line for edges and update the edges in progress.
  * When edges close into loops, send them for approximation.
  **********************************************************************/
 
 void
-line_edges (                     //scan for edges
+BLOCK_EDGE_SCANNER::line_edges ( //scan for edges
 inT16 x,                         //coord of line start
 inT16 y,                         //coord of line
 inT16 xext,                      //width of line
@@ -272,13 +316,13 @@ CRACKEDGE ** prevline            //edges in progress
 
 
 /**********************************************************************
- * h_edge
+ * BLOCK_EDGE_SCANNER::h_edge
  *
  * Create a new horizontal CRACKEDGE and join it to the given edge.
  **********************************************************************/
 
 CRACKEDGE *
-h_edge (                         //horizontal edge
+BLOCK_EDGE_SCANNER::h_edge (     //horizontal edge
 inT16 x,                         //xposition
 inT16 y,                         //y position
 inT8 sign,                       //sign of edge
@@ -332,13 +376,13 @@ CRACKEDGE * join                 //edge to join to
 
 
 /**********************************************************************
- * v_edge
+ * BLOCK_EDGE_SCANNER::v_edge
  *
  * Create a new vertical CRACKEDGE and join it to the given edge.
  **********************************************************************/
 
 CRACKEDGE *
-v_edge (                         //vertical edge
+BLOCK_EDGE_SCANNER::v_edge (     //vertical edge
 inT16 x,                         //xposition
 inT16 y,                         //y position
 inT8 sign,                       //sign of edge
@@ -391,16 +435,16 @@ CRACKEDGE * join                 //edge to join to
 
 
 /**********************************************************************
- * join_edges
+ * BLOCK_EDGE_SCANNER::join_edges
  *
  * Join 2 edges together. Send the outline for approximation when a
  * closed loop is formed.
  **********************************************************************/
 
-void join_edges(                   //join edge fragments
-                CRACKEDGE *edge1,  //edges to join
-                CRACKEDGE *edge2   //no specific order
-               ) {
+void BLOCK_EDGE_SCANNER::join_edges(     //join edge fragments
+                                    CRACKEDGE *edge1,  //edges to join
+                                    CRACKEDGE *edge2   //no specific order
+                                   ) {
   CRACKEDGE *tempedge;           //for exchanging
 
   if (edge1->pos.x () + edge1->stepx != edge2->pos.x ()
@@ -418,7 +462,7 @@ void join_edges(                   //join edge fragments
   //              edge2->next,edge2->prev);
   if (edge1->next == edge2) {
                                  //already closed
-    complete_edge(edge1);  //approximate it
+    complete_edge(window, edge1, out_it);  //approximate it
                                  //attach freelist to end
     edge1->prev->next = free_cracks;
     free_cracks = edge1;         //and free list
@@ -24,12 +24,77 @@
 #include          "scrollview.h"
 #include          "img.h"
 #include          "pdblock.h"
+#include          "coutln.h"
 #include          "crakedge.h"
 
+/**********************************************************************
+ * BLOCK_EDGE_SCANNER
+ *
+ * The scanner behind block_edges, for callers that produce the
+ * thresholded lines themselves. The lines of the block are fed from the
+ * top down, and outlines are approximated as soon as they close, so only
+ * the edges still open are kept from one line to the next. The crack
+ * edges of closed outlines are kept for reuse by the same scanner.
+ **********************************************************************/
+
+class BLOCK_EDGE_SCANNER
+{
+  public:
+    BLOCK_EDGE_SCANNER(                      //scan a block
+                       PDBLK *block,         //block in image
+                       C_OUTLINE_IT *out_it, //output
+                       ScrollView* window    //for raw edges, or NULL
+                      );
+    ~BLOCK_EDGE_SCANNER ();
+
+    void scan_line(               //add a line
+                   inT16 y,       //line coord
+                   uinT8 *pixels  //from block left
+                  );
+    void finish();  //close the bottom
+
+  private:
+    void line_edges (                //scan for edges
+    inT16 x,                         //coord of line start
+    inT16 y,                         //coord of line
+    inT16 xext,                      //width of line
+    uinT8 uppercolour,               //start of prev line
+    uinT8 * bwpos,                   //thresholded line
+    CRACKEDGE ** prevline            //edges in progress
+    );
+    CRACKEDGE *h_edge (              //horizontal edge
+    inT16 x,                         //xposition
+    inT16 y,                         //y position
+    inT8 sign,                       //sign of edge
+    CRACKEDGE * join                 //edge to join to
+    );
+    CRACKEDGE *v_edge (              //vertical edge
+    inT16 x,                         //xposition
+    inT16 y,                         //y position
+    inT8 sign,                       //sign of edge
+    CRACKEDGE * join                 //edge to join to
+    );
+    void join_edges(                   //join edge fragments
+                    CRACKEDGE *edge1,  //edges to join
+                    CRACKEDGE *edge2   //no specific order
+                   );
+
+    PDBLK *block;                //block being scanned
+    BLOCK_LINE_IT line_it;       //for old style
+    C_OUTLINE_IT *out_it;        //where outlines go
+    ScrollView* window;          //for raw edges
+    ICOORD bleft;                //bounding box
+    ICOORD tright;
+    CRACKEDGE **ptrline;         //lines in progress
+    CRACKEDGE *free_cracks;      //local freelist
+};
+
 DLLSYM void block_edges(                      //get edges in a block
                         IMAGE *t_image,       //threshold image
                         PDBLK *block,         //block in image
-                        ICOORD page_tr        //corner of page
+                        ICOORD page_tr,       //corner of page
+                        C_OUTLINE_IT *out_it, //output iterator
+                        ScrollView* window    //for raw edges, or NULL
                        );
 void make_margins(                         //get a line
                   PDBLK *block,            //block in image
@@ -44,30 +109,6 @@ void whiteout_block(                 //clean it
                     IMAGE *t_image,  //threshold image
                     PDBLK *block     //block in image
                    );
-void line_edges (                //scan for edges
-inT16 x,                         //coord of line start
-inT16 y,                         //coord of line
-inT16 xext,                      //width of line
-uinT8 uppercolour,               //start of prev line
-uinT8 * bwpos,                   //thresholded line
-CRACKEDGE ** prevline            //edges in progress
-);
-CRACKEDGE *h_edge (              //horizontal edge
-inT16 x,                         //xposition
-inT16 y,                         //y position
-inT8 sign,                       //sign of edge
-CRACKEDGE * join                 //edge to join to
-);
-CRACKEDGE *v_edge (              //vertical edge
-inT16 x,                         //xposition
-inT16 y,                         //y position
-inT8 sign,                       //sign of edge
-CRACKEDGE * join                 //edge to join to
-);
-void join_edges(                   //join edge fragments
-                CRACKEDGE *edge1,  //edges to join
-                CRACKEDGE *edge2   //no specific order
-               );
 void free_crackedges(                  //really free them
                      CRACKEDGE *start  //start of loop
                     );
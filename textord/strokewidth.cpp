@@ -110,7 +110,8 @@ void StrokeWidth::HandleClick(int x, int y) {
   while ((neighbour = radsearch.NextRadSearch()) != NULL) {
     TBOX nbox = neighbour->bounding_box();
     if (nbox.contains(click) && neighbour->cblob() != NULL) {
-      SetBlobStrokeWidth(true, neighbour);
+      // There is no page image here, so this shows the area estimate.
+      SetBlobStrokeWidth(NULL, true, neighbour);
       tprintf("Box (%d,%d)->(%d,%d): h-width=%.1f, v-width=%.1f p-width=%1.f\n",
               nbox.left(), nbox.bottom(), nbox.right(), nbox.top(),
               neighbour->horz_stroke_width(), neighbour->vert_stroke_width(),
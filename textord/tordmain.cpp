@@ -26,6 +26,7 @@
 #include          "blread.h"
 #include          "blobbox.h"
 #include          "edgblob.h"
+#include          "scanedg.h"
 #include          "drawtord.h"
 #include          "makerow.h"
 #include          "wordseg.h"
@@ -35,6 +36,7 @@
 #include          "tordmain.h"
 #include          "secname.h"
 #include "tesseractclass.h"
+#include "stripthresholder.h"
 
 // Some of the code in this file is dependent upon leptonica. If you don't
 // have it, you don't get this functionality.
@@ -92,29 +94,33 @@ EXTERN double_VAR (textord_blshift_xfraction, 9.99,
 "Min size of baseline shift");
 EXTERN STRING_EVAR (tessedit_image_ext, ".tif", "Externsion for image file");
 
-#ifndef EMBEDDED
-EXTERN clock_t previous_cpu;
-#endif
-
 extern BOOL_VAR_H (polygon_tess_approximation, TRUE,
 "Do tess poly instead of grey scale");
 
 #define MAX_NEAREST_DIST  600    //for block skew stats
 #define MAX_BLOB_TRANSITIONS100  //for nois stats
 
-extern IMAGE page_image;         //must be defined somewhere
 extern BOOL_VAR_H (interactive_mode, TRUE, "Run interactively?");
 extern /*"C" */ ETEXT_DESC *global_monitor;     //progress monitor
 
+static void sort_components(
+                            IMAGE *page_image,
+                            BLOCK_LIST *blocks,
+                            TO_BLOCK_LIST *land_blocks,
+                            TO_BLOCK_LIST *port_blocks,
+                            TBOX *page_box);
+
 /**********************************************************************
  * find_components
  *
- * Find the C_OUTLINEs of the connected components in each block, put them
- * in C_BLOBs, and filter them by size, putting the different size
- * grades on different lists in the matching TO_BLOCK in port_blocks.
+ * Find the C_OUTLINEs of the connected components of page_image in each
+ * block, put them in C_BLOBs, and filter them by size, putting the
+ * different size grades on different lists in the matching TO_BLOCK in
+ * port_blocks.
  **********************************************************************/
 
 void find_components(
+                       IMAGE *page_image,
                        BLOCK_LIST *blocks,
                        TO_BLOCK_LIST *land_blocks,
                        TO_BLOCK_LIST *port_blocks,
@@ -125,8 +131,8 @@ void find_components(
   PDBLK_C_IT pd_it = &pd_blocks; //iterator
   IMAGE thresh_image;            //thresholded
 
-  int width = page_image.get_xsize();
-  int height = page_image.get_ysize();
+  int width = page_image->get_xsize();
+  int height = page_image->get_ysize();
   if (width > MAX_INT16 || height > MAX_INT16) {
     tprintf("Input image too large! (%d, %d)\n", width, height);
     return;  // Can't handle it.
@@ -138,12 +144,8 @@ void find_components(
     global_monitor->ocr_alive = TRUE;
 
     set_global_loc_code(LOC_EDGE_PROG);
-    if (!page_image.white_high ())
-      invert_image(&page_image);
-
-#ifndef EMBEDDED
-    previous_cpu = clock ();
-#endif
+    if (!page_image->white_high ())
+      invert_image(page_image);
 
     for (block_it.mark_cycle_pt (); !block_it.cycled_list ();
     block_it.forward ()) {
@@ -151,9 +153,9 @@ void find_components(
     if (block->poly_block() == NULL ||
         block->poly_block()->IsText()) {
 #ifndef GRAPHICS_DISABLED
-      extract_edges(NULL, &page_image, &page_image, page_tr, block);
+      extract_edges(NULL, page_image, page_image, page_tr, block);
 #else
-      extract_edges(&page_image, &page_image, page_tr, block);
+      extract_edges(page_image, page_image, page_tr, block);
 #endif
       *page_box += block->bounding_box ();
     }
@@ -163,25 +165,215 @@ void find_components(
     global_monitor->progress = 10;
   }
 
-  assign_blobs_to_blocks2(blocks, land_blocks, port_blocks);
+  sort_components(page_image, blocks, land_blocks, port_blocks, page_box);
+}
+
+
+/**********************************************************************
+ * sort_components
+ *
+ * Put the blobs found in each block in the matching TO_BLOCK in
+ * port_blocks, sorted by size, as find_components does. page_image is
+ * used to measure the stroke widths, and may be NULL.
+ **********************************************************************/
+
+static void sort_components(
+                            IMAGE *page_image,
+                            BLOCK_LIST *blocks,
+                            TO_BLOCK_LIST *land_blocks,
+                            TO_BLOCK_LIST *port_blocks,
+                            TBOX *page_box) {
+  assign_blobs_to_blocks2(page_image, blocks, land_blocks, port_blocks);
   if (global_monitor != NULL)
     global_monitor->ocr_alive = TRUE;
   filter_blobs (page_box->topright (), land_blocks, textord_test_landscape);
-#ifndef EMBEDDED
-  previous_cpu = clock ();
-#endif
   filter_blobs (page_box->topright (), port_blocks, !textord_test_landscape);
   if (global_monitor != NULL)
     global_monitor->ocr_alive = TRUE;
 }
 
+
+/**********************************************************************
+ * STRIP_EDGES
+ *
+ * The edge scans of all the text blocks of a page that is thresholded
+ * one line at a time, from the top down.
+ **********************************************************************/
+
+class STRIP_EDGES
+{
+  public:
+    STRIP_EDGES(BLOCK_LIST *block_list, int page_height);
+    ~STRIP_EDGES ();
+
+    void scan_line(int row, uinT8 *pixels);  //row from top
+    void finish(TBOX *page_box);              //make the blobs
+
+  private:
+    int height;                  //of page
+    int block_count;             //no of text blocks
+    BLOCK **blocks;              //text blocks
+    C_OUTLINE_LIST *outlines;    //found in each block
+    C_OUTLINE_IT *out_its;       //to each list
+    BLOCK_EDGE_SCANNER **scanners;
+    uinT8 *line;                 //scratch line
+};
+
+
+STRIP_EDGES::STRIP_EDGES(BLOCK_LIST *block_list, int page_height) {
+  BLOCK_IT block_it = block_list;
+  BLOCK *block;
+  int width = 0;
+
+  height = page_height;
+  block_count = 0;
+  for (block_it.mark_cycle_pt (); !block_it.cycled_list ();
+       block_it.forward ()) {
+    block = block_it.data ();
+    if (block->poly_block () == NULL || block->poly_block ()->IsText ())
+      block_count++;
+  }
+  blocks = new BLOCK*[block_count];
+  outlines = new C_OUTLINE_LIST[block_count];
+  out_its = new C_OUTLINE_IT[block_count];
+  scanners = new BLOCK_EDGE_SCANNER*[block_count];
+  block_count = 0;
+  for (block_it.mark_cycle_pt (); !block_it.cycled_list ();
+       block_it.forward ()) {
+    block = block_it.data ();
+    if (block->poly_block () == NULL || block->poly_block ()->IsText ()) {
+      blocks[block_count] = block;
+      out_its[block_count].set_to_list (&outlines[block_count]);
+      scanners[block_count] =
+        new BLOCK_EDGE_SCANNER (block, &out_its[block_count], NULL);
+      if (block->bounding_box ().width () > width)
+        width = block->bounding_box ().width ();
+      block_count++;
+    }
+  }
+  line = new uinT8[width + 1];
+}
+
+
+STRIP_EDGES::~STRIP_EDGES() {
+  for (int b = 0; b < block_count; b++)
+    delete scanners[b];
+  delete [] scanners;
+  delete [] out_its;
+  delete [] outlines;
+  delete [] blocks;
+  delete [] line;
+}
+
+
+/**********************************************************************
+ * STRIP_EDGES::scan_line
+ *
+ * Give a thresholded line of the page to every block it crosses.
+ **********************************************************************/
+
+void STRIP_EDGES::scan_line(int row, uinT8 *pixels) {
+  inT16 y = height - 1 - row;    //tess coords
+  TBOX box;
+
+  for (int b = 0; b < block_count; b++) {
+    box = blocks[b]->bounding_box ();
+    if (y >= box.bottom () && y < box.top ()) {
+                                 //scan_line writes margins
+      memcpy (line, pixels + box.left (), box.width ());
+      scanners[b]->scan_line (y, line);
+    }
+  }
+}
+
+
+/**********************************************************************
+ * STRIP_EDGES::finish
+ *
+ * Close the scans and turn the outlines of each block into blobs.
+ **********************************************************************/
+
+void STRIP_EDGES::finish(TBOX *page_box) {
+  ICOORD bleft;                  //block box
+  ICOORD tright;
+
+  for (int b = 0; b < block_count; b++) {
+    scanners[b]->finish ();
+    blocks[b]->bounding_box (bleft, tright);
+    outlines_to_blobs (blocks[b], bleft, tright, &outlines[b]);
+    *page_box += blocks[b]->bounding_box ();
+  }
+}
+
+
+/**********************************************************************
+ * find_components_streamed
+ *
+ * As find_components, but for a page that is never held in memory as a
+ * whole: the thresholder reads it in strips and the edges of the blocks
+ * are scanned line by line as it goes. Returns FALSE if the page could
+ * not be read.
+ **********************************************************************/
+
+BOOL8 find_components_streamed(
+                       tesseract::StripThresholder *thresholder,
+                       BLOCK_LIST *blocks,
+                       TO_BLOCK_LIST *land_blocks,
+                       TO_BLOCK_LIST *port_blocks,
+                       TBOX *page_box) {
+  int width = thresholder->source ()->width ();
+  int height = thresholder->source ()->height ();
+  if (width > MAX_INT16 || height > MAX_INT16) {
+    tprintf("Input image too large! (%d, %d)\n", width, height);
+    return FALSE;  // Can't handle it.
+  }
+  if (global_monitor != NULL)
+    global_monitor->ocr_alive = TRUE;
+  set_global_loc_code(LOC_EDGE_PROG);
+
+  STRIP_EDGES edges(blocks, height);
+  Callback2<int, uinT8*>* line_callback =
+    NewPermanentCallback(&edges, &STRIP_EDGES::scan_line);
+  BOOL8 ok = thresholder->ThresholdToLines (line_callback);
+  delete line_callback;
+  edges.finish (page_box);
+  if (!ok) {
+    tprintf("Failed to read the image strips\n");
+    return FALSE;
+  }
+  if (global_monitor != NULL) {
+    global_monitor->ocr_alive = TRUE;
+    global_monitor->progress = 10;
+  }
+  // There is no page image to measure the stroke widths on.
+  sort_components(NULL, blocks, land_blocks, port_blocks, page_box);
+  return TRUE;
+}
+
 /**********************************************************************
  * SetBlobStrokeWidth
  *
- * Set the horizontal and vertical stroke widths in the blob.
+ * Set the horizontal and vertical stroke widths in the blob, measured on
+ * page_image, or from the area if page_image is NULL.
  **********************************************************************/
-void SetBlobStrokeWidth(bool debug, BLOBNBOX* blob) {
+/**********************************************************************
+ * SetBlobStrokeWidthFromArea
+ *
+ * Set both stroke widths in the blob to 2*area/perimeter.
+ **********************************************************************/
+static void SetBlobStrokeWidthFromArea(BLOBNBOX* blob) {
+  float width = 2.0f * blob->cblob()->area();
+  width /= blob->cblob()->perimeter();
+  blob->set_horz_stroke_width(width);
+  blob->set_vert_stroke_width(width);
+}
+
+void SetBlobStrokeWidth(IMAGE* page_image, bool debug, BLOBNBOX* blob) {
 #ifdef HAVE_LIBLEPT
+  if (page_image == NULL) {
+    SetBlobStrokeWidthFromArea(blob);
+    return;
+  }
   // Cut the blob rectangle into a Pix.
   // TODO(rays) make the page_image a Pix so this is more direct.
   const TBOX& box = blob->bounding_box();
@@ -189,7 +381,7 @@ void SetBlobStrokeWidth(bool debug, BLOBNBOX* blob) {
   int width = box.width();
   int height = box.height();
   blob_im.create(width, height, 1);
-  copy_sub_image(&page_image, box.left(), box.bottom(), width, height,
+  copy_sub_image(page_image, box.left(), box.bottom(), width, height,
                  &blob_im, 0, 0, false);
   Pix* pix = blob_im.ToPix();
   Pix* dist_pix = pixDistanceFunction(pix, 4, 8, L_BOUNDARY_BG);
@@ -297,10 +489,7 @@ void SetBlobStrokeWidth(bool debug, BLOBNBOX* blob) {
   }
 #else
   // Without leptonica present, use the 2*area/perimeter as an approximation.
-  float width = 2.0f * blob->cblob()->area();
-  width /= blob->cblob()->perimeter();
-  blob->set_horz_stroke_width(width);
-  blob->set_vert_stroke_width(width);
+  SetBlobStrokeWidthFromArea(blob);
 #endif
 }
 
@@ -312,6 +501,7 @@ void SetBlobStrokeWidth(bool debug, BLOBNBOX* blob) {
  **********************************************************************/
 
 void assign_blobs_to_blocks2(                             //split into groups
+                             IMAGE *page_image,           //for stroke widths
                              BLOCK_LIST *blocks,          //blocks to process
                              TO_BLOCK_LIST *land_blocks,  // ** unused **
                              TO_BLOCK_LIST *port_blocks   //output list
@@ -336,7 +526,7 @@ void assign_blobs_to_blocks2(                             //split into groups
     for (blob_it.mark_cycle_pt(); !blob_it.cycled_list(); blob_it.forward()) {
       blob = blob_it.extract ();
       newblob = new BLOBNBOX(blob);  // Convert blob to BLOBNBOX.
-      SetBlobStrokeWidth(false, newblob);
+      SetBlobStrokeWidth(page_image, false, newblob);
       port_box_it.add_after_then_move (newblob);
     }
 
@@ -348,7 +538,7 @@ void assign_blobs_to_blocks2(                             //split into groups
     for (blob_it.mark_cycle_pt(); !blob_it.cycled_list(); blob_it.forward()) {
       blob = blob_it.extract();
       newblob = new BLOBNBOX(blob);  // Convert blob to BLOBNBOX.
-      SetBlobStrokeWidth(false, newblob);
+      SetBlobStrokeWidth(page_image, false, newblob);
       port_box_it.add_after_then_move(newblob);
     }
 
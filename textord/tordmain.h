@@ -27,7 +27,10 @@
 #include          "blobbox.h"
 #include          "notdll.h"
 
+class IMAGE;
+
 namespace tesseract {
+class StripThresholder;
 class Tesseract;
 }
 
@@ -70,7 +73,6 @@ extern double_VAR_H (textord_blshift_xfraction, 9.99,
 "Min size of baseline shift");
                                  //xiaofan
 extern STRING_EVAR_H (tessedit_image_ext, ".tif", "Externsion for image file");
-extern clock_t previous_cpu;
 void make_blocks_from_blobs(                       //convert & textord
                             TBLOB *tessblobs,      //tess style input
                             const char *filename,  //blob file
@@ -79,12 +81,20 @@ void make_blocks_from_blobs(                       //convert & textord
                             BLOCK_LIST *blocks     //block list
                            );
 void find_components(  // find components in blocks
+                       IMAGE *page_image,
+                       BLOCK_LIST *blocks,
+                       TO_BLOCK_LIST *land_blocks,
+                       TO_BLOCK_LIST *port_blocks,
+                       TBOX *page_box);
+BOOL8 find_components_streamed(  // find components in strips
+                       tesseract::StripThresholder *thresholder,
                        BLOCK_LIST *blocks,
                        TO_BLOCK_LIST *land_blocks,
                        TO_BLOCK_LIST *port_blocks,
                        TBOX *page_box);
-void SetBlobStrokeWidth(bool debug, BLOBNBOX* blob);
+void SetBlobStrokeWidth(IMAGE* page_image, bool debug, BLOBNBOX* blob);
 void assign_blobs_to_blocks2(                             //split into groups
+                             IMAGE *page_image,           //for stroke widths
                              BLOCK_LIST *blocks,          //blocks to process
                              TO_BLOCK_LIST *land_blocks,  //rotated for landscape
                              TO_BLOCK_LIST *port_blocks   //output list
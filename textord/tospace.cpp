@@ -974,9 +974,9 @@ ROW *make_prop_words(                 //find lines
   inT16 current_within_xht_gap = MAX_INT16;
   inT16 next_within_xht_gap = MAX_INT16;
   inT16 word_count = 0;
-  static inT16 row_count = 0;
+  BOOL8 prev_gap_was_a_space = FALSE;
+  BOOL8 break_at_next_gap = FALSE;
 
-  row_count++;
   rep_char_it.set_to_list (&(row->rep_words));
   if (!rep_char_it.empty ()) {
     next_rep_char_word_right =
@@ -1093,7 +1093,8 @@ ROW *make_prop_words(                 //find lines
             make_a_word_break(row, blob_box, prev_gap_arg, prev_blob_box,
           current_gap, current_within_xht_gap,
                               next_blob_box, next_gap_arg,
-                              blanks, fuzzy_sp, fuzzy_non) ||
+                              blanks, fuzzy_sp, fuzzy_non,
+                              prev_gap_was_a_space, break_at_next_gap) ||
         box_it.at_first ()) {
           /* Form a new word out of the blobs collected */
           if (!blob_it.empty ()) {
@@ -1230,8 +1231,7 @@ ROW *make_prop_words(                 //find lines
     word_it.add_list_after (&words);
     real_row->recalc_bounding_box ();
     if (tosp_debug_level > 9) {
-      tprintf ("Row %d Made %d words in row ((%d,%d)(%d,%d))\n",
-        row_count,
+      tprintf ("Made %d words in row ((%d,%d)(%d,%d))\n",
         word_count,
         real_row->bounding_box ().left (),
         real_row->bounding_box ().bottom (),
@@ -1267,9 +1267,6 @@ ROW *make_blob_words(                 // find lines
   TBOX blob_box;                 // bounding box
   BLOBNBOX_IT box_it;            // iterator
   inT16 word_count = 0;
-  static inT16 row_count = 0;
-
-  row_count++;
 
   cblob_it.set_to_list(&cblobs);
   box_it.set_to_list(row->blob_list());
@@ -1319,8 +1316,7 @@ ROW *make_blob_words(                 // find lines
     word_it.add_list_after(&words);
     real_row->recalc_bounding_box();
     if (tosp_debug_level > 9) {
-      tprintf ("Row %d Made %d words in row ((%d,%d)(%d,%d))\n",
-        row_count,
+      tprintf ("Made %d words in row ((%d,%d)(%d,%d))\n",
         word_count,
         real_row->bounding_box().left(),
         real_row->bounding_box().bottom(),
@@ -1343,9 +1339,9 @@ BOOL8 make_a_word_break(               //decide on word break
                         inT16 next_gap,
                         uinT8 &blanks,
                         BOOL8 &fuzzy_sp,
-                        BOOL8 &fuzzy_non) {
-  static BOOL8 prev_gap_was_a_space = FALSE;
-  static BOOL8 break_at_next_gap = FALSE;
+                        BOOL8 &fuzzy_non,
+                        BOOL8 &prev_gap_was_a_space,  //state of the row
+                        BOOL8 &break_at_next_gap) {
   BOOL8 space;
   inT16 current_gap;
   float fuzzy_sp_to_kn_limit;
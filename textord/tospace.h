@@ -169,7 +169,9 @@ BOOL8 make_a_word_break(               //decide on word break
                         inT16 next_gap,
                         uinT8 &blanks,
                         BOOL8 &fuzzy_sp,
-                        BOOL8 &fuzzy_non);
+                        BOOL8 &fuzzy_non,
+                        BOOL8 &prev_gap_was_a_space,  //state of the row
+                        BOOL8 &break_at_next_gap);
 BOOL8 narrow_blob(TO_ROW *row, TBOX blob_box);
 BOOL8 wide_blob(TO_ROW *row, TBOX blob_box);
 BOOL8 suspected_punct_blob(TO_ROW *row, TBOX box);
@@ -252,7 +252,7 @@ void ReadTrainingSamples (
           for (i = 0; i < CharDesc->NumFeatureSets; i++)
             if (Type != i)
               FreeFeatureSet(CharDesc->FeatureSets[i]);
-          free (CharDesc);
+          Efree (CharDesc);
         }
 }	// ReadTrainingSamples
 
@@ -391,8 +391,8 @@ void FreeLabeledList (
 
 {
 	destroy (LabeledList->List);
-	free (LabeledList->Label);
-	free (LabeledList);
+	Efree (LabeledList->Label);
+	Efree (LabeledList);
 
 }	/* FreeLabeledList */
 
@@ -455,7 +455,7 @@ CLUSTERER *SetUpForClustering(
 		}
 		CharID++;
 	}
-	if ( Sample != NULL ) free( Sample );
+	if ( Sample != NULL ) Efree( Sample );
 	return( Clusterer );
 
 }	/* SetUpForClustering */
@@ -673,7 +673,7 @@ void FreeLabeledClassList (
 	iterate (ClassList) 		/* iterate thru all of the fonts */
 	{
 		MergeClass = (MERGE_CLASS) first_node (ClassList);
-		free (MergeClass->Label);
+		Efree (MergeClass->Label);
 		FreeClass(MergeClass->Class);
 		delete MergeClass;
 	}
@@ -447,7 +447,7 @@ LIST ReadTrainingSamples (
 		for (i = 0; i < CharDesc->NumFeatureSets; i++)
                   if (Type != i)
                     FreeFeatureSet(CharDesc->FeatureSets[i]);
-		free (CharDesc);
+		Efree (CharDesc);
         }
 	return (TrainingSamples);
 
@@ -0,0 +1,418 @@
+///////////////////////////////////////////////////////////////////////
+// File:        text2ngram.cpp
+// Description: Program to build a character n-gram model from a text file
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Given a UTF-8 text file, this program counts the character n-grams of
+// each line, with the words separated by single spaces and a space at each
+// end of the line, and writes the backoff model used by the ngram permuter
+// (see dict/ngrammodel.h). The probabilities are estimated with absolute
+// discounting, and the n-grams longer than one character that were seen
+// fewer than min_count times are left out, with their probability mass
+// given back to the shorter contexts. The result is meant to be named
+// <lang>.ngram and put in the traineddata file with combine_tessdata.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "genericvector.h"
+#include "ngrammodel.h"
+#include "strngs.h"
+#include "unichar.h"
+
+// An n-gram of up to order characters, with its counts and estimated
+// probability, and the statistics of the n-grams that follow it as a
+// context. The probability is only computed for the n-grams that are kept
+// in the model.
+struct NgramEntry {
+  int start;               // index of the first code in NgramTable::codes_
+  int length;              // number of codes
+  int count;
+  bool kept;
+  double prob;
+  int total;               // sum of the counts of the n-grams following it
+  int types;               // number of distinct n-grams following it
+  double kept_prob;        // sum of the probabilities of the kept n-grams
+  double kept_lower_prob;  // same, from the context without its first char
+  double alpha;            // backoff weight
+  int state;               // state in the model, or -1
+};
+
+// The codes of an n-gram and its index in an NgramTable, for sorting.
+struct NgramKey {
+  const int *codes;
+  int length;
+  int index;
+};
+
+// Open hash table of the n-grams, including the empty one, which is always
+// entry 0.
+class NgramTable {
+ public:
+  NgramTable();
+  ~NgramTable();
+
+  int size() const { return entries_.size(); }
+  NgramEntry &entry(int index) { return entries_[index]; }
+
+  // Returns the index of the n-gram of the given codes. If it is not in the
+  // table, adds it if add is true, and returns -1 otherwise.
+  int Find(const int *codes, int length, bool add);
+
+  // Fills keys with the n-grams sorted by length, then in the order of
+  // their codes, which is the order of the states and transitions of the
+  // model. The keys point into the table, so no n-gram may be added while
+  // they are in use.
+  void SortedKeys(GenericVector<NgramKey> *keys) const;
+
+ private:
+  // Returns the codes of entry, or NULL if it is the empty n-gram.
+  const int *CodesOf(const NgramEntry &entry) const {
+    return entry.length > 0 ? &codes_[entry.start] : NULL;
+  }
+  static uinT32 Hash(const int *codes, int length);
+  static int CompareKeys(const void *key1, const void *key2);
+  // Inserts entry index into slots_, growing it if it is getting full.
+  void Insert(int index);
+
+  GenericVector<int> codes_;
+  GenericVector<NgramEntry> entries_;
+  // Entry indices, with -1 for empty slots. The size is a power of 2.
+  int *slots_;
+  int num_slots_;
+};
+
+NgramTable::NgramTable() : num_slots_(1024) {
+  slots_ = new int[num_slots_];
+  memset(slots_, -1, sizeof(*slots_) * num_slots_);
+  Find(NULL, 0, true);
+}
+
+NgramTable::~NgramTable() {
+  delete [] slots_;
+}
+
+int NgramTable::Find(const int *codes, int length, bool add) {
+  int slot = Hash(codes, length) & (num_slots_ - 1);
+  for (; slots_[slot] >= 0; slot = (slot + 1) & (num_slots_ - 1)) {
+    const NgramEntry &entry = entries_[slots_[slot]];
+    if (entry.length == length &&
+        (length == 0 ||
+         memcmp(CodesOf(entry), codes, sizeof(*codes) * length) == 0))
+      return slots_[slot];
+  }
+  if (!add)
+    return -1;
+  NgramEntry entry;
+  entry.start = codes_.size();
+  entry.length = length;
+  entry.count = 0;
+  entry.kept = false;
+  entry.prob = 0.0;
+  entry.total = 0;
+  entry.types = 0;
+  entry.kept_prob = 0.0;
+  entry.kept_lower_prob = 0.0;
+  entry.alpha = 1.0;
+  entry.state = -1;
+  for (int i = 0; i < length; ++i)
+    codes_.push_back(codes[i]);
+  int index = entries_.push_back(entry);
+  Insert(index);
+  return index;
+}
+
+void NgramTable::SortedKeys(GenericVector<NgramKey> *keys) const {
+  keys->clear();
+  for (int i = 0; i < entries_.size(); ++i) {
+    NgramKey key;
+    key.codes = CodesOf(entries_[i]);
+    key.length = entries_[i].length;
+    key.index = i;
+    keys->push_back(key);
+  }
+  qsort(&(*keys)[0], keys->size(), sizeof(NgramKey), CompareKeys);
+}
+
+uinT32 NgramTable::Hash(const int *codes, int length) {
+  uinT64 hash = length;
+  for (int i = 0; i < length; ++i)
+    hash = (hash ^ static_cast<uinT32>(codes[i])) * 1099511628211ULL;
+  return static_cast<uinT32>(hash ^ (hash >> 32));
+}
+
+int NgramTable::CompareKeys(const void *key1, const void *key2) {
+  const NgramKey *ngram1 = static_cast<const NgramKey *>(key1);
+  const NgramKey *ngram2 = static_cast<const NgramKey *>(key2);
+  if (ngram1->length != ngram2->length)
+    return ngram1->length - ngram2->length;
+  for (int i = 0; i < ngram1->length; ++i) {
+    if (ngram1->codes[i] != ngram2->codes[i])
+      return ngram1->codes[i] < ngram2->codes[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+void NgramTable::Insert(int index) {
+  if (2 * (entries_.size() + 1) > num_slots_) {
+    // Keep the table at most half full.
+    delete [] slots_;
+    num_slots_ *= 2;
+    slots_ = new int[num_slots_];
+    memset(slots_, -1, sizeof(*slots_) * num_slots_);
+    for (int old_index = 0; old_index < index; ++old_index)
+      Insert(old_index);
+  }
+  const NgramEntry &entry = entries_[index];
+  int slot = Hash(CodesOf(entry), entry.length) & (num_slots_ - 1);
+  while (slots_[slot] >= 0)
+    slot = (slot + 1) & (num_slots_ - 1);
+  slots_[slot] = index;
+}
+
+static const int kDefaultOrder = 4;
+static const int kDefaultMinCount = 2;
+// Size of the pieces in which lines are read.
+static const int kReadBufferSize = 4096;
+
+// Appends the unicodes of the given line to codes, with the runs of white
+// space replaced by single spaces and a space at both ends.
+static void AppendLineCodes(const STRING &line, GenericVector<int> *codes) {
+  codes->clear();
+  codes->push_back(' ');
+  const char *utf8 = line.length() > 0 ? line.string() : "";
+  while (*utf8 != '\0') {
+    int step = UNICHAR::utf8_step(utf8);
+    if (step == 0) {
+      ++utf8;  // Skip bytes that are not UTF-8.
+      continue;
+    }
+    int unicode = UNICHAR(utf8, step).first_uni();
+    utf8 += step;
+    if (unicode == ' ' || unicode == '\t' || unicode == '\r' ||
+        unicode == '\n') {
+      if ((*codes)[codes->size() - 1] != ' ')
+        codes->push_back(' ');
+    } else {
+      codes->push_back(unicode);
+    }
+  }
+  if ((*codes)[codes->size() - 1] != ' ')
+    codes->push_back(' ');
+}
+
+// Reads one line of file into line, with its newline if it has one.
+// Returns false at the end of the file.
+static bool ReadLine(FILE *file, STRING *line) {
+  *line = "";
+  char buffer[kReadBufferSize];
+  while (fgets(buffer, sizeof(buffer), file) != NULL) {
+    *line += buffer;
+    if (line->length() > 0 && (*line)[line->length() - 1] == '\n')
+      break;
+  }
+  return line->length() > 0;
+}
+
+// Returns the probability of unicode after the given context, backing off
+// to shorter contexts when the n-gram was not kept. The probabilities and
+// backoff weights of the contexts shorter than context must be known.
+static double Probability(NgramTable *table, int num_unigrams,
+                          const int *context, int context_length,
+                          int unicode) {
+  GenericVector<int> ngram;
+  for (int i = 0; i < context_length; ++i)
+    ngram.push_back(context[i]);
+  ngram.push_back(unicode);
+  int index = table->Find(&ngram[0], ngram.size(), false);
+  if (index >= 0 && table->entry(index).kept)
+    return table->entry(index).prob;
+  int context_index = table->Find(context, context_length, false);
+  double alpha = context_index >= 0 ? table->entry(context_index).alpha : 1.0;
+  if (context_length == 0)
+    return alpha / (num_unigrams + 1);
+  return alpha * Probability(table, num_unigrams, context + 1,
+                             context_length - 1, unicode);
+}
+
+// Returns the state of the longest suffix of the given n-gram that is a
+// context of the model, no longer than order - 1.
+static int StateOf(NgramTable *table, int order, const int *codes,
+                   int length) {
+  int start = length >= order ? length - order + 1 : 0;
+  for (; start < length; ++start) {
+    int index = table->Find(codes + start, length - start, false);
+    if (index >= 0 && table->entry(index).state >= 0)
+      return table->entry(index).state;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int order = kDefaultOrder;
+  int min_count = kDefaultMinCount;
+  int arg = 1;
+  for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+    if (strcmp(argv[arg], "-o") == 0)
+      order = atoi(argv[arg + 1]);
+    else if (strcmp(argv[arg], "-c") == 0)
+      min_count = atoi(argv[arg + 1]);
+    else
+      break;
+  }
+  if (argc - arg != 2 || order < 1 || min_count < 1) {
+    printf("Usage: %s [-o order] [-c min_count] text_file ngram_file\n",
+           argv[0]);
+    return 1;
+  }
+  const char* text_filename = argv[arg];
+  const char* ngram_filename = argv[arg + 1];
+
+  FILE *text_file = fopen(text_filename, "r");
+  if (text_file == NULL) {
+    printf("Failed to open text file '%s'\n", text_filename);
+    return 1;
+  }
+  printf("Counting %d-grams in '%s'\n", order, text_filename);
+  NgramTable table;
+  STRING line;
+  GenericVector<int> codes;
+  while (ReadLine(text_file, &line)) {
+    AppendLineCodes(line, &codes);
+    if (codes.size() < 2)
+      continue;  // Blank line.
+    for (int end = 1; end <= codes.size(); ++end) {
+      for (int length = 1; length <= order && length <= end; ++length)
+        ++table.entry(table.Find(&codes[end - length], length, true)).count;
+    }
+  }
+  fclose(text_file);
+  // Every prefix of a counted n-gram is counted too, so the contexts are
+  // all in the table, and it does not change from here on.
+  GenericVector<NgramKey> keys;
+  table.SortedKeys(&keys);
+  // The keys of the n-grams of each length start at length_starts[length].
+  GenericVector<int> length_starts;
+  for (int i = 0; i < keys.size(); ++i) {
+    while (length_starts.size() <= keys[i].length)
+      length_starts.push_back(i);
+  }
+  while (length_starts.size() <= order + 1)
+    length_starts.push_back(keys.size());
+  int num_unigrams = length_starts[2] - length_starts[1];
+  if (num_unigrams == 0) {
+    printf("No text in '%s'\n", text_filename);
+    return 1;
+  }
+
+  // Estimate the probabilities, shortest n-grams first, since those of
+  // each length are interpolated with the shorter ones.
+  for (int length = 1; length <= order; ++length) {
+    int count_of_counts[3] = { 0, 0, 0 };
+    int k;
+    for (k = length_starts[length]; k < length_starts[length + 1]; ++k) {
+      NgramEntry &ngram = table.entry(keys[k].index);
+      if (ngram.count <= 2)
+        ++count_of_counts[ngram.count];
+      NgramEntry &context =
+          table.entry(table.Find(keys[k].codes, length - 1, false));
+      context.total += ngram.count;
+      ++context.types;
+      ngram.kept = length == 1 || ngram.count >= min_count;
+    }
+    double discount = 0.5;
+    if (count_of_counts[1] + count_of_counts[2] > 0) {
+      discount = static_cast<double>(count_of_counts[1]) /
+          (count_of_counts[1] + 2 * count_of_counts[2]);
+      if (discount < 0.1) discount = 0.1;
+      if (discount > 0.9) discount = 0.9;
+    }
+    for (k = length_starts[length]; k < length_starts[length + 1]; ++k) {
+      NgramEntry &ngram = table.entry(keys[k].index);
+      if (!ngram.kept)
+        continue;
+      NgramEntry &context =
+          table.entry(table.Find(keys[k].codes, length - 1, false));
+      int unicode = keys[k].codes[length - 1];
+      double lower_prob = 1.0 / (num_unigrams + 1);
+      if (length > 1) {
+        lower_prob = Probability(&table, num_unigrams, keys[k].codes + 1,
+                                 length - 2, unicode);
+      }
+      ngram.prob = (ngram.count - discount) / context.total +
+          discount * context.types / context.total * lower_prob;
+      context.kept_prob += ngram.prob;
+      context.kept_lower_prob += lower_prob;
+    }
+    // The backoff weight gives the mass left by the kept n-grams to the
+    // others, in proportion to their probability in the shorter context.
+    for (k = length_starts[length - 1]; k < length_starts[length]; ++k) {
+      NgramEntry &context = table.entry(keys[k].index);
+      if (context.kept_prob == 0.0)
+        continue;
+      double left = 1.0 - context.kept_prob;
+      double lower_left = 1.0 - context.kept_lower_prob;
+      context.alpha = (left > 1e-6 ? left : 1e-6) /
+          (lower_left > 1e-6 ? lower_left : 1e-6);
+    }
+  }
+
+  // The contexts followed by kept n-grams become the states of the model,
+  // with the empty context first.
+  GenericVector<int> state_keys;
+  for (int k = 0; k < length_starts[order]; ++k) {
+    NgramEntry &context = table.entry(keys[k].index);
+    if (context.kept_prob > 0.0)
+      context.state = state_keys.push_back(k);
+  }
+  GenericVector<inT32> backoff_states;
+  GenericVector<float> backoff_costs;
+  for (int i = 0; i < state_keys.size(); ++i) {
+    const NgramKey &key = keys[state_keys[i]];
+    backoff_states.push_back(key.length == 0 ? -1 :
+        StateOf(&table, order, key.codes + 1, key.length - 1));
+    backoff_costs.push_back(-log(table.entry(key.index).alpha) / log(2.0));
+  }
+  GenericVector<tesseract::NgramTransition> transitions;
+  for (int k = length_starts[1]; k < length_starts[order + 1]; ++k) {
+    const NgramKey &key = keys[k];
+    const NgramEntry &ngram = table.entry(key.index);
+    if (!ngram.kept)
+      continue;
+    tesseract::NgramTransition transition;
+    transition.state =
+        table.entry(table.Find(key.codes, key.length - 1, false)).state;
+    transition.unicode = key.codes[key.length - 1];
+    transition.cost = -log(ngram.prob) / log(2.0);
+    transition.next_state = StateOf(&table, order, key.codes, key.length);
+    transitions.push_back(transition);
+  }
+
+  printf("Writing a model with %d states and %d transitions to '%s'\n",
+         state_keys.size(), transitions.size(), ngram_filename);
+  FILE *ngram_file = fopen(ngram_filename, "wb");
+  if (ngram_file == NULL ||
+      !tesseract::NgramModel::Write(ngram_file, order,
+                                    log(num_unigrams + 1.0) / log(2.0),
+                                    backoff_states, backoff_costs,
+                                    transitions)) {
+    printf("Failed to write '%s'\n", ngram_filename);
+    return 1;
+  }
+  fclose(ngram_file);
+  return 0;
+}
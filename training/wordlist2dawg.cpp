@@ -24,41 +24,61 @@
 
 #include "classify.h"
 #include "dawg.h"
+#include "dawgbuilder.h"
 #include "emalloc.h"
 #include "freelist.h"
-#include "trie.h"
 #include "unicharset.h"
 
-static const int kMaxNumEdges =  10000000;
+static void Usage(const char* program) {
+  printf("Usage: %s [-t] [-j num_threads] word_list_file dawg_file"
+         " unicharset_file\n", program);
+  printf("  -t checks the words of word_list_file against dawg_file.\n");
+  printf("  -j sorts an unsorted word list with up to num_threads threads"
+         " (default: the number of processors).\n");
+}
 
 int main(int argc, char** argv) {
-  if (!(argc == 4 || (argc == 5 && strcmp(argv[1], "-t") == 0))) {
-    printf("Usage: %s [-t] word_list_file dawg_file unicharset_file", argv[0]);
+  bool check = false;
+  int num_threads = tesseract::CCUtilThread::NumProcessors();
+  int argv_index = 1;
+  for (; argv_index < argc && argv[argv_index][0] == '-'; ++argv_index) {
+    if (strcmp(argv[argv_index], "-t") == 0) {
+      check = true;
+    } else if (strcmp(argv[argv_index], "-j") == 0 && argv_index + 1 < argc &&
+               atoi(argv[argv_index + 1]) > 0) {
+      num_threads = atoi(argv[++argv_index]);
+    } else {
+      Usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - argv_index != 3) {
+    Usage(argv[0]);
     return 1;
   }
   tesseract::Classify classify;
-  int argv_index = 0;
-  if (argc == 5) ++argv_index;
-  const char* wordlist_filename = argv[++argv_index];
-  const char* dawg_filename = argv[++argv_index];
-  const char* unicharset_file = argv[++argv_index];
+  const char* wordlist_filename = argv[argv_index++];
+  const char* dawg_filename = argv[argv_index++];
+  const char* unicharset_file = argv[argv_index++];
   if (!classify.getDict().getUnicharset().load_from_file(unicharset_file)) {
     tprintf("Failed to load unicharset from '%s'\n", unicharset_file);
     return 1;
   }
   const UNICHARSET &unicharset = classify.getDict().getUnicharset();
-  if (argc == 4) {
-    tesseract::Trie trie(
+  if (!check) {
+    tesseract::DawgBuilder builder(
         // the first 3 arguments are not used in this case
-        tesseract::DAWG_TYPE_WORD, "", SYSTEM_DAWG_PERM,
-        kMaxNumEdges, unicharset.size());
+        tesseract::DAWG_TYPE_WORD, "", SYSTEM_DAWG_PERM, unicharset.size());
     printf("Reading word list from '%s'\n", wordlist_filename);
-    if (!trie.read_word_list(wordlist_filename, unicharset)) {
+    if (!builder.read_word_list(wordlist_filename, unicharset,
+                                num_threads)) {
       printf("Failed to read word list from '%s'\n", wordlist_filename);
       exit(1);
     }
-    printf("Reducing Trie to SquishedDawg\n");
-    tesseract::SquishedDawg *dawg = trie.trie_to_dawg();
+    builder.finish();
+    printf("Built a minimal DAWG with %d nodes and %d edges\n",
+           builder.num_states(), builder.num_edges());
+    tesseract::SquishedDawg *dawg = builder.to_squished_dawg();
     printf("Writing squished DAWG to '%s'\n", dawg_filename);
     dawg->write_squished_dawg(dawg_filename);
     delete dawg;
@@ -46,8 +46,6 @@ BOOL_VAR(force_word_assoc, FALSE,
          "always force associator to run, independent of what enable_assoc is."
          "This is used for CJK where component grouping is necessary.");
 
-EVALUATION_ARRAY last_segmentation;
-
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
@@ -81,7 +81,6 @@ typedef EVALUATION_RECORD EVALUATION_ARRAY[MAX_NUM_CHUNKS];
 /*----------------------------------------------------------------------
               V a r i a b l e s
 ----------------------------------------------------------------------*/
-extern EVALUATION_ARRAY last_segmentation;
 extern WIDTH_RECORD *char_widths;
 extern BOOL_VAR_H(wordrec_enable_assoc, 1, "Associator Enable");
 extern BOOL_VAR_H(force_word_assoc, FALSE,
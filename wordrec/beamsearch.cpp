@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////
+// File:        beamsearch.cpp
+// Description: Beam search of the segmentations of a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "beamsearch.h"
+
+#include "bestfirst.h"
+#include "dict.h"
+#include "freelist.h"
+#include "genericvector.h"
+#include "globals.h"
+#include "ndminx.h"
+#include "pagestats.h"
+#include "permute.h"
+#include "tordvars.h"
+#include "wordrec.h"
+
+BOOL_VAR(wordrec_beam_search, FALSE,
+         "Segment words with a beam search of the ratings matrix"
+         " instead of the best first search");
+
+INT_VAR(wordrec_beam_width, 0,
+        "Number of partial segmentations kept at each chunk by the"
+        " segmentation beam search, 0 to follow the accuracy vs"
+        " speed hint");
+
+INT_VAR(wordrec_beam_max_span, 6,
+        "Most chunks joined into one character by the segmentation"
+        " beam search");
+
+double_VAR(wordrec_beam_nonword_penalty, 1.25,
+           "Rating multiplier of the partial segmentations of the"
+           " beam search that are not in any dictionary");
+
+namespace tesseract {
+
+typedef GenericVector<BeamEntry*> BeamEntryVector;
+
+int BeamWidthForAccuracyVSpeed(int accuracyvspeed) {
+  int speed = MIN(MAX(accuracyvspeed, 0), 100);
+  return kMinBeamWidth + (kMaxBeamWidth - kMinBeamWidth) * speed / 100;
+}
+
+// Adds entry to beam if the beam has fewer than width entries, or in
+// place of its worst entry if entry costs less. Returns false if entry was
+// not added. The caller keeps ownership of the entries in either case.
+static bool AddToBeam(BeamEntry *entry, int width, BeamEntryVector *beam) {
+  if (beam->size() < width) {
+    beam->push_back(entry);
+    return true;
+  }
+  int worst = 0;
+  for (int i = 1; i < beam->size(); ++i) {
+    if ((*beam)[i]->cost > (*beam)[worst]->cost)
+      worst = i;
+  }
+  if (entry->cost >= (*beam)[worst]->cost)
+    return false;
+  (*beam)[worst] = entry;
+  return true;
+}
+
+// Takes the dictionary search of parent one letter further, to the last
+// character of entry, and sets the dawg state and in_dawg of entry.
+// scratch is a word used to hand the letter to letter_is_okay, of which
+// only the letter at the index of the character is looked at.
+static void StepDawgs(Dict *dict, const BeamEntry &parent, bool word_end,
+                      WERD_CHOICE *scratch, BeamEntry *entry) {
+  entry->in_dawg = false;
+  entry->permuter = NO_PERM;
+  if (!parent.in_dawg)
+    return;
+  int index = dict->hyphen_base_size() + parent.length;
+  while (scratch->length() > index + 1)
+    scratch->remove_last_unichar_id();
+  while (scratch->length() <= index)
+    scratch->append_unichar_id(entry->unichar_id, 1, 0.0f, 0.0f);
+  scratch->set_unichar_id(entry->unichar_id, index);
+  // letter_is_okay does not change the vectors of the parent, but DawgArgs
+  // can only point at modifiable ones.
+  DawgArgs dawg_args(const_cast<DawgInfoVector*>(&parent.active_dawgs),
+                     const_cast<DawgInfoVector*>(&parent.constraints),
+                     &entry->active_dawgs, &entry->constraints, 0.0);
+  entry->permuter = (dict->*(dict->letter_is_okay_))(&dawg_args, index,
+                                                     scratch, word_end);
+  entry->in_dawg = entry->permuter != NO_PERM;
+}
+
+// Sets the joints of state between the characters of the complete
+// segmentation that ends with entry.
+static void EntryToState(const BeamEntry *entry, int num_joints,
+                         STATE *state) {
+  state->clear();
+  for (entry = entry->parent; entry != NULL && entry->end > 0;
+       entry = entry->parent)
+    state->set_bit(num_joints - entry->end, true);
+}
+
+// Sets word to the characters of the complete segmentation that ends with
+// entry, with their ratings and certainties, and certainties to the
+// certainty of each character.
+static void EntryToWord(const BeamEntry *entry, WERD_CHOICE *word,
+                        float certainties[]) {
+  GenericVector<const BeamEntry*> path;
+  for (; entry != NULL && entry->end > 0; entry = entry->parent)
+    path.push_back(entry);
+  *word = WERD_CHOICE();
+  for (int i = path.size() - 1; i >= 0; --i) {
+    certainties[word->length()] = path[i]->choice_certainty;
+    word->append_unichar_id(path[i]->unichar_id, 1, path[i]->choice_rating,
+                            path[i]->choice_certainty);
+  }
+}
+
+// Finds the best segmentation of the chunks of the word by a beam search
+// from left to right over the ratings matrix. The beam at each chunk
+// boundary keeps the wordrec_beam_width best segmentations of the chunks
+// before it, each with one choice per character, ranked by the sum of
+// their ratings and penalized once they leave the dictionary. Each entry
+// is extended by every piece of up to wordrec_beam_max_span chunks, with
+// its best kBeamChoicesPerPiece choices, and with any other choice that
+// keeps it in the dictionary. The complete segmentations left
+// in the last beam, up to pass_num_seg_states of them, are then made
+// into words from the choices and dawg states the beam already holds, and
+// rated with the adjustments of the dictionary permuters, without running
+// the permuters again. The cost of a word is thus bounded by its number of
+// chunks whatever the ratings. Only if the beam finds no complete
+// segmentation is the current one evaluated by the permuters instead.
+void Wordrec::beam_search(CHUNKS_RECORD *chunks_record,
+                          WERD_CHOICE *best_choice,
+                          WERD_CHOICE *raw_choice,
+                          STATE *state,
+                          DANGERR *fixpt,
+                          STATE *best_state) {
+  PageStageTimer timer(&page_stats, PS_BEAM_SEARCH);
+  Dict &dict = getDict();
+  const UNICHARSET &unicharset = dict.getUnicharset();
+  int num_chunks = chunks_record->ratings->dimension();
+  int width = wordrec_beam_width > 0 ? wordrec_beam_width :
+    MAX(beam_width_hint_, 1);
+  int max_span = MAX(wordrec_beam_max_span, 1);
+  int num_joints = num_chunks - 1;
+
+  SEARCH_RECORD *the_search = new_search(chunks_record, num_joints,
+                                         pass_num_seg_states, best_choice,
+                                         raw_choice, state,
+                                         &spare_closed_states_);
+  // As in best_first_search, give the initial best choice a poor rating so
+  // that the best segmentation replaces it.
+  the_search->best_choice->set_rating(100000.0);
+
+  // beams[i] holds the segmentations of the first i chunks. All entries
+  // are owned by all_entries.
+  BeamEntryVector all_entries;
+  BeamEntryVector *beams = new BeamEntryVector[num_chunks + 1];
+  BeamEntry *root = new BeamEntry;
+  dict.init_active_dawgs(&root->active_dawgs);
+  dict.init_constraints(&root->constraints);
+  all_entries.push_back(root);
+  beams[0].push_back(root);
+  WERD_CHOICE scratch;
+  BLOB_CHOICE_IT choice_it;
+
+  for (int start = 0; start < num_chunks; ++start) {
+    const BeamEntryVector &beam = beams[start];
+    if (beam.empty())
+      continue;
+    int last_end = MIN(start + max_span, num_chunks) - 1;
+    for (int end = start; end <= last_end && !tord_blob_skip; ++end) {
+      BLOB_CHOICE_LIST *choices =
+        get_piece_rating(chunks_record->ratings, chunks_record->chunks,
+                         chunks_record->splits, start, end);
+      if (choices == NULL || choices->empty())
+        continue;
+      bool word_end = end == num_chunks - 1;
+      int num_choices = 0;
+      choice_it.set_to_list(choices);
+      for (choice_it.mark_cycle_pt(); !choice_it.cycled_list();
+           choice_it.forward()) {
+        BLOB_CHOICE *choice = choice_it.data();
+        if (unicharset.get_fragment(choice->unichar_id()) != NULL)
+          continue;
+        // Beyond the best choices, only dictionary words are followed, as
+        // the dawg permuter would find them.
+        bool dawg_only = ++num_choices > kBeamChoicesPerPiece;
+        for (int b = 0; b < beam.size(); ++b) {
+          const BeamEntry *parent = beam[b];
+          if (dawg_only && !parent->in_dawg)
+            continue;
+          BeamEntry *entry = new BeamEntry;
+          entry->parent = parent;
+          entry->end = end + 1;
+          entry->length = parent->length + 1;
+          entry->unichar_id = choice->unichar_id();
+          entry->choice_rating = choice->rating();
+          entry->choice_certainty = choice->certainty();
+          entry->rating = parent->rating + choice->rating();
+          StepDawgs(&dict, *parent, word_end, &scratch, entry);
+          entry->cost = entry->in_dawg ? entry->rating :
+            entry->rating * wordrec_beam_nonword_penalty;
+          if (entry->length > MAX_WERD_LENGTH ||
+              (dawg_only && !entry->in_dawg) ||
+              !AddToBeam(entry, width, &beams[end + 1])) {
+            delete entry;
+          } else {
+            all_entries.push_back(entry);
+          }
+        }
+      }
+    }
+  }
+
+  // Rate the complete segmentations, best first, until the stopper accepts
+  // the best word. Those that differ only in their choices share a state,
+  // and only the best of them is rated.
+  BeamEntryVector &finals = beams[num_chunks];
+  WERD_CHOICE word;
+  float certainties[MAX_WERD_LENGTH + 1];
+  float adjust_factor;
+  PIECES_STATE widths;
+  bool any_rated = false;
+  bool keep_going = true;
+  for (int i = 0; keep_going && !tord_blob_skip && i < finals.size() &&
+       the_search->num_states < pass_num_seg_states; ++i) {
+    int best = i;
+    for (int j = i + 1; j < finals.size(); ++j) {
+      if (finals[j]->cost < finals[best]->cost)
+        best = j;
+    }
+    BeamEntry *entry = finals[best];
+    finals[best] = finals[i];
+    finals[i] = entry;
+    EntryToState(entry, num_joints, the_search->this_state);
+    if (segment_debug) {
+      tprintf("Beam segmentation %d cost %g%s\n", i, entry->cost,
+              entry->in_dawg ? " (dawg)" : "");
+      print_state("", the_search->this_state, num_joints);
+    }
+    if (hash_lookup(the_search->closed_states, the_search->this_state))
+      continue;
+    hash_add(the_search->closed_states, the_search->arena,
+             the_search->this_state);
+    the_search->num_states++;
+    page_stats.Count(PC_SEG_STATES);
+    any_rated = true;
+    bin_to_pieces(the_search->this_state, num_joints, widths);
+    dict.LogNewSegmentation(widths);
+
+    EntryToWord(entry, &word, certainties);
+    word.set_permuter(TOP_CHOICE_PERM);
+    if (word.rating() < the_search->raw_choice->rating()) {
+      *the_search->raw_choice = word;
+      the_search->raw_choice->populate_unichars(unicharset);
+      dict.LogNewChoice(word, 1.0, certainties, true);
+    }
+    if (entry->in_dawg) {
+      word.set_permuter(entry->permuter);
+      dict.adjust_word(&word, certainties);
+    } else {
+      dict.adjust_non_word(&word, &adjust_factor);
+      dict.LogNewChoice(word, adjust_factor, certainties, false);
+    }
+    if (word.rating() >= the_search->best_choice->rating()) {
+      fixpt->index = -1;
+      continue;
+    }
+    *the_search->best_choice = word;
+    the_search->best_choice->populate_unichars(unicharset);
+    *the_search->best_state = *the_search->this_state;
+    the_search->before_best = the_search->num_states;
+    // Look the choices of the new best segmentation up again, for its
+    // widths and for the stopper, as evaluate_state does.
+    SEARCH_STATE chunk_groups = bin_to_chunks(the_search->this_state,
+                                              num_joints);
+    BLOB_CHOICE_LIST_VECTOR *char_choices =
+      evaluate_chunks(chunks_record, chunk_groups);
+    if (char_choices != NULL) {
+      replace_char_widths(chunks_record, chunk_groups);
+      bool replaced = false;
+      if (dict.AcceptableChoice(char_choices, the_search->best_choice,
+                                *the_search->raw_choice, fixpt,
+                                ASSOCIATOR_CALLER, &replaced))
+        keep_going = false;
+      delete char_choices;
+    }
+    memfree(chunk_groups);
+  }
+
+  if (!any_rated) {
+    // The beam found no segmentation, so let the permuters rate the
+    // current one.
+    *the_search->this_state = *the_search->first_state;
+    evaluate_state(chunks_record, the_search, fixpt);
+  }
+
+  *state = *the_search->best_state;
+  all_entries.delete_data_pointers();
+  delete [] beams;
+  record_search_status(the_search->num_states, the_search->before_best);
+  delete_search(the_search, &spare_closed_states_);
+}
+
+}  // namespace tesseract
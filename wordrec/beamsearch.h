@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////
+// File:        beamsearch.h
+// Description: Beam search of the segmentations of a word.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_WORDREC_BEAMSEARCH_H__
+#define TESSERACT_WORDREC_BEAMSEARCH_H__
+
+#include "dawg.h"
+#include "unichar.h"
+#include "varable.h"
+
+extern BOOL_VAR_H(wordrec_beam_search, FALSE,
+                  "Segment words with a beam search of the ratings matrix"
+                  " instead of the best first search");
+
+extern INT_VAR_H(wordrec_beam_width, 0,
+                 "Number of partial segmentations kept at each chunk by the"
+                 " segmentation beam search, 0 to follow the accuracy vs"
+                 " speed hint");
+
+extern INT_VAR_H(wordrec_beam_max_span, 6,
+                 "Most chunks joined into one character by the segmentation"
+                 " beam search");
+
+extern double_VAR_H(wordrec_beam_nonword_penalty, 1.25,
+                    "Rating multiplier of the partial segmentations of the"
+                    " beam search that are not in any dictionary");
+
+namespace tesseract {
+
+// The number of choices of each piece that the beam search tries for any
+// word. Other choices are only tried where they continue a dictionary word.
+const int kBeamChoicesPerPiece = 3;
+// Widths of the beam for the fastest (and default) and the most accurate
+// settings of the accuracy vs speed hint, when wordrec_beam_width is 0.
+const int kMinBeamWidth = 8;
+const int kMaxBeamWidth = 32;
+
+// Returns the width of the beam for an accuracy vs speed hint from 0,
+// the fastest, to 100, the most accurate.
+int BeamWidthForAccuracyVSpeed(int accuracyvspeed);
+
+// A segmentation of the first chunks of a word, with one choice for each
+// of its characters. The entries of a word form a tree through parent,
+// and each carries the state of the dictionary search of its characters,
+// so that extending it by a character is a single letter_is_okay step.
+struct BeamEntry {
+  BeamEntry()
+    : parent(NULL), end(0), length(0), unichar_id(INVALID_UNICHAR_ID),
+      choice_rating(0.0f), choice_certainty(0.0f), rating(0.0f),
+      cost(0.0f), in_dawg(true), permuter(NO_PERM) {}
+
+  const BeamEntry *parent;      // The segmentation of the chunks before the
+                                // last character, or NULL.
+  int end;                      // The number of chunks covered.
+  int length;                   // The number of characters.
+  UNICHAR_ID unichar_id;        // The last character.
+  float choice_rating;          // Rating and certainty of the last
+  float choice_certainty;       // character.
+  float rating;                 // Sum of the ratings of the characters.
+  float cost;                   // rating, penalized if not in_dawg.
+  bool in_dawg;                 // Whether some dawg has all the characters.
+  uinT8 permuter;               // Permuter of the dawg, if in_dawg.
+  DawgInfoVector active_dawgs;  // Dawg state after the last character.
+  DawgInfoVector constraints;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_WORDREC_BEAMSEARCH_H__
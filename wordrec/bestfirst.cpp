@@ -54,10 +54,6 @@ void call_caller();
 /*----------------------------------------------------------------------
           V a r i a b l e s
 ---------------------------------------------------------------------*/
-int num_joints;                  /* Number of chunks - 1 */
-int num_pushed = 0;
-int num_popped = 0;
-
 INT_VAR(wordrec_num_seg_states, 30, "Segmentation states");
 
 double_VAR(wordrec_worst_state, 1, "Worst segmentation state");
@@ -83,10 +79,12 @@ void Wordrec::best_first_search(CHUNKS_RECORD *chunks_record,
   SEARCH_RECORD *the_search;
   inT16 keep_going;
   STATE guided_state;   // not used
+  int num_joints = chunks_record->ratings->dimension() - 1;
+  int num_popped = 0;
+  PageStageTimer timer(&page_stats, PS_BEST_FIRST);
 
-  num_joints = chunks_record->ratings->dimension() - 1;
-  the_search = new_search (chunks_record, num_joints,
-    best_choice, raw_choice, state);
+  the_search = new_search (chunks_record, num_joints, pass_num_seg_states,
+    best_choice, raw_choice, state, &spare_closed_states_);
 
   // The default state is initialized as the best choice.  In order to apply
   // segmentation adjustment, or any other contextual processing in permute,
@@ -115,22 +113,20 @@ void Wordrec::best_first_search(CHUNKS_RECORD *chunks_record,
                                  /* Look for answer */
     if (!hash_lookup (the_search->closed_states, the_search->this_state)) {
 
-      if (tord_blob_skip) {
-        free_state (the_search->this_state);
+      if (tord_blob_skip)
         break;
-      }
 
       guided_state = *(the_search->this_state);
       keep_going = evaluate_state(chunks_record, the_search, fixpt);
-      hash_add (the_search->closed_states, the_search->this_state);
+      hash_add (the_search->closed_states, the_search->arena,
+                the_search->this_state);
 
       if (!keep_going ||
-          (the_search->num_states > wordrec_num_seg_states) ||
+          (the_search->num_states > pass_num_seg_states) ||
           (tord_blob_skip)) {
         if (segment_debug)
           tprintf("Breaking best_first_search on keep_going %s numstates %d\n",
                   ((keep_going) ? "T" :"F"), the_search->num_states);
-        free_state (the_search->this_state);
         break;
       }
 
@@ -144,20 +140,19 @@ void Wordrec::best_first_search(CHUNKS_RECORD *chunks_record,
         // candidates are found.  After lowering this threshold, we can safely
         // popout everything that is worse than this score also.
         worst_priority = new_worst_priority;
+        the_search->open_states->PruneAbove(worst_priority);
       }
       expand_node(worst_priority, chunks_record, the_search);
     }
 
-    free_state (the_search->this_state);
     num_popped++;
-    the_search->this_state = pop_queue (the_search->open_states);
-    if (segment_debug && !the_search->this_state)
+    keep_going = pop_queue (the_search);
+    if (segment_debug && !keep_going)
       tprintf("No more states to evalaute after %d evals", num_popped);
   }
-  while (the_search->this_state);
+  while (keep_going);
 
-  state->part1 = the_search->best_state->part1;
-  state->part2 = the_search->best_state->part2;
+  *state = *the_search->best_state;
   stop_recording();
   if (permute_debug) {
     tprintf("\n\n\n =========== BestFirstSearch ==============\n");
@@ -165,7 +160,8 @@ void Wordrec::best_first_search(CHUNKS_RECORD *chunks_record,
     best_choice->print("**Final BestChoice**");
   }
   // save the best_state stats
-  delete_search(the_search);
+  record_search_status(the_search->num_states, the_search->before_best);
+  delete_search(the_search, &spare_closed_states_);
 }
 }  // namespace tesseract
 
@@ -200,24 +196,13 @@ int chunks_gap(WIDTH_RECORD *width_record, int last_chunk) {
 /**********************************************************************
  * delete_search
  *
- * Terminate the current search and free all the memory involved.
+ * Terminate the current search and free all the memory involved, but
+ * for its emptied table of closed states, which is kept in spare_table.
  **********************************************************************/
-void delete_search(SEARCH_RECORD *the_search) {
-  float closeness;
-
-  closeness = (the_search->num_joints ?
-    (hamming_distance(reinterpret_cast<uinT32*>(the_search->first_state),
-                      reinterpret_cast<uinT32*>(the_search->best_state), 2) /
-      (float) the_search->num_joints) : 0.0f);
-
-  record_search_status (the_search->num_states,
-    the_search->before_best, closeness);
-
-  free_state (the_search->first_state);
-  free_state (the_search->best_state);
-
-  free_hash_table (the_search->closed_states);
-  FreeHeapData (the_search->open_states, (void_dest) free_state);
+void delete_search(SEARCH_RECORD *the_search, HASH_TABLE *spare_table) {
+  free_hash_table (the_search->closed_states, spare_table);
+  delete the_search->open_states;
+  delete the_search->arena;
 
   memfree(the_search);
 }
@@ -263,12 +248,12 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::evaluate_chunks(CHUNKS_RECORD *chunks_record,
 
     /* Add permuted ratings */
     blob_choice_it.set_to_list(blob_choices);
-    last_segmentation[i - 1].certainty = blob_choice_it.data()->certainty();
-    last_segmentation[i - 1].match = blob_choice_it.data()->rating();
+    last_segmentation_[i - 1].certainty = blob_choice_it.data()->certainty();
+    last_segmentation_[i - 1].match = blob_choice_it.data()->rating();
 
-    last_segmentation[i - 1].width =
+    last_segmentation_[i - 1].width =
       chunks_width (chunks_record->chunk_widths, x, y);
-    last_segmentation[i - 1].gap =
+    last_segmentation_[i - 1].gap =
       chunks_gap (chunks_record->chunk_widths, y);
 
     *char_choices += blob_choices;
@@ -293,19 +278,20 @@ inT16 Wordrec::evaluate_state(CHUNKS_RECORD *chunks_record,
   PIECES_STATE widths;
 
   the_search->num_states++;
+  page_stats.Count(PC_SEG_STATES);
   chunk_groups = bin_to_chunks(the_search->this_state,
                                the_search->num_joints);
   bin_to_pieces (the_search->this_state, the_search->num_joints, widths);
   getDict().LogNewSegmentation(widths);
 
   char_choices = evaluate_chunks(chunks_record, chunk_groups);
-  wordseg_rating_adjust_factor = -1.0f;
+  getDict().set_wordseg_rating_adjust_factor(-1.0f);
   if (char_choices != NULL && char_choices->length() > 0) {
     // Compute the segmentation cost and include the cost in word rating.
     // TODO(dsl): We should change the SEARCH_RECORD to store this cost
     // from state evaluation and avoid recomputing it here.
     prioritize_state(chunks_record, the_search);
-    wordseg_rating_adjust_factor = the_search->segcost_bias;
+    getDict().set_wordseg_rating_adjust_factor(the_search->segcost_bias);
     getDict().permute_characters(*char_choices, rating_limit,
                                  the_search->best_choice,
                                  the_search->raw_choice);
@@ -316,7 +302,7 @@ inT16 Wordrec::evaluate_state(CHUNKS_RECORD *chunks_record,
       keep_going = FALSE;
     }
   }
-  wordseg_rating_adjust_factor = -1.0f;
+  getDict().set_wordseg_rating_adjust_factor(-1.0f);
 
 #ifndef GRAPHICS_DISABLED
   if (wordrec_display_segmentations) {
@@ -328,8 +314,7 @@ inT16 Wordrec::evaluate_state(CHUNKS_RECORD *chunks_record,
 
   if (rating_limit != the_search->best_choice->rating()) {
     the_search->before_best = the_search->num_states;
-    the_search->best_state->part1 = the_search->this_state->part1;
-    the_search->best_state->part2 = the_search->this_state->part2;
+    *the_search->best_state = *the_search->this_state;
     replace_char_widths(chunks_record, chunk_groups);
   }
   else if (char_choices != NULL)
@@ -551,13 +536,8 @@ namespace tesseract {
 void Wordrec::expand_node(FLOAT32 worst_priority,
                           CHUNKS_RECORD *chunks_record,
                           SEARCH_RECORD *the_search) {
-  STATE old_state;
   int nodes_added = 0;
   int x;
-  uinT32 mask = 1 << (the_search->num_joints - 1 - 32);
-
-  old_state.part1 = the_search->this_state->part1;
-  old_state.part2 = the_search->this_state->part2;
 
   // We need to expand the search more intelligently, or we get stuck
   // with a bad starting segmentation in a long word sequence as in CJK.
@@ -565,47 +545,22 @@ void Wordrec::expand_node(FLOAT32 worst_priority,
   // worse than 2x of its parent.
   // TODO(dsl): There is some redudency here in recomputing the priority,
   // and in filtering of old_merit and worst_priority.
-  the_search->this_state->part2 = old_state.part2;
-  for (x = the_search->num_joints; x > 32; x--) {
-    the_search->this_state->part1 = mask ^ old_state.part1;
+  for (x = the_search->num_joints - 1; x >= 0; x--) {
+    // Visit the neighbour that differs in joint x, and come back.
+    the_search->this_state->toggle_bit(x);
     if (!hash_lookup (the_search->closed_states, the_search->this_state)) {
       FLOAT32 new_merit = prioritize_state(chunks_record, the_search);
       if (segment_debug && permute_debug) {
         cprintf ("....checking state: %8.3f ", new_merit);
-        print_state ("", the_search->this_state, num_joints);
+        print_state ("", the_search->this_state, the_search->num_joints);
       }
       if (new_merit < worst_priority) {
-      push_queue (the_search->open_states, the_search->this_state,
+        push_queue (the_search, the_search->this_state,
                     worst_priority, new_merit);
         nodes_added++;
       }
     }
-    mask >>= 1;
-  }
-
-  if (the_search->num_joints > 32) {
-    mask = 1 << 31;
-  }
-  else {
-    mask = 1 << (the_search->num_joints - 1);
-  }
-
-  the_search->this_state->part1 = old_state.part1;
-  while (x--) {
-    the_search->this_state->part2 = mask ^ old_state.part2;
-    if (!hash_lookup (the_search->closed_states, the_search->this_state)) {
-      FLOAT32 new_merit = prioritize_state(chunks_record, the_search);
-      if (segment_debug && permute_debug) {
-        cprintf ("....checking state: %8.3f ", new_merit);
-        print_state ("", the_search->this_state, num_joints);
-      }
-      if (new_merit < worst_priority) {
-      push_queue (the_search->open_states, the_search->this_state,
-                   worst_priority, new_merit);
-        nodes_added++;
-      }
-    }
-    mask >>= 1;
+    the_search->this_state->toggle_bit(x);
   }
 }
 }  // namespace tesseract
@@ -614,33 +569,40 @@ void Wordrec::expand_node(FLOAT32 worst_priority,
 /**********************************************************************
  * new_search
  *
- * Create and initialize a new search record.
+ * Create and initialize a new search record, with room in its queue for
+ * the states of a search of num_seg_states. Its table of closed states
+ * is the one kept in spare_table, if there is one.
  **********************************************************************/
 SEARCH_RECORD *new_search(CHUNKS_RECORD *chunks_record,
                           int num_joints,
+                          int num_seg_states,
                           WERD_CHOICE *best_choice,
                           WERD_CHOICE *raw_choice,
-                          STATE *state) {
+                          STATE *state,
+                          HASH_TABLE *spare_table) {
   SEARCH_RECORD *this_search;
 
   this_search = (SEARCH_RECORD *) memalloc (sizeof (SEARCH_RECORD));
 
-  this_search->open_states = MakeHeap (wordrec_num_seg_states * 20);
-  this_search->closed_states = new_hash_table ();
+  this_search->open_states =
+    new tesseract::SearchHeap(num_seg_states * 20);
+  this_search->closed_states = new_hash_table (spare_table);
+  this_search->arena = new STATE_ARENA;
 
-  if (state)
-    this_search->this_state = new_state (state);
-  else
+  if (!state)
     cprintf ("error: bad initial state in new_search\n");
 
-  this_search->first_state = new_state (this_search->this_state);
-  this_search->best_state = new_state (this_search->this_state);
+  /* The current state is a scratch copy, never in the hash table */
+  this_search->this_state = &this_search->arena->new_node (state)->state;
+  this_search->first_state = &this_search->arena->new_node (state)->state;
+  this_search->best_state = &this_search->arena->new_node (state)->state;
 
   this_search->best_choice = best_choice;
   this_search->raw_choice = raw_choice;
 
   this_search->num_joints = num_joints;
   this_search->num_states = 0;
+  this_search->num_pushed = 0;
   this_search->before_best = 0;
   this_search->segcost_bias = 0;
 
@@ -651,47 +613,49 @@ SEARCH_RECORD *new_search(CHUNKS_RECORD *chunks_record,
 /**********************************************************************
  * pop_queue
  *
- * Get this state from the priority queue.  It should be the state that
- * has the greatest urgency to be evaluated.
+ * Get the next state from the priority queue into this_state.  It
+ * should be the state that has the greatest urgency to be evaluated.
+ * Return FALSE if the queue is empty.
  **********************************************************************/
-STATE *pop_queue(HEAP *queue) {
-  HEAPENTRY entry;
+int pop_queue(SEARCH_RECORD *the_search) {
+  SEARCH_NODE *node;
 
-  if (GetTopOfHeap (queue, &entry) == OK) {
+  node = the_search->open_states->Pop ();
+  if (node == NULL)
+    return (FALSE);
 #ifndef GRAPHICS_DISABLED
-    if (wordrec_display_segmentations) {
-      cprintf ("eval state: %8.3f ", entry.Key);
-      print_state ("", (STATE *) entry.Data, num_joints);
-    }
-#endif
-    return ((STATE *) entry.Data);
-  }
-  else {
-    return (NULL);
+  if (wordrec_display_segmentations) {
+    cprintf ("eval state: %8.3f ", node->priority);
+    print_state ("", &node->state, the_search->num_joints);
   }
+#endif
+  *the_search->this_state = node->state;
+  return (TRUE);
 }
 
 
 /**********************************************************************
  * push_queue
  *
- * Add this state into the priority queue.
+ * Add this state into the priority queue, or move it up if it is there
+ * already with a worse priority.  When the queue is full, the worst
+ * state in it makes room for a better one.
  **********************************************************************/
-void push_queue(HEAP *queue, STATE *state, FLOAT32 worst_priority,
-                FLOAT32 priority) {
-  HEAPENTRY entry;
+void push_queue(SEARCH_RECORD *the_search, STATE *state,
+                FLOAT32 worst_priority, FLOAT32 priority) {
+  SEARCH_NODE *node;
 
   if (priority < worst_priority) {
-    if (SizeOfHeap (queue) >= MaxSizeOfHeap(queue)) {
-      if (segment_debug) tprintf("Heap is Full\n");
+    node = hash_insert (the_search->closed_states, the_search->arena, state);
+    if (node->closed)
+      return;
+    if (!the_search->open_states->Push (node, priority)) {
+      if (segment_debug) tprintf("State not pushed\n");
       return;
     }
     if (segment_debug)
-      tprintf("\tpushing %d node  %f\n", num_pushed, priority);
-    entry.Data = (char *) new_state (state);
-    num_pushed++;
-    entry.Key = priority;
-    HeapStore(queue, &entry);
+      tprintf("\tpushing %d node  %f\n", the_search->num_pushed, priority);
+    the_search->num_pushed++;
   }
 }
 
@@ -700,9 +664,11 @@ void push_queue(HEAP *queue, STATE *state, FLOAT32 worst_priority,
  * replace_char_widths
  *
  * Replace the value of the char_width field in the chunks_record with
- * the updated width measurements from the last_segmentation.
+ * the updated width measurements from the last_segmentation_.
  **********************************************************************/
-void replace_char_widths(CHUNKS_RECORD *chunks_record, SEARCH_STATE state) {
+namespace tesseract {
+void Wordrec::replace_char_widths(CHUNKS_RECORD *chunks_record,
+                                  SEARCH_STATE state) {
   WIDTH_RECORD *width_record;
   int num_blobs;
   int i;
@@ -715,15 +681,14 @@ void replace_char_widths(CHUNKS_RECORD *chunks_record, SEARCH_STATE state) {
 
   for (i = 0; i < num_blobs; i++) {
 
-    width_record->widths[2 * i] = last_segmentation[i].width;
+    width_record->widths[2 * i] = last_segmentation_[i].width;
 
     if (i + 1 < num_blobs)
-      width_record->widths[2 * i + 1] = last_segmentation[i].gap;
+      width_record->widths[2 * i + 1] = last_segmentation_[i].gap;
   }
   chunks_record->char_widths = width_record;
 }
 
-namespace tesseract {
 BLOB_CHOICE_LIST *Wordrec::join_blobs_and_classify(
     TBLOB *blobs, SEAMS seam_list,
     int x, int y, int fx, const MATRIX *ratings,
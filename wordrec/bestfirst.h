@@ -33,9 +33,9 @@
 #include "associate.h"
 #include "blobs.h"
 #include "closed.h"
-#include "oldheap.h"
 #include "ratngs.h"
 #include "seam.h"
+#include "searchheap.h"
 #include "states.h"
 #include "stopper.h"
 #include "tessclas.h"
@@ -45,13 +45,15 @@
 ----------------------------------------------------------------------*/
 struct SEARCH_RECORD
 {
-  HEAP *open_states;
+  tesseract::SearchHeap *open_states;
   HASH_TABLE closed_states;
+  STATE_ARENA *arena;            /* Owns the states of the search */
   STATE *this_state;
   STATE *first_state;
   STATE *best_state;
   int num_joints;
   long num_states;
+  int num_pushed;                /* States pushed, for debug output */
   long before_best;
   float segcost_bias;
   WERD_CHOICE *best_choice;
@@ -72,21 +74,21 @@ extern double_VAR_H(wordrec_worst_state, 1, "Worst segmentation state");
 int chunks_width(WIDTH_RECORD *width_record, int start_chunk, int last_chunk);
 int chunks_gap(WIDTH_RECORD *width_record, int last_chunk);
 
-void delete_search(SEARCH_RECORD *the_search);
+void delete_search(SEARCH_RECORD *the_search, HASH_TABLE *spare_table);
 
 SEARCH_RECORD *new_search(CHUNKS_RECORD *chunks_record,
                           int num_joints,
+                          int num_seg_states,
                           WERD_CHOICE *best_choice,
                           WERD_CHOICE *raw_choice,
-                          STATE *state);
+                          STATE *state,
+                          HASH_TABLE *spare_table);
 
-STATE *pop_queue(HEAP *queue);
+int pop_queue(SEARCH_RECORD *the_search);
 
-void push_queue(HEAP *queue, STATE *state,
+void push_queue(SEARCH_RECORD *the_search, STATE *state,
                 FLOAT32 worst_priority, FLOAT32 priority);
 
-void replace_char_widths(CHUNKS_RECORD *chunks_record, SEARCH_STATE state);
-
 // Joins blobs between index x and y, hides corresponding seams and
 // returns classification of the resulting merged blob.
 BLOB_CHOICE_LIST *join_blobs_and_classify(TBLOB *blobs, SEAMS seam_list,
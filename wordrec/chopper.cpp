@@ -32,7 +32,9 @@
 
 #include "assert.h"
 #include "associate.h"
+#include "beamsearch.h"
 #include "callcpp.h"
+#include "ccutil.h"
 #include "choices.h"
 #include "const.h"
 #include "findseam.h"
@@ -59,6 +61,16 @@ double_VAR(tessedit_certainty_threshold, -2.25, "Good blob limit");
 BOOL_VAR(fragments_guide_chopper, FALSE,
          "Use information from fragments to guide chopping process");
 
+INT_VAR(chop_seam_candidates, 0,
+        "Seams tried on copies of a blob to choose each chop, 0 or 1 to"
+        " take the best seam by its shape");
+
+INT_VAR(chop_seam_threads, 1,
+        "Threads to try the seams of a chop with, read by Init");
+
+#define MAX_CHOP_STATES 64       /* States recorded for matcher_fp */
+#define MAX_SEAM_CANDIDATES 16   /* Limit on chop_seam_candidates */
+
 /*----------------------------------------------------------------------
           M a c r o s
 ----------------------------------------------------------------------*/
@@ -160,17 +172,69 @@ void restore_outline_tree(TESSLINE *srcline) {
 }
 
 
+/**********************************************************************
+ * split_blob_with_seam
+ *
+ * Split this blob, whose outlines were preserved if
+ * repair_unchopped_blobs is set, with this seam, which may be NULL.
+ * The new other_blob has been linked in after it.  Check to make sure
+ * that it was successful.  If not, the blob is put back together, the
+ * seam is deleted and NULL is returned.
+ **********************************************************************/
+static SEAM *split_blob_with_seam(TWERD *word, inT32 blob_number,
+                                  SEAMS seam_list, TBLOB *blob,
+                                  TBLOB *other_blob, TBLOB *next_blob,
+                                  SEAM *seam) {
+  if (seam) {
+    apply_seam(blob, other_blob, seam);
+  }
+
+  if ((seam == NULL) ||
+    (blob->outlines == NULL) ||
+    (other_blob->outlines == NULL) ||
+    total_containment (blob, other_blob) ||
+    check_blob (other_blob) ||
+    !(check_seam_order (blob, seam) &&
+    check_seam_order (other_blob, seam)) ||
+    any_shared_split_points (seam_list, seam) ||
+    !test_insert_seam(seam_list, blob_number, blob, word->blobs)) {
+
+    blob->next = next_blob;
+    if (seam) {
+      undo_seam(blob, other_blob, seam);
+      delete_seam(seam);
+#ifndef GRAPHICS_DISABLED
+      if (chop_debug) {
+        if (chop_debug >2)
+          display_blob(blob, Red);
+        cprintf ("\n** seam being removed ** \n");
+      }
+#endif
+    }
+    else {
+      oldblob(other_blob);
+    }
+
+    if (repair_unchopped_blobs)
+      restore_outline_tree (blob->outlines);
+    return (NULL);
+  }
+  return (seam);
+}
+
+
 /**********************************************************************
  * attempt_blob_chop
  *
  * Try to split the this blob after this one.  Check to make sure that
  * it was successful.
  **********************************************************************/
-SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list) {
+namespace tesseract {
+SEAM *Wordrec::attempt_blob_chop(TWERD *word, inT32 blob_number,
+                                 SEAMS seam_list) {
   TBLOB *blob;
   TBLOB *other_blob;
   SEAM *seam;
-  TBLOB *last_blob;
   TBLOB *next_blob;
   inT16 x;
 
@@ -179,12 +243,9 @@ SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list) {
   else
     chops_attempted2++;
 
-  last_blob = NULL;
   blob = word->blobs;
-  for (x = 0; x < blob_number; x++) {
-    last_blob = blob;
+  for (x = 0; x < blob_number; x++)
     blob = blob->next;
-  }
   next_blob = blob->next;
 
   if (repair_unchopped_blobs)
@@ -194,7 +255,7 @@ SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list) {
   other_blob->outlines = NULL;
   blob->next = other_blob;
 
-  seam = pick_good_seam (blob);
+  seam = pick_good_seam (blob, pass_ok_split);
   if (chop_debug) {
     if (seam != NULL) {
       print_seam ("Good seam picked=", seam);
@@ -202,41 +263,97 @@ SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list) {
     else
       cprintf ("\n** no seam picked *** \n");
   }
-  if (seam) {
-    apply_seam(blob, other_blob, seam);
+  return (split_blob_with_seam (word, blob_number, seam_list,
+                                blob, other_blob, next_blob, seam));
+}
+}  // namespace tesseract
+
+
+/**********************************************************************
+ * copy_outlines
+ *
+ * Make a copy of a list of outlines and their children.  Where a point
+ * of the outlines is a point of a split of the seam, the split of
+ * seam_copy is pointed at the copy of the point.
+ **********************************************************************/
+static void copy_split_point(EDGEPT *point, EDGEPT *copy,
+                             SPLIT *split, SPLIT *split_copy) {
+  if (split != NULL) {
+    if (split->point1 == point)
+      split_copy->point1 = copy;
+    if (split->point2 == point)
+      split_copy->point2 = copy;
   }
+}
 
-  if ((seam == NULL) ||
-    (blob->outlines == NULL) ||
-    (other_blob->outlines == NULL) ||
-    total_containment (blob, other_blob) ||
-    check_blob (other_blob) ||
-    !(check_seam_order (blob, seam) &&
-    check_seam_order (other_blob, seam)) ||
-    any_shared_split_points (seam_list, seam) ||
-    !test_insert_seam(seam_list, blob_number, blob, word->blobs)) {
+static EDGEPT *copy_loop(EDGEPT *loop, SEAM *seam, SEAM *seam_copy) {
+  EDGEPT *point;
+  EDGEPT *copy;
+  EDGEPT *first = NULL;
+  EDGEPT *last = NULL;
 
-    blob->next = next_blob;
-    if (seam) {
-      undo_seam(blob, other_blob, seam);
-      delete_seam(seam);
-#ifndef GRAPHICS_DISABLED
-      if (chop_debug) {
-        if (chop_debug >2)
-          display_blob(blob, Red);
-        cprintf ("\n** seam being removed ** \n");
-      }
-#endif
+  if (loop == NULL)
+    return (NULL);
+  point = loop;
+  do {
+    copy = newedgept ();
+    *copy = *point;
+    if (first == NULL) {
+      first = copy;
     }
     else {
-      oldblob(other_blob);
+      last->next = copy;
+      copy->prev = last;
     }
+    last = copy;
+    copy_split_point(point, copy, seam->split1, seam_copy->split1);
+    copy_split_point(point, copy, seam->split2, seam_copy->split2);
+    copy_split_point(point, copy, seam->split3, seam_copy->split3);
+    point = point->next;
+  }
+  while (point != loop);
+  last->next = first;
+  first->prev = last;
+  return (first);
+}
 
-    if (repair_unchopped_blobs)
-      restore_outline_tree (blob->outlines);
-    return (NULL);
+static TESSLINE *copy_outlines(TESSLINE *outline,
+                               SEAM *seam, SEAM *seam_copy) {
+  TESSLINE *copy;
+  TESSLINE *first = NULL;
+  TESSLINE *last = NULL;
+
+  for (; outline != NULL; outline = outline->next) {
+    copy = newoutline ();
+    *copy = *outline;
+    copy->compactloop = NULL;
+    copy->loop = copy_loop (outline->loop, seam, seam_copy);
+    copy->child = copy_outlines (outline->child, seam, seam_copy);
+    copy->next = NULL;
+    if (first == NULL)
+      first = copy;
+    else
+      last->next = copy;
+    last = copy;
+  }
+  return (first);
+}
+
+
+/**********************************************************************
+ * free_outlines
+ *
+ * Free a list of outlines made by copy_outlines, and their children.
+ **********************************************************************/
+static void free_outlines(TESSLINE *outline) {
+  TESSLINE *next_outline;
+
+  for (; outline != NULL; outline = next_outline) {
+    next_outline = outline->next;
+    free_outlines (outline->child);
+    delete_edgepts (outline->loop);
+    oldoutline(outline);
   }
-  return (seam);
 }
 
 
@@ -281,13 +398,290 @@ int check_blob(TBLOB *blob) {
 }
 
 
+namespace tesseract {
+/**********************************************************************
+ * try_seam_on_copy
+ *
+ * Split a copy of this blob with a copy of this seam, and classify the
+ * two pieces without using or changing the match table.  The blob
+ * itself is only read, so the seams of a blob may be tried at the same
+ * time by several instances.  Return FALSE if the seam does not split
+ * the copy cleanly, in which case no choices are returned.
+ **********************************************************************/
+bool Wordrec::try_seam_on_copy(TBLOB *pblob, TBLOB *blob, TBLOB *nblob,
+                               SEAM *seam, BLOB_CHOICE_LIST **left,
+                               BLOB_CHOICE_LIST **right) {
+  TBLOB *copy;
+  TBLOB *other_copy;
+  SEAM *seam_copy;
+  bool ok;
+
+  clone_seam(seam_copy, seam);
+  copy = newblob ();
+  *copy = *blob;
+  copy->next = NULL;
+  copy->outlines = copy_outlines (blob->outlines, seam, seam_copy);
+  other_copy = newblob ();
+  other_copy->outlines = NULL;
+  other_copy->next = NULL;
+
+  apply_seam(copy, other_copy, seam_copy);
+  ok = copy->outlines != NULL &&
+    other_copy->outlines != NULL &&
+    !total_containment (copy, other_copy) &&
+    !check_blob (other_copy) &&
+    check_seam_order (copy, seam_copy) &&
+    check_seam_order (other_copy, seam_copy);
+  if (ok) {
+    *left = call_matcher (pblob, copy, other_copy, NULL, NULL);
+    *right = call_matcher (copy, other_copy, nblob, NULL, NULL);
+  }
+
+  free_outlines (copy->outlines);
+  free_outlines (other_copy->outlines);
+  oldblob(copy);
+  oldblob(other_copy);
+  delete_seam(seam_copy);
+  return (ok);
+}
+
+
+/**********************************************************************
+ * copy_seam_helper_state
+ *
+ * Give the seam helpers the classifier state of this instance, if it
+ * may have changed since they were last given it, and the matcher and
+ * word of the chop, so that they classify pieces as this one would.
+ **********************************************************************/
+void Wordrec::copy_seam_helper_state() {
+  char *templates;
+  int templates_length = 0;
+  int x;
+
+  /* Done by the first classification of a serial trial */
+  ResetIfAdaptationsFailed();
+  if (seam_helper_changes_ != classifier_changes()) {
+    templates = ExportAdaptiveClassifier(&templates_length);
+    for (x = 0; x < seam_helpers_.size(); x++)
+      CopyClassifierState(templates, templates_length, seam_helpers_[x]);
+    delete [] templates;
+    seam_helper_changes_ = classifier_changes();
+  }
+  for (x = 0; x < seam_helpers_.size(); x++) {
+    seam_helpers_[x]->tess_matcher = tess_matcher;
+    seam_helpers_[x]->tess_denorm = tess_denorm;
+    seam_helpers_[x]->tess_word = tess_word;
+  }
+}
+}  // namespace tesseract
+
+
+/**********************************************************************
+ * SEAM_TRIALS
+ *
+ * The seams of a blob to try, the choices of the pieces of those that
+ * split the blob cleanly, and the instance that tries every step'th one
+ * from first on.
+ **********************************************************************/
+typedef struct
+{
+  tesseract::Wordrec *wordrec;
+  TBLOB *pblob;
+  TBLOB *blob;
+  TBLOB *nblob;
+  SEAM **seams;
+  BLOB_CHOICE_LIST **lefts;
+  BLOB_CHOICE_LIST **rights;
+  int num_seams;
+  int first;
+  int step;
+} SEAM_TRIALS;
+
+static void try_seams(SEAM_TRIALS *trials) {
+  int x;
+
+  for (x = trials->first; x < trials->num_seams; x += trials->step) {
+    if (trials->seams[x] != NULL)
+      trials->wordrec->try_seam_on_copy (trials->pblob, trials->blob,
+                                         trials->nblob, trials->seams[x],
+                                         &trials->lefts[x],
+                                         &trials->rights[x]);
+  }
+}
+
+static void *try_seams_thread(void *arg) {
+  try_seams ((SEAM_TRIALS *) arg);
+  return (NULL);
+}
+
+
+/**********************************************************************
+ * attempt_best_blob_chop
+ *
+ * Pick up to chop_seam_candidates good seams for the blob after this
+ * one, split a copy of the blob with each, and chop the blob with the
+ * seam that leaves the better worst piece.  The copies are tried by
+ * this instance and its seam helpers at the same time.  On a tie the
+ * seam with the better shape wins, so the choice does not depend on
+ * the number of threads.  Return the seam, with the choices of its two
+ * pieces in left and right, or NULL if no seam could be applied.
+ **********************************************************************/
+namespace tesseract {
+SEAM *Wordrec::attempt_best_blob_chop(TWERD *word, inT32 blob_number,
+                                      SEAMS seam_list,
+                                      BLOB_CHOICE_LIST **left,
+                                      BLOB_CHOICE_LIST **right) {
+  SEAM *seams[MAX_SEAM_CANDIDATES];
+  BLOB_CHOICE_LIST *lefts[MAX_SEAM_CANDIDATES];
+  BLOB_CHOICE_LIST *rights[MAX_SEAM_CANDIDATES];
+  FLOAT32 scores[MAX_SEAM_CANDIDATES];
+  SEAM_TRIALS trials[MAX_SEAM_CANDIDATES];
+  CCUtilThread threads[MAX_SEAM_CANDIDATES];
+  bool started[MAX_SEAM_CANDIDATES];
+  BLOB_CHOICE_IT choice_it;
+  TBLOB *pblob = NULL;
+  TBLOB *blob;
+  TBLOB *other_blob;
+  TBLOB *next_blob;
+  SEAM *seam = NULL;
+  int num_seams;
+  int num_runs;
+  int best;
+  int x;
+
+  if (first_pass)
+    chops_attempted1++;
+  else
+    chops_attempted2++;
+
+  blob = word->blobs;
+  for (x = 0; x < blob_number; x++) {
+    pblob = blob;
+    blob = blob->next;
+  }
+
+  num_seams = pick_good_seams (blob, pass_ok_split, seams,
+    MIN (chop_seam_candidates, MAX_SEAM_CANDIDATES));
+  for (x = 0; x < num_seams; x++) {
+    lefts[x] = NULL;
+    rights[x] = NULL;
+    scores[x] = MAX_FLOAT32;
+    if (any_shared_split_points (seam_list, seams[x])) {
+      delete_seam (seams[x]);
+      seams[x] = NULL;
+    }
+  }
+
+  /* Try the seams, spread over this instance and its helpers */
+  num_runs = 1;
+  if (!tord_blob_skip && !chop_debug && num_seams > 1)
+    num_runs = MIN (num_seams, seam_helpers_.size () + 1);
+  if (num_runs > 1)
+    copy_seam_helper_state();
+  for (x = 0; x < num_runs; x++) {
+    trials[x].wordrec = x == 0 ? this : seam_helpers_[x - 1];
+    trials[x].pblob = pblob;
+    trials[x].blob = blob;
+    trials[x].nblob = blob->next;
+    trials[x].seams = seams;
+    trials[x].lefts = lefts;
+    trials[x].rights = rights;
+    trials[x].num_seams = tord_blob_skip ? 0 : num_seams;
+    trials[x].first = x;
+    trials[x].step = num_runs;
+  }
+  for (x = 1; x < num_runs; x++)
+    started[x] = threads[x].Start (try_seams_thread, &trials[x]);
+  try_seams (&trials[0]);
+  /* The trials of a thread that could not be started are done here */
+  for (x = 1; x < num_runs; x++) {
+    if (!started[x])
+      try_seams (&trials[x]);
+  }
+  for (x = 1; x < num_runs; x++)
+    threads[x].Join ();
+
+  for (x = 0; x < num_seams; x++) {
+    if (lefts[x] != NULL && !lefts[x]->empty () && !rights[x]->empty ()) {
+      choice_it.set_to_list (lefts[x]);
+      scores[x] = choice_it.data ()->rating ();
+      choice_it.set_to_list (rights[x]);
+      if (choice_it.data ()->rating () > scores[x])
+        scores[x] = choice_it.data ()->rating ();
+    }
+    if (chop_debug && seams[x] != NULL)
+      cprintf ("Seam candidate %d scored %g\n", x, scores[x]);
+  }
+
+  /* Apply the best scoring seam that works on the real blob */
+  while (seam == NULL) {
+    best = -1;
+    for (x = 0; x < num_seams; x++) {
+      if (lefts[x] != NULL && (best < 0 || scores[x] < scores[best]))
+        best = x;
+    }
+    if (best < 0)
+      break;
+    if (chop_debug)
+      print_seam ("Best scoring seam=", seams[best]);
+    next_blob = blob->next;
+    if (repair_unchopped_blobs)
+      preserve_outline_tree (blob->outlines);
+    other_blob = newblob ();
+    other_blob->next = blob->next;
+    other_blob->outlines = NULL;
+    blob->next = other_blob;
+    seam = split_blob_with_seam (word, blob_number, seam_list,
+                                 blob, other_blob, next_blob, seams[best]);
+    seams[best] = NULL;
+    if (seam != NULL) {
+      *left = lefts[best];
+      *right = rights[best];
+    }
+    else {
+      delete lefts[best];
+      delete rights[best];
+    }
+    lefts[best] = NULL;
+    rights[best] = NULL;
+  }
+  for (x = 0; x < num_seams; x++) {
+    delete lefts[x];
+    delete rights[x];
+    if (seams[x] != NULL)
+      delete_seam (seams[x]);
+  }
+  if (chop_debug && seam == NULL)
+    cprintf ("\n** no seam candidate applied *** \n");
+  return (seam);
+}
+
+
+/**********************************************************************
+ * put_trial_match
+ *
+ * Record the choices that attempt_best_blob_chop found for one piece
+ * of a chopped blob in the match table, unless the table already has
+ * the blob, and free them.
+ **********************************************************************/
+void Wordrec::put_trial_match(TBLOB *blob, BLOB_CHOICE_LIST *choices) {
+  BLOB_CHOICE_LIST *old_choices;
+
+  old_choices = blob_match_table.get_match (blob);
+  if (old_choices == NULL)
+    blob_match_table.put_match (blob, choices);
+  else
+    delete old_choices;
+  delete choices;
+}
+
+
 /**********************************************************************
  * improve_one_blob
  *
  * Start with the current word of blobs and its classification.  Find
  * the worst blobs and try to divide it up to improve the ratings.
  *********************************************************************/
-namespace tesseract {
 bool Wordrec::improve_one_blob(TWERD *word,
                                BLOB_CHOICE_LIST_VECTOR *char_choices,
                                int fx,
@@ -301,6 +695,8 @@ bool Wordrec::improve_one_blob(TWERD *word,
   float rating_ceiling = MAX_FLOAT32;
   BLOB_CHOICE_LIST *answer;
   BLOB_CHOICE_IT answer_it;
+  BLOB_CHOICE_LIST *left = NULL;
+  BLOB_CHOICE_LIST *right = NULL;
   SEAM *seam;
 
   do {
@@ -311,7 +707,12 @@ bool Wordrec::improve_one_blob(TWERD *word,
     if (*blob_number == -1)
       return false;
 
-    seam = attempt_blob_chop (word, *blob_number, *seam_list);
+    page_stats.Count(PC_CHOP_ATTEMPTS);
+    if (chop_seam_candidates > 1)
+      seam = attempt_best_blob_chop (word, *blob_number, *seam_list,
+                                     &left, &right);
+    else
+      seam = attempt_blob_chop (word, *blob_number, *seam_list);
     if (seam != NULL)
       break;
     /* Must split null blobs */
@@ -332,6 +733,10 @@ bool Wordrec::improve_one_blob(TWERD *word,
 
   delete char_choices->get(*blob_number);
 
+  if (left != NULL) {
+    put_trial_match(blob, left);
+    put_trial_match(blob->next, right);
+  }
   answer = classify_blob(pblob, blob, blob->next, NULL, "improve 1:", Red);
   char_choices->insert(answer, *blob_number);
 
@@ -400,6 +805,7 @@ bool Wordrec::chop_one_blob(TWERD *word,
       cprintf("blob_number = %d\n", *blob_number);
     if (*blob_number == -1)
       return false;
+    page_stats.Count(PC_CHOP_ATTEMPTS);
     seam = attempt_blob_chop(word, *blob_number, *seam_list);
     if (seam != NULL)
       break;
@@ -504,11 +910,13 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
   SEAMS seam_list = start_seam_list(word->blobs);
   BLOB_CHOICE_LIST *match_result;
   MATRIX *ratings = NULL;
+  MATRIX *chop_ratings;          /* Kept up to date by the chops */
   DANGERR fixpt;                 /*dangerous ambig */
   inT32 state_count;             //no of states
   inT32 bit_count;               //no of bits
-  static STATE best_state;
-  static STATE chop_states[64];  //in between states
+  STATE best_state;
+  STATE chop_states[MAX_CHOP_STATES];  //in between states
+  PageStageTimer timer(&page_stats, PS_CHOP_WORD);
 
   state_count = 0;
   best_choice->make_bad();
@@ -527,6 +935,10 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
     pblob = blob;
   }
   bit_count = index - 1;
+  /* All the blobs are in the match table */
+  chop_ratings = new MATRIX(index);
+  for (index = 0; index < chop_ratings->dimension(); index++)
+    chop_ratings->set_dirty(index, index);
   getDict().permute_characters(*char_choices, rating_limit,
                                best_choice, raw_choice);
   set_n_ones(&state, char_choices->length() - 1);
@@ -547,7 +959,7 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
     else
       words_chopped2++;
 
-    if (chop_enable)
+    if (chop_enable && !tess_dont_chop)
       improve_by_chopping(word,
                           char_choices,
                           fx,
@@ -557,7 +969,8 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
                           &seam_list,
                           &fixpt,
                           chop_states,
-                          &state_count);
+                          &state_count,
+                          chop_ratings);
     if (chop_debug)
       print_seams ("Final seam list:", seam_list);
 
@@ -565,7 +978,7 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
     // it is not conditioned on the dict behavior.  For CJK, we need to force
     // the associator to be invoked.  When we figure out the exact behavior
     // of dict on CJK, we can remove the flag if it turns out to be redundant.
-    if ((wordrec_enable_assoc &&
+    if ((wordrec_enable_assoc && !tess_dont_chop &&
          !getDict().AcceptableChoice(char_choices, best_choice, *raw_choice,
                                      NULL, CHOPPER_CALLER, &replaced)) ||
         force_word_assoc ||
@@ -573,9 +986,11 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
          strcmp(word->correct, best_choice->unichar_string().string()))) {
       ratings = word_associator (word->blobs, seam_list, &state, fx,
         best_choice, raw_choice, word->correct,
-        /*0, */ &fixpt, &best_state);
+        /*0, */ &fixpt, &best_state, chop_ratings);
+      chop_ratings = NULL;
     }
-    bits_in_states = bit_count + state_count - 1;
+    if (matcher_fp != NULL)
+      bits_in_states = bit_count + state_count - 1;
   }
   if (replaced) update_blob_classifications(word, *char_choices);
 
@@ -588,6 +1003,10 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
     ratings->delete_matrix_pointers();
     delete ratings;
   }
+  if (chop_ratings != NULL) {
+    chop_ratings->delete_matrix_pointers();
+    delete chop_ratings;
+  }
   if (seam_list != NULL)
     free_seam_list(seam_list);
   if (matcher_fp != NULL) {
@@ -606,7 +1025,8 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(register TWERD *word,
  * the worst blobs and try to divide them up to improve the ratings.
  * As long as ratings are produced by the new blob splitting.  When
  * all the splitting has been accomplished all the ratings memory is
- * reclaimed.
+ * reclaimed.  The chunks of ratings are split with the blobs, so that
+ * it only has to be updated with the pieces that are new.
  **********************************************************************/
 void Wordrec::improve_by_chopping(register TWERD *word,
                                   BLOB_CHOICE_LIST_VECTOR *char_choices,
@@ -617,12 +1037,12 @@ void Wordrec::improve_by_chopping(register TWERD *word,
                                   SEAMS *seam_list,
                                   DANGERR *fixpt,
                                   STATE *chop_states,
-                                  inT32 *state_count) {
+                                  inT32 *state_count,
+                                  MATRIX *ratings) {
   inT32 blob_number;
   inT32 index;                   //to states
   float old_best;
   int fixpt_valid = 1;
-  static inT32 old_count;        //from pass1
   bool replaced = false;
 
   do {  // improvement loop
@@ -634,6 +1054,9 @@ void Wordrec::improve_by_chopping(register TWERD *word,
                          fixpt, (fragments_guide_chopper &&
                                  best_choice->fragment_mark()))) {
       getDict().LogNewSplit(blob_number);
+      ratings->split_chunk(blob_number);
+      ratings->set_dirty(blob_number, blob_number);
+      ratings->set_dirty(blob_number + 1, blob_number + 1);
       getDict().permute_characters(*char_choices, best_choice->rating(),
                                    best_choice, raw_choice);
 
@@ -650,8 +1073,10 @@ void Wordrec::improve_by_chopping(register TWERD *word,
           insert_new_chunk(&chop_states[index], blob_number,
                            char_choices->length() - 2);
         }
-        set_n_ones(&chop_states[index], char_choices->length() - 1);
-        (*state_count)++;
+        if (*state_count < MAX_CHOP_STATES) {
+          set_n_ones(&chop_states[index], char_choices->length() - 1);
+          (*state_count)++;
+        }
       }
 
       if (chop_debug)
@@ -668,7 +1093,6 @@ void Wordrec::improve_by_chopping(register TWERD *word,
                                        fixpt, CHOPPER_CALLER, &replaced) &&
            !tord_blob_skip && char_choices->length() < MAX_NUM_CHUNKS);
   if (replaced) update_blob_classifications(word, *char_choices);
-  old_count = *state_count;
   if (!fixpt_valid)
     fixpt->index = -1;
 }
@@ -829,6 +1253,9 @@ inT16 total_containment(TBLOB *blob1, TBLOB *blob2) {
  *
  * Reassociate and classify the blobs in a word.  Continue this process
  * until a good answer is found or all the possibilities have been tried.
+ * The ratings of the pieces are taken from ratings, which is brought up
+ * to date first, or from the match table if it is NULL.  The returned
+ * matrix replaces ratings.
  **********************************************************************/
 namespace tesseract {
 MATRIX *Wordrec::word_associator(TBLOB *blobs,
@@ -839,7 +1266,8 @@ MATRIX *Wordrec::word_associator(TBLOB *blobs,
                                  WERD_CHOICE *raw_choice,
                                  char *correct,
                                  DANGERR *fixpt,
-                                 STATE *best_state) {
+                                 STATE *best_state,
+                                 MATRIX *ratings) {
   CHUNKS_RECORD chunks_record;
   BLOB_WEIGHTS blob_weights;
   int x;
@@ -850,7 +1278,13 @@ MATRIX *Wordrec::word_associator(TBLOB *blobs,
 
   chunks_record.chunks = blobs;
   chunks_record.splits = seams;
-  chunks_record.ratings = record_piece_ratings (blobs);
+  if (ratings != NULL) {
+    update_piece_ratings(ratings, blobs);
+    chunks_record.ratings = ratings;
+  }
+  else {
+    chunks_record.ratings = record_piece_ratings (blobs);
+  }
   chunks_record.char_widths = blobs_widths (blobs);
   chunks_record.chunk_widths = blobs_widths (blobs);
   chunks_record.fx = fxid;
@@ -873,12 +1307,16 @@ MATRIX *Wordrec::word_associator(TBLOB *blobs,
   if (chop_debug)
     chunks_record.ratings->print(getDict().getUnicharset());
 
-  best_first_search(&chunks_record,
-                    best_choice,
-                    raw_choice,
-                    state,
-                    fixpt,
-                    best_state);
+  if (wordrec_beam_search)
+    beam_search(&chunks_record, best_choice, raw_choice, state, fixpt,
+                best_state);
+  else
+    best_first_search(&chunks_record,
+                      best_choice,
+                      raw_choice,
+                      state,
+                      fixpt,
+                      best_state);
 
   free_widths (chunks_record.chunk_widths);
   free_widths (chunks_record.char_widths);
@@ -42,6 +42,13 @@
 extern BOOL_VAR_H (fragments_guide_chopper, FALSE,
                    "Use information from fragments to guide chopping process");
 
+extern INT_VAR_H(chop_seam_candidates, 0,
+                 "Seams tried on copies of a blob to choose each chop, 0 or 1"
+                 " to take the best seam by its shape");
+
+extern INT_VAR_H(chop_seam_threads, 1,
+                 "Threads to try the seams of a chop with, read by Init");
+
 
 /*----------------------------------------------------------------------
               F u n c t i o n s
@@ -54,8 +61,6 @@ EDGEPT *restore_outline(EDGEPT *start);
 
 void restore_outline_tree(TESSLINE *srcline);
 
-SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list);
-
 int any_shared_split_points(SEAMS seam_list, SEAM *seam);
 
 int check_blob(TBLOB *blob);
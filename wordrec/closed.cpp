@@ -29,108 +29,221 @@
 #include "closed.h"
 #include "cutil.h"
 #include "callcpp.h"
-//#include <process.h>
-#ifdef __UNIX__
-#include <assert.h>
-#endif
+
+#include <string.h>
 
 /*----------------------------------------------------------------------
               V a r i a b l e s
 ----------------------------------------------------------------------*/
-#define TABLE_SIZE 2000
-HASH_TABLE global_hash = NULL;
+#define INITIAL_TABLE_SIZE 1024  /* Slots of a new table */
+
+/*----------------------------------------------------------------------
+              M e t h o d s
+----------------------------------------------------------------------*/
+/**********************************************************************
+ * STATE_ARENA::new_node
+ *
+ * Take the next node of the newest block, starting a new block when
+ * it is used up.
+ **********************************************************************/
+SEARCH_NODE *STATE_ARENA::new_node(const STATE *state) {
+  SEARCH_NODE *node;
+
+  if (used >= ARENA_BLOCK_SIZE) {
+    BLOCK *block = new BLOCK;
+    block->next = blocks;
+    blocks = block;
+    used = 0;
+  }
+  node = &blocks->nodes[used++];
+  node->state = *state;
+  node->priority = 0.0f;
+  node->heap_index = -1;
+  node->closed = FALSE;
+  return node;
+}
+
+
+/**********************************************************************
+ * STATE_ARENA::release
+ *
+ * Free all the blocks, and the nodes in them.
+ **********************************************************************/
+void STATE_ARENA::release() {
+  while (blocks != NULL) {
+    BLOCK *next = blocks->next;
+    delete blocks;
+    blocks = next;
+  }
+  used = ARENA_BLOCK_SIZE;
+}
+
 
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
 /**********************************************************************
- * hash_add
+ * hash_slot
  *
- * Look in the hash table for a particular value. If it is not there
- * then add it.
+ * Return the slot of the table that holds state, or the empty slot
+ * where it would go.
  **********************************************************************/
-int hash_add(HASH_TABLE state_table, STATE *state) { 
+static int hash_slot(HASH_TABLE state_table, STATE *state) {
+  uinT32 hash;
+  int mask = state_table->size - 1;
   int x;
-  int i = 0;
-  int table_limit = TABLE_SIZE;
-
-  x = state->part2 % table_limit;
-  while (i < table_limit) {
-    assert (0 <= x && x < table_limit);
-    /* Found it */
-    if ((state_table[x].part2 == state->part2) &&
-    (state_table[x].part1 == state->part1)) {
-      return (FALSE);
-    }
-    /* Not in table */
-    else if (state_table[x].part1 == NO_STATE) {
-      state_table[x].part2 = state->part2;
-      state_table[x].part1 = state->part1;
-      return (TRUE);
+
+  hash = state->hash();
+  /* The low bits are the last joints, so mix in the high ones. */
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  x = hash & mask;
+  while (state_table->nodes[x] != NULL &&
+         state_table->nodes[x]->state != *state)
+    x = (x + 1) & mask;
+  return x;
+}
+
+
+/**********************************************************************
+ * grow_hash_table
+ *
+ * Double the size of the table and put the nodes back in.
+ **********************************************************************/
+static void grow_hash_table(HASH_TABLE state_table) {
+  SEARCH_NODE **old_nodes = state_table->nodes;
+  int *old_filled = state_table->filled;
+  int x;
+
+  state_table->size *= 2;
+  state_table->nodes = new SEARCH_NODE *[state_table->size];
+  state_table->filled = new int[state_table->size / 2];
+  memset(state_table->nodes, 0, state_table->size * sizeof(SEARCH_NODE *));
+  for (x = 0; x < state_table->count; x++) {
+    SEARCH_NODE *node = old_nodes[old_filled[x]];
+    int slot = hash_slot(state_table, &node->state);
+    state_table->nodes[slot] = node;
+    state_table->filled[x] = slot;
+  }
+  delete [] old_nodes;
+  delete [] old_filled;
+}
+
+
+/**********************************************************************
+ * hash_find
+ *
+ * Look in the hash table for a particular state. Return its node, or
+ * NULL if it is not there.
+ **********************************************************************/
+SEARCH_NODE *hash_find(HASH_TABLE state_table, STATE *state) {
+  return state_table->nodes[hash_slot(state_table, state)];
+}
+
+
+/**********************************************************************
+ * hash_insert
+ *
+ * Look in the hash table for a particular state. If it is not there
+ * then add a new node for it. Return the node.
+ **********************************************************************/
+SEARCH_NODE *hash_insert(HASH_TABLE state_table, STATE_ARENA *arena,
+                         STATE *state) {
+  int x = hash_slot(state_table, state);
+
+  if (state_table->nodes[x] == NULL) {
+    if (2 * (state_table->count + 1) > state_table->size) {
+      grow_hash_table(state_table);
+      x = hash_slot(state_table, state);
     }
-    i++;
-    if (++x >= table_limit)
-      x = 0;
+    state_table->nodes[x] = arena->new_node(state);
+    state_table->filled[state_table->count++] = x;
   }
-  cprintf("warning: hash table is full");
-  
-  abort(); 
-  return 0;
+  return state_table->nodes[x];
+}
+
+
+/**********************************************************************
+ * hash_add
+ *
+ * Mark a particular state as closed, adding it to the hash table if it
+ * is not there. Return FALSE if it was closed already.
+ **********************************************************************/
+int hash_add(HASH_TABLE state_table, STATE_ARENA *arena, STATE *state) {
+  SEARCH_NODE *node = hash_insert(state_table, arena, state);
+
+  if (node->closed)
+    return (FALSE);
+  node->closed = TRUE;
+  return (TRUE);
 }
 
 
 /**********************************************************************
  * hash_lookup
  *
- * Look in the hash table for a particular value. If the value is there
- * then return TRUE, FALSE otherwise.
+ * Look in the hash table for a particular state. If it is there and
+ * closed then return TRUE, FALSE otherwise.
  **********************************************************************/
-int hash_lookup(HASH_TABLE state_table, STATE *state) { 
-  int x;
-  int i = 0;
-  int table_limit = TABLE_SIZE;
-
-  x = state->part2 % table_limit;
-  while (i < table_limit) {
-    assert (0 <= x && x < table_limit);
-    /* Found it */
-    if ((state_table[x].part2 == state->part2) &&
-    (state_table[x].part1 == state->part1)) {
-      return (TRUE);
-    }
-    /* Not in table */
-    else if (state_table[x].part1 == NO_STATE) {
-      return (FALSE);
-    }
+int hash_lookup(HASH_TABLE state_table, STATE *state) {
+  SEARCH_NODE *node = hash_find(state_table, state);
 
-    i++;
-    if (++x >= table_limit)
-      x = 0;
-  }
-  cprintf ("warning: fell off end of hash table  (%x) %x\n",
-    state->part2, state->part2 % table_limit);
-  abort(); 
-  return 0;
+  return (node != NULL && node->closed);
 }
 
 
 /**********************************************************************
  * new_hash_table
  *
- * Create and initialize a hash table.
+ * Return an empty hash table, taking the one kept in spare if there is
+ * one.
  **********************************************************************/
-HASH_TABLE new_hash_table() { 
+HASH_TABLE new_hash_table(HASH_TABLE *spare) {
   HASH_TABLE ht;
+
+  if (*spare == NULL) {
+    ht = new HASH_TABLE_RECORD;
+    ht->size = INITIAL_TABLE_SIZE;
+    ht->nodes = new SEARCH_NODE *[ht->size];
+    ht->filled = new int[ht->size / 2];
+    memset(ht->nodes, 0, ht->size * sizeof(SEARCH_NODE *));
+    ht->count = 0;
+  }
+  else {
+    ht = *spare;
+    *spare = NULL;
+  }
+  return (ht);
+}
+
+
+/**********************************************************************
+ * free_hash_table
+ *
+ * Empty the slots in use of table and keep it in spare for the next
+ * new_hash_table. Its nodes belong to the arena of the search.
+ **********************************************************************/
+void free_hash_table(HASH_TABLE table, HASH_TABLE *spare) {
   int x;
 
-  if (global_hash == NULL)
-    ht = (HASH_TABLE) memalloc (TABLE_SIZE * sizeof (STATE));
-  else
-    ht = global_hash;
+  for (x = 0; x < table->count; x++)
+    table->nodes[table->filled[x]] = NULL;
+  table->count = 0;
+  delete_hash_table(*spare);
+  *spare = table;
+}
+
 
-  for (x = 0; x < TABLE_SIZE; x++) {
-    ht[x].part1 = NO_STATE;
-    ht[x].part2 = NO_STATE;
+/**********************************************************************
+ * delete_hash_table
+ *
+ * Free a hash table, if there is one.
+ **********************************************************************/
+void delete_hash_table(HASH_TABLE table) {
+  if (table != NULL) {
+    delete [] table->nodes;
+    delete [] table->filled;
+    delete table;
   }
-  return (ht);
 }
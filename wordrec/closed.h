@@ -35,31 +35,81 @@
 /*----------------------------------------------------------------------
               T y p e s
 ----------------------------------------------------------------------*/
-typedef STATE *HASH_TABLE;
-#define NO_STATE ~0
+/**********************************************************************
+ * SEARCH_NODE
+ *
+ * A state seen by the segmentation search, with its place in the
+ * queue of open states and whether it has been evaluated.
+ **********************************************************************/
+struct SEARCH_NODE {
+  STATE state;
+  FLOAT32 priority;              /* Key in the open heap */
+  int heap_index;                /* Place in the open heap, or -1 */
+  BOOL8 closed;                  /* Evaluated by the search */
+};
 
-/*----------------------------------------------------------------------
-              V a r i a b l e s
-----------------------------------------------------------------------*/
-extern HASH_TABLE global_hash;
+/**********************************************************************
+ * STATE_ARENA
+ *
+ * Allocates the nodes of one search in blocks, so that they cost no
+ * malloc each and are all freed at once when the search is deleted.
+ **********************************************************************/
+#define ARENA_BLOCK_SIZE 256     /* Nodes per block */
+
+class STATE_ARENA {
+ public:
+  STATE_ARENA() : blocks(NULL), used(ARENA_BLOCK_SIZE) {}
+  ~STATE_ARENA() {
+    release();
+  }
+  /* Returns a new node holding a copy of state, not in any heap. */
+  SEARCH_NODE *new_node(const STATE *state);
+  /* Frees all the nodes. */
+  void release();
+
+ private:
+  struct BLOCK {
+    BLOCK *next;
+    SEARCH_NODE nodes[ARENA_BLOCK_SIZE];
+  };
+  STATE_ARENA(const STATE_ARENA &);
+  void operator=(const STATE_ARENA &);
+
+  BLOCK *blocks;                 /* Newest first */
+  int used;                      /* Nodes used in the newest block */
+};
 
-/*----------------------------------------------------------------------
-              M a c r o s
-----------------------------------------------------------------------*/
 /**********************************************************************
- * free_hash_table
+ * HASH_TABLE
  *
- * Free the memory taken by a state variable.
+ * Open addressing table of the nodes of a search, keyed by their
+ * states. It doubles when half full, so it never fills up. The slots
+ * in use are listed, so that emptying a large table for the next
+ * search only touches them.
  **********************************************************************/
-#define free_hash_table(table) \
-	global_hash = table
+struct HASH_TABLE_RECORD {
+  SEARCH_NODE **nodes;           /* NULL where empty */
+  int *filled;                   /* The count slots in use */
+  int size;                      /* A power of 2 */
+  int count;                     /* Nodes in the table */
+};
+typedef HASH_TABLE_RECORD *HASH_TABLE;
 
 /*---------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
-int hash_add(HASH_TABLE state_table, STATE *state); 
+int hash_add(HASH_TABLE state_table, STATE_ARENA *arena, STATE *state);
+
+int hash_lookup(HASH_TABLE state_table, STATE *state);
+
+SEARCH_NODE *hash_find(HASH_TABLE state_table, STATE *state);
+
+SEARCH_NODE *hash_insert(HASH_TABLE state_table, STATE_ARENA *arena,
+                         STATE *state);
+
+HASH_TABLE new_hash_table(HASH_TABLE *spare);
 
-int hash_lookup(HASH_TABLE state_table, STATE *state); 
+void free_hash_table(HASH_TABLE table, HASH_TABLE *spare);
 
-HASH_TABLE new_hash_table(); 
+void delete_hash_table(HASH_TABLE table);
 #endif
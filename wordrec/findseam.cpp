@@ -171,7 +171,8 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
                       SPLIT *split,
                       PRIORITY priority,
                       SEAM **seam_result,
-                      TBLOB *blob) {
+                      TBLOB *blob,
+                      PRIORITY ok_split) {
   SEAM *seam;
   TPOINT topleft;
   TPOINT botright;
@@ -202,7 +203,7 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
     }
 
     if ((*seam_result == NULL || /* Replace answer */
-    (*seam_result)->priority > my_priority) && my_priority < chop_ok_split) {
+    (*seam_result)->priority > my_priority) && my_priority < ok_split) {
       /* No crossing */
       if (constrained_split (seam->split1, blob)) {
         delete_seam(*seam_result);
@@ -226,7 +227,7 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
                                  /* Combine with others */
       if (array_count (*seam_pile) < MAX_NUM_SEAMS
       /*|| tessedit_truncate_chopper==0 */ ) {
-        combine_seam(seam_queue, *seam_pile, seam);
+        combine_seam(seam_queue, *seam_pile, seam, ok_split);
         *seam_pile = array_push (*seam_pile, seam);
       }
       else
@@ -234,7 +235,7 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
     }
 
     my_priority = best_seam_priority (seam_queue);
-    if ((my_priority > chop_ok_split) ||
+    if ((my_priority > ok_split) ||
       (my_priority > chop_good_split && split))
       return;
   }
@@ -248,7 +249,8 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
  * from this union should be added to the seam queue.  The return value
  * tells whether or not any additional seams were added to the queue.
  **********************************************************************/
-void combine_seam(SEAM_QUEUE seam_queue, SEAM_PILE seam_pile, SEAM *seam) {
+void combine_seam(SEAM_QUEUE seam_queue, SEAM_PILE seam_pile, SEAM *seam,
+                  PRIORITY ok_split) {
   register inT16 x;
   register inT16 dist;
   inT16 bottom1, top1;
@@ -282,7 +284,7 @@ void combine_seam(SEAM_QUEUE seam_queue, SEAM_PILE seam_pile, SEAM *seam) {
     dist = seam->location - this_one->location;
     if (-SPLIT_CLOSENESS < dist &&
       dist < SPLIT_CLOSENESS &&
-    seam->priority + this_one->priority < chop_ok_split) {
+    seam->priority + this_one->priority < ok_split) {
       inT16 split1_point1_y = this_one->split1->point1->pos.y;
       inT16 split1_point2_y = this_one->split1->point2->pos.y;
       inT16 split2_point1_y = 0;
@@ -364,21 +366,24 @@ void delete_seam_pile(SEAM_PILE seam_pile) {
 
 
 /**********************************************************************
- * pick_good_seam
+ * search_seams
  *
- * Find and return a good seam that will split this blob into two pieces.
- * Work from the outlines provided.
+ * Search the splits of this blob for the best seam and return it, or
+ * NULL if there is none.  Seams with a priority above ok_split are not
+ * good enough, but one may still be returned.  The seams that were
+ * queued or combined on the way are left in the seam queue and pile,
+ * which the caller must delete, and the critical points that were
+ * paired in points.
  **********************************************************************/
-SEAM *pick_good_seam(TBLOB *blob) {
-  SEAM_QUEUE seam_queue;
-  SEAM_PILE seam_pile;
+static SEAM *search_seams(TBLOB *blob, PRIORITY ok_split,
+                          SEAM_QUEUE *seam_queue, SEAM_PILE *seam_pile,
+                          EDGEPT *points[MAX_NUM_POINTS],
+                          inT16 *num_points) {
   POINT_GROUP point_heap;
   PRIORITY priority;
   EDGEPT *edge;
-  EDGEPT *points[MAX_NUM_POINTS];
   SEAM *seam = NULL;
   TESSLINE *outline;
-  inT16 num_points = 0;
 
 #ifndef GRAPHICS_DISABLED
   if (chop_debug > 2)
@@ -391,58 +396,236 @@ SEAM *pick_good_seam(TBLOB *blob) {
   for (outline = blob->outlines; outline; outline = outline->next)
     prioritize_points(outline, point_heap);
 
+  *num_points = 0;
   while (HeapPop (point_heap, &priority, &edge) == OK) {
-    if (num_points < MAX_NUM_POINTS)
-      points[num_points++] = (EDGEPT *) edge;
+    if (*num_points < MAX_NUM_POINTS)
+      points[(*num_points)++] = (EDGEPT *) edge;
   }
   FreeHeap(point_heap);
 
   /* Initialize queue & pile */
-  create_seam_pile(seam_pile);
-  create_seam_queue(seam_queue);
+  create_seam_pile(*seam_pile);
+  create_seam_queue(*seam_queue);
 
-  try_point_pairs(points, num_points, seam_queue, &seam_pile, &seam, blob);
+  try_point_pairs(points, *num_points, *seam_queue, seam_pile, &seam, blob,
+                  ok_split);
 
-  try_vertical_splits(points, num_points, seam_queue, &seam_pile, &seam, blob);
+  try_vertical_splits(points, *num_points, *seam_queue, seam_pile, &seam,
+                      blob, ok_split);
 
   if (seam == NULL) {
-    choose_best_seam(seam_queue, &seam_pile, NULL, BAD_PRIORITY, &seam, blob);
+    choose_best_seam(*seam_queue, seam_pile, NULL, BAD_PRIORITY, &seam, blob,
+                     ok_split);
   }
   else if (seam->priority > chop_good_split) {
-    choose_best_seam (seam_queue, &seam_pile, NULL, seam->priority,
-      &seam, blob);
+    choose_best_seam (*seam_queue, seam_pile, NULL, seam->priority,
+      &seam, blob, ok_split);
   }
-  delete_seam_queue(seam_queue);
-  delete_seam_pile(seam_pile);
+  return (seam);
+}
 
-  if (seam) {
-    if (seam->priority > chop_ok_split) {
-      delete_seam(seam);
-      seam = NULL;
-    }
+
+/**********************************************************************
+ * show_picked_seam
+ *
+ * Mark the splits of the seam that was picked, if any, and end the
+ * display of the splits.
+ **********************************************************************/
+static void show_picked_seam(SEAM *seam) {
 #ifndef GRAPHICS_DISABLED
-    else if (wordrec_display_splits) {
-      if (seam->split1)
-        mark_split (seam->split1);
-      if (seam->split2)
-        mark_split (seam->split2);
-      if (seam->split3)
-        mark_split (seam->split3);
-      if (chop_debug > 2) {
-        update_edge_window();
-        edge_window_wait();
-      }
+  if (seam && wordrec_display_splits) {
+    if (seam->split1)
+      mark_split (seam->split1);
+    if (seam->split2)
+      mark_split (seam->split2);
+    if (seam->split3)
+      mark_split (seam->split3);
+    if (chop_debug > 2) {
+      update_edge_window();
+      edge_window_wait();
     }
-#endif
   }
+#endif
 
   if (chop_debug)
     wordrec_display_splits.set_value(false);
+}
+
+
+/**********************************************************************
+ * pick_good_seam
+ *
+ * Find and return a good seam that will split this blob into two pieces.
+ * Work from the outlines provided. Seams with a priority above ok_split
+ * are not good enough.
+ **********************************************************************/
+SEAM *pick_good_seam(TBLOB *blob, PRIORITY ok_split) {
+  SEAM_QUEUE seam_queue;
+  SEAM_PILE seam_pile;
+  EDGEPT *points[MAX_NUM_POINTS];
+  inT16 num_points;
+  SEAM *seam;
+
+  seam = search_seams(blob, ok_split, &seam_queue, &seam_pile,
+                      points, &num_points);
+  delete_seam_queue(seam_queue);
+  delete_seam_pile(seam_pile);
+
+  if (seam && seam->priority > ok_split) {
+    delete_seam(seam);
+    seam = NULL;
+  }
+  show_picked_seam(seam);
 
   return (seam);
 }
 
 
+/**********************************************************************
+ * same_seam
+ *
+ * Return TRUE if the two seams are made of the same splits.
+ **********************************************************************/
+static int same_split(SPLIT *split1, SPLIT *split2) {
+  if (split1 == NULL || split2 == NULL)
+    return (split1 == split2);
+  return (split1->point1 == split2->point1 &&
+    split1->point2 == split2->point2);
+}
+
+static int same_seam(SEAM *seam1, SEAM *seam2) {
+  return (same_split (seam1->split1, seam2->split1) &&
+    same_split (seam1->split2, seam2->split2) &&
+    same_split (seam1->split3, seam2->split3));
+}
+
+
+/**********************************************************************
+ * add_seam_candidate
+ *
+ * Add a copy of this seam to the candidates, which are kept in the
+ * order of their full priority, unless it is not good enough, crosses
+ * an outline, is already there or is worse than all of a full set.  The
+ * first candidate is never displaced, and a candidate goes after those
+ * of the same priority.
+ **********************************************************************/
+static void add_seam_candidate(SEAM *candidate, TBLOB *blob,
+                               inT16 xmin, inT16 xmax, PRIORITY ok_split,
+                               SEAM **seams, int *num_seams, int max_seams) {
+  PRIORITY priority;
+  int x;
+
+  priority = seam_priority (candidate, xmin, xmax);
+  if (priority >= ok_split || !constrained_split (candidate->split1, blob))
+    return;
+  for (x = 0; x < *num_seams; x++) {
+    if (same_seam (seams[x], candidate))
+      return;
+  }
+  for (x = *num_seams; x > 1 && seams[x - 1]->priority > priority; x--) {
+    if (x < max_seams)
+      seams[x] = seams[x - 1];
+    else
+      delete_seam (seams[x - 1]);
+  }
+  if (x < max_seams) {
+    clone_seam (seams[x], candidate);
+    seams[x]->priority = priority;
+    if (*num_seams < max_seams)
+      (*num_seams)++;
+  }
+}
+
+
+/**********************************************************************
+ * add_point_pair_candidates
+ *
+ * Add the seams of the splits between pairs of these critical points
+ * that try_point_pairs would try to the candidates.
+ **********************************************************************/
+static void add_point_pair_candidates(EDGEPT *points[MAX_NUM_POINTS],
+                                      inT16 num_points, TBLOB *blob,
+                                      inT16 xmin, inT16 xmax,
+                                      PRIORITY ok_split, SEAM **seams,
+                                      int *num_seams, int max_seams) {
+  inT16 x;
+  inT16 y;
+  SPLIT *split;
+  SEAM *candidate;
+
+  for (x = 0; x < num_points; x++) {
+    for (y = x + 1; y < num_points; y++) {
+      if (points[y] &&
+        weighted_edgept_dist (points[x], points[y],
+                               chop_x_y_weight) < chop_split_length &&
+        points[x] != points[y]->next &&
+        points[y] != points[x]->next &&
+        !is_exterior_point (points[x], points[y]) &&
+      !is_exterior_point (points[y], points[x])) {
+        split = new_split (points[x], points[y]);
+        /* Placed where choose_best_seam places the seam of a split */
+        candidate = new_seam (partial_split_priority (split),
+          (split->point1->pos.x + split->point1->pos.x) / 2,
+          split, NULL, NULL);
+        add_seam_candidate (candidate, blob, xmin, xmax, ok_split,
+          seams, num_seams, max_seams);
+        delete_seam(candidate);
+      }
+    }
+  }
+}
+
+
+/**********************************************************************
+ * pick_good_seams
+ *
+ * Find up to max_seams different good seams that will split this blob
+ * into two pieces, and put them in seams.  The first is the seam that
+ * pick_good_seam would return, and the others are the best of the seams
+ * that were queued or combined while searching for it and of the seams
+ * of single point pair splits, in the order of their full priority and
+ * then of the search.  Return the number of seams found.
+ **********************************************************************/
+int pick_good_seams(TBLOB *blob, PRIORITY ok_split,
+                    SEAM **seams, int max_seams) {
+  SEAM_QUEUE seam_queue;
+  SEAM_PILE seam_pile;
+  EDGEPT *points[MAX_NUM_POINTS];
+  inT16 num_points;
+  SEAM *seam;
+  TPOINT topleft;
+  TPOINT botright;
+  int num_seams = 0;
+  int x;
+
+  seam = search_seams(blob, ok_split, &seam_queue, &seam_pile,
+                      points, &num_points);
+  if (seam && (seam->priority > ok_split || max_seams < 1)) {
+    delete_seam(seam);
+    seam = NULL;
+  }
+  if (seam) {
+    seams[num_seams++] = seam;
+    blob_bounding_box(blob, &topleft, &botright);
+    array_loop(seam_pile, x) {
+      add_seam_candidate ((SEAM *) array_value (seam_pile, x), blob,
+        topleft.x, botright.x, ok_split, seams, &num_seams, max_seams);
+    }
+    for (x = 0; x < SizeOfHeap (seam_queue); x++) {
+      add_seam_candidate ((SEAM *) HeapDataFor (seam_queue, x), blob,
+        topleft.x, botright.x, ok_split, seams, &num_seams, max_seams);
+    }
+    add_point_pair_candidates (points, num_points, blob,
+      topleft.x, botright.x, ok_split, seams, &num_seams, max_seams);
+  }
+  delete_seam_queue(seam_queue);
+  delete_seam_pile(seam_pile);
+  show_picked_seam(seam);
+
+  return (num_seams);
+}
+
+
 /**********************************************************************
  * seam_priority
  *
@@ -490,7 +673,7 @@ void
 try_point_pairs (EDGEPT * points[MAX_NUM_POINTS],
 inT16 num_points,
 SEAM_QUEUE seam_queue,
-SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob) {
+SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob, PRIORITY ok_split) {
   inT16 x;
   inT16 y;
   SPLIT *split;
@@ -509,7 +692,8 @@ SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob) {
         split = new_split (points[x], points[y]);
         priority = partial_split_priority (split);
 
-        choose_best_seam(seam_queue, seam_pile, split, priority, seam, blob);
+        choose_best_seam(seam_queue, seam_pile, split, priority, seam, blob,
+                         ok_split);
 
         if (*seam && (*seam)->priority < chop_good_split)
           return;
@@ -531,7 +715,7 @@ void
 try_vertical_splits (EDGEPT * points[MAX_NUM_POINTS],
 inT16 num_points,
 SEAM_QUEUE seam_queue,
-SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob) {
+SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob, PRIORITY ok_split) {
   EDGEPT *vertical_point = NULL;
   SPLIT *split;
   inT16 x;
@@ -558,7 +742,8 @@ SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob) {
       split = new_split (points[x], vertical_point);
       priority = partial_split_priority (split);
 
-      choose_best_seam(seam_queue, seam_pile, split, priority, seam, blob);
+      choose_best_seam(seam_queue, seam_pile, split, priority, seam, blob,
+                         ok_split);
     }
   }
 }
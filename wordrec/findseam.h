@@ -45,25 +45,30 @@ void choose_best_seam(SEAM_QUEUE seam_queue,
                       SPLIT *split,
                       PRIORITY priority,
                       SEAM **seam_result,
-                      TBLOB *blob);
+                      TBLOB *blob,
+                      PRIORITY ok_split);
 
-void combine_seam(SEAM_QUEUE seam_queue, SEAM_PILE seam_pile, SEAM *seam);
+void combine_seam(SEAM_QUEUE seam_queue, SEAM_PILE seam_pile, SEAM *seam,
+                  PRIORITY ok_split);
 
 inT16 constrained_split(SPLIT *split, TBLOB *blob);
 
 void delete_seam_pile(SEAM_PILE seam_pile);
 
-SEAM *pick_good_seam(TBLOB *blob);
+SEAM *pick_good_seam(TBLOB *blob, PRIORITY ok_split);
+
+int pick_good_seams(TBLOB *blob, PRIORITY ok_split,
+                    SEAM **seams, int max_seams);
 
 PRIORITY seam_priority(SEAM *seam, inT16 xmin, inT16 xmax);
 
 void try_point_pairs (EDGEPT * points[MAX_NUM_POINTS],
 inT16 num_points,
 SEAM_QUEUE seam_queue,
-SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob);
+SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob, PRIORITY ok_split);
 
 void try_vertical_splits (EDGEPT * points[MAX_NUM_POINTS],
 inT16 num_points,
 SEAM_QUEUE seam_queue,
-SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob);
+SEAM_PILE * seam_pile, SEAM ** seam, TBLOB * blob, PRIORITY ok_split);
 #endif
@@ -159,21 +159,13 @@ FLOAT32 Wordrec::seamcut_priority(SEAMS seams,
                                   STATE *state,
                                   int num_joints) {
   int x;
-  unsigned int mask = (num_joints > 32) ? (1 << (num_joints - 1 - 32))
-                                        : (1 << (num_joints - 1));
   float seam_cost = 0.0f;
   for (x = num_joints - 1; x >= 0; x--) {
     int i = num_joints - 1 - x;
-    uinT32 value = (x < 32) ? state->part2 : state->part1;
-    bool state_on = value & mask;
-    if (state_on) {
+    if (state->bit(x)) {
       SEAM* seam = (SEAM *) array_value(seams, i);
       seam_cost += seam->priority;
     }
-    if (mask == 1)
-      mask = 1 << 31;
-    else
-      mask >>= 1;
   }
   if (segment_adjust_debug > 2)
     tprintf("seam_cost: %f\n", seam_cost);
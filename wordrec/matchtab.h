@@ -33,17 +33,44 @@
 #include "tessclas.h"
 
 /*----------------------------------------------------------------------
-              F u n c t i o n s
+              T y p e s
 ----------------------------------------------------------------------*/
-void init_match_table();
-void end_match_table();
+typedef struct _MATCH_
+{
+  int topleft;
+  int botright;
+  BLOB_CHOICE_LIST *rating;
+} MATCH;
 
-void put_match(TBLOB *blob, BLOB_CHOICE_LIST *ratings);
+/*----------------------------------------------------------------------
+              C l a s s e s
+----------------------------------------------------------------------*/
+namespace tesseract {
+
+// Table of blobs already matched in the current word, keyed on the blob
+// bounding box. Each Wordrec owns its own table, so separate instances do
+// not share (or trample) each other's cached classifications.
+class BlobMatchTable {
+ public:
+  BlobMatchTable();
+  ~BlobMatchTable();
+
+  void init_match_table();
+  void end_match_table();
+
+  void put_match(TBLOB *blob, BLOB_CHOICE_LIST *ratings);
+
+  BLOB_CHOICE_LIST *get_match(TBLOB *blob);
+
+  BLOB_CHOICE_LIST *get_match_by_bounds(unsigned int topleft,
+                                        unsigned int botright);
 
-BLOB_CHOICE_LIST *get_match(TBLOB *blob);
+  void add_to_match(TBLOB *blob, BLOB_CHOICE_LIST *ratings);
 
-BLOB_CHOICE_LIST *get_match_by_bounds(unsigned int topleft,
-                                      unsigned int botright);
+ private:
+  bool been_initialized_;
+  MATCH *match_table_;
+};
 
-void add_to_match(TBLOB *blob, BLOB_CHOICE_LIST *ratings);
+}  // namespace tesseract
 #endif
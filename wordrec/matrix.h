@@ -63,6 +63,28 @@ class GENERIC_MATRIX {
     return matrix_[this->index(column, row)];
   }
 
+  // Split the chunk at index into two chunks, index and index + 1, growing
+  // the matrix by one. Every cell keeps the same piece of the word: a cell
+  // that covered the old chunk now covers both halves. The cells that
+  // start or end between the halves are new, and are set to the value
+  // initialized T (NULL for the ratings, false for the dirty marks).
+  void split_chunk(int index) {
+    int new_dimension = dimension_ + 1;
+    T *new_matrix = new T[new_dimension * new_dimension];
+    for (int i = 0; i < new_dimension * new_dimension; i++)
+      new_matrix[i] = T();
+    for (int x = 0; x < dimension_; x++) {
+      int new_x = x <= index ? x : x + 1;
+      for (int y = 0; y < dimension_; y++) {
+        int new_y = y < index ? y : y + 1;
+        new_matrix[new_y * new_dimension + new_x] = this->get(x, y);
+      }
+    }
+    delete[] matrix_;
+    matrix_ = new_matrix;
+    dimension_ = new_dimension;
+  }
+
   // Delete objects pointed to by matrix_[i].
   void delete_matrix_pointers() {
     for (int x = 0; x < this->dimension(); x++) {
@@ -81,9 +103,43 @@ class GENERIC_MATRIX {
 
 class MATRIX : public GENERIC_MATRIX<BLOB_CHOICE_LIST *> {
  public:
-  MATRIX(int dimension) : GENERIC_MATRIX<BLOB_CHOICE_LIST *>(dimension) {}
+  MATRIX(int dimension)
+    : GENERIC_MATRIX<BLOB_CHOICE_LIST *>(dimension),
+      dirty_(dimension), num_dirty_(0) {}
   // Print a shortened version of the contents of the matrix.
   void print(const UNICHARSET &current_unicharset);
+
+  // Split the chunk at index into two, keeping the ratings and dirty marks
+  // of all the pieces as GENERIC_MATRIX::split_chunk.
+  void split_chunk(int index) {
+    GENERIC_MATRIX<BLOB_CHOICE_LIST *>::split_chunk(index);
+    dirty_.split_chunk(index);
+  }
+
+  // A dirty cell is a piece that has been classified into the blob match
+  // table, but whose ratings have not been copied into the matrix yet.
+  // Only the dirty cells need to be looked up to bring the matrix up to
+  // date, so a matrix kept while a word is chopped is never rebuilt.
+  bool dirty(int column, int row) const {
+    return dirty_.get(column, row);
+  }
+  void set_dirty(int column, int row) {
+    if (!dirty_.get(column, row)) {
+      dirty_.put(column, row, true);
+      num_dirty_++;
+    }
+  }
+  void clear_dirty(int column, int row) {
+    if (dirty_.get(column, row)) {
+      dirty_.put(column, row, false);
+      num_dirty_--;
+    }
+  }
+  int num_dirty() const { return num_dirty_; }
+
+ private:
+  GENERIC_MATRIX<bool> dirty_;
+  int num_dirty_;
 };
 
 #endif
@@ -41,35 +41,8 @@
 /*----------------------------------------------------------------------
               V a r i a b l e s
 ----------------------------------------------------------------------*/
-static int states_timed_out1;    /* Counters */
-static int states_timed_out2;
-static int words_segmented1;
-static int words_segmented2;
-static int segmentation_states1;
-static int segmentation_states2;
 static int save_priorities;
 
-int words_chopped1;
-int words_chopped2;
-int chops_attempted1;
-int chops_performed1;
-int chops_attempted2;
-int chops_performed2;
-
-int character_count;
-int word_count;
-int chars_classified;
-
-MEASUREMENT num_pieces;
-MEASUREMENT width_measure;
-
-MEASUREMENT width_priority_range;/* Help to normalize */
-MEASUREMENT match_priority_range;
-
-TALLY states_before_best;
-TALLY best_certainties[2];
-TALLY character_widths;          /* Width histogram */
-
 FILE *priority_file_1;           /* Output to cluster */
 FILE *priority_file_2;
 FILE *priority_file_3;
@@ -91,7 +64,8 @@ STATE *known_best_state = NULL;  /* The right answer */
  * Set up the appropriate variables to record information about the
  * OCR process. Later calls will log the data and save a summary.
  **********************************************************************/
-void init_metrics() {
+namespace tesseract {
+void Wordrec::init_metrics() {
   words_chopped1 = 0;
   words_chopped2 = 0;
   chops_performed1 = 0;
@@ -111,7 +85,6 @@ void init_metrics() {
   character_count = 0;
   word_count = 0;
   chars_classified = 0;
-  permutation_count = 0;
 
   end_metrics();
 
@@ -122,7 +95,7 @@ void init_metrics() {
   reset_width_tally();
 }
 
-void end_metrics() {
+void Wordrec::end_metrics() {
   if (states_before_best != NULL) {
     memfree(states_before_best);
     memfree(best_certainties[0]);
@@ -142,7 +115,7 @@ void end_metrics() {
  * Maintain a record of the best certainty values achieved on each
  * word recognition.
  **********************************************************************/
-void record_certainty(float certainty, int pass) {
+void Wordrec::record_certainty(float certainty, int pass) {
   int bucket;
 
   if (certainty / CERTAINTY_BUCKET_SIZE < MAX_INT32)
@@ -158,20 +131,19 @@ void record_certainty(float certainty, int pass) {
  * record_search_status
  *
  * Record information about each iteration of the search.  This  data
- * is kept in global memory and accumulated over multiple segmenter
- * searches.
+ * is accumulated over multiple segmenter searches.
  **********************************************************************/
-void record_search_status(int num_states, int before_best, float closeness) {
+void Wordrec::record_search_status(int num_states, int before_best) {
   inc_tally_bucket(states_before_best, before_best);
 
   if (first_pass) {
-    if (num_states == wordrec_num_seg_states + 1)
+    if (num_states == pass_num_seg_states + 1)
       states_timed_out1++;
     segmentation_states1 += num_states;
     words_segmented1++;
   }
   else {
-    if (num_states == wordrec_num_seg_states + 1)
+    if (num_states == pass_num_seg_states + 1)
       states_timed_out2++;
     segmentation_states2 += num_states;
     words_segmented2++;
@@ -184,7 +156,6 @@ void record_search_status(int num_states, int before_best, float closeness) {
  *
  * Save the summary information into the file "file.sta".
  **********************************************************************/
-namespace tesseract {
 void Wordrec::save_summary(inT32 elapsed_time) {
   #ifndef SECURE_NAMES
   STRING outfilename;
@@ -202,7 +173,8 @@ void Wordrec::save_summary(inT32 elapsed_time) {
   fprintf (f, "%d words\n", word_count);
   fprintf (f, "\n");
 
-  fprintf (f, "%d permutations performed\n", permutation_count);
+  fprintf (f, "%d permutations performed\n",
+           getDict().permutation_count());
   fprintf (f, "%d characters classified\n", chars_classified);
   fprintf (f, "%4.0f%% classification overhead\n",
     (float) chars_classified / character_count * 100.0 - 100.0);
@@ -255,7 +227,6 @@ void Wordrec::save_summary(inT32 elapsed_time) {
   fclose(f);
   #endif
 }
-}  // namespace tesseract
 
 
 /**********************************************************************
@@ -265,9 +236,9 @@ void Wordrec::save_summary(inT32 elapsed_time) {
  * each of the priority voters.  Save them in a file that is set up for
  * doing clustering.
  **********************************************************************/
-void record_priorities(SEARCH_RECORD *the_search,
-                       FLOAT32 priority_1,
-                       FLOAT32 priority_2) {
+void Wordrec::record_priorities(SEARCH_RECORD *the_search,
+                                FLOAT32 priority_1,
+                                FLOAT32 priority_2) {
   record_samples(priority_1, priority_2);
 }
 
@@ -277,7 +248,7 @@ void record_priorities(SEARCH_RECORD *the_search,
  *
  * Remember the priority samples to summarize them later.
  **********************************************************************/
-void record_samples(FLOAT32 match_pri, FLOAT32 width_pri) {
+void Wordrec::record_samples(FLOAT32 match_pri, FLOAT32 width_pri) {
   ADD_SAMPLE(match_priority_range, match_pri);
   ADD_SAMPLE(width_priority_range, width_pri);
 }
@@ -288,13 +259,14 @@ void record_samples(FLOAT32 match_pri, FLOAT32 width_pri) {
  *
  * Create a tally record and initialize it.
  **********************************************************************/
-void reset_width_tally() {
+void Wordrec::reset_width_tally() {
   character_widths = new_tally (20);
   new_measurement(width_measure);
   width_measure.num_samples = 158;
   width_measure.sum_of_samples = 125.0;
   width_measure.sum_of_squares = 118.0;
 }
+}  // namespace tesseract
 
 
 #ifndef GRAPHICS_DISABLED
@@ -311,8 +283,7 @@ void save_best_state(CHUNKS_RECORD *chunks_record) {
   if (save_priorities) {
     num_joints = chunks_record->ratings->dimension() - 1;
 
-    state.part1 = 0xffffffff;
-    state.part2 = 0xffffffff;
+    set_n_ones(&state, num_joints);
 
     chunk_groups = bin_to_chunks (&state, num_joints);
     display_segmentation (chunks_record->chunks, chunk_groups);
@@ -320,7 +291,7 @@ void save_best_state(CHUNKS_RECORD *chunks_record) {
 
     cprintf ("Enter the correct segmentation > ");
     fflush(stdout);
-    state.part1 = 0;
+    state.clear();
     scanf ("%x", &state.part2);
 
     chunk_groups = bin_to_chunks (&state, num_joints);
@@ -32,43 +32,9 @@
 #include "bestfirst.h"
 #include "states.h"
 
-/*----------------------------------------------------------------------
-              V a r i a b l e s
-----------------------------------------------------------------------*/
-extern int words_chopped1;
-extern int words_chopped2;
-extern int chops_attempted1;
-extern int chops_performed1;
-extern int chops_attempted2;
-extern int chops_performed2;
-extern int permutation_count;
-
-extern int character_count;
-extern int word_count;
-extern int chars_classified;
-
-extern MEASUREMENT width_measure;
-extern MEASUREMENT width_priority_range;
-extern MEASUREMENT match_priority_range;
-
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
-void init_metrics();
-void end_metrics();
-
-void record_certainty(float certainty, int pass);
-
-void record_search_status(int num_states, int before_best, float closeness);
-
-void record_priorities(SEARCH_RECORD *the_search,
-                       FLOAT32 priority_1,
-                       FLOAT32 priority_2);
-
-void record_samples(FLOAT32 match_pri, FLOAT32 width_pri);
-
-void reset_width_tally();
-
 void save_best_state(CHUNKS_RECORD *chunks_record);
 
 void start_recording();
@@ -365,7 +365,33 @@ BOUNDS_LIST record_blob_bounds(TBLOB *blobs) {
  * matrix is created.  The indices correspond to the starting and
  * ending initial piece number.
  **********************************************************************/
-MATRIX *record_piece_ratings(TBLOB *blobs) {
+namespace tesseract {
+MATRIX *Wordrec::record_piece_ratings(TBLOB *blobs) {
+  inT16 num_blobs;
+  inT16 x;
+  inT16 y;
+  MATRIX *ratings;
+
+  num_blobs = count_blobs (blobs);
+  ratings = new MATRIX(num_blobs);
+
+  for (x = 0; x < num_blobs; x++) {
+    for (y = x; y < num_blobs; y++)
+      ratings->set_dirty(x, y);
+  }
+  update_piece_ratings(ratings, blobs);
+  return (ratings);
+}
+
+
+/**********************************************************************
+ * update_piece_ratings
+ *
+ * Copy the choices of the dirty pieces of the matrix from the match
+ * table, and mark them clean.  Pieces that are not in the match table
+ * are left NOT_CLASSIFIED.
+ **********************************************************************/
+void Wordrec::update_piece_ratings(MATRIX *ratings, TBLOB *blobs) {
   BOUNDS_LIST bounds;
   inT16 num_blobs;
   inT16 x;
@@ -374,24 +400,29 @@ MATRIX *record_piece_ratings(TBLOB *blobs) {
   TPOINT tp_botright;
   unsigned int topleft;
   unsigned int botright;
-  MATRIX *ratings;
   BLOB_CHOICE_LIST *choices;
 
+  if (ratings->num_dirty() == 0)
+    return;
   bounds = record_blob_bounds (blobs);
   num_blobs = count_blobs (blobs);
-  ratings = new MATRIX(num_blobs);
 
-  for (x = 0; x < num_blobs; x++) {
+  for (x = 0; x < num_blobs && ratings->num_dirty() > 0; x++) {
     for (y = x; y < num_blobs; y++) {
+      if (!ratings->dirty(x, y))
+        continue;
+      ratings->clear_dirty(x, y);
       bounds_of_piece(bounds, x, y, &tp_topleft, &tp_botright);
       topleft = *(unsigned int *) &tp_topleft;
       botright = *(unsigned int *) &tp_botright;
-      choices = get_match_by_bounds (topleft, botright);
+      choices = blob_match_table.get_match_by_bounds (topleft, botright);
       if (choices != NULL) {
+        if (ratings->get(x, y) != NOT_CLASSIFIED)
+          delete ratings->get(x, y);
         ratings->put(x, y, choices);
       }
     }
   }
   memfree(bounds);
-  return (ratings);
 }
+}  // namespace tesseract
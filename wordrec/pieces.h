@@ -66,8 +66,6 @@ void bounds_of_piece(BOUNDS_LIST bounds,
 
 BOUNDS_LIST record_blob_bounds(TBLOB *blobs);
 
-MATRIX *record_piece_ratings(TBLOB *blobs);
-
 /*
 #if defined(__STDC__) || defined(__cplusplus)
 # define	_ARGS(s) s
@@ -40,7 +40,7 @@
 #define NUM_STARTING_SEAMS  20
 
 #define SEAMBLOCK 100            /* Cells per block */
-makestructure (newseam, free_seam, printseam, SEAM,
+makewordstructure (newseam, free_seam, printseam, SEAM,
 freeseam, SEAMBLOCK, "SEAM", seamcount);
 
 /*----------------------------------------------------------------------
@@ -277,27 +277,20 @@ int account_splits_right(SEAM *seam, TBLOB *blob) {
 }
 
 
-/**********************************************************************
- * account_splits_left
- *
- * Account for all the splits by looking to the left.
- * in the blob list.
- **********************************************************************/
-int account_splits_left(SEAM *seam, TBLOB *blob, TBLOB *end_blob) {
-  static inT32 depth = 0;
-  static inT8 width;
-  static inT8 found_em[3];
-
+// Recursive worker for account_splits_left. The depth and the running
+// results are passed down explicitly to keep the recursion re-entrant.
+static int account_splits_left_helper(SEAM *seam, TBLOB *blob,
+                                      TBLOB *end_blob, inT32 depth,
+                                      inT8 *width, inT8 found_em[3]) {
   if (blob != end_blob) {
-    depth++;
-    account_splits_left (seam, blob->next, end_blob);
-    depth--;
+    account_splits_left_helper(seam, blob->next, end_blob, depth + 1,
+                               width, found_em);
   }
   else {
     found_em[0] = seam->split1 == NULL;
     found_em[1] = seam->split2 == NULL;
     found_em[2] = seam->split3 == NULL;
-    width = 0;
+    *width = 0;
   }
   if (!found_em[0])
     found_em[0] = find_split_in_blob (seam->split1, blob);
@@ -306,12 +299,25 @@ int account_splits_left(SEAM *seam, TBLOB *blob, TBLOB *end_blob) {
   if (!found_em[2])
     found_em[2] = find_split_in_blob (seam->split3, blob);
   if (!found_em[0] || !found_em[1] || !found_em[2]) {
-    width++;
+    (*width)++;
     if (depth == 0) {
-      width = -1;
+      *width = -1;
     }
   }
-  return width;
+  return *width;
+}
+
+/**********************************************************************
+ * account_splits_left
+ *
+ * Account for all the splits by looking to the left.
+ * in the blob list.
+ **********************************************************************/
+int account_splits_left(SEAM *seam, TBLOB *blob, TBLOB *end_blob) {
+  inT8 width = 0;
+  inT8 found_em[3];
+  return account_splits_left_helper(seam, blob, end_blob, 0,
+                                    &width, found_em);
 }
 
 
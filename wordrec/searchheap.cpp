@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////
+// File:        searchheap.cpp
+// Description: Bounded priority queue of the open segmentation states.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "searchheap.h"
+
+namespace tesseract {
+
+SearchHeap::SearchHeap(int max_size)
+  : nodes_(NULL), size_(0), max_size_(max_size > 0 ? max_size : 1) {
+  nodes_ = new SEARCH_NODE*[max_size_];
+}
+
+SearchHeap::~SearchHeap() {
+  Clear();
+  delete [] nodes_;
+}
+
+bool SearchHeap::Push(SEARCH_NODE* node, FLOAT32 priority) {
+  if (node->heap_index >= 0) {
+    if (priority >= node->priority)
+      return false;
+    node->priority = priority;
+    SiftUp(node->heap_index);
+    return true;
+  }
+  if (size_ >= max_size_) {
+    int worst = WorstIndex();
+    if (priority >= nodes_[worst]->priority)
+      return false;
+    RemoveAt(worst);
+  }
+  node->priority = priority;
+  node->heap_index = size_;
+  nodes_[size_++] = node;
+  SiftUp(node->heap_index);
+  return true;
+}
+
+SEARCH_NODE* SearchHeap::Pop() {
+  return size_ > 0 ? RemoveAt(0) : NULL;
+}
+
+int SearchHeap::PruneAbove(FLOAT32 limit) {
+  int kept = 0;
+  for (int i = 0; i < size_; ++i) {
+    if (nodes_[i]->priority < limit)
+      nodes_[kept++] = nodes_[i];
+    else
+      nodes_[i]->heap_index = -1;
+  }
+  int num_pruned = size_ - kept;
+  if (num_pruned > 0) {
+    size_ = kept;
+    for (int i = 0; i < size_; ++i)
+      nodes_[i]->heap_index = i;
+    for (int i = size_ / 2 - 1; i >= 0; --i)
+      SiftDown(i);
+  }
+  return num_pruned;
+}
+
+void SearchHeap::Clear() {
+  for (int i = 0; i < size_; ++i)
+    nodes_[i]->heap_index = -1;
+  size_ = 0;
+}
+
+void SearchHeap::SiftUp(int index) {
+  SEARCH_NODE* node = nodes_[index];
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (nodes_[parent]->priority <= node->priority)
+      break;
+    nodes_[index] = nodes_[parent];
+    nodes_[index]->heap_index = index;
+    index = parent;
+  }
+  nodes_[index] = node;
+  node->heap_index = index;
+}
+
+void SearchHeap::SiftDown(int index) {
+  SEARCH_NODE* node = nodes_[index];
+  for (;;) {
+    int child = 2 * index + 1;
+    if (child >= size_)
+      break;
+    if (child + 1 < size_ &&
+        nodes_[child + 1]->priority < nodes_[child]->priority)
+      ++child;
+    if (node->priority <= nodes_[child]->priority)
+      break;
+    nodes_[index] = nodes_[child];
+    nodes_[index]->heap_index = index;
+    index = child;
+  }
+  nodes_[index] = node;
+  node->heap_index = index;
+}
+
+int SearchHeap::WorstIndex() const {
+  int worst = size_ / 2;
+  for (int i = worst + 1; i < size_; ++i) {
+    if (nodes_[i]->priority > nodes_[worst]->priority)
+      worst = i;
+  }
+  return worst;
+}
+
+SEARCH_NODE* SearchHeap::RemoveAt(int index) {
+  SEARCH_NODE* node = nodes_[index];
+  node->heap_index = -1;
+  --size_;
+  if (index < size_) {
+    nodes_[index] = nodes_[size_];
+    nodes_[index]->heap_index = index;
+    // The moved node may belong above or below its new place.
+    if (index > 0 &&
+        nodes_[(index - 1) / 2]->priority > nodes_[index]->priority)
+      SiftUp(index);
+    else
+      SiftDown(index);
+  }
+  return node;
+}
+
+}  // namespace tesseract
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////
+// File:        searchheap.h
+// Description: Bounded priority queue of the open segmentation states.
+//
+// (C) Copyright 2010, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_WORDREC_SEARCHHEAP_H__
+#define TESSERACT_WORDREC_SEARCHHEAP_H__
+
+#include "closed.h"
+#include "host.h"
+
+namespace tesseract {
+
+// A binary min-heap of SEARCH_NODEs keyed by their priority, lowest
+// first, holding at most max_size nodes. Each node records its own place
+// in the heap, so that pushing a node that is already in the heap with a
+// better priority moves it up instead of adding a duplicate, and a full
+// heap makes room for a better node by dropping its worst one.
+// The heap does not own the nodes, which belong to a STATE_ARENA.
+class SearchHeap {
+ public:
+  explicit SearchHeap(int max_size);
+  ~SearchHeap();
+
+  int size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  // Adds node with the given priority, or lowers the priority of node if
+  // it is already in the heap with a higher one. If the heap is full, its
+  // worst node is dropped to make room, unless node would be no better.
+  // Returns false if node was not added or changed.
+  bool Push(SEARCH_NODE* node, FLOAT32 priority);
+  // Removes and returns the node with the lowest priority, or NULL if the
+  // heap is empty.
+  SEARCH_NODE* Pop();
+  // Removes all the nodes with a priority of limit or more, and returns
+  // the number removed.
+  int PruneAbove(FLOAT32 limit);
+  // Removes all the nodes.
+  void Clear();
+
+ private:
+  // Moves the node at index towards the top/bottom until the heap is in
+  // order, updating the heap_index of every node moved.
+  void SiftUp(int index);
+  void SiftDown(int index);
+  // Returns the index of the node with the highest priority, which is
+  // always one of the leaves.
+  int WorstIndex() const;
+  // Removes the node at index, and returns it.
+  SEARCH_NODE* RemoveAt(int index);
+
+  SEARCH_NODE** nodes_;
+  int size_;
+  int max_size_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_WORDREC_SEARCHHEAP_H__
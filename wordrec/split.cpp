@@ -40,7 +40,7 @@
 BOOL_VAR(wordrec_display_splits, 0, "Display splits");
 
 #define SPLITBLOCK 100           /* Cells per block */
-makestructure (newsplit, free_split, printsplit, SPLIT,
+makewordstructure (newsplit, free_split, printsplit, SPLIT,
 freesplit, SPLITBLOCK, "SPLIT", splitcount);
 
 /*----------------------------------------------------------------------
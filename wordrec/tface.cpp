@@ -55,9 +55,6 @@ namespace tesseract {
 /*----------------------------------------------------------------------
               Variables
 ----------------------------------------------------------------------*/
-static PRIORITY pass2_ok_split;
-static int pass2_seg_states;
-
 BOOL_VAR(wordrec_no_block, false, "Don't output block information");
 
 /*----------------------------------------------------------------------
@@ -98,8 +95,7 @@ void Wordrec::program_editup(const char *textbase, bool init_permute) {
   setup_cp_maps();
 
   init_metrics();
-  pass2_ok_split = chop_ok_split;
-  pass2_seg_states = wordrec_num_seg_states;
+  tord_blob_skip.set_value(false);
 }
 }  // namespace tesseract
 
@@ -177,12 +173,10 @@ void Wordrec::program_editdown(inT32 elasped_time) {
   close_choices();
   if (tessedit_save_stats)
     save_summary (elasped_time);
-  end_match_table();
+  blob_match_table.end_match_table();
   getDict().InitChoiceAccum();
-  if (global_hash != NULL) {
-    free_mem(global_hash);
-    global_hash = NULL;
-  }
+  delete_hash_table(spare_closed_states_);
+  spare_closed_states_ = NULL;
   end_metrics();
   getDict().end_permute();
 }
@@ -194,11 +188,10 @@ void Wordrec::program_editdown(inT32 elasped_time) {
  * Get ready to do some pass 1 stuff.
  **********************************************************************/
 void Wordrec::set_pass1() {
-  tord_blob_skip.set_value(false);
-  chop_ok_split.set_value(70.0);
-  wordrec_num_seg_states.set_value(15);
+  pass_ok_split = 70.0;
+  pass_num_seg_states = 15;
   SettupPass1();
-  first_pass = 1;
+  first_pass = TRUE;
 }
 
 
@@ -208,11 +201,10 @@ void Wordrec::set_pass1() {
  * Get ready to do some pass 2 stuff.
  **********************************************************************/
 void Wordrec::set_pass2() {
-  tord_blob_skip.set_value(false);
-  chop_ok_split.set_value(pass2_ok_split);
-  wordrec_num_seg_states.set_value(pass2_seg_states);
+  pass_ok_split = chop_ok_split;
+  pass_num_seg_states = wordrec_num_seg_states;
   SettupPass2();
-  first_pass = 0;
+  first_pass = FALSE;
 }
 
 
@@ -227,6 +219,7 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::cc_recog(TWERD *tessword,
                                            BOOL8 tester,
                                            BOOL8 trainer,
                                            bool last_word_on_line) {
+  AllocSubsystemScope alloc_scope(AS_WORDREC);
   int fx;
   BLOB_CHOICE_LIST_VECTOR *results;          /*matcher results */
 
@@ -238,7 +231,7 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::cc_recog(TWERD *tessword,
   }
   getDict().InitChoiceAccum();
   getDict().reset_hyphen_vars(last_word_on_line);
-  init_match_table();
+  blob_match_table.init_match_table();
   for (fx = 0; fx < MAX_FX && (acts[OCR] & (FXSELECT << fx)) == 0; fx++);
   results =
     chop_word_main(tessword,
@@ -47,11 +47,6 @@
 
 extern TBLOB *newblob();
 
-/*----------------------------------------------------------------------
-            Variables
-----------------------------------------------------------------------*/
-inT16 first_pass;
-
 /*----------------------------------------------------------------------
           C o n s t a n t s
 ----------------------------------------------------------------------*/
@@ -80,17 +75,17 @@ BLOB_CHOICE_LIST *Wordrec::classify_blob(TBLOB *pblob,
                                          const char *string,
                                          C_COL color) {
   BLOB_CHOICE_LIST *choices = NULL;
-  chars_classified++;            /* Global value */
+  chars_classified++;
   if (tord_blob_skip)
     return (NULL);
 #ifndef GRAPHICS_DISABLED
   if (wordrec_display_all_blobs)
     display_blob(blob, color);
 #endif
-  choices = get_match(blob);
+  choices = blob_match_table.get_match(blob);
   if (choices == NULL) {
     choices = call_matcher(pblob, blob, nblob, NULL, row);
-    put_match(blob, choices);
+    blob_match_table.put_match(blob, choices);
   }
 #ifndef GRAPHICS_DISABLED
   if (tord_display_ratings && string)
@@ -115,7 +110,7 @@ void Wordrec::update_blob_classifications(
   int index = 0;
   for (; tblob != NULL && index < choices.length();
        tblob = tblob->next, index++) {
-    add_to_match(tblob, choices.get(index));
+    blob_match_table.add_to_match(tblob, choices.get(index));
   }
 }
 
@@ -162,7 +157,4 @@ void write_text_files(TWERD *word,
       fflush(textfile);
     }
   }
-  /* Global counters */
-  character_count += (word->guess ? strlen (word->guess) : 0);
-  word_count++;
 }
@@ -30,11 +30,6 @@
 #include "states.h"
 #include "tessclas.h"
 
-/*----------------------------------------------------------------------
-            Variables
-----------------------------------------------------------------------*/
-extern inT16 first_pass;
-
 /*----------------------------------------------------------------------
               F u n c t i o n s
 ----------------------------------------------------------------------*/
@@ -18,7 +18,23 @@
 
 #include "wordrec.h"
 
+#include "beamsearch.h"
+#include "bestfirst.h"
+#include "chop.h"
+#include "closed.h"
+
 namespace tesseract {
-Wordrec::Wordrec() {}
-Wordrec::~Wordrec() {}
+Wordrec::Wordrec()
+  : tess_dont_chop(FALSE), beam_width_hint_(kMinBeamWidth),
+    pass_ok_split(chop_ok_split), pass_num_seg_states(wordrec_num_seg_states),
+    first_pass(FALSE), seam_helper_changes_(-1), spare_closed_states_(NULL),
+    states_before_best(NULL) {
+  best_certainties[0] = NULL;
+  best_certainties[1] = NULL;
+  character_widths = NULL;
+}
+Wordrec::~Wordrec() {
+  delete_hash_table(spare_closed_states_);
+  end_metrics();
+}
 }
@@ -20,14 +20,19 @@
 #define TESSERACT_WORDREC_WORDREC_H__
 
 #include "classify.h"
+#include "genericvector.h"
 #include "ratngs.h"
 #include "matrix.h"
 #include "seam.h"
 #include "callback.h"
 #include "associate.h"
 #include "badwords.h"
+#include "matchtab.h"
+#include "measure.h"
+#include "tally.h"
 
 struct CHUNKS_RECORD;
+struct HASH_TABLE_RECORD;
 struct SEARCH_RECORD;
 
 namespace tesseract {
@@ -85,6 +90,8 @@ class Wordrec : public Classify {
   void expand_node(FLOAT32 worst_priority,
                    CHUNKS_RECORD *chunks_record,
                    SEARCH_RECORD *the_search);
+  void replace_char_widths(CHUNKS_RECORD *chunks_record,
+                           SEARCH_STATE state);
   BLOB_CHOICE_LIST_VECTOR *rebuild_current_state(
       TBLOB *blobs,
       SEAMS seam_list,
@@ -98,8 +105,29 @@ class Wordrec : public Classify {
       TBLOB *blobs, SEAMS seam_list,
       int x, int y, int fx, const MATRIX *ratings,
       BLOB_CHOICE_LIST_VECTOR *old_choices);
+  /* beamsearch.cpp **********************************************************/
+  // Sets the width of the segmentation beam used while wordrec_beam_width
+  // is 0.
+  void set_beam_width_hint(int width) {
+    beam_width_hint_ = width;
+  }
+  void beam_search(CHUNKS_RECORD *chunks_record,
+                   WERD_CHOICE *best_choice,
+                   WERD_CHOICE *raw_choice,
+                   STATE *state,
+                   DANGERR *fixpt,
+                   STATE *best_state);
 
   /* chopper.cpp *************************************************************/
+  SEAM *attempt_blob_chop(TWERD *word, inT32 blob_number, SEAMS seam_list);
+  bool try_seam_on_copy(TBLOB *pblob, TBLOB *blob, TBLOB *nblob,
+                        SEAM *seam, BLOB_CHOICE_LIST **left,
+                        BLOB_CHOICE_LIST **right);
+  void copy_seam_helper_state();
+  SEAM *attempt_best_blob_chop(TWERD *word, inT32 blob_number,
+                               SEAMS seam_list, BLOB_CHOICE_LIST **left,
+                               BLOB_CHOICE_LIST **right);
+  void put_trial_match(TBLOB *blob, BLOB_CHOICE_LIST *choices);
   bool improve_one_blob(TWERD *word,
                         BLOB_CHOICE_LIST_VECTOR *char_choices,
                         int fx,
@@ -129,7 +157,8 @@ class Wordrec : public Classify {
                            SEAMS *seam_list,
                            DANGERR *fixpt,
                            STATE *chop_states,
-                           inT32 *state_count);
+                           inT32 *state_count,
+                           MATRIX *ratings);
   MATRIX *word_associator(TBLOB *blobs,
                           SEAMS seams,
                           STATE *state,
@@ -138,7 +167,8 @@ class Wordrec : public Classify {
                           WERD_CHOICE *raw_choice,
                           char *correct,
                           DANGERR *fixpt,
-                          STATE *best_state);
+                          STATE *best_state,
+                          MATRIX *ratings);
   inT16 select_blob_to_split(const BLOB_CHOICE_LIST_VECTOR &char_choices,
                              float rating_ceiling,
                              bool split_next_to_fragment);
@@ -154,6 +184,8 @@ class Wordrec : public Classify {
                                      SEAMS seams,
                                      inT16 start,
                                      inT16 end);
+  MATRIX *record_piece_ratings(TBLOB *blobs);
+  void update_piece_ratings(MATRIX *ratings, TBLOB *blobs);
   /* djmenus.cpp **************************************************************/
   // Prints out statistics gathered.
   void dj_statistics(FILE *File) {
@@ -164,6 +196,17 @@ class Wordrec : public Classify {
   void dj_cleanup() { EndAdaptiveClassifier(); }
 
 
+  /* metrics.cpp *************************************************************/
+  void init_metrics();
+  void end_metrics();
+  void record_certainty(float certainty, int pass);
+  void record_search_status(int num_states, int before_best);
+  void record_priorities(SEARCH_RECORD *the_search,
+                         FLOAT32 priority_1,
+                         FLOAT32 priority_2);
+  void record_samples(FLOAT32 match_pri, FLOAT32 width_pri);
+  void reset_width_tally();
+
   /* heuristic.cpp ************************************************************/
   FLOAT32 prioritize_state(CHUNKS_RECORD *chunks_record,
                            SEARCH_RECORD *the_search);
@@ -184,7 +227,52 @@ class Wordrec : public Classify {
   POLY_TESTER tess_trainer; //current trainer
   DENORM *tess_denorm;      //current denorm
   WERD *tess_word;          //current word
+  BOOL8 tess_dont_chop;     //current word must not be chopped
+  int beam_width_hint_;     //beam width when wordrec_beam_width is 0
+  // Limits of the current pass, set by set_pass1 and set_pass2. Pass 2
+  // uses the configured chop_ok_split and wordrec_num_seg_states.
+  PRIORITY pass_ok_split;   //seams must be better than this
+  int pass_num_seg_states;  //segmentation states searched per word
+  BOOL8 first_pass;         //set_pass1 was called last
   int dict_word(const WERD_CHOICE &word);
+  /* matchtab.cpp *************************************************************/
+  BlobMatchTable blob_match_table;
+  /* chopper.cpp **************************************************************/
+  // Instances of the same language that try the seam candidates of this
+  // one on other threads when chop_seam_candidates is more than 1. They
+  // are made and deleted by the Tesseract that owns this Wordrec.
+  GenericVector<Wordrec*> seam_helpers_;
+  // classifier_changes() when the seam helpers were last given the
+  // classifier state of this instance, or -1.
+  int seam_helper_changes_;
+  /* bestfirst.cpp ************************************************************/
+  // Emptied table of closed states of the last search, for the next one.
+  HASH_TABLE_RECORD *spare_closed_states_;
+  // Widths and gaps of the characters of the last state evaluated.
+  EVALUATION_ARRAY last_segmentation_;
+  /* metrics.cpp **************************************************************/
+  // Counters of this instance, written by save_summary.
+  int words_chopped1;
+  int words_chopped2;
+  int chops_attempted1;
+  int chops_performed1;
+  int chops_attempted2;
+  int chops_performed2;
+  int words_segmented1;
+  int words_segmented2;
+  int segmentation_states1;
+  int segmentation_states2;
+  int states_timed_out1;
+  int states_timed_out2;
+  int character_count;
+  int word_count;
+  int chars_classified;
+  MEASUREMENT width_measure;
+  MEASUREMENT width_priority_range;  // Help to normalize
+  MEASUREMENT match_priority_range;
+  TALLY states_before_best;
+  TALLY best_certainties[2];
+  TALLY character_widths;            // Width histogram
 };
 
 